@@ -16,6 +16,8 @@ this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "LibBoolEE.h"
 
+#include <algorithm>
+
 std::vector<std::string> LibBoolEE::singleParse(const std::string & formula, const char op, ErrorReport* errorReport) {
     int start_pos = -1;
     int parity_count = 0;
@@ -145,6 +147,115 @@ bool LibBoolEE::resolveRec(const std::string &source, const Vals & valuation, Er
     }
 }
 
+void LibBoolEE::compile(const std::string &source, const std::vector<std::string> & variables, Formula & formula, ErrorReport* errorReport) {
+    if (variables.size() > MAX_FORMULA_VARIABLES) {
+        throw std::runtime_error("The formula has more than " + std::to_string(MAX_FORMULA_VARIABLES) + " variables.");
+    }
+    formula.nodes.clear();
+    compileRec(removeWhitespaces(source), variables, formula, errorReport);
+}
+
+// Follows resolveRec step by step, so that the same formulas fail with the same errors
+void LibBoolEE::compileRec(const std::string &source, const std::vector<std::string> & variables, Formula & formula, ErrorReport* errorReport) {
+    if (source.empty()) {
+        if (errorReport) {
+            errorReport->type = ErrorReport::ErrorType::EmptySubExpression;
+            errorReport->vecUserData.emplace_back(source);
+            errorReport->strDevData = "bad-txns-null-verifier-empty-sub-expression";
+        }
+        throw std::runtime_error("An empty subexpression was encountered");
+    }
+
+    Formula::Op current_op = Formula::OR;
+    // Try to divide by |
+    std::vector<std::string> subexpressions = singleParse(source, '|', errorReport);
+    // No | on the top level
+    if (subexpressions.size() == 1) {
+        current_op = Formula::AND;
+        subexpressions = singleParse(source, '&', errorReport);
+    }
+
+    // No valid name found
+    if (subexpressions.size() == 0) {
+        if (errorReport) {
+            errorReport->type = ErrorReport::ErrorType::InvalidQualifierName;
+            errorReport->vecUserData.emplace_back(source);
+            errorReport->strDevData = "bad-txns-null-verifier-no-sub-expressions";
+        }
+        throw std::runtime_error("The subexpression " + source + " is not a valid formula.");
+    }
+
+    // No binary top level operator found
+    else if (subexpressions.size() == 1) {
+        if (source[0] == '!') {
+            formula.nodes.push_back({Formula::NOT, 0});
+            compileRec(source.substr(1), variables, formula, errorReport);
+        }
+        else if (source[0] == '(') {
+            compileRec(source.substr(1, source.size() - 2), variables, formula, errorReport);
+        }
+        else if (source == "1") {
+            formula.nodes.push_back({Formula::TRUE_CONSTANT, 0});
+        }
+        else if (source == "0") {
+            formula.nodes.push_back({Formula::FALSE_CONSTANT, 0});
+        }
+        else {
+            std::vector<std::string>::const_iterator it = std::find(variables.begin(), variables.end(), source);
+            if (it == variables.end()) {
+                if (errorReport) {
+                    errorReport->type = ErrorReport::ErrorType::VariableNotFound;
+                    errorReport->vecUserData.emplace_back(source);
+                    errorReport->strDevData = "bad-txns-null-verifier-variable-not-found";
+                }
+                throw std::runtime_error("Variable '" + source + "' not found in the interpretation.");
+            }
+            formula.nodes.push_back({Formula::VARIABLE, static_cast<uint32_t>(it - variables.begin())});
+        }
+    }
+    else {
+        formula.nodes.push_back({current_op, static_cast<uint32_t>(subexpressions.size())});
+        for (std::vector<std::string>::iterator it = subexpressions.begin(); it != subexpressions.end(); it++) {
+            compileRec(*it, variables, formula, errorReport);
+        }
+    }
+}
+
+bool LibBoolEE::evaluate(const Formula & formula, uint64_t values) {
+    size_t pos = 0;
+    return evaluateRec(formula, pos, values);
+}
+
+bool LibBoolEE::evaluateRec(const Formula & formula, size_t & pos, uint64_t values) {
+    const Formula::Node& node = formula.nodes[pos++];
+    switch (node.op) {
+        case Formula::VARIABLE:
+            return (values >> node.arg) & 1;
+        case Formula::TRUE_CONSTANT:
+            return true;
+        case Formula::FALSE_CONSTANT:
+            return false;
+        case Formula::NOT:
+            return !evaluateRec(formula, pos, values);
+        case Formula::AND: {
+            // All operands are visited to move pos past them
+            bool result = true;
+            for (uint32_t i = 0; i < node.arg; i++) {
+                result &= evaluateRec(formula, pos, values);
+            }
+            return result;
+        }
+        case Formula::OR: {
+            bool result = false;
+            for (uint32_t i = 0; i < node.arg; i++) {
+                result |= evaluateRec(formula, pos, values);
+            }
+            return result;
+        }
+    }
+    return false;
+}
+
 std::string LibBoolEE::trim(const std::string &source) {
     static const std::string WHITESPACES = " \n\r\t\v\f";
     const size_t front = source.find_first_not_of(WHITESPACES);
@@ -34,6 +34,7 @@ this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "tokens/tokens.h"
 
 #include <map>
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <utility>
@@ -44,9 +45,31 @@ public:
     typedef std::map<std::string, bool> Vals; ///< Valuation of atomic propositions
     typedef std::pair<std::string, bool> Val; ///< A single proposition valuation
 
+    /// A formula parsed once by compile() and then evaluated by evaluate() without parsing or allocating.
+    /// The nodes are stored in prefix order, each operator is followed by its operands.
+    struct Formula {
+        enum Op : uint8_t { VARIABLE, TRUE_CONSTANT, FALSE_CONSTANT, NOT, AND, OR };
+
+        struct Node {
+            Op op;
+            uint32_t arg; ///< Index of the variable, or number of operands of AND and OR
+        };
+
+        std::vector<Node> nodes;
+    };
+
+    static const size_t MAX_FORMULA_VARIABLES = 64;
+
     // @return	true iff the formula is true under the valuation (where the valuation are pairs (variable,value))
     static bool resolve(const std::string & source, const Vals & valuation,  ErrorReport* errorReport = nullptr);
 
+    // Parses the formula, throwing the same errors as resolve() would for a valuation of the given variables.
+    // Bit i of the values passed to evaluate() is the value of variables[i], there can be at most MAX_FORMULA_VARIABLES.
+    static void compile(const std::string & source, const std::vector<std::string> & variables, Formula & formula, ErrorReport* errorReport = nullptr);
+
+    // @return	true iff the compiled formula is true when variable i has the value of bit i
+    static bool evaluate(const Formula & formula, uint64_t values);
+
     // @return  new string made from the source by removing whitespaces
     static std::string removeWhitespaces(const std::string & source);
 
@@ -63,6 +86,12 @@ private:
     static bool resolveRec(const std::string & source, const Vals & valuation, ErrorReport* errorReport = nullptr);
 
 
+    // Appends the nodes of the formula, which has no whitespaces, to formula.nodes---used internally
+    static void compileRec(const std::string & source, const std::vector<std::string> & variables, Formula & formula, ErrorReport* errorReport);
+
+    // @return	value of the subformula starting at node pos, and moves pos past it---used internally
+    static bool evaluateRec(const Formula & formula, size_t & pos, uint64_t values);
+
     // @return	new string made from the source by removing the leading and trailing white spaces
     static std::string trim(const std::string & source);
 };
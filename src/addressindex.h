@@ -10,6 +10,8 @@
 #include "amount.h"
 #include "script/script.h"
 
+#include <map>
+
 static const std::string PLB = "PLB";
 
 struct CAddressUnspentKey {
@@ -278,6 +280,72 @@ struct CAddressIndexIteratorTokenKey {
         hashBytes.SetNull();
         token.clear();
     }
+
+    friend bool operator<(const CAddressIndexIteratorTokenKey& a, const CAddressIndexIteratorTokenKey& b) {
+        if (a.type != b.type)
+            return a.type < b.type;
+        if (a.hashBytes != b.hashBytes)
+            return a.hashBytes < b.hashBytes;
+        return a.token < b.token;
+    }
+};
+
+/**
+ * Totals of the address index entries of an address and token, kept by the address balance index.
+ * Deltas with a time lock are also summed per time lock so the locked part of the balance can be told apart.
+ */
+struct CAddressBalanceValue {
+    CAmount received;
+    CAmount balance;
+    std::map<int, CAmount> timeLocked;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(received);
+        READWRITE(balance);
+        READWRITE(timeLocked);
+    }
+
+    CAddressBalanceValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        received = 0;
+        balance = 0;
+        timeLocked.clear();
+    }
+
+    bool IsNull() const {
+        return received == 0 && balance == 0 && timeLocked.empty();
+    }
+
+    // Adds the delta of an address index entry, or takes it away again if fUndo is set
+    void AddDelta(CAmount nDelta, int nTimeLock, bool fUndo) {
+        if (nDelta > 0)
+            received += fUndo ? -nDelta : nDelta;
+        if (fUndo)
+            nDelta = -nDelta;
+        balance += nDelta;
+        if (nTimeLock != 0) {
+            CAmount& nLocked = timeLocked[nTimeLock];
+            nLocked += nDelta;
+            if (nLocked == 0)
+                timeLocked.erase(nTimeLock);
+        }
+    }
+
+    // The part of the balance whose time lock hasn't passed at the given height and median time past
+    CAmount GetLocked(int nHeight, int64_t nMedianTimePast) const {
+        CAmount nLocked = 0;
+        for (const auto& entry : timeLocked) {
+            if (entry.first >= ((int64_t)entry.first < LOCKTIME_THRESHOLD ? (int64_t)nHeight : nMedianTimePast))
+                nLocked += entry.second;
+        }
+        return nLocked;
+    }
 };
 
 struct CAddressIndexIteratorHeightKey {
@@ -11,6 +11,7 @@
 #include "random.h"
 #include "uint256.h"
 #include "utiltime.h"
+#include "crypto/blake2b_header.h"
 #include "crypto/ripemd160.h"
 #include "crypto/sha1.h"
 #include "crypto/sha256.h"
@@ -61,6 +62,31 @@ static void SHA512(benchmark::State& state)
         CSHA512().Write(in.data(), in.size()).Finalize(hash);
 }
 
+static void BLAKE2b_80b(benchmark::State& state)
+{
+    std::vector<uint8_t> in(BLAKE2B_HEADER_SIZE, 0);
+    uint256 hash;
+    while (state.KeepRunning()) {
+        for (uint32_t nonce = 0; nonce < 1000000; nonce++) {
+            WriteLE32(in.data() + BLAKE2B_HEADER_SIZE - 4, nonce);
+            hash = blake2b(in.data(), in.data() + in.size());
+        }
+    }
+}
+
+static void BLAKE2b_80b_midstate8(benchmark::State& state)
+{
+    std::vector<uint8_t> in(BLAKE2B_HEADER_SIZE, 0);
+    uint8_t hashes[BLAKE2B_HEADER_LANES * BLAKE2B_HEADER_HASH_SIZE];
+    Blake2bHeaderMidstate midstate;
+    Blake2bHeaderMidstateInit(midstate, in.data());
+    while (state.KeepRunning()) {
+        for (uint32_t nonce = 0; nonce < 1000000; nonce += BLAKE2B_HEADER_LANES) {
+            Blake2bHeaderHash8(midstate, nonce, hashes);
+        }
+    }
+}
+
 static void SipHash_32b(benchmark::State& state)
 {
     uint256 x;
@@ -99,6 +125,8 @@ BENCHMARK(SHA256);
 BENCHMARK(SHA512);
 
 BENCHMARK(SHA256_32b);
+BENCHMARK(BLAKE2b_80b);
+BENCHMARK(BLAKE2b_80b_midstate8);
 BENCHMARK(SipHash_32b);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
@@ -0,0 +1,29 @@
+// Copyright (c) 2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "tokens/tokens.h"
+
+#include <string>
+#include <vector>
+
+// A mix of the token names seen in token scripts, valid and invalid
+static const std::vector<std::string> vTokenNames = {
+    "MY_TOKEN", "MY_TOKEN/SUB.TOKEN", "MY_TOKEN!", "MY_TOKEN/SUB!", "MY_TOKEN#Unique-tag(1)", "MY_TOKEN~Channel_1",
+    "MY_TOKEN^VOTE", "#KYC", "#KYC/#VERIFIED", "$RESTRICTED", "@USERNAME", "MY__TOKEN", "_MY_TOKEN", "lowercase",
+    "A_VERY_LONG_TOKEN_NAME_BUT_VALID", "PLB",
+};
+
+static void TokenNameValidation(benchmark::State& state)
+{
+    KnownTokenType type;
+    std::string error;
+    while (state.KeepRunning()) {
+        for (const std::string& name : vTokenNames)
+            IsTokenNameValid(name, type, error);
+    }
+}
+
+BENCHMARK(TokenNameValidation);
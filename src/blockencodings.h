@@ -222,6 +222,7 @@ public:
     std::string ipfs;
     int32_t nHeight;
 
+    SerializedTokenData() : units(0), amount(0), reissuable(0), hasIPFS(0), nHeight(-1) {}
     SerializedTokenData(const CDatabasedTokenData &tokenData);
 
     ADD_SERIALIZE_METHODS;
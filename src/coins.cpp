@@ -105,15 +105,15 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
         if (tokensCache) {
             if (tx.IsNewToken()) { // This works are all new root tokens, sub token, and restricted tokens
                 CNewToken token;
-                std::string strAddress;
-                TokenFromTransaction(tx, token, strAddress);
+                CTokenAddress address;
+                TokenFromTransaction(tx, token, address);
 
                 std::string ownerName;
-                std::string ownerAddress;
+                CTokenAddress ownerAddress;
                 OwnerFromTransaction(tx, ownerName, ownerAddress);
 
                 // Add the new token to cache
-                if (!tokensCache->AddNewToken(token, strAddress, nHeight, blockHash))
+                if (!tokensCache->AddNewToken(token, address, nHeight, blockHash))
                     error("%s : Failed at adding a new token to our cache. token: %s", __func__,
                           token.strName);
 
@@ -124,18 +124,18 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
 
             } if (tx.IsNewUsername()) {
                 CNewToken token;
-                std::string strAddress;
-                UsernameFromTransaction(tx, token, strAddress);
+                CTokenAddress address;
+                UsernameFromTransaction(tx, token, address);
 
                 // Add the new token to cache
-                if (!tokensCache->AddNewToken(token, strAddress, nHeight, blockHash))
+                if (!tokensCache->AddNewToken(token, address, nHeight, blockHash))
                     error("%s : Failed at adding a new token to our cache. token: %s", __func__,
                           token.strName);
 
             } else if (tx.IsReissueToken()) {
                 CReissueToken reissue;
-                std::string strAddress;
-                ReissueTokenFromTransaction(tx, reissue, strAddress);
+                CTokenAddress address;
+                ReissueTokenFromTransaction(tx, reissue, address);
 
                 int reissueIndex = tx.vout.size() - 1;
 
@@ -145,7 +145,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                     error("%s: Failed to get the original token that is getting reissued. Token Name : %s",
                           __func__, reissue.strName);
 
-                if (!tokensCache->AddReissueToken(reissue, strAddress, COutPoint(txid, reissueIndex)))
+                if (!tokensCache->AddReissueToken(reissue, address, COutPoint(txid, reissueIndex)))
                     error("%s: Failed to reissue an token. Token Name : %s", __func__, reissue.strName);
 
                 // Check to see if we are reissuing a restricted token
@@ -203,42 +203,42 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                     auto out = tx.vout[n];
 
                     CNewToken token;
-                    std::string strAddress;
+                    CTokenAddress address;
 
                     if (IsScriptNewUniqueToken(out.scriptPubKey)) {
-                        TokenFromScript(out.scriptPubKey, token, strAddress);
+                        TokenFromScript(out.scriptPubKey, token, address);
 
                         // Add the new token to cache
-                        if (!tokensCache->AddNewToken(token, strAddress, nHeight, blockHash))
+                        if (!tokensCache->AddNewToken(token, address, nHeight, blockHash))
                             error("%s : Failed at adding a new token to our cache. token: %s", __func__,
                                   token.strName);
                     }
                 }
             } else if (tx.IsNewMsgChannelToken()) {
                 CNewToken token;
-                std::string strAddress;
-                MsgChannelTokenFromTransaction(tx, token, strAddress);
+                CTokenAddress address;
+                MsgChannelTokenFromTransaction(tx, token, address);
 
                 // Add the new token to cache
-                if (!tokensCache->AddNewToken(token, strAddress, nHeight, blockHash))
+                if (!tokensCache->AddNewToken(token, address, nHeight, blockHash))
                     error("%s : Failed at adding a new token to our cache. token: %s", __func__,
                           token.strName);
             } else if (tx.IsNewQualifierToken()) {
                 CNewToken token;
-                std::string strAddress;
-                QualifierTokenFromTransaction(tx, token, strAddress);
+                CTokenAddress address;
+                QualifierTokenFromTransaction(tx, token, address);
 
                 // Add the new token to cache
-                if (!tokensCache->AddNewToken(token, strAddress, nHeight, blockHash))
+                if (!tokensCache->AddNewToken(token, address, nHeight, blockHash))
                     error("%s : Failed at adding a new qualifier token to our cache. token: %s", __func__,
                           token.strName);
             }  else if (tx.IsNewRestrictedToken()) {
                 CNewToken token;
-                std::string strAddress;
-                RestrictedTokenFromTransaction(tx, token, strAddress);
+                CTokenAddress address;
+                RestrictedTokenFromTransaction(tx, token, address);
 
                 // Add the new token to cache
-                if (!tokensCache->AddNewToken(token, strAddress, nHeight, blockHash))
+                if (!tokensCache->AddNewToken(token, address, nHeight, blockHash))
                     error("%s : Failed at adding a new restricted token to our cache. token: %s", __func__,
                           token.strName);
 
@@ -274,15 +274,16 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
         /** TOKENS START */
         if (AreTokensDeployed()) {
             if (tokensCache) {
-                CTokenOutputEntry tokenData;
-                if (GetTokenData(tx.vout[i].scriptPubKey, tokenData)) {
+                const CTokenOutputEntry* pTokenData = tx.GetTokenOutput(i);
+                if (pTokenData) {
+                    const CTokenOutputEntry& tokenData = *pTokenData;
 
                     // If this is a transfer token, and the amount is greater than zero
                     // We want to make sure it is added to the token addresses database if (fTokenIndex == true)
                     if (tokenData.type == TX_TRANSFER_TOKEN && tokenData.nAmount > 0) {
                         // Create the objects needed from the tokenData
                         CTokenTransfer tokenTransfer(tokenData.tokenName, tokenData.nAmount, tokenData.nTimeLock, tokenData.message, tokenData.expireTime);
-                        std::string address = EncodeDestination(tokenData.destination);
+                        const CTokenAddress& address = tokenData.address;
 
                         // Add the transfer token data to the token cache
                         if (!tokensCache->AddTransferToken(tokenTransfer, address, COutPoint(txid, i), tx.vout[i]))
@@ -291,7 +292,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
 
                         /** Subscribe to new message channels if they are sent to a new address, or they are the owner token or message channel */
 #ifdef ENABLE_WALLET
-                        if (fMessaging && pMessageSubscribedChannelsCache) {
+                        if (fMessaging && pmessagechanneldb) {
                             LOCK(cs_messaging);
                             if (vpwallets.size() && vpwallets[0]->IsMine(tx.vout[i]) == ISMINE_SPENDABLE) {
                                 KnownTokenType aType;
@@ -299,14 +300,14 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
 
                                 if (aType == KnownTokenType::ROOT || aType == KnownTokenType::SUB) {
                                     if (!IsChannelSubscribed(GetParentName(tokenTransfer.strName) + OWNER_TAG)) {
-                                        if (!IsAddressSeen(address)) {
+                                        if (!IsAddressSeen(address.ToString())) {
                                             AddChannel(GetParentName(tokenTransfer.strName) + OWNER_TAG);
-                                            AddAddressSeen(address);
+                                            AddAddressSeen(address.ToString());
                                         }
                                     }
                                 } else if (aType == KnownTokenType::OWNER || aType == KnownTokenType::MSGCHANNEL) {
                                     AddChannel(tokenTransfer.strName);
-                                    AddAddressSeen(address);
+                                    AddAddressSeen(address.ToString());
                                 }
                             }
                         }
@@ -314,7 +315,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                     } else if (tokenData.type == TX_NEW_TOKEN) {
                         /** Subscribe to new message channels if they are tokens you created, or are new msgchannels of channels already being watched */
 #ifdef ENABLE_WALLET
-                        if (fMessaging && pMessageSubscribedChannelsCache) {
+                        if (fMessaging && pmessagechanneldb) {
                             LOCK(cs_messaging);
                             if (vpwallets.size()) {
                                 KnownTokenType aType;
@@ -322,10 +323,10 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                                 if (vpwallets[0]->IsMine(tx.vout[i]) == ISMINE_SPENDABLE) {
                                     if (aType == KnownTokenType::ROOT || aType == KnownTokenType::SUB) {
                                         AddChannel(tokenData.tokenName + OWNER_TAG);
-                                        AddAddressSeen(EncodeDestination(tokenData.destination));
+                                        AddAddressSeen(tokenData.address.ToString());
                                     } else if (aType == KnownTokenType::OWNER || aType == KnownTokenType::MSGCHANNEL) {
                                         AddChannel(tokenData.tokenName);
-                                        AddAddressSeen(EncodeDestination(tokenData.destination));
+                                        AddAddressSeen(tokenData.address.ToString());
                                     }
                                 } else {
                                     if (aType == KnownTokenType::MSGCHANNEL) {
@@ -344,7 +345,7 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, uint2
                 if (script.IsNullToken()) {
                     if (script.IsNullTokenTxDataScript()) {
                         CNullTokenTxData data;
-                        std::string address;
+                        CTokenAddress address;
                         TokenNullDataFromScript(script, data, address);
 
                         KnownTokenType type;
@@ -182,15 +182,16 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
     // Check for negative or overflow output values
     CAmount nValueOut = 0;
     std::set<std::string> setTokenTransferNames;
-    std::map<std::pair<std::string, std::string>, int> mapNullDataTxCount; // (token_name, address) -> int
+    std::map<std::pair<std::string, CTokenAddress>, int> mapNullDataTxCount; // (token_name, address) -> int
     std::set<std::string> setNullGlobalTokenChanges;
     bool fContainsNewRestrictedToken = false;
     bool fContainsRestrictedTokenReissue = false;
     bool fContainsNullTokenVerifierTx = false;
     int nCountAddTagOuts = 0;
 
-    for (const auto& txout : tx.vout)
+    for (unsigned int n = 0; n < tx.vout.size(); n++)
     {
+        const CTxOut& txout = tx.vout[n];
         if (txout.IsEmpty() && !tx.IsCoinBase() && !tx.IsCoinStake())
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-vout-empty");
         if (txout.nValue < 0)
@@ -208,7 +209,7 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
         // Find and handle all new OP_PLB_TOKEN null data transactions
         if (txout.scriptPubKey.IsNullToken()) {
             CNullTokenTxData data;
-            std::string address;
+            CTokenAddress address;
             std::string strError = "";
 
             if (txout.scriptPubKey.IsNullTokenTxDataScript()) {
@@ -272,10 +273,10 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
         if (isToken) {
             // Get the transfer transaction data from the scriptPubKey
             if (nType == TX_TRANSFER_TOKEN) {
-                CTokenTransfer transfer;
-                std::string address;
-                if (!TransferTokenFromScript(txout.scriptPubKey, transfer, address))
+                const CTokenOutputEntry* pTokenData = tx.GetTokenOutput(n);
+                if (!pTokenData)
                     return state.DoS(100, false, REJECT_INVALID, "bad-txns-transfer-token-bad-deserialize");
+                CTokenTransfer transfer(pTokenData->tokenName, pTokenData->nAmount, pTokenData->nTimeLock, pTokenData->message, pTokenData->expireTime);
 
                 // insert into set, so that later on we can check token null data transactions
                 setTokenTransferNames.insert(transfer.strName);
@@ -405,12 +406,12 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
             return state.DoS(100, false, REJECT_INVALID, strError);
 
         CNewToken token;
-        std::string strAddress;
-        if (!TokenFromTransaction(tx, token, strAddress))
+        CTokenAddress address;
+        if (!TokenFromTransaction(tx, token, address))
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-token-from-transaction");
 
         // Validate the new tokens information
-        if (!IsNewOwnerTxValid(tx, token.strName, strAddress, strError))
+        if (!IsNewOwnerTxValid(tx, token.strName, address, strError))
             return state.DoS(100, false, REJECT_INVALID, strError);
 
         if(!CheckNewToken(token, strError))
@@ -424,8 +425,8 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
             return state.DoS(100, false, REJECT_INVALID, strError);
 
         CReissueToken reissue;
-        std::string strAddress;
-        if (!ReissueTokenFromTransaction(tx, reissue, strAddress))
+        CTokenAddress address;
+        if (!ReissueTokenFromTransaction(tx, reissue, address))
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-reissue-token");
 
         if (!CheckReissueToken(reissue, strError))
@@ -466,8 +467,8 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
             if (IsScriptNewUniqueToken(out.scriptPubKey))
             {
                 CNewToken token;
-                std::string strAddress;
-                if (!TokenFromScript(out.scriptPubKey, token, strAddress))
+                CTokenAddress address;
+                if (!TokenFromScript(out.scriptPubKey, token, address))
                     return state.DoS(100, false, REJECT_INVALID, "bad-txns-check-transaction-issue-unique-token-serialization");
 
                 if (!CheckNewToken(token, strError))
@@ -481,8 +482,8 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
             return state.DoS(100, false, REJECT_INVALID, strError);
 
         CNewToken token;
-        std::string strAddress;
-        if (!MsgChannelTokenFromTransaction(tx, token, strAddress))
+        CTokenAddress address;
+        if (!MsgChannelTokenFromTransaction(tx, token, address))
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-msgchannel-from-transaction");
 
         if (!CheckNewToken(token, strError))
@@ -495,8 +496,8 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
             return state.DoS(100, false, REJECT_INVALID, strError);
 
         CNewToken token;
-        std::string strAddress;
-        if (!QualifierTokenFromTransaction(tx, token, strAddress))
+        CTokenAddress address;
+        if (!QualifierTokenFromTransaction(tx, token, address))
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-qualifier-from-transaction");
 
         if (!CheckNewToken(token, strError))
@@ -510,8 +511,8 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
 
         // Get token data
         CNewToken token;
-        std::string strAddress;
-        if (!RestrictedTokenFromTransaction(tx, token, strAddress))
+        CTokenAddress address;
+        if (!RestrictedTokenFromTransaction(tx, token, address))
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-restricted-from-transaction");
 
         if (!CheckNewToken(token, strError))
@@ -532,8 +533,8 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
         }
 
         CNewToken token;
-        std::string strAddress;
-        if (!UsernameFromTransaction(tx, token, strAddress))
+        CTokenAddress address;
+        if (!UsernameFromTransaction(tx, token, address))
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-username-from-transaction");
 
         if (!CheckNewToken(token, strError))
@@ -575,7 +576,7 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
     return true;
 }
 
-bool Consensus::CheckTxInputs(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee)
+bool Consensus::CheckTxInputs(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee, const CGovernanceView* governanceView)
 {
     // are the actual inputs available?
     if (!inputs.HaveInputs(tx)) {
@@ -583,6 +584,9 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, CValidationState& state, c
                          strprintf("%s: inputs missing/spent", __func__), tx.GetHash());
     }
 
+    if (!governanceView)
+        governanceView = pgovernanceTip;
+
     CAmount nValueIn = 0;
 
     for (unsigned int i = 0; i < tx.vin.size(); ++i) {
@@ -605,7 +609,7 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, CValidationState& state, c
         }
         
         if (nSpendHeight >= GetParams().GetConsensus().nGovernanceFixHeight)
-            if (!governance->CanSend(coin.out.scriptPubKey))
+            if (!governanceView->CanSend(coin.out.scriptPubKey))
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-address-frozen");
 
         // Check for negative or overflow input values
@@ -650,7 +654,7 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
     // Create map that stores the amount of an token transaction input. Used to verify no tokens are burned
     std::map<std::string, CAmount> totalInputs;
 
-    std::map<std::string, std::string> mapAddresses;
+    std::map<std::string, CTokenAddress> mapAddresses;
 
     for (unsigned int i = 0; i < tx.vin.size(); ++i) {
         const COutPoint &prevout = tx.vin[i].prevout;
@@ -669,11 +673,11 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
                 totalInputs.insert(make_pair(data.tokenName, data.nAmount));
 
             if (AreMessagesDeployed()) {
-                mapAddresses.insert(make_pair(data.tokenName,EncodeDestination(data.destination)));
+                mapAddresses.insert(make_pair(data.tokenName, data.address));
             }
 
             if (IsTokenNameAnRestricted(data.tokenName)) {
-                if (tokenCache->CheckForAddressRestriction(data.tokenName, EncodeDestination(data.destination), true)) {
+                if (tokenCache->CheckForAddressRestriction(data.tokenName, data.address, true)) {
                     return state.DoS(100, false, REJECT_INVALID, "bad-txns-restricted-token-transfer-from-frozen-address", false, "", tx.GetHash());
                 }
             }
@@ -688,6 +692,7 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
 
     // Create map that stores the amount of an token transaction output. Used to verify no tokens are burned
     std::map<std::string, bool> tokenRoyalties;
+    std::map<std::string, CTokenAddress> tokenRoyaltiesAddresses; // decoded once per token with royalties
     std::map<std::string, CAmount> totalOutputs;
     int index = 0;
     int64_t currentTime = GetTime();
@@ -727,11 +732,12 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
         }
 
         if (nType == TX_TRANSFER_TOKEN) {
-            CTokenTransfer transfer;
-            std::string address = "";
-            if (!TransferTokenFromScript(txout.scriptPubKey, transfer, address))
+            const CTokenOutputEntry* pTokenData = tx.GetTokenOutput(i - 1);
+            if (!pTokenData)
                 return state.DoS(100, false, REJECT_INVALID, "bad-tx-token-transfer-bad-deserialize", false, "",
                                  tx.GetHash());
+            CTokenTransfer transfer(pTokenData->tokenName, pTokenData->nAmount, pTokenData->nTimeLock, pTokenData->message, pTokenData->expireTime);
+            const CTokenAddress& address = pTokenData->address;
 
             if (!ContextualCheckTransferToken(tokenCache, transfer, address, strError))
                 return state.DoS(100, false, REJECT_INVALID, strError, false, "", tx.GetHash());
@@ -760,10 +766,13 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
 
                     if (token.nHasRoyalties && token.nRoyaltiesAmount > 0)
                     {
-                        if (tokenRoyalties.find(transfer.strName) == tokenRoyalties.end())
+                        if (tokenRoyalties.find(transfer.strName) == tokenRoyalties.end()) {
                             tokenRoyalties[transfer.strName] = false;
+                            tokenRoyaltiesAddresses[transfer.strName] = CTokenAddress::FromString(token.nRoyaltiesAddress);
+                        }
 
-                        if (address == token.nRoyaltiesAddress && transfer.nAmount >= token.nRoyaltiesAmount && transfer.nTimeLock == 0)
+                        const CTokenAddress& royaltiesAddress = tokenRoyaltiesAddresses[transfer.strName];
+                        if (!royaltiesAddress.IsNull() && address == royaltiesAddress && transfer.nAmount >= token.nRoyaltiesAmount && transfer.nTimeLock == 0)
                             tokenRoyalties[transfer.strName] = true;
                     }
                 }
@@ -790,7 +799,7 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
             }
         } else if (nType == TX_REISSUE_TOKEN) {
             CReissueToken reissue;
-            std::string address;
+            CTokenAddress address;
             if (!ReissueTokenFromScript(txout.scriptPubKey, reissue, address))
                 return state.DoS(100, false, REJECT_INVALID, "bad-tx-token-reissue-bad-deserialize", false, "", tx.GetHash());
 
@@ -816,7 +825,7 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
         if (tx.IsNewToken()) {
             // Get the token type
             CNewToken token;
-            std::string address;
+            CTokenAddress address;
             if (!TokenFromScript(tx.vout[tx.vout.size() - 1].scriptPubKey, token, address)) {
                 error("%s : Failed to get new token from transaction: %s", __func__, tx.GetHash().GetHex());
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-serialzation-failed", false, "", tx.GetHash());
@@ -830,7 +839,7 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
 
         } else if (tx.IsReissueToken()) {
             CReissueToken reissue_token;
-            std::string address;
+            CTokenAddress address;
             if (!ReissueTokenFromScript(tx.vout[tx.vout.size() - 1].scriptPubKey, reissue_token, address)) {
                 error("%s : Failed to get new token from transaction: %s", __func__, tx.GetHash().GetHex());
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-reissue-serialzation-failed", false, "", tx.GetHash());
@@ -848,8 +857,8 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-msgchannel-before-messaging-is-active", false, "", tx.GetHash());
 
             CNewToken token;
-            std::string strAddress;
-            if (!MsgChannelTokenFromTransaction(tx, token, strAddress))
+            CTokenAddress address;
+            if (!MsgChannelTokenFromTransaction(tx, token, address))
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-msgchannel-serialzation-failed", false, "", tx.GetHash());
 
             if (!ContextualCheckNewToken(tokenCache, token, strError, fCheckMempool))
@@ -860,8 +869,8 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-qualifier-before-it-is-active", false, "", tx.GetHash());
 
             CNewToken token;
-            std::string strAddress;
-            if (!QualifierTokenFromTransaction(tx, token, strAddress))
+            CTokenAddress address;
+            if (!QualifierTokenFromTransaction(tx, token, address))
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-qualifier-serialzation-failed", false, "", tx.GetHash());
 
             if (!ContextualCheckNewToken(tokenCache, token, strError, fCheckMempool))
@@ -873,8 +882,8 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
 
             // Get token data
             CNewToken token;
-            std::string strAddress;
-            if (!RestrictedTokenFromTransaction(tx, token, strAddress))
+            CTokenAddress address;
+            if (!RestrictedTokenFromTransaction(tx, token, address))
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-restricted-serialzation-failed", false, "", tx.GetHash());
 
             if (!ContextualCheckNewToken(tokenCache, token, strError, fCheckMempool))
@@ -886,7 +895,7 @@ bool Consensus::CheckTxTokens(const CTransaction& tx, CValidationState& state, c
                 return state.DoS(100, false, REJECT_INVALID, "bad-txns-issue-restricted-verifier-search-" + strError, false, "", tx.GetHash());
 
             // Check the verifier string against the destination address
-            if (!ContextualCheckVerifierString(tokenCache, verifier.verifier_string, strAddress, strError))
+            if (!ContextualCheckVerifierString(tokenCache, verifier.verifier_string, address, strError))
                 return state.DoS(100, false, REJECT_INVALID, strError, false, "", tx.GetHash());
 
         } else {
@@ -38,7 +38,7 @@ static inline size_t RecursiveDynamicUsage(const CTransaction& tx) {
     for (std::vector<CTxOut>::const_iterator it = tx.vout.begin(); it != tx.vout.end(); it++) {
         mem += RecursiveDynamicUsage(*it);
     }
-    return mem;
+    return mem + tx.GetTokenOutputsDynamicUsage();
 }
 
 static inline size_t RecursiveDynamicUsage(const CMutableTransaction& tx) {
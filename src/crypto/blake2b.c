@@ -71,7 +71,7 @@ static const uint64_t blake2b_iv[8] = {
 };
 
 // Compression function. "last" flag indicates last block.
-static void blake2b_compress(blake2b_ctx *ctx, int last)
+void blake2b_compress_portable(uint64_t h[8], const uint8_t block[128], const uint64_t t[2], int last)
 {
     const uint8_t sigma[12][16] = {
         { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
@@ -92,12 +92,12 @@ static void blake2b_compress(blake2b_ctx *ctx, int last)
 
     // init work variables
     for (i = 0; i < 8; i++) {
-        v[i] = ctx->h[i];
+        v[i] = h[i];
         v[i + 8] = blake2b_iv[i];
     }
 
-    v[12] ^= ctx->t[0]; // low 64 bits of offset
-    v[13] ^= ctx->t[1]; // high 64 bits
+    v[12] ^= t[0]; // low 64 bits of offset
+    v[13] ^= t[1]; // high 64 bits
 
     // last block flag set ?
     if (last) { 
@@ -106,7 +106,7 @@ static void blake2b_compress(blake2b_ctx *ctx, int last)
 
     // get little-endian words
     for (i = 0; i < 16; i++) {
-        m[i] = B2B_GET64(&ctx->b[8 * i]);
+        m[i] = B2B_GET64(&block[8 * i]);
     }
 
     // twelve rounds
@@ -122,10 +122,23 @@ static void blake2b_compress(blake2b_ctx *ctx, int last)
     }
 
     for(i = 0; i < 8; ++i) {
-        ctx->h[i] ^= v[i] ^ v[i + 8];
+        h[i] ^= v[i] ^ v[i + 8];
     }
 }
 
+// Compression function in use, replaced by blake2b_set_compress
+static blake2b_compress_fn blake2b_compress_impl = blake2b_compress_portable;
+
+void blake2b_set_compress(blake2b_compress_fn fn)
+{
+    blake2b_compress_impl = fn;
+}
+
+static void blake2b_compress(blake2b_ctx *ctx, int last)
+{
+    blake2b_compress_impl(ctx->h, ctx->b, ctx->t, last);
+}
+
 // Initialize the hashing context "ctx" with optional key "key".
 // 1 <= outlen <= 64 gives the digest size in bytes.
 // Secret key (also <= 64 bytes) is optional (keylen = 0).
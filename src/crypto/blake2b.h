@@ -27,6 +27,14 @@ typedef struct {
 extern "C" {
 #endif
 
+// Compresses one 128 byte block into the chained state h, t counts the bytes hashed including the block and
+// last is set for the final block
+typedef void (*blake2b_compress_fn)(uint64_t h[8], const uint8_t block[128], const uint64_t t[2], int last);
+
+void blake2b_compress_portable(uint64_t h[8], const uint8_t block[128], const uint64_t t[2], int last);
+// Not thread safe, to be called once at startup (see Blake2bAutoDetect)
+void blake2b_set_compress(blake2b_compress_fn fn);
+
 int blake2b_init(blake2b_ctx *ctx, size_t outlen, const void *key, size_t keylen);
 void blake2b_update(blake2b_ctx *ctx, const void *in, size_t inlen);
 void blake2b_final(blake2b_ctx *ctx, void *out);
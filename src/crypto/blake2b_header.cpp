@@ -0,0 +1,246 @@
+// Copyright (c) 2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "crypto/blake2b_header.h"
+#include "crypto/blake2b.h"
+#include "crypto/common.h"
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__)) && !defined(BUILD_PLB_INTERNAL)
+#include <cpuid.h>
+#if defined(ENABLE_SSE41)
+namespace blake2b_sse41
+{
+void Compress(uint64_t h[8], const uint8_t block[128], const uint64_t t[2], int last);
+void HashHeaders4(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char* out);
+}
+#endif
+#if defined(ENABLE_AVX2)
+namespace blake2b_avx2
+{
+void Compress(uint64_t h[8], const uint8_t block[128], const uint64_t t[2], int last);
+void HashHeaders8(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char* out);
+}
+#endif
+#endif
+
+namespace
+{
+/// Internal BLAKE2b-256 of a single block header.
+namespace blake2b_header
+{
+const uint64_t IV[8] = {
+    0x6A09E667F3BCC908ull, 0xBB67AE8584CAA73Bull, 0x3C6EF372FE94F82Bull, 0xA54FF53A5F1D36F1ull,
+    0x510E527FADE682D1ull, 0x9B05688C2B3E6C1Full, 0x1F83D9ABFB41BD6Bull, 0x5BE0CD19137E2179ull
+};
+
+const uint8_t SIGMA[12][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+    { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+    { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+    { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+    { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+    { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+    { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+    { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+    { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+//! Parameter block of an unkeyed 32 byte digest
+const uint64_t PARAM = 0x01010000ull ^ BLAKE2B_HEADER_HASH_SIZE;
+
+uint64_t inline Rotr(uint64_t x, int n) { return (x >> n) | (x << (64 - n)); }
+
+void inline G(uint64_t* v, int a, int b, int c, int d, uint64_t x, uint64_t y)
+{
+    v[a] = v[a] + v[b] + x;
+    v[d] = Rotr(v[d] ^ v[a], 32);
+    v[c] = v[c] + v[d];
+    v[b] = Rotr(v[b] ^ v[c], 24);
+    v[a] = v[a] + v[b] + y;
+    v[d] = Rotr(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = Rotr(v[b] ^ v[c], 63);
+}
+
+void Hash(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char* out)
+{
+    uint64_t v[16];
+    uint64_t m[16] = {0};
+    memcpy(v, midstate.v, sizeof(v));
+    memcpy(m, midstate.m, sizeof(midstate.m));
+    m[9] |= (uint64_t)nonce << 32;
+
+    // Diagonal step of the first round, the column step is in the midstate
+    G(v, 0, 5, 10, 15, m[8], m[9]);
+    G(v, 1, 6, 11, 12, m[10], m[11]);
+    G(v, 2, 7, 8, 13, m[12], m[13]);
+    G(v, 3, 4, 9, 14, m[14], m[15]);
+
+    for (int i = 1; i < 12; i++) {
+        const uint8_t* s = SIGMA[i];
+        G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    WriteLE64(out, IV[0] ^ PARAM ^ v[0] ^ v[8]);
+    for (int i = 1; i < 4; i++)
+        WriteLE64(out + 8 * i, IV[i] ^ v[i] ^ v[i + 8]);
+}
+
+void Hash8(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char* out)
+{
+    for (size_t i = 0; i < BLAKE2B_HEADER_LANES; i++)
+        Hash(midstate, nonce + (uint32_t)i, out + BLAKE2B_HEADER_HASH_SIZE * i);
+}
+
+} // namespace blake2b_header
+
+typedef void (*HashHeaders8Type)(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char* out);
+
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__)) && !defined(BUILD_PLB_INTERNAL)
+#if defined(ENABLE_SSE41)
+void HashHeaders8SSE41(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char* out)
+{
+    blake2b_sse41::HashHeaders4(midstate, nonce, out);
+    blake2b_sse41::HashHeaders4(midstate, nonce + 4, out + 4 * BLAKE2B_HEADER_HASH_SIZE);
+}
+#endif
+
+#if defined(ENABLE_AVX2)
+//! Whether the OS saves the AVX registers (XCR0 bits 1 and 2), checked after the CPU reported OSXSAVE
+bool AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+#endif
+
+/** Checks the compression function set with blake2b_set_compress and a header hash function against known hashes */
+bool SelfTest(HashHeaders8Type hash8)
+{
+    // BLAKE2b-256 of the bytes 0 .. 79
+    static const unsigned char expected[BLAKE2B_HEADER_HASH_SIZE] = {
+        0x06, 0x6d, 0xe1, 0x00, 0x9d, 0xac, 0xa2, 0xb8, 0x39, 0x0a, 0x9d, 0xc7, 0x34, 0xbc, 0xe5, 0x47,
+        0xac, 0x4e, 0x3c, 0xc4, 0x53, 0x16, 0x45, 0xbb, 0x8b, 0x9c, 0xbc, 0x00, 0x70, 0x94, 0x1d, 0x88
+    };
+    // BLAKE2b-256 of the 300 bytes i * 7
+    static const unsigned char expectedBlocks[BLAKE2B_HEADER_HASH_SIZE] = {
+        0x91, 0xcc, 0xce, 0x0b, 0xa9, 0xe1, 0x58, 0x67, 0x93, 0x4e, 0x70, 0xe0, 0x7d, 0x8d, 0x4a, 0xf1,
+        0x27, 0x0e, 0xc7, 0x57, 0x48, 0xbe, 0x56, 0xa3, 0xf4, 0x8f, 0x5b, 0xc8, 0xb6, 0xc3, 0x96, 0x7d
+    };
+
+    unsigned char header[BLAKE2B_HEADER_SIZE];
+    for (size_t i = 0; i < sizeof(header); i++)
+        header[i] = i;
+
+    // The compression function, through blake2b_hash, on one and on several blocks
+    unsigned char hash[BLAKE2B_HEADER_HASH_SIZE];
+    blake2b_hash(hash, header, sizeof(header));
+    if (memcmp(hash, expected, sizeof(hash))) return false;
+
+    unsigned char data[300];
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = i * 7;
+    blake2b_hash(hash, data, sizeof(data));
+    if (memcmp(hash, expectedBlocks, sizeof(hash))) return false;
+
+    // The header lanes, starting from the nonce of the test vector
+    Blake2bHeaderMidstate midstate;
+    Blake2bHeaderMidstateInit(midstate, header);
+    uint32_t nonce = ReadLE32(header + BLAKE2B_HEADER_SIZE - 4);
+    unsigned char lanes[BLAKE2B_HEADER_LANES * BLAKE2B_HEADER_HASH_SIZE];
+    hash8(midstate, nonce, lanes);
+    if (memcmp(lanes, expected, sizeof(expected))) return false;
+    for (size_t i = 0; i < BLAKE2B_HEADER_LANES; i++) {
+        blake2b_header::Hash(midstate, nonce + (uint32_t)i, hash);
+        if (memcmp(lanes + BLAKE2B_HEADER_HASH_SIZE * i, hash, sizeof(hash))) return false;
+    }
+    return true;
+}
+
+HashHeaders8Type HashHeaders8 = blake2b_header::Hash8;
+
+} // namespace
+
+void Blake2bHeaderMidstateInit(Blake2bHeaderMidstate& midstate, const unsigned char header[BLAKE2B_HEADER_SIZE])
+{
+    using namespace blake2b_header;
+
+    for (int i = 0; i < 10; i++)
+        midstate.m[i] = ReadLE64(header + 8 * i);
+    midstate.m[9] &= 0xFFFFFFFFull;
+
+    uint64_t* v = midstate.v;
+    for (int i = 0; i < 8; i++) {
+        v[i] = IV[i];
+        v[i + 8] = IV[i];
+    }
+    v[0] ^= PARAM;
+    v[12] ^= BLAKE2B_HEADER_SIZE; // bytes hashed
+    v[14] = ~v[14]; // last block
+
+    const uint64_t* m = midstate.m;
+    G(v, 0, 4, 8, 12, m[0], m[1]);
+    G(v, 1, 5, 9, 13, m[2], m[3]);
+    G(v, 2, 6, 10, 14, m[4], m[5]);
+    G(v, 3, 7, 11, 15, m[6], m[7]);
+}
+
+void Blake2bHeaderHash(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char out[BLAKE2B_HEADER_HASH_SIZE])
+{
+    blake2b_header::Hash(midstate, nonce, out);
+}
+
+void Blake2bHeaderHash8(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char out[BLAKE2B_HEADER_LANES * BLAKE2B_HEADER_HASH_SIZE])
+{
+    HashHeaders8(midstate, nonce, out);
+}
+
+std::string Blake2bAutoDetect()
+{
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__)) && !defined(BUILD_PLB_INTERNAL)
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+#if defined(ENABLE_AVX2)
+        bool fAVX = ((ecx >> 27) & 1) && ((ecx >> 28) & 1) && AVXEnabled();
+        uint32_t eax7, ebx7, ecx7, edx7;
+        if (fAVX && __get_cpuid_max(0, nullptr) >= 7) {
+            __cpuid_count(7, 0, eax7, ebx7, ecx7, edx7);
+            if ((ebx7 >> 5) & 1) {
+                HashHeaders8 = blake2b_avx2::HashHeaders8;
+                blake2b_set_compress(blake2b_avx2::Compress);
+                assert(SelfTest(HashHeaders8));
+                return "avx2";
+            }
+        }
+#endif
+#if defined(ENABLE_SSE41)
+        if ((ecx >> 19) & 1) {
+            HashHeaders8 = HashHeaders8SSE41;
+            blake2b_set_compress(blake2b_sse41::Compress);
+            assert(SelfTest(HashHeaders8));
+            return "sse4.1";
+        }
+#endif
+    }
+#endif
+
+    blake2b_set_compress(blake2b_compress_portable);
+    assert(SelfTest(HashHeaders8));
+    return "standard";
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef PLB_CRYPTO_BLAKE2B_HEADER_H
+#define PLB_CRYPTO_BLAKE2B_HEADER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+//! Size of a serialized block header, the nonce is its last 4 bytes
+static const size_t BLAKE2B_HEADER_SIZE = 80;
+
+//! Size of the BLAKE2b-256 hash of a header
+static const size_t BLAKE2B_HEADER_HASH_SIZE = 32;
+
+//! Number of nonces Blake2bHeaderHash8 hashes at once
+static const size_t BLAKE2B_HEADER_LANES = 8;
+
+/**
+ * The BLAKE2b-256 work of a block header that doesn't depend on its nonce.
+ *
+ * A header fits in a single BLAKE2b block, so there is no chained state to reuse between nonces. What the nonces
+ * share is the initialization and the column step of the first round, which only mixes in the words before the one
+ * holding the nonce.
+ */
+struct Blake2bHeaderMidstate
+{
+    //! Working vector after the column step of the first round
+    uint64_t v[16];
+    //! Message words of the header, m[9] with a zero nonce
+    uint64_t m[10];
+};
+
+/** Computes the midstate of a serialized header, its nonce is ignored */
+void Blake2bHeaderMidstateInit(Blake2bHeaderMidstate& midstate, const unsigned char header[BLAKE2B_HEADER_SIZE]);
+
+/** BLAKE2b-256 of the header with the given nonce, the same hash as blake2b() of the serialized header */
+void Blake2bHeaderHash(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char out[BLAKE2B_HEADER_HASH_SIZE]);
+
+/** Hashes the header with the nonces nonce .. nonce + 7, hash i is written to out + 32 * i */
+void Blake2bHeaderHash8(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char out[BLAKE2B_HEADER_LANES * BLAKE2B_HEADER_HASH_SIZE]);
+
+/** Autodetect the best available BLAKE2b implementation, for blake2b() and the header hashes.
+ *  Returns the name of the implementation.
+ */
+std::string Blake2bAutoDetect();
+
+#endif // PLB_CRYPTO_BLAKE2B_HEADER_H
@@ -0,0 +1,179 @@
+// Copyright (c) 2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// BLAKE2b with SSE4.1 intrinsics. The compression function keeps the rows of the working vector in pairs of 128 bit
+// registers, the header hashes run one nonce per 64 bit lane.
+
+#ifdef ENABLE_SSE41
+
+#include "crypto/blake2b_header.h"
+#include "crypto/common.h"
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace blake2b_sse41
+{
+namespace
+{
+const uint64_t IV[8] = {
+    0x6A09E667F3BCC908ull, 0xBB67AE8584CAA73Bull, 0x3C6EF372FE94F82Bull, 0xA54FF53A5F1D36F1ull,
+    0x510E527FADE682D1ull, 0x9B05688C2B3E6C1Full, 0x1F83D9ABFB41BD6Bull, 0x5BE0CD19137E2179ull
+};
+
+const uint8_t SIGMA[12][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+    { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+    { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+    { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+    { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+    { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+    { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+    { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+    { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+__m128i inline Add(__m128i x, __m128i y) { return _mm_add_epi64(x, y); }
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+__m128i inline Rotr32(__m128i x) { return _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)); }
+__m128i inline Rotr24(__m128i x) { return _mm_shuffle_epi8(x, _mm_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10)); }
+__m128i inline Rotr16(__m128i x) { return _mm_shuffle_epi8(x, _mm_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9)); }
+__m128i inline Rotr63(__m128i x) { return Xor(_mm_srli_epi64(x, 63), Add(x, x)); }
+
+/** Half a G on two columns or diagonals at once, a..d hold the words of both */
+void inline G1(__m128i& a, __m128i& b, __m128i& c, __m128i& d, __m128i x)
+{
+    a = Add(Add(a, b), x);
+    d = Rotr32(Xor(d, a));
+    c = Add(c, d);
+    b = Rotr24(Xor(b, c));
+}
+
+void inline G2(__m128i& a, __m128i& b, __m128i& c, __m128i& d, __m128i y)
+{
+    a = Add(Add(a, b), y);
+    d = Rotr16(Xor(d, a));
+    c = Add(c, d);
+    b = Rotr63(Xor(b, c));
+}
+
+/** Both halves of G on one nonce per lane */
+void inline G(__m128i* v, int a, int b, int c, int d, __m128i x, __m128i y)
+{
+    G1(v[a], v[b], v[c], v[d], x);
+    G2(v[a], v[b], v[c], v[d], y);
+}
+
+__m128i inline Words(const uint64_t* m, int i, int j) { return _mm_set_epi64x(m[j], m[i]); }
+
+/** Hashes the nonces nonce and nonce + 1 */
+void HashHeaders2(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char* out)
+{
+    __m128i v[16], m[16];
+    for (int i = 0; i < 16; i++)
+        v[i] = _mm_set1_epi64x(midstate.v[i]);
+    for (int i = 0; i < 10; i++)
+        m[i] = _mm_set1_epi64x(midstate.m[i]);
+    for (int i = 10; i < 16; i++)
+        m[i] = _mm_setzero_si128();
+    m[9] = _mm_or_si128(m[9], _mm_set_epi64x((uint64_t)(nonce + 1) << 32, (uint64_t)nonce << 32));
+
+    G(v, 0, 5, 10, 15, m[8], m[9]);
+    G(v, 1, 6, 11, 12, m[10], m[11]);
+    G(v, 2, 7, 8, 13, m[12], m[13]);
+    G(v, 3, 4, 9, 14, m[14], m[15]);
+
+    for (int r = 1; r < 12; r++) {
+        const uint8_t* s = SIGMA[r];
+        G(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        G(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        G(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        G(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        G(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        G(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        G(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    alignas(16) uint64_t h[4][2];
+    for (int i = 0; i < 4; i++)
+        _mm_store_si128((__m128i*)h[i], Xor(v[i], v[i + 8]));
+    const uint64_t h0 = IV[0] ^ 0x01010000ull ^ BLAKE2B_HEADER_HASH_SIZE;
+    for (int lane = 0; lane < 2; lane++) {
+        unsigned char* hash = out + BLAKE2B_HEADER_HASH_SIZE * lane;
+        WriteLE64(hash, h0 ^ h[0][lane]);
+        for (int i = 1; i < 4; i++)
+            WriteLE64(hash + 8 * i, IV[i] ^ h[i][lane]);
+    }
+}
+
+} // namespace
+
+void Compress(uint64_t h[8], const uint8_t block[128], const uint64_t t[2], int last)
+{
+    uint64_t m[16];
+    for (int i = 0; i < 16; i++)
+        m[i] = ReadLE64(block + 8 * i);
+
+    const __m128i* hv = (const __m128i*)h;
+    __m128i row1l = _mm_loadu_si128(hv);
+    __m128i row1h = _mm_loadu_si128(hv + 1);
+    __m128i row2l = _mm_loadu_si128(hv + 2);
+    __m128i row2h = _mm_loadu_si128(hv + 3);
+    __m128i row3l = _mm_set_epi64x(IV[1], IV[0]);
+    __m128i row3h = _mm_set_epi64x(IV[3], IV[2]);
+    __m128i row4l = Xor(_mm_set_epi64x(IV[5], IV[4]), _mm_set_epi64x(t[1], t[0]));
+    __m128i row4h = Xor(_mm_set_epi64x(IV[7], IV[6]), _mm_set_epi64x(0, last ? ~0ull : 0));
+
+    for (int r = 0; r < 12; r++) {
+        const uint8_t* s = SIGMA[r];
+
+        // Columns
+        G1(row1l, row2l, row3l, row4l, Words(m, s[0], s[2]));
+        G1(row1h, row2h, row3h, row4h, Words(m, s[4], s[6]));
+        G2(row1l, row2l, row3l, row4l, Words(m, s[1], s[3]));
+        G2(row1h, row2h, row3h, row4h, Words(m, s[5], s[7]));
+
+        // Diagonals, rotating rows 2, 3 and 4 left by one, two and three words
+        __m128i t0 = _mm_alignr_epi8(row2h, row2l, 8);
+        __m128i t1 = _mm_alignr_epi8(row2l, row2h, 8);
+        row2l = t0; row2h = t1;
+        t0 = row3l; row3l = row3h; row3h = t0;
+        t0 = _mm_alignr_epi8(row4h, row4l, 8);
+        t1 = _mm_alignr_epi8(row4l, row4h, 8);
+        row4l = t1; row4h = t0;
+
+        G1(row1l, row2l, row3l, row4l, Words(m, s[8], s[10]));
+        G1(row1h, row2h, row3h, row4h, Words(m, s[12], s[14]));
+        G2(row1l, row2l, row3l, row4l, Words(m, s[9], s[11]));
+        G2(row1h, row2h, row3h, row4h, Words(m, s[13], s[15]));
+
+        t0 = _mm_alignr_epi8(row2l, row2h, 8);
+        t1 = _mm_alignr_epi8(row2h, row2l, 8);
+        row2l = t0; row2h = t1;
+        t0 = row3l; row3l = row3h; row3h = t0;
+        t0 = _mm_alignr_epi8(row4l, row4h, 8);
+        t1 = _mm_alignr_epi8(row4h, row4l, 8);
+        row4l = t1; row4h = t0;
+    }
+
+    __m128i* hw = (__m128i*)h;
+    _mm_storeu_si128(hw, Xor(_mm_loadu_si128(hw), Xor(row1l, row3l)));
+    _mm_storeu_si128(hw + 1, Xor(_mm_loadu_si128(hw + 1), Xor(row1h, row3h)));
+    _mm_storeu_si128(hw + 2, Xor(_mm_loadu_si128(hw + 2), Xor(row2l, row4l)));
+    _mm_storeu_si128(hw + 3, Xor(_mm_loadu_si128(hw + 3), Xor(row2h, row4h)));
+}
+
+void HashHeaders4(const Blake2bHeaderMidstate& midstate, uint32_t nonce, unsigned char* out)
+{
+    HashHeaders2(midstate, nonce, out);
+    HashHeaders2(midstate, nonce + 2, out + 2 * BLAKE2B_HEADER_HASH_SIZE);
+}
+
+} // namespace blake2b_sse41
+
+#endif
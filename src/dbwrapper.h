@@ -14,6 +14,8 @@
 #include "utilstrencodings.h"
 #include "version.h"
 
+#include <map>
+
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 
@@ -48,6 +50,7 @@ const std::vector<unsigned char>& GetObfuscateKey(const CDBWrapper &w);
 class CDBBatch
 {
     friend class CDBWrapper;
+    friend class CDBOrderedBatch;
 
 private:
     const CDBWrapper &parent;
@@ -58,27 +61,11 @@ private:
 
     size_t size_estimate;
 
-public:
-    /**
-     * @param[in] _parent   CDBWrapper that this batch is to be submitted to
-     */
-    explicit CDBBatch(const CDBWrapper &_parent) : parent(_parent), ssKey(SER_DISK, CLIENT_VERSION), ssValue(SER_DISK, CLIENT_VERSION), size_estimate(0) { };
-
-    void Clear()
-    {
-        batch.Clear();
-        size_estimate = 0;
-    }
-
-    template <typename K, typename V>
-    void Write(const K& key, const V& value)
+    //! Puts the key and value serialized to ssKey and ssValue into the batch, and clears both
+    void WriteStreams()
     {
-        ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
-        ssKey << key;
         leveldb::Slice slKey(ssKey.data(), ssKey.size());
 
-        ssValue.reserve(DBWRAPPER_PREALLOC_VALUE_SIZE);
-        ssValue << value;
         ssValue.Xor(dbwrapper_private::GetObfuscateKey(parent));
         leveldb::Slice slValue(ssValue.data(), ssValue.size());
 
@@ -95,11 +82,9 @@ public:
         ssValue.clear();
     }
 
-    template <typename K>
-    void Erase(const K& key)
+    //! Erases the key serialized to ssKey, and clears it
+    void EraseStream()
     {
-        ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
-        ssKey << key;
         leveldb::Slice slKey(ssKey.data(), ssKey.size());
 
         batch.Delete(slKey);
@@ -112,9 +97,86 @@ public:
         ssKey.clear();
     }
 
+public:
+    /**
+     * @param[in] _parent   CDBWrapper that this batch is to be submitted to
+     */
+    explicit CDBBatch(const CDBWrapper &_parent) : parent(_parent), ssKey(SER_DISK, CLIENT_VERSION), ssValue(SER_DISK, CLIENT_VERSION), size_estimate(0) { };
+
+    void Clear()
+    {
+        batch.Clear();
+        size_estimate = 0;
+    }
+
+    template <typename K, typename V>
+    void Write(const K& key, const V& value)
+    {
+        ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+        ssKey << key;
+        ssValue.reserve(DBWRAPPER_PREALLOC_VALUE_SIZE);
+        ssValue << value;
+        WriteStreams();
+    }
+
+    template <typename K>
+    void Erase(const K& key)
+    {
+        ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+        ssKey << key;
+        EraseStream();
+    }
+
     size_t SizeEstimate() const { return size_estimate; }
 };
 
+/** Changes that are handed to a CDBBatch sorted by their serialized key, the order LevelDB stores them in.
+ *  A later write or erase of a key replaces the earlier one, the same as it would within a single batch.
+ */
+class CDBOrderedBatch
+{
+private:
+    //! Serialized key -> (erased, serialized value). Values are obfuscated when they are added to a CDBBatch
+    std::map<std::string, std::pair<bool, std::string> > mapChanges;
+
+    template <typename T>
+    static std::string Serialize(const T& obj, size_t nPrealloc)
+    {
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss.reserve(nPrealloc);
+        ss << obj;
+        return ss.str();
+    }
+
+public:
+    template <typename K, typename V>
+    void Write(const K& key, const V& value)
+    {
+        mapChanges[Serialize(key, DBWRAPPER_PREALLOC_KEY_SIZE)] = std::make_pair(false, Serialize(value, DBWRAPPER_PREALLOC_VALUE_SIZE));
+    }
+
+    template <typename K>
+    void Erase(const K& key)
+    {
+        mapChanges[Serialize(key, DBWRAPPER_PREALLOC_KEY_SIZE)] = std::make_pair(true, std::string());
+    }
+
+    size_t Size() const { return mapChanges.size(); }
+
+    void AddTo(CDBBatch& batch) const
+    {
+        for (const auto& change : mapChanges) {
+            batch.ssKey.write(change.first.data(), change.first.size());
+            if (change.second.first) {
+                batch.EraseStream();
+            } else {
+                batch.ssValue.write(change.second.second.data(), change.second.second.size());
+                batch.WriteStreams();
+            }
+        }
+    }
+};
+
 class CDBIterator
 {
 private:
@@ -134,6 +196,7 @@ public:
     bool Valid() const;
 
     void SeekToFirst();
+    void SeekToLast();
 
     template<typename K> void Seek(const K& key) {
         CDataStream ssKey(SER_DISK, CLIENT_VERSION);
@@ -144,6 +207,7 @@ public:
     }
 
     void Next();
+    void Prev();
 
     template<typename K> bool GetKey(K& key) {
         leveldb::Slice slKey = piter->key();
@@ -168,6 +232,10 @@ public:
         return true;
     }
 
+    unsigned int GetKeySize() {
+        return piter->key().size();
+    }
+
     unsigned int GetValueSize() {
         return piter->value().size();
     }
@@ -12,6 +12,7 @@
 #include <amount.h>
 #include <base58.h>
 #include <chain.h>
+#include <random.h>
 #include <util.h>
 
 static const CScript DUMMY_SCRIPT = CScript() << ParseHex("6885777789"); 
@@ -23,6 +24,7 @@ static const char DB_AUTORIZATION = 'p';
 static const char DB_FEE_ADDRESS = 'f';
 static const char DB_ADDRESS = 'a';
 static const char DB_COST = 'c';
+static const char DB_BEST_BLOCK = 'B';
 
 static const char DB_GOVERNANCE_INIT  = 'G';
 
@@ -179,142 +181,389 @@ namespace {
     };
 }
 
-CGovernance::CGovernance(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "governance", nCacheSize, fMemory, fWipe) 
-{
+SaltedScriptHasher::SaltedScriptHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+
+static bool GetCostTypeName(int type, std::string& type_name) {
+    if (type == GOVERNANCE_COST_ROOT) {
+        type_name = "root";
+    } else if (type == GOVERNANCE_COST_REISSUE) {
+        type_name = "reissue";
+    } else if (type == GOVERNANCE_COST_UNIQUE) {
+        type_name = "unique";
+    } else if (type == GOVERNANCE_COST_SUB) {
+        type_name = "sub";
+    } else if (type == GOVERNANCE_COST_USERNAME) {
+        type_name = "username";
+    } else {
+        return false;
+    }
+
+    return true;
 }
 
-bool CGovernance::Init(bool fWipe, const CChainParams& chainparams) {
-    bool init;
+/**
+ * CGovernanceView
+ */
 
-    if (fWipe || Read(DB_GOVERNANCE_INIT, init) == false || init == false) {
-        LogPrintf("Governance: Creating new database\n");
+CAmount CGovernanceView::GetCost(int type) const {
+    std::map<int, CAmount> entries;
+    GetCostEntries(type, entries);
 
-        CDBBatch batch(*this);
+    // The most recent update for the type is the active cost
+    if (entries.empty())
+        return CostDetails().cost;
 
-        batch.Write(DB_NUMBER_FROZEN, 0);
+    return entries.rbegin()->second;
+}
 
-        // Add dummy entries will be first for searching the database
-        batch.Write(AuthorityEntry(), AuthorityDetails());
-        batch.Write(FreezeEntry(), FreezeDetails());
-        batch.Write(CostEntry(), CostDetails());
+CScript CGovernanceView::GetFeeScript() const {
+    std::map<int, CScript> entries;
+    GetFeeScriptEntries(entries);
 
-        // Add initial token issuance cost values
-        batch.Write(CostEntry(GOVERNANCE_COST_ROOT, 0), CostDetails(chainparams.IssueTokenFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_REISSUE, 0), CostDetails(chainparams.ReissueTokenFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_UNIQUE, 0), CostDetails(chainparams.IssueUniqueTokenFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_SUB, 0), CostDetails(chainparams.IssueUniqueTokenFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_USERNAME, 0), CostDetails(chainparams.IssueUsernameTokenFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_MSG_CHANNEL, 0), CostDetails(chainparams.IssueMsgChannelTokenFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_QUALIFIER, 0), CostDetails(chainparams.IssueQualifierTokenFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_SUB_QUALIFIER, 0), CostDetails(chainparams.IssueSubQualifierTokenFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_NULL_QUALIFIER, 0), CostDetails(chainparams.AddNullQualifierTagFeeAmount()));
-        batch.Write(CostEntry(GOVERNANCE_COST_RESTRICTED, 0), CostDetails(chainparams.IssueRestrictedTokenFeeAmount()));
+    if (entries.empty())
+        return FeeDetails().script;
 
-        // Init PoS-A addresses
-        const std::set<std::string> init_authorized = chainparams.GetInitAuthorized();
-        for (auto auth_address : init_authorized) {
-            CTxDestination auth_destination = DecodeDestination(auth_address);
-            CScript authScript = GetScriptForDestination(auth_destination);
-            batch.Write(AuthorityEntry(authScript), AuthorityDetails(true));
-        }
+    return entries.rbegin()->second;
+}
 
-        // Add initial token fee address from chainparams
-        CTxDestination destination = DecodeDestination(GetParams().TokenFeeAddress());
-        CScript feeScript = GetScriptForDestination(destination);
-        batch.Write(FeeEntry(), FeeDetails(feeScript));
+bool CGovernanceView::ScriptExist(const CScript& script) const {
+    bool frozen;
+    return GetFreezeEntry(script, frozen);
+}
 
-        batch.Write(DB_GOVERNANCE_INIT, true);
-        WriteBatch(batch);
+bool CGovernanceView::CanSend(const CScript& script) const {
+    bool frozen;
+    if (!GetFreezeEntry(script, frozen)) {
+        return true;
     }
 
+    return !frozen;
+}
+
+bool CGovernanceView::AuthorityExist(const CScript& script) const {
+    bool authorized;
+    return GetAuthorityEntry(script, authorized);
+}
+
+CScript CGovernanceView::GetValidatorScript(const CScript& script) {
+    // Handle pay-to-public-key outputs properly
+    if (script.IsPayToPublicKey()) {
+        uint160 hashBytes(Hash160(script.begin() + 1, script.end() - 1));
+        return CScript() << OP_DUP << OP_HASH160 << ToByteVector(hashBytes) << OP_EQUALVERIFY << OP_CHECKSIG;
+    }
+
+    return script;
+}
+
+bool CGovernanceView::CanStake(const CScript& script) const {
+    bool authorized;
+    if (!GetAuthorityEntry(GetValidatorScript(script), authorized)) {
+        return false;
+    }
+
+    return authorized;
+}
+
+bool CGovernanceView::DumpFreezeStats(std::vector< std::pair< CScript, bool > > *FreezeVector) const {
+    std::map<CScript, bool> entries;
+    GetFreezeEntries(entries);
+
+    for (const auto& entry : entries)
+        FreezeVector->emplace_back(entry.first, entry.second);
+
     return true;
 }
 
-unsigned int CGovernance::GetNumberOfFrozenScripts() {
-    unsigned int number;
+bool CGovernanceView::GetFrozenScripts(std::vector< CScript > *FreezeVector) const {
+    std::map<CScript, bool> entries;
+    GetFreezeEntries(entries);
 
-    Read(DB_NUMBER_FROZEN, number);
+    for (const auto& entry : entries) {
+        if (entry.second)
+            FreezeVector->emplace_back(entry.first);
+    }
 
-    return number;
+    return true;
 }
 
-bool CGovernance::FreezeScript(CScript script) {
-    FreezeEntry entry(script);
-    FreezeDetails details = FreezeDetails();
-    CDBBatch batch(*this);
+bool CGovernanceView::GetActiveValidators(std::vector< std::string > *ValidatorsVector) const {
+    std::map<CScript, bool> entries;
+    GetAuthorityEntries(entries);
 
-    unsigned int number;
-    Read(DB_NUMBER_FROZEN, number);
+    for (const auto& entry : entries) {
+        if (entry.second) {
+            CTxDestination authorizedDestination;
+            ExtractDestination(entry.first, authorizedDestination);
+            CPaladeumAddress validatorAddress(authorizedDestination);
 
-    if (Read(entry, details)) {
-        if (!details.frozen) {
-            LogPrintf("Governance: Adding script %s back to freeze list\n", HexStr(script));
+            ValidatorsVector->emplace_back(validatorAddress.ToString());
+        }
+    }
+
+    return true;
+}
+
+bool CGovernanceView::GetActiveValidatorsScript(std::vector< CScript > *ValidatorsVector) const {
+    CGovernanceScriptSet validators;
+    GetValidators(validators);
+
+    ValidatorsVector->assign(validators.begin(), validators.end());
+
+    return true;
+}
+
+/**
+ * CGovernanceCache
+ */
+
+CGovernanceCache::CGovernanceCache(CGovernanceView* baseIn) : base(baseIn), nFrozenDelta(0), nAuthorizedDelta(0), nValidatorChanges(0)
+{
+}
+
+bool CGovernanceCache::GetFreezeEntry(const CScript& script, bool& frozen) const {
+    LOCK(cs_governance);
+
+    auto it = mapFreeze.find(script);
+    if (it != mapFreeze.end()) {
+        frozen = it->second;
+        return true;
+    }
+
+    return base->GetFreezeEntry(script, frozen);
+}
+
+bool CGovernanceCache::GetAuthorityEntry(const CScript& script, bool& authorized) const {
+    LOCK(cs_governance);
+
+    auto it = mapAuthority.find(script);
+    if (it != mapAuthority.end()) {
+        authorized = it->second;
+        return true;
+    }
+
+    return base->GetAuthorityEntry(script, authorized);
+}
+
+bool CGovernanceCache::GetCostEntry(int type, int height, CAmount& cost) const {
+    LOCK(cs_governance);
+
+    auto key = std::make_pair(type, height);
+    auto it = mapCostToAdd.find(key);
+    if (it != mapCostToAdd.end()) {
+        cost = it->second;
+        return true;
+    }
+
+    if (setCostToRemove.count(key))
+        return false;
+
+    return base->GetCostEntry(type, height, cost);
+}
+
+bool CGovernanceCache::GetFeeScriptEntry(int height, CScript& script) const {
+    LOCK(cs_governance);
+
+    auto it = mapFeeScriptToAdd.find(height);
+    if (it != mapFeeScriptToAdd.end()) {
+        script = it->second;
+        return true;
+    }
+
+    if (setFeeScriptToRemove.count(height))
+        return false;
 
-            details.frozen = true;
-            batch.Write(entry, details);
-            batch.Write(DB_NUMBER_FROZEN, number + 1);
+    return base->GetFeeScriptEntry(height, script);
+}
+
+void CGovernanceCache::GetFreezeEntries(std::map<CScript, bool>& entries) const {
+    LOCK(cs_governance);
+
+    base->GetFreezeEntries(entries);
+    for (const auto& item : mapFreeze)
+        entries[item.first] = item.second;
+}
+
+void CGovernanceCache::GetAuthorityEntries(std::map<CScript, bool>& entries) const {
+    LOCK(cs_governance);
+
+    base->GetAuthorityEntries(entries);
+    for (const auto& item : mapAuthority)
+        entries[item.first] = item.second;
+}
+
+void CGovernanceCache::GetCostEntries(int type, std::map<int, CAmount>& entries) const {
+    LOCK(cs_governance);
+
+    base->GetCostEntries(type, entries);
+    for (const auto& item : setCostToRemove) {
+        if (item.first == type)
+            entries.erase(item.second);
+    }
+
+    for (const auto& item : mapCostToAdd) {
+        if (item.first.first == type)
+            entries[item.first.second] = item.second;
+    }
+}
+
+void CGovernanceCache::GetFeeScriptEntries(std::map<int, CScript>& entries) const {
+    LOCK(cs_governance);
+
+    base->GetFeeScriptEntries(entries);
+    for (const auto& item : setFeeScriptToRemove)
+        entries.erase(item);
+
+    for (const auto& item : mapFeeScriptToAdd)
+        entries[item.first] = item.second;
+}
+
+unsigned int CGovernanceCache::GetNumberOfAuthorizedScripts() const {
+    LOCK(cs_governance);
+    return base->GetNumberOfAuthorizedScripts() + nAuthorizedDelta;
+}
+
+void CGovernanceCache::GetValidators(CGovernanceScriptSet& validators) const {
+    LOCK(cs_governance);
+
+    base->GetValidators(validators);
+    for (const auto& item : mapAuthority) {
+        if (item.second)
+            validators.insert(item.first);
+        else
+            validators.erase(item.first);
+    }
+}
+
+uint64_t CGovernanceCache::GetValidatorEpoch() const {
+    LOCK(cs_governance);
+
+    // Changes move from child to parent on flush, so the sum stays the same
+    // for an unchanged authorization list and grows with every change
+    return base->GetValidatorEpoch() + nValidatorChanges;
+}
+
+unsigned int CGovernanceCache::GetNumberOfFrozenScripts() const {
+    LOCK(cs_governance);
+    return base->GetNumberOfFrozenScripts() + nFrozenDelta;
+}
+
+CAmount CGovernanceCache::GetCost(int type) const {
+    LOCK(cs_governance);
+
+    bool fDirty = false;
+    for (const auto& item : mapCostToAdd)
+        fDirty |= item.first.first == type;
+    for (const auto& item : setCostToRemove)
+        fDirty |= item.first == type;
+
+    // Nothing changed for this type, let the parent answer without copying its history
+    if (!fDirty)
+        return base->GetCost(type);
+
+    return CGovernanceView::GetCost(type);
+}
+
+CScript CGovernanceCache::GetFeeScript() const {
+    LOCK(cs_governance);
+
+    if (mapFeeScriptToAdd.empty() && setFeeScriptToRemove.empty())
+        return base->GetFeeScript();
+
+    return CGovernanceView::GetFeeScript();
+}
+
+bool CGovernanceCache::BatchWrite(CGovernanceCache& cache) {
+    LOCK(cs_governance);
+
+    for (const auto& item : cache.mapFreeze)
+        mapFreeze[item.first] = item.second;
+
+    for (const auto& item : cache.mapAuthority)
+        mapAuthority[item.first] = item.second;
+
+    for (const auto& item : cache.setCostToRemove) {
+        mapCostToAdd.erase(item);
+        setCostToRemove.insert(item);
+    }
+
+    for (const auto& item : cache.mapCostToAdd) {
+        setCostToRemove.erase(item.first);
+        mapCostToAdd[item.first] = item.second;
+    }
+
+    for (const auto& item : cache.setFeeScriptToRemove) {
+        mapFeeScriptToAdd.erase(item);
+        setFeeScriptToRemove.insert(item);
+    }
+
+    for (const auto& item : cache.mapFeeScriptToAdd) {
+        setFeeScriptToRemove.erase(item.first);
+        mapFeeScriptToAdd[item.first] = item.second;
+    }
+
+    nFrozenDelta += cache.nFrozenDelta;
+    nAuthorizedDelta += cache.nAuthorizedDelta;
+    nValidatorChanges += cache.nValidatorChanges;
+
+    if (!cache.hashBlock.IsNull())
+        hashBlock = cache.hashBlock;
+
+    return true;
+}
+
+bool CGovernanceCache::FreezeScript(const CScript& script) {
+    LOCK(cs_governance);
+
+    bool frozen;
+    if (GetFreezeEntry(script, frozen)) {
+        if (!frozen) {
+            LogPrintf("Governance: Adding script %s back to freeze list\n", HexStr(script));
+            nFrozenDelta++;
         } else {
             LogPrintf("Governance: Script %s already frozen\n", HexStr(script));
-            batch.Write(entry, details);
         }
     } else {
         LogPrintf("Governance: Freezing previously unknown script %s\n", HexStr(script));
-
-        batch.Write(entry, FreezeDetails());
-        batch.Write(DB_NUMBER_FROZEN, number + 1);
+        nFrozenDelta++;
     }
 
-    return WriteBatch(batch);
+    mapFreeze[script] = true;
+    return true;
 }
 
-bool CGovernance::UnfreezeScript(CScript script) {
-    FreezeEntry entry(script);
-    FreezeDetails details = FreezeDetails();
-    CDBBatch batch(*this);
+bool CGovernanceCache::UnfreezeScript(const CScript& script) {
+    LOCK(cs_governance);
 
-    unsigned int number;
-    Read(DB_NUMBER_FROZEN, number);
-
-    if (Read(entry, details)) {
-        if (details.frozen) {
+    bool frozen;
+    if (GetFreezeEntry(script, frozen)) {
+        if (frozen) {
             LogPrintf("Governance: Removing script %s from freeze list\n", HexStr(script));
-
-            details.frozen = false;
-            batch.Write(entry, details);
-            batch.Write(DB_NUMBER_FROZEN, number - 1);
+            nFrozenDelta--;
         } else {
             LogPrintf("Governance: Script %s already unfrozen\n", HexStr(script));
-            batch.Write(entry, details);
         }
     } else {
         LogPrintf("Governance: Unfreezing previously unknown script %s\n", HexStr(script));
-        batch.Write(entry, FreezeDetails(false));
     }
 
-    return WriteBatch(batch);
+    mapFreeze[script] = false;
+    return true;
 }
 
-bool CGovernance::RevertFreezeScript(CScript script) {
+bool CGovernanceCache::RevertFreezeScript(const CScript& script) {
     // This is different from unfreezing
     // Reverting immediately removes script from the freeze list,
     // This routine only does so if scrip was only added to the list once
 
-    FreezeEntry entry(script);
-    FreezeDetails details = FreezeDetails();
-    CDBBatch batch(*this);
-
-    unsigned int number;
-    Read(DB_NUMBER_FROZEN, number);
+    LOCK(cs_governance);
 
-    if (Read(entry, details)) {
-        if (details.frozen) {
+    bool frozen;
+    if (GetFreezeEntry(script, frozen)) {
+        if (frozen) {
             LogPrintf("Governance: Revert adding of script %s to freeze list\n", HexStr(script));
 
             LogPrintf("Governance: Unfreezing script %s\n", HexStr(script));
-            details.frozen = false;
-            batch.Write(DB_NUMBER_FROZEN, number - 1);
-
-            batch.Write(entry, details);
+            nFrozenDelta--;
         } else {
             LogPrintf("Trying to revert freezing of script, database is corrupted\n");
             return false;
@@ -324,30 +573,24 @@ bool CGovernance::RevertFreezeScript(CScript script) {
         return false;
     }
 
-    return WriteBatch(batch);
+    mapFreeze[script] = false;
+    return true;
 }
 
-bool CGovernance::RevertUnfreezeScript(CScript script) {
+bool CGovernanceCache::RevertUnfreezeScript(const CScript& script) {
     // This is different from freezing
     // Reverting immediately adds script to the freeze list,
     // This routine only does so if script was only removed from the list once
 
-    FreezeEntry entry(script);
-    FreezeDetails details = FreezeDetails();
-    CDBBatch batch(*this);
+    LOCK(cs_governance);
 
-    unsigned int number;
-    Read(DB_NUMBER_FROZEN, number);
-
-    if (Read(entry, details)) {
-        if (!details.frozen) {
+    bool frozen;
+    if (GetFreezeEntry(script, frozen)) {
+        if (!frozen) {
             LogPrintf("Governance: Revert disabling of script %s\n", HexStr(script));
 
             LogPrintf("Governance: Freezing script %s\n", HexStr(script));
-            details.frozen = true;
-            batch.Write(DB_NUMBER_FROZEN, number + 1);
-
-            batch.Write(entry, details);
+            nFrozenDelta++;
         } else {
             LogPrintf("Trying to revert unfreezing of script, database is corrupted\n");
             return false;
@@ -357,388 +600,539 @@ bool CGovernance::RevertUnfreezeScript(CScript script) {
         return false;
     }
 
-    return WriteBatch(batch);
-}
-
-bool CGovernance::ScriptExist(CScript script) {
-    return Exists(FreezeEntry(script));
+    mapFreeze[script] = true;
+    return true;
 }
 
-bool CGovernance::CanSend(CScript script) {
-    FreezeEntry entry(script);
-    FreezeDetails details = FreezeDetails();
+bool CGovernanceCache::AuthorizeScript(const CScript& script) {
+    LOCK(cs_governance);
 
-    if (!Exists(entry)) {
-        return true;
+    bool authorized;
+    if (GetAuthorityEntry(script, authorized)) {
+        if (!authorized) {
+            LogPrintf("Governance: Adding script %s back to authorized list\n", HexStr(script));
+            nAuthorizedDelta++;
+        } else {
+            LogPrintf("Governance: Script %s already authorized\n", HexStr(script));
+        }
+    } else {
+        LogPrintf("Governance: Authorizing previously unknown script %s\n", HexStr(script));
+        nAuthorizedDelta++;
     }
 
-    Read(entry, details);
-    return !details.frozen;
+    mapAuthority[script] = true;
+    nValidatorChanges++;
+    return true;
 }
 
-bool CGovernance::DumpFreezeStats(std::vector< std::pair< CScript, bool > > *FreezeVector) {
-    if (IsEmpty())
-        LogPrintf("Governance: DB is empty\n");
-
-    std::unique_ptr<CDBIterator> it(NewIterator());
-    for (it->Seek(FreezeEntry(DUMMY_SCRIPT)); it->Valid(); it->Next()) { // DUMMY_SCRIPT is the lexically first script.
-        FreezeEntry entry;
-        if (it->GetKey(entry) && entry.key == DB_ADDRESS) {
-            FreezeDetails details;
-            it->GetValue(details);
+bool CGovernanceCache::UnauthorizeScript(const CScript& script) {
+    LOCK(cs_governance);
 
-            FreezeVector->emplace_back(entry.script, details.frozen);
+    bool authorized;
+    if (GetAuthorityEntry(script, authorized)) {
+        if (authorized) {
+            LogPrintf("Governance: Removing script %s from authorization list\n", HexStr(script));
+            nAuthorizedDelta--;
         } else {
-            break; // we are done with the scripts.
+            LogPrintf("Governance: Script %s already unauthorized\n", HexStr(script));
         }
+    } else {
+        LogPrintf("Governance: Unauthorizing previously unknown script %s\n", HexStr(script));
     }
 
+    mapAuthority[script] = false;
+    nValidatorChanges++;
     return true;
 }
 
-bool CGovernance::GetFrozenScripts(std::vector< CScript > *FreezeVector) {
-    std::unique_ptr<CDBIterator> it(NewIterator());
-    for (it->Seek(FreezeEntry(DUMMY_SCRIPT)); it->Valid(); it->Next()) {
-        FreezeEntry entry;
-        if (it->GetKey(entry) && entry.key == DB_ADDRESS) {
-            FreezeDetails details;
-            it->GetValue(details);
+bool CGovernanceCache::RevertAuthorizeScript(const CScript& script) {
+    // This is different from unauthorizing
+    // Reverting immediately removes script from the authorization list,
+    // This routine only does so if script was only added to the list once
 
-            if (details.frozen)
-                FreezeVector->emplace_back(entry.script);
-        } else { 
-            break;
+    LOCK(cs_governance);
+
+    bool authorized;
+    if (GetAuthorityEntry(script, authorized)) {
+        if (authorized) {
+            LogPrintf("Governance: Revert adding of script %s to authorized list\n", HexStr(script));
+
+            LogPrintf("Governance: Unauthorizing script %s\n", HexStr(script));
+            nAuthorizedDelta--;
+        } else {
+            LogPrintf("Trying to revert authorization of script, database is corrupted\n");
+            return false;
         }
-    } 
+    } else {
+        LogPrintf("Trying to revert authorization of unknown script, database is corrupted\n");
+        return false;
+    }
 
+    mapAuthority[script] = false;
+    nValidatorChanges++;
     return true;
 }
 
-CAmount CGovernance::GetCost(int type) {
-    CostDetails details = CostDetails();
-    int height = -1;
+bool CGovernanceCache::RevertUnauthorizeScript(const CScript& script) {
+    // This is different from authorizing
+    // Reverting immediately adds script to the authorize list,
+    // This routine only does so if script was only removed from the list once
 
-    std::unique_ptr<CDBIterator> it(NewIterator());
-    for (it->Seek(CostEntry()); it->Valid(); it->Next()) {
-        CostEntry entry;
-        if (it->GetKey(entry) && entry.key == DB_COST) {
-            if (entry.type == type && entry.height > height) {
-                height = entry.height;
-                it->GetValue(details);
-            }
+    LOCK(cs_governance);
+
+    bool authorized;
+    if (GetAuthorityEntry(script, authorized)) {
+        if (!authorized) {
+            LogPrintf("Governance: Revert unauthorization of script %s\n", HexStr(script));
+
+            LogPrintf("Governance: Authorizing script %s\n", HexStr(script));
+            nAuthorizedDelta++;
         } else {
-            break;
+            LogPrintf("Trying to revert unauthorization of script, database is corrupted\n");
+            return false;
         }
+    } else {
+        LogPrintf("Governance: Trying to revert unauthorization of unknown script, database is corrupted\n");
+        return false;
     }
 
-    return details.cost;
+    mapAuthority[script] = true;
+    nValidatorChanges++;
+    return true;
 }
 
-bool CGovernance::UpdateCost(CAmount cost, int type, int height) {
-    CostEntry entry(type, height);
-    CostDetails details = CostDetails();
-    CDBBatch batch(*this);
+bool CGovernanceCache::UpdateCost(CAmount cost, int type, int height) {
     std::string type_name;
-
-    if (type == GOVERNANCE_COST_ROOT) {
-        type_name = "root";
-    } else if (type == GOVERNANCE_COST_REISSUE) {
-        type_name = "reissue";
-    } else if (type == GOVERNANCE_COST_UNIQUE) {
-        type_name = "unique";
-    } else if (type == GOVERNANCE_COST_SUB) {
-        type_name = "sub";
-    } else if (type == GOVERNANCE_COST_USERNAME) {
-        type_name = "username";
-    } else {
+    if (!GetCostTypeName(type, type_name)) {
         LogPrintf("Governance: Trying to update issuance cost for unknow type\n");
         return false;
     }
 
-    if (!Read(entry, details)) {
+    LOCK(cs_governance);
+
+    CAmount current;
+    if (!GetCostEntry(type, height, current)) {
         LogPrintf("Governance: Updating issuance cost for \"%s\" to %s AOK\n", type_name, ValueFromAmountString(cost, 8));
-        batch.Write(entry, CostDetails(cost));
+
+        auto key = std::make_pair(type, height);
+        setCostToRemove.erase(key);
+        mapCostToAdd[key] = cost;
     }
 
-    return WriteBatch(batch);
+    return true;
 }
 
-bool CGovernance::RevertUpdateCost(int type, int height) {
-    CostEntry entry(type, height);
-    CostDetails details = CostDetails();
-    CDBBatch batch(*this);
-
+bool CGovernanceCache::RevertUpdateCost(int type, int height) {
     std::string type_name;
+    GetCostTypeName(type, type_name);
 
-    if (type == GOVERNANCE_COST_ROOT) {
-        type_name = "root";
-    } else if (type == GOVERNANCE_COST_REISSUE) {
-        type_name = "reissue";
-    } else if (type == GOVERNANCE_COST_UNIQUE) {
-        type_name = "unique";
-    } else if (type == GOVERNANCE_COST_SUB) {
-        type_name = "sub";
-    } else if (type == GOVERNANCE_COST_USERNAME) {
-        type_name = "username";
-    }
+    LOCK(cs_governance);
 
-    if (Read(entry, details)) {
-        LogPrintf("Governance: Revert updating issuance cost for \"%s\" to %s AOK\n", type_name, ValueFromAmountString(details.cost, 8));
-        batch.Erase(entry);
+    CAmount cost;
+    if (GetCostEntry(type, height, cost)) {
+        LogPrintf("Governance: Revert updating issuance cost for \"%s\" to %s AOK\n", type_name, ValueFromAmountString(cost, 8));
+
+        auto key = std::make_pair(type, height);
+        mapCostToAdd.erase(key);
+        setCostToRemove.insert(key);
     } else {
         LogPrintf("Governance: Trying to revert unknown issuance cost update, database is corrupted\n");
         return false;
     }
 
-    return WriteBatch(batch);
-}
-
-CScript CGovernance::GetFeeScript() {
-    FeeDetails details = FeeDetails();
-    int height = -1;
-
-    std::unique_ptr<CDBIterator> it(NewIterator());
-    for (it->Seek(FeeEntry()); it->Valid(); it->Next()) {
-        FeeEntry entry;
-        if (it->GetKey(entry) && entry.key == DB_FEE_ADDRESS) {
-            if (entry.height > height) {
-                height = entry.height;
-                it->GetValue(details);
-            }
-        } else {
-            break;
-        }
-    }
-
-    return details.script;
+    return true;
 }
 
-bool CGovernance::UpdateFeeScript(CScript script, int height) {
-    FeeEntry entry(height);
-    FeeDetails details = FeeDetails();
-    CDBBatch batch(*this);
+bool CGovernanceCache::UpdateFeeScript(const CScript& script, int height) {
+    LOCK(cs_governance);
 
-    if (!Read(entry, details)) {
+    CScript current;
+    if (!GetFeeScriptEntry(height, current)) {
         LogPrintf("Governance: Updating fee script to %s\n", HexStr(script));
-        batch.Write(entry, FeeDetails(script));
+
+        setFeeScriptToRemove.erase(height);
+        mapFeeScriptToAdd[height] = script;
     }
 
-    return WriteBatch(batch);
+    return true;
 }
 
-bool CGovernance::RevertUpdateFeeScript(int height) {
-    FeeEntry entry(height);
-    FeeDetails details = FeeDetails();
-    CDBBatch batch(*this);
+bool CGovernanceCache::RevertUpdateFeeScript(int height) {
+    LOCK(cs_governance);
+
+    CScript script;
+    if (GetFeeScriptEntry(height, script)) {
+        LogPrintf("Governance: Revert updating fee script to %s\n", HexStr(script));
 
-    if (Read(entry, details)) {
-        LogPrintf("Governance: Revert updating fee script to %s\n", HexStr(details.script));
-        batch.Erase(entry);
+        mapFeeScriptToAdd.erase(height);
+        setFeeScriptToRemove.insert(height);
     } else {
         LogPrintf("Governance: Trying to revert unknown fee script update, database is corrupted\n");
         return false;
     }
 
-    return WriteBatch(batch);
+    return true;
+}
+
+void CGovernanceCache::SetBestBlock(const uint256& hashBlockIn) {
+    LOCK(cs_governance);
+    hashBlock = hashBlockIn;
 }
 
-unsigned int CGovernance::GetNumberOfAuthorizedScripts() {
-    unsigned int number;
+bool CGovernanceCache::Flush() {
+    LOCK(cs_governance);
 
-    Read(DB_NUMBER_AUTHORIZED, number);
+    if (!base->BatchWrite(*this))
+        return error("%s: Failed to write governance changes to the parent view", __func__);
 
-    return number;
+    ClearDirtyCache();
+    return true;
 }
 
-bool CGovernance::AuthorizeScript(CScript script) {
-    AuthorityEntry entry(script);
-    AuthorityDetails details = AuthorityDetails();
-    CDBBatch batch(*this);
+void CGovernanceCache::ClearDirtyCache() {
+    LOCK(cs_governance);
 
-    unsigned int number;
-    Read(DB_NUMBER_AUTHORIZED, number);
+    mapFreeze.clear();
+    mapAuthority.clear();
 
-    if (Read(entry, details)) {
-        if (!details.authorized) {
-            LogPrintf("Governance: Adding script %s back to authorized list\n", HexStr(script));
+    mapCostToAdd.clear();
+    setCostToRemove.clear();
 
-            details.authorized = true;
-            batch.Write(entry, details);
-            batch.Write(DB_NUMBER_AUTHORIZED, number + 1);
-        } else {
-            LogPrintf("Governance: Script %s already authorized\n", HexStr(script));
-            batch.Write(entry, details);
-        }
-    } else {
-        LogPrintf("Governance: Authorizing previously unknown script %s\n", HexStr(script));
+    mapFeeScriptToAdd.clear();
+    setFeeScriptToRemove.clear();
 
-        batch.Write(entry, AuthorityDetails());
-        batch.Write(DB_NUMBER_AUTHORIZED, number + 1);
-    }
+    nFrozenDelta = 0;
+    nAuthorizedDelta = 0;
+    nValidatorChanges = 0;
 
-    return WriteBatch(batch);
+    hashBlock.SetNull();
 }
 
-bool CGovernance::UnauthorizeScript(CScript script) {
-    AuthorityEntry entry(script);
-    AuthorityDetails details = AuthorityDetails();
-    CDBBatch batch(*this);
+/**
+ * CGovernance
+ */
 
-    unsigned int number;
-    Read(DB_NUMBER_AUTHORIZED, number);
+CGovernance::CGovernance(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "governance", nCacheSize, fMemory, fWipe), nFrozen(0), nAuthorized(0), nValidatorEpoch(0)
+{
+}
 
-    if (Read(entry, details)) {
-        if (details.authorized) {
-            LogPrintf("Governance: Removing script %s from authorization list\n", HexStr(script));
+bool CGovernance::Init(bool fWipe, const CChainParams& chainparams) {
+    bool init;
 
-            details.authorized = false;
-            batch.Write(entry, details);
-            batch.Write(DB_NUMBER_AUTHORIZED, number - 1);
-        } else {
-            LogPrintf("Governance: Script %s already unauthorized\n", HexStr(script));
-            batch.Write(entry, details);
+    if (fWipe || Read(DB_GOVERNANCE_INIT, init) == false || init == false) {
+        LogPrintf("Governance: Creating new database\n");
+
+        CDBBatch batch(*this);
+
+        batch.Write(DB_NUMBER_FROZEN, 0);
+        batch.Write(DB_NUMBER_AUTHORIZED, 0);
+
+        // Add dummy entries will be first for searching the database
+        batch.Write(AuthorityEntry(), AuthorityDetails());
+        batch.Write(FreezeEntry(), FreezeDetails());
+        batch.Write(CostEntry(), CostDetails());
+
+        // Add initial token issuance cost values
+        batch.Write(CostEntry(GOVERNANCE_COST_ROOT, 0), CostDetails(chainparams.IssueTokenFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_REISSUE, 0), CostDetails(chainparams.ReissueTokenFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_UNIQUE, 0), CostDetails(chainparams.IssueUniqueTokenFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_SUB, 0), CostDetails(chainparams.IssueUniqueTokenFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_USERNAME, 0), CostDetails(chainparams.IssueUsernameTokenFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_MSG_CHANNEL, 0), CostDetails(chainparams.IssueMsgChannelTokenFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_QUALIFIER, 0), CostDetails(chainparams.IssueQualifierTokenFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_SUB_QUALIFIER, 0), CostDetails(chainparams.IssueSubQualifierTokenFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_NULL_QUALIFIER, 0), CostDetails(chainparams.AddNullQualifierTagFeeAmount()));
+        batch.Write(CostEntry(GOVERNANCE_COST_RESTRICTED, 0), CostDetails(chainparams.IssueRestrictedTokenFeeAmount()));
+
+        // Init PoS-A addresses
+        const std::set<std::string> init_authorized = chainparams.GetInitAuthorized();
+        for (auto auth_address : init_authorized) {
+            CTxDestination auth_destination = DecodeDestination(auth_address);
+            CScript authScript = GetScriptForDestination(auth_destination);
+            batch.Write(AuthorityEntry(authScript), AuthorityDetails(true));
         }
-    } else {
-        LogPrintf("Governance: Unauthorizing previously unknown script %s\n", HexStr(script));
-        batch.Write(entry, AuthorityDetails(false));
+
+        // Add initial token fee address from chainparams
+        CTxDestination destination = DecodeDestination(GetParams().TokenFeeAddress());
+        CScript feeScript = GetScriptForDestination(destination);
+        batch.Write(FeeEntry(), FeeDetails(feeScript));
+
+        // A new database holds no block's actions yet, databases from before the marker have none
+        batch.Write(DB_BEST_BLOCK, uint256());
+
+        batch.Write(DB_GOVERNANCE_INIT, true);
+        WriteBatch(batch);
     }
 
-    return WriteBatch(batch);
+    return LoadState();
 }
 
-bool CGovernance::RevertAuthorizeScript(CScript script) {
-    // This is different from unauthorizing
-    // Reverting immediately removes script from the authorization list,
-    // This routine only does so if script was only added to the list once
+bool CGovernance::LoadState() {
+    LOCK(cs_governance);
 
-    AuthorityEntry entry(script);
-    AuthorityDetails details = AuthorityDetails();
-    CDBBatch batch(*this);
+    mapFreeze.clear();
+    mapAuthority.clear();
+    mapCost.clear();
+    mapFeeScript.clear();
+    setValidators.clear();
 
-    unsigned int number;
-    Read(DB_NUMBER_AUTHORIZED, number);
+    if (!Read(DB_NUMBER_FROZEN, nFrozen))
+        nFrozen = 0;
 
-    if (Read(entry, details)) {
-        if (details.authorized) {
-            LogPrintf("Governance: Revert adding of script %s to authorized list\n", HexStr(script));
+    if (!Read(DB_NUMBER_AUTHORIZED, nAuthorized))
+        nAuthorized = 0;
 
-            LogPrintf("Governance: Unauthorizing script %s\n", HexStr(script));
-            details.authorized = false;
-            batch.Write(DB_NUMBER_AUTHORIZED, number - 1);
+    std::unique_ptr<CDBIterator> it(NewIterator());
 
-            batch.Write(entry, details);
+    for (it->Seek(FreezeEntry(DUMMY_SCRIPT)); it->Valid(); it->Next()) {
+        FreezeEntry entry;
+        FreezeDetails details;
+        if (it->GetKey(entry) && entry.key == DB_ADDRESS && it->GetValue(details)) {
+            mapFreeze[entry.script] = details.frozen;
         } else {
-            LogPrintf("Trying to revert authorization of script, database is corrupted\n");
-            return false;
+            break;
+        }
+    }
+
+    for (it->Seek(AuthorityEntry(DUMMY_SCRIPT)); it->Valid(); it->Next()) {
+        AuthorityEntry entry;
+        AuthorityDetails details;
+        if (it->GetKey(entry) && entry.key == DB_AUTORIZATION && it->GetValue(details)) {
+            mapAuthority[entry.script] = details.authorized;
+            if (details.authorized)
+                setValidators.insert(entry.script);
+        } else {
+            break;
         }
-    } else {
-        LogPrintf("Trying to revert authorization of unknown script, database is corrupted\n");
-        return false;
     }
 
-    return WriteBatch(batch);
+    for (it->Seek(CostEntry()); it->Valid(); it->Next()) {
+        CostEntry entry;
+        CostDetails details;
+        if (it->GetKey(entry) && entry.key == DB_COST && it->GetValue(details)) {
+            mapCost[entry.type][entry.height] = details.cost;
+        } else {
+            break;
+        }
+    }
+
+    for (it->Seek(FeeEntry()); it->Valid(); it->Next()) {
+        FeeEntry entry;
+        FeeDetails details;
+        if (it->GetKey(entry) && entry.key == DB_FEE_ADDRESS && it->GetValue(details)) {
+            mapFeeScript[entry.height] = details.script;
+        } else {
+            break;
+        }
+    }
+
+    LogPrintf("Governance: Loaded %u freeze entries, %u authority entries, %u cost types and %u fee script updates\n",
+        mapFreeze.size(), mapAuthority.size(), mapCost.size(), mapFeeScript.size());
+
+    return true;
 }
 
-bool CGovernance::RevertUnauthorizeScript(CScript script) {
-    // This is different from authorizing
-    // Reverting immediately adds script to the authorize list,
-    // This routine only does so if script was only removed from the list once
+uint256 CGovernance::GetBestBlock() const {
+    uint256 hashBestBlock;
+    if (!Read(DB_BEST_BLOCK, hashBestBlock))
+        return uint256();
+    return hashBestBlock;
+}
 
-    AuthorityEntry entry(script);
-    AuthorityDetails details = AuthorityDetails();
-    CDBBatch batch(*this);
+bool CGovernance::HasBestBlock() const {
+    return Exists(DB_BEST_BLOCK);
+}
 
-    unsigned int number;
-    Read(DB_NUMBER_AUTHORIZED, number);
+bool CGovernance::Upgrade(const uint256& hashBlock) {
+    if (HasBestBlock())
+        return true;
 
-    if (Read(entry, details)) {
-        if (!details.authorized) {
-            LogPrintf("Governance: Revert unauthorization of script %s\n", HexStr(script));
+    LogPrintf("Governance: Marking the database as being at %s\n", hashBlock.ToString());
+    return Write(DB_BEST_BLOCK, hashBlock, true);
+}
 
-            LogPrintf("Governance: Authorizing script %s\n", HexStr(script));
-            details.authorized = true;
-            batch.Write(DB_NUMBER_AUTHORIZED, number + 1);
+bool CGovernance::GetFreezeEntry(const CScript& script, bool& frozen) const {
+    LOCK(cs_governance);
 
-            batch.Write(entry, details);
-        } else {
-            LogPrintf("Trying to revert unauthorization of script, database is corrupted\n");
-            return false;
-        }
-    } else {
-        LogPrintf("Governance: Trying to revert unauthorization of unknown script, database is corrupted\n");
+    auto it = mapFreeze.find(script);
+    if (it == mapFreeze.end())
         return false;
-    }
 
-    return WriteBatch(batch);
+    frozen = it->second;
+    return true;
 }
 
-bool CGovernance::AuthorityExist(CScript script) {
-    return Exists(AuthorityEntry(script));
+bool CGovernance::GetAuthorityEntry(const CScript& script, bool& authorized) const {
+    LOCK(cs_governance);
+
+    auto it = mapAuthority.find(script);
+    if (it == mapAuthority.end())
+        return false;
+
+    authorized = it->second;
+    return true;
 }
 
-bool CGovernance::CanStake(CScript script) {
-    // Handle pay-to-public-key outputs properly
-    if (script.IsPayToPublicKey()) {
-        uint160 hashBytes(Hash160(script.begin() + 1, script.end() - 1));
-        script = CScript() << OP_DUP << OP_HASH160 << ToByteVector(hashBytes) << OP_EQUALVERIFY << OP_CHECKSIG;
-    }
+bool CGovernance::GetCostEntry(int type, int height, CAmount& cost) const {
+    LOCK(cs_governance);
 
-    AuthorityEntry entry(script);
-    AuthorityDetails details = AuthorityDetails();
+    auto costs = mapCost.find(type);
+    if (costs == mapCost.end())
+        return false;
 
-    if (!Exists(entry)) {
+    auto it = costs->second.find(height);
+    if (it == costs->second.end())
         return false;
-    }
 
-    Read(entry, details);
-    return details.authorized;
+    cost = it->second;
+    return true;
 }
 
-bool CGovernance::GetActiveValidators(std::vector< std::string > *ValidatorsVector) {
-    if (IsEmpty())
-        LogPrintf("Governance: DB is empty\n");
+bool CGovernance::GetFeeScriptEntry(int height, CScript& script) const {
+    LOCK(cs_governance);
 
-    std::unique_ptr<CDBIterator> it(NewIterator());
-    for (it->Seek(AuthorityEntry(DUMMY_SCRIPT)); it->Valid(); it->Next()) {
-        AuthorityEntry entry;
-        if (it->GetKey(entry) && entry.key == DB_AUTORIZATION) {
-            AuthorityDetails details;
-            it->GetValue(details);
+    auto it = mapFeeScript.find(height);
+    if (it == mapFeeScript.end())
+        return false;
 
-            if (details.authorized) {
-                CTxDestination authorizedDestination;
-                ExtractDestination(entry.script, authorizedDestination);
-                CPaladeumAddress validatorAddress(authorizedDestination);
+    script = it->second;
+    return true;
+}
 
-                ValidatorsVector->emplace_back(validatorAddress.ToString());
-            }
-        } else {
-            break; // we are done with the scripts.
-        }
+void CGovernance::GetFreezeEntries(std::map<CScript, bool>& entries) const {
+    LOCK(cs_governance);
+    entries.insert(mapFreeze.begin(), mapFreeze.end());
+}
+
+void CGovernance::GetAuthorityEntries(std::map<CScript, bool>& entries) const {
+    LOCK(cs_governance);
+    entries.insert(mapAuthority.begin(), mapAuthority.end());
+}
+
+void CGovernance::GetCostEntries(int type, std::map<int, CAmount>& entries) const {
+    LOCK(cs_governance);
+
+    auto it = mapCost.find(type);
+    if (it != mapCost.end())
+        entries.insert(it->second.begin(), it->second.end());
+}
+
+void CGovernance::GetFeeScriptEntries(std::map<int, CScript>& entries) const {
+    LOCK(cs_governance);
+    entries.insert(mapFeeScript.begin(), mapFeeScript.end());
+}
+
+unsigned int CGovernance::GetNumberOfAuthorizedScripts() const {
+    LOCK(cs_governance);
+    return nAuthorized;
+}
+
+unsigned int CGovernance::GetNumberOfFrozenScripts() const {
+    LOCK(cs_governance);
+    return nFrozen;
+}
+
+void CGovernance::GetValidators(CGovernanceScriptSet& validators) const {
+    LOCK(cs_governance);
+
+    validators.clear();
+    validators.insert(setValidators.begin(), setValidators.end());
+}
+
+uint64_t CGovernance::GetValidatorEpoch() const {
+    LOCK(cs_governance);
+    return nValidatorEpoch;
+}
+
+CAmount CGovernance::GetCost(int type) const {
+    LOCK(cs_governance);
+
+    // The most recent update for the type is the active cost
+    auto it = mapCost.find(type);
+    if (it == mapCost.end() || it->second.empty()) {
+        return CostDetails().cost;
     }
 
-    return true;
+    return it->second.rbegin()->second;
 }
 
+CScript CGovernance::GetFeeScript() const {
+    LOCK(cs_governance);
 
-bool CGovernance::GetActiveValidatorsScript(std::vector< CScript > *ValidatorsVector) {
-    if (IsEmpty())
-        LogPrintf("Governance: DB is empty\n");
+    if (mapFeeScript.empty()) {
+        return FeeDetails().script;
+    }
 
-    std::unique_ptr<CDBIterator> it(NewIterator());
-    for (it->Seek(AuthorityEntry(DUMMY_SCRIPT)); it->Valid(); it->Next()) {
-        AuthorityEntry entry;
-        if (it->GetKey(entry) && entry.key == DB_AUTORIZATION) {
-            AuthorityDetails details;
-            it->GetValue(details);
+    return mapFeeScript.rbegin()->second;
+}
 
-            if (details.authorized) {
-                ValidatorsVector->emplace_back(entry.script);
-            }
-        } else {
-            break; // we are done with the scripts.
+bool CGovernance::BatchWrite(CGovernanceCache& cache) {
+    LOCK(cs_governance);
+
+    CDBBatch batch(*this);
+
+    for (const auto& item : cache.mapFreeze)
+        batch.Write(FreezeEntry(item.first), FreezeDetails(item.second));
+
+    for (const auto& item : cache.mapAuthority)
+        batch.Write(AuthorityEntry(item.first), AuthorityDetails(item.second));
+
+    for (const auto& item : cache.setCostToRemove)
+        batch.Erase(CostEntry(item.first, item.second));
+
+    for (const auto& item : cache.mapCostToAdd)
+        batch.Write(CostEntry(item.first.first, item.first.second), CostDetails(item.second));
+
+    for (const auto& item : cache.setFeeScriptToRemove)
+        batch.Erase(FeeEntry(item));
+
+    for (const auto& item : cache.mapFeeScriptToAdd)
+        batch.Write(FeeEntry(item.first), FeeDetails(item.second));
+
+    unsigned int nNewFrozen = nFrozen + cache.nFrozenDelta;
+    unsigned int nNewAuthorized = nAuthorized + cache.nAuthorizedDelta;
+    batch.Write(DB_NUMBER_FROZEN, nNewFrozen);
+    batch.Write(DB_NUMBER_AUTHORIZED, nNewAuthorized);
+
+    if (!cache.hashBlock.IsNull())
+        batch.Write(DB_BEST_BLOCK, cache.hashBlock);
+
+    if (!WriteBatch(batch))
+        return false;
+
+    // Keep the in-memory mirror in step with the database
+    for (const auto& item : cache.mapFreeze)
+        mapFreeze[item.first] = item.second;
+
+    for (const auto& item : cache.mapAuthority) {
+        mapAuthority[item.first] = item.second;
+        if (item.second)
+            setValidators.insert(item.first);
+        else
+            setValidators.erase(item.first);
+    }
+
+    for (const auto& item : cache.setCostToRemove) {
+        auto costs = mapCost.find(item.first);
+        if (costs != mapCost.end()) {
+            costs->second.erase(item.second);
+            if (costs->second.empty())
+                mapCost.erase(costs);
         }
     }
 
+    for (const auto& item : cache.mapCostToAdd)
+        mapCost[item.first.first][item.first.second] = item.second;
+
+    for (const auto& item : cache.setFeeScriptToRemove)
+        mapFeeScript.erase(item);
+
+    for (const auto& item : cache.mapFeeScriptToAdd)
+        mapFeeScript[item.first] = item.second;
+
+    nFrozen = nNewFrozen;
+    nAuthorized = nNewAuthorized;
+    nValidatorEpoch += cache.nValidatorChanges;
+
     return true;
 }
@@ -9,6 +9,13 @@
 #include <chainparams.h>
 #include <dbwrapper.h>
 #include <chain.h>
+#include <hash.h>
+#include <sync.h>
+
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 #define GOVERNANCE_MARKER 71
 #define GOVERNANCE_ACTION 65
@@ -31,50 +38,219 @@
 #define GOVERNANCE_COST_NULL_QUALIFIER 9
 #define GOVERNANCE_COST_RESTRICTED 10
 
-class CGovernance : CDBWrapper 
+class SaltedScriptHasher
 {
+private:
+    /** Salt */
+    const uint64_t k0, k1;
+
 public:
-    CGovernance(size_t nCacheSize, bool fMemory, bool fWipe);
-    bool Init(bool fWipe, const CChainParams& chainparams);
+    SaltedScriptHasher();
+
+    size_t operator()(const CScript& script) const {
+        return CSipHasher(k0, k1).Write(script.data(), script.size()).Finalize();
+    }
+};
+
+typedef std::unordered_map<CScript, bool, SaltedScriptHasher> CGovernanceScriptMap;
+typedef std::unordered_set<CScript, SaltedScriptHasher> CGovernanceScriptSet;
+
+class CGovernanceCache;
+
+/** Abstract view on the governance state, modeled on CCoinsView */
+class CGovernanceView
+{
+public:
+    //! Retrieve the freeze flag of a script, returns false if the script has no freeze entry
+    virtual bool GetFreezeEntry(const CScript& script, bool& frozen) const = 0;
+
+    //! Retrieve the authorization flag of a script, returns false if the script has no authority entry
+    virtual bool GetAuthorityEntry(const CScript& script, bool& authorized) const = 0;
+
+    //! Retrieve the issuance cost set for a type at the given height, returns false if there is none
+    virtual bool GetCostEntry(int type, int height, CAmount& cost) const = 0;
+
+    //! Retrieve the fee script set at the given height, returns false if there is none
+    virtual bool GetFeeScriptEntry(int height, CScript& script) const = 0;
+
+    //! Retrieve every freeze and authority entry, ordered by script
+    virtual void GetFreezeEntries(std::map<CScript, bool>& entries) const = 0;
+    virtual void GetAuthorityEntries(std::map<CScript, bool>& entries) const = 0;
+
+    //! Retrieve the cost history of a type and the fee script history, keyed by height
+    virtual void GetCostEntries(int type, std::map<int, CAmount>& entries) const = 0;
+    virtual void GetFeeScriptEntries(std::map<int, CScript>& entries) const = 0;
 
     // Statistics
-    unsigned int GetNumberOfAuthorizedScripts();
-    unsigned int GetNumberOfFrozenScripts();
-    
+    virtual unsigned int GetNumberOfAuthorizedScripts() const = 0;
+    virtual unsigned int GetNumberOfFrozenScripts() const = 0;
+
+    //! Retrieve the set of currently authorized scripts
+    virtual void GetValidators(CGovernanceScriptSet& validators) const = 0;
+
+    //! Counter bumped by every change to the authorization list, so callers
+    //! holding a copy of the validator set know when to refresh it
+    virtual uint64_t GetValidatorEpoch() const = 0;
+
+    //! Apply the dirty entries of a child cache to this view
+    virtual bool BatchWrite(CGovernanceCache& cache) = 0;
+
+    //! Current issuance cost and fee script, which are the most recent updates
+    virtual CAmount GetCost(int type) const;
+    virtual CScript GetFeeScript() const;
+
     // Managing freeze list
-    bool FreezeScript(CScript script);
-    bool UnfreezeScript(CScript script);
-    bool RevertFreezeScript(CScript script);
-    bool RevertUnfreezeScript(CScript script);
-    bool ScriptExist(CScript script);
-    bool CanSend(CScript script);
+    bool ScriptExist(const CScript& script) const;
+    bool CanSend(const CScript& script) const;
 
     // Managing authorization list
-    bool GetActiveValidators(std::vector< std::string > *ValidatorsVector);
-    bool GetActiveValidatorsScript(std::vector< CScript > *ValidatorsVector);
-    bool AuthorizeScript(CScript script);
-    bool UnauthorizeScript(CScript script);
-    bool RevertAuthorizeScript(CScript script);
-    bool RevertUnauthorizeScript(CScript script);
-    bool AuthorityExist(CScript script);
-    bool CanStake(CScript script);
+    bool GetActiveValidators(std::vector< std::string > *ValidatorsVector) const;
+    bool GetActiveValidatorsScript(std::vector< CScript > *ValidatorsVector) const;
+    bool AuthorityExist(const CScript& script) const;
+    bool CanStake(const CScript& script) const;
+
+    //! Script an output is authorized under, pay-to-public-key outputs map to their pay-to-public-key-hash form
+    static CScript GetValidatorScript(const CScript& script);
+
+    // Misc
+    bool DumpFreezeStats(std::vector< std::pair< CScript, bool > > *FreezeVector) const;
+    bool GetFrozenScripts(std::vector< CScript > *FreezeVector) const;
+
+    //! As we use CGovernanceViews polymorphically, have a virtual destructor
+    virtual ~CGovernanceView() {}
+};
+
+/**
+ * Governance changes made by connecting or disconnecting blocks. Entries are
+ * kept in memory and only reach the parent view when Flush is called, so a
+ * block that fails validation (or is only being checked) never touches the
+ * governance database.
+ */
+class CGovernanceCache : public CGovernanceView
+{
+protected:
+    CGovernanceView* base;
+    mutable CCriticalSection cs_governance;
+
+public:
+    //! These are memory only containers that show dirty entries that will be databased when flushed
+    CGovernanceScriptMap mapFreeze;
+    CGovernanceScriptMap mapAuthority;
+
+    std::map<std::pair<int, int>, CAmount> mapCostToAdd; // (type, height) -> cost
+    std::set<std::pair<int, int> > setCostToRemove;
+
+    std::map<int, CScript> mapFeeScriptToAdd; // height -> script
+    std::set<int> setFeeScriptToRemove;
+
+    int nFrozenDelta;
+    int nAuthorizedDelta;
+
+    //! Number of authorization list changes made in this cache
+    uint64_t nValidatorChanges;
+
+    //! Block the dirty entries belong to, written as the governance best block
+    uint256 hashBlock;
+
+    explicit CGovernanceCache(CGovernanceView* baseIn);
+
+    bool GetFreezeEntry(const CScript& script, bool& frozen) const override;
+    bool GetAuthorityEntry(const CScript& script, bool& authorized) const override;
+    bool GetCostEntry(int type, int height, CAmount& cost) const override;
+    bool GetFeeScriptEntry(int height, CScript& script) const override;
+    void GetFreezeEntries(std::map<CScript, bool>& entries) const override;
+    void GetAuthorityEntries(std::map<CScript, bool>& entries) const override;
+    void GetCostEntries(int type, std::map<int, CAmount>& entries) const override;
+    void GetFeeScriptEntries(std::map<int, CScript>& entries) const override;
+    unsigned int GetNumberOfAuthorizedScripts() const override;
+    unsigned int GetNumberOfFrozenScripts() const override;
+    void GetValidators(CGovernanceScriptSet& validators) const override;
+    uint64_t GetValidatorEpoch() const override;
+    bool BatchWrite(CGovernanceCache& cache) override;
+    CAmount GetCost(int type) const override;
+    CScript GetFeeScript() const override;
+
+    // Managing freeze list
+    bool FreezeScript(const CScript& script);
+    bool UnfreezeScript(const CScript& script);
+    bool RevertFreezeScript(const CScript& script);
+    bool RevertUnfreezeScript(const CScript& script);
+
+    // Managing authorization list
+    bool AuthorizeScript(const CScript& script);
+    bool UnauthorizeScript(const CScript& script);
+    bool RevertAuthorizeScript(const CScript& script);
+    bool RevertUnauthorizeScript(const CScript& script);
 
     // Managing issuance cost
     bool UpdateCost(CAmount cost, int type, int height);
     bool RevertUpdateCost(int type, int height);
-    CAmount GetCost(int type);
 
     // Managing fee address
-    bool UpdateFeeScript(CScript script, int height);
+    bool UpdateFeeScript(const CScript& script, int height);
     bool RevertUpdateFeeScript(int height);
-    CScript GetFeeScript();
 
-    // Misc
-    bool DumpFreezeStats(std::vector< std::pair< CScript, bool > > *FreezeVector);
-    bool GetFrozenScripts(std::vector< CScript > *FreezeVector);
+    void SetBestBlock(const uint256& hashBlockIn);
+
+    //! Push the dirty entries into the parent view and clear them
+    bool Flush();
+
+    //! Clear all dirty cache sets and maps
+    void ClearDirtyCache();
+};
+
+class CGovernance : public CGovernanceView, CDBWrapper
+{
+private:
+    /**
+     * In-memory mirror of the freeze list, authorization list, cost table and
+     * fee script history. Loaded once in Init and kept in step with every
+     * database write, so lookups on the consensus path never touch LevelDB.
+     */
+    mutable CCriticalSection cs_governance;
+    CGovernanceScriptMap mapFreeze;
+    CGovernanceScriptMap mapAuthority;
+    std::map<int, std::map<int, CAmount>> mapCost; // type -> height -> cost
+    std::map<int, CScript> mapFeeScript; // height -> script
+    unsigned int nFrozen;
+    unsigned int nAuthorized;
+
+    //! Authorized scripts, maintained incrementally next to mapAuthority
+    CGovernanceScriptSet setValidators;
+    uint64_t nValidatorEpoch;
+
+    bool LoadState();
+
+public:
+    CGovernance(size_t nCacheSize, bool fMemory, bool fWipe);
+    bool Init(bool fWipe, const CChainParams& chainparams);
+
+    //! Block the database state was last flushed at, null if never written
+    uint256 GetBestBlock() const;
+
+    //! Whether the best block marker was ever written, databases from older versions lack it
+    bool HasBestBlock() const;
+
+    //! Mark a database that lacks the best block marker as being at hashBlock
+    bool Upgrade(const uint256& hashBlock);
+
+    bool GetFreezeEntry(const CScript& script, bool& frozen) const override;
+    bool GetAuthorityEntry(const CScript& script, bool& authorized) const override;
+    bool GetCostEntry(int type, int height, CAmount& cost) const override;
+    bool GetFeeScriptEntry(int height, CScript& script) const override;
+    void GetFreezeEntries(std::map<CScript, bool>& entries) const override;
+    void GetAuthorityEntries(std::map<CScript, bool>& entries) const override;
+    void GetCostEntries(int type, std::map<int, CAmount>& entries) const override;
+    void GetFeeScriptEntries(std::map<int, CScript>& entries) const override;
+    unsigned int GetNumberOfAuthorizedScripts() const override;
+    unsigned int GetNumberOfFrozenScripts() const override;
+    void GetValidators(CGovernanceScriptSet& validators) const override;
+    uint64_t GetValidatorEpoch() const override;
+    bool BatchWrite(CGovernanceCache& cache) override;
+    CAmount GetCost(int type) const override;
+    CScript GetFeeScript() const override;
 
     using CDBWrapper::Sync;
-  
 };
 
 #endif /* PALADEUM_GOVERNANCE_H */
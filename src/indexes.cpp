@@ -0,0 +1,368 @@
+// Copyright (c) 2021-2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "indexes.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "hash.h"
+#include "primitives/block.h"
+#include "script/standard.h"
+#include "timestampindex.h"
+#include "txdb.h"
+#include "undo.h"
+#include "util.h"
+#include "validation.h"
+
+#include <chrono>
+#include <functional>
+
+CIndexesSync* pindexessync = nullptr;
+
+//! Seconds between the progress messages while the indexes catch up with the chain
+static const int64_t INDEXES_SYNC_LOG_INTERVAL = 30;
+
+namespace {
+
+/** The address and the amount of PLB or of a token an output pays to, as kept by the address index */
+struct CIndexedOutput
+{
+    int addressType;
+    uint160 hashBytes;
+    std::string tokenName;
+    CAmount nAmount;
+    int nTimeLock;
+};
+
+// False if the output doesn't pay to an address the address index keeps
+bool GetIndexedOutput(const CTxOut& out, CIndexedOutput& indexed)
+{
+    const CScript& script = out.scriptPubKey;
+    indexed.tokenName = PLB;
+    indexed.nAmount = out.nValue;
+    indexed.nTimeLock = 0;
+
+    if (script.IsPayToScriptHash()) {
+        indexed.addressType = 2;
+        indexed.hashBytes = uint160(std::vector<unsigned char>(script.begin() + 2, script.begin() + 22));
+    } else if (script.IsPayToPublicKeyHash()) {
+        indexed.addressType = 1;
+        indexed.hashBytes = uint160(std::vector<unsigned char>(script.begin() + 3, script.begin() + 23));
+    } else if (script.IsPayToPublicKeyHashLocked()) {
+        int offset = script.size() - 25;
+        indexed.addressType = 1;
+        indexed.hashBytes = uint160(std::vector<unsigned char>(script.begin() + (3 + offset), script.begin() + (23 + offset)));
+        indexed.nTimeLock = out.GetLockTime();
+    } else if (script.IsPayToPublicKey()) {
+        indexed.addressType = 1;
+        indexed.hashBytes = Hash160(script.begin() + 1, script.end() - 1);
+    } else {
+        /** TOKENS START */
+        int nScriptType;
+        uint32_t nTimeLock;
+        if (!AreTokensDeployed() || !ParseTokenScript(script, indexed.hashBytes, nScriptType, indexed.tokenName, indexed.nAmount, nTimeLock))
+            return false;
+
+        if (nScriptType == TX_PUBKEYHASH) {
+            indexed.addressType = 1;
+        } else if (nScriptType == TX_SCRIPTHASH) {
+            indexed.addressType = 2;
+        } else {
+            return false;
+        }
+        indexed.nTimeLock = nTimeLock;
+        /** TOKENS END */
+    }
+
+    return true;
+}
+
+} // namespace
+
+bool GetIndexesBlockData(const CBlock& block, const CBlockUndo& blockundo, int nHeight, bool fConnect, CIndexesBlockData& data)
+{
+    if (blockundo.vtxundo.size() + 1 != block.vtx.size())
+        return error("%s: block and undo data inconsistent", __func__);
+
+    for (unsigned int n = 0; n < block.vtx.size(); n++) {
+        // A disconnected block is undone from its last transaction, so an output created and spent in the same
+        // block ends up out of the unspent index both ways
+        const unsigned int i = fConnect ? n : block.vtx.size() - 1 - n;
+        const CTransaction& tx = *block.vtx[i];
+        const uint256 txhash = tx.GetHash();
+
+        if (i > 0) {
+            const CTxUndo& txundo = blockundo.vtxundo[i - 1];
+            if (txundo.vprevout.size() != tx.vin.size())
+                return error("%s: transaction and undo data inconsistent", __func__);
+
+            for (unsigned int j = 0; j < tx.vin.size(); j++) {
+                const COutPoint& prevout = tx.vin[j].prevout;
+                const Coin& coin = txundo.vprevout[j];
+
+                CIndexedOutput indexed;
+                if (GetIndexedOutput(coin.out, indexed)) {
+                    // spending activity
+                    data.addressIndex.push_back(std::make_pair(CAddressIndexKey(indexed.addressType, indexed.hashBytes, indexed.tokenName, nHeight, i, txhash, j, true, indexed.nTimeLock), indexed.nAmount * -1));
+
+                    // the spent output leaves the unspent index, and is restored when the block is disconnected
+                    CAddressUnspentKey unspentKey(indexed.addressType, indexed.hashBytes, indexed.tokenName, prevout.hash, prevout.n, indexed.nTimeLock);
+                    if (fConnect)
+                        data.addressUnspentIndex.push_back(std::make_pair(unspentKey, CAddressUnspentValue()));
+                    else
+                        data.addressUnspentIndex.push_back(std::make_pair(unspentKey, CAddressUnspentValue(indexed.nAmount, coin.out.scriptPubKey, coin.nHeight, coin.nTime)));
+                } else {
+                    indexed.addressType = 0;
+                    indexed.hashBytes.SetNull();
+                }
+
+                // the txid and input that spent an output, with the amount and address it came from
+                CSpentIndexKey spentKey(prevout.hash, prevout.n);
+                if (fConnect)
+                    data.spentIndex.push_back(std::make_pair(spentKey, CSpentIndexValue(txhash, j, nHeight, coin.out.nValue, indexed.addressType, indexed.hashBytes)));
+                else
+                    data.spentIndex.push_back(std::make_pair(spentKey, CSpentIndexValue()));
+            }
+        }
+
+        for (unsigned int k = 0; k < tx.vout.size(); k++) {
+            const CTxOut& out = tx.vout[k];
+
+            CIndexedOutput indexed;
+            if (!GetIndexedOutput(out, indexed))
+                continue;
+
+            // receiving activity
+            data.addressIndex.push_back(std::make_pair(CAddressIndexKey(indexed.addressType, indexed.hashBytes, indexed.tokenName, nHeight, i, txhash, k, false, indexed.nTimeLock), indexed.nAmount));
+
+            // the output enters the unspent index, and leaves it when the block is disconnected
+            CAddressUnspentKey unspentKey(indexed.addressType, indexed.hashBytes, indexed.tokenName, txhash, k, indexed.nTimeLock);
+            if (fConnect)
+                data.addressUnspentIndex.push_back(std::make_pair(unspentKey, CAddressUnspentValue(indexed.nAmount, out.scriptPubKey, nHeight, tx.nTime)));
+            else
+                data.addressUnspentIndex.push_back(std::make_pair(unspentKey, CAddressUnspentValue()));
+        }
+    }
+
+    return true;
+}
+
+CIndexesSync::CIndexesSync() : fTipChanged(false), pindexBest(nullptr), fSynced(false), fInterrupt(false), fMovedIndexesErased(false)
+{
+}
+
+CIndexesSync::~CIndexesSync()
+{
+    Stop();
+}
+
+void CIndexesSync::Start()
+{
+    uint256 hashBest = pindexesdb->GetBestBlock();
+    {
+        LOCK(cs_main);
+        BlockMap::iterator mi = mapBlockIndex.find(hashBest);
+        if (mi != mapBlockIndex.end())
+            pindexBest = mi->second;
+    }
+    LogPrintf("%s: indexes are at height %d\n", __func__, pindexBest ? pindexBest->nHeight : -1);
+
+    RegisterValidationInterface(this);
+    threadSync = std::thread(&TraceThread<std::function<void()> >, "indexes", std::function<void()>(std::bind(&CIndexesSync::ThreadSync, this)));
+}
+
+void CIndexesSync::Stop()
+{
+    if (!threadSync.joinable())
+        return;
+
+    UnregisterValidationInterface(this);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fInterrupt = true;
+    }
+    condTip.notify_all();
+    condBest.notify_all();
+    threadSync.join();
+}
+
+int CIndexesSync::GetBestHeight()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pindexBest ? pindexBest->nHeight : -1;
+}
+
+bool CIndexesSync::BlockUntilSyncedToCurrentChain()
+{
+    if (!fSynced)
+        return false;
+
+    while (!fInterrupt) {
+        const CBlockIndex* pindexTip;
+        {
+            LOCK(cs_main);
+            pindexTip = chainActive.Tip();
+        }
+        if (pindexTip == nullptr)
+            return true;
+
+        // The tip is read again now and then, a reorg may take the indexes past it without ever reaching it
+        std::unique_lock<std::mutex> lock(mutex);
+        if (condBest.wait_for(lock, std::chrono::seconds(1), [&] { return fInterrupt || (pindexBest && pindexBest->GetAncestor(pindexTip->nHeight) == pindexTip); }))
+            return !fInterrupt;
+    }
+
+    return false;
+}
+
+void CIndexesSync::BlockConnected(const std::shared_ptr<const CBlock> &block, const CBlockIndex *pindex, const std::vector<CTransactionRef> &txnConflicted)
+{
+    NotifyTipChanged();
+}
+
+void CIndexesSync::BlockDisconnected(const std::shared_ptr<const CBlock> &block)
+{
+    NotifyTipChanged();
+}
+
+void CIndexesSync::NotifyTipChanged()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fTipChanged = true;
+    }
+    condTip.notify_one();
+}
+
+void CIndexesSync::ThreadSync()
+{
+    while (!fInterrupt) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fTipChanged = false;
+        }
+
+        if (!SyncWithActiveChain())
+            return;
+
+        // Older versions kept the indexes in the block tree database, their rows are dropped once these replace them
+        if (fSynced && !fMovedIndexesErased) {
+            if (!pblocktree->EraseMovedIndexes(&fInterrupt))
+                LogPrintf("%s: Failed to erase the indexes from the block tree database\n", __func__);
+            fMovedIndexesErased = true;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        condTip.wait(lock, [this] { return fTipChanged || fInterrupt; });
+    }
+}
+
+bool CIndexesSync::SyncWithActiveChain()
+{
+    int64_t nLastLog = GetTime();
+
+    while (!fInterrupt) {
+        const CBlockIndex* pindex;
+        bool fConnect;
+        {
+            LOCK(cs_main);
+            if (pindexBest == nullptr) {
+                pindex = chainActive.Genesis();
+                fConnect = true;
+            } else if (!chainActive.Contains(pindexBest)) {
+                // Left behind by a reorg, or ahead of a chainstate that wasn't flushed before a crash
+                pindex = pindexBest;
+                fConnect = false;
+            } else {
+                pindex = chainActive.Next(pindexBest);
+                fConnect = true;
+            }
+
+            if (pindex == nullptr) {
+                if (!fSynced) {
+                    LogPrintf("%s: indexes are synced with the chain at height %d\n", __func__, chainActive.Height());
+                    fSynced = true;
+                }
+                return true;
+            }
+        }
+
+        if (!WriteBlock(pindex, fConnect))
+            return false;
+
+        SetBest(fConnect ? pindex : pindex->pprev);
+
+        if (!fSynced && GetTime() - nLastLog >= INDEXES_SYNC_LOG_INTERVAL) {
+            LogPrintf("Syncing indexes with the chain at height %d\n", pindex->nHeight);
+            nLastLog = GetTime();
+        }
+    }
+
+    return true;
+}
+
+bool CIndexesSync::WriteBlock(const CBlockIndex* pindex, bool fConnect)
+{
+    CDBBatch batch(*pindexesdb);
+
+    // The transactions of the genesis block aren't indexed, it can't be spent from
+    if (pindex->pprev) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, GetParams().GetConsensus()))
+            return AbortNode(strprintf("%s: Failed to read block %s from disk", __func__, pindex->GetIndexHash().ToString()));
+
+        CBlockUndo blockundo;
+        if (!UndoReadFromDisk(blockundo, pindex->GetUndoPos(), pindex->pprev->GetIndexHash()))
+            return AbortNode(strprintf("%s: Failed to read undo data of block %s from disk", __func__, pindex->GetIndexHash().ToString()));
+
+        CIndexesBlockData data;
+        if (!GetIndexesBlockData(block, blockundo, pindex->nHeight, fConnect, data))
+            return AbortNode(strprintf("%s: Undo data of block %s doesn't match the block", __func__, pindex->GetIndexHash().ToString()));
+
+        if (fAddressIndex) {
+            if (fConnect)
+                pindexesdb->WriteAddressIndex(batch, data.addressIndex, fAddressBalanceIndex);
+            else
+                pindexesdb->EraseAddressIndex(batch, data.addressIndex, fAddressBalanceIndex);
+            pindexesdb->UpdateAddressUnspentIndex(batch, data.addressUnspentIndex);
+        }
+
+        if (fSpentIndex)
+            pindexesdb->UpdateSpentIndex(batch, data.spentIndex);
+
+        // Timestamps of disconnected blocks are kept, they are filtered by whether the block is in the active chain
+        if (fTimestampIndex && fConnect) {
+            unsigned int logicalTS = pindex->nTime;
+            unsigned int prevLogicalTS = 0;
+
+            // retrieve logical timestamp of the previous block
+            if (!pindexesdb->ReadTimestampBlockIndex(pindex->pprev->GetIndexHash(), prevLogicalTS))
+                LogPrintf("%s: Failed to read previous block's logical timestamp\n", __func__);
+
+            if (logicalTS <= prevLogicalTS) {
+                logicalTS = prevLogicalTS + 1;
+                LogPrintf("%s: Previous logical timestamp is newer Actual[%d] prevLogical[%d] Logical[%d]\n", __func__, pindex->nTime, prevLogicalTS, logicalTS);
+            }
+
+            pindexesdb->WriteTimestampIndex(batch, CTimestampIndexKey(logicalTS, pindex->GetIndexHash()));
+            pindexesdb->WriteTimestampBlockIndex(batch, CTimestampBlockIndexKey(pindex->GetIndexHash()), CTimestampBlockIndexValue(logicalTS));
+        }
+    }
+
+    const CBlockIndex* pindexNewBest = fConnect ? pindex : pindex->pprev;
+    pindexesdb->WriteBestBlock(batch, pindexNewBest ? pindexNewBest->GetIndexHash() : uint256());
+    if (!pindexesdb->WriteBatch(batch))
+        return AbortNode(strprintf("%s: Failed to write the indexes of block %s", __func__, pindex->GetIndexHash().ToString()));
+
+    return true;
+}
+
+void CIndexesSync::SetBest(const CBlockIndex* pindex)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pindexBest = pindex;
+    }
+    condBest.notify_all();
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2021-2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef PLB_INDEXES_H
+#define PLB_INDEXES_H
+
+#include "addressindex.h"
+#include "spentindex.h"
+#include "validationinterface.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+
+/** Changes a block makes to the address and spent indexes */
+struct CIndexesBlockData
+{
+    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
+    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
+};
+
+/**
+ * Collects the index changes of connecting (fConnect) or disconnecting a block. The address index entries are the
+ * same both ways, the unspent and spent index entries are restored or erased when the block is disconnected.
+ * Returns false if the undo data doesn't match the block.
+ */
+bool GetIndexesBlockData(const CBlock& block, const CBlockUndo& blockundo, int nHeight, bool fConnect, CIndexesBlockData& data);
+
+/**
+ * Keeps the address, spent and timestamp indexes in pindexesdb up to date with the active chain.
+ *
+ * Validation only signals that the tip changed, the blocks are indexed by a thread of their own from the block and
+ * undo files, so the indexes don't slow down connecting blocks. The same thread catches up with the chain when the
+ * node starts, an index was just enabled or the indexes fell behind before a shutdown.
+ */
+class CIndexesSync : public CValidationInterface
+{
+public:
+    CIndexesSync();
+    virtual ~CIndexesSync();
+
+    void Start();
+    void Stop();
+
+    //! Whether the indexes caught up with the chain since the node started
+    bool IsSynced() const { return fSynced; }
+
+    //! Height of the last block indexed, -1 if none
+    int GetBestHeight();
+
+    /**
+     * Waits until the indexes include the tip of the active chain at the time of the call. Returns false without
+     * waiting if they are still catching up. Must not be called with cs_main held.
+     */
+    bool BlockUntilSyncedToCurrentChain();
+
+protected:
+    void BlockConnected(const std::shared_ptr<const CBlock> &block, const CBlockIndex *pindex, const std::vector<CTransactionRef> &txnConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock> &block) override;
+
+private:
+    std::mutex mutex;
+    std::condition_variable condTip;
+    std::condition_variable condBest;
+    bool fTipChanged;
+    const CBlockIndex* pindexBest;
+
+    std::atomic<bool> fSynced;
+    std::atomic<bool> fInterrupt;
+    std::thread threadSync;
+
+    //! Set once the rows older versions kept in the block tree database were erased, only used by the sync thread
+    bool fMovedIndexesErased;
+
+    void NotifyTipChanged();
+    void ThreadSync();
+    bool SyncWithActiveChain();
+    bool WriteBlock(const CBlockIndex* pindex, bool fConnect);
+    void SetBest(const CBlockIndex* pindex);
+};
+
+extern CIndexesSync* pindexessync;
+
+#endif // PLB_INDEXES_H
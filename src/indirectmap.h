@@ -6,6 +6,8 @@
 #ifndef PLB_INDIRECTMAP_H
 #define PLB_INDIRECTMAP_H
 
+#include <map>
+
 template <class T>
 struct DereferencingComparator { bool operator()(const T a, const T b) const { return *a < *b; } };
 
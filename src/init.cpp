@@ -17,9 +17,11 @@
 #include "checkpoints.h"
 #include "compat/sanity.h"
 #include "consensus/validation.h"
+#include "crypto/blake2b_header.h"
 #include "fs.h"
 #include "httpserver.h"
 #include "httprpc.h"
+#include "indexes.h"
 #include "key.h"
 #include "validation.h"
 #include "miner.h"
@@ -244,6 +246,13 @@ void PrepareShutdown()
     // CValidationInterface callbacks, flush them...
     GetMainSignals().FlushBackgroundCallbacks();
 
+    // The indexes thread waits for cs_main, stop it before taking it
+    if (pindexessync != nullptr) {
+        pindexessync->Stop();
+        delete pindexessync;
+        pindexessync = nullptr;
+    }
+
     // Any future callbacks will be dropped. This should absolutely be safe - if
     // missing a callback results in an unrecoverable situation, unclean shutdown
     // would too. The only reason to do the above flushes is to let the wallet catch
@@ -270,6 +279,9 @@ void PrepareShutdown()
         delete pblocktree;
         pblocktree = nullptr;
 
+        delete pindexesdb;
+        pindexesdb = nullptr;
+
         /** TOKENS START */
         delete ptokens;
         ptokens = nullptr;
@@ -283,12 +295,6 @@ void PrepareShutdown()
         delete pMessagesCache;
         pMessagesCache = nullptr;
 
-        delete pMessageSubscribedChannelsCache;
-        pMessageSubscribedChannelsCache = nullptr;
-
-        delete pMessagesSeenAddressCache;
-        pMessagesSeenAddressCache = nullptr;
-
         delete pmessagechanneldb;
         pmessagechanneldb = nullptr;
 
@@ -325,6 +331,9 @@ void PrepareShutdown()
         delete pDistributeSnapshotDb;
         pDistributeSnapshotDb = nullptr;
 
+        delete pgovernanceTip;
+        pgovernanceTip = nullptr;
+
         delete governance;
         governance = nullptr;
 
@@ -486,10 +495,13 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-sysperms", _("Create new files with system default permissions, instead of umask 077 (only effective with disabled wallet functionality)"));
 #endif
     strUsage += HelpMessageOpt("-txindex", strprintf(_("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)"), DEFAULT_TXINDEX));
+    strUsage += HelpMessageOpt("-tokencache=<n>", strprintf(_("Set the memory the token cache may use before it is written to the database in megabytes (%d to %d, default: %d)"), nMinTokenCache, nMaxDbCache, nDefaultTokenCache));
     strUsage += HelpMessageOpt("-tokenindex", _("Keep an index of tokens, used by the requestsnapshot rpc call. Requires a -reindex."));
 
     strUsage += HelpMessageOpt("-addressindex", strprintf(_("Maintain a full address index, used to query for the balance, txids and unspent outputs for addresses (default: %u)"), DEFAULT_ADDRESSINDEX));
+    strUsage += HelpMessageOpt("-addressbalanceindex", strprintf(_("Keep the balance of every address up to date in the address index, so getaddressbalance doesn't have to add up its history. Requires -addressindex (default: %u)"), DEFAULT_ADDRESSBALANCEINDEX));
     strUsage += HelpMessageOpt("-timestampindex", strprintf(_("Maintain a timestamp index for block hashes, used to query blocks hashes by a range of timestamps (default: %u)"), DEFAULT_TIMESTAMPINDEX));
+    strUsage += HelpMessageOpt("-indexcache=<n>", strprintf(_("Set the database cache of the address, spent and timestamp indexes in megabytes (%d to %d, default: %d)"), nMinIndexCache, nMaxDbCache, nDefaultIndexCache));
     strUsage += HelpMessageOpt("-spentindex", strprintf(_("Maintain a full spent index, used to query the spending txid and input index for an outpoint (default: %u)"), DEFAULT_SPENTINDEX));
 
     strUsage += HelpMessageGroup(_("Connection options:"));
@@ -1019,8 +1031,21 @@ bool AppInitParameterInteraction()
     if (gArgs.GetArg("-prune", 0)) {
         if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX))
             return InitError(_("Prune mode is incompatible with -txindex."));
+        // the indexes are built from the block and undo files
+        if (gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX) || gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX) || gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX))
+            return InitError(_("Prune mode is incompatible with -addressindex, -spentindex and -timestampindex."));
     }
 
+    // the address balance index is kept next to the address index
+    if (gArgs.GetBoolArg("-addressbalanceindex", DEFAULT_ADDRESSBALANCEINDEX) && !gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX))
+        return InitError(_("-addressbalanceindex requires -addressindex."));
+
+    // the indexes live in a database of their own, they are rebuilt when these change
+    fAddressIndex = gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
+    fAddressBalanceIndex = gArgs.GetBoolArg("-addressbalanceindex", DEFAULT_ADDRESSBALANCEINDEX);
+    fSpentIndex = gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
+    fTimestampIndex = gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
+
     // -bind and -whitebind can't be set when not listening
     size_t nUserBind = gArgs.GetArgs("-bind").size() + gArgs.GetArgs("-whitebind").size();
     if (nUserBind != 0 && !gArgs.GetBoolArg("-listen", DEFAULT_LISTEN)) {
@@ -1302,6 +1327,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string blake2b_algo = Blake2bAutoDetect();
+    LogPrintf("Using the '%s' BLAKE2b implementation\n", blake2b_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1527,12 +1554,22 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
         int64_t nGovernanceDBCache = nTotalCache / 2;
     nTotalCache -= nGovernanceDBCache;
     nCoinCacheUsage = nTotalCache; // the rest goes to in-memory cache
+    int64_t nTokenCache = (gArgs.GetArg("-tokencache", nDefaultTokenCache) << 20);
+    nTokenCache = std::max(nTokenCache, nMinTokenCache << 20);
+    nTokenCache = std::min(nTokenCache, nMaxDbCache << 20);
+    nTokenCacheUsage = nTokenCache; // in addition to -dbcache
     int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for governance database\n", nGovernanceDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
+    LogPrintf("* Using %.1fMiB for in-memory token cache\n", nTokenCacheUsage * (1.0 / 1024 / 1024));
+    int64_t nIndexDBCache = (gArgs.GetArg("-indexcache", nDefaultIndexCache) << 20);
+    nIndexDBCache = std::max(nIndexDBCache, nMinIndexCache << 20);
+    nIndexDBCache = std::min(nIndexDBCache, nMaxDbCache << 20);
+    if (fAddressIndex || fSpentIndex || fTimestampIndex)
+        LogPrintf("* Using %.1fMiB for address, spent and timestamp index database\n", nIndexDBCache * (1.0 / 1024 / 1024));
 
     bool fLoaded = false;
     while (!fLoaded && !fRequestShutdown) {
@@ -1562,8 +1599,6 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     delete pmessagedb;
                     delete pmessagechanneldb;
                     delete pMessagesCache;
-                    delete pMessagesSeenAddressCache;
-                    delete pMessageSubscribedChannelsCache;
 
                     // My restricted tokens
                     delete pmyrestricteddb;
@@ -1581,17 +1616,16 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     delete pDistributeSnapshotDb;
 
                     // Governance
+                    delete pgovernanceTip;
                     delete governance;
 
                     // Basic tokens
                     ptokensdb = new CTokensDB(nBlockTreeDBCache, false, fReset);
                     ptokens = new CTokensCache();
-                    ptokensCache = new CLRUCache<std::string, CDatabasedTokenData>(MAX_CACHE_TOKENS_SIZE);
+                    ptokensCache = new CLRUCache<std::string, CDatabasedTokenData>(MAX_CACHE_TOKENS_BYTES);
 
                     // Messaging tokens
-                    pMessagesCache = new CLRUCache<std::string, CMessage>(1000);
-                    pMessageSubscribedChannelsCache = new CLRUCache<std::string, int>(1000);
-                    pMessagesSeenAddressCache = new CLRUCache<std::string, int>(1000);
+                    pMessagesCache = new CLRUCache<std::string, CMessage>(MAX_CACHE_MESSAGES_BYTES);
                     pmessagedb = new CMessageDB(nBlockTreeDBCache, false, false);
                     pmessagechanneldb = new CMessageChannelDB(nBlockTreeDBCache, false, false);
 
@@ -1601,10 +1635,10 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     // Restricted tokens
                     prestricteddb = new CRestrictedDB(nBlockTreeDBCache, false, fReset);
                     ptokensVerifierCache = new CLRUCache<std::string, CNullTokenTxVerifierString>(
-                            MAX_CACHE_TOKENS_SIZE);
-                    ptokensQualifierCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_TOKENS_SIZE);
-                    ptokensRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_TOKENS_SIZE);
-                    ptokensGlobalRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_TOKENS_SIZE);
+                            MAX_CACHE_TOKENS_BYTES);
+                    ptokensQualifierCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_TOKENS_BYTES);
+                    ptokensRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_TOKENS_BYTES);
+                    ptokensGlobalRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_TOKENS_BYTES);
 
                     // Rewards
                     pSnapshotRequestDb = new CSnapshotRequestDB(nBlockTreeDBCache, false, false);
@@ -1613,6 +1647,17 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
                     // Read for fTokenIndex to make sure that we only load token address balances if it if true
                     pblocktree->ReadFlag("tokenindex", fTokenIndex);
+
+                    // Databases written with base58 address keys are rewritten once, before anything reads them
+                    if (!ptokensdb->UpgradeAddressKeys()) {
+                        strLoadError = _("Failed to upgrade the Tokens Database");
+                        break;
+                    }
+                    if (!prestricteddb->UpgradeAddressKeys()) {
+                        strLoadError = _("Failed to upgrade the Restricted Tokens Database");
+                        break;
+                    }
+
                     // Need to load tokens before we verify the database
                     if (!ptokensdb->LoadTokens()) {
                         strLoadError = _("Failed to load Tokens Database");
@@ -1632,6 +1677,14 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                         fMessaging = false;
                     } else {
                         LogPrintf("Messaging is enabled\n");
+
+                        LOCK(cs_messaging);
+                        if (!pmessagechanneldb->LoadMyMessageChannels(setSubscribedChannels) || !pmessagechanneldb->LoadUsedAddresses(setSeenAddresses)) {
+                            strLoadError = _("Failed to load Message Channels Database");
+                            break;
+                        }
+
+                        LogPrintf("Loaded %u message channels and %u seen addresses\n", setSubscribedChannels.size(), setSeenAddresses.size());
                     }
                 }
                 /** TOKENS END */
@@ -1666,24 +1719,6 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     break;
                 }
 
-                // Check for changed -addressindex state
-                if (fAddressIndex != gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex-chainstate to change -addressindex");
-                    break;
-                }
-
-                // Check for changed -spentindex state
-                if (fSpentIndex != gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex-chainstate to change -spentindex");
-                    break;
-                }
-
-                // Check for changed -timestampindex state
-                if (fTimestampIndex != gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex-chainstate to change -timestampindex");
-                    break;
-                }
-
                 // Check for changed -prune state.  What we are concerned about is a user who has pruned blocks
                 // in the past, but is now trying to run unpruned.
                 if (fHavePruned && !fPruneMode) {
@@ -1708,6 +1743,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
                 governance = new CGovernance(nGovernanceDBCache, false, fReset);
                 governance->Init(fReset, chainparams);
+                pgovernanceTip = new CGovernanceCache(governance);
 
                 // If necessary, upgrade from older database format.
                 // This is a no-op if we cleared the coinsviewdb with -reindex or -reindex-chainstate
@@ -1716,12 +1752,36 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     break;
                 }
 
+                // Governance databases from before the best block marker were written with every connected block,
+                // so after a clean shutdown they are at the chainstate's tip. After an interrupted chainstate flush
+                // there is no telling which of its blocks they hold.
+                if (!governance->HasBestBlock()) {
+                    if (!pcoinsdbview->GetHeadBlocks().empty()) {
+                        strLoadError = _("Governance database is inconsistent with the chainstate. You will need to rebuild the database using -reindex.");
+                        break;
+                    }
+                    if (!governance->Upgrade(pcoinsdbview->GetBestBlock())) {
+                        strLoadError = _("Error upgrading governance database");
+                        break;
+                    }
+                }
+
                 // ReplayBlocks is a no-op if we cleared the coinsviewdb with -reindex or -reindex-chainstate
                 if (!ReplayBlocks(chainparams, pcoinsdbview)) {
                     strLoadError = _("Unable to replay blocks. You will need to rebuild the database using -reindex-chainstate.");
                     break;
                 }
 
+                // ReplayBlocks moved the governance state, which is flushed right after the chainstate and tagged with
+                // its best block, to the replayed tip. Refuse to continue on top of one that belongs to another block.
+                if (!fReindexChainState) {
+                    uint256 hashGovernance = governance->GetBestBlock();
+                    if (!hashGovernance.IsNull() && hashGovernance != pcoinsdbview->GetBestBlock()) {
+                        strLoadError = _("Governance database is inconsistent with the chainstate. You will need to rebuild the database using -reindex.");
+                        break;
+                    }
+                }
+
                 // The on-disk coinsdb is now in a good state, create the cache
                 pcoinsTip = new CCoinsViewCache(pcoinscatcher);
 
@@ -1812,6 +1872,45 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
         LogPrintf(" block index %15dms\n", GetTimeMillis() - nStart);
     }
 
+    // The indexes are kept up to date from the block and undo files by a thread of their own. They are rebuilt from
+    // the genesis block after a reindex, when an index was enabled or disabled, or when they are at a block we don't know.
+    if (fAddressIndex || fSpentIndex || fTimestampIndex) {
+        bool fWipe = fReindex || fReindexChainState;
+        pindexesdb = new CIndexesDB(nIndexDBCache, false, fWipe, dbMaxFileSize);
+
+        if (!fWipe) {
+            bool fAddressIndexDB = false, fAddressBalanceIndexDB = false, fSpentIndexDB = false, fTimestampIndexDB = false;
+            pindexesdb->ReadFlag("addressindex", fAddressIndexDB);
+            pindexesdb->ReadFlag("addressbalanceindex", fAddressBalanceIndexDB);
+            pindexesdb->ReadFlag("spentindex", fSpentIndexDB);
+            pindexesdb->ReadFlag("timestampindex", fTimestampIndexDB);
+
+            uint256 hashBest = pindexesdb->GetBestBlock();
+            bool fKnownBest;
+            {
+                LOCK(cs_main);
+                fKnownBest = hashBest.IsNull() || mapBlockIndex.count(hashBest);
+            }
+
+            if (fAddressIndexDB != fAddressIndex || fAddressBalanceIndexDB != fAddressBalanceIndex || fSpentIndexDB != fSpentIndex || fTimestampIndexDB != fTimestampIndex || !fKnownBest) {
+                LogPrintf("Rebuilding the address, spent and timestamp indexes\n");
+                delete pindexesdb;
+                pindexesdb = new CIndexesDB(nIndexDBCache, false, true, dbMaxFileSize);
+            }
+        }
+
+        if (!pindexesdb->WriteFlag("addressindex", fAddressIndex) || !pindexesdb->WriteFlag("addressbalanceindex", fAddressBalanceIndex) ||
+            !pindexesdb->WriteFlag("spentindex", fSpentIndex) || !pindexesdb->WriteFlag("timestampindex", fTimestampIndex))
+            return InitError(_("Error initializing the index database"));
+
+        pindexessync = new CIndexesSync();
+        pindexessync->Start();
+    } else if (!fReindex) {
+        // Without any index the rows older versions kept in the block tree database are of no use
+        if (!pblocktree->EraseMovedIndexes())
+            return InitError(_("Error erasing the indexes from the block tree database"));
+    }
+
     fs::path est_path = GetDataDir() / FEE_ESTIMATES_FILENAME;
     CAutoFile est_filein(fsbridge::fopen(est_path, "rb"), SER_DISK, CLIENT_VERSION);
     // Allowed to fail as this file IS missing on first startup.
@@ -7,11 +7,16 @@
 #define PLB_MEMUSAGE_H
 
 #include "indirectmap.h"
+#include "prevector.h"
 
 #include <stdlib.h>
 
+#include <cassert>
+#include <list>
 #include <map>
+#include <memory>
 #include <set>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -72,6 +77,15 @@ private:
     X x;
 };
 
+template<typename X>
+struct stl_list_node
+{
+private:
+    void* next;
+    void* prev;
+    X x;
+};
+
 struct stl_shared_counter
 {
     /* Various platforms use different sized counters here.
@@ -87,6 +101,15 @@ static inline size_t DynamicUsage(const std::vector<X>& v)
     return MallocUsage(v.capacity() * sizeof(X));
 }
 
+static inline size_t DynamicUsage(const std::string& s)
+{
+    // Short strings are kept inside the string object itself
+    const char* data = s.data();
+    if (data >= reinterpret_cast<const char*>(&s) && data < reinterpret_cast<const char*>(&s) + sizeof(s))
+        return 0;
+    return MallocUsage(s.capacity() + 1);
+}
+
 template<unsigned int N, typename X, typename S, typename D>
 static inline size_t DynamicUsage(const prevector<N, X, S, D>& v)
 {
@@ -117,6 +140,12 @@ static inline size_t IncrementalDynamicUsage(const std::map<X, Y, Z>& m)
     return MallocUsage(sizeof(stl_tree_node<std::pair<const X, Y> >));
 }
 
+template<typename X>
+static inline size_t DynamicUsage(const std::list<X>& l)
+{
+    return MallocUsage(sizeof(stl_list_node<X>)) * l.size();
+}
+
 // indirectmap has underlying map with pointer as key
 
 template<typename X, typename Y>
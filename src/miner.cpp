@@ -15,6 +15,7 @@
 #include "consensus/tx_verify.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
+#include "crypto/blake2b_header.h"
 #include "hash.h"
 #include "validation.h"
 #include "net.h"
@@ -104,7 +105,7 @@ bool CheckFirstCoinstakeOutput(const CBlock& block){
 
 #ifdef ENABLE_WALLET
 // novacoin: attempt to generate suitable proof-of-stake
-bool SignBlock(std::shared_ptr<CBlock> pblock, CWallet& wallet, const CAmount& nTotalFees, const CBlockIndex* pindexPrev, std::vector< CScript > validatorVector)
+bool SignBlock(std::shared_ptr<CBlock> pblock, CWallet& wallet, const CAmount& nTotalFees, const CBlockIndex* pindexPrev, const CGovernanceScriptSet& validators)
 {
     // if we are trying to sign
     //    something except proof-of-stake block template
@@ -120,7 +121,7 @@ bool SignBlock(std::shared_ptr<CBlock> pblock, CWallet& wallet, const CAmount& n
     CMutableTransaction txCoinStake(*pblock->vtx[1]);
     txCoinStake.nTime = pblock->nTime;
 
-    if (wallet.CreateCoinStake(wallet, pblock->nBits, nTotalFees, pblock->nTime, txCoinStake, key, validatorVector))
+    if (wallet.CreateCoinStake(wallet, pblock->nBits, nTotalFees, pblock->nTime, txCoinStake, key, validators))
     {
         if (txCoinStake.nTime >= pindexPrev->GetMedianTimePast() + 1)
         {
@@ -530,8 +531,13 @@ void ThreadStakeMiner(CWallet *pwallet)
 
     bool fTryToSync = true;
 
-    std::vector< CScript > validatorVector;
-    int nValidatorHeight = -1;
+    CGovernanceScriptSet validators;
+    uint64_t nValidatorEpoch = std::numeric_limits<uint64_t>::max();
+
+    // Earliest timestamp with a kernel on top of hashKernelTip, and how far ahead it has been searched
+    uint256 hashKernelTip;
+    uint32_t nTimeKernel = 0;
+    uint32_t nTimeSearched = 0;
 
     while (true) {
         while (pwallet->IsLocked())
@@ -558,17 +564,47 @@ void ThreadStakeMiner(CWallet *pwallet)
 
         CBlockIndex* pindexPrev = chainActive.Tip();
 
-        if (nValidatorHeight != pindexPrev->nHeight) {
-            LogPrintf("ThreadStakeMiner: Detected new block, updating list of validators\n");
-            governance->GetActiveValidatorsScript(&validatorVector);
-            nValidatorHeight = pindexPrev->nHeight;
+        // Only copy the validator set when the authorization list has changed
+        uint64_t nEpoch = pgovernanceTip->GetValidatorEpoch();
+        if (nValidatorEpoch != nEpoch) {
+            LogPrintf("ThreadStakeMiner: Authorization list changed, updating list of validators\n");
+            pgovernanceTip->GetValidators(validators);
+            nValidatorEpoch = nEpoch;
+        }
+
+        if (pindexPrev->GetIndexHash() != hashKernelTip) {
+            hashKernelTip = pindexPrev->GetIndexHash();
+            nTimeKernel = 0;
+            nTimeSearched = 0;
+        }
+
+        // Hash the kernels for the next few timestamps in one go and sleep until the first hit,
+        // instead of assembling a block template every time just to try the current timestamp
+        uint32_t nTimeNow = GetAdjustedTime() & ~STAKE_TIMESTAMP_MASK;
+        if (nTimeKernel < nTimeNow) {
+            uint32_t nTimeFrom = std::max(nTimeNow, nTimeSearched + STAKE_TIMESTAMP_MASK + 1);
+            uint32_t nTimeTo = nTimeNow + MAX_STAKE_LOOKAHEAD;
+            if (nTimeFrom > nTimeTo) {
+                // The whole lookahead came up empty already, wait until it moves past what was searched
+                MilliSleep(nMinerSleep);
+                continue;
+            }
+            if (pwallet->FindStakeTime(pindexPrev, nTimeFrom, nTimeTo, validators, nTimeKernel)) {
+                // The search stops at the first hit, later timestamps still have to be tried
+                nTimeSearched = nTimeKernel;
+            } else {
+                nTimeKernel = 0;
+                nTimeSearched = std::max(nTimeSearched, nTimeTo);
+            }
         }
 
         //
         // Create new block
         //
 
-        if (pwallet->HaveAvailableCoinsForStaking(validatorVector)) {
+        if (nTimeKernel != nTimeNow) {
+            MilliSleep(nMinerSleep);
+        } else {
             int64_t nTotalFees = 0;
             std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(GetParams()).CreateNewBlock(reservekey.reserveScript, true, &nTotalFees));
             if (!pblocktemplate.get())
@@ -578,7 +614,7 @@ void ThreadStakeMiner(CWallet *pwallet)
 
             // Try to sign a block (this also checks for a PoS stake)
             std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>(pblocktemplate->block);
-            if (SignBlock(pblock, *pwallet, nTotalFees, pindexPrev, validatorVector)) {
+            if (SignBlock(pblock, *pwallet, nTotalFees, pindexPrev, validators)) {
                 // Increase priority so we can build the full PoS block ASAP to ensure the timestamp doesn't expire
                 SetThreadPriority(THREAD_PRIORITY_ABOVE_NORMAL);
 
@@ -603,6 +639,15 @@ void ThreadStakeMiner(CWallet *pwallet)
     }
 }
 
+int GetStakingThreads()
+{
+    // 0 = one per core, <0 = leave that many cores free
+    int nThreads = gArgs.GetArg("-stakingthreads", DEFAULT_STAKING_THREADS);
+    if (nThreads <= 0)
+        nThreads += GetNumCores();
+    return std::max(1, nThreads);
+}
+
 void StakeCoins(bool fStake, CWallet *pwallet, boost::thread_group*& stakeThread)
 {
     if (fStake) {
@@ -622,6 +667,10 @@ void StakeCoins(bool fStake, CWallet *pwallet, boost::thread_group*& stakeThread
     {
         stakeThread = new boost::thread_group();
         stakeThread->create_thread(boost::bind(&ThreadStakeMiner, pwallet));
+
+        // The staker thread joins the kernel search workers while it waits for a search
+        for (int i = 0; i < GetStakingThreads() - 1; i++)
+            stakeThread->create_thread(&ThreadStakeKernelSearch);
     }
 }
 
@@ -883,11 +932,32 @@ void static SoloMiner(const CChainParams& chainparams)
             while (true)
             {
 
+                // Only the nonce changes until the next check below, so hash from the midstate of the header
+                Blake2bHeaderMidstate midstate;
+                Blake2bHeaderMidstateInit(midstate, (const unsigned char*)BEGIN(pblock->nVersion));
+                unsigned char hashes[BLAKE2B_HEADER_LANES * BLAKE2B_HEADER_HASH_SIZE];
                 uint256 hash;
                 while (true)
                 {
-                    hash = pblock->GetWorkHash();
-                    if (UintToArith256(hash) <= hashTarget)
+                    bool fFound = false;
+                    Blake2bHeaderHash8(midstate, pblock->nNonce, hashes);
+                    for (size_t i = 0; i < BLAKE2B_HEADER_LANES; i++) {
+                        memcpy(hash.begin(), hashes + BLAKE2B_HEADER_HASH_SIZE * i, BLAKE2B_HEADER_HASH_SIZE);
+                        if (UintToArith256(hash) <= hashTarget) {
+                            // Only submit what the scalar hash agrees with, a faulty lane just loses this batch
+                            uint32_t nNonceBatch = pblock->nNonce;
+                            pblock->nNonce += i;
+                            if (hash != pblock->GetWorkHash()) {
+                                LogPrintf("SoloMiner -- ERROR: lane hash %s of nonce %u differs from the header hash %s, discarding it\n",
+                                    hash.GetHex(), pblock->nNonce, pblock->GetWorkHash().GetHex());
+                                pblock->nNonce = nNonceBatch;
+                                break;
+                            }
+                            fFound = true;
+                            break;
+                        }
+                    }
+                    if (fFound)
                     {
                         // Found a solution
                         SetThreadPriority(THREAD_PRIORITY_NORMAL);
@@ -903,12 +973,12 @@ void static SoloMiner(const CChainParams& chainparams)
 
                         break;
                     }
-                    pblock->nNonce += 1;
-                    nHashesDone += 1;
+                    pblock->nNonce += BLAKE2B_HEADER_LANES;
+                    nHashesDone += BLAKE2B_HEADER_LANES;
                     if (nHashesDone % 500000 == 0) {   //Calculate hashing speed
                         nHashesPerSec = nHashesDone / (((GetTimeMicros() - nMiningTimeStart) / 1000000) + 1);
                     } 
-                    if ((pblock->nNonce & 0xFF) == 0)
+                    if ((pblock->nNonce & 0xFF) < BLAKE2B_HEADER_LANES)
                         break;
                 }
 
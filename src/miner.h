@@ -29,6 +29,9 @@ static const bool DEFAULT_STAKE = false;
 
 static const bool DEFAULT_STAKE_CACHE = true;
 
+// Number of threads hashing stake kernels, 0 = one per core
+static const int DEFAULT_STAKING_THREADS = 0;
+
 // How many seconds to look ahead and prepare a block for staking
 // Look ahead up to 3 "timeslots" in the future, 48 seconds
 // Reduce this to reduce computational waste for stakers, increase this to increase the amount of time available to construct full blocks
@@ -228,6 +231,9 @@ private:
     int UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded, indexed_modified_transaction_set &mapModifiedTx);
 };
 
+/** Number of threads hashing stake kernels from -stakingthreads, including the staker thread */
+int GetStakingThreads();
+
 /** Stake coins */
 void StakeCoins(bool fStake, CWallet *pwallet, boost::thread_group*& stakeThread);
 
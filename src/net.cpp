@@ -702,6 +702,10 @@ void CNode::copyStats(CNodeStats &stats)
         X(mapRecvBytesPerMsgCmd);
         X(nRecvBytes);
     }
+    {
+        LOCK(cs_tokenDataServed);
+        X(tokenDataServed);
+    }
     X(fWhitelisted);
 
     // It is common for nodes with good ping times to suddenly become lagged,
@@ -2735,6 +2739,22 @@ uint64_t CConnman::GetTotalBytesSent()
     return nTotalBytesSent;
 }
 
+void CConnman::RecordTokenDataServed(CNode* pnode, const CTokenDataServeStats& served)
+{
+    {
+        LOCK(pnode->cs_tokenDataServed);
+        pnode->tokenDataServed.Add(served);
+    }
+    LOCK(cs_totalTokenDataServed);
+    totalTokenDataServed.Add(served);
+}
+
+CTokenDataServeStats CConnman::GetTotalTokenDataServed()
+{
+    LOCK(cs_totalTokenDataServed);
+    return totalTokenDataServed;
+}
+
 ServiceFlags CConnman::GetLocalServices() const
 {
     return nLocalServices;
@@ -118,6 +118,27 @@ struct CSerializedNetMsg
     std::string command;
 };
 
+/** Token meta data served to peers in answer to gettokendata requests */
+struct CTokenDataServeStats
+{
+    //! Records sent, in tokendata or tokendatas messages
+    uint64_t nRecords = 0;
+    //! Names answered as not found
+    uint64_t nNotFound = 0;
+    //! Bytes of the messages sent, headers included
+    uint64_t nBytes = 0;
+    //! Time spent looking up and queueing the answers, in microseconds
+    int64_t nServeTimeMicros = 0;
+
+    void Add(const CTokenDataServeStats& other)
+    {
+        nRecords += other.nRecords;
+        nNotFound += other.nNotFound;
+        nBytes += other.nBytes;
+        nServeTimeMicros += other.nServeTimeMicros;
+    }
+};
+
 class NetEventsInterface;
 class CConnman
 {
@@ -310,6 +331,10 @@ public:
     uint64_t GetTotalBytesRecv();
     uint64_t GetTotalBytesSent();
 
+    //! Adds what was just served to pnode to its totals and the totals of all peers
+    void RecordTokenDataServed(CNode* pnode, const CTokenDataServeStats& served);
+    CTokenDataServeStats GetTotalTokenDataServed();
+
     void SetBestHeight(int height);
     int GetBestHeight() const;
 
@@ -380,6 +405,8 @@ private:
     CCriticalSection cs_totalBytesSent;
     uint64_t nTotalBytesRecv;
     uint64_t nTotalBytesSent;
+    CCriticalSection cs_totalTokenDataServed;
+    CTokenDataServeStats totalTokenDataServed;
 
     // outbound limit & stats
     uint64_t nMaxOutboundTotalBytesSentInCycle;
@@ -551,6 +578,7 @@ public:
     mapMsgCmdSize mapSendBytesPerMsgCmd;
     uint64_t nRecvBytes;
     mapMsgCmdSize mapRecvBytesPerMsgCmd;
+    CTokenDataServeStats tokenDataServed;
     bool fWhitelisted;
     double dPingTime;
     double dPingWait;
@@ -693,6 +721,8 @@ public:
 
     bool fGetTokenData;
     std::set<std::string> setInventoryTokensSend;
+    CCriticalSection cs_tokenDataServed;
+    CTokenDataServeStats tokenDataServed;
 
     // inventory based relay
     CRollingBloomFilter filterInventoryKnown;
@@ -1213,68 +1213,82 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
 
 void static ProcessTokenGetData(CNode* pfrom, const Consensus::Params& consensusParams, CConnman* connman, const std::atomic<bool>& interruptMsgProc)
 {
+    // The meta data is looked up in the published token meta data snapshot, serving a request doesn't take cs_main
+    // unless the snapshot has to catch up with the blocks connected during the initial block download
+    if (IsTokenMetaDataSnapshotBehind() && !IsInitialBlockDownload()) {
+        LOCK(cs_main);
+        if (IsTokenMetaDataSnapshotBehind())
+            PublishTokenMetaDataSnapshot(chainActive.Tip()->GetIndexHash());
+    }
+
+    int64_t nTimeStart = GetTimeMicros();
     std::deque<CInvToken>::iterator it = pfrom->vRecvTokenGetData.begin();
+    std::vector<SerializedTokenData> vTokenData;
     std::vector<CInvToken> vNotFound;
     const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
-    LOCK(cs_main);
+    const bool fBatch = pfrom->nVersion >= TOKENDATA_BATCH_VERSION;
+    CTokenDataServeStats served;
+
+    auto pushMessage = [&](CSerializedNetMsg&& msg) {
+        served.nBytes += msg.data.size() + CMessageHeader::HEADER_SIZE;
+        connman->PushMessage(pfrom, std::move(msg));
+    };
 
     while (it != pfrom->vRecvTokenGetData.end()) {
         // Don't bother if send buffer is too full to respond anyway
         if (pfrom->fPauseSend)
             break;
 
+        if (interruptMsgProc)
+            return;
+
         const CInvToken &inv = *it;
-        {
-            if (interruptMsgProc)
-                return;
+        it++;
 
-            it++;
+        if (!IsTokenNameValid(inv.name)) {
+            served.nNotFound++;
+            vNotFound.push_back(inv);
+            continue;
+        }
 
-            if (!IsTokenNameValid(inv.name)) {
+        CDatabasedTokenData data;
+        if (!GetTokenMetaDataFromSnapshot(inv.name, data)) {
+            served.nNotFound++;
+            if (fBatch) {
                 vNotFound.push_back(inv);
-                continue;
+            } else {
+                data.SetNull();
+                data.token.strName = "_NF"; // Return _NF for NOT Found
+                pushMessage(msgMaker.Make(NetMsgType::TOKENDATA, SerializedTokenData(data)));
             }
+            continue;
+        }
 
-            UNUSED_VAR bool push = false;
-            auto currentActiveTokenCache = GetCurrentTokenCache();
-            if (currentActiveTokenCache) {
-                CNewToken token;
-                int height;
-                uint256 hash;
-                if (currentActiveTokenCache->GetTokenMetaDataIfExists(inv.name, token, height, hash)) {
-                    auto data = CDatabasedTokenData(token, height, hash);
-                    ptokensCache->Put(inv.name, data);
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::TOKENDATA, SerializedTokenData(data)));
-                    push = true;
-                } else {
-                    CDatabasedTokenData data;
-                    data.token.strName = "_NF"; // Return _NF for NOT Found
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::TOKENDATA, SerializedTokenData(data)));
-                }
-            }
+        served.nRecords++;
+        if (!fBatch) {
+            pushMessage(msgMaker.Make(NetMsgType::TOKENDATA, SerializedTokenData(data)));
+            continue;
+        }
 
-//            if (!push) {
-//                vNotFound.push_back(inv);
-//            }
+        vTokenData.emplace_back(data);
+        if (vTokenData.size() == MAX_TOKEN_INV_SZ) {
+            pushMessage(msgMaker.Make(NetMsgType::TOKENDATAS, vTokenData));
+            vTokenData.clear();
         }
     }
 
     pfrom->vRecvTokenGetData.erase(pfrom->vRecvTokenGetData.begin(), it);
 
-//    if (!vNotFound.empty()) {
-//        // Let the peer know that we didn't find what it asked for, so it doesn't
-//        // have to wait around forever. Currently only SPV clients actually care
-//        // about this message: it's needed when they are recursively walking the
-//        // dependencies of relevant unconfirmed transactions. SPV clients want to
-//        // do that because they want to know about (and store and rebroadcast and
-//        // risk analyze) the dependencies of transactions relevant to them, without
-//        // having to download the entire memory pool.
-//        for (auto tokeninv : vNotFound) {
-//            CDatabasedTokenData data;
-//            data.token.strName = "_NF"; // Return _NF for NOT Found
-//            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::TOKENDATA, SerializedTokenData(data)));
-//        }
-//    }
+    if (!vTokenData.empty())
+        pushMessage(msgMaker.Make(NetMsgType::TOKENDATAS, vTokenData));
+
+    // Let the peer know that we didn't find what it asked for, so it doesn't have to wait around forever. Older
+    // peers were only ever answered with _NF records
+    if (fBatch && !vNotFound.empty())
+        pushMessage(msgMaker.Make(NetMsgType::TOKENNOTFOUND, vNotFound));
+
+    served.nServeTimeMicros = GetTimeMicros() - nTimeStart;
+    connman->RecordTokenDataServed(pfrom, served);
 }
 
 uint32_t GetFetchFlags(CNode* pfrom) {
@@ -2926,9 +2940,9 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         // message would be undesirable as we transmit it ourselves.
     }
 
-    else if (strCommand == NetMsgType::TOKENNOTFOUND) {
-        // We do not care about the TOKENNOTFOUND message, but logging an Unknown Command
-        // message would be undesirable as we transmit it ourselves.
+    else if (strCommand == NetMsgType::TOKENNOTFOUND || strCommand == NetMsgType::TOKENDATAS) {
+        // We do not care about the TOKENNOTFOUND and TOKENDATAS messages, but logging an Unknown Command
+        // message would be undesirable as we transmit them ourselves.
     }
 
     else {
@@ -2993,6 +3007,14 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     // this maintains the order of responses
     if (!pfrom->vRecvGetData.empty()) return true;
 
+    if (!pfrom->vRecvTokenGetData.empty())
+        ProcessTokenGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
+
+    if (pfrom->fDisconnect)
+        return false;
+
+    if (!pfrom->vRecvTokenGetData.empty()) return true;
+
     // Don't bother if send buffer is too full to respond anyway
     if (pfrom->fPauseSend)
         return false;
@@ -13,6 +13,11 @@
 #include <chainparams.h>
 #include <script/sign.h>
 #include <consensus/consensus.h>
+#include <checkqueue.h>
+#include <util.h>
+
+#include <atomic>
+#include <limits>
 
 using namespace std;
 
@@ -71,6 +76,147 @@ bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, CAm
     return (UintToArith256(hashProofOfStake) / nValueIn) <= bnTarget;
 }
 
+namespace {
+
+// The candidates in one range that hit the earliest timestamp seen by that range, in candidate order
+struct StakeKernelHits
+{
+    uint32_t nTime = std::numeric_limits<uint32_t>::max();
+    std::vector<size_t> vCandidates;
+};
+
+/**
+ * Hashes the kernels of one contiguous range of candidates, run by the stake kernel search queue.
+ * Every check of a search shares the slots, the earliest timestamp hit by any range and the target,
+ * which all outlive the check since FindStakeKernel waits for the queue.
+ */
+class CStakeKernelSearch
+{
+private:
+    const uint256* pStakeModifier;
+    const arith_uint256* pbnTarget;
+    const std::vector<CStakeKernelCandidate>* pvCandidates;
+    size_t nBegin;
+    size_t nEnd;
+    const std::vector<uint32_t>* pvSlots;
+    std::atomic<uint32_t>* pnBestTime;
+    StakeKernelHits* pHits;
+
+public:
+    CStakeKernelSearch() : pStakeModifier(nullptr), pbnTarget(nullptr), pvCandidates(nullptr), nBegin(0), nEnd(0), pvSlots(nullptr), pnBestTime(nullptr), pHits(nullptr) {}
+    CStakeKernelSearch(const uint256& nStakeModifier, const arith_uint256& bnTarget, const std::vector<CStakeKernelCandidate>& vCandidates,
+                       size_t nBeginIn, size_t nEndIn, const std::vector<uint32_t>& vSlots, std::atomic<uint32_t>& nBestTime, StakeKernelHits& hits) :
+        pStakeModifier(&nStakeModifier), pbnTarget(&bnTarget), pvCandidates(&vCandidates), nBegin(nBeginIn), nEnd(nEndIn), pvSlots(&vSlots), pnBestTime(&nBestTime), pHits(&hits) {}
+
+    bool operator()();
+
+    void swap(CStakeKernelSearch& check)
+    {
+        std::swap(pStakeModifier, check.pStakeModifier);
+        std::swap(pbnTarget, check.pbnTarget);
+        std::swap(pvCandidates, check.pvCandidates);
+        std::swap(nBegin, check.nBegin);
+        std::swap(nEnd, check.nEnd);
+        std::swap(pvSlots, check.pvSlots);
+        std::swap(pnBestTime, check.pnBestTime);
+        std::swap(pHits, check.pHits);
+    }
+};
+
+bool CStakeKernelSearch::operator()()
+{
+    for (size_t i = nBegin; i < nEnd; i++) {
+        const CStakeKernelCandidate& candidate = (*pvCandidates)[i];
+        if (candidate.amount <= 0)
+            continue;
+
+        // Everything up to the block timestamp is the same for every slot
+        CHashWriter ssPrefix(SER_GETHASH, 0);
+        ssPrefix << *pStakeModifier << candidate.nTime << candidate.prevout.hash << candidate.prevout.n;
+
+        for (uint32_t nTimeSlot : *pvSlots) {
+            // A candidate already hit an earlier slot, other hits at the same slot are still collected
+            if (nTimeSlot > pnBestTime->load(std::memory_order_relaxed) || nTimeSlot > pHits->nTime)
+                break;
+
+            CHashWriter ss(ssPrefix);
+            ss << nTimeSlot;
+
+            if ((UintToArith256(ss.GetHash()) / candidate.amount) <= *pbnTarget) {
+                if (nTimeSlot < pHits->nTime) {
+                    pHits->nTime = nTimeSlot;
+                    pHits->vCandidates.clear();
+                }
+                pHits->vCandidates.push_back(i);
+
+                uint32_t nBest = pnBestTime->load();
+                while (nTimeSlot < nBest && !pnBestTime->compare_exchange_weak(nBest, nTimeSlot)) {}
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+CCheckQueue<CStakeKernelSearch> stakekernelqueue(1);
+
+} // namespace
+
+void ThreadStakeKernelSearch()
+{
+    RenameThread("paladeum-stakesearch");
+    stakekernelqueue.Thread();
+}
+
+bool FindStakeKernel(const CBlockIndex* pindexPrev, unsigned int nBits, const std::vector<CStakeKernelCandidate>& vCandidates, uint32_t nTimeFrom, uint32_t nTimeTo, std::vector<size_t>& vKernelsRet, uint32_t& nTimeRet)
+{
+    vKernelsRet.clear();
+    if (!pindexPrev || vCandidates.empty())
+        return false;
+
+    // Stakers only produce timestamps at the granularity of the mask
+    std::vector<uint32_t> vSlots;
+    for (uint64_t nTimeSlot = nTimeFrom; nTimeSlot <= nTimeTo; nTimeSlot += STAKE_TIMESTAMP_MASK + 1)
+        vSlots.push_back(nTimeSlot);
+
+    if (vSlots.empty())
+        return false;
+
+    arith_uint256 bnTarget;
+    bnTarget.SetCompact(nBits);
+
+    // Split the candidates into contiguous ranges, the workers of the queue and this thread take them one at a time
+    size_t nRanges = (vCandidates.size() + STAKE_KERNEL_CANDIDATES_PER_CHECK - 1) / STAKE_KERNEL_CANDIDATES_PER_CHECK;
+    std::atomic<uint32_t> nBestTime(std::numeric_limits<uint32_t>::max());
+    std::vector<StakeKernelHits> vHits(nRanges);
+    std::vector<CStakeKernelSearch> vChecks;
+    vChecks.reserve(nRanges);
+    for (size_t n = 0; n < nRanges; n++) {
+        size_t nBegin = n * STAKE_KERNEL_CANDIDATES_PER_CHECK;
+        size_t nEnd = std::min(vCandidates.size(), nBegin + STAKE_KERNEL_CANDIDATES_PER_CHECK);
+        vChecks.emplace_back(pindexPrev->nStakeModifier, bnTarget, vCandidates, nBegin, nEnd, vSlots, nBestTime, vHits[n]);
+    }
+
+    {
+        CCheckQueueControl<CStakeKernelSearch> control(&stakekernelqueue);
+        control.Add(vChecks);
+        control.Wait();
+    }
+
+    uint32_t nTime = nBestTime.load();
+    if (nTime == std::numeric_limits<uint32_t>::max())
+        return false;
+
+    // The ranges are in candidate order, so the hits end up sorted
+    for (const StakeKernelHits& hits : vHits) {
+        if (hits.nTime == nTime)
+            vKernelsRet.insert(vKernelsRet.end(), hits.vCandidates.begin(), hits.vCandidates.end());
+    }
+
+    nTimeRet = nTime;
+    return true;
+}
+
 // Check whether the coinstake timestamp meets protocol
 bool CheckCoinStakeTimestamp(int64_t nTimeBlock, int64_t nTimeTx)
 {
@@ -28,6 +28,18 @@ struct CStakeCache{
     CAmount amount;
 };
 
+// Output that can be tried as a stake kernel, nTime is the time of the transaction that created it
+struct CStakeKernelCandidate{
+    CStakeKernelCandidate(const COutPoint& prevout_, CAmount amount_, uint32_t nTime_) : prevout(prevout_), amount(amount_), nTime(nTime_){
+    }
+    COutPoint prevout;
+    CAmount amount;
+    uint32_t nTime;
+};
+
+// Number of candidates hashed by one stake kernel search check, the workers take the checks one at a time
+static const size_t STAKE_KERNEL_CANDIDATES_PER_CHECK = 256;
+
 // Compute the hash modifier for proof-of-stake
 uint256 ComputeStakeModifier(const CBlockIndex* pindexPrev, const uint256& kernel);
 bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, unsigned int nBits, CAmount nValueIn, const COutPoint& prevout, unsigned int nTimeTx, unsigned int nTimeTxPoS);
@@ -35,5 +47,13 @@ bool CheckCoinStakeTimestamp(int64_t nTimeBlock, int64_t nTimeTx);
 bool CheckStakeBlockTimestamp(int64_t nTimeBlock);
 bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t nTimeBlock, const COutPoint& prevout, CCoinsViewCache& view);
 bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t nTimeBlock, const COutPoint& prevout, CCoinsViewCache& view, const std::map<COutPoint, CStakeCache>& cache);
+// Find the earliest of the timestamps nTimeFrom, nTimeFrom + STAKE_TIMESTAMP_MASK + 1, ... up to nTimeTo at
+// which one of the candidates meets the kernel protocol on top of pindexPrev. Returns the indexes of all the
+// candidates that hit that timestamp in ascending order, and the timestamp. The candidates are split over the
+// stake kernel search workers and the calling thread. Candidates must already be mature and unspent, this only
+// checks the hash target.
+bool FindStakeKernel(const CBlockIndex* pindexPrev, unsigned int nBits, const std::vector<CStakeKernelCandidate>& vCandidates, uint32_t nTimeFrom, uint32_t nTimeTo, std::vector<size_t>& vKernelsRet, uint32_t& nTimeRet);
+// Worker thread of the stake kernel search, runs until interrupted
+void ThreadStakeKernelSearch();
 bool CheckProofOfStake(CBlockIndex* pindexPrev, CValidationState& state, const CTransaction& tx, unsigned int nBits, uint32_t nTimeBlock, uint256& hashProofOfStake, uint256& targetProofOfStake, CCoinsViewCache& view);
 #endif // AOKCHAIN_POS_H
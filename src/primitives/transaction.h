@@ -15,6 +15,7 @@
 #include "uint256.h"
 
 #include <iostream>
+#include <memory>
 
 static const int SERIALIZE_TRANSACTION_NO_WITNESS = 0x40000000;
 static const int32_t MESSAGE_VERSION = 2;
@@ -297,6 +298,7 @@ inline void SerializeTransaction(const TxType& tx, Stream& s) {
     }
 }
 
+struct CTokenOutputEntry;
 
 /** The basic transaction that is broadcasted on the network and contained in
  * blocks.  A transaction can contain multiple inputs and outputs.
@@ -329,6 +331,9 @@ private:
     /** Memory only. */
     const uint256 hash;
 
+    /** Memory only. The token data of the token outputs in vout order, decoded on first use by GetTokenOutput */
+    mutable std::shared_ptr<const std::vector<CTokenOutputEntry> > tokenOutputs;
+
     uint256 ComputeHash() const;
 
 public:
@@ -386,6 +391,15 @@ public:
     bool GetVerifierStringFromTx(CNullTokenTxVerifierString& verifier, std::string& strError) const;
     bool GetVerifierStringFromTx(CNullTokenTxVerifierString& verifier, std::string& strError, bool& fNotFound) const;
 
+    /**
+     * The token data of output n, or nullptr if it isn't a token output. The first call decodes the scripts of all
+     * the outputs, so the validation, coins, mempool and wallet code share one decode per output of a transaction.
+     */
+    const CTokenOutputEntry* GetTokenOutput(unsigned int n) const;
+
+    /** Memory used by the token outputs GetTokenOutput decoded, counted with the dynamic usage of the transaction */
+    size_t GetTokenOutputsDynamicUsage() const;
+
     /** TOKENS END */
 
     /**
@@ -42,6 +42,7 @@ const char *GETBLOCKTXN="getblocktxn";
 const char *BLOCKTXN="blocktxn";
 const char *GETTOKENDATA="gettokendata";
 const char *TOKENDATA="tokendata";
+const char *TOKENDATAS="tokendatas";
 const char *TOKENNOTFOUND ="asstnotfound";
 } // namespace NetMsgType
 
@@ -77,6 +78,7 @@ const static std::string allNetMessageTypes[] = {
     NetMsgType::BLOCKTXN,
     NetMsgType::GETTOKENDATA,
     NetMsgType::TOKENDATA,
+    NetMsgType::TOKENDATAS,
     NetMsgType::TOKENNOTFOUND
 };
 const static std::vector<std::string> allNetMessageTypesVec(allNetMessageTypes, allNetMessageTypes+ARRAYLEN(allNetMessageTypes));
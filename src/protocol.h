@@ -256,6 +256,13 @@ extern const char *GETTOKENDATA;
  */
 extern const char *TOKENDATA;
 
+/**
+ * Contains the TokenData of many tokens
+ * Sent in response to a "gettokendata" message, the names that weren't found are sent in an "asstnotfound" message.
+ * @since protocol version 70029
+ */
+extern const char *TOKENDATAS;
+
 /**
  * The asstnotfound message is a reply to a gettokendata message which requested an
  * object the receiving node does not have available for relay.
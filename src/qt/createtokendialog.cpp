@@ -582,7 +582,7 @@ void CreateTokenDialog::CheckFormState()
             std::string strError;
             ErrorReport errorReport;
             errorReport.type = ErrorReport::ErrorType::NotSetError;
-            if (!ContextualCheckVerifierString(ptokens, strippedVerifier, strAddress, strError, &errorReport)) {
+            if (!ContextualCheckVerifierString(ptokens, strippedVerifier, CTokenAddress::FromString(strAddress), strError, &errorReport)) {
                 ui->lineEditVerifierString->setStyleSheet(STYLE_INVALID);
                 showInvalidVerifierStringMessage(QString::fromStdString(GetUserErrorString(errorReport)));
                 return;
@@ -553,7 +553,7 @@ void ReissueTokenDialog::CheckFormState()
             std::string strError;
             ErrorReport errorReport;
             errorReport.type = ErrorReport::ErrorType::NotSetError;
-            if (!ContextualCheckVerifierString(ptokens, strippedVerifier, strAddress, strError, &errorReport)) {
+            if (!ContextualCheckVerifierString(ptokens, strippedVerifier, CTokenAddress::FromString(strAddress), strError, &errorReport)) {
                 ui->lineEditVerifierString->setStyleSheet(STYLE_INVALID);
                 qDebug() << "Failing here 1";
                 showInvalidVerifierStringMessage(QString::fromStdString(GetUserErrorString(errorReport)));
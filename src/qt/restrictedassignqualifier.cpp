@@ -202,7 +202,7 @@ void AssignQualifier::check()
 
     if (ptokens) {
         // returns true if the address has the qualifier
-        if (ptokens->CheckForAddressQualifier(qualifier.toStdString(), address.toStdString(), true)) {
+        if (ptokens->CheckForAddressQualifier(qualifier.toStdString(), CTokenAddress::FromString(address.toStdString()), true)) {
             if (removing) {
                 enableSubmitButton();
             } else {
@@ -214,7 +214,7 @@ void FreezeAddress::check()
 
     if (ptokens) {
         if (isSingleAddress) {
-            bool fCurrentlyAddressRestricted = ptokens->CheckForAddressRestriction(restricted_token.toStdString(), address.toStdString(), true);
+            bool fCurrentlyAddressRestricted = ptokens->CheckForAddressRestriction(restricted_token.toStdString(), CTokenAddress::FromString(address.toStdString()), true);
 
             if (freeze_address && fCurrentlyAddressRestricted) {
                 showWarning(tr("Address is already frozen"));
@@ -217,7 +217,7 @@ SendCoinsRecipient SendCoinsEntry::getValue()
     if (IsUsernameValid(ui->payTo->text().toStdString()))
     {
         recipient.username = ui->payTo->text();
-        recipient.address = QString::fromStdString(ptokensdb->UsernameAddress(ui->payTo->text().toStdString()));
+        recipient.address = QString::fromStdString(ptokensdb->UsernameAddress(ui->payTo->text().toStdString()).ToString());
     } else {
         recipient.address = ui->payTo->text();
     }
@@ -300,7 +300,7 @@ bool SendTokensEntry::validate()
             if (ptokens->GetTokenVerifierStringIfExists(tokenName, verifier)) {
                 std::string strError = "";
                 ErrorReport report;
-                if (!ContextualCheckVerifierString(ptokens, verifier.verifier_string,ui->payTo->text().toStdString(), strError, &report)) {
+                if (!ContextualCheckVerifierString(ptokens, verifier.verifier_string, CTokenAddress::FromString(ui->payTo->text().toStdString()), strError, &report)) {
                     ui->payTo->setValid(false);
                     ui->messageTextLabel->show();
                     ui->messageTextLabel->setText(QString::fromStdString(GetUserErrorString(report)));
@@ -329,7 +329,7 @@ SendTokensRecipient SendTokensEntry::getValue()
     if (IsUsernameValid(ui->payTo->text().toStdString()))
     {
         recipient.username = ui->payTo->text();
-        recipient.address = QString::fromStdString(ptokensdb->UsernameAddress(ui->payTo->text().toStdString()));
+        recipient.address = QString::fromStdString(ptokensdb->UsernameAddress(ui->payTo->text().toStdString()).ToString());
     } else {
         recipient.address = ui->payTo->text();
     }
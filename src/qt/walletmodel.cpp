@@ -285,7 +285,7 @@ WalletModel::SendCoinsReturn WalletModel::prepareTransaction(WalletModelTransact
         {   // User-entered paladeum address / amount:
             if(!validateAddress(rcp.address))
             {
-                if (ptokensdb->UsernameAddress(rcp.username.toStdString()) == "") {
+                if (ptokensdb->UsernameAddress(rcp.username.toStdString()).IsNull()) {
                     return InvalidUsername;
                 }
 
@@ -30,6 +30,7 @@
 #include "util.h"
 #include "utilstrencodings.h"
 #include "hash.h"
+#include "indexes.h"
 #include "warnings.h"
 #include <pos.h>
 
@@ -118,6 +119,12 @@ double GetPoSKernelPS()
     return result;
 }
 
+void EnsureIndexesSynced()
+{
+    if (pindexessync && !pindexessync->BlockUntilSyncedToCurrentChain())
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("The address, spent and timestamp indexes are still being built (at block %d)", pindexessync->GetBestHeight()));
+}
+
 UniValue blockheaderToJSON(const CBlockIndex* blockindex)
 {
     UniValue result(UniValue::VOBJ);
@@ -771,6 +778,10 @@ UniValue getblockdeltas(const JSONRPCRequest& request)
     std::string strHash = request.params[0].get_str();
     uint256 hash(uint256S(strHash));
 
+    // The input deltas are filled in from the spent index
+    if (fSpentIndex)
+        EnsureIndexesSynced();
+
     if (mapBlockIndex.count(hash) == 0)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
 
@@ -834,6 +845,8 @@ UniValue GetIndexHashes(const JSONRPCRequest& request)
         }
     }
 
+    EnsureIndexesSynced();
+
     std::vector<std::pair<uint256, unsigned int> > blockHashes;
 
     if (fActiveOnly)
@@ -1867,7 +1880,7 @@ UniValue freezelist(const JSONRPCRequest& request) {
 
     std::vector< std::pair< CScript, bool > > frozenVector;
 
-    governance->DumpFreezeStats(&frozenVector);
+    pgovernanceTip->DumpFreezeStats(&frozenVector);
     UniValue addresses(UniValue::VOBJ);
 
     for (unsigned int i = 0; i < frozenVector.size() ; i++) {
@@ -1880,7 +1893,7 @@ UniValue freezelist(const JSONRPCRequest& request) {
     }
 
     result.push_back(Pair("addresses", addresses));
-    result.push_back(Pair("total", (uint64_t)governance->GetNumberOfFrozenScripts()));
+    result.push_back(Pair("total", (uint64_t)pgovernanceTip->GetNumberOfFrozenScripts()));
 
     return result;
 }
@@ -1900,7 +1913,7 @@ UniValue checkfreeze(const JSONRPCRequest& request) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    return !governance->CanSend(GetScriptForDestination(dest));
+    return !pgovernanceTip->CanSend(GetScriptForDestination(dest));
 }
 
 UniValue issuanceinfo(const JSONRPCRequest& request) {
@@ -1914,21 +1927,21 @@ UniValue issuanceinfo(const JSONRPCRequest& request) {
     UniValue result(UniValue::VOBJ);
     UniValue cost(UniValue::VOBJ);
 
-    cost.push_back(Pair("root", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_ROOT))));
-    cost.push_back(Pair("reissue", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_REISSUE))));
-    cost.push_back(Pair("unique", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_UNIQUE))));
-    cost.push_back(Pair("sub", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_SUB))));
-    cost.push_back(Pair("username", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_USERNAME))));
-    cost.push_back(Pair("msg_channel", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_MSG_CHANNEL))));
-    cost.push_back(Pair("qualifier", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_QUALIFIER))));
-    cost.push_back(Pair("sub_qualifier", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_SUB_QUALIFIER))));
-    cost.push_back(Pair("null_qualifier", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_NULL_QUALIFIER))));
-    cost.push_back(Pair("restricted", ValueFromAmount(governance->GetCost(GOVERNANCE_COST_RESTRICTED))));
+    cost.push_back(Pair("root", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_ROOT))));
+    cost.push_back(Pair("reissue", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_REISSUE))));
+    cost.push_back(Pair("unique", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_UNIQUE))));
+    cost.push_back(Pair("sub", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_SUB))));
+    cost.push_back(Pair("username", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_USERNAME))));
+    cost.push_back(Pair("msg_channel", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_MSG_CHANNEL))));
+    cost.push_back(Pair("qualifier", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_QUALIFIER))));
+    cost.push_back(Pair("sub_qualifier", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_SUB_QUALIFIER))));
+    cost.push_back(Pair("null_qualifier", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_NULL_QUALIFIER))));
+    cost.push_back(Pair("restricted", ValueFromAmount(pgovernanceTip->GetCost(GOVERNANCE_COST_RESTRICTED))));
     
     result.push_back(Pair("cost", cost));
 
     CTxDestination dest;
-    if (ExtractDestination(governance->GetFeeScript(), dest)) {
+    if (ExtractDestination(pgovernanceTip->GetFeeScript(), dest)) {
         result.push_back(Pair("address", EncodeDestination(dest)));
     }
 
@@ -32,6 +32,9 @@ UniValue mempoolInfoToJSON();
 /** Mempool to JSON */
 UniValue mempoolToJSON(bool fVerbose = false);
 
+/** Waits for the indexes to include the chain tip, throws while they catch up. Must not be called with cs_main held */
+void EnsureIndexesSynced();
+
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex* blockindex);
 
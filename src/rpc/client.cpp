@@ -185,6 +185,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "GetIndexHashes", 1, "low"},
     { "GetIndexHashes", 2, "options" },
     { "getspentinfo", 0, "txid_index"},
+    { "getaddressdeltas", 0, "address"},
+    { "getaddressutxos", 0, "address"},
+    { "getaddresstxids", 0, "address"},
     { "getaddresstxids", 1, "includeTokens"},
     { "getaddressbalance", 1, "includeTokens"},
     { "getaddressmempool", 1, "includeTokens"},
@@ -225,11 +228,22 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "stop", 0, "wait"},
 };
 
+/**
+ * The converted params that also take a plain string, like the address of the address index calls which is either
+ * one address or an object of addresses. They are passed as the string when they aren't valid JSON.
+ */
+static const std::set<std::pair<std::string, std::string>> setRPCConvertOrString = {
+    { "getaddressdeltas", "address" },
+    { "getaddressutxos", "address" },
+    { "getaddresstxids", "address" },
+};
+
 class CRPCConvertTable
 {
 private:
     std::set<std::pair<std::string, int>> members;
     std::set<std::pair<std::string, std::string>> membersByName;
+    std::set<std::pair<std::string, int>> membersOrString;
 
 public:
     CRPCConvertTable();
@@ -240,6 +254,12 @@ public:
     bool convert(const std::string& method, const std::string& name) {
         return (membersByName.count(std::make_pair(method, name)) > 0);
     }
+    bool orString(const std::string& method, int idx) {
+        return (membersOrString.count(std::make_pair(method, idx)) > 0);
+    }
+    bool orString(const std::string& method, const std::string& name) {
+        return (setRPCConvertOrString.count(std::make_pair(method, name)) > 0);
+    }
 };
 
 CRPCConvertTable::CRPCConvertTable()
@@ -252,6 +272,9 @@ CRPCConvertTable::CRPCConvertTable()
                                       vRPCConvertParams[i].paramIdx));
         membersByName.insert(std::make_pair(vRPCConvertParams[i].methodName,
                                             vRPCConvertParams[i].paramName));
+        if (setRPCConvertOrString.count(std::make_pair(vRPCConvertParams[i].methodName, vRPCConvertParams[i].paramName)))
+            membersOrString.insert(std::make_pair(vRPCConvertParams[i].methodName,
+                                                  vRPCConvertParams[i].paramIdx));
     }
 }
 
@@ -269,6 +292,18 @@ UniValue ParseNonRFCJSONValue(const std::string& strVal)
     return jVal[0];
 }
 
+/** Parses a converted param, falling back to the string itself for the params that also take a plain string */
+static UniValue ParseConvertedValue(const std::string& strVal, bool fOrString)
+{
+    try {
+        return ParseNonRFCJSONValue(strVal);
+    } catch (const std::runtime_error&) {
+        if (!fOrString)
+            throw;
+        return UniValue(strVal);
+    }
+}
+
 UniValue RPCConvertValues(const std::string &strMethod, const std::vector<std::string> &strParams)
 {
     UniValue params(UniValue::VARR);
@@ -281,7 +316,7 @@ UniValue RPCConvertValues(const std::string &strMethod, const std::vector<std::s
             params.push_back(strVal);
         } else {
             // parse string as JSON, insert bool/number/object/etc. value
-            params.push_back(ParseNonRFCJSONValue(strVal));
+            params.push_back(ParseConvertedValue(strVal, rpcCvtTable.orString(strMethod, idx)));
         }
     }
 
@@ -306,7 +341,7 @@ UniValue RPCConvertNamedValues(const std::string &strMethod, const std::vector<s
             params.pushKV(name, value);
         } else {
             // parse string as JSON, insert bool/number/object/etc. value
-            params.pushKV(name, ParseNonRFCJSONValue(value));
+            params.pushKV(name, ParseConvertedValue(value, rpcCvtTable.orString(strMethod, name)));
         }
     }
 
@@ -141,15 +141,15 @@ UniValue viewallmessagechannels(const JSONRPCRequest& request) {
         return ret;
     }
 
-    if (!pMessageSubscribedChannelsCache || !pmessagechanneldb) {
+    if (!pmessagechanneldb) {
         UniValue ret(UniValue::VSTR);
         ret.push_back("Messaging channel database and cache are having problems (a wallet restart might fix this issue)");
         return ret;
     }
 
-    std::set<std::string> setChannels;
+    LOCK(cs_messaging);
 
-    pmessagechanneldb->LoadMyMessageChannels(setChannels);
+    std::set<std::string> setChannels(setSubscribedChannels.begin(), setSubscribedChannels.end());
 
     LogPrintf("%s: Checking caches removeSize:%u, addSize:%u\n", __func__, setDirtyChannelsRemove.size(), setDirtyChannelsAdd.size());
 
@@ -191,7 +191,7 @@ UniValue subscribetochannel(const JSONRPCRequest& request) {
         throw JSONRPCError(RPC_DATABASE_ERROR, "Messaging is disabled. To enable messaging, run the wallet without -disablemessaging or remove disablemessaging from your paladeum.conf");
     }
 
-    if (!pMessageSubscribedChannelsCache || !pmessagechanneldb) {
+    if (!pmessagechanneldb) {
         throw JSONRPCError(RPC_DATABASE_ERROR, "Message database isn't setup");
     }
 
@@ -214,7 +214,10 @@ UniValue subscribetochannel(const JSONRPCRequest& request) {
         throw JSONRPCError(
                 RPC_INVALID_PARAMETER, "Channel Name must be a owner token, or a message channel token e.g OWNER!, MSG_CHANNEL~123.");
 
-    AddChannel(channel_name);
+    {
+        LOCK(cs_messaging);
+        AddChannel(channel_name);
+    }
 
     return "Subscribed to channel: " + channel_name;
 }
@@ -241,7 +244,7 @@ UniValue unsubscribefromchannel(const JSONRPCRequest& request) {
         throw JSONRPCError(RPC_DATABASE_ERROR, "Messaging is disabled. To enable messaging, run the wallet without -disablemessaging or remove disablemessaging from your paladeum.conf");
     }
 
-    if (!pMessageSubscribedChannelsCache || !pmessagechanneldb) {
+    if (!pmessagechanneldb) {
         throw JSONRPCError(RPC_DATABASE_ERROR, "Message database isn't setup");
     }
 
@@ -265,7 +268,10 @@ UniValue unsubscribefromchannel(const JSONRPCRequest& request) {
         throw JSONRPCError(
                 RPC_INVALID_PARAMETER, "Channel Name must be a owner token, or a message channel token e.g OWNER!, MSG_CHANNEL~123.");
 
-    RemoveChannel(channel_name);
+    {
+        LOCK(cs_messaging);
+        RemoveChannel(channel_name);
+    }
 
     return "Unsubscribed from channel: " + channel_name;
 }
@@ -700,26 +700,42 @@ bool getAddressFromIndex(const int &type, const uint160 &hash, std::string &addr
     return true;
 }
 
+// Resolves a username or address to the key it is indexed under
+static std::pair<uint160, int> GetAddressIndexKey(std::string address)
+{
+    if (IsUsernameValid(address)) {
+        address = ptokensdb->UsernameAddress(address).ToString();
+        if (address == "") {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
+        }
+    }
+
+    CPaladeumAddress dest(address);
+    uint160 hashBytes;
+    int type = 0;
+    if (!dest.GetIndexKey(hashBytes, type)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+
+    return std::make_pair(hashBytes, type);
+}
+
 bool getAddressesFromParams(const UniValue& params, std::vector<std::pair<uint160, int> > &addresses)
 {
     if (params[0].isStr()) {
-        std::string address = params[0].get_str();
-
-        if (IsUsernameValid(address)) {
-            address = ptokensdb->UsernameAddress(address);
-            if (address == "") {
-                throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
-            }
+        addresses.push_back(GetAddressIndexKey(params[0].get_str()));
+    } else if (params[0].isObject()) {
+        UniValue addressValues = find_value(params[0].get_obj(), "addresses");
+        if (!addressValues.isArray()) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Addresses is expected to be an array");
         }
 
-        CPaladeumAddress dest(address);
-        uint160 hashBytes;
-        int type = 0;
-        if (!dest.GetIndexKey(hashBytes, type)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+        for (const UniValue& value : addressValues.getValues()) {
+            if (!value.isStr()) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+            }
+            addresses.push_back(GetAddressIndexKey(value.get_str()));
         }
-
-        addresses.push_back(std::make_pair(hashBytes, type));
     } else {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
@@ -737,6 +753,64 @@ bool timestampSort(std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> a,
     return a.second.time < b.second.time;
 }
 
+/**
+ * Paging of the address index RPCs. A page holds at most "limit" entries of the address object, and "cursor" is
+ * set when there are more. Passing it back continues after the last entry of the page, it holds the position of
+ * that entry's address in the request and its index key. getaddresstxids only uses the block position in the key.
+ */
+static int GetPageLimit(const UniValue& param)
+{
+    if (!param.isObject())
+        return 0;
+
+    UniValue limitValue = find_value(param.get_obj(), "limit");
+    if (limitValue.isNull())
+        return 0;
+
+    int nLimit = limitValue.get_int();
+    if (nLimit <= 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Limit is expected to be greater than zero");
+    }
+    return nLimit;
+}
+
+template <typename Key>
+static bool ReadPageCursor(const UniValue& param, unsigned int& nAddress, Key& key)
+{
+    UniValue cursorValue = find_value(param.get_obj(), "cursor");
+    if (cursorValue.isNull())
+        return false;
+
+    if (!cursorValue.isStr() || !IsHex(cursorValue.get_str())) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+
+    CDataStream ssCursor(ParseHex(cursorValue.get_str()), SER_DISK, CLIENT_VERSION);
+    try {
+        ssCursor >> nAddress >> key;
+    } catch (const std::exception&) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+    return true;
+}
+
+template <typename Key>
+static std::string WritePageCursor(unsigned int nAddress, const Key& key)
+{
+    CDataStream ssCursor(SER_DISK, CLIENT_VERSION);
+    ssCursor << nAddress << key;
+    return HexStr(ssCursor.begin(), ssCursor.end());
+}
+
+static UniValue PageToJSON(const std::string& name, const UniValue& entries, const std::string& cursor)
+{
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair(name, entries));
+    if (!cursor.empty())
+        result.push_back(Pair("cursor", cursor));
+    return result;
+}
+
 UniValue getaddressmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 2)
@@ -828,6 +902,39 @@ UniValue getaddressmempool(const JSONRPCRequest& request)
     return result;
 }
 
+// Unspent output of the address index as returned by getaddressutxos, false if it is still time locked
+static bool AddressUtxoToJSON(const CAddressUnspentKey& key, const CAddressUnspentValue& value, bool fDecodeToken, int nHeight, int64_t nMedianTimePast, UniValue& output)
+{
+    std::string address;
+    if (!getAddressFromIndex(key.type, key.hashBytes, address)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+    }
+
+    std::string tokenNameOut = PLB;
+    uint32_t nTimeLock = 0;
+    if (fDecodeToken) {
+        CAmount _amount;
+        if (!GetTokenInfoFromScript(value.script, tokenNameOut, _amount, nTimeLock)) {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Couldn't decode token script");
+        }
+    }
+
+    int64_t timeLock = fDecodeToken ? nTimeLock : key.timeLock;
+    if (timeLock >= (timeLock < LOCKTIME_THRESHOLD ? nHeight : nMedianTimePast))
+        return false;
+
+    output = UniValue(UniValue::VOBJ);
+    output.pushKV("address", address);
+    output.pushKV("token_name", tokenNameOut);
+    output.pushKV("txid", key.txhash.GetHex());
+    output.pushKV("outputIndex", (int)key.index);
+    output.pushKV("script", HexStr(value.script.begin(), value.script.end()));
+    output.pushKV("satoshis", value.satoshis);
+    output.pushKV("height", value.blockHeight);
+    output.pushKV("timelock", timeLock);
+    return true;
+}
+
 UniValue getaddressutxos(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 1 || request.params.size() > 3)
@@ -835,8 +942,18 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
             "getaddressutxos\n"
             "\nReturns all unspent outputs for an address (requires addressindex to be enabled).\n"
             "\nArguments:\n"
-            "\"address\"         (string, required) The paladeum address.\n"
-            "\"token\"           (string, optional) The name of token.\n"
+            "\"address\"         (string, required) The paladeum address, or an object:\n"
+            "{\n"
+            "  \"addresses\"\n"
+            "    [\n"
+            "      \"address\"  (string) The base58check encoded address\n"
+            "      ,...\n"
+            "    ]\n"
+            "  \"limit\"    (number, optional) Return at most this many outputs, in index order, and a cursor to the next ones\n"
+            "  \"cursor\"   (string, optional) The cursor of the previous page, to continue after it\n"
+            "}\n"
+            "\"amount\"          (numeric, optional) Stop once the outputs add up to this amount.\n"
+            "\"token\"           (string, optional) The name of token, * for every token.\n"
             "\nResult\n"
             "[\n"
             "  {\n"
@@ -849,9 +966,15 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
             "    \"satoshis\"  (number) The number of satoshis of the output\n"
             "  }\n"
             "]\n"
+            "\nResult with a limit:\n"
+            "{\n"
+            "  \"utxos\"  (array) The outputs as above\n"
+            "  \"cursor\"  (string) Set when there are more outputs, pass it back to get them\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressutxos", "\"1D1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\" \"TOKEN\"")
             + HelpExampleRpc("getaddressutxos", "\"1D1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\", \"TOKEN\"")
+            + HelpExampleCli("getaddressutxos", "'{\"addresses\": [\"1D1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"limit\": 1000}'")
             );
 
     CAmount requiredAmount = 0;
@@ -875,6 +998,57 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
+    int nLimit = GetPageLimit(request.params[0]);
+
+    EnsureIndexesSynced();
+
+    int nHeight;
+    int64_t nMedianTimePast;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+        nMedianTimePast = chainActive.Tip()->GetMedianTimePast();
+    }
+
+    UniValue utxos(UniValue::VARR);
+    CAmount total = 0;
+
+    if (nLimit > 0) {
+        // Pages are read in index order straight from the database, the outputs aren't sorted by height
+        unsigned int nAddress = 0;
+        CAddressUnspentKey after;
+        bool fResume = ReadPageCursor(request.params[0], nAddress, after);
+        std::string cursor;
+
+        for (unsigned int nAfterAddress = nAddress; nAddress < addresses.size() && cursor.empty(); nAddress++, fResume = false) {
+            auto fn = [&](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+                if (requiredAmount > 0 && total >= requiredAmount)
+                    return false;
+                if ((int)utxos.size() == nLimit) {
+                    cursor = WritePageCursor(nAfterAddress, after);
+                    return false;
+                }
+
+                UniValue output;
+                if (AddressUtxoToJSON(key, value, tokenName != PLB, nHeight, nMedianTimePast, output)) {
+                    utxos.push_back(output);
+                    total += value.satoshis;
+                }
+                after = key;
+                nAfterAddress = nAddress;
+                return true;
+            };
+
+            bool fRead = tokenName == "*" ? GetAddressUnspent(addresses[nAddress].first, addresses[nAddress].second, "", true, fResume ? &after : nullptr, fn)
+                                          : GetAddressUnspent(addresses[nAddress].first, addresses[nAddress].second, tokenName, false, fResume ? &after : nullptr, fn);
+            if (!fRead) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
+        }
+
+        return PageToJSON("utxos", utxos, cursor);
+    }
+
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentOutputs;
 
     for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
@@ -891,43 +1065,14 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
 
     std::sort(unspentOutputs.begin(), unspentOutputs.end(), heightSort);
 
-    UniValue utxos(UniValue::VARR);
-    CAmount total = 0;
-
-    int nHeight = chainActive.Height();
-
     for (std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >::const_iterator it=unspentOutputs.begin(); it!=unspentOutputs.end(); it++) {
         if (requiredAmount > 0 && total >= requiredAmount) {
             break;
         }
 
-        UniValue output(UniValue::VOBJ);
-        std::string address;
-        uint32_t nTimeLock = 0;
-        if (!getAddressFromIndex(it->first.type, it->first.hashBytes, address)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
-        }
-
-        std::string tokenNameOut = PLB;
-        if (tokenName != PLB) {
-            CAmount _amount;
-            if (!GetTokenInfoFromScript(it->second.script, tokenNameOut, _amount, nTimeLock)) {
-                throw JSONRPCError(RPC_INTERNAL_ERROR, "Couldn't decode token script");
-            }
-        }
-
-        int64_t timeLock = (tokenName == PLB) ? it->first.timeLock : nTimeLock;
-        if (timeLock < ((int64_t)timeLock < LOCKTIME_THRESHOLD ? nHeight : (int64_t)chainActive.Tip()->GetMedianTimePast())) {
-            output.pushKV("address", address);
-            output.pushKV("token_name", tokenNameOut);
-            output.pushKV("txid", it->first.txhash.GetHex());
-            output.pushKV("outputIndex", (int)it->first.index);
-            output.pushKV("script", HexStr(it->second.script.begin(), it->second.script.end()));
-            output.pushKV("satoshis", it->second.satoshis);
-            output.pushKV("height", it->second.blockHeight);
-            output.pushKV("timelock", timeLock);
+        UniValue output;
+        if (AddressUtxoToJSON(it->first, it->second, tokenName != PLB, nHeight, nMedianTimePast, output)) {
             utxos.push_back(output);
-
             total += it->second.satoshis;
         }
     }
@@ -935,6 +1080,24 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
     return utxos;
 }
 
+static UniValue AddressDeltaToJSON(const CAddressIndexKey& key, const CAmount& nValue)
+{
+    std::string address;
+    if (!getAddressFromIndex(key.type, key.hashBytes, address)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+    }
+
+    UniValue delta(UniValue::VOBJ);
+    delta.push_back(Pair("tokenName", key.token));
+    delta.push_back(Pair("satoshis", nValue));
+    delta.push_back(Pair("txid", key.txhash.GetHex()));
+    delta.push_back(Pair("index", (int)key.index));
+    delta.push_back(Pair("blockindex", (int)key.txindex));
+    delta.push_back(Pair("height", key.blockHeight));
+    delta.push_back(Pair("address", address));
+    return delta;
+}
+
 UniValue getaddressdeltas(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1 || !request.params[0].isObject())
@@ -952,6 +1115,8 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
             "  \"end\" (number) The end block height\n"
             "  \"chainInfo\" (boolean) Include chain info in results, only applies if start and end specified\n"
             "  \"tokenName\"   (string, optional) Get deltas for a particular token instead of PLB.\n"
+            "  \"limit\"    (number, optional) Return at most this many deltas and a cursor to the next ones\n"
+            "  \"cursor\"   (string, optional) The cursor of the previous page, to continue after it\n"
             "}\n"
             "\nResult:\n"
             "[\n"
@@ -964,11 +1129,17 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
             "    \"address\"  (string) The base58check encoded address\n"
             "  }\n"
             "]\n"
+            "\nResult with a limit:\n"
+            "{\n"
+            "  \"deltas\"  (array) The deltas as above\n"
+            "  \"cursor\"  (string) Set when there are more deltas, pass it back to get them\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"]}'")
             + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"]}")
             + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"],\"tokenName\":\"MY_TOKEN\"}'")
             + HelpExampleRpc("getaddressdeltas", "{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"],\"tokenName\":\"MY_TOKEN\"}")
+            + HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"12c6DSiU4Rq3P4ZxziKxzrL5LmMBrzjrJX\"],\"limit\":1000}'")
         );
 
 
@@ -1009,37 +1180,45 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    int nLimit = GetPageLimit(request.params[0]);
 
-    for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, tokenName, addressIndex, start, end)) {
+    EnsureIndexesSynced();
+
+    UniValue deltas(UniValue::VARR);
+    std::string cursor;
+
+    if (nLimit > 0) {
+        unsigned int nAddress = 0;
+        CAddressIndexKey after;
+        bool fResume = ReadPageCursor(request.params[0], nAddress, after);
+
+        for (unsigned int nAfterAddress = nAddress; nAddress < addresses.size() && cursor.empty(); nAddress++, fResume = false) {
+            if (!GetAddressIndex(addresses[nAddress].first, addresses[nAddress].second, tokenName, start, end, fResume ? &after : nullptr,
+                    [&](const CAddressIndexKey& key, const CAmount& nValue) {
+                if ((int)deltas.size() == nLimit) {
+                    cursor = WritePageCursor(nAfterAddress, after);
+                    return false;
+                }
+                deltas.push_back(AddressDeltaToJSON(key, nValue));
+                after = key;
+                nAfterAddress = nAddress;
+                return true;
+            })) {
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
             }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, tokenName, addressIndex)) {
+        }
+    } else {
+        std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+
+        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            if (!GetAddressIndex((*it).first, (*it).second, tokenName, addressIndex, start, end)) {
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
             }
         }
-    }
-
-    UniValue deltas(UniValue::VARR);
 
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        std::string address;
-        if (!getAddressFromIndex(it->first.type, it->first.hashBytes, address)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+        for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
+            deltas.push_back(AddressDeltaToJSON(it->first, it->second));
         }
-
-        UniValue delta(UniValue::VOBJ);
-        delta.push_back(Pair("tokenName", it->first.token));
-        delta.push_back(Pair("satoshis", it->second));
-        delta.push_back(Pair("txid", it->first.txhash.GetHex()));
-        delta.push_back(Pair("index", (int)it->first.index));
-        delta.push_back(Pair("blockindex", (int)it->first.txindex));
-        delta.push_back(Pair("height", it->first.blockHeight));
-        delta.push_back(Pair("address", address));
-        deltas.push_back(delta);
     }
 
     UniValue result(UniValue::VOBJ);
@@ -1066,19 +1245,46 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         result.push_back(Pair("deltas", deltas));
         result.push_back(Pair("start", startInfo));
         result.push_back(Pair("end", endInfo));
+        if (!cursor.empty())
+            result.push_back(Pair("cursor", cursor));
 
         return result;
+    } else if (nLimit > 0) {
+        return PageToJSON("deltas", deltas, cursor);
     } else {
         return deltas;
     }
 }
 
+/** Adds up the address balance index entries of the addresses for tokenName, or for every token if it is empty */
+static void GetAddressBalances(const std::vector<std::pair<uint160, int> >& addresses, const std::string& tokenName,
+                               std::map<std::string, std::pair<CAmount, CAmount>>& balances, std::map<std::string, CAmount>& locked)
+{
+    int nHeight = chainActive.Height();
+    int64_t nMedianTimePast = chainActive.Tip()->GetMedianTimePast();
+
+    for (std::vector<std::pair<uint160, int> >::const_iterator it = addresses.begin(); it != addresses.end(); it++) {
+        std::vector<std::pair<CAddressIndexIteratorTokenKey, CAddressBalanceValue> > addressBalances;
+        if (!GetAddressBalance((*it).first, (*it).second, tokenName, addressBalances)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+
+        for (const auto& entry : addressBalances) {
+            CAmount nLocked = entry.second.GetLocked(nHeight, nMedianTimePast);
+            balances[entry.first.token].first += entry.second.received;
+            balances[entry.first.token].second += entry.second.balance - nLocked;
+            locked[entry.first.token] += nLocked;
+        }
+    }
+}
+
 UniValue getaddressbalance(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 2)
         throw std::runtime_error(
             "getaddressbalance\n"
             "\nReturns the balance for an address (requires addressindex to be enabled).\n"
+            "With addressbalanceindex enabled the balance is read from the index rather than added up from the address history.\n"
             "\nArguments:\n"
             "\"address\"         (string, required) The paladeum address.\n"
             "\"includeTokens\"   (boolean, optional) Include tokens.\n"
@@ -1107,6 +1313,8 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
+    EnsureIndexesSynced();
+
     bool includeTokens = false;
     if (request.params.size() > 1) {
         includeTokens = request.params[1].get_bool();
@@ -1116,18 +1324,22 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
         if (!AreTokensDeployed())
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Tokens aren't active.  includeTokens can't be true.");
 
+        //tokenName -> (received, balance)
+        std::map<std::string, std::pair<CAmount, CAmount>> balances;
+        std::map<std::string, CAmount> locked;
+
         std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
-        for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        if (fAddressBalanceIndex) {
+            GetAddressBalances(addresses, "", balances, locked);
+        } else {
+            for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+                if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
             }
         }
 
-        //tokenName -> (received, balance)
-        std::map<std::string, std::pair<CAmount, CAmount>> balances;
-        std::map<std::string, CAmount> locked;
-
         for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it = addressIndex.begin();
             it != addressIndex.end(); it++) {
                 std::string tokenName = it->first.token;
@@ -1169,6 +1381,19 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
         return result;
 
     } else {
+        if (fAddressBalanceIndex) {
+            std::map<std::string, std::pair<CAmount, CAmount>> balances;
+            std::map<std::string, CAmount> locked;
+            GetAddressBalances(addresses, PLB, balances, locked);
+
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("balance", balances[PLB].second);
+            result.pushKV("received", balances[PLB].first);
+            result.pushKV("locked", locked[PLB]);
+
+            return result;
+        }
+
         std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
         for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
@@ -1210,16 +1435,33 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
             "getaddresstxids\n"
             "\nReturns the txids for an address (requires addressindex to be enabled).\n"
             "\nArguments:\n"
-            "\"address\"       (string, required) The paladeum address.\n"
+            "\"address\"       (string, required) The paladeum address, or an object:\n"
+            "{\n"
+            "  \"addresses\"\n"
+            "    [\n"
+            "      \"address\"  (string) The base58check encoded address\n"
+            "      ,...\n"
+            "    ]\n"
+            "  \"start\"    (number, optional) The start block height\n"
+            "  \"end\"      (number, optional) The end block height\n"
+            "  \"limit\"    (number, optional) Return at most this many txids, listed once each in block order, and a cursor to the next ones\n"
+            "  \"cursor\"   (string, optional) The cursor of the previous page, to continue after it\n"
+            "}\n"
             "\"includeTokens\" (boolean, optional, default false)  If true this will return an expanded result which includes token transactions\n"
             "\nResult:\n"
             "[\n"
             "  \"transactionid\"  (string) The transaction id\n"
             "  ,...\n"
             "]\n"
+            "\nResult with a limit:\n"
+            "{\n"
+            "  \"txids\"  (array) The transaction ids as above\n"
+            "  \"cursor\"  (string) Set when there are more transactions, pass it back to get them\n"
+            "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getaddressbalance", "\"1D1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\" true")
             + HelpExampleRpc("getaddressbalance", "\"1D1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\", true")
+            + HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"1D1ZrZNe3JUo7ZycKEYQQiQAWd9y54F4XX\"], \"limit\": 1000}'")
         );
 
     std::vector<std::pair<uint160, int> > addresses;
@@ -1228,6 +1470,8 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
     }
 
+    EnsureIndexesSynced();
+
     int start = 0;
     int end = 0;
     if (request.params[0].isObject()) {
@@ -1248,6 +1492,69 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
         if (!AreTokensDeployed())
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Tokens aren't active.  includeTokens can't be true.");
 
+    int nLimit = GetPageLimit(request.params[0]);
+    if (nLimit > 0) {
+        // A transaction can be in the index under several tokens and addresses, so every address and token is read
+        // in block order from after the cursor's transaction and the reads are merged. The cursor only needs the
+        // block position of the last transaction of the page then
+        unsigned int nAddress = 0;
+        CAddressIndexKey after;
+        bool fResume = ReadPageCursor(request.params[0], nAddress, after);
+
+        std::map<std::pair<int, unsigned int>, uint256> mapTxids;
+        bool fMore = false;
+
+        for (const std::pair<uint160, int>& address : addresses) {
+            std::vector<std::string> tokens;
+            if (!includeTokens)
+                tokens.push_back(PLB);
+            else if (!GetAddressIndexTokens(address.first, address.second, tokens))
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+
+            for (const std::string& token : tokens) {
+                // Sorts before every entry of the transaction after the cursor's
+                CAddressIndexKey from(address.second, address.first, token, after.blockHeight, after.txindex + 1, uint256(), 0, false);
+                std::pair<int, unsigned int> last(-1, 0);
+                int nRead = 0;
+
+                if (!GetAddressIndex(address.first, address.second, token, start, end, fResume ? &from : nullptr,
+                        [&](const CAddressIndexKey& key, const CAmount& nValue) {
+                    std::pair<int, unsigned int> pos(key.blockHeight, key.txindex);
+                    if (pos == last)
+                        return true;
+                    // Only the first nLimit transactions of each read can make it into the page
+                    if (nRead == nLimit) {
+                        fMore = true;
+                        return false;
+                    }
+                    mapTxids.insert(std::make_pair(pos, key.txhash));
+                    last = pos;
+                    nRead++;
+                    return true;
+                })) {
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
+
+                while ((int)mapTxids.size() > nLimit) {
+                    mapTxids.erase(std::prev(mapTxids.end()));
+                    fMore = true;
+                }
+            }
+        }
+
+        UniValue txids(UniValue::VARR);
+        for (const auto& item : mapTxids)
+            txids.push_back(item.second.GetHex());
+
+        std::string cursor;
+        if (fMore) {
+            const auto& item = *mapTxids.rbegin();
+            cursor = WritePageCursor(0, CAddressIndexKey(0, uint160(), "", item.first.first, item.first.second, item.second, 0, false));
+        }
+
+        return PageToJSON("txids", txids, cursor);
+    }
+
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
 
     for (std::vector<std::pair<uint160, int> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
@@ -1333,6 +1640,8 @@ UniValue getspentinfo(const JSONRPCRequest& request)
     uint256 txid = ParseHashV(txidValue, "txid");
     int outputIndex = indexValue.get_int();
 
+    EnsureIndexesSynced();
+
     CSpentIndexKey key(txid, outputIndex);
     CSpentIndexValue value;
 
@@ -89,6 +89,16 @@ UniValue ping(const JSONRPCRequest& request)
 //}
 
 
+static UniValue TokenDataServeStatsToJSON(const CTokenDataServeStats& served)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("records", served.nRecords));
+    obj.push_back(Pair("notfound", served.nNotFound));
+    obj.push_back(Pair("bytes", served.nBytes));
+    obj.push_back(Pair("servetime", served.nServeTimeMicros / 1e6));
+    return obj;
+}
+
 UniValue getpeerinfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -133,6 +143,12 @@ UniValue getpeerinfo(const JSONRPCRequest& request)
             "    \"bytesrecv_per_msg\": {\n"
             "       \"addr\": n,              (numeric) The total bytes received aggregated by message type\n"
             "       ...\n"
+            "    },\n"
+            "    \"tokendata\": {            (json object) The token meta data served in answer to gettokendata\n"
+            "       \"records\": n,           (numeric) The token meta data records sent\n"
+            "       \"notfound\": n,          (numeric) The token names that weren't found\n"
+            "       \"bytes\": n,             (numeric) The bytes of the messages sent\n"
+            "       \"servetime\": n          (numeric) The time spent serving the requests in seconds\n"
             "    }\n"
             "  }\n"
             "  ,...\n"
@@ -207,6 +223,7 @@ UniValue getpeerinfo(const JSONRPCRequest& request)
                 recvPerMsgCmd.push_back(Pair(i.first, i.second));
         }
         obj.push_back(Pair("bytesrecv_per_msg", recvPerMsgCmd));
+        obj.push_back(Pair("tokendata", TokenDataServeStatsToJSON(stats.tokenDataServed)));
 
         ret.push_back(obj);
     }
@@ -383,6 +400,13 @@ UniValue getnettotals(const JSONRPCRequest& request)
             "  \"totalbytesrecv\": n,   (numeric) Total bytes received\n"
             "  \"totalbytessent\": n,   (numeric) Total bytes sent\n"
             "  \"timemillis\": t,       (numeric) Current UNIX time in milliseconds\n"
+            "  \"tokendata\":           (json object) The token meta data served to all peers, as in getpeerinfo\n"
+            "  {\n"
+            "    \"records\": n,\n"
+            "    \"notfound\": n,\n"
+            "    \"bytes\": n,\n"
+            "    \"servetime\": n\n"
+            "  },\n"
             "  \"uploadtarget\":\n"
             "  {\n"
             "    \"timeframe\": n,                         (numeric) Length of the measuring timeframe in seconds\n"
@@ -404,6 +428,7 @@ UniValue getnettotals(const JSONRPCRequest& request)
     obj.push_back(Pair("totalbytesrecv", g_connman->GetTotalBytesRecv()));
     obj.push_back(Pair("totalbytessent", g_connman->GetTotalBytesSent()));
     obj.push_back(Pair("timemillis", GetTimeMillis()));
+    obj.push_back(Pair("tokendata", TokenDataServeStatsToJSON(g_connman->GetTotalTokenDataServed())));
 
     UniValue outboundLimit(UniValue::VOBJ);
     outboundLimit.push_back(Pair("timeframe", g_connman->GetMaxOutboundTimeframe()));
@@ -16,6 +16,7 @@
 #include "net.h"
 #include "policy/policy.h"
 #include "policy/rbf.h"
+#include "rpc/blockchain.h"
 #include "primitives/transaction.h"
 #include "rpc/safemode.h"
 #include "rpc/server.h"
@@ -184,8 +185,6 @@ UniValue getrawtransaction(const JSONRPCRequest& request)
             + HelpExampleRpc("getrawtransaction", "\"mytxid\", true")
         );
 
-    LOCK(cs_main);
-
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
 
     // Accept either a bool (true) or a num (>=1) to indicate verbose output.
@@ -206,6 +205,12 @@ UniValue getrawtransaction(const JSONRPCRequest& request)
         }
     }
 
+    // The verbose inputs and outputs are filled in from the spent index
+    if (fVerbose && fSpentIndex)
+        EnsureIndexesSynced();
+
+    LOCK(cs_main);
+
     CTransactionRef tx;
 
     uint256 hashBlock;
@@ -1097,8 +1102,11 @@ UniValue createrawtransaction(const JSONRPCRequest& request)
                     std::string strippedVerifierString = GetStrippedVerifierString(verifier_string.get_str());
 
                     // Check the restricted token destination address, and make sure it validates with the verifier string
+                    CTokenAddress tokenAddress(destination);
+                    if (tokenAddress.IsNull())
+                        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Tokens can't be held by address: ") + name_);
                     std::string strError = "";
-                    if (!ContextualCheckVerifierString(currentActiveTokenCache, strippedVerifierString, EncodeDestination(destination), strError))
+                    if (!ContextualCheckVerifierString(currentActiveTokenCache, strippedVerifierString, tokenAddress, strError))
                         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Invalid parmeter, verifier string is not. Please check the syntax. Error Msg - " + strError));
 
                     bool hasRoyalties = false;
@@ -1224,9 +1232,12 @@ UniValue createrawtransaction(const JSONRPCRequest& request)
                         strippedVerifierString = GetStrippedVerifierString(verifier.get_str());
 
                         // Check the restricted token destination address, and make sure it validates with the verifier string
+                        CTokenAddress tokenAddress(destination);
+                        if (tokenAddress.IsNull())
+                            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Tokens can't be held by address: ") + name_);
                         std::string strError = "";
                         if (!ContextualCheckVerifierString(currentActiveTokenCache, strippedVerifierString,
-                                                           EncodeDestination(destination), strError))
+                                                           tokenAddress, strError))
                             throw JSONRPCError(RPC_INVALID_PARAMETER, std::string(
                                     "Invalid parmeter, verifier string is not. Please check the syntax. Error Msg - " +
                                     strError));
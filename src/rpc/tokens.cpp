@@ -52,8 +52,7 @@ void CheckRestrictedTokenTransferInputs(const CWalletTx& transaction, const std:
 
 
                     if (IsTokenNameAnRestricted(data.tokenName)) {
-                        if (ptokens->CheckForAddressRestriction(data.tokenName, EncodeDestination(data.destination),
-                                                                true)) {
+                        if (ptokens->CheckForAddressRestriction(data.tokenName, data.address, true)) {
                             throw JSONRPCError(RPC_INVALID_PARAMETER, std::string(
                                     _("Restricted token transfer from address that has been frozen")));
                         }
@@ -888,7 +887,7 @@ UniValue listtokenbalancesbyaddress(const JSONRPCRequest& request)
 
     if (request.fHelp || !AreTokensDeployed() || request.params.size() < 1)
         throw std::runtime_error(
-            "listtokenbalancesbyaddress \"address\" (onlytotal) (count) (start)\n"
+            "listtokenbalancesbyaddress \"address\" (onlytotal) (count) (start) (\"after\")\n"
             + TokenActivationWarning() +
             "\nReturns a list of all token balances for an address.\n"
 
@@ -897,6 +896,7 @@ UniValue listtokenbalancesbyaddress(const JSONRPCRequest& request)
             "2. \"onlytotal\"                (boolean, optional, default=false) when false result is just a list of tokens balances -- when true the result is just a single number representing the number of tokens\n"
             "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ tokens found\n"
             "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ tokens found (if negative it skips back from the end)\n"
+            "5. \"after\"                    (string, optional) continue after this token name, the last one of the previous page\n"
 
             "\nResult:\n"
             "{\n"
@@ -907,6 +907,7 @@ UniValue listtokenbalancesbyaddress(const JSONRPCRequest& request)
 
             "\nExamples:\n"
             + HelpExampleCli("listtokenbalancesbyaddress", "\"myaddress\" false 2 0")
+            + HelpExampleCli("listtokenbalancesbyaddress", "\"myaddress\" false 2 0 \"LAST_TOKEN_NAME\"")
             + HelpExampleCli("listtokenbalancesbyaddress", "\"myaddress\" true")
             + HelpExampleCli("listtokenbalancesbyaddress", "\"myaddress\"")
         );
@@ -918,6 +919,9 @@ UniValue listtokenbalancesbyaddress(const JSONRPCRequest& request)
     if (!IsValidDestination(destination)) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Invalid Paladeum address: ") + address);
     }
+    CTokenAddress tokenAddress(destination);
+    if (tokenAddress.IsNull())
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Tokens can't be held by address: ") + address);
 
     bool fOnlyTotal = false;
     if (request.params.size() > 1)
@@ -935,13 +939,19 @@ UniValue listtokenbalancesbyaddress(const JSONRPCRequest& request)
         start = request.params[3].get_int();
     }
 
+    std::string after;
+    if (request.params.size() > 4) {
+        after = request.params[4].get_str();
+        if (!after.empty() && start < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start can't be negative when continuing after a token.");
+    }
+
     if (!ptokensdb)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "token db unavailable.");
 
-    LOCK(cs_main);
     std::vector<std::pair<std::string, CAmount> > vecTokenAmounts;
     int nTotalEntries = 0;
-    if (!ptokensdb->AddressDir(vecTokenAmounts, nTotalEntries, fOnlyTotal, address, count, start))
+    if (!ptokensdb->AddressDir(vecTokenAmounts, nTotalEntries, fOnlyTotal, tokenAddress, count, start, after))
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve address token directory.");
 
     // If only the number of addresses is wanted return it
@@ -1397,9 +1407,9 @@ UniValue listaddressesbytoken(const JSONRPCRequest &request)
         return "_This rpc call is not functional unless -tokenindex is enabled. To enable, please run the wallet with -tokenindex, this will require a reindex to occur";
     }
 
-    if (request.fHelp || !AreTokensDeployed() || request.params.size() > 4 || request.params.size() < 1)
+    if (request.fHelp || !AreTokensDeployed() || request.params.size() > 5 || request.params.size() < 1)
         throw std::runtime_error(
-                "listaddressesbytoken \"token_name\" (onlytotal) (count) (start)\n"
+                "listaddressesbytoken \"token_name\" (onlytotal) (count) (start) (\"after\")\n"
                 + TokenActivationWarning() +
                 "\nReturns a list of all address that own the given token (with balances)"
                 "\nOr returns the total size of how many address own the given token"
@@ -1409,6 +1419,7 @@ UniValue listaddressesbytoken(const JSONRPCRequest &request)
                 "2. \"onlytotal\"                (boolean, optional, default=false) when false result is just a list of addresses with balances -- when true the result is just a single number representing the number of addresses\n"
                 "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ tokens found\n"
                 "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ tokens found (if negative it skips back from the end)\n"
+                "5. \"after\"                    (string, optional) continue after this address, the last one of the previous page\n"
 
                 "\nResult:\n"
                 "[ "
@@ -1418,12 +1429,11 @@ UniValue listaddressesbytoken(const JSONRPCRequest &request)
 
                 "\nExamples:\n"
                 + HelpExampleCli("listaddressesbytoken", "\"TOKEN_NAME\" false 2 0")
+                + HelpExampleCli("listaddressesbytoken", "\"TOKEN_NAME\" false 2 0 \"LAST_ADDRESS\"")
                 + HelpExampleCli("listaddressesbytoken", "\"TOKEN_NAME\" true")
                 + HelpExampleCli("listaddressesbytoken", "\"TOKEN_NAME\"")
         );
 
-    LOCK(cs_main);
-
     std::string token_name = request.params[0].get_str();
     bool fOnlyTotal = false;
     if (request.params.size() > 1)
@@ -1441,13 +1451,21 @@ UniValue listaddressesbytoken(const JSONRPCRequest &request)
         start = request.params[3].get_int();
     }
 
+    CTokenAddress after;
+    if (request.params.size() > 4 && !request.params[4].get_str().empty()) {
+        after = CTokenAddress::FromString(request.params[4].get_str());
+        if (after.IsNull())
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Invalid Paladeum address: ") + request.params[4].get_str());
+        if (start < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start can't be negative when continuing after an address.");
+    }
+
     if (!IsTokenNameValid(token_name))
         return "_Not a valid token name";
 
-    LOCK(cs_main);
-    std::vector<std::pair<std::string, CAmount> > vecAddressAmounts;
+    std::vector<std::pair<CTokenAddress, CAmount> > vecAddressAmounts;
     int nTotalEntries = 0;
-    if (!ptokensdb->TokenAddressDir(vecAddressAmounts, nTotalEntries, fOnlyTotal, token_name, count, start))
+    if (!ptokensdb->TokenAddressDir(vecAddressAmounts, nTotalEntries, fOnlyTotal, token_name, count, start, after))
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve address token directory.");
 
     // If only the number of addresses is wanted return it
@@ -1457,7 +1475,7 @@ UniValue listaddressesbytoken(const JSONRPCRequest &request)
 
     UniValue result(UniValue::VOBJ);
     for (auto& pair : vecAddressAmounts) {
-        result.push_back(Pair(pair.first, UnitValueFromAmount(pair.second, token_name)));
+        result.push_back(Pair(pair.first.ToString(), UnitValueFromAmount(pair.second, token_name)));
     }
 
 
@@ -1515,7 +1533,7 @@ UniValue transfer(const JSONRPCRequest& request)
     std::string to_address = request.params[2].get_str();
 
     if (IsUsernameValid(to_address)) {
-        to_address = ptokensdb->UsernameAddress(to_address);
+        to_address = ptokensdb->UsernameAddress(to_address).ToString();
         if (to_address == "") {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
         }
@@ -1670,7 +1688,7 @@ UniValue transferfromaddresses(const JSONRPCRequest& request)
         std::string address = from_addresses[i].get_str();
 
         if (IsUsernameValid(address)) {
-            address = ptokensdb->UsernameAddress(address);
+            address = ptokensdb->UsernameAddress(address).ToString();
             if (address == "") {
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
             }
@@ -2436,9 +2454,9 @@ UniValue sweep(const JSONRPCRequest& request)
 
 UniValue listtokens(const JSONRPCRequest& request)
 {
-    if (request.fHelp || !AreTokensDeployed() || request.params.size() > 4)
+    if (request.fHelp || !AreTokensDeployed() || request.params.size() > 5)
         throw std::runtime_error(
-                "listtokens \"( token )\" ( verbose ) ( count ) ( start )\n"
+                "listtokens \"( token )\" ( verbose ) ( count ) ( start ) ( \"after\" )\n"
                 + TokenActivationWarning() +
                 "\nReturns a list of all tokens\n"
                 "\nThis could be a slow/expensive operation as it reads from the database\n"
@@ -2448,6 +2466,7 @@ UniValue listtokens(const JSONRPCRequest& request)
                 "2. \"verbose\"                  (boolean, optional, default=false) when false result is just a list of token names -- when true results are token name mapped to metadata\n"
                 "3. \"count\"                    (integer, optional, default=ALL) truncates results to include only the first _count_ tokens found\n"
                 "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ tokens found (if negative it skips back from the end)\n"
+                "5. \"after\"                    (string, optional) continue after this token name, the last one of the previous page\n"
 
                 "\nResult (verbose=false):\n"
                 "[\n"
@@ -2473,6 +2492,7 @@ UniValue listtokens(const JSONRPCRequest& request)
                 + HelpExampleRpc("listtokens", "")
                 + HelpExampleCli("listtokens", "TOKEN")
                 + HelpExampleCli("listtokens", "\"TOKEN*\" true 10 20")
+                + HelpExampleCli("listtokens", "\"TOKEN*\" true 10 0 \"TOKEN_LAST\"")
         );
 
     ObserveSafeMode();
@@ -2503,8 +2523,15 @@ UniValue listtokens(const JSONRPCRequest& request)
         start = request.params[3].get_int();
     }
 
+    std::string after;
+    if (request.params.size() > 4) {
+        after = request.params[4].get_str();
+        if (!after.empty() && start < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start can't be negative when continuing after a token.");
+    }
+
     std::vector<CDatabasedTokenData> tokens;
-    if (!ptokensdb->TokenDir(tokens, filter, count, start))
+    if (!ptokensdb->TokenDir(tokens, filter, count, start, after))
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve token directory.");
 
     UniValue result;
@@ -2537,6 +2564,22 @@ UniValue listtokens(const JSONRPCRequest& request)
     return result;
 }
 
+template <typename Cache>
+static UniValue LRUCacheInfo(const Cache& cache)
+{
+    uint64_t nHits, nMisses, nEvictions;
+    cache.GetStats(nHits, nMisses, nEvictions);
+
+    UniValue info(UniValue::VOBJ);
+    info.push_back(Pair("usage", (int64_t)cache.DynamicMemoryUsage()));
+    info.push_back(Pair("limit", (int64_t)cache.MaxSize()));
+    info.push_back(Pair("entries", (int64_t)cache.Size()));
+    info.push_back(Pair("hits", (int64_t)nHits));
+    info.push_back(Pair("misses", (int64_t)nMisses));
+    info.push_back(Pair("evictions", (int64_t)nEvictions));
+    return info;
+}
+
 UniValue getcacheinfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || !AreTokensDeployed() || request.params.size())
@@ -2547,16 +2590,18 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
                 "\nResult:\n"
                 "[\n"
                 "  uxto cache size:\n"
-                "  token total (exclude dirty):\n"
-                "  token address map:\n"
-                "  token address balance:\n"
-                "  my unspent token:\n"
-                "  reissue data:\n"
-                "  token metadata map:\n"
-                "  token metadata list (est):\n"
-                "  dirty cache (est):\n"
-
-
+                "  token total:                  (bytes) token cache, balances, reissue data and dirty entries\n"
+                "  token cache limit:            (bytes) -tokencache, the token cache is flushed above it\n"
+                "  token data:\n"
+                "    token address balance:\n"
+                "    reissue data:\n"
+                "  reissue tracking (memory only):\n"
+                "  token metadata cache:          {usage, limit, entries, hits, misses, evictions}\n"
+                "  token verifier cache:          {...}\n"
+                "  token qualifier cache:         {...}\n"
+                "  token restriction cache:       {...}\n"
+                "  token global restriction cache: {...}\n"
+                "  dirty cache:                  (bytes) entries written to the database on the next flush\n"
                 "]\n"
 
                 "\nExamples:\n"
@@ -2577,20 +2622,30 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
     UniValue result(UniValue::VARR);
 
     UniValue info(UniValue::VOBJ);
-    info.push_back(Pair("uxto cache size", (int)pcoinsTip->DynamicMemoryUsage()));
-    info.push_back(Pair("token total (exclude dirty)", (int)currentActiveTokenCache->DynamicMemoryUsage()));
+    info.push_back(Pair("uxto cache size", (int64_t)pcoinsTip->DynamicMemoryUsage()));
+    info.push_back(Pair("token total", (int64_t)currentActiveTokenCache->DynamicMemoryUsage()));
+    info.push_back(Pair("token cache limit", (int64_t)nTokenCacheUsage));
+
+    size_t nBalanceUsage = currentActiveTokenCache->mapTokensAddressAmount.DynamicMemoryUsage();
+    size_t nReissueUsage = currentActiveTokenCache->mapReissuedTokenData.DynamicMemoryUsage();
 
     UniValue descendants(UniValue::VOBJ);
 
-    descendants.push_back(Pair("token address balance",   (int)memusage::DynamicUsage(currentActiveTokenCache->mapTokensAddressAmount)));
-    descendants.push_back(Pair("reissue data",   (int)memusage::DynamicUsage(currentActiveTokenCache->mapReissuedTokenData)));
+    descendants.push_back(Pair("token address balance", (int64_t)nBalanceUsage));
+    descendants.push_back(Pair("reissue data", (int64_t)nReissueUsage));
 
-    info.push_back(Pair("reissue tracking (memory only)", (int)memusage::DynamicUsage(mapReissuedTokens) + (int)memusage::DynamicUsage(mapReissuedTx)));
     info.push_back(Pair("token data", descendants));
-    info.push_back(Pair("token metadata map",  (int)memusage::DynamicUsage(ptokensCache->GetItemsMap())));
-    info.push_back(Pair("token metadata list (est)",  (int)ptokensCache->GetItemsList().size() * (32 + 80))); // Max 32 bytes for token name, 80 bytes max for token data
-    info.push_back(Pair("dirty cache (est)",  (int)currentActiveTokenCache->GetCacheSize()));
-    info.push_back(Pair("dirty cache V2 (est)",  (int)currentActiveTokenCache->GetCacheSizeV2()));
+    info.push_back(Pair("reissue tracking (memory only)", (int64_t)(memusage::DynamicUsage(mapReissuedTokens) + memusage::DynamicUsage(mapReissuedTx))));
+    info.push_back(Pair("token metadata cache", LRUCacheInfo(*ptokensCache)));
+    if (ptokensVerifierCache)
+        info.push_back(Pair("token verifier cache", LRUCacheInfo(*ptokensVerifierCache)));
+    if (ptokensQualifierCache)
+        info.push_back(Pair("token qualifier cache", LRUCacheInfo(*ptokensQualifierCache)));
+    if (ptokensRestrictionCache)
+        info.push_back(Pair("token restriction cache", LRUCacheInfo(*ptokensRestrictionCache)));
+    if (ptokensGlobalRestrictionCache)
+        info.push_back(Pair("token global restriction cache", LRUCacheInfo(*ptokensGlobalRestrictionCache)));
+    info.push_back(Pair("dirty cache", (int64_t)currentActiveTokenCache->GetCacheSize()));
 
     result.push_back(info);
     return result;
@@ -2607,7 +2662,7 @@ UniValue getusernameaddress(const JSONRPCRequest& request)
                 + HelpExampleCli("getusernameaddress", "@USERNAME")
         );
 
-    std::string address = ptokensdb->UsernameAddress(request.params[0].get_str());
+    std::string address = ptokensdb->UsernameAddress(request.params[0].get_str()).ToString();
     if (address == "") {
         throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
     }
@@ -2824,11 +2879,14 @@ UniValue listtagsforaddress(const JSONRPCRequest &request)
     CTxDestination dest = DecodeDestination(address);
     if (!IsValidDestination(dest))
         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Not valid PLB address: ") + address);
+    CTokenAddress tokenAddress(dest);
+    if (tokenAddress.IsNull())
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Tokens can't be held by address: ") + address);
 
     std::vector<std::string> qualifiers;
 
     // This function forces a FlushStateToDisk so that a database scan and occur
-    if (!prestricteddb->GetAddressQualifiers(address, qualifiers)) {
+    if (!prestricteddb->GetAddressQualifiers(tokenAddress, qualifiers)) {
         throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to search the database");
     }
 
@@ -2871,7 +2929,7 @@ UniValue listaddressesfortag(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "You must use qualifier token names only, qualifier tokens start with '#'");
 
 
-    std::vector<std::string> addresses;
+    std::vector<CTokenAddress> addresses;
 
     // This function forces a FlushStateToDisk so that a database scan and occur
     if (!prestricteddb->GetQualifierAddresses(qualifier_name, addresses)) {
@@ -2880,7 +2938,7 @@ UniValue listaddressesfortag(const JSONRPCRequest& request)
 
     UniValue ret(UniValue::VARR);
     for (auto item : addresses) {
-        ret.push_back(item);
+        ret.push_back(item.ToString());
     }
 
     return ret;
@@ -2917,10 +2975,13 @@ UniValue listaddressrestrictions(const JSONRPCRequest& request)
     CTxDestination dest = DecodeDestination(address);
     if (!IsValidDestination(dest))
         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Not valid PLB address: ") + address);
+    CTokenAddress tokenAddress(dest);
+    if (tokenAddress.IsNull())
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Tokens can't be held by address: ") + address);
 
     std::vector<std::string> restrictions;
 
-    if (!prestricteddb->GetAddressRestrictions(address, restrictions)) {
+    if (!prestricteddb->GetAddressRestrictions(tokenAddress, restrictions)) {
         throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to search the database");
     }
 
@@ -3041,8 +3102,11 @@ UniValue checkaddresstag(const JSONRPCRequest& request)
     CTxDestination dest = DecodeDestination(address);
     if (!IsValidDestination(dest))
         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Not valid PLB address: ") + address);
+    CTokenAddress tokenAddress(dest);
+    if (tokenAddress.IsNull())
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Tokens can't be held by address: ") + address);
 
-    return ptokens->CheckForAddressQualifier(qualifier_name, address);
+    return ptokens->CheckForAddressQualifier(qualifier_name, tokenAddress);
 }
 
 UniValue checkaddressrestriction(const JSONRPCRequest& request)
@@ -3081,8 +3145,11 @@ UniValue checkaddressrestriction(const JSONRPCRequest& request)
     CTxDestination dest = DecodeDestination(address);
     if (!IsValidDestination(dest))
         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Not valid PLB address: ") + address);
+    CTokenAddress tokenAddress(dest);
+    if (tokenAddress.IsNull())
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Tokens can't be held by address: ") + address);
 
-    return ptokens->CheckForAddressRestriction(restricted_name, address);
+    return ptokens->CheckForAddressRestriction(restricted_name, tokenAddress);
 }
 
 UniValue checkglobalrestriction(const JSONRPCRequest& request)
@@ -3359,13 +3426,16 @@ UniValue issuerestrictedtoken(const JSONRPCRequest& request)
     if (!IsValidDestination(destination)) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Invalid Paladeum address: ") + to_address);
     }
+    CTokenAddress tokenAddress(destination);
+    if (tokenAddress.IsNull())
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, std::string("Tokens can't be held by address: ") + to_address);
 
 
     std::string verifierStripped = GetStrippedVerifierString(verifier_string);
 
     // Validate the verifier string with the given to_address
     std::string strError = "";
-    if (!ContextualCheckVerifierString(ptokens, verifierStripped, to_address, strError))
+    if (!ContextualCheckVerifierString(ptokens, verifierStripped, tokenAddress, strError))
         throw JSONRPCError(RPC_INVALID_PARAMETER, strError);
 
     // Get the change address if one was given
@@ -3764,7 +3834,7 @@ UniValue isvalidverifierstring(const JSONRPCRequest& request)
     std::string stripped_verifier_string = GetStrippedVerifierString(verifier_string);
 
     std::string strError;
-    if (!ContextualCheckVerifierString(ptokens, stripped_verifier_string, "", strError)) {
+    if (!ContextualCheckVerifierString(ptokens, stripped_verifier_string, CTokenAddress(), strError)) {
         throw JSONRPCError(RPC_INVALID_PARAMETER, strError);
     }
 
@@ -3891,9 +3961,9 @@ static const CRPCCommand commands[] =
     { "tokens",   "listmytokens",               &listmytokens,               {"token", "verbose", "count", "start", "confs"}},
     { "tokens",   "listmylockedtokens",         &listmylockedtokens,         {"token", "verbose", "count", "start"}},
 #endif
-    { "tokens",   "listtokenbalancesbyaddress", &listtokenbalancesbyaddress, {"address", "onlytotal", "count", "start"} },
+    { "tokens",   "listtokenbalancesbyaddress", &listtokenbalancesbyaddress, {"address", "onlytotal", "count", "start", "after"} },
     { "tokens",   "gettokendata",               &gettokendata,               {"token_name"}},
-    { "tokens",   "listaddressesbytoken",       &listaddressesbytoken,       {"token_name", "onlytotal", "count", "start"}},
+    { "tokens",   "listaddressesbytoken",       &listaddressesbytoken,       {"token_name", "onlytotal", "count", "start", "after"}},
 #ifdef ENABLE_WALLET
     { "tokens",   "transferfromaddress",        &transferfromaddress,        {"token_name", "from_address", "qty", "to_address", "timelock", "message", "token_message", "expire_time", "paladeum_change_address", "token_change_address"}},
     { "tokens",   "transferfromaddresses",      &transferfromaddresses,      {"token_name", "from_addresses", "qty", "to_address", "timelock", "message", "token_message", "expire_time", "paladeum_change_address", "token_change_address"}},
@@ -3901,7 +3971,7 @@ static const CRPCCommand commands[] =
     { "tokens",   "reissue",                    &reissue,                    {"token_name", "qty", "to_address", "change_address", "reissuable", "new_units", "new_ipfs"}},
     { "tokens",   "sweep",                      &sweep,                      {"privkey", "token_name"}},
 #endif
-    { "tokens",   "listtokens",                 &listtokens,                 {"token", "verbose", "count", "start"}},
+    { "tokens",   "listtokens",                 &listtokens,                 {"token", "verbose", "count", "start", "after"}},
     { "tokens",   "getcacheinfo",               &getcacheinfo,               {}},
 
 #ifdef ENABLE_WALLET
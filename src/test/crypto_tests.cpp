@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "crypto/aes.h"
+#include "crypto/blake2b_header.h"
 #include "crypto/chacha20.h"
 #include "crypto/ripemd160.h"
 #include "crypto/sha1.h"
@@ -11,6 +12,7 @@
 #include "crypto/sha512.h"
 #include "crypto/hmac_sha256.h"
 #include "crypto/hmac_sha512.h"
+#include "hash.h"
 #include "random.h"
 #include "utilstrencodings.h"
 #include "test/test_paladeum.h"
@@ -565,6 +567,54 @@ BOOST_FIXTURE_TEST_SUITE(crypto_tests, BasicTestingSetup)
                      "fab78c9");
     }
 
+    BOOST_AUTO_TEST_CASE(blake2b_testvectors_test)
+    {
+        BOOST_TEST_MESSAGE("Running blake2b TestVectors Test");
+
+        std::vector<unsigned char> header(BLAKE2B_HEADER_SIZE);
+        for (size_t i = 0; i < header.size(); i++)
+            header[i] = i;
+
+        BOOST_CHECK_EQUAL(HexStr(blake2b(header.data(), header.data())),
+                          "0e5751c026e543b2e8ab2eb06099daa1d1e5df47778f7787faab45cdf12fe3a8");
+        std::string abc = "abc";
+        BOOST_CHECK_EQUAL(HexStr(blake2b(abc.data(), abc.data() + abc.size())),
+                          "bddd813c634239723171ef3fee98579b94964e3bb1cb3e427262c8c068d52319");
+        BOOST_CHECK_EQUAL(HexStr(blake2b(header.data(), header.data() + header.size())),
+                          "066de1009daca2b8390a9dc734bce547ac4e3cc4531645bb8b9cbc0070941d88");
+        std::string million(1000000, 'a');
+        BOOST_CHECK_EQUAL(HexStr(blake2b(million.data(), million.data() + million.size())),
+                          "0741850f36cba4259628355d1073e24ddb9ca0e1bfac36fd39ae5dc2101e23a4");
+    }
+
+    BOOST_AUTO_TEST_CASE(blake2b_header_test)
+    {
+        BOOST_TEST_MESSAGE("Running blake2b Header Test");
+
+        for (int i = 0; i < 64; i++) {
+            std::vector<unsigned char> header(BLAKE2B_HEADER_SIZE);
+            for (size_t j = 0; j < header.size(); j++)
+                header[j] = InsecureRandBits(8);
+            // Also cover the nonce wrapping around within a batch
+            uint32_t nonce = i == 0 ? 0xFFFFFFFC : InsecureRand32();
+
+            Blake2bHeaderMidstate midstate;
+            Blake2bHeaderMidstateInit(midstate, header.data());
+            unsigned char lanes[BLAKE2B_HEADER_LANES * BLAKE2B_HEADER_HASH_SIZE];
+            Blake2bHeaderHash8(midstate, nonce, lanes);
+
+            for (size_t lane = 0; lane < BLAKE2B_HEADER_LANES; lane++) {
+                WriteLE32(header.data() + BLAKE2B_HEADER_SIZE - 4, nonce + (uint32_t)lane);
+                uint256 expected = blake2b(header.data(), header.data() + header.size());
+
+                unsigned char hash[BLAKE2B_HEADER_HASH_SIZE];
+                Blake2bHeaderHash(midstate, nonce + (uint32_t)lane, hash);
+                BOOST_CHECK(memcmp(hash, expected.begin(), sizeof(hash)) == 0);
+                BOOST_CHECK(memcmp(lanes + BLAKE2B_HEADER_HASH_SIZE * lane, expected.begin(), sizeof(hash)) == 0);
+            }
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(countbits_test)
     {
         BOOST_TEST_MESSAGE("Running CoutBits Test");
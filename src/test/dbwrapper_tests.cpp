@@ -6,6 +6,8 @@
 #include "dbwrapper.h"
 #include "uint256.h"
 #include "random.h"
+#include "txdb.h"
+#include "utilstrencodings.h"
 #include "test/test_paladeum.h"
 
 #include <boost/test/unit_test.hpp>
@@ -85,6 +87,44 @@ BOOST_FIXTURE_TEST_SUITE(dbwrapper_tests, BasicTestingSetup)
         }
     }
 
+// Test ordered batch operations
+    BOOST_AUTO_TEST_CASE(dbwrapper_ordered_batch_test)
+    {
+        BOOST_TEST_MESSAGE("Running dbWrapper Ordered Batch Test");
+
+        // The values are serialized before the obfuscation key is known, both ways have to read back
+        for (bool obfuscate : {false, true}) {
+            fs::path ph = fs::temp_directory_path() / fs::unique_path();
+            CDBWrapper dbw(ph, (1 << 20), true, false, obfuscate);
+
+            char key = 'i';
+            uint256 in = InsecureRand256();
+            char key2 = 'j';
+            uint256 in2 = InsecureRand256();
+            uint256 in3 = InsecureRand256();
+
+            dbw.Write(key2, in2);
+
+            CDBOrderedBatch ordered;
+            ordered.Write(key, in);
+            ordered.Erase(key);
+            ordered.Write(key, in3);
+            ordered.Erase(key2);
+
+            // Only the last change to each key is kept
+            BOOST_CHECK_EQUAL(ordered.Size(), 2U);
+
+            CDBBatch batch(dbw);
+            ordered.AddTo(batch);
+            dbw.WriteBatch(batch);
+
+            uint256 res;
+            BOOST_CHECK(dbw.Read(key, res));
+            BOOST_CHECK_EQUAL(res.ToString(), in3.ToString());
+            BOOST_CHECK(dbw.Read(key2, res) == false);
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(dbwrapper_iterator_test)
     {
         BOOST_TEST_MESSAGE("Running dbWrapper Iterator Test");
@@ -360,5 +400,117 @@ BOOST_FIXTURE_TEST_SUITE(dbwrapper_tests, BasicTestingSetup)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(address_balance_index_test)
+    {
+        BOOST_TEST_MESSAGE("Running Address Balance Index Test");
+
+        CIndexesDB db(1 << 20, true);
+        uint160 hashBytes(ParseHex("0102030405060708090a0b0c0d0e0f1011121314"));
+        uint256 txid = InsecureRand256();
+        uint256 spendid = InsecureRand256();
+
+        // Received 50 and 20 locked until height 1000, spent 30 and a token
+        std::vector<std::pair<CAddressIndexKey, CAmount> > vReceive;
+        vReceive.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, 10, 1, txid, 0, false), 50));
+        vReceive.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, 10, 1, txid, 1, false, 1000), 20));
+        vReceive.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, "TOKEN", 10, 1, txid, 2, false), 7));
+        std::vector<std::pair<CAddressIndexKey, CAmount> > vSpend;
+        vSpend.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, 11, 1, spendid, 0, true), -30));
+
+        BOOST_CHECK(db.WriteAddressIndex(vReceive, true));
+        BOOST_CHECK(db.WriteAddressIndex(vSpend, true));
+
+        // Writing a block again doesn't count it twice
+        BOOST_CHECK(db.WriteAddressIndex(vReceive, true));
+
+        std::vector<std::pair<CAddressIndexIteratorTokenKey, CAddressBalanceValue> > balances;
+        BOOST_CHECK(db.ReadAddressBalanceIndex(hashBytes, 1, PLB, balances));
+        BOOST_CHECK_EQUAL(balances.size(), 1U);
+        BOOST_CHECK_EQUAL(balances[0].second.received, 70);
+        BOOST_CHECK_EQUAL(balances[0].second.balance, 40);
+        BOOST_CHECK_EQUAL(balances[0].second.GetLocked(999, 0), 20);
+        BOOST_CHECK_EQUAL(balances[0].second.GetLocked(1001, 0), 0);
+
+        // The balances match adding up the address index
+        std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+        BOOST_CHECK(db.ReadAddressIndex(hashBytes, 1, PLB, addressIndex));
+        CAmount nBalance = 0;
+        for (const auto& entry : addressIndex)
+            nBalance += entry.second;
+        BOOST_CHECK_EQUAL(nBalance, balances[0].second.balance);
+
+        // Every token of the address is listed without a token name
+        balances.clear();
+        BOOST_CHECK(db.ReadAddressBalanceIndex(hashBytes, 1, "", balances));
+        BOOST_CHECK_EQUAL(balances.size(), 2U);
+
+        // Disconnecting the blocks removes the balances again, also when a block is erased twice
+        BOOST_CHECK(db.EraseAddressIndex(vSpend, true));
+        BOOST_CHECK(db.EraseAddressIndex(vSpend, true));
+        BOOST_CHECK(db.EraseAddressIndex(vReceive, true));
+        balances.clear();
+        BOOST_CHECK(db.ReadAddressBalanceIndex(hashBytes, 1, "", balances));
+        BOOST_CHECK(balances.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(address_index_paging_test)
+    {
+        BOOST_TEST_MESSAGE("Running Address Index Paging Test");
+
+        CIndexesDB db(1 << 20, true);
+        uint160 hashBytes(ParseHex("0102030405060708090a0b0c0d0e0f1011121314"));
+
+        // PLB and a token received at heights 1 to 10
+        std::vector<std::pair<CAddressIndexKey, CAmount> > vReceive;
+        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > vUnspent;
+        for (int nHeight = 1; nHeight <= 10; nHeight++) {
+            uint256 txid = InsecureRand256();
+            vReceive.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, nHeight, 1, txid, 0, false), 10));
+            vReceive.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, "TOKEN", nHeight, 1, txid, 1, false), 1));
+            vUnspent.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, txid, 0), CAddressUnspentValue(10, CScript(), nHeight, 0)));
+            vUnspent.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, "TOKEN", txid, 1), CAddressUnspentValue(1, CScript(), nHeight, 0)));
+        }
+        BOOST_CHECK(db.WriteAddressIndex(vReceive));
+        BOOST_CHECK(db.UpdateAddressUnspentIndex(vUnspent));
+
+        // Pages of 3 entries between heights 3 and 8 of every token, each continuing after the last one
+        std::vector<CAddressIndexKey> vPaged;
+        CAddressIndexKey after;
+        bool fResume = false;
+        for (size_t nPage = 0; nPage < 10; nPage++) {
+            size_t nRead = 0;
+            BOOST_CHECK(db.ReadAddressIndex(hashBytes, 1, "", 3, 8, fResume ? &after : nullptr, [&](const CAddressIndexKey& key, const CAmount& nValue) {
+                if (nRead == 3)
+                    return false;
+                vPaged.push_back(key);
+                after = key;
+                nRead++;
+                return true;
+            }));
+            fResume = true;
+            if (nRead < 3)
+                break;
+        }
+
+        BOOST_CHECK_EQUAL(vPaged.size(), 12U);
+        for (const CAddressIndexKey& key : vPaged)
+            BOOST_CHECK(key.blockHeight >= 3 && key.blockHeight <= 8);
+        BOOST_CHECK_EQUAL(std::count_if(vPaged.begin(), vPaged.end(), [](const CAddressIndexKey& key) { return key.token == PLB; }), 6);
+
+        // The token outputs are listed without the PLB ones
+        size_t nTokenOutputs = 0;
+        BOOST_CHECK(db.ReadAddressUnspentIndex(hashBytes, 1, "", true, nullptr, [&](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+            BOOST_CHECK(key.token != PLB);
+            nTokenOutputs++;
+            return true;
+        }));
+        BOOST_CHECK_EQUAL(nTokenOutputs, 10U);
+
+        // Both tokens are found with one seek each
+        std::vector<std::string> tokens;
+        BOOST_CHECK(db.ReadAddressIndexTokens(hashBytes, 1, tokens));
+        BOOST_CHECK_EQUAL(tokens.size(), 2U);
+        BOOST_CHECK(std::count(tokens.begin(), tokens.end(), PLB) == 1 && std::count(tokens.begin(), tokens.end(), "TOKEN") == 1);
+    }
 
 BOOST_AUTO_TEST_SUITE_END()
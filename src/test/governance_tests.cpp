@@ -0,0 +1,343 @@
+// Copyright (c) 2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "base58.h"
+#include "chainparams.h"
+#include "governance/governance.h"
+#include "key.h"
+#include "script/sign.h"
+#include "script/standard.h"
+#include "test/test_paladeum.h"
+#include "tokens/tokendb.h"
+#include "validation.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(governance_tests, TestingSetup)
+
+static CScript GetTestScript(unsigned char n)
+{
+    return GetScriptForDestination(CKeyID(uint160(std::vector<unsigned char>(20, n))));
+}
+
+BOOST_AUTO_TEST_CASE(governance_cache_freeze_test)
+{
+    CScript script = GetTestScript(1);
+    unsigned int nFrozen = pgovernanceTip->GetNumberOfFrozenScripts();
+
+    BOOST_CHECK(pgovernanceTip->CanSend(script));
+    BOOST_CHECK(!pgovernanceTip->ScriptExist(script));
+
+    {
+        CGovernanceCache cache(pgovernanceTip);
+        BOOST_CHECK(cache.FreezeScript(script));
+
+        // Only the child view sees the change until it is flushed
+        BOOST_CHECK(!cache.CanSend(script));
+        BOOST_CHECK(pgovernanceTip->CanSend(script));
+        BOOST_CHECK_EQUAL(cache.GetNumberOfFrozenScripts(), nFrozen + 1);
+    }
+
+    BOOST_CHECK(pgovernanceTip->CanSend(script));
+
+    CGovernanceCache cache(pgovernanceTip);
+    BOOST_CHECK(cache.FreezeScript(script));
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(!pgovernanceTip->CanSend(script));
+    BOOST_CHECK_EQUAL(pgovernanceTip->GetNumberOfFrozenScripts(), nFrozen + 1);
+
+    // Flushing the tip writes to the database and its in-memory state
+    BOOST_CHECK(pgovernanceTip->Flush());
+    BOOST_CHECK(!governance->CanSend(script));
+    BOOST_CHECK_EQUAL(governance->GetNumberOfFrozenScripts(), nFrozen + 1);
+
+    std::vector<CScript> vFrozen;
+    governance->GetFrozenScripts(&vFrozen);
+    BOOST_CHECK(std::find(vFrozen.begin(), vFrozen.end(), script) != vFrozen.end());
+
+    // Reverting an unknown or already reverted freeze fails
+    BOOST_CHECK(!cache.RevertFreezeScript(GetTestScript(2)));
+    BOOST_CHECK(cache.RevertFreezeScript(script));
+    BOOST_CHECK(!cache.RevertFreezeScript(script));
+    BOOST_CHECK(cache.CanSend(script));
+    BOOST_CHECK(!governance->CanSend(script));
+
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(pgovernanceTip->Flush());
+    BOOST_CHECK(governance->CanSend(script));
+    BOOST_CHECK(governance->ScriptExist(script));
+    BOOST_CHECK_EQUAL(governance->GetNumberOfFrozenScripts(), nFrozen);
+}
+
+BOOST_AUTO_TEST_CASE(governance_cache_authority_test)
+{
+    CScript script = GetTestScript(3);
+
+    CGovernanceCache cache(pgovernanceTip);
+    BOOST_CHECK(!cache.CanStake(script));
+    BOOST_CHECK(cache.AuthorizeScript(script));
+    BOOST_CHECK(cache.CanStake(script));
+    BOOST_CHECK(!pgovernanceTip->CanStake(script));
+
+    std::vector<CScript> vValidators;
+    cache.GetActiveValidatorsScript(&vValidators);
+    BOOST_CHECK(std::find(vValidators.begin(), vValidators.end(), script) != vValidators.end());
+
+    BOOST_CHECK(cache.UnauthorizeScript(script));
+    BOOST_CHECK(!cache.CanStake(script));
+    BOOST_CHECK(cache.AuthorityExist(script));
+    BOOST_CHECK(cache.RevertUnauthorizeScript(script));
+    BOOST_CHECK(cache.CanStake(script));
+
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(pgovernanceTip->Flush());
+    BOOST_CHECK(governance->CanStake(script));
+}
+
+BOOST_AUTO_TEST_CASE(governance_validator_epoch_test)
+{
+    CScript script = GetTestScript(5);
+    CKey key;
+    key.MakeNewKey(true);
+    CPubKey pubkey = key.GetPubKey();
+    CScript pubkeyScript = GetScriptForRawPubKey(pubkey);
+    CScript pubkeyHashScript = GetScriptForDestination(pubkey.GetID());
+
+    CGovernanceScriptSet validators;
+    uint64_t nEpoch = pgovernanceTip->GetValidatorEpoch();
+
+    CGovernanceCache cache(pgovernanceTip);
+    BOOST_CHECK(cache.AuthorizeScript(script));
+    BOOST_CHECK(cache.AuthorizeScript(pubkeyHashScript));
+    BOOST_CHECK_EQUAL(cache.GetValidatorEpoch(), nEpoch + 2);
+    BOOST_CHECK_EQUAL(pgovernanceTip->GetValidatorEpoch(), nEpoch);
+
+    cache.GetValidators(validators);
+    BOOST_CHECK(validators.count(script));
+    BOOST_CHECK(validators.count(CGovernanceView::GetValidatorScript(pubkeyScript)));
+    BOOST_CHECK(cache.CanStake(pubkeyScript));
+
+    // The epoch is carried over unchanged when the changes move down a layer
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK_EQUAL(pgovernanceTip->GetValidatorEpoch(), nEpoch + 2);
+    BOOST_CHECK(pgovernanceTip->Flush());
+    BOOST_CHECK_EQUAL(pgovernanceTip->GetValidatorEpoch(), nEpoch + 2);
+    BOOST_CHECK_EQUAL(governance->GetValidatorEpoch(), nEpoch + 2);
+
+    governance->GetValidators(validators);
+    BOOST_CHECK(validators.count(script));
+
+    // Freezing does not touch the validator set
+    BOOST_CHECK(cache.FreezeScript(script));
+    BOOST_CHECK_EQUAL(cache.GetValidatorEpoch(), nEpoch + 2);
+
+    BOOST_CHECK(cache.UnauthorizeScript(script));
+    BOOST_CHECK_EQUAL(cache.GetValidatorEpoch(), nEpoch + 3);
+    cache.GetValidators(validators);
+    BOOST_CHECK(!validators.count(script));
+
+    std::vector<CScript> vValidators;
+    vValidators.push_back(script);
+    cache.GetActiveValidatorsScript(&vValidators);
+    BOOST_CHECK_EQUAL(vValidators.size(), validators.size());
+
+    BOOST_CHECK(cache.RevertUnauthorizeScript(script));
+    BOOST_CHECK_EQUAL(cache.GetValidatorEpoch(), nEpoch + 4);
+    cache.GetValidators(validators);
+    BOOST_CHECK(validators.count(script));
+}
+
+BOOST_AUTO_TEST_CASE(governance_cache_cost_test)
+{
+    CAmount nRootCost = pgovernanceTip->GetCost(GOVERNANCE_COST_ROOT);
+
+    CGovernanceCache cache(pgovernanceTip);
+    BOOST_CHECK(!cache.UpdateCost(1 * COIN, GOVERNANCE_COST_RESTRICTED, 10));
+    BOOST_CHECK(cache.UpdateCost(7 * COIN, GOVERNANCE_COST_ROOT, 10));
+    BOOST_CHECK(cache.UpdateCost(9 * COIN, GOVERNANCE_COST_ROOT, 20));
+    BOOST_CHECK_EQUAL(cache.GetCost(GOVERNANCE_COST_ROOT), 9 * COIN);
+    BOOST_CHECK_EQUAL(pgovernanceTip->GetCost(GOVERNANCE_COST_ROOT), nRootCost);
+
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(pgovernanceTip->Flush());
+    BOOST_CHECK_EQUAL(governance->GetCost(GOVERNANCE_COST_ROOT), 9 * COIN);
+
+    // Disconnecting the latest update falls back to the previous one
+    BOOST_CHECK(cache.RevertUpdateCost(GOVERNANCE_COST_ROOT, 20));
+    BOOST_CHECK_EQUAL(cache.GetCost(GOVERNANCE_COST_ROOT), 7 * COIN);
+    BOOST_CHECK(!cache.RevertUpdateCost(GOVERNANCE_COST_ROOT, 20));
+    BOOST_CHECK(cache.RevertUpdateCost(GOVERNANCE_COST_ROOT, 10));
+    BOOST_CHECK_EQUAL(cache.GetCost(GOVERNANCE_COST_ROOT), nRootCost);
+
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(pgovernanceTip->Flush());
+    BOOST_CHECK_EQUAL(governance->GetCost(GOVERNANCE_COST_ROOT), nRootCost);
+}
+
+BOOST_AUTO_TEST_CASE(governance_cache_fee_script_test)
+{
+    CScript feeScript = pgovernanceTip->GetFeeScript();
+    CScript script = GetTestScript(4);
+
+    CGovernanceCache cache(pgovernanceTip);
+    BOOST_CHECK(cache.UpdateFeeScript(script, 15));
+    BOOST_CHECK(cache.GetFeeScript() == script);
+    BOOST_CHECK(pgovernanceTip->GetFeeScript() == feeScript);
+
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(pgovernanceTip->GetFeeScript() == script);
+    BOOST_CHECK(pgovernanceTip->Flush());
+    BOOST_CHECK(governance->GetFeeScript() == script);
+
+    BOOST_CHECK(cache.RevertUpdateFeeScript(15));
+    BOOST_CHECK(!cache.RevertUpdateFeeScript(15));
+    BOOST_CHECK(cache.GetFeeScript() == feeScript);
+}
+
+/** Chainstate in the middle of a flush from one tip to another, as left behind by a node stopped during it */
+class CCoinsViewInterruptedFlush : public CCoinsViewBacked
+{
+    std::vector<uint256> hashHeads;
+
+public:
+    CCoinsViewInterruptedFlush(CCoinsView* viewIn, const uint256& hashNew, const uint256& hashOld) : CCoinsViewBacked(viewIn), hashHeads{hashNew, hashOld} {}
+
+    std::vector<uint256> GetHeadBlocks() const override { return hashHeads; }
+};
+
+static CScript GetGovernanceScript(unsigned char action, const CScript& script)
+{
+    std::vector<unsigned char> vchData = {GOVERNANCE_MARKER, GOVERNANCE_ACTION, action, (unsigned char)script.size()};
+    vchData.insert(vchData.end(), script.begin(), script.end());
+    return CScript() << OP_RETURN << vchData;
+}
+
+/** Drop the governance changes that were only in memory, like a node that stopped before flushing them */
+static void ResetGovernanceTip()
+{
+    LOCK(cs_main);
+    delete pgovernanceTip;
+    pgovernanceTip = new CGovernanceCache(governance);
+}
+
+BOOST_FIXTURE_TEST_CASE(governance_replay_test, TestChain100Setup)
+{
+    const CChainParams& chainparams = GetParams();
+    CScript coinbaseScript = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CScript script = GetTestScript(6);
+
+    // Regtest has no master address, so outputs with an empty script are spent from the master key
+    CScript masterKey = GetScriptForDestination(DecodeDestination(chainparams.GovernanceMasterAddress()));
+
+    CMutableTransaction fund;
+    fund.nVersion = 1;
+    fund.vin.resize(1);
+    fund.vin[0].prevout = COutPoint(coinbaseTxns[0].GetHash(), 0);
+    fund.vout.resize(2);
+    for (CTxOut& out : fund.vout) {
+        out.nValue = 11 * CENT;
+        out.scriptPubKey = masterKey;
+    }
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(coinbaseScript, fund, 0, SIGHASH_ALL, 0, SIGVERSION_BASE);
+    BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    fund.vin[0].scriptSig << vchSig;
+
+    CMutableTransaction freeze;
+    freeze.nVersion = 1;
+    freeze.vin.resize(1);
+    freeze.vin[0].prevout = COutPoint(fund.GetHash(), 0);
+    freeze.vin[0].scriptSig << OP_TRUE;
+    freeze.vout.resize(1);
+    freeze.vout[0].nValue = 0;
+    freeze.vout[0].scriptPubKey = GetGovernanceScript(GOVERNANCE_FREEZE, script);
+
+    CMutableTransaction unfreeze = freeze;
+    unfreeze.vin[0].prevout = COutPoint(fund.GetHash(), 1);
+    unfreeze.vout[0].scriptPubKey = GetGovernanceScript(GOVERNANCE_UNFREEZE, script);
+
+    // Start from a state where every database is at the same block
+    FlushStateToDisk();
+    uint256 hashOld = chainActive.Tip()->GetIndexHash();
+    BOOST_CHECK(governance->GetBestBlock() == hashOld);
+
+    CreateAndProcessBlock({fund, freeze}, coinbaseScript);
+    uint256 hashNew = chainActive.Tip()->GetIndexHash();
+    BOOST_CHECK(hashNew != hashOld);
+    BOOST_CHECK(!pgovernanceTip->CanSend(script));
+
+    // Interrupt the chainstate flush of the new block, before the governance state got written
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(pcoinsTip->Flush());
+    }
+    ResetGovernanceTip();
+    BOOST_CHECK(governance->CanSend(script));
+
+    CCoinsViewInterruptedFlush view(pcoinsdbview, hashNew, hashOld);
+    BOOST_CHECK(ReplayBlocks(chainparams, &view));
+    BOOST_CHECK(governance->GetBestBlock() == hashNew);
+    BOOST_CHECK(!governance->CanSend(script));
+    BOOST_CHECK(!pgovernanceTip->CanSend(script));
+
+    // Replaying again finds the governance state at the new tip and leaves it alone
+    BOOST_CHECK(ReplayBlocks(chainparams, &view));
+    BOOST_CHECK(governance->GetBestBlock() == hashNew);
+    BOOST_CHECK(!governance->CanSend(script));
+
+    // Stop between a complete chainstate flush and the governance flush
+    CreateAndProcessBlock({unfreeze}, coinbaseScript);
+    uint256 hashUnfreeze = chainActive.Tip()->GetIndexHash();
+    BOOST_CHECK(pgovernanceTip->CanSend(script));
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(pcoinsTip->Flush());
+    }
+    ResetGovernanceTip();
+    BOOST_CHECK(!governance->CanSend(script));
+
+    BOOST_CHECK(ReplayBlocks(chainparams, pcoinsdbview));
+    BOOST_CHECK(governance->GetBestBlock() == hashUnfreeze);
+    BOOST_CHECK(governance->CanSend(script));
+
+    // A database without a marker may already hold the actions of the interrupted flush, it is never replayed
+    BOOST_CHECK(governance->Init(true, chainparams));
+    BOOST_CHECK(governance->HasBestBlock());
+    BOOST_CHECK(governance->GetBestBlock().IsNull());
+    BOOST_CHECK(!ReplayBlocks(chainparams, &view));
+    BOOST_CHECK(governance->GetBestBlock().IsNull());
+}
+
+BOOST_FIXTURE_TEST_CASE(governance_replay_tokens_ahead_test, TestChain100Setup)
+{
+    const CChainParams& chainparams = GetParams();
+    CScript coinbaseScript = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    FlushStateToDisk();
+    uint256 hashOld = chainActive.Tip()->GetIndexHash();
+
+    // Stop after the token databases were written for the new block, before the chainstate was
+    CreateAndProcessBlock({}, coinbaseScript);
+    uint256 hashNew = chainActive.Tip()->GetIndexHash();
+    CTokensDBBatch batch;
+    size_t nBytes;
+    BOOST_CHECK(ptokensdb->WriteTokensBatch(batch, hashNew, nBytes));
+    ResetGovernanceTip();
+    BOOST_CHECK(pcoinsdbview->GetBestBlock() == hashOld);
+    BOOST_CHECK(governance->GetBestBlock() == hashOld);
+
+    // The chainstate and the governance database are rolled forward to the token databases
+    BOOST_CHECK(ReplayBlocks(chainparams, pcoinsdbview));
+    BOOST_CHECK(pcoinsdbview->GetBestBlock() == hashNew);
+    BOOST_CHECK(pcoinsdbview->GetHeadBlocks().empty());
+    BOOST_CHECK(governance->GetBestBlock() == hashNew);
+
+    // Token databases behind the chainstate are left alone
+    BOOST_CHECK(ptokensdb->WriteTokensBatch(batch, hashOld, nBytes));
+    BOOST_CHECK(ReplayBlocks(chainparams, pcoinsdbview));
+    BOOST_CHECK(pcoinsdbview->GetBestBlock() == hashNew);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
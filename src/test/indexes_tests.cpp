@@ -0,0 +1,384 @@
+// Copyright (c) 2021-2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "indexes.h"
+#include "chainparams.h"
+#include "consensus/validation.h"
+#include "key.h"
+#include "primitives/block.h"
+#include "script/standard.h"
+#include "tokens/tokens.h"
+#include "txdb.h"
+#include "undo.h"
+#include "utiltime.h"
+#include "validation.h"
+#include "test/test_paladeum.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(indexes_tests, BasicTestingSetup)
+
+static uint160 RandomHash160()
+{
+    uint256 hash = InsecureRand256();
+    return uint160(std::vector<unsigned char>(hash.begin(), hash.begin() + 20));
+}
+
+static CMutableTransaction SpendTx(const COutPoint& prevout, const CScript& scriptPubKey, CAmount nValue)
+{
+    CMutableTransaction tx;
+    tx.nTime = 1600000000;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = prevout;
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = scriptPubKey;
+    tx.vout[0].nValue = nValue;
+    return tx;
+}
+
+// A block of the given transactions after a coinbase that pays to no indexed address, with the undo data of the
+// coins they spend
+static void BuildBlock(const std::vector<CMutableTransaction>& txns, const std::vector<Coin>& coins, CBlock& block, CBlockUndo& blockundo)
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vout.resize(1);
+    coinbase.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    for (unsigned int i = 0; i < txns.size(); i++) {
+        block.vtx.push_back(MakeTransactionRef(txns[i]));
+        CTxUndo txundo;
+        txundo.vprevout.push_back(coins[i]);
+        blockundo.vtxundo.push_back(txundo);
+    }
+}
+
+static void WriteBlockData(CIndexesDB& db, const CIndexesBlockData& data)
+{
+    BOOST_CHECK(db.UpdateAddressUnspentIndex(data.addressUnspentIndex));
+    BOOST_CHECK(db.UpdateSpentIndex(data.spentIndex));
+}
+
+static std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > ReadUnspent(CIndexesDB& db, const uint160& hashBytes, const std::string& tokenName = PLB)
+{
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspent;
+    BOOST_CHECK(db.ReadAddressUnspentIndex(hashBytes, 1, tokenName, unspent));
+    return unspent;
+}
+
+BOOST_AUTO_TEST_CASE(indexes_same_block_spend_test)
+{
+    CIndexesDB db(1 << 20, true, true);
+
+    uint160 hashA = RandomHash160();
+    uint160 hashB = RandomHash160();
+    CScript scriptA = GetScriptForDestination(CKeyID(hashA));
+    CScript scriptB = GetScriptForDestination(CKeyID(hashB));
+
+    // An output of an earlier block, already in the unspent index
+    COutPoint prevout(InsecureRand256(), 0);
+    Coin coinPrev(CTxOut(10 * COIN, scriptA), 5, false, false, 1500000000);
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > prevEntry;
+    prevEntry.push_back(std::make_pair(CAddressUnspentKey(1, hashA, prevout.hash, prevout.n), CAddressUnspentValue(10 * COIN, scriptA, 5, 1500000000)));
+    BOOST_CHECK(db.UpdateAddressUnspentIndex(prevEntry));
+
+    // The second transaction spends the output of the first in the same block
+    CMutableTransaction tx1 = SpendTx(prevout, scriptA, 9 * COIN);
+    CMutableTransaction tx2 = SpendTx(COutPoint(tx1.GetHash(), 0), scriptB, 8 * COIN);
+
+    CBlock block;
+    CBlockUndo blockundo;
+    BuildBlock({tx1, tx2}, {coinPrev, Coin(tx1.vout[0], 10, false, false, tx1.nTime)}, block, blockundo);
+
+    CIndexesBlockData connectData;
+    BOOST_CHECK(GetIndexesBlockData(block, blockundo, 10, true, connectData));
+    WriteBlockData(db, connectData);
+
+    BOOST_CHECK(ReadUnspent(db, hashA).empty());
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentB = ReadUnspent(db, hashB);
+    BOOST_CHECK_EQUAL(unspentB.size(), 1U);
+    BOOST_CHECK(unspentB[0].first.txhash == tx2.GetHash());
+
+    // Undone from the last transaction, the output spent within the block doesn't come back
+    CIndexesBlockData disconnectData;
+    BOOST_CHECK(GetIndexesBlockData(block, blockundo, 10, false, disconnectData));
+    WriteBlockData(db, disconnectData);
+
+    BOOST_CHECK(ReadUnspent(db, hashB).empty());
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspentA = ReadUnspent(db, hashA);
+    BOOST_CHECK_EQUAL(unspentA.size(), 1U);
+    BOOST_CHECK(unspentA[0].first.txhash == prevout.hash);
+    BOOST_CHECK_EQUAL(unspentA[0].second.blockHeight, 5);
+    BOOST_CHECK_EQUAL(unspentA[0].second.nTime, 1500000000U);
+}
+
+BOOST_AUTO_TEST_CASE(indexes_timelocked_token_restore_test)
+{
+    CIndexesDB db(1 << 20, true, true);
+
+    uint160 hashA = RandomHash160();
+    uint160 hashB = RandomHash160();
+    const uint32_t nTimeLock = 1700000000;
+
+    CScript scriptToken = GetScriptForDestination(CKeyID(hashA));
+    CTokenTransfer("LOCKEDTOKEN", 5 * COIN, nTimeLock).ConstructTransaction(scriptToken);
+
+    // The block that creates the timelocked token output
+    COutPoint prevout(InsecureRand256(), 0);
+    CMutableTransaction txCreate = SpendTx(prevout, scriptToken, 0);
+    CBlock blockCreate;
+    CBlockUndo undoCreate;
+    BuildBlock({txCreate}, {Coin(CTxOut(COIN, GetScriptForDestination(CKeyID(hashB))), 5, false, false, 1500000000)}, blockCreate, undoCreate);
+
+    CIndexesBlockData createData;
+    BOOST_CHECK(GetIndexesBlockData(blockCreate, undoCreate, 10, true, createData));
+    WriteBlockData(db, createData);
+
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > created = ReadUnspent(db, hashA, "LOCKEDTOKEN");
+    BOOST_CHECK_EQUAL(created.size(), 1U);
+    BOOST_CHECK_EQUAL(created[0].first.timeLock, (int)nTimeLock);
+
+    // The block that spends it, once connected and disconnected again the entry is back under the same key
+    CMutableTransaction txSpend = SpendTx(COutPoint(txCreate.GetHash(), 0), GetScriptForDestination(CKeyID(hashB)), COIN);
+    CBlock blockSpend;
+    CBlockUndo undoSpend;
+    BuildBlock({txSpend}, {Coin(txCreate.vout[0], 10, false, false, txCreate.nTime)}, blockSpend, undoSpend);
+
+    CIndexesBlockData connectData;
+    BOOST_CHECK(GetIndexesBlockData(blockSpend, undoSpend, 11, true, connectData));
+    WriteBlockData(db, connectData);
+    BOOST_CHECK(ReadUnspent(db, hashA, "LOCKEDTOKEN").empty());
+
+    CIndexesBlockData disconnectData;
+    BOOST_CHECK(GetIndexesBlockData(blockSpend, undoSpend, 11, false, disconnectData));
+    WriteBlockData(db, disconnectData);
+
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > restored = ReadUnspent(db, hashA, "LOCKEDTOKEN");
+    BOOST_CHECK_EQUAL(restored.size(), 1U);
+    BOOST_CHECK(restored[0].first.txhash == created[0].first.txhash);
+    BOOST_CHECK_EQUAL(restored[0].first.timeLock, created[0].first.timeLock);
+    BOOST_CHECK_EQUAL(restored[0].second.satoshis, created[0].second.satoshis);
+    BOOST_CHECK_EQUAL(restored[0].second.blockHeight, created[0].second.blockHeight);
+    BOOST_CHECK_EQUAL(restored[0].second.nTime, created[0].second.nTime);
+}
+
+BOOST_AUTO_TEST_CASE(indexes_spent_erase_test)
+{
+    CIndexesDB db(1 << 20, true, true);
+
+    uint160 hashA = RandomHash160();
+    CScript scriptA = GetScriptForDestination(CKeyID(hashA));
+
+    COutPoint prevout(InsecureRand256(), 1);
+    CMutableTransaction tx = SpendTx(prevout, CScript() << OP_TRUE, 9 * COIN);
+    CBlock block;
+    CBlockUndo blockundo;
+    BuildBlock({tx}, {Coin(CTxOut(10 * COIN, scriptA), 5, false, false, 1500000000)}, block, blockundo);
+
+    CIndexesBlockData connectData;
+    BOOST_CHECK(GetIndexesBlockData(block, blockundo, 10, true, connectData));
+    WriteBlockData(db, connectData);
+
+    CSpentIndexKey key(prevout.hash, prevout.n);
+    CSpentIndexValue value;
+    BOOST_CHECK(db.ReadSpentIndex(key, value));
+    BOOST_CHECK(value.txid == tx.GetHash());
+    BOOST_CHECK_EQUAL(value.inputIndex, 0U);
+    BOOST_CHECK_EQUAL(value.blockHeight, 10);
+    BOOST_CHECK_EQUAL(value.satoshis, 10 * COIN);
+    BOOST_CHECK(value.addressHash == hashA);
+
+    // Disconnecting the block erases the entry
+    CIndexesBlockData disconnectData;
+    BOOST_CHECK(GetIndexesBlockData(block, blockundo, 10, false, disconnectData));
+    WriteBlockData(db, disconnectData);
+    BOOST_CHECK(!db.ReadSpentIndex(key, value));
+}
+
+BOOST_AUTO_TEST_CASE(indexes_erase_moved_test)
+{
+    CBlockTreeDB db(1 << 20, true, true);
+
+    // Rows older versions kept in the block tree database, under the prefixes the indexes use there
+    CSpentIndexKey spentKey(InsecureRand256(), 1);
+    CTimestampBlockIndexKey blockKey(InsecureRand256());
+    for (int i = 0; i < 100; i++)
+        BOOST_CHECK(db.Write(std::make_pair('p', CSpentIndexKey(InsecureRand256(), i)), CSpentIndexValue()));
+    BOOST_CHECK(db.Write(std::make_pair('p', spentKey), CSpentIndexValue()));
+    BOOST_CHECK(db.Write(std::make_pair('z', blockKey), CTimestampBlockIndexValue(1500000000)));
+    BOOST_CHECK(db.Write(std::make_pair('s', CTimestampIndexKey(1500000000, InsecureRand256())), true));
+
+    // The rows the block tree database still owns are kept
+    uint256 txid = InsecureRand256();
+    BOOST_CHECK(db.WriteTxIndex({std::make_pair(txid, CDiskTxPos(CDiskBlockPos(1, 2), 3))}));
+    BOOST_CHECK(db.WriteFlag("txindex", true));
+
+    std::atomic<bool> fInterrupt(true);
+    BOOST_CHECK(db.EraseMovedIndexes(&fInterrupt));
+    BOOST_CHECK(db.Exists(std::make_pair('p', spentKey)));
+
+    BOOST_CHECK(db.EraseMovedIndexes());
+    BOOST_CHECK(!db.Exists(std::make_pair('p', spentKey)));
+    BOOST_CHECK(!db.Exists(std::make_pair('z', blockKey)));
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek('s');
+    std::pair<char, CTimestampIndexKey> key;
+    BOOST_CHECK(!pcursor->Valid() || !pcursor->GetKey(key) || key.first != 's');
+
+    CDiskTxPos pos;
+    BOOST_CHECK(db.ReadTxIndex(txid, pos));
+    bool fTxIndex = false;
+    BOOST_CHECK(db.ReadFlag("txindex", fTxIndex) && fTxIndex);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/** Runs a CIndexesSync on an empty index database in memory, restoring the index settings afterwards */
+struct IndexesSyncSetup : public TestChain100Setup
+{
+    bool fAddressIndexPrev;
+    bool fSpentIndexPrev;
+    bool fTimestampIndexPrev;
+    CScript scriptPubKey;
+
+    IndexesSyncSetup() : fAddressIndexPrev(fAddressIndex), fSpentIndexPrev(fSpentIndex), fTimestampIndexPrev(fTimestampIndex)
+    {
+        fAddressIndex = fSpentIndex = fTimestampIndex = true;
+        pindexesdb = new CIndexesDB(1 << 20, true, true);
+        scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    }
+
+    ~IndexesSyncSetup()
+    {
+        delete pindexesdb;
+        pindexesdb = nullptr;
+        fAddressIndex = fAddressIndexPrev;
+        fSpentIndex = fSpentIndexPrev;
+        fTimestampIndex = fTimestampIndexPrev;
+    }
+
+    // Waits for the first catch up, then for the tip
+    static bool WaitForSync(CIndexesSync& sync)
+    {
+        for (int i = 0; i < 1000 && !sync.IsSynced(); i++)
+            MilliSleep(10);
+        return sync.BlockUntilSyncedToCurrentChain();
+    }
+
+    // Whether the first output of the coinbase is in the unspent index of the key it pays to
+    bool HasUnspentCoinbase(const CTransaction& coinbase)
+    {
+        CTxDestination dest;
+        BOOST_CHECK(ExtractDestination(coinbase.vout[0].scriptPubKey, dest));
+        const CKeyID* keyID = boost::get<CKeyID>(&dest);
+        BOOST_CHECK(keyID);
+
+        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspent;
+        BOOST_CHECK(pindexesdb->ReadAddressUnspentIndex(*keyID, 1, unspent));
+        for (const auto& item : unspent) {
+            if (item.first.txhash == coinbase.GetHash() && item.first.index == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Invalidates the last nBlocks blocks and mines nBlocks + 1 blocks paying to a new key instead, so none of them
+    // is one of the blocks it replaces. Returns the coinbases of the new blocks
+    std::vector<CTransactionRef> Reorg(int nBlocks, std::vector<CTransactionRef>& vStale)
+    {
+        CBlockIndex* pindexFork;
+        vStale.clear();
+        {
+            LOCK(cs_main);
+            pindexFork = chainActive[chainActive.Height() - nBlocks + 1];
+            for (CBlockIndex* pindex = chainActive.Tip(); pindex != pindexFork->pprev; pindex = pindex->pprev) {
+                CBlock block;
+                BOOST_CHECK(ReadBlockFromDisk(block, pindex, GetParams().GetConsensus()));
+                vStale.push_back(block.vtx[0]);
+            }
+        }
+
+        CValidationState state;
+        {
+            LOCK(cs_main);
+            BOOST_CHECK(InvalidateBlock(state, GetParams(), pindexFork));
+        }
+        BOOST_CHECK(ActivateBestChain(state, GetParams()));
+
+        CKey key;
+        key.MakeNewKey(true);
+        CScript scriptNew = CScript() << ToByteVector(key.GetPubKey()) << OP_CHECKSIG;
+
+        std::vector<CTransactionRef> vNew;
+        for (int i = 0; i <= nBlocks; i++)
+            vNew.push_back(CreateAndProcessBlock({}, scriptNew).vtx[0]);
+        return vNew;
+    }
+
+    void CheckSyncedWithTip()
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(pindexesdb->GetBestBlock() == chainActive.Tip()->GetIndexHash());
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(indexes_sync_tests, IndexesSyncSetup)
+
+BOOST_AUTO_TEST_CASE(indexes_sync_catch_up_test)
+{
+    // The indexes start empty behind a chain of 100 blocks
+    CIndexesSync sync;
+    sync.Start();
+    BOOST_CHECK(WaitForSync(sync));
+    BOOST_CHECK_EQUAL(sync.GetBestHeight(), chainActive.Height());
+    CheckSyncedWithTip();
+    for (const CTransaction& coinbase : coinbaseTxns)
+        BOOST_CHECK(HasUnspentCoinbase(coinbase));
+
+    // Blocks connected while running are picked up as well
+    CBlock block = CreateAndProcessBlock({}, scriptPubKey);
+    BOOST_CHECK(sync.BlockUntilSyncedToCurrentChain());
+    CheckSyncedWithTip();
+    BOOST_CHECK(HasUnspentCoinbase(*block.vtx[0]));
+
+    sync.Stop();
+}
+
+BOOST_AUTO_TEST_CASE(indexes_sync_reorg_test)
+{
+    // Indexes left on a branch that was reorganized away while the node was down undo it when they start
+    {
+        CIndexesSync sync;
+        sync.Start();
+        BOOST_CHECK(WaitForSync(sync));
+        sync.Stop();
+    }
+
+    std::vector<CTransactionRef> vStale;
+    std::vector<CTransactionRef> vNew = Reorg(3, vStale);
+
+    CIndexesSync sync;
+    sync.Start();
+    BOOST_CHECK(WaitForSync(sync));
+    CheckSyncedWithTip();
+    for (const CTransactionRef& coinbase : vStale)
+        BOOST_CHECK(!HasUnspentCoinbase(*coinbase));
+    for (const CTransactionRef& coinbase : vNew)
+        BOOST_CHECK(HasUnspentCoinbase(*coinbase));
+
+    // A reorg while the thread is running is followed the same way
+    vNew = Reorg(2, vStale);
+    BOOST_CHECK(sync.BlockUntilSyncedToCurrentChain());
+    CheckSyncedWithTip();
+    for (const CTransactionRef& coinbase : vStale)
+        BOOST_CHECK(!HasUnspentCoinbase(*coinbase));
+    for (const CTransactionRef& coinbase : vNew)
+        BOOST_CHECK(HasUnspentCoinbase(*coinbase));
+
+    sync.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
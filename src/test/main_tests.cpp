@@ -3,9 +3,12 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "chain.h"
 #include "chainparams.h"
 #include "validation.h"
 #include "net.h"
+#include "protocol.h"
+#include "streams.h"
 
 #include "test/test_paladeum.h"
 
@@ -87,4 +90,62 @@ BOOST_FIXTURE_TEST_SUITE(main_tests, TestingSetup)
         BOOST_CHECK(Test());
     }
 
+    /** Writes block as the only record of block file nFile, the way WriteBlockToDisk does unless told otherwise */
+    static CBlockIndex WriteBlockRecord(const CBlock& block, const uint256& hash, int nFile, const CMessageHeader::MessageStartChars& messageStart, unsigned int nSizeOffset)
+    {
+        CAutoFile fileout(OpenBlockFile(CDiskBlockPos(nFile, 0)), SER_DISK, CLIENT_VERSION);
+        BOOST_REQUIRE(!fileout.IsNull());
+
+        unsigned int nSize = GetSerializeSize(fileout, block) + nSizeOffset;
+        fileout << FLATDATA(messageStart) << nSize;
+
+        CBlockIndex index(block);
+        index.phashBlock = &hash;
+        index.nStatus = BLOCK_VALID_TREE | BLOCK_HAVE_DATA;
+        index.nFile = nFile;
+        index.nDataPos = ftell(fileout.Get());
+        fileout << block;
+        return index;
+    }
+
+    BOOST_AUTO_TEST_CASE(read_block_record_test)
+    {
+        BOOST_TEST_MESSAGE("Running Read Block Record Test");
+
+        const CBlock& genesis = GetParams().GenesisBlock();
+        const uint256 hashGenesis = genesis.GetIndexHash();
+        const Consensus::Params& consensusParams = GetParams().GetConsensus();
+        CMessageHeader::MessageStartChars messageStart;
+        memcpy(messageStart, GetParams().MessageStart(), CMessageHeader::MESSAGE_START_SIZE);
+
+        // A record as WriteBlockToDisk writes it is read back without rehashing
+        CBlock block;
+        CBlockIndex index = WriteBlockRecord(genesis, hashGenesis, 1000, messageStart, 0);
+        BOOST_CHECK(ReadBlockFromDisk(block, &index, consensusParams));
+        BOOST_CHECK(block.GetIndexHash() == hashGenesis);
+
+        // A record carrying another network's message start
+        CMessageHeader::MessageStartChars wrongStart;
+        memcpy(wrongStart, messageStart, CMessageHeader::MESSAGE_START_SIZE);
+        wrongStart[0] ^= 0xff;
+        index = WriteBlockRecord(genesis, hashGenesis, 1001, wrongStart, 0);
+        BOOST_CHECK(!ReadBlockFromDisk(block, &index, consensusParams));
+
+        // A record length that isn't the size the block deserialized from
+        index = WriteBlockRecord(genesis, hashGenesis, 1002, messageStart, 1);
+        BOOST_CHECK(!ReadBlockFromDisk(block, &index, consensusParams));
+
+        // A header that isn't the one the index entry was built from
+        index = WriteBlockRecord(genesis, hashGenesis, 1003, messageStart, 0);
+        BOOST_CHECK(ReadBlockFromDisk(block, &index, consensusParams));
+        index.nTime++;
+        BOOST_CHECK(!ReadBlockFromDisk(block, &index, consensusParams));
+        index.nTime--;
+        index.nNonce++;
+        BOOST_CHECK(!ReadBlockFromDisk(block, &index, consensusParams));
+        index.nNonce--;
+        index.hashMerkleRoot = uint256();
+        BOOST_CHECK(!ReadBlockFromDisk(block, &index, consensusParams));
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,66 @@
+// Copyright (c) 2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chain.h"
+#include "pos.h"
+#include "test/test_paladeum.h"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(pos_tests, BasicTestingSetup)
+
+/* The queued kernel search must find the same kernels as checking every candidate in order */
+BOOST_AUTO_TEST_CASE(find_stake_kernel_test)
+{
+    CBlockIndex pindexPrev;
+    pindexPrev.nStakeModifier = InsecureRand256();
+    // Easy enough that several candidates in different ranges hit the first timestamp
+    unsigned int nBits = 0x1c200000;
+    uint32_t nTimeFrom = 1600000000;
+    uint32_t nTimeTo = nTimeFrom + 3 * (STAKE_TIMESTAMP_MASK + 1);
+
+    std::vector<CStakeKernelCandidate> vCandidates;
+    for (int i = 0; i < 1000; i++)
+        vCandidates.emplace_back(COutPoint(InsecureRand256(), InsecureRandBits(2)), (1 + InsecureRandRange(10)) * COIN, nTimeFrom - InsecureRandRange(100000));
+
+    std::vector<size_t> vExpected;
+    uint32_t nTimeExpected = 0;
+    for (uint32_t nTime = nTimeFrom; nTime <= nTimeTo && vExpected.empty(); nTime += STAKE_TIMESTAMP_MASK + 1) {
+        for (size_t i = 0; i < vCandidates.size(); i++) {
+            if (CheckStakeKernelHash(&pindexPrev, nBits, vCandidates[i].amount, vCandidates[i].prevout, nTime, vCandidates[i].nTime)) {
+                vExpected.push_back(i);
+                nTimeExpected = nTime;
+            }
+        }
+    }
+    BOOST_CHECK(vExpected.size() > 1);
+    BOOST_CHECK(vExpected.front() / STAKE_KERNEL_CANDIDATES_PER_CHECK != vExpected.back() / STAKE_KERNEL_CANDIDATES_PER_CHECK);
+
+    // Once on the calling thread alone, then twice with the same workers
+    boost::thread_group threadGroup;
+    for (int nRun = 0; nRun < 3; nRun++) {
+        if (nRun == 1) {
+            for (int i = 0; i < 3; i++)
+                threadGroup.create_thread(&ThreadStakeKernelSearch);
+        }
+
+        std::vector<size_t> vKernels;
+        uint32_t nTime = 0;
+        BOOST_CHECK(FindStakeKernel(&pindexPrev, nBits, vCandidates, nTimeFrom, nTimeTo, vKernels, nTime));
+        BOOST_CHECK(vKernels == vExpected);
+        BOOST_CHECK_EQUAL(nTime, nTimeExpected);
+    }
+
+    // Nothing to find in an empty range
+    std::vector<size_t> vKernels;
+    uint32_t nTime = 0;
+    BOOST_CHECK(!FindStakeKernel(&pindexPrev, nBits, vCandidates, nTimeTo, nTimeFrom, vKernels, nTime));
+    BOOST_CHECK(vKernels.empty());
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
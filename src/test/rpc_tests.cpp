@@ -9,6 +9,8 @@
 #include "base58.h"
 #include "core_io.h"
 #include "netbase.h"
+#include "random.h"
+#include "txdb.h"
 
 #include "test/test_paladeum.h"
 
@@ -390,4 +392,139 @@ BOOST_FIXTURE_TEST_SUITE(rpc_tests, TestingSetup)
         BOOST_CHECK_EQUAL(result[2].get_int(), 9);
     }
 
+    BOOST_AUTO_TEST_CASE(rpc_convert_values_addressindex_test)
+    {
+        BOOST_TEST_MESSAGE("Running RPC Convert Values Address Index Test");
+
+        UniValue result;
+
+        // A plain address stays a string
+        BOOST_CHECK_NO_THROW(result = RPCConvertValues("getaddresstxids", {"mkESjLZW66TmHhiFX8MCaBjrhZ543PPh9a", "true"}));
+        BOOST_CHECK_EQUAL(result[0].get_str(), "mkESjLZW66TmHhiFX8MCaBjrhZ543PPh9a");
+        BOOST_CHECK_EQUAL(result[1].get_bool(), true);
+
+        BOOST_CHECK_NO_THROW(result = RPCConvertValues("getaddressutxos", {"mkESjLZW66TmHhiFX8MCaBjrhZ543PPh9a", "TOKEN"}));
+        BOOST_CHECK_EQUAL(result[0].get_str(), "mkESjLZW66TmHhiFX8MCaBjrhZ543PPh9a");
+        BOOST_CHECK_EQUAL(result[1].get_str(), "TOKEN");
+
+        BOOST_CHECK_NO_THROW(result = RPCConvertNamedValues("getaddressdeltas", {"address=mkESjLZW66TmHhiFX8MCaBjrhZ543PPh9a"}));
+        BOOST_CHECK_EQUAL(find_value(result.get_obj(), "address").get_str(), "mkESjLZW66TmHhiFX8MCaBjrhZ543PPh9a");
+
+        // And an object of addresses is converted
+        BOOST_CHECK_NO_THROW(result = RPCConvertValues("getaddresstxids", {"{\"addresses\": [\"mkESjLZW66TmHhiFX8MCaBjrhZ543PPh9a\"], \"limit\": 10}"}));
+        BOOST_CHECK_EQUAL(find_value(result[0].get_obj(), "limit").get_int(), 10);
+
+        // The other converted params still have to be valid JSON
+        BOOST_CHECK_THROW(RPCConvertValues("getaddresstxids", {"mkESjLZW66TmHhiFX8MCaBjrhZ543PPh9a", "yes"}), std::runtime_error);
+    }
+
+    /** Concatenates the pages of an address index call, resuming from each cursor until there is none */
+    static std::vector<UniValue> ReadPages(const std::string& strMethod, const std::string& strAddresses, const std::string& strExtra,
+                                           int nLimit, const std::string& strEntries, const std::string& strArgs = "")
+    {
+        std::vector<UniValue> vEntries;
+        std::string cursor;
+        for (int nPages = 0; nPages < 100; nPages++) {
+            std::string strParam = "{\"addresses\":" + strAddresses + strExtra + ",\"limit\":" + std::to_string(nLimit);
+            if (!cursor.empty())
+                strParam += ",\"cursor\":\"" + cursor + "\"";
+            UniValue page = CallRPC(strMethod + " " + strParam + "}" + strArgs);
+
+            const UniValue& entries = find_value(page.get_obj(), strEntries);
+            BOOST_CHECK((int)entries.size() <= nLimit);
+            for (unsigned int i = 0; i < entries.size(); i++)
+                vEntries.push_back(entries[i]);
+
+            const UniValue& cursorValue = find_value(page.get_obj(), "cursor");
+            if (cursorValue.isNull())
+                return vEntries;
+            BOOST_CHECK(!entries.empty());
+            cursor = cursorValue.get_str();
+        }
+        BOOST_ERROR("Paging " + strMethod + " didn't end");
+        return vEntries;
+    }
+
+    BOOST_AUTO_TEST_CASE(rpc_addressindex_paging_test)
+    {
+        BOOST_TEST_MESSAGE("Running RPC Address Index Paging Test");
+
+        bool fAddressIndexPrev = fAddressIndex;
+        fAddressIndex = true;
+        CIndexesDB* pindexesdbPrev = pindexesdb;
+        pindexesdb = new CIndexesDB(1 << 20, true, true);
+
+        uint160 hashA = uint160(std::vector<unsigned char>(20, 0x0a));
+        uint160 hashB = uint160(std::vector<unsigned char>(20, 0x0b));
+        std::string addressA = EncodeDestination(CKeyID(hashA));
+        std::string addressB = EncodeDestination(CKeyID(hashB));
+
+        // Transactions moving PLB and a token between both addresses, several to a block and several to a
+        // transaction, so the same transaction is in the index under both addresses and both tokens
+        std::vector<uint256> txids;
+        for (int i = 0; i < 8; i++)
+            txids.push_back(InsecureRand256());
+
+        std::vector<std::pair<CAddressIndexKey, CAmount> > vEntries;
+        auto add = [&](const uint160& hash, const std::string& token, int nHeight, int nTx, int nOutput, CAmount nValue) {
+            vEntries.push_back(std::make_pair(CAddressIndexKey(1, hash, token, nHeight, nTx, txids[nHeight * 2 + nTx - 3], nOutput, nValue < 0), nValue));
+        };
+        add(hashA, PLB, 1, 1, 0, 5 * COIN);
+        add(hashA, PLB, 1, 1, 1, -3 * COIN);
+        add(hashA, "TOKEN", 1, 2, 0, 100);
+        add(hashB, PLB, 1, 2, 1, COIN);
+        add(hashB, PLB, 2, 1, 0, 2 * COIN);
+        add(hashA, PLB, 2, 2, 0, -COIN);
+        add(hashA, "TOKEN", 2, 2, 1, -50);
+        add(hashB, "TOKEN", 2, 2, 2, 50);
+        add(hashA, "TOKEN", 3, 1, 0, 10);
+        add(hashB, PLB, 3, 2, 0, COIN);
+        add(hashA, PLB, 3, 2, 1, COIN);
+        add(hashA, PLB, 4, 1, 0, COIN);
+        add(hashB, "TOKEN", 4, 2, 0, 10);
+        BOOST_CHECK(pindexesdb->WriteAddressIndex(vEntries));
+
+        std::string strBoth = "[\"" + addressA + "\",\"" + addressB + "\"]";
+        std::string strA = "[\"" + addressA + "\"]";
+
+        for (int nLimit = 1; nLimit <= 9; nLimit++) {
+            // Each transaction is listed once across the pages, in block order, and they are all the unpaged call lists
+            std::vector<UniValue> vPaged = ReadPages("getaddresstxids", strBoth, "", nLimit, "txids", " true");
+            UniValue unpaged = CallRPC("getaddresstxids {\"addresses\":" + strBoth + "} true");
+            std::set<std::string> setPaged;
+            std::vector<std::string> vOrder;
+            for (const UniValue& txid : vPaged) {
+                BOOST_CHECK(setPaged.insert(txid.get_str()).second);
+                vOrder.push_back(txid.get_str());
+            }
+            BOOST_CHECK_EQUAL(setPaged.size(), txids.size());
+            std::set<std::string> setUnpaged;
+            for (unsigned int i = 0; i < unpaged.size(); i++)
+                setUnpaged.insert(unpaged[i].get_str());
+            BOOST_CHECK(setPaged == setUnpaged);
+            for (unsigned int i = 0; i < vOrder.size(); i++)
+                BOOST_CHECK_EQUAL(vOrder[i], txids[i].GetHex());
+
+            // A single address without tokens pages through exactly what the unpaged call lists
+            vPaged = ReadPages("getaddresstxids", strA, "", nLimit, "txids");
+            unpaged = CallRPC("getaddresstxids {\"addresses\":" + strA + "}");
+            BOOST_CHECK_EQUAL(vPaged.size(), unpaged.size());
+            for (unsigned int i = 0; i < vPaged.size() && i < unpaged.size(); i++)
+                BOOST_CHECK_EQUAL(vPaged[i].get_str(), unpaged[i].get_str());
+
+            // The deltas of both addresses page through the unpaged ones in the same order
+            for (const std::string& strToken : {std::string(), std::string(",\"tokenName\":\"TOKEN\"")}) {
+                vPaged = ReadPages("getaddressdeltas", strBoth, strToken, nLimit, "deltas");
+                unpaged = CallRPC("getaddressdeltas {\"addresses\":" + strBoth + strToken + "}");
+                BOOST_CHECK_EQUAL(vPaged.size(), unpaged.size());
+                for (unsigned int i = 0; i < vPaged.size() && i < unpaged.size(); i++)
+                    BOOST_CHECK_EQUAL(vPaged[i].write(), unpaged[i].write());
+            }
+        }
+
+        delete pindexesdb;
+        pindexesdb = pindexesdbPrev;
+        fAddressIndex = fAddressIndexPrev;
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include "chainparams.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
+#include "crypto/blake2b_header.h"
 #include "crypto/sha256.h"
 #include "fs.h"
 #include "key.h"
@@ -22,6 +23,8 @@
 #include "rpc/server.h"
 #include "rpc/register.h"
 #include "script/sigcache.h"
+#include "tokens/restricteddb.h"
+#include "tokens/tokendb.h"
 
 #include <memory>
 
@@ -34,6 +37,7 @@ extern void noui_connect();
 BasicTestingSetup::BasicTestingSetup(const std::string &chainName)
 {
     SHA256AutoDetect();
+    Blake2bAutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
@@ -73,12 +77,17 @@ TestingSetup::TestingSetup(const std::string &chainName) : BasicTestingSetup(cha
     pblocktree = new CBlockTreeDB(1 << 20, true);
     pcoinsdbview = new CCoinsViewDB(1 << 23, true);
     pcoinsTip = new CCoinsViewCache(pcoinsdbview);
+    governance = new CGovernance(1 << 20, true, true);
+    governance->Init(true, chainparams);
+    pgovernanceTip = new CGovernanceCache(governance);
     if (!LoadGenesisBlock(chainparams))
     {
         throw std::runtime_error("LoadGenesisBlock failed.");
     }
 
     ptokens = new CTokensCache();
+    ptokensdb = new CTokensDB(1 << 20, true);
+    prestricteddb = new CRestrictedDB(1 << 20, true);
     {
         CValidationState state;
         if (!ActivateBestChain(state, chainparams))
@@ -105,8 +114,16 @@ TestingSetup::~TestingSetup()
     UnloadBlockIndex();
     delete pcoinsTip;
     delete pcoinsdbview;
+    delete pgovernanceTip;
+    pgovernanceTip = nullptr;
+    delete governance;
+    governance = nullptr;
     delete pblocktree;
     delete ptokens;
+    delete ptokensdb;
+    ptokensdb = nullptr;
+    delete prestricteddb;
+    prestricteddb = nullptr;
     fs::remove_all(pathTemp);
 }
 
@@ -138,6 +155,13 @@ TestChain100Setup::CreateAndProcessBlock(const std::vector<CMutableTransaction>
     block.vtx.resize(1);
     for (const CMutableTransaction &tx : txns)
         block.vtx.push_back(MakeTransactionRef(tx));
+    // The witness commitment of the template only covered its own txns
+    CMutableTransaction coinbaseTx(*block.vtx[0]);
+    int commitpos = GetWitnessCommitmentIndex(block);
+    if (commitpos != -1)
+        coinbaseTx.vout.erase(coinbaseTx.vout.begin() + commitpos);
+    block.vtx[0] = MakeTransactionRef(std::move(coinbaseTx));
+    GenerateCoinbaseCommitment(block, chainActive.Tip(), chainparams.GetConsensus());
     // IncrementExtraNonce creates a valid coinbase and merkleRoot
     unsigned int extraNonce = 0;
     IncrementExtraNonce(&block, chainActive.Tip(), extraNonce);
@@ -1,40 +1,238 @@
 
 #include "tokens/tokens.h"
+#include "validation.h"
 #include <boost/test/unit_test.hpp>
 #include <test/test_paladeum.h>
 
 BOOST_FIXTURE_TEST_SUITE(cache_tests, BasicTestingSetup)
 
 
-    const int NUM_OF_TOKENS1 = 100000;
-
 BOOST_AUTO_TEST_CASE(cache_test)
 {
     BOOST_TEST_MESSAGE("Running Cache Test");
 
-    CLRUCache<std::string, CNewToken> cache(NUM_OF_TOKENS1);
+    // A single shard, so the least recently used entry of the whole cache is the one evicted
+    CLRUCache<std::string, CNewToken> cache(1 << 20, 1);
 
     std::string tokenName = "TEST";
 
     int counter = 0;
-    while(cache.Size() != NUM_OF_TOKENS1)
+    uint64_t nHits, nMisses, nEvictions = 0;
+    while (!nEvictions)
     {
-        CNewToken token(std::string(tokenName + std::to_string(counter)), CAmount(1), 0, 0, 1, "43f81c6f2c0593bde5a85e09ae662816eca80797");
+        CNewToken token(std::string(tokenName + std::to_string(counter)), CAmount(1));
 
         cache.Put(token.strName, token);
         counter++;
+        cache.GetStats(nHits, nMisses, nEvictions);
     }
 
-    BOOST_CHECK_MESSAGE(cache.Exists("TEST0"), "Didn't have TEST0");
+    BOOST_CHECK_MESSAGE(cache.DynamicMemoryUsage() <= cache.MaxSize() + (1 << 16), "Cache went over its memory limit");
+    BOOST_CHECK_MESSAGE(!cache.Exists("TEST0"), "Cache didn't remove the least recently used");
+    BOOST_CHECK_MESSAGE(cache.Exists("TEST1"), "Cache didn't have TEST1");
 
-    CNewToken token("THISWILLOVERWRITE", CAmount(1), 0, 0, 1, "43f81c6f2c0593bde5a85e09ae662816eca80797");
+    // Using TEST1 makes TEST2 the least recently used
+    CNewToken token;
+    BOOST_CHECK(cache.TryGet("TEST1", token));
+    BOOST_CHECK_EQUAL(token.strName, "TEST1");
 
-    cache.Put(token.strName, token);
+    CNewToken newToken("THISWILLOVERWRITE", CAmount(1));
+    cache.Put(newToken.strName, newToken);
 
     BOOST_CHECK_MESSAGE(cache.Exists("THISWILLOVERWRITE"), "New token wasn't added to cache");
-    BOOST_CHECK_MESSAGE(!cache.Exists("TEST0"), "Cache didn't remove the least recently used");
-    BOOST_CHECK_MESSAGE(cache.Exists("TEST1"), "Cache didn't have TEST1");
+    BOOST_CHECK_MESSAGE(cache.Exists("TEST1"), "Cache removed the recently used TEST1");
+    BOOST_CHECK_MESSAGE(!cache.Exists("TEST2"), "Cache didn't remove the least recently used");
+
+    // Missing entries are told apart from entries that aren't cached
+    bool fMissing = false;
+    cache.PutMissing("MISSING");
+    BOOST_CHECK(!cache.TryGet("MISSING", token));
+    BOOST_CHECK(cache.TryGet("MISSING", token, fMissing) && fMissing);
+    BOOST_CHECK(!cache.TryGet("NOTCACHED", token, fMissing));
+
+    cache.Put(newToken.strName, newToken);
+    cache.Erase(newToken.strName);
+    BOOST_CHECK(!cache.Exists(newToken.strName));
+
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.Size(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(cache_small_size_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Small Size Test");
+
+    // A budget smaller than a single entry per shard still keeps the entry last inserted in each shard
+    CLRUCache<std::string, CNewToken> cache(100);
+    CNewToken token;
+    for (int i = 0; i < 64; i++) {
+        CNewToken newToken("SMALLCACHE" + std::to_string(i), CAmount(1));
+        cache.Put(newToken.strName, newToken);
+        BOOST_CHECK(cache.TryGet(newToken.strName, token));
+        BOOST_CHECK_EQUAL(token.strName, newToken.strName);
+    }
+
+    uint64_t nHits, nMisses, nEvictions;
+    cache.GetStats(nHits, nMisses, nEvictions);
+    BOOST_CHECK_EQUAL(nHits, 64U);
+    BOOST_CHECK(cache.Size() <= DEFAULT_LRU_CACHE_SHARDS);
+
+    cache.PutMissing("SMALLCACHEMISSING");
+    bool fMissing = false;
+    BOOST_CHECK(cache.TryGet("SMALLCACHEMISSING", token, fMissing) && fMissing);
+}
+
+BOOST_AUTO_TEST_CASE(cache_memory_usage_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Memory Usage Test");
+
+    CTokensCache cache;
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+
+    // Strings too long to be kept inside the string object are counted too
+    std::string strLongName = "$GLOBAL_RESTRICTION_WITH_A_LONG_NAME";
+    CTokensCache shortCache;
+    shortCache.AddGlobalRestricted("$SHORT", RestrictedType::GLOBAL_FREEZE);
+    cache.AddGlobalRestricted(strLongName, RestrictedType::GLOBAL_FREEZE);
+    BOOST_CHECK(cache.GetCacheSize() > shortCache.GetCacheSize());
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), cache.GetCacheSize());
+
+    // Balances are part of the total but aren't dirty entries
+    size_t nDirty = cache.GetCacheSize();
+    cache.mapTokensAddressAmount[std::make_pair(strLongName, CTokenAddress())] = 1;
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), nDirty);
+    BOOST_CHECK(cache.DynamicMemoryUsage() > nDirty);
+
+    cache.ClearDirtyCache();
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), 0U);
+}
 
+BOOST_AUTO_TEST_CASE(cache_memory_tracking_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Memory Tracking Test");
+
+    // The usage is added up at the insert and erase points, so it has to match walking the entries
+    typedef std::map<CTokenCacheRootQualifierChecker, std::set<std::string> > RootMap;
+    CTokenCacheMap<CTokenCacheRootQualifierChecker, std::set<std::string> > mapRoot;
+    auto fnWalk = [](const RootMap& entries) {
+        size_t usage = memusage::DynamicUsage(entries);
+        for (const auto& item : entries)
+            usage += RecursiveDynamicUsage(item);
+        return usage;
+    };
+
+    std::string strFirst = "#ROOT_QUALIFIER_WITH_A_LONG_NAME/#FIRST_SUB_QUALIFIER";
+    std::string strSecond = "#ROOT_QUALIFIER_WITH_A_LONG_NAME/#SECOND_SUB_QUALIFIER";
+    CTokenCacheRootQualifierChecker checker("#ROOT_QUALIFIER_WITH_A_LONG_NAME", CTokenAddress());
+
+    mapRoot.Modify(checker, [&strFirst](std::set<std::string>& tokens) { tokens.insert(strFirst); });
+    BOOST_CHECK_EQUAL(mapRoot.DynamicMemoryUsage(), fnWalk(mapRoot));
+    mapRoot.Modify(checker, [&strSecond](std::set<std::string>& tokens) { tokens.insert(strSecond); });
+    BOOST_CHECK_EQUAL(mapRoot.DynamicMemoryUsage(), fnWalk(mapRoot));
+    mapRoot.Modify(checker, [&strFirst](std::set<std::string>& tokens) { tokens.erase(strFirst); });
+    BOOST_CHECK_EQUAL(mapRoot.DynamicMemoryUsage(), fnWalk(mapRoot));
+
+    CTokenCacheMap<CTokenCacheRootQualifierChecker, std::set<std::string> > mapCopy(mapRoot);
+    BOOST_CHECK_EQUAL(mapCopy.DynamicMemoryUsage(), mapRoot.DynamicMemoryUsage());
+
+    BOOST_CHECK_EQUAL(mapRoot.erase(checker), 1U);
+    BOOST_CHECK_EQUAL(mapRoot.DynamicMemoryUsage(), 0U);
+
+    // Values replaced through Set are counted again
+    CTokenCacheMap<std::string, CNewToken> mapReissued;
+    CNewToken token("REISSUED", 1000);
+    mapReissued.Set(token.strName, token);
+    size_t nUsage = mapReissued.DynamicMemoryUsage();
+    token.strIPFSHash = std::string(46, 'Q');
+    mapReissued.Set(token.strName, token);
+    BOOST_CHECK(mapReissued.DynamicMemoryUsage() > nUsage);
+    mapReissued.erase(token.strName);
+    BOOST_CHECK_EQUAL(mapReissued.DynamicMemoryUsage(), 0U);
+
+    // Inserting an entry twice or erasing a missing one leaves the usage alone
+    CTokenCacheSet<CTokenCacheRestrictedGlobal> setGlobal;
+    CTokenCacheRestrictedGlobal global("$GLOBAL_RESTRICTION_WITH_A_LONG_NAME", RestrictedType::GLOBAL_FREEZE);
+    setGlobal.insert(global);
+    nUsage = setGlobal.DynamicMemoryUsage();
+    BOOST_CHECK(nUsage > 0);
+    setGlobal.insert(global);
+    BOOST_CHECK_EQUAL(setGlobal.DynamicMemoryUsage(), nUsage);
+    BOOST_CHECK_EQUAL(setGlobal.erase(CTokenCacheRestrictedGlobal("$MISSING", RestrictedType::GLOBAL_FREEZE)), 0U);
+    BOOST_CHECK_EQUAL(setGlobal.DynamicMemoryUsage(), nUsage);
+    setGlobal.erase(global);
+    BOOST_CHECK_EQUAL(setGlobal.DynamicMemoryUsage(), 0U);
+}
+
+BOOST_FIXTURE_TEST_CASE(cache_view_test, TestingSetup)
+{
+    BOOST_TEST_MESSAGE("Running Cache View Test");
+
+    CTokensCache view(ptokens);
+    CTokensCache childView(&view);
+    BOOST_CHECK(view.GetParent() == ptokens);
+    BOOST_CHECK(childView.GetParent() == &view);
+    BOOST_CHECK(ptokens->GetParent() == nullptr);
+
+    // Changes of the global cache are seen through both views
+    ptokens->AddGlobalRestricted("$GLOBAL", RestrictedType::GLOBAL_FREEZE);
+    BOOST_CHECK(childView.CheckForGlobalRestriction("$GLOBAL"));
+    BOOST_CHECK(childView.CheckForGlobalRestriction("$GLOBAL", true));
+
+    // Changes of a view are only seen from it and the views on top of it
+    view.AddGlobalRestricted("$VIEW", RestrictedType::GLOBAL_FREEZE);
+    BOOST_CHECK(childView.CheckForGlobalRestriction("$VIEW"));
+    BOOST_CHECK(!childView.CheckForGlobalRestriction("$VIEW", true));
+    BOOST_CHECK(!ptokens->CheckForGlobalRestriction("$VIEW"));
+
+    // A view only records its own changes, and removing in a view hides the entry of its parent
+    childView.RemoveGlobalRestricted("$VIEW", RestrictedType::GLOBAL_FREEZE);
+    BOOST_CHECK(childView.setNewRestrictedGlobalToAdd.empty());
+    BOOST_CHECK(!childView.CheckForGlobalRestriction("$VIEW"));
+    BOOST_CHECK(view.CheckForGlobalRestriction("$VIEW"));
+
+    // Flushing merges into the parent view, not the global cache
+    BOOST_CHECK(childView.Flush());
+    BOOST_CHECK(!view.CheckForGlobalRestriction("$VIEW"));
+    BOOST_CHECK(!ptokens->setNewRestrictedGlobalToRemove.size());
+
+    BOOST_CHECK(view.Flush());
+    BOOST_CHECK_EQUAL(ptokens->setNewRestrictedGlobalToRemove.size(), 1U);
+}
+
+BOOST_FIXTURE_TEST_CASE(cache_view_nearest_change_test, TestingSetup)
+{
+    BOOST_TEST_MESSAGE("Running Cache View Nearest Change Test");
+
+    CTokensCache view(ptokens);
+    CTokensCache childView(&view);
+    CTokensCache grandchildView(&childView);
+
+    // The view nearest to the lookup decides, even when a view below it removed the entry
+    CNewToken token;
+    token.strName = "LAYERED";
+    token.nAmount = 100 * COIN;
+    BOOST_CHECK(view.AddNewToken(token, CTokenAddress(), 1, uint256()));
+    BOOST_CHECK(childView.RemoveNewToken(token, CTokenAddress()));
+    BOOST_CHECK(!grandchildView.CheckIfTokenExists("LAYERED", true));
+    BOOST_CHECK(grandchildView.AddNewToken(token, CTokenAddress(), 2, uint256()));
+    BOOST_CHECK(grandchildView.CheckIfTokenExists("LAYERED", true));
+    BOOST_CHECK(!childView.CheckIfTokenExists("LAYERED", true));
+    BOOST_CHECK(view.CheckIfTokenExists("LAYERED", true));
+
+    CNewToken tokenRet;
+    int nHeight = 0;
+    uint256 blockHash;
+    BOOST_CHECK(grandchildView.GetTokenMetaDataIfExists("LAYERED", tokenRet, nHeight, blockHash));
+    BOOST_CHECK_EQUAL(nHeight, 2);
+    BOOST_CHECK(!childView.GetTokenMetaDataIfExists("LAYERED", tokenRet));
+
+    // Same for the restrictions, a freeze in the child wins over an undone freeze in its parent
+    view.RemoveGlobalRestricted("$LAYERED", RestrictedType::GLOBAL_FREEZE);
+    childView.AddGlobalRestricted("$LAYERED", RestrictedType::GLOBAL_FREEZE);
+    BOOST_CHECK(!view.CheckForGlobalRestriction("$LAYERED"));
+    BOOST_CHECK(childView.CheckForGlobalRestriction("$LAYERED"));
+    BOOST_CHECK(grandchildView.CheckForGlobalRestriction("$LAYERED"));
 }
 
 BOOST_AUTO_TEST_SUITE_END()
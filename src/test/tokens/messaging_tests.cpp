@@ -12,6 +12,13 @@
 #include <base58.h>
 #include <chainparams.h>
 #include "consensus/consensus.h"
+#include <tokens/messages.h>
+#include <tokens/mytokensdb.h>
+#include <validation.h>
+
+#ifdef ENABLE_WALLET
+#include <wallet/wallet.h>
+#endif
 
 
 BOOST_FIXTURE_TEST_SUITE(messaging_tests, BasicTestingSetup)
@@ -20,7 +27,7 @@ BOOST_FIXTURE_TEST_SUITE(messaging_tests, BasicTestingSetup)
     {
         std::string error = "";
 
-        CTokenTransfer transfer1("TOKEN", 1 * COIN, DecodeTokenData("QmRAQB6YaCyidP37UdDnjFY5vQuiBrcqdyoW1CuDgwxkD4"));
+        CTokenTransfer transfer1("TOKEN", 1 * COIN, 0, DecodeTokenData("QmRAQB6YaCyidP37UdDnjFY5vQuiBrcqdyoW1CuDgwxkD4"));
         BOOST_CHECK_MESSAGE(transfer1.IsValid(error), "Transfer Valid Test 1 - failed -" + error);
 
         // TODO Once Messages are active
@@ -28,19 +35,19 @@ BOOST_FIXTURE_TEST_SUITE(messaging_tests, BasicTestingSetup)
 //        BOOST_CHECK_MESSAGE(transfer2.IsValid(error), "Transfer Valid Test 2 - failed -" + error);
 
         // Token transfer is Zero failure
-        CTokenTransfer transfer3("TOKEN", 0);
+        CTokenTransfer transfer3("TOKEN", 0, 0);
         BOOST_CHECK_MESSAGE(!transfer3.IsValid(error), "Transfer Valid Test 3 did not fail");
 
         // empty message with an expiration date failure
         std::string message = "";
         int64_t date = 15555555;
-        CTokenTransfer transfer4("TOKEN", 1 * COIN, message, date);
+        CTokenTransfer transfer4("TOKEN", 1 * COIN, 0, message, date);
         transfer4.nExpireTime = date;
         BOOST_CHECK_MESSAGE(!transfer4.IsValid(error), "Transfer Valid Test 4 did not fail");
 
         // negative expiration date failure
         int64_t date2 = -1;
-        CTokenTransfer transfer5("TOKEN", 1 * COIN, message, date2);
+        CTokenTransfer transfer5("TOKEN", 1 * COIN, 0, message, date2);
         transfer5.nExpireTime = date2;
         BOOST_CHECK_MESSAGE(!transfer5.IsValid(error), "Transfer Valid Test 5 did not fail");
 
@@ -77,5 +84,251 @@ BOOST_FIXTURE_TEST_SUITE(messaging_tests, BasicTestingSetup)
 
     }
 
+    BOOST_AUTO_TEST_CASE(message_channel_db_flush_test)
+    {
+        BOOST_TEST_MESSAGE("Running Message Channel DB Flush Test");
+
+        CMessageChannelDB db(1 << 20, true, true);
+        CMessageChannelDB* pmessagechanneldbPrev = pmessagechanneldb;
+        pmessagechanneldb = &db;
+        setDirtyChannelsAdd.clear();
+        setDirtyChannelsRemove.clear();
+        setDirtySeenAddressAdd.clear();
+        setSubscribedChannels.clear();
+        setSeenAddresses.clear();
+
+        // Every channel and address in the database, as the startup load finds them
+        auto CheckLoaded = [&db]() {
+            std::unordered_set<std::string> setChannels;
+            std::unordered_set<std::string> setAddresses;
+            BOOST_CHECK(db.LoadMyMessageChannels(setChannels));
+            BOOST_CHECK(db.LoadUsedAddresses(setAddresses));
+            BOOST_CHECK(setChannels == setSubscribedChannels);
+            BOOST_CHECK(setAddresses == setSeenAddresses);
+        };
+
+        // Subscribing is visible before the flush and only reaches the loaded sets with it
+        AddChannel("AAA!");
+        AddChannel("BBB~NEWS");
+        AddAddressSeen("address1");
+        BOOST_CHECK(IsChannelSubscribed("AAA!"));
+        BOOST_CHECK(IsAddressSeen("address1"));
+        BOOST_CHECK(setSubscribedChannels.empty());
+        BOOST_CHECK(setSeenAddresses.empty());
+
+        BOOST_CHECK(db.Flush());
+        BOOST_CHECK(setDirtyChannelsAdd.empty() && setDirtySeenAddressAdd.empty());
+        BOOST_CHECK(setSubscribedChannels == std::unordered_set<std::string>({"AAA!", "BBB~NEWS"}));
+        BOOST_CHECK(setSeenAddresses == std::unordered_set<std::string>({"address1"}));
+        BOOST_CHECK(db.ReadMyMessageChannel("AAA!"));
+        BOOST_CHECK(db.ReadUsedAddress("address1"));
+        BOOST_CHECK(IsChannelSubscribed("BBB~NEWS"));
+        BOOST_CHECK(IsAddressSeen("address1"));
+        BOOST_CHECK(!IsChannelSubscribed("CCC!"));
+        BOOST_CHECK(!IsAddressSeen("address2"));
+        CheckLoaded();
+
+        // Unsubscribing hides the channel before the flush and drops it from the database and the set with it
+        RemoveChannel("AAA!");
+        BOOST_CHECK(!IsChannelSubscribed("AAA!"));
+        BOOST_CHECK(setSubscribedChannels.count("AAA!"));
+
+        // Removing and adding again before the flush keeps the channel
+        RemoveChannel("BBB~NEWS");
+        AddChannel("BBB~NEWS");
+        AddChannel("CCC!");
+        AddAddressSeen("address2");
+
+        BOOST_CHECK(db.Flush());
+        BOOST_CHECK(setDirtyChannelsRemove.empty());
+        BOOST_CHECK(setSubscribedChannels == std::unordered_set<std::string>({"BBB~NEWS", "CCC!"}));
+        BOOST_CHECK(setSeenAddresses == std::unordered_set<std::string>({"address1", "address2"}));
+        BOOST_CHECK(!db.ReadMyMessageChannel("AAA!"));
+        BOOST_CHECK(!IsChannelSubscribed("AAA!"));
+        BOOST_CHECK(IsChannelSubscribed("BBB~NEWS"));
+        CheckLoaded();
+
+        // A restart rebuilds the sets from the database alone
+        std::unordered_set<std::string> setChannelsFlushed = setSubscribedChannels;
+        std::unordered_set<std::string> setAddressesFlushed = setSeenAddresses;
+        setSubscribedChannels.clear();
+        setSeenAddresses.clear();
+        BOOST_CHECK(db.LoadMyMessageChannels(setSubscribedChannels));
+        BOOST_CHECK(db.LoadUsedAddresses(setSeenAddresses));
+        BOOST_CHECK(setSubscribedChannels == setChannelsFlushed);
+        BOOST_CHECK(setSeenAddresses == setAddressesFlushed);
+        BOOST_CHECK(IsChannelSubscribed("CCC!"));
+        BOOST_CHECK(IsAddressSeen("address2"));
+
+        setSubscribedChannels.clear();
+        setSeenAddresses.clear();
+        pmessagechanneldb = pmessagechanneldbPrev;
+    }
+
+#ifdef ENABLE_WALLET
+    // Subscribes the way ScanForMessageChannels did when it read every block of the active chain
+    static void ScanBlocksForMessageChannels(const CWallet& wallet, const std::vector<CBlock>& vBlocks, std::set<std::string>& setChannels, std::set<std::string>& setAddresses)
+    {
+        for (const CBlock& block : vBlocks) {
+            for (const auto& tx : block.vtx) {
+                for (const CTxOut& out : tx->vout) {
+                    CTokenOutputEntry tokenData;
+                    if (wallet.IsMine(out) != ISMINE_SPENDABLE || !GetTokenData(out.scriptPubKey, tokenData))
+                        continue;
+
+                    KnownTokenType type;
+                    IsTokenNameValid(tokenData.tokenName, type);
+                    std::string address = EncodeDestination(tokenData.destination);
+
+                    if (tokenData.type == TX_TRANSFER_TOKEN) {
+                        if (type == KnownTokenType::MSGCHANNEL || type == KnownTokenType::OWNER) {
+                            setChannels.insert(tokenData.tokenName);
+                            setAddresses.insert(address);
+                        } else if (type == KnownTokenType::ROOT || type == KnownTokenType::SUB) {
+                            if (!setChannels.count(tokenData.tokenName + OWNER_TAG) && !setAddresses.count(address)) {
+                                setChannels.insert(tokenData.tokenName + OWNER_TAG);
+                                setAddresses.insert(address);
+                            }
+                        }
+                    } else if (tokenData.type == TX_NEW_TOKEN || tokenData.type == TX_REISSUE_TOKEN) {
+                        if (type == KnownTokenType::OWNER || type == KnownTokenType::MSGCHANNEL) {
+                            setChannels.insert(tokenData.tokenName);
+                            setAddresses.insert(address);
+                        } else if (type == KnownTokenType::ROOT || type == KnownTokenType::SUB || type == KnownTokenType::RESTRICTED) {
+                            setChannels.insert(tokenData.tokenName + "!");
+                            setAddresses.insert(address);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(scan_for_message_channels_test)
+    {
+        BOOST_TEST_MESSAGE("Running Scan For Message Channels Test");
+
+        CMessageChannelDB db(1 << 20, true, true);
+        CMessageChannelDB* pmessagechanneldbPrev = pmessagechanneldb;
+        pmessagechanneldb = &db;
+        setDirtyChannelsAdd.clear();
+        setDirtyChannelsRemove.clear();
+        setDirtySeenAddressAdd.clear();
+        setSubscribedChannels.clear();
+        setSeenAddresses.clear();
+
+        CWallet wallet;
+        vpwallets.insert(vpwallets.begin(), &wallet);
+
+        std::vector<CScript> vScripts;
+        for (int i = 0; i < 5; i++) {
+            CKey key;
+            key.MakeNewKey(true);
+            vScripts.push_back(GetScriptForDestination(key.GetPubKey().GetID()));
+            if (i < 4) // The last one belongs to another wallet
+                wallet.AddKeyPubKey(key, key.GetPubKey());
+        }
+        const CScript& scriptOther = vScripts[4];
+
+        auto Transfer = [](const std::string& name, const CScript& script) {
+            CScript scriptPubKey = script;
+            CTokenTransfer(name, 1 * COIN, 0).ConstructTransaction(scriptPubKey);
+            return CTxOut(0, scriptPubKey);
+        };
+        static uint32_t nextLockTime = 0;
+        auto MakeTx = [](const std::vector<CTxOut>& vout) {
+            CMutableTransaction tx;
+            tx.nLockTime = nextLockTime++;
+            tx.vin.emplace_back(COutPoint(GetRandHash(), 0));
+            tx.vout = vout;
+            return MakeTransactionRef(std::move(tx));
+        };
+
+        CScript scriptNewToken = vScripts[2];
+        CScript scriptNewOwner = vScripts[2];
+        CNewToken newToken("DDD", 1000 * COIN);
+        newToken.ConstructTransaction(scriptNewToken);
+        newToken.ConstructOwnerTransaction(scriptNewOwner);
+
+        // The order decides which tokens sent to an address subscribe to their owner channel, so two of them share a block
+        std::vector<std::vector<CTransactionRef> > vBlockTxs = {
+            {},
+            {MakeTx({Transfer("AAA", vScripts[0])}), MakeTx({Transfer("BBB", vScripts[0])})},
+            {MakeTx({Transfer("CCC!", vScripts[1]), Transfer("CCC~NEWS", vScripts[1])})},
+            {MakeTx({Transfer("CCC", vScripts[2]), Transfer("EEE/SUB", vScripts[2])})},
+            {MakeTx({CTxOut(0, scriptNewOwner), CTxOut(0, scriptNewToken)}), MakeTx({Transfer("FFF", scriptOther), Transfer("FFF~NEWS", scriptOther)})},
+            {MakeTx({Transfer("JJJ", vScripts[3])})}
+        };
+
+        std::vector<CBlock> vBlocks;
+        std::vector<CBlockIndex*> vIndexes;
+        for (const auto& vtx : vBlockTxs) {
+            CBlock block;
+            block.vtx = vtx;
+            vBlocks.push_back(block);
+
+            auto inserted = mapBlockIndex.emplace(GetRandHash(), new CBlockIndex);
+            CBlockIndex* pindex = inserted.first->second;
+            pindex->phashBlock = &inserted.first->first;
+            pindex->pprev = vIndexes.empty() ? nullptr : vIndexes.back();
+            pindex->nHeight = vIndexes.size();
+            vIndexes.push_back(pindex);
+        }
+
+        // A block that lost a reorg, it must not count although the wallet still has its transaction
+        auto inserted = mapBlockIndex.emplace(GetRandHash(), new CBlockIndex);
+        CBlockIndex* pindexStale = inserted.first->second;
+        pindexStale->phashBlock = &inserted.first->first;
+        pindexStale->pprev = vIndexes[2];
+        pindexStale->nHeight = 3;
+        vIndexes.push_back(pindexStale);
+
+        {
+            LOCK2(cs_main, wallet.cs_wallet);
+            chainActive.SetTip(vIndexes[vBlocks.size() - 1]);
+
+            // Added out of chain order, the wallet orders them by hash anyway
+            for (size_t n = vBlocks.size(); n-- > 0;) {
+                for (size_t i = 0; i < vBlocks[n].vtx.size(); i++) {
+                    CWalletTx wtx(&wallet, vBlocks[n].vtx[i]);
+                    wtx.SetMerkleBranch(vIndexes[n], i);
+                    wallet.AddToWallet(wtx);
+                }
+            }
+
+            CWalletTx wtxStale(&wallet, MakeTx({Transfer("HHH", vScripts[3])}));
+            wtxStale.SetMerkleBranch(pindexStale, 0);
+            wallet.AddToWallet(wtxStale);
+
+            CWalletTx wtxUnconfirmed(&wallet, MakeTx({Transfer("III", vScripts[3])}));
+            wallet.AddToWallet(wtxUnconfirmed);
+        }
+
+        std::string strError;
+        BOOST_CHECK_MESSAGE(ScanForMessageChannels(strError), strError);
+
+        std::set<std::string> setChannels;
+        std::set<std::string> setAddresses;
+        ScanBlocksForMessageChannels(wallet, vBlocks, setChannels, setAddresses);
+
+        BOOST_CHECK(setDirtyChannelsAdd == setChannels);
+        BOOST_CHECK(setDirtySeenAddressAdd == setAddresses);
+        BOOST_CHECK(setDirtyChannelsAdd == std::set<std::string>({"AAA!", "CCC!", "CCC~NEWS", "EEE/SUB!", "DDD!", "JJJ!"}));
+        BOOST_CHECK_EQUAL(setDirtySeenAddressAdd.size(), 4U);
+
+        {
+            LOCK(cs_main);
+            chainActive.SetTip(nullptr);
+        }
+        for (CBlockIndex* pindex : vIndexes) {
+            mapBlockIndex.erase(pindex->GetIndexHash());
+            delete pindex;
+        }
+        vpwallets.erase(vpwallets.begin());
+        setDirtyChannelsAdd.clear();
+        setDirtySeenAddressAdd.clear();
+        pmessagechanneldb = pmessagechanneldbPrev;
+    }
+#endif
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,11 +4,13 @@
 
 
 #include <tokens/tokens.h>
+#include <tokens/restricteddb.h>
 #include <test/test_paladeum.h>
 #include <boost/test/unit_test.hpp>
 #include <amount.h>
 #include <base58.h>
 #include <chainparams.h>
+#include <validation.h>
 
 BOOST_FIXTURE_TEST_SUITE(qualifier_tests, BasicTestingSetup)
 
@@ -60,7 +62,7 @@ BOOST_FIXTURE_TEST_SUITE(qualifier_tests, BasicTestingSetup)
     }
 
 
-    BOOST_AUTO_TEST_CASE(verify_new_qualifier_transaction_test)
+    BOOST_FIXTURE_TEST_CASE(verify_new_qualifier_transaction_test, TestingSetup)
     {
         BOOST_TEST_MESSAGE("Running Verify New Qualifier From Transaction Test");
 
@@ -72,7 +74,7 @@ BOOST_FIXTURE_TEST_SUITE(qualifier_tests, BasicTestingSetup)
 
         // Create the new Qualifier Script
         CScript newQualifierScript = GetScriptForDestination(DecodeDestination(GetParams().GlobalFeeAddress()));
-        CNewToken qualifier_token("#QUALIFIER_NAME", 5 * COIN, 0, 0, 0, "");
+        CNewToken qualifier_token("#QUALIFIER_NAME", 5 * COIN, 0, 0, 0, "", 0, "", 0);
         qualifier_token.ConstructTransaction(newQualifierScript);
         CTxOut tokenOut(0, newQualifierScript);
         mutableTransaction.vout.push_back(tokenOut);
@@ -83,7 +85,7 @@ BOOST_FIXTURE_TEST_SUITE(qualifier_tests, BasicTestingSetup)
         BOOST_CHECK_MESSAGE(tx.VerifyNewQualfierToken(error), "Failed to Verify New Qualifier Token" + error);
     }
 
-    BOOST_AUTO_TEST_CASE(verify_new_sub_qualifier_transaction_test)
+    BOOST_FIXTURE_TEST_CASE(verify_new_sub_qualifier_transaction_test, TestingSetup)
     {
         BOOST_TEST_MESSAGE("Running Verify New Sub Qualifier From Transaction Test");
 
@@ -94,7 +96,7 @@ BOOST_FIXTURE_TEST_SUITE(qualifier_tests, BasicTestingSetup)
         mutableTransaction.vout.push_back(burnOut);
 
         // Add the parent transaction for sub qualifier tx
-        CTokenTransfer parentTransfer("#QUALIFIER_NAME", OWNER_TOKEN_AMOUNT);
+        CTokenTransfer parentTransfer("#QUALIFIER_NAME", OWNER_TOKEN_AMOUNT, 0);
         CScript parentScript = GetScriptForDestination(DecodeDestination(GetParams().GlobalFeeAddress()));
         parentTransfer.ConstructTransaction(parentScript);
         CTxOut parentOut(0, parentScript);
@@ -102,7 +104,7 @@ BOOST_FIXTURE_TEST_SUITE(qualifier_tests, BasicTestingSetup)
 
         // Create the new Qualifier Script
         CScript newQualifierScript = GetScriptForDestination(DecodeDestination(GetParams().GlobalFeeAddress()));
-        CNewToken qualifier_token("#QUALIFIER_NAME/#SUB1", 5 * COIN, 0, 0, 0, "");
+        CNewToken qualifier_token("#QUALIFIER_NAME/#SUB1", 5 * COIN, 0, 0, 0, "", 0, "", 0);
         qualifier_token.ConstructTransaction(newQualifierScript);
         CTxOut tokenOut(0, newQualifierScript);
         mutableTransaction.vout.push_back(tokenOut);
@@ -115,6 +117,64 @@ BOOST_FIXTURE_TEST_SUITE(qualifier_tests, BasicTestingSetup)
         BOOST_CHECK_MESSAGE(tx.VerifyNewQualfierToken(strError), "Failed to Verify New Sub Qualifier Token " + strError);
     }
 
+    BOOST_AUTO_TEST_CASE(loaded_address_qualifiers_test)
+    {
+        BOOST_TEST_MESSAGE("Running Loaded Address Qualifiers Test");
+
+        CRestrictedDB db(1 << 20, true, true);
+        CLRUCache<std::string, int8_t> qualifierCache(1000);
+        CRestrictedDB* prestricteddbPrev = prestricteddb;
+        CLRUCache<std::string, int8_t>* ptokensQualifierCachePrev = ptokensQualifierCache;
+        prestricteddb = &db;
+        ptokensQualifierCache = &qualifierCache;
+
+        CTokenAddress addressA(CKeyID(uint160(std::vector<unsigned char>(20, 0x0a))));
+        CTokenAddress addressB(CKeyID(uint160(std::vector<unsigned char>(20, 0x0b))));
+        CTokenAddress addressMissing(CKeyID(uint160(std::vector<unsigned char>(20, 0x0c))));
+        BOOST_CHECK(db.WriteAddressQualifier(addressA, "#A"));
+        BOOST_CHECK(db.WriteAddressQualifier(addressA, "#B/#C"));
+        BOOST_CHECK(db.WriteAddressQualifier(addressB, "#AB"));
+        BOOST_CHECK(db.WriteAddressQualifier(addressB, "#B/#D"));
+
+        std::vector<CTokenAddress> vAddresses = {addressA, addressB, addressMissing};
+        std::vector<std::string> vQualifiers = {"#A", "#AB", "#B", "#B/#C", "#B/#D", "#C", "#A/#B"};
+
+        // The loaded addresses are answered the way the database reads answer them
+        CTokensCache loadedCache;
+        loadedCache.LoadAddressQualifiers(std::set<CTokenAddress>(vAddresses.begin(), vAddresses.end()));
+        for (const CTokenAddress& address : vAddresses) {
+            for (const std::string& qualifier : vQualifiers) {
+                CTokensCache readCache;
+                qualifierCache.Clear();
+                bool fRead = readCache.CheckForAddressQualifier(qualifier, address);
+                BOOST_CHECK_MESSAGE(readCache.CheckForAddressQualifier(qualifier, address) == fRead, qualifier + " " + address.ToString());
+                qualifierCache.Clear();
+                BOOST_CHECK_MESSAGE(loadedCache.CheckForAddressQualifier(qualifier, address) == fRead, qualifier + " " + address.ToString());
+            }
+        }
+
+        qualifierCache.Clear();
+        BOOST_CHECK(loadedCache.CheckForAddressQualifier("#A", addressA));
+        BOOST_CHECK(loadedCache.CheckForAddressQualifier("#B", addressA));
+        BOOST_CHECK(!loadedCache.CheckForAddressQualifier("#A", addressB));
+        BOOST_CHECK(loadedCache.CheckForAddressQualifier("#B", addressB));
+        for (const std::string& qualifier : vQualifiers)
+            BOOST_CHECK(!loadedCache.CheckForAddressQualifier(qualifier, addressMissing));
+
+        // The qualifiers the block adds and removes decide over the loaded ones
+        BOOST_CHECK(loadedCache.AddQualifierAddress("#A", addressA, QualifierType::REMOVE_QUALIFIER));
+        BOOST_CHECK(loadedCache.AddQualifierAddress("#C", addressMissing, QualifierType::ADD_QUALIFIER));
+        BOOST_CHECK(loadedCache.RemoveQualifierAddress("#AB", addressB, QualifierType::ADD_QUALIFIER));
+        qualifierCache.Clear();
+        BOOST_CHECK(!loadedCache.CheckForAddressQualifier("#A", addressA));
+        BOOST_CHECK(loadedCache.CheckForAddressQualifier("#C", addressMissing));
+        BOOST_CHECK(!loadedCache.CheckForAddressQualifier("#AB", addressB));
+        BOOST_CHECK(loadedCache.CheckForAddressQualifier("#B", addressB));
+
+        prestricteddb = prestricteddbPrev;
+        ptokensQualifierCache = ptokensQualifierCachePrev;
+    }
+
 
 
 
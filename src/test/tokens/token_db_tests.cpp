@@ -0,0 +1,387 @@
+// Copyright (c) 2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "base58.h"
+#include "tokens/restricteddb.h"
+#include "tokens/tokendb.h"
+#include "tokens/tokens.h"
+#include "tokens/tokensnapshotdb.h"
+#include "test/test_paladeum.h"
+#include "validation.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+
+BOOST_FIXTURE_TEST_SUITE(token_db_tests, TestingSetup)
+
+//! The order of the token table, names are sorted by length first
+static bool TokenKeyLess(const std::string& a, const std::string& b)
+{
+    if (a.size() != b.size())
+        return a.size() < b.size();
+    return a < b;
+}
+
+//! The directory the way it was computed before the seeks, by walking the whole table
+static std::vector<std::string> ReferenceTokenDir(const std::vector<std::string>& vNames, const std::string& prefix, const size_t count, const long start)
+{
+    std::vector<std::string> vMatches;
+    for (const auto& name : vNames) {
+        if (name.compare(0, prefix.size(), prefix) == 0)
+            vMatches.push_back(name);
+    }
+
+    std::vector<std::string> vResult;
+    long skip = start >= 0 ? start : (long)vMatches.size() + start;
+    if (skip < 0)
+        return vResult;
+    for (size_t i = skip; i < vMatches.size() && vResult.size() < count; i++)
+        vResult.push_back(vMatches[i]);
+    return vResult;
+}
+
+//! A key id address that differs in its first two bytes
+static CTokenAddress TestAddress(unsigned int i)
+{
+    std::vector<unsigned char> vchKeyId(20, 0);
+    vchKeyId[0] = i & 0xff;
+    vchKeyId[1] = i >> 8;
+    return CTokenAddress(CKeyID(uint160(vchKeyId)));
+}
+
+static std::vector<std::string> GetNames(const std::vector<CDatabasedTokenData>& tokens)
+{
+    std::vector<std::string> vNames;
+    for (const auto& data : tokens)
+        vNames.push_back(data.token.strName);
+    return vNames;
+}
+
+BOOST_AUTO_TEST_CASE(token_dir_prefix_test)
+{
+    CTokensDB db(1 << 20, true, true);
+
+    std::vector<std::string> vNames = {"ABC", "ABD", "ABCD", "AB", "ABCDEFG", "ZZZ", "AAAA", "ABZZ", "B", "ABAB", "XABC", "ABC/SUB", "ABC#TAG"};
+    for (const auto& name : vNames)
+        BOOST_CHECK(db.WriteTokenData(CNewToken(name, 1000), 1, uint256()));
+    std::sort(vNames.begin(), vNames.end(), TokenKeyLess);
+
+    for (const std::string prefix : {"", "A", "AB", "ABC", "ABCD", "X", "Q"}) {
+        for (long start = -15; start <= 15; start++) {
+            for (size_t count : {1, 2, 5, 100}) {
+                std::vector<CDatabasedTokenData> tokens;
+                BOOST_CHECK(db.TokenDir(tokens, prefix + "*", count, start));
+                BOOST_CHECK_MESSAGE(GetNames(tokens) == ReferenceTokenDir(vNames, prefix, count, start),
+                                    "prefix " + prefix + " start " + std::to_string(start) + " count " + std::to_string(count));
+            }
+        }
+
+        // Paging with the cursor visits the same names as one large page
+        std::vector<std::string> vPaged;
+        std::string after;
+        while (true) {
+            std::vector<CDatabasedTokenData> tokens;
+            BOOST_CHECK(db.TokenDir(tokens, prefix + "*", 2, 0, after));
+            if (tokens.empty())
+                break;
+            for (const auto& data : tokens)
+                vPaged.push_back(data.token.strName);
+            after = tokens.back().token.strName;
+        }
+        BOOST_CHECK(vPaged == ReferenceTokenDir(vNames, prefix, vNames.size(), 0));
+    }
+
+    // A full name selects a single token
+    std::vector<CDatabasedTokenData> tokens;
+    BOOST_CHECK(db.TokenDir(tokens, "ABC", 10, 0));
+    BOOST_CHECK(GetNames(tokens) == std::vector<std::string>{"ABC"});
+    tokens.clear();
+    BOOST_CHECK(db.TokenDir(tokens, "ABC", 10, 0, "ABC"));
+    BOOST_CHECK(tokens.empty());
+}
+
+BOOST_AUTO_TEST_CASE(token_address_dir_test)
+{
+    CTokensDB db(1 << 20, true, true);
+
+    std::vector<CTokenAddress> vAddresses;
+    for (int i = 0; i < 20; i++) {
+        vAddresses.push_back(TestAddress(i * 13));
+        BOOST_CHECK(db.WriteTokenAddressQuantity("TOKEN", vAddresses.back(), i + 1));
+    }
+    BOOST_CHECK(db.WriteTokenAddressQuantity("TOKEN2", TestAddress(13), 5));
+    BOOST_CHECK(db.WriteTokenAddressQuantity("TOKE", TestAddress(13), 5));
+    std::sort(vAddresses.begin(), vAddresses.end());
+
+    std::vector<std::pair<CTokenAddress, CAmount> > vAmounts;
+    int nTotal = 0;
+    BOOST_CHECK(db.TokenAddressDir(vAmounts, nTotal, true, "TOKEN", 0, 0));
+    BOOST_CHECK_EQUAL(nTotal, 20);
+
+    // The count follows entries that are added and removed, but not quantity updates
+    BOOST_CHECK(db.WriteTokenAddressQuantity("TOKEN", TestAddress(0), 100));
+    BOOST_CHECK(db.WriteTokenAddressQuantity("TOKEN", TestAddress(1), 1));
+    BOOST_CHECK(db.EraseTokenAddressQuantity("TOKEN", TestAddress(1)));
+    BOOST_CHECK(db.EraseTokenAddressQuantity("TOKEN", TestAddress(2)));
+    BOOST_CHECK(db.TokenAddressDir(vAmounts, nTotal, true, "TOKEN", 0, 0));
+    BOOST_CHECK_EQUAL(nTotal, 20);
+
+    for (long start = -22; start <= 22; start++) {
+        vAmounts.clear();
+        BOOST_CHECK(db.TokenAddressDir(vAmounts, nTotal, false, "TOKEN", 3, start));
+
+        std::vector<CTokenAddress> vExpected;
+        long skip = start >= 0 ? start : 20 + start;
+        for (long i = skip; skip >= 0 && i < 20 && vExpected.size() < 3; i++)
+            vExpected.push_back(vAddresses[i]);
+
+        std::vector<CTokenAddress> vResult;
+        for (const auto& pair : vAmounts)
+            vResult.push_back(pair.first);
+        BOOST_CHECK_MESSAGE(vResult == vExpected, "start " + std::to_string(start));
+    }
+
+    std::vector<CTokenAddress> vPaged;
+    CTokenAddress after;
+    while (true) {
+        vAmounts.clear();
+        BOOST_CHECK(db.TokenAddressDir(vAmounts, nTotal, false, "TOKEN", 3, 0, after));
+        if (vAmounts.empty())
+            break;
+        for (const auto& pair : vAmounts)
+            vPaged.push_back(pair.first);
+        after = vAmounts.back().first;
+    }
+    BOOST_CHECK(vPaged == vAddresses);
+}
+
+BOOST_AUTO_TEST_CASE(token_address_keys_upgrade_test)
+{
+    CTokensDB db(1 << 20, true, true);
+
+    // Quantities written with base58 address keys, as the database held them before the upgrade
+    for (unsigned int i = 0; i < 10; i++) {
+        std::string strAddress = TestAddress(i).ToString();
+        BOOST_CHECK(db.Write(std::make_pair('B', std::make_pair(std::string("OLD"), strAddress)), CAmount(i + 1)));
+        BOOST_CHECK(db.Write(std::make_pair('C', std::make_pair(strAddress, std::string("OLD"))), CAmount(i + 1)));
+    }
+    // And one written after an interrupted upgrade
+    BOOST_CHECK(db.WriteTokenAddressQuantity("NEW", TestAddress(1), 7));
+    BOOST_CHECK(db.WriteAddressTokenQuantity(TestAddress(1), "NEW", 7));
+
+    CAmount nQuantity;
+    BOOST_CHECK(!db.ReadTokenAddressQuantity("OLD", TestAddress(3), nQuantity));
+
+    for (int nRun = 0; nRun < 2; nRun++) {
+        BOOST_CHECK(db.UpgradeAddressKeys());
+
+        for (unsigned int i = 0; i < 10; i++) {
+            BOOST_CHECK(db.ReadTokenAddressQuantity("OLD", TestAddress(i), nQuantity));
+            BOOST_CHECK_EQUAL(nQuantity, CAmount(i + 1));
+            BOOST_CHECK(db.ReadAddressTokenQuantity(TestAddress(i), "OLD", nQuantity));
+            BOOST_CHECK_EQUAL(nQuantity, CAmount(i + 1));
+        }
+        BOOST_CHECK(db.ReadTokenAddressQuantity("NEW", TestAddress(1), nQuantity));
+        BOOST_CHECK_EQUAL(nQuantity, 7);
+
+        // The base58 keys are gone, so the counts only see the upgraded entries
+        std::vector<std::pair<CTokenAddress, CAmount> > vAmounts;
+        int nTotal = 0;
+        BOOST_CHECK(db.TokenAddressDir(vAmounts, nTotal, true, "OLD", 0, 0));
+        BOOST_CHECK_EQUAL(nTotal, 10);
+        std::vector<std::pair<std::string, CAmount> > vTokens;
+        BOOST_CHECK(db.AddressDir(vTokens, nTotal, true, TestAddress(1), 0, 0));
+        BOOST_CHECK_EQUAL(nTotal, 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(restricted_address_keys_upgrade_test)
+{
+    CRestrictedDB db(1 << 20, true, true);
+
+    int8_t i = 1;
+    std::string strAddress = TestAddress(5).ToString();
+    BOOST_CHECK(db.Write(std::make_pair('T', std::make_pair(strAddress, std::string("#TAG"))), i));
+    BOOST_CHECK(db.Write(std::make_pair('Q', std::make_pair(std::string("#TAG"), strAddress)), i));
+    BOOST_CHECK(db.Write(std::make_pair('R', std::make_pair(strAddress, std::string("$RESTRICTED"))), i));
+    BOOST_CHECK(db.WriteGlobalRestriction("$RESTRICTED"));
+
+    for (int nRun = 0; nRun < 2; nRun++) {
+        BOOST_CHECK(db.UpgradeAddressKeys());
+
+        BOOST_CHECK(db.ReadAddressQualifier(TestAddress(5), "#TAG"));
+        BOOST_CHECK(db.ReadQualifierAddress(TestAddress(5), "#TAG"));
+        BOOST_CHECK(db.ReadRestrictedAddress(TestAddress(5), "$RESTRICTED"));
+        BOOST_CHECK(db.ReadGlobalRestriction("$RESTRICTED"));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(token_ownership_snapshot_test)
+{
+    CTokensDB db(1 << 20, true, true);
+    CTokenSnapshotDB snapshotDb(1 << 20, true, true);
+    CTokensDB* ptokensdbPrev = ptokensdb;
+    ptokensdb = &db;
+
+    // Enough owners for several chunks, plus an address that isn't valid
+    std::set<std::pair<std::string, CAmount>> ownersAndAmounts;
+    for (unsigned int i = 0; i < OWNERS_PER_SNAPSHOT_CHUNK * 2 + 10; i++) {
+        ownersAndAmounts.emplace(TestAddress(i).ToString(), i + 1);
+        BOOST_CHECK(db.WriteTokenAddressQuantity("SNAPSHOT", TestAddress(i), i + 1));
+    }
+    BOOST_CHECK(db.WriteTokenAddressQuantity("SNAPSHOT", CTokenAddress(), 5));
+    BOOST_CHECK(db.WriteTokenAddressQuantity("SNAPSHOTS", CTokenAddress(CKeyID()), 5));
+
+    BOOST_CHECK(!snapshotDb.AddTokenOwnershipSnapshot("NOOWNERS", 10));
+    BOOST_CHECK(!snapshotDb.OwnershipSnapshotExists("NOOWNERS", 10));
+
+    BOOST_CHECK(snapshotDb.AddTokenOwnershipSnapshot("SNAPSHOT", 10));
+    BOOST_CHECK(snapshotDb.OwnershipSnapshotExists("SNAPSHOT", 10));
+
+    CTokenSnapshotDBEntry snapshotEntry;
+    BOOST_CHECK(snapshotDb.RetrieveOwnershipSnapshot("SNAPSHOT", 10, snapshotEntry));
+    BOOST_CHECK_EQUAL(snapshotEntry.tokenName, "SNAPSHOT");
+    BOOST_CHECK_EQUAL(snapshotEntry.height, 10);
+    BOOST_CHECK(snapshotEntry.ownersAndAmounts == ownersAndAmounts);
+
+    // Snapshots written before the chunks keep their owners in the entry itself
+    CTokenSnapshotDBEntry oldEntry("OLD", 10, ownersAndAmounts);
+    BOOST_CHECK(snapshotDb.Write(std::make_pair('C', oldEntry.heightAndName), oldEntry));
+    BOOST_CHECK(snapshotDb.RetrieveOwnershipSnapshot("OLD", 10, snapshotEntry));
+    BOOST_CHECK(snapshotEntry.ownersAndAmounts == ownersAndAmounts);
+
+    BOOST_CHECK(snapshotDb.RemoveOwnershipSnapshot("SNAPSHOT", 10));
+    BOOST_CHECK(!snapshotDb.RetrieveOwnershipSnapshot("SNAPSHOT", 10, snapshotEntry));
+
+    ptokensdb = ptokensdbPrev;
+}
+
+BOOST_AUTO_TEST_CASE(token_name_filter_test)
+{
+    CTokenNameFilter filter(1000);
+    for (int i = 0; i < 1000; i++)
+        filter.Insert("TOKEN" + std::to_string(i));
+    BOOST_CHECK(!filter.IsFull());
+
+    for (int i = 0; i < 1000; i++)
+        BOOST_CHECK(filter.MayContain("TOKEN" + std::to_string(i)));
+
+    // Sized for 0.1% false positives when full
+    int nFalsePositives = 0;
+    for (int i = 0; i < 10000; i++)
+        nFalsePositives += filter.MayContain("OTHER" + std::to_string(i));
+    BOOST_CHECK(nFalsePositives < 50);
+
+    // Every insert is counted, also one that sets no new bit
+    unsigned int nElements = filter.GetElements();
+    BOOST_CHECK(!filter.Insert("TOKEN0"));
+    BOOST_CHECK_EQUAL(filter.GetElements(), nElements + 1);
+    BOOST_CHECK(filter.IsFull());
+
+    // A filter that wasn't built rules nothing out
+    BOOST_CHECK(CTokenNameFilter().MayContain("ANY"));
+
+    // The database keeps the filter up to date with both write paths
+    CTokensDB db(1 << 20, true, true);
+    BOOST_CHECK(!db.TokenNameMayExist("SINGLE"));
+    BOOST_CHECK(db.WriteTokenData(CNewToken("SINGLE", 1000), 1, uint256()));
+    BOOST_CHECK(db.TokenNameMayExist("SINGLE"));
+
+    CTokensDBBatch batch;
+    db.WriteTokenData(batch, CNewToken("BATCHED", 1000), 2, uint256());
+    BOOST_CHECK(!db.TokenNameMayExist("BATCHED"));
+    size_t nBytes;
+    BOOST_CHECK(db.WriteTokensBatch(batch, InsecureRand256(), nBytes));
+    BOOST_CHECK(db.TokenNameMayExist("BATCHED"));
+
+    // Storing the filter leaves it in use
+    BOOST_CHECK(db.WriteTokenNameFilter());
+    BOOST_CHECK(db.TokenNameMayExist("SINGLE"));
+    BOOST_CHECK(!db.TokenNameMayExist("NEVERISSUED"));
+
+    CNewToken token;
+    int nHeight;
+    uint256 hash;
+    BOOST_CHECK(db.ReadTokenData("BATCHED", token, nHeight, hash));
+    BOOST_CHECK_EQUAL(nHeight, 2);
+    BOOST_CHECK(!db.ReadTokenData("NEVERISSUED", token, nHeight, hash));
+}
+
+BOOST_AUTO_TEST_CASE(token_metadata_snapshot_test)
+{
+    LOCK(cs_main);
+    CTokensDB db(1 << 20, true, true);
+    BOOST_CHECK(db.WriteTokenData(CNewToken("FLUSHED", 1000), 1, uint256()));
+    BOOST_CHECK(db.WriteTokenData(CNewToken("DISCONNECTED", 1000), 2, uint256()));
+
+    CTokensDB* pOldTokensDB = ptokensdb;
+    CTokensCache* pOldTokens = ptokens;
+    CTokensCache cache;
+    ptokensdb = &db;
+    ptokens = &cache;
+
+    // What ptokens doesn't hold is read from the database
+    uint256 hashFlushed = uint256S("01");
+    PublishTokenMetaDataSnapshot(hashFlushed);
+    CDatabasedTokenData data;
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("FLUSHED", data));
+    BOOST_CHECK_EQUAL(data.nHeight, 1);
+    BOOST_CHECK(!GetTokenMetaDataFromSnapshot("CONNECTED", data));
+
+    // The changes of a block are only seen once published
+    CTokensCache blockCache(&cache);
+    blockCache.setNewTokensToAdd.insert(CTokenCacheNewToken(CNewToken("CONNECTED", 1000), CTokenAddress(), 3, uint256()));
+    blockCache.setNewTokensToRemove.insert(CTokenCacheNewToken(CNewToken("DISCONNECTED", 1000), CTokenAddress(), 0, uint256()));
+    blockCache.mapReissuedTokenData.Set("FLUSHED", CNewToken("FLUSHED", 1500));
+    blockCache.setNewReissueToAdd.insert(CTokenCacheReissueToken(CReissueToken("FLUSHED", 500, 0, 1, "", 0, "", 0), CTokenAddress(), COutPoint(), 4, uint256()));
+    BOOST_CHECK(blockCache.Flush());
+    BOOST_CHECK(!GetTokenMetaDataFromSnapshot("CONNECTED", data));
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("DISCONNECTED", data));
+
+    uint256 hashConnected = uint256S("02");
+    PublishTokenMetaDataChanges(blockCache, hashFlushed, hashConnected);
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("CONNECTED", data));
+    BOOST_CHECK_EQUAL(data.nHeight, 3);
+    BOOST_CHECK(!GetTokenMetaDataFromSnapshot("DISCONNECTED", data));
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("FLUSHED", data));
+    BOOST_CHECK_EQUAL(data.token.nAmount, 1500);
+    BOOST_CHECK_EQUAL(data.nHeight, 4);
+
+    // The next block only publishes its own changes, the earlier ones are still seen beneath them
+    CTokensCache nextBlockCache(&cache);
+    nextBlockCache.setNewTokensToAdd.insert(CTokenCacheNewToken(CNewToken("DISCONNECTED", 2000), CTokenAddress(), 5, uint256()));
+    BOOST_CHECK(nextBlockCache.Flush());
+    uint256 hashNext = uint256S("03");
+    PublishTokenMetaDataChanges(nextBlockCache, hashConnected, hashNext);
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("DISCONNECTED", data));
+    BOOST_CHECK_EQUAL(data.nHeight, 5);
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("CONNECTED", data));
+    BOOST_CHECK_EQUAL(data.nHeight, 3);
+
+    // Changes published on a snapshot of another block fall back to everything ptokens holds
+    CTokensCache emptyBlockCache(&cache);
+    PublishTokenMetaDataChanges(emptyBlockCache, hashFlushed, uint256S("04"));
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("CONNECTED", data));
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("DISCONNECTED", data));
+    BOOST_CHECK_EQUAL(data.nHeight, 5);
+
+    // A block skipped during the initial block download is only seen once the snapshot is caught up
+    CTokensCache skippedBlockCache(&cache);
+    skippedBlockCache.setNewTokensToAdd.insert(CTokenCacheNewToken(CNewToken("SKIPPED", 1000), CTokenAddress(), 6, uint256()));
+    BOOST_CHECK(skippedBlockCache.Flush());
+    SkipTokenMetaDataChanges();
+    BOOST_CHECK(IsTokenMetaDataSnapshotBehind());
+    BOOST_CHECK(!GetTokenMetaDataFromSnapshot("SKIPPED", data));
+    PublishTokenMetaDataSnapshot(uint256S("05"));
+    BOOST_CHECK(!IsTokenMetaDataSnapshotBehind());
+    BOOST_CHECK(GetTokenMetaDataFromSnapshot("SKIPPED", data));
+    BOOST_CHECK_EQUAL(data.nHeight, 6);
+
+    ptokens = pOldTokens;
+    ptokensdb = pOldTokensDB;
+    PublishTokenMetaDataSnapshot(uint256());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,493 @@
+// Copyright (c) 2022 The Paladeum developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <tokens/tokens.h>
+
+#include <test/test_paladeum.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <regex>
+
+// The std::regex based name validation the hand-written validators replaced, kept as a reference
+namespace regex_reference {
+
+bool IsTypeCheckNameValid(const KnownTokenType type, const std::string& name, std::string& error);
+
+// excluding owner tag ('!')
+static const auto MAX_NAME_LENGTH = 31;
+static const auto MAX_CHANNEL_NAME_LENGTH = 12;
+
+// min lengths are expressed by quantifiers
+static const std::regex ROOT_NAME_CHARACTERS("^[A-Z0-9._]{3,}$");
+static const std::regex SUB_NAME_CHARACTERS("^[A-Z0-9._]+$");
+static const std::regex UNIQUE_TAG_CHARACTERS("^[-A-Za-z0-9@$%&*()[\\]{}_.?:]+$");
+static const std::regex MSG_CHANNEL_TAG_CHARACTERS("^[A-Za-z0-9_]+$");
+static const std::regex VOTE_TAG_CHARACTERS("^[A-Z0-9._]+$");
+static const std::regex USERNAME_CHARACTERS("^@[A-Z0-9._]{4,}$");
+
+// Restricted tokens
+static const std::regex QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]{3,}$");
+static const std::regex SUB_QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]+$");
+static const std::regex RESTRICTED_NAME_CHARACTERS("\\$[A-Z0-9._]{3,}$");
+
+static const std::regex DOUBLE_PUNCTUATION("^.*[._]{2,}.*$");
+static const std::regex LEADING_PUNCTUATION("^[._].*$");
+static const std::regex TRAILING_PUNCTUATION("^.*[._]$");
+static const std::regex QUALIFIER_LEADING_PUNCTUATION("^[#\\$][._].*$"); // Used for qualifier tokens, and restricted token only
+
+static const std::string SUB_NAME_DELIMITER = "/";
+static const std::string UNIQUE_TAG_DELIMITER = "#";
+static const std::string MSG_CHANNEL_TAG_DELIMITER = "~";
+static const std::string VOTE_TAG_DELIMITER = "^";
+static const std::string RESTRICTED_TAG_DELIMITER = "$";
+
+static const std::regex UNIQUE_INDICATOR(R"(^[^^~#!]+#[^~#!\/]+$)");
+static const std::regex MSG_CHANNEL_INDICATOR(R"(^[^^~#!]+~[^~#!\/]+$)");
+static const std::regex OWNER_INDICATOR(R"(^[^^~#!]+!$)");
+static const std::regex VOTE_INDICATOR(R"(^[^^~#!]+\^[^~#!\/]+$)");
+static const std::regex USERNAME_INDICATOR(R"(^@[A-Z0-9._]{4,}$)");
+
+static const std::regex QUALIFIER_INDICATOR("^[#][A-Z0-9._]{3,}$"); // Starts with #
+static const std::regex SUB_QUALIFIER_INDICATOR("^#[A-Z0-9._]+\\/#[A-Z0-9._]+$"); // Starts with #
+static const std::regex RESTRICTED_INDICATOR("^[\\$][A-Z0-9._]{3,}$"); // Starts with $
+
+static const std::regex PLB_NAMES("^PLB$|^PLB$|^PLBCOIN$");
+
+bool IsRootNameValid(const std::string& name)
+{
+    return std::regex_match(name, ROOT_NAME_CHARACTERS)
+        && !std::regex_match(name, DOUBLE_PUNCTUATION)
+        && !std::regex_match(name, LEADING_PUNCTUATION)
+        && !std::regex_match(name, TRAILING_PUNCTUATION)
+        && !std::regex_match(name, PLB_NAMES);
+}
+
+bool IsQualifierNameValid(const std::string& name)
+{
+    return std::regex_match(name, QUALIFIER_NAME_CHARACTERS)
+           && !std::regex_match(name, DOUBLE_PUNCTUATION)
+           && !std::regex_match(name, QUALIFIER_LEADING_PUNCTUATION)
+           && !std::regex_match(name, TRAILING_PUNCTUATION)
+           && !std::regex_match(name, PLB_NAMES);
+}
+
+bool IsRestrictedNameValid(const std::string& name)
+{
+    return std::regex_match(name, RESTRICTED_NAME_CHARACTERS)
+           && !std::regex_match(name, DOUBLE_PUNCTUATION)
+           && !std::regex_match(name, LEADING_PUNCTUATION)
+           && !std::regex_match(name, TRAILING_PUNCTUATION)
+           && !std::regex_match(name, PLB_NAMES);
+}
+
+bool IsSubQualifierNameValid(const std::string& name)
+{
+    return std::regex_match(name, SUB_QUALIFIER_NAME_CHARACTERS)
+           && !std::regex_match(name, DOUBLE_PUNCTUATION)
+           && !std::regex_match(name, LEADING_PUNCTUATION)
+           && !std::regex_match(name, TRAILING_PUNCTUATION);
+}
+
+bool IsSubNameValid(const std::string& name)
+{
+    return std::regex_match(name, SUB_NAME_CHARACTERS)
+        && !std::regex_match(name, DOUBLE_PUNCTUATION)
+        && !std::regex_match(name, LEADING_PUNCTUATION)
+        && !std::regex_match(name, TRAILING_PUNCTUATION);
+}
+
+bool IsUniqueTagValid(const std::string& tag)
+{
+    return std::regex_match(tag, UNIQUE_TAG_CHARACTERS);
+}
+
+bool IsVoteTagValid(const std::string& tag)
+{
+    return std::regex_match(tag, VOTE_TAG_CHARACTERS);
+}
+
+bool IsMsgChannelTagValid(const std::string &tag)
+{
+    return std::regex_match(tag, MSG_CHANNEL_TAG_CHARACTERS)
+        && !std::regex_match(tag, DOUBLE_PUNCTUATION)
+        && !std::regex_match(tag, LEADING_PUNCTUATION)
+        && !std::regex_match(tag, TRAILING_PUNCTUATION);
+}
+
+bool IsUsernameValid(const std::string& username)
+{
+    return std::regex_match(username, USERNAME_CHARACTERS);
+}
+
+bool IsNameValidBeforeTag(const std::string& name)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+
+    if (!IsRootNameValid(parts.front())) return false;
+
+    if (parts.size() > 1)
+    {
+        for (unsigned long i = 1; i < parts.size(); i++)
+        {
+            if (!IsSubNameValid(parts[i])) return false;
+        }
+    }
+
+    return true;
+}
+
+bool IsQualifierNameValidBeforeTag(const std::string& name)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+
+    if (!IsQualifierNameValid(parts.front())) return false;
+
+    // Qualifiers can only have one sub qualifier under it
+    if (parts.size() > 2) {
+        return false;
+    }
+
+    if (parts.size() > 1)
+    {
+
+        for (unsigned long i = 1; i < parts.size(); i++)
+        {
+            if (!IsSubQualifierNameValid(parts[i])) return false;
+        }
+    }
+
+    return true;
+}
+
+bool IsTokenNameASubtoken(const std::string& name)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+
+    if (!IsRootNameValid(parts.front())) return false;
+
+    return parts.size() > 1;
+}
+
+bool IsTokenNameASubQualifier(const std::string& name)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+
+    if (!IsQualifierNameValid(parts.front())) return false;
+
+    return parts.size() > 1;
+}
+
+
+bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::string& error)
+{
+    // Do a max length check first to stop the possibility of a stack exhaustion.
+    // We check for a value that is larger than the max token name
+    if (name.length() > 40)
+        return false;
+
+    tokenType = KnownTokenType::INVALID;
+    if (std::regex_match(name, UNIQUE_INDICATOR))
+    {
+        bool ret = regex_reference::IsTypeCheckNameValid(KnownTokenType::UNIQUE, name, error);
+        if (ret)
+            tokenType = KnownTokenType::UNIQUE;
+
+        return ret;
+    }
+    else if (std::regex_match(name, MSG_CHANNEL_INDICATOR))
+    {
+        bool ret = regex_reference::IsTypeCheckNameValid(KnownTokenType::MSGCHANNEL, name, error);
+        if (ret)
+            tokenType = KnownTokenType::MSGCHANNEL;
+
+        return ret;
+    }
+    else if (std::regex_match(name, OWNER_INDICATOR))
+    {
+        bool ret = regex_reference::IsTypeCheckNameValid(KnownTokenType::OWNER, name, error);
+        if (ret)
+            tokenType = KnownTokenType::OWNER;
+
+        return ret;
+    }
+    else if (std::regex_match(name, VOTE_INDICATOR))
+    {
+        bool ret = regex_reference::IsTypeCheckNameValid(KnownTokenType::VOTE, name, error);
+        if (ret)
+            tokenType = KnownTokenType::VOTE;
+
+        return ret;
+    }
+    else if (std::regex_match(name, QUALIFIER_INDICATOR))
+    {
+        bool ret = regex_reference::IsTypeCheckNameValid(KnownTokenType::QUALIFIER, name, error);
+        if (ret) {
+            if (IsTokenNameASubQualifier(name))
+                tokenType = KnownTokenType::SUB_QUALIFIER;
+            else
+                tokenType = KnownTokenType::QUALIFIER;
+        }
+
+        return ret;
+    }
+    else if (std::regex_match(name, SUB_QUALIFIER_INDICATOR))
+    {
+        bool ret = regex_reference::IsTypeCheckNameValid(KnownTokenType::SUB_QUALIFIER, name, error);
+        if (ret) {
+            if (IsTokenNameASubQualifier(name))
+                tokenType = KnownTokenType::SUB_QUALIFIER;
+        }
+
+        return ret;
+    }
+    else if (std::regex_match(name, RESTRICTED_INDICATOR))
+    {
+        bool ret = regex_reference::IsTypeCheckNameValid(KnownTokenType::RESTRICTED, name, error);
+        if (ret)
+            tokenType = KnownTokenType::RESTRICTED;
+
+        return ret;
+    }
+    else if (std::regex_match(name, USERNAME_INDICATOR))
+    {
+        bool ret = regex_reference::IsTypeCheckNameValid(KnownTokenType::USERNAME, name, error);
+        if (ret)
+            tokenType = KnownTokenType::USERNAME;
+
+        return ret;
+    }
+    else
+    {
+        auto type = IsTokenNameASubtoken(name) ? KnownTokenType::SUB : KnownTokenType::ROOT;
+        bool ret = regex_reference::IsTypeCheckNameValid(type, name, error);
+        if (ret)
+            tokenType = type;
+
+        return ret;
+    }
+}
+
+bool IsTokenNameValid(const std::string& name)
+{
+    KnownTokenType _tokenType;
+    std::string _error;
+    return regex_reference::IsTokenNameValid(name, _tokenType, _error);
+}
+
+bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType)
+{
+    std::string _error;
+    return regex_reference::IsTokenNameValid(name, tokenType, _error);
+}
+
+bool IsTokenNameARoot(const std::string& name)
+{
+    KnownTokenType type;
+    return regex_reference::IsTokenNameValid(name, type) && type == KnownTokenType::ROOT;
+}
+
+bool IsTokenNameAnOwner(const std::string& name)
+{
+    return IsTokenNameValid(name) && std::regex_match(name, OWNER_INDICATOR);
+}
+
+bool IsTokenNameAnRestricted(const std::string& name)
+{
+    return IsTokenNameValid(name) && std::regex_match(name, RESTRICTED_INDICATOR);
+}
+
+bool IsTokenNameAQualifier(const std::string& name, bool fOnlyQualifiers)
+{
+    if (fOnlyQualifiers) {
+        return IsTokenNameValid(name) && std::regex_match(name, QUALIFIER_INDICATOR);
+    }
+
+    return IsTokenNameValid(name) && (std::regex_match(name, QUALIFIER_INDICATOR) || std::regex_match(name, SUB_QUALIFIER_INDICATOR));
+}
+
+bool IsTokenNameAnMsgChannel(const std::string& name)
+{
+    return IsTokenNameValid(name) && std::regex_match(name, MSG_CHANNEL_INDICATOR);
+}
+
+bool IsTypeCheckNameValid(const KnownTokenType type, const std::string& name, std::string& error)
+{
+    if (type == KnownTokenType::UNIQUE) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        std::vector<std::string> parts;
+        boost::split(parts, name, boost::is_any_of(UNIQUE_TAG_DELIMITER));
+        bool valid = IsNameValidBeforeTag(parts.front()) && IsUniqueTagValid(parts.back());
+        if (!valid) { error = "Unique name contains invalid characters (Valid characters are: A-Z a-z 0-9 @ $ % & * ( ) [ ] { } _ . ? : -)";  return false; }
+        return true;
+    } else if (type == KnownTokenType::MSGCHANNEL) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        std::vector<std::string> parts;
+        boost::split(parts, name, boost::is_any_of(MSG_CHANNEL_TAG_DELIMITER));
+        bool valid = IsNameValidBeforeTag(parts.front()) && IsMsgChannelTagValid(parts.back());
+        if (parts.back().size() > MAX_CHANNEL_NAME_LENGTH) { error = "Channel name is greater than max length of " + std::to_string(MAX_CHANNEL_NAME_LENGTH); return false; }
+        if (!valid) { error = "Message Channel name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == KnownTokenType::OWNER) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        bool valid = IsNameValidBeforeTag(name.substr(0, name.size() - 1));
+        if (!valid) { error = "Owner name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == KnownTokenType::VOTE) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        std::vector<std::string> parts;
+        boost::split(parts, name, boost::is_any_of(VOTE_TAG_DELIMITER));
+        bool valid = IsNameValidBeforeTag(parts.front()) && IsVoteTagValid(parts.back());
+        if (!valid) { error = "Vote name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == KnownTokenType::QUALIFIER || type == KnownTokenType::SUB_QUALIFIER) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        bool valid = IsQualifierNameValidBeforeTag(name);
+        if (!valid) { error = "Qualifier name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (# must be the first character, _ . special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == KnownTokenType::RESTRICTED) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        bool valid = IsRestrictedNameValid(name);
+        if (!valid) { error = "Restricted name contains invalid characters (Valid characters are: A-Z 0-9 _ .) ($ must be the first character, _ . special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == KnownTokenType::USERNAME) {
+        if (name.size() > MAX_NAME_LENGTH) {
+            error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH);
+            return false;
+        }
+
+        bool valid = IsUsernameValid(name);
+        if (!valid) {
+            error = "Username contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";
+            return false;
+        }
+
+        return true;
+    } else {
+        if (name.size() > MAX_NAME_LENGTH - 1) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH - 1); return false; }  //Tokens and sub-tokens need to leave one extra char for OWNER indicator
+        if (!IsTokenNameASubtoken(name) && name.size() < MIN_TOKEN_LENGTH) { error = "Name must be contain " + std::to_string(MIN_TOKEN_LENGTH) + " characters"; return false; }
+        bool valid = IsNameValidBeforeTag(name);
+        if (!valid && IsTokenNameASubtoken(name) && name.size() < 3) { error = "Name must have at least 3 characters (Valid characters are: A-Z 0-9 _ .)";  return false; }
+        if (!valid) { error = "Name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
+        return true;
+    }
+}
+
+void ExtractVerifierStringQualifiers(const std::string& verifier, std::set<std::string>& qualifiers)
+{
+    std::string s(verifier);
+
+    std::regex regexSearch = std::regex(R"([A-Z0-9_.]+)");
+    std::smatch match;
+
+    while (std::regex_search(s,match,regexSearch)) {
+        for (auto str : match)
+            qualifiers.insert(str);
+        s = match.suffix().str();
+    }
+}
+
+} // namespace regex_reference
+
+static const KnownTokenType ALL_TOKEN_TYPES[] = {
+    KnownTokenType::ROOT, KnownTokenType::SUB, KnownTokenType::UNIQUE, KnownTokenType::MSGCHANNEL, KnownTokenType::QUALIFIER,
+    KnownTokenType::SUB_QUALIFIER, KnownTokenType::RESTRICTED, KnownTokenType::USERNAME, KnownTokenType::VOTE, KnownTokenType::OWNER,
+};
+
+static void CheckSameAsRegex(const std::string& name, bool fTypeChecks)
+{
+    KnownTokenType type = KnownTokenType::REISSUE, typeExpected = KnownTokenType::REISSUE;
+    std::string error, errorExpected;
+    BOOST_CHECK_MESSAGE(IsTokenNameValid(name, type, error) == regex_reference::IsTokenNameValid(name, typeExpected, errorExpected), name);
+    BOOST_CHECK_MESSAGE(type == typeExpected, name);
+    BOOST_CHECK_MESSAGE(error == errorExpected, name);
+
+    BOOST_CHECK_MESSAGE(IsTokenNameARoot(name) == regex_reference::IsTokenNameARoot(name), name);
+    BOOST_CHECK_MESSAGE(IsTokenNameAnOwner(name) == regex_reference::IsTokenNameAnOwner(name), name);
+    BOOST_CHECK_MESSAGE(IsTokenNameAnRestricted(name) == regex_reference::IsTokenNameAnRestricted(name), name);
+    BOOST_CHECK_MESSAGE(IsTokenNameAQualifier(name) == regex_reference::IsTokenNameAQualifier(name, false), name);
+    BOOST_CHECK_MESSAGE(IsTokenNameAQualifier(name, true) == regex_reference::IsTokenNameAQualifier(name, true), name);
+    BOOST_CHECK_MESSAGE(IsTokenNameASubQualifier(name) == regex_reference::IsTokenNameASubQualifier(name), name);
+    BOOST_CHECK_MESSAGE(IsTokenNameAnMsgChannel(name) == regex_reference::IsTokenNameAnMsgChannel(name), name);
+    BOOST_CHECK_MESSAGE(IsUniqueTagValid(name) == regex_reference::IsUniqueTagValid(name), name);
+    BOOST_CHECK_MESSAGE(IsUsernameValid(name) == regex_reference::IsUsernameValid(name), name);
+
+    if (!fTypeChecks)
+        return;
+
+    for (KnownTokenType checkType : ALL_TOKEN_TYPES) {
+        error.clear();
+        errorExpected.clear();
+        BOOST_CHECK_MESSAGE(IsTypeCheckNameValid(checkType, name, error) == regex_reference::IsTypeCheckNameValid(checkType, name, errorExpected), name);
+        BOOST_CHECK_MESSAGE(error == errorExpected, name);
+    }
+}
+
+static std::string GetRandomString(const std::vector<std::string>& vPieces, int nMaxPieces)
+{
+    std::string str;
+    int nPieces = 1 + InsecureRandRange(nMaxPieces);
+    for (int i = 0; i < nPieces; i++)
+        str += vPieces[InsecureRandRange(vPieces.size())];
+    return str;
+}
+
+BOOST_FIXTURE_TEST_SUITE(token_name_tests, BasicTestingSetup)
+
+    BOOST_AUTO_TEST_CASE(token_name_exhaustive_test)
+    {
+        BOOST_TEST_MESSAGE("Running Token Name Exhaustive Test");
+
+        // One character of every class the validators tell apart
+        const std::string alphabet = "Aa0._/#~^!$@- \xe9";
+
+        std::vector<std::string> vNames(1, "");
+        for (size_t nLength = 1; nLength <= 4; nLength++) {
+            std::vector<std::string> vLonger;
+            for (const std::string& name : vNames) {
+                for (char c : alphabet) {
+                    vLonger.push_back(name + c);
+                    CheckSameAsRegex(vLonger.back(), nLength <= 3);
+                }
+            }
+            vNames.swap(vLonger);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(token_name_random_test)
+    {
+        BOOST_TEST_MESSAGE("Running Token Name Random Test");
+
+        const std::vector<std::string> vPieces = {"A", "Z", "9", "a", "z", ".", "_", "/", "#", "~", "^", "!", "$", "@",
+                                                  "-", "*", "?", " ", "PLB", "COIN", "ABCDEFGHIJ", "._", "\n"};
+
+        CheckSameAsRegex("PLB", true);
+        CheckSameAsRegex("PLBCOIN", true);
+        CheckSameAsRegex("", true);
+
+        for (int i = 0; i < 20000; i++)
+            CheckSameAsRegex(GetRandomString(vPieces, 12), true);
+    }
+
+    BOOST_AUTO_TEST_CASE(verifier_string_qualifiers_test)
+    {
+        BOOST_TEST_MESSAGE("Running Verifier String Qualifiers Test");
+
+        const std::vector<std::string> vPieces = {"#", "A", "KYC", "_", ".", "0", "&", "|", "!", "(", ")", " ", "a", "-"};
+
+        for (int i = 0; i < 5000; i++) {
+            std::string verifier = GetRandomString(vPieces, 16);
+            std::set<std::string> qualifiers, qualifiersExpected;
+            ExtractVerifierStringQualifiers(verifier, qualifiers);
+            regex_reference::ExtractVerifierStringQualifiers(verifier, qualifiersExpected);
+            BOOST_CHECK_MESSAGE(qualifiers == qualifiersExpected, verifier);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
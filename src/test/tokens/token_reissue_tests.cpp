@@ -33,18 +33,18 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
 
         // Add an token to a valid paladeum address
         uint256 hash = uint256();
-        BOOST_CHECK_MESSAGE(cache.AddNewToken(token1, GetParams().GlobalFeeAddress(), 0, hash), "Failed to add new token");
+        BOOST_CHECK_MESSAGE(cache.AddNewToken(token1, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), 0, hash), "Failed to add new token");
 
         // Create a reissuance of the token
         CReissueToken reissue1("PLBTOKEN", CAmount(1 * COIN), 8, 1, DecodeTokenData("QmacSRmrkVmvJfbCpmU6pK72furJ8E8fbKHindrLxmYMQo"));
         COutPoint out(uint256S("BF50CB9A63BE0019171456252989A459A7D0A5F494735278290079D22AB704A4"), 1);
 
         // Add an reissuance of the token to the cache
-        BOOST_CHECK_MESSAGE(cache.AddReissueToken(reissue1, GetParams().GlobalFeeAddress(), out), "Failed to add reissue");
+        BOOST_CHECK_MESSAGE(cache.AddReissueToken(reissue1, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), out), "Failed to add reissue");
 
         // Check to see if the reissue changed the cache data correctly
         BOOST_CHECK_MESSAGE(cache.mapReissuedTokenData.count("PLBTOKEN"), "Map Reissued Token should contain the token \"PLBTOKEN\"");
-        BOOST_CHECK_MESSAGE(cache.mapTokensAddressAmount.at(make_pair("PLBTOKEN", GetParams().GlobalFeeAddress())) == CAmount(101 * COIN), "Reissued amount wasn't added to the previous total");
+        BOOST_CHECK_MESSAGE(cache.mapTokensAddressAmount.at(std::make_pair("PLBTOKEN", CTokenAddress::FromString(GetParams().GlobalFeeAddress()))) == CAmount(101 * COIN), "Reissued amount wasn't added to the previous total");
 
         // Get the new token data from the cache
         CNewToken token2;
@@ -60,7 +60,7 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
         // Remove the reissue from the cache
         std::vector<std::pair<std::string, CBlockTokenUndo> > undoBlockData;
         undoBlockData.emplace_back(std::make_pair("PLBTOKEN", CBlockTokenUndo{true, false, "", 0, TOKEN_UNDO_INCLUDES_VERIFIER_STRING, false, ""}));
-        BOOST_CHECK_MESSAGE(cache.RemoveReissueToken(reissue1, GetParams().GlobalFeeAddress(), out, undoBlockData), "Failed to remove reissue");
+        BOOST_CHECK_MESSAGE(cache.RemoveReissueToken(reissue1, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), out, undoBlockData), "Failed to remove reissue");
 
         // Get the token data from the cache now that the reissuance was removed
         CNewToken token3;
@@ -75,7 +75,7 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
 
         // Check to see if the reissue removal updated the cache correctly
         BOOST_CHECK_MESSAGE(cache.mapReissuedTokenData.count("PLBTOKEN"), "Map of reissued data was removed, even though changes were made and not databased yet");
-        BOOST_CHECK_MESSAGE(cache.mapTokensAddressAmount.at(make_pair("PLBTOKEN", GetParams().GlobalFeeAddress())) == CAmount(100 * COIN), "Tokens total wasn't undone when reissuance was");
+        BOOST_CHECK_MESSAGE(cache.mapTokensAddressAmount.at(std::make_pair("PLBTOKEN", CTokenAddress::FromString(GetParams().GlobalFeeAddress()))) == CAmount(100 * COIN), "Tokens total wasn't undone when reissuance was");
     }
 
     BOOST_AUTO_TEST_CASE(reissue_cache_test_txid)
@@ -93,18 +93,18 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
 
         // Add an token to a valid paladeum address
         uint256 hash = uint256();
-        BOOST_CHECK_MESSAGE(cache.AddNewToken(token1, GetParams().GlobalFeeAddress(), 0, hash), "Failed to add new token");
+        BOOST_CHECK_MESSAGE(cache.AddNewToken(token1, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), 0, hash), "Failed to add new token");
 
         // Create a reissuance of the token
         CReissueToken reissue1("PLBTOKEN", CAmount(1 * COIN), 8, 1, DecodeTokenData("9c2c8e121a0139ba39bffd3ca97267bca9d4c0c1e84ac0c34a883c28e7a912ca"));
         COutPoint out(uint256S("BF50CB9A63BE0019171456252989A459A7D0A5F494735278290079D22AB704A4"), 1);
 
         // Add an reissuance of the token to the cache
-        BOOST_CHECK_MESSAGE(cache.AddReissueToken(reissue1, GetParams().GlobalFeeAddress(), out), "Failed to add reissue");
+        BOOST_CHECK_MESSAGE(cache.AddReissueToken(reissue1, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), out), "Failed to add reissue");
 
         // Check to see if the reissue changed the cache data correctly
         BOOST_CHECK_MESSAGE(cache.mapReissuedTokenData.count("PLBTOKEN"), "Map Reissued Token should contain the token \"PLBTOKEN\"");
-        BOOST_CHECK_MESSAGE(cache.mapTokensAddressAmount.at(make_pair("PLBTOKEN", GetParams().GlobalFeeAddress())) == CAmount(101 * COIN), "Reissued amount wasn't added to the previous total");
+        BOOST_CHECK_MESSAGE(cache.mapTokensAddressAmount.at(std::make_pair("PLBTOKEN", CTokenAddress::FromString(GetParams().GlobalFeeAddress()))) == CAmount(101 * COIN), "Reissued amount wasn't added to the previous total");
 
         // Get the new token data from the cache
         CNewToken token2;
@@ -120,7 +120,7 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
         // Remove the reissue from the cache
         std::vector<std::pair<std::string, CBlockTokenUndo> > undoBlockData;
         undoBlockData.emplace_back(std::make_pair("PLBTOKEN", CBlockTokenUndo{true, false, "", 0, TOKEN_UNDO_INCLUDES_VERIFIER_STRING, false, ""}));
-        BOOST_CHECK_MESSAGE(cache.RemoveReissueToken(reissue1, GetParams().GlobalFeeAddress(), out, undoBlockData), "Failed to remove reissue");
+        BOOST_CHECK_MESSAGE(cache.RemoveReissueToken(reissue1, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), out, undoBlockData), "Failed to remove reissue");
 
         // Get the token data from the cache now that the reissuance was removed
         CNewToken token3;
@@ -135,7 +135,7 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
 
         // Check to see if the reissue removal updated the cache correctly
         BOOST_CHECK_MESSAGE(cache.mapReissuedTokenData.count("PLBTOKEN"), "Map of reissued data was removed, even though changes were made and not databased yet");
-        BOOST_CHECK_MESSAGE(cache.mapTokensAddressAmount.at(make_pair("PLBTOKEN", GetParams().GlobalFeeAddress())) == CAmount(100 * COIN), "Tokens total wasn't undone when reissuance was");
+        BOOST_CHECK_MESSAGE(cache.mapTokensAddressAmount.at(std::make_pair("PLBTOKEN", CTokenAddress::FromString(GetParams().GlobalFeeAddress()))) == CAmount(100 * COIN), "Tokens total wasn't undone when reissuance was");
     }
 
 
@@ -151,7 +151,7 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
         CNewToken token1("PLBTOKEN", CAmount(100 * COIN), 8, 1, 0, "");
 
         // Add an token to a valid paladeum address
-        BOOST_CHECK_MESSAGE(cache.AddNewToken(token1, GetParams().GlobalFeeAddress(), 0, uint256()), "Failed to add new token");
+        BOOST_CHECK_MESSAGE(cache.AddNewToken(token1, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), 0, uint256()), "Failed to add new token");
 
         // Create a reissuance of the token that is valid
         CReissueToken reissue1("PLBTOKEN", CAmount(1 * COIN), 8, 1, DecodeTokenData("QmacSRmrkVmvJfbCpmU6pK72furJ8E8fbKHindrLxmYMQo"));
@@ -178,7 +178,7 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
         CNewToken token2("PLBTOKEN2", CAmount(100 * COIN), 0, 1, 0, "");
 
         // Add new token2 to a valid paladeum address
-        BOOST_CHECK_MESSAGE(cache.AddNewToken(token2, GetParams().GlobalFeeAddress(), 0, uint256()), "Failed to add new token");
+        BOOST_CHECK_MESSAGE(cache.AddNewToken(token2, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), 0, uint256()), "Failed to add new token");
 
         // Create a reissuance of the token that is valid unit go from 0 -> 1 and change the ipfs hash
         CReissueToken reissue5("PLBTOKEN2", CAmount(1 * COIN), 1, 1, DecodeTokenData("QmacSRmrkVmvJfbCpmU6pK72furJ8E8fbKHindrLxmYMQo"));
@@ -194,7 +194,7 @@ BOOST_FIXTURE_TEST_SUITE(token_reissue_tests, BasicTestingSetup)
         CNewToken token3("DATAHASH", CAmount(100 * COIN), 8, 1, 0, "");
 
         // Add new token3 to a valid paladeum address
-        BOOST_CHECK_MESSAGE(cache.AddNewToken(token3, GetParams().GlobalFeeAddress(), 0, uint256()), "Failed to add new token");
+        BOOST_CHECK_MESSAGE(cache.AddNewToken(token3, CTokenAddress::FromString(GetParams().GlobalFeeAddress()), 0, uint256()), "Failed to add new token");
 
         // Create a reissuance of the token that is valid txid but messaging isn't active in unit tests
         CReissueToken reissue7("DATAHASH", CAmount(1 * COIN), 8, 1, DecodeTokenData("9c2c8e121a0139ba39bffd3ca97267bca9d4c0c1e84ac0c34a883c28e7a912ca"));
@@ -545,4 +545,41 @@ BOOST_FIXTURE_TEST_SUITE(token_tx_tests, BasicTestingSetup)
     }
 #endif
 
+    BOOST_AUTO_TEST_CASE(token_tx_decoded_outputs_test)
+    {
+        BOOST_TEST_MESSAGE("Running Token TX Decoded Outputs Test");
+
+        SelectParams(CBaseChainParams::MAIN);
+
+        CTxDestination dest = DecodeDestination(GetParams().GlobalFeeAddress());
+
+        // Create a transfer token output with a timelock and a plain PLB output
+        CTokenTransfer token("PLBTEST", 1000, 500);
+        CScript scriptPubKey = GetScriptForDestination(dest);
+        token.ConstructTransaction(scriptPubKey);
+
+        CMutableTransaction mutTx;
+        mutTx.vout.emplace_back(CTxOut(0, scriptPubKey));
+        mutTx.vout.emplace_back(CTxOut(1000, GetScriptForDestination(dest)));
+        CTransaction tx(mutTx);
+
+        const CTokenOutputEntry* data = tx.GetTokenOutput(0);
+        BOOST_REQUIRE(data);
+        BOOST_CHECK(data->type == TX_TRANSFER_TOKEN);
+        BOOST_CHECK(data->tokenName == "PLBTEST");
+        BOOST_CHECK(data->nAmount == 1000);
+        BOOST_CHECK(data->nTimeLock == 500);
+        BOOST_CHECK(data->destination == dest);
+        BOOST_CHECK(data->vout == 0);
+
+        // Later calls and copies of the transaction share the decoded outputs
+        BOOST_CHECK(tx.GetTokenOutput(0) == data);
+        CTransaction txCopy(tx);
+        BOOST_CHECK(txCopy.GetTokenOutput(0) == data);
+
+        // Outputs that aren't tokens, or don't exist, have no token data
+        BOOST_CHECK(!tx.GetTokenOutput(1));
+        BOOST_CHECK(!tx.GetTokenOutput(2));
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
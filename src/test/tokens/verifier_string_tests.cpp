@@ -367,4 +367,50 @@ BOOST_FIXTURE_TEST_SUITE(verifier_string_tests, BasicTestingSetup)
     }
 
 
+    BOOST_AUTO_TEST_CASE(compiled_formula_test)
+    {
+        BOOST_TEST_MESSAGE("Running Compiled Formula Test");
+
+        const std::vector<std::string> vVariables = {"A", "B", "C"};
+        const std::vector<std::string> vPieces = {"A", "B", "C", "!", "(", ")", "&", "|", "1", "0", " ", "#A", "D", "-"};
+
+        // Compiling must fail exactly when resolving fails, and evaluate to the same value otherwise
+        for (int i = 0; i < 5000; i++) {
+            std::string formula;
+            int nPieces = 1 + InsecureRandRange(12);
+            for (int j = 0; j < nPieces; j++)
+                formula += vPieces[InsecureRandRange(vPieces.size())];
+
+            LibBoolEE::Formula compiled;
+            bool fCompiled = true;
+            try {
+                LibBoolEE::compile(formula, vVariables, compiled);
+            } catch (const std::runtime_error&) {
+                fCompiled = false;
+            }
+
+            for (uint64_t values = 0; values < 8; values++) {
+                LibBoolEE::Vals vals;
+                for (size_t n = 0; n < vVariables.size(); n++)
+                    vals.insert(std::make_pair(vVariables[n], (values >> n) & 1));
+
+                try {
+                    bool fResult = LibBoolEE::resolve(formula, vals);
+                    BOOST_CHECK_MESSAGE(fCompiled && LibBoolEE::evaluate(compiled, values) == fResult, formula);
+                } catch (const std::runtime_error&) {
+                    BOOST_CHECK_MESSAGE(!fCompiled, formula);
+                }
+            }
+        }
+
+        // Checking a verifier string again comes from the cache and gives the same qualifiers
+        for (int i = 0; i < 2; i++) {
+            std::set<std::string> setFoundQualifiers;
+            std::string error;
+            BOOST_CHECK(CheckVerifierString("KYC & !(AML | USA)", setFoundQualifiers, error));
+            BOOST_CHECK(setFoundQualifiers == std::set<std::string>({"KYC", "AML", "USA"}));
+            BOOST_CHECK(!CheckVerifierString("KYC & & AML", setFoundQualifiers, error));
+        }
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
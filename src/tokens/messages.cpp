@@ -12,6 +12,8 @@
 #include "mytokensdb.h"
 #include <primitives/block.h>
 
+#include <algorithm>
+
 
 std::set<COutPoint> setDirtyMessagesRemove;
 std::map<COutPoint, CMessage> mapDirtyMessagesAdd;
@@ -19,10 +21,11 @@ std::map<COutPoint, CMessage> mapDirtyMessagesOrphaned;
 
 std::set<std::string> setDirtyChannelsAdd;
 std::set<std::string> setDirtyChannelsRemove;
-std::set<std::string> setSubscribedChannelsAskedForFalse;
 
 std::set<std::string> setDirtySeenAddressAdd;
-std::set<std::string> setAddressAskedForFalse;
+
+std::unordered_set<std::string> setSubscribedChannels;
+std::unordered_set<std::string> setSeenAddresses;
 
 CCriticalSection cs_messaging;
 
@@ -67,7 +70,7 @@ CMessage::CMessage(const COutPoint& out, const std::string& strName, const std::
 
 bool IsChannelSubscribed(const std::string &name)
 {
-    if (!pMessageSubscribedChannelsCache || !pmessagechanneldb)
+    if (!pmessagechanneldb)
         return false;
 
     // Check Dirty Cache for newly added channel additions
@@ -78,24 +81,8 @@ bool IsChannelSubscribed(const std::string &name)
     if (setDirtyChannelsRemove.count(name))
         return false;
 
-    // Check the Channel Cache and see if it is in the Cache
-    if (pMessageSubscribedChannelsCache->Exists(name))
-        return true;
-
-    // Check if we have already searched for this before
-    if (setSubscribedChannelsAskedForFalse.count(name))
-        return false;
-
-    // Check to see if the message database contains the token
-    if (pmessagechanneldb->ReadMyMessageChannel(name)) {
-        pMessageSubscribedChannelsCache->Put(name, 1);
-        return true;
-    }
-
-    // Help prevent spam and unneeded database reads
-    setSubscribedChannelsAskedForFalse.insert(name);
-
-    return false;
+    // Check the channels already in the database
+    return setSubscribedChannels.count(name) > 0;
 }
 
 bool GetMessage(const COutPoint& out, CMessage& message)
@@ -114,10 +101,8 @@ bool GetMessage(const COutPoint& out, CMessage& message)
         return false;
 
     // Check database cache
-    if (pMessagesCache->Exists(out.ToSerializedString())) {
-        message = pMessagesCache->Get(out.ToSerializedString());
+    if (pMessagesCache->TryGet(out.ToSerializedString(), message))
         return true;
-    }
 
     // Check the database
     if (pmessagedb->ReadMessage(out, message)) {
@@ -135,7 +120,6 @@ void AddChannel(const std::string &name)
 
     // If the channel name is in the dirty remove cache. Remove it so it doesn't get deleted on flush
     setDirtyChannelsRemove.erase(name);
-    setSubscribedChannelsAskedForFalse.erase(name);
 }
 
 void RemoveChannel(const std::string &name)
@@ -188,10 +172,37 @@ void OrphanMessage(const CMessage& message)
 }
 
 #ifdef ENABLE_WALLET
-bool ScanForMessageChannels(std::string& strError)
+/** Subscribes to the channels a token output of the wallet gives access to */
+static void ScanTokenOutputForMessageChannels(const CTokenOutputEntry& tokenData)
 {
-    LOCK2(cs_messaging, cs_main);
+    KnownTokenType type;
+    IsTokenNameValid(tokenData.tokenName, type);
+
+    if (tokenData.type == TX_TRANSFER_TOKEN) {
+        if (type == KnownTokenType::MSGCHANNEL || type == KnownTokenType::OWNER) { // Subscribe to any channels or owner tokens you own
+            AddChannel(tokenData.tokenName);
+            AddAddressSeen(tokenData.address.ToString());
+        } else if (type == KnownTokenType::ROOT || type == KnownTokenType::SUB) { // Subscribe to any tokens you are sent, if they are sent to a new address
+            if (!IsChannelSubscribed(tokenData.tokenName + OWNER_TAG)) {
+                if (!IsAddressSeen(tokenData.address.ToString())) {
+                    AddChannel(tokenData.tokenName + OWNER_TAG);
+                    AddAddressSeen(tokenData.address.ToString());
+                }
+            }
+        }
+    } else if (tokenData.type == TX_NEW_TOKEN || tokenData.type == TX_REISSUE_TOKEN) {
+        if (type == KnownTokenType::OWNER || type == KnownTokenType::MSGCHANNEL) {
+            AddChannel(tokenData.tokenName);
+            AddAddressSeen(tokenData.address.ToString());
+        } else if (type == KnownTokenType::ROOT || type == KnownTokenType::SUB || type == KnownTokenType::RESTRICTED) {
+            AddChannel(tokenData.tokenName + "!");
+            AddAddressSeen(tokenData.address.ToString());
+        }
+    }
+}
 
+bool ScanForMessageChannels(std::string& strError)
+{
     LogPrintf("%s : Start Scanning For Message Channels\n", __func__);
 
     if (vpwallets.size() == 0) {
@@ -199,66 +210,46 @@ bool ScanForMessageChannels(std::string& strError)
         return false;
     }
 
-    CBlockIndex* blockIndex = chainActive[0];
+    CWallet* pwallet = vpwallets[0];
+
+    // The wallet already holds every confirmed transaction paying it, so only those have to be looked at instead of
+    // every block of the chain. Whether a channel is subscribed depends on the addresses seen before, so the token
+    // outputs are collected in chain order (height, then position in the block) and processed after cs_main is released.
+    std::vector<std::pair<std::pair<int, int>, std::vector<CTokenOutputEntry> > > vTokenOutputs;
+    {
+        LOCK2(cs_main, pwallet->cs_wallet);
+
+        for (const auto& item : pwallet->mapWallet) {
+            const CWalletTx& wtx = item.second;
+            const CBlockIndex* pindex = nullptr;
+            if (wtx.GetDepthInMainChain(pindex) <= 0 || !pindex)
+                continue;
+
+            std::vector<CTokenOutputEntry> vout;
+            for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+                const CTokenOutputEntry* tokenData = wtx.tx->GetTokenOutput(i);
+                if (tokenData && pwallet->IsMine(wtx.tx->vout[i]) == ISMINE_SPENDABLE) // Is the out mine
+                    vout.push_back(*tokenData);
+            }
 
-    while (blockIndex) {
-        CBlock block;
-        if (!ReadBlockFromDisk(block, blockIndex, GetParams().GetConsensus())) {
-            strError = "Block not found on disk";
-            return false;
+            if (!vout.empty())
+                vTokenOutputs.emplace_back(std::make_pair(pindex->nHeight, wtx.nIndex), std::move(vout));
         }
+    }
 
-        for (const auto& tx : block.vtx) {
+    std::sort(vTokenOutputs.begin(), vTokenOutputs.end(),
+              [](const std::pair<std::pair<int, int>, std::vector<CTokenOutputEntry> >& a, const std::pair<std::pair<int, int>, std::vector<CTokenOutputEntry> >& b) {
+                  return a.first < b.first;
+              });
 
-            auto ptx = tx.get();
-            if (!ptx) {
-                strError = "Failed to get transaction pointer";
-                return false;
-            }
+    LOCK(cs_messaging);
 
-            for (auto out : ptx->vout) {
-                int nType = 0;
-                bool fOwner = false;
-                if (vpwallets[0]->IsMine(out) == ISMINE_SPENDABLE) { // Is the out mine
-                    if (out.scriptPubKey.IsTokenScript(nType, fOwner)) {
-                        CTokenOutputEntry tokenData;
-                        // Get the token data from the script
-                        if (GetTokenData(out.scriptPubKey, tokenData)) {
-                            KnownTokenType type;
-                            IsTokenNameValid(tokenData.tokenName, type);
-
-                            if (tokenData.type == TX_TRANSFER_TOKEN) {
-                                if (type == KnownTokenType::MSGCHANNEL || type == KnownTokenType::OWNER) { // Subscribe to any channels or owner tokens you own
-                                    AddChannel(tokenData.tokenName);
-                                    AddAddressSeen(EncodeDestination(tokenData.destination));
-                                } else if (type == KnownTokenType::ROOT || type == KnownTokenType::SUB) { // Subscribe to any tokens you are sent, if they are sent to a new address
-                                    if (!IsChannelSubscribed(tokenData.tokenName + OWNER_TAG)) {
-                                        if (!IsAddressSeen(EncodeDestination(tokenData.destination))) {
-                                            AddChannel(tokenData.tokenName + OWNER_TAG);
-                                            AddAddressSeen(EncodeDestination(tokenData.destination));
-                                        }
-                                    }
-                                }
-                            } else if (tokenData.type == TX_NEW_TOKEN || tokenData.type == TX_REISSUE_TOKEN) {
-                                if (fOwner || type == KnownTokenType::MSGCHANNEL) {
-                                    AddChannel(tokenData.tokenName);
-                                    AddAddressSeen(EncodeDestination(tokenData.destination));
-                                } else if (type == KnownTokenType::ROOT || type == KnownTokenType::SUB || type == KnownTokenType::RESTRICTED) {
-                                    AddChannel(tokenData.tokenName + "!");
-                                    AddAddressSeen(EncodeDestination(tokenData.destination));
-                                }
-                            }
-                        } else {
-                            LogPrintf("%s : Failed to get GetTokenData call\n", __func__);
-                        }
-                    }
-                }
-            }
-        }
-        blockIndex = chainActive[blockIndex->nHeight + 1];
+    for (const auto& item : vTokenOutputs) {
+        for (const auto& tokenData : item.second)
+            ScanTokenOutputForMessageChannels(tokenData);
     }
 
-    LogPrintf("%s : Finished Scanning For Message Channels. Subscribed Messages Channels Found: %u\n", __func__, setDirtyChannelsAdd.size());
+    LogPrintf("%s : Finished Scanning For Message Channels. Transactions With Token Outputs: %u, Subscribed Messages Channels Found: %u\n", __func__, vTokenOutputs.size(), setDirtyChannelsAdd.size());
     
     if (setDirtyChannelsAdd.size() > 0) {
         for (auto item : setDirtyChannelsAdd) {
@@ -273,34 +264,18 @@ bool ScanForMessageChannels(std::string& strError)
 
 bool IsAddressSeen(const std::string &address)
 {
-    if (!pmessagechanneldb || !pMessagesSeenAddressCache)
+    if (!pmessagechanneldb)
         return false;
 
     if (setDirtySeenAddressAdd.count(address)) // Check dirty set
         return true;
 
-    if (pMessagesSeenAddressCache->Exists(address)) {
-        return true;
-    }
-
-    if (setAddressAskedForFalse.count(address)) {
-        return false;
-    }
-
-    if (pmessagechanneldb->ReadUsedAddress(address)) {
-        pMessagesSeenAddressCache->Put(address, 1);
-        return true;
-    }
-
-    setAddressAskedForFalse.insert(address);
-
-    return false;
+    return setSeenAddresses.count(address) > 0;
 }
 
 void AddAddressSeen(const std::string &address)
 {
     setDirtySeenAddressAdd.insert(address);
-    setSubscribedChannelsAskedForFalse.erase(address);
 }
 
 size_t GetMessageDirtyCacheSize()
@@ -327,11 +302,9 @@ size_t GetMessageDirtyCacheSize()
     // Message Channel Caches
     size += 32 * setDirtyChannelsAdd.size();
     size += 32 * setDirtyChannelsRemove.size();
-    size += 32 * setSubscribedChannelsAskedForFalse.size();
 
     // Address Seen Caches
     size += 32 * setDirtySeenAddressAdd.size();
-    size += 32 * setAddressAskedForFalse.size();
 
     return size;
 }
@@ -7,9 +7,12 @@
 #ifndef PLBCOIN_MESSAGES_H
 #define PLBCOIN_MESSAGES_H
 
+#include <memusage.h>
 #include <uint256.h>
 #include <serialize.h>
 
+#include <unordered_set>
+
 class CMessage;
 class COutPoint;
 
@@ -21,15 +24,21 @@ extern std::map<COutPoint, CMessage> mapDirtyMessagesOrphaned;
 // Message Channel Database caches
 extern std::set<std::string> setDirtyChannelsAdd;
 extern std::set<std::string> setDirtyChannelsRemove;
-extern std::set<std::string> setSubscribedChannelsAskedForFalse;
 
 // Spam prevention address index
 extern std::set<std::string> setDirtySeenAddressAdd;
-extern std::set<std::string> setAddressAskedForFalse;
+
+// Every channel and seen address stored in the message channel database, loaded at startup and kept up to date when
+// the dirty sets are flushed, so looking them up never reads the database
+extern std::unordered_set<std::string> setSubscribedChannels;
+extern std::unordered_set<std::string> setSeenAddresses;
 
 // Lock for messaging
 extern CCriticalSection cs_messaging;
 
+// Memory each of the message LRU caches may use
+#define MAX_CACHE_MESSAGES_BYTES (1 << 20)
+
 size_t GetMessageDirtyCacheSize();
 bool IsChannelSubscribed(const std::string &name); // Is this channel marked as spamA
 
@@ -48,6 +57,7 @@ void OrphanMessage(const CMessage &message);
 void OrphanMessage(const COutPoint &out);
 
 #ifdef ENABLE_WALLET
+/** Subscribes to the channels of the tokens the wallet received or issued, from the wallet's own transactions */
 bool ScanForMessageChannels(std::string& strError);
 #endif
 bool IsAddressSeen(const std::string &address); // Has this address already been sent an token before
@@ -124,6 +134,10 @@ public:
     }
 };
 
+static inline size_t RecursiveDynamicUsage(const CMessage& message) {
+    return memusage::DynamicUsage(message.strName) + memusage::DynamicUsage(message.ipfsHash);
+}
+
 class CZMQMessage {
 public:
     int blockHeight;
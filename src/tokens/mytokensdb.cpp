@@ -144,7 +144,7 @@ bool CMessageChannelDB::EraseMyMessageChannel(const std::string& channelname)
     return Erase(std::make_pair(MY_MESSAGE_CHANNEL, channelname));
 }
 
-bool CMessageChannelDB::LoadMyMessageChannels(std::set<std::string>& setChannels)
+bool CMessageChannelDB::LoadMyMessageChannels(std::unordered_set<std::string>& setChannels)
 {
     setChannels.clear();
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
@@ -195,6 +195,28 @@ bool CMessageChannelDB::EraseUsedAddress(const std::string& address)
     return Erase(std::make_pair(MY_SEEN_ADDRESSES, address));
 }
 
+bool CMessageChannelDB::LoadUsedAddresses(std::unordered_set<std::string>& setAddresses)
+{
+    setAddresses.clear();
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(MY_SEEN_ADDRESSES, std::string()));
+
+    // Load seen addresses
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, std::string> key;
+        if (pcursor->GetKey(key) && key.first == MY_SEEN_ADDRESSES) {
+            setAddresses.insert(key.second);
+            pcursor->Next();
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
+
 bool CMessageChannelDB::WriteFlag(const std::string &name, bool fValue)
 {
     return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
@@ -216,23 +238,24 @@ bool CMessageChannelDB::Flush() {
         for (auto channelRemove : setDirtyChannelsRemove) {
             if (!EraseMyMessageChannel(channelRemove))
                 return error("%s: failed to erase messagechannel %s", __func__, channelRemove);
+            setSubscribedChannels.erase(channelRemove);
         }
 
         for (auto channelAdd : setDirtyChannelsAdd) {
             if (!WriteMyMessageChannel(channelAdd))
                 return error("%s: failed to write messagechannel %s", __func__, channelAdd);
+            setSubscribedChannels.insert(channelAdd);
         }
 
         for (auto seenAddress : setDirtySeenAddressAdd) {
             if (!WriteUsedAddress(seenAddress))
                 return error("%s: failed to write seenaddress %s", __func__, seenAddress);
+            setSeenAddresses.insert(seenAddress);
         }
 
         setDirtyChannelsRemove.clear();
         setDirtyChannelsAdd.clear();
         setDirtySeenAddressAdd.clear();
-        setSubscribedChannelsAskedForFalse.clear();
-        setAddressAskedForFalse.clear();
     } catch (const std::runtime_error& e) {
         return error("%s : %s ", __func__, std::string("System error while flushing messagechannels: ") + e.what());
     }
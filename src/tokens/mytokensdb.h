@@ -8,6 +8,8 @@
 
 #include <dbwrapper.h>
 
+#include <unordered_set>
+
 class CMessage;
 class COutPoint;
 
@@ -44,11 +46,12 @@ public:
     bool WriteMyMessageChannel(const std::string& channelname);
     bool ReadMyMessageChannel(const std::string& channelname);
     bool EraseMyMessageChannel(const std::string& channelname);
-    bool LoadMyMessageChannels(std::set<std::string>& setChannels);
+    bool LoadMyMessageChannels(std::unordered_set<std::string>& setChannels);
 
     bool WriteUsedAddress(const std::string& address);
     bool ReadUsedAddress(const std::string& address);
     bool EraseUsedAddress(const std::string& address);
+    bool LoadUsedAddresses(std::unordered_set<std::string>& setAddresses);
 
     // Write / Read Database flags
     bool WriteFlag(const std::string &name, bool fValue);
@@ -14,6 +14,9 @@ static const char ADDRESS_QULAIFIER_FLAG = 'T';
 static const char QULAIFIER_ADDRESS_FLAG = 'Q';
 static const char RESTRICTED_ADDRESS_FLAG = 'R';
 static const char GLOBAL_RESTRICTION_FLAG = 'G';
+static const char BEST_BLOCK_FLAG = 'B';
+
+static const std::string ADDRESS_KEYS_FLAG = "addresskeys";
 
 
 
@@ -37,56 +40,56 @@ bool CRestrictedDB::EraseVerifier(const std::string& tokenName)
 }
 
 // Address Tags
-bool CRestrictedDB::WriteAddressQualifier(const std::string &address, const std::string &tag)
+bool CRestrictedDB::WriteAddressQualifier(const CTokenAddress& address, const std::string &tag)
 {
     int8_t i = 1;
     return Write(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, tag)), i);
 }
 
-bool CRestrictedDB::ReadAddressQualifier(const std::string &address, const std::string &tag)
+bool CRestrictedDB::ReadAddressQualifier(const CTokenAddress& address, const std::string &tag)
 {
     int8_t i;
     return Read(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, tag)), i);
 }
 
-bool CRestrictedDB::EraseAddressQualifier(const std::string &address, const std::string &tag)
+bool CRestrictedDB::EraseAddressQualifier(const CTokenAddress& address, const std::string &tag)
 {
     return Erase(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, tag)));
 }
 
 // Address Tags
-bool CRestrictedDB::WriteQualifierAddress(const std::string &address, const std::string &tag)
+bool CRestrictedDB::WriteQualifierAddress(const CTokenAddress& address, const std::string &tag)
 {
     int8_t i = 1;
     return Write(std::make_pair(QULAIFIER_ADDRESS_FLAG, std::make_pair(tag, address)), i);
 }
 
-bool CRestrictedDB::ReadQualifierAddress(const std::string &address, const std::string &tag)
+bool CRestrictedDB::ReadQualifierAddress(const CTokenAddress& address, const std::string &tag)
 {
     int8_t i;
     return Read(std::make_pair(QULAIFIER_ADDRESS_FLAG, std::make_pair(tag, address)), i);
 }
 
-bool CRestrictedDB::EraseQualifierAddress(const std::string &address, const std::string &tag)
+bool CRestrictedDB::EraseQualifierAddress(const CTokenAddress& address, const std::string &tag)
 {
     return Erase(std::make_pair(QULAIFIER_ADDRESS_FLAG, std::make_pair(tag, address)));
 }
 
 
 // Address Restriction
-bool CRestrictedDB::WriteRestrictedAddress(const std::string& address, const std::string& tokenName)
+bool CRestrictedDB::WriteRestrictedAddress(const CTokenAddress& address, const std::string& tokenName)
 {
     int8_t i = 1;
     return Write(std::make_pair(RESTRICTED_ADDRESS_FLAG, std::make_pair(address, tokenName)), i);
 }
 
-bool CRestrictedDB::ReadRestrictedAddress(const std::string& address, const std::string& tokenName)
+bool CRestrictedDB::ReadRestrictedAddress(const CTokenAddress& address, const std::string& tokenName)
 {
     int8_t i;
     return Read(std::make_pair(RESTRICTED_ADDRESS_FLAG, std::make_pair(address, tokenName)), i);
 }
 
-bool CRestrictedDB::EraseRestrictedAddress(const std::string& address, const std::string& tokenName)
+bool CRestrictedDB::EraseRestrictedAddress(const CTokenAddress& address, const std::string& tokenName)
 {
     return Erase(std::make_pair(RESTRICTED_ADDRESS_FLAG, std::make_pair(address, tokenName)));
 }
@@ -109,6 +112,80 @@ bool CRestrictedDB::EraseGlobalRestriction(const std::string& tokenName)
     return Erase(std::make_pair(GLOBAL_RESTRICTION_FLAG, tokenName));
 }
 
+// Batched changes
+void CRestrictedDB::WriteVerifier(CDBOrderedBatch& batch, const std::string& tokenName, const std::string& verifier)
+{
+    batch.Write(std::make_pair(VERIFIER_FLAG, tokenName), verifier);
+}
+
+void CRestrictedDB::EraseVerifier(CDBOrderedBatch& batch, const std::string& tokenName)
+{
+    batch.Erase(std::make_pair(VERIFIER_FLAG, tokenName));
+}
+
+void CRestrictedDB::WriteAddressQualifier(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string &tag)
+{
+    int8_t i = 1;
+    batch.Write(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, tag)), i);
+}
+
+void CRestrictedDB::EraseAddressQualifier(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string &tag)
+{
+    batch.Erase(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, tag)));
+}
+
+void CRestrictedDB::WriteQualifierAddress(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string &tag)
+{
+    int8_t i = 1;
+    batch.Write(std::make_pair(QULAIFIER_ADDRESS_FLAG, std::make_pair(tag, address)), i);
+}
+
+void CRestrictedDB::EraseQualifierAddress(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string &tag)
+{
+    batch.Erase(std::make_pair(QULAIFIER_ADDRESS_FLAG, std::make_pair(tag, address)));
+}
+
+void CRestrictedDB::WriteRestrictedAddress(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string& tokenName)
+{
+    int8_t i = 1;
+    batch.Write(std::make_pair(RESTRICTED_ADDRESS_FLAG, std::make_pair(address, tokenName)), i);
+}
+
+void CRestrictedDB::EraseRestrictedAddress(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string& tokenName)
+{
+    batch.Erase(std::make_pair(RESTRICTED_ADDRESS_FLAG, std::make_pair(address, tokenName)));
+}
+
+void CRestrictedDB::WriteGlobalRestriction(CDBOrderedBatch& batch, const std::string& tokenName)
+{
+    int8_t i = 1;
+    batch.Write(std::make_pair(GLOBAL_RESTRICTION_FLAG, tokenName), i);
+}
+
+void CRestrictedDB::EraseGlobalRestriction(CDBOrderedBatch& batch, const std::string& tokenName)
+{
+    batch.Erase(std::make_pair(GLOBAL_RESTRICTION_FLAG, tokenName));
+}
+
+bool CRestrictedDB::WriteRestrictedBatch(const CDBOrderedBatch& batch, const uint256& hashBlock, size_t& nBytes)
+{
+    CDBBatch dbBatch(*this);
+    batch.AddTo(dbBatch);
+    if (!hashBlock.IsNull())
+        dbBatch.Write(BEST_BLOCK_FLAG, hashBlock);
+
+    nBytes = dbBatch.SizeEstimate();
+    return WriteBatch(dbBatch);
+}
+
+uint256 CRestrictedDB::GetBestBlock() const
+{
+    uint256 hashBestBlock;
+    if (!Read(BEST_BLOCK_FLAG, hashBestBlock))
+        return uint256();
+    return hashBestBlock;
+}
+
 bool CRestrictedDB::WriteFlag(const std::string &name, bool fValue)
 {
     return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
@@ -123,18 +200,18 @@ bool CRestrictedDB::ReadFlag(const std::string &name, bool &fValue)
     return true;
 }
 
-bool CRestrictedDB::GetQualifierAddresses(std::string& qualifier, std::vector<std::string>& addresses)
+bool CRestrictedDB::GetQualifierAddresses(std::string& qualifier, std::vector<CTokenAddress>& addresses)
 {
     FlushStateToDisk();
 
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
-    pcursor->Seek(std::make_pair(QULAIFIER_ADDRESS_FLAG, std::make_pair(qualifier, std::string())));
+    pcursor->Seek(std::make_pair(QULAIFIER_ADDRESS_FLAG, std::make_pair(qualifier, CTokenAddress())));
 
     // Load all qualifiers related to that given address
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
-        std::pair<char, std::pair<std::string, std::string> > key;
+        std::pair<char, std::pair<std::string, CTokenAddress> > key;
         if (pcursor->GetKey(key) && key.first == QULAIFIER_ADDRESS_FLAG && key.second.first == qualifier) {
             addresses.emplace_back(key.second.second);
             pcursor->Next();
@@ -146,7 +223,7 @@ bool CRestrictedDB::GetQualifierAddresses(std::string& qualifier, std::vector<st
     return true;
 }
 
-bool CRestrictedDB::CheckForAddressRootQualifier(const std::string& address, const std::string& qualifier)
+bool CRestrictedDB::CheckForAddressRootQualifier(const CTokenAddress& address, const std::string& qualifier)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
@@ -155,7 +232,7 @@ bool CRestrictedDB::CheckForAddressRootQualifier(const std::string& address, con
     // Load all qualifiers related to that given address
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
-        std::pair<char, std::pair<std::string, std::string> > key;
+        std::pair<char, std::pair<CTokenAddress, std::string> > key;
         if (pcursor->GetKey(key) && key.first == ADDRESS_QULAIFIER_FLAG && key.second.first == address) {
             if (key.second.second == qualifier || key.second.second.rfind(std::string(qualifier + "/"), 0) == 0) {
                 return true;
@@ -169,7 +246,32 @@ bool CRestrictedDB::CheckForAddressRootQualifier(const std::string& address, con
     return false;
 }
 
-bool CRestrictedDB::GetAddressQualifiers(std::string& address, std::vector<std::string>& qualifiers)
+bool CRestrictedDB::ReadAddressesQualifiers(const std::set<CTokenAddress>& setAddresses, std::map<CTokenAddress, std::set<std::string> >& mapQualifiers)
+{
+    // The binary addresses compare the way their keys sort, so the set is already in key order
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    for (const CTokenAddress& address : setAddresses) {
+        std::set<std::string>& qualifiers = mapQualifiers[address];
+
+        pcursor->Seek(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, std::string())));
+
+        while (pcursor->Valid()) {
+            boost::this_thread::interruption_point();
+            std::pair<char, std::pair<CTokenAddress, std::string> > key;
+            if (pcursor->GetKey(key) && key.first == ADDRESS_QULAIFIER_FLAG && key.second.first == address) {
+                qualifiers.insert(key.second.second);
+                pcursor->Next();
+            } else {
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool CRestrictedDB::GetAddressQualifiers(const CTokenAddress& address, std::vector<std::string>& qualifiers)
 {
     FlushStateToDisk();
 
@@ -180,7 +282,7 @@ bool CRestrictedDB::GetAddressQualifiers(std::string& address, std::vector<std::
     // Load all qualifiers related to that given address
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
-        std::pair<char, std::pair<std::string, std::string> > key;
+        std::pair<char, std::pair<CTokenAddress, std::string> > key;
         if (pcursor->GetKey(key) && key.first == ADDRESS_QULAIFIER_FLAG && key.second.first == address) {
             qualifiers.emplace_back(key.second.second);
             pcursor->Next();
@@ -192,7 +294,7 @@ bool CRestrictedDB::GetAddressQualifiers(std::string& address, std::vector<std::
     return true;
 }
 
-bool CRestrictedDB::GetAddressRestrictions(std::string& address, std::vector<std::string>& restrictions)
+bool CRestrictedDB::GetAddressRestrictions(const CTokenAddress& address, std::vector<std::string>& restrictions)
 {
     FlushStateToDisk();
 
@@ -203,7 +305,7 @@ bool CRestrictedDB::GetAddressRestrictions(std::string& address, std::vector<std
     // Load all restrictions related to the given address
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
-        std::pair<char, std::pair<std::string, std::string> > key;
+        std::pair<char, std::pair<CTokenAddress, std::string> > key;
         if (pcursor->GetKey(key) && key.first == RESTRICTED_ADDRESS_FLAG && key.second.first == address) {
             restrictions.emplace_back(key.second.second);
             pcursor->Next();
@@ -236,4 +338,61 @@ bool CRestrictedDB::GetGlobalRestrictions(std::vector<std::string>& restrictions
     }
 
     return true;
-}
\ No newline at end of file
+}
+bool CRestrictedDB::UpgradeAddressKeys()
+{
+    bool fUpgraded = false;
+    if (ReadFlag(ADDRESS_KEYS_FLAG, fUpgraded) && fUpgraded)
+        return true;
+
+    LogPrintf("%s: Upgrading the restricted token addresses to binary address keys...\n", __func__);
+
+    // The qualifier and restriction tables are next to each other, they are upgraded in a single pass
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(QULAIFIER_ADDRESS_FLAG);
+
+    CDBBatch batch(*this);
+    size_t nUpgraded = 0;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+
+        char flag;
+        if (!pcursor->GetKey(flag) || flag > ADDRESS_QULAIFIER_FLAG)
+            break;
+
+        // Only keys that parse as two strings up to their last byte, one of them an address, were written with
+        // base58 addresses. An upgrade that was interrupted already rewrote some of them.
+        std::pair<char, std::pair<std::string, std::string> > key;
+        if ((flag == QULAIFIER_ADDRESS_FLAG || flag == RESTRICTED_ADDRESS_FLAG || flag == ADDRESS_QULAIFIER_FLAG) &&
+                pcursor->GetKey(key) && GetSerializeSize(key, SER_DISK, CLIENT_VERSION) == pcursor->GetKeySize()) {
+            const std::string& strAddress = flag == QULAIFIER_ADDRESS_FLAG ? key.second.second : key.second.first;
+            CTokenAddress address = CTokenAddress::FromString(strAddress);
+            if (address.ToString() == strAddress) {
+                int8_t i;
+                if (!pcursor->GetValue(i))
+                    return error("%s: failed to read restricted token address", __func__);
+
+                batch.Erase(key);
+                if (flag == QULAIFIER_ADDRESS_FLAG)
+                    batch.Write(std::make_pair(flag, std::make_pair(key.second.first, address)), i);
+                else
+                    batch.Write(std::make_pair(flag, std::make_pair(address, key.second.second)), i);
+                nUpgraded++;
+            }
+        }
+
+        if (batch.SizeEstimate() > (size_t)nDefaultDbBatchSize) {
+            if (!WriteBatch(batch))
+                return error("%s: failed to write upgraded restricted token addresses", __func__);
+            batch.Clear();
+        }
+        pcursor->Next();
+    }
+
+    batch.Write(std::make_pair(DB_FLAG, ADDRESS_KEYS_FLAG), '1');
+    if (!WriteBatch(batch, true))
+        return error("%s: failed to write upgraded restricted token addresses", __func__);
+
+    LogPrintf("%s: Upgraded %u restricted token addresses\n", __func__, nUpgraded);
+    return true;
+}
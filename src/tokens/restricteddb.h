@@ -8,6 +8,11 @@
 #define PLBCOIN_RESTRICTEDDB_H
 
 #include <dbwrapper.h>
+#include <uint256.h>
+#include "tokens/tokentypes.h"
+
+#include <map>
+#include <set>
 
 class CRestrictedDB  : public CDBWrapper {
 
@@ -23,35 +28,59 @@ public:
     bool EraseVerifier(const std::string& tokenName);
 
     // Database of Addresses and the Tag that are assigned to them
-    bool WriteAddressQualifier(const std::string &address, const std::string &tag);
-    bool ReadAddressQualifier(const std::string &address, const std::string &tag);
-    bool EraseAddressQualifier(const std::string &address, const std::string &tag);
+    bool WriteAddressQualifier(const CTokenAddress& address, const std::string &tag);
+    bool ReadAddressQualifier(const CTokenAddress& address, const std::string &tag);
+    bool EraseAddressQualifier(const CTokenAddress& address, const std::string &tag);
 
     // Database of the Qualifier to the address that are assigned to them
-    bool WriteQualifierAddress(const std::string &address, const std::string &tag);
-    bool ReadQualifierAddress(const std::string &address, const std::string &tag);
-    bool EraseQualifierAddress(const std::string &address, const std::string &tag);
+    bool WriteQualifierAddress(const CTokenAddress& address, const std::string &tag);
+    bool ReadQualifierAddress(const CTokenAddress& address, const std::string &tag);
+    bool EraseQualifierAddress(const CTokenAddress& address, const std::string &tag);
 
     // Database of Blacklist addresses
-    bool WriteRestrictedAddress(const std::string& address, const std::string& tokenName);
-    bool ReadRestrictedAddress(const std::string& address, const std::string& tokenName);
-    bool EraseRestrictedAddress(const std::string& address, const std::string& tokenName);
+    bool WriteRestrictedAddress(const CTokenAddress& address, const std::string& tokenName);
+    bool ReadRestrictedAddress(const CTokenAddress& address, const std::string& tokenName);
+    bool EraseRestrictedAddress(const CTokenAddress& address, const std::string& tokenName);
 
     // Database of Restricted Trading Global Off
     bool WriteGlobalRestriction(const std::string& tokenName);
     bool ReadGlobalRestriction(const std::string& tokenName);
     bool EraseGlobalRestriction(const std::string& tokenName);
 
+    // Batched changes, nothing is written until WriteRestrictedBatch
+    void WriteVerifier(CDBOrderedBatch& batch, const std::string& tokenName, const std::string& verifier);
+    void EraseVerifier(CDBOrderedBatch& batch, const std::string& tokenName);
+    void WriteAddressQualifier(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string &tag);
+    void EraseAddressQualifier(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string &tag);
+    void WriteQualifierAddress(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string &tag);
+    void EraseQualifierAddress(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string &tag);
+    void WriteRestrictedAddress(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string& tokenName);
+    void EraseRestrictedAddress(CDBOrderedBatch& batch, const CTokenAddress& address, const std::string& tokenName);
+    void WriteGlobalRestriction(CDBOrderedBatch& batch, const std::string& tokenName);
+    void EraseGlobalRestriction(CDBOrderedBatch& batch, const std::string& tokenName);
+
+    // Writes the batch atomically, tagged with the block the chainstate was flushed at. nBytes is set to the size written
+    bool WriteRestrictedBatch(const CDBOrderedBatch& batch, const uint256& hashBlock, size_t& nBytes);
+
+    // The block of the last batch, null if none was written yet
+    uint256 GetBestBlock() const;
+
     // Write / Read Database flags
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
 
-    bool GetQualifierAddresses(std::string& qualifier, std::vector<std::string>& addresses);
-    bool GetAddressQualifiers(std::string& address, std::vector<std::string>& qualifiers);
-    bool GetAddressRestrictions(std::string& address, std::vector<std::string>& restrictions);
+    bool GetQualifierAddresses(std::string& qualifier, std::vector<CTokenAddress>& addresses);
+    bool GetAddressQualifiers(const CTokenAddress& address, std::vector<std::string>& qualifiers);
+    bool GetAddressRestrictions(const CTokenAddress& address, std::vector<std::string>& restrictions);
     bool GetGlobalRestrictions(std::vector<std::string>& restrictions);
 
-    bool CheckForAddressRootQualifier(const std::string& address, const std::string& qualifier);
+    bool CheckForAddressRootQualifier(const CTokenAddress& address, const std::string& qualifier);
+
+    // Reads the qualifiers of each address, moving a single iterator through the addresses in key order
+    bool ReadAddressesQualifiers(const std::set<CTokenAddress>& setAddresses, std::map<CTokenAddress, std::set<std::string> >& mapQualifiers);
+
+    // Rewrites the address tables of a database written with base58 address keys, once
+    bool UpgradeAddressKeys();
 
     bool Flush();
 };
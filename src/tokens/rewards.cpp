@@ -112,29 +112,30 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
     std::set<std::string> exceptionAddressSet;
     boost::split(exceptionAddressSet, p_rewardSnapshot.strExceptionAddresses, boost::is_any_of(ADDRESS_COMMA_DELIMITER));
 
-    std::set<OwnerAndAmount> nonExceptionOwnerships;
+    //  Ignore exception and burn addresses
+    auto fIsPayable = [&](const std::string& address) {
+        return exceptionAddressSet.find(address) == exceptionAddressSet.end() && !GetParams().IsFeeAddress(address);
+    };
+
+    //  The shares need the total first, so the snapshot is streamed twice instead of collecting every holder
+    size_t nPayableOwners = 0;
     CAmount totalAmtOwned = 0;
 
-    CTokenSnapshotDBEntry snapshotEntry;
-    if (!pTokenSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipToken, p_rewardSnapshot.nHeight, snapshotEntry)) {
+    bool fRead = pTokenSnapshotDb->ReadOwnershipSnapshot(p_rewardSnapshot.strOwnershipToken, p_rewardSnapshot.nHeight,
+        [&](const std::string & address, CAmount amount) {
+            if (fIsPayable(address)) {
+                nPayableOwners++;
+                totalAmtOwned += amount;
+            }
+        });
+
+    if (!fRead) {
         LogPrint(BCLog::REWARDS, "%s: Failed to retrieve ownership snapshot list!\n", __func__);
         return false;
     }
 
-    for (auto const & currPair : snapshotEntry.ownersAndAmounts) {
-        //  Ignore exception and burn addresses
-        if (
-                exceptionAddressSet.find(currPair.first) == exceptionAddressSet.end()
-                && !GetParams().IsFeeAddress(currPair.first)
-                ) {
-            //  Address is valid so add it to the payment list
-            nonExceptionOwnerships.insert(OwnerAndAmount(currPair.first, currPair.second));
-            totalAmtOwned += currPair.second;
-        }
-    }
-
     //  Make sure we have some addresses to pay to
-    if (nonExceptionOwnerships.size() == 0) {
+    if (nPayableOwners == 0) {
         LogPrint(BCLog::REWARDS, "%s: Ownership of '%s' includes only exception/burn addresses.\n", __func__,
                  p_rewardSnapshot.strOwnershipToken.c_str());
         return false;
@@ -148,27 +149,40 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
 
     CAmount totalSentAsRewards = 0;
     //  Loop through token owners
-    for (auto & ownership : nonExceptionOwnerships) {
-        // Get percentage of total ownership
-        long double percent = (long double)ownership.amount / (long double)totalAmtOwned;
-        // Caculate the reward with potentional unit inaccurancies e.g with units 4, 90054100 satoshis = 0.90054100
-        CAmount rewardAmt = percent * modifiedPaymentInTokenUnits * static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionToken.units));
-        // Remove all none accurate units e.g with units 4 90054100 => 9005
-        rewardAmt /= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionToken.units));
-        // Replace all none accurate units back with zeros e.g with units 4 9005 => 90050000 satoshis = 0.90050000
-        rewardAmt *= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionToken.units));
-
-        totalSentAsRewards += rewardAmt;
-
-        LogPrint(BCLog::REWARDS, "%s: Found ownership address for '%s': '%s' owns %d => reward %d\n", __func__,
-                 p_rewardSnapshot.strOwnershipToken.c_str(), ownership.address.c_str(),
-                 ownership.amount, rewardAmt);
-
-        //  Save it into our list if the reward payment is above zero
-        if (rewardAmt > 0)
-            vecDistributionList.push_back(OwnerAndAmount(ownership.address, rewardAmt));
+    fRead = pTokenSnapshotDb->ReadOwnershipSnapshot(p_rewardSnapshot.strOwnershipToken, p_rewardSnapshot.nHeight,
+        [&](const std::string & address, CAmount amount) {
+            if (!fIsPayable(address))
+                return;
+
+            // Get percentage of total ownership
+            long double percent = (long double)amount / (long double)totalAmtOwned;
+            // Caculate the reward with potentional unit inaccurancies e.g with units 4, 90054100 satoshis = 0.90054100
+            CAmount rewardAmt = percent * modifiedPaymentInTokenUnits * static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionToken.units));
+            // Remove all none accurate units e.g with units 4 90054100 => 9005
+            rewardAmt /= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionToken.units));
+            // Replace all none accurate units back with zeros e.g with units 4 9005 => 90050000 satoshis = 0.90050000
+            rewardAmt *= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionToken.units));
+
+            totalSentAsRewards += rewardAmt;
+
+            LogPrint(BCLog::REWARDS, "%s: Found ownership address for '%s': '%s' owns %d => reward %d\n", __func__,
+                     p_rewardSnapshot.strOwnershipToken.c_str(), address.c_str(),
+                     amount, rewardAmt);
+
+            //  Save it into our list if the reward payment is above zero
+            if (rewardAmt > 0)
+                vecDistributionList.push_back(OwnerAndAmount(address, rewardAmt));
+        });
+
+    if (!fRead) {
+        LogPrint(BCLog::REWARDS, "%s: Failed to retrieve ownership snapshot list!\n", __func__);
+        vecDistributionList.clear();
+        return false;
     }
 
+    //  The payment transactions are numbered by their position in the list, keep it in address order
+    std::sort(vecDistributionList.begin(), vecDistributionList.end());
+
     CAmount change = totalAmtOwned - totalSentAsRewards;
     if (change > 0) {
         LogPrint(BCLog::REWARDS, "%s: Found change amount of %u\n", __func__, change);
@@ -191,10 +205,8 @@ void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewar
         return;
     }
 
-    //  Retrieve the token snapshot entry for the target token at the specified height
-    CTokenSnapshotDBEntry snapshotEntry;
-
-    if (!pTokenSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipToken, p_rewardSnapshot.nHeight, snapshotEntry)) {
+    //  Check for the token snapshot entry for the target token at the specified height
+    if (!pTokenSnapshotDb->OwnershipSnapshotExists(p_rewardSnapshot.strOwnershipToken, p_rewardSnapshot.nHeight)) {
         LogPrint(BCLog::REWARDS, "Failed to retrieve ownership snapshot!\n");
         return;
     }
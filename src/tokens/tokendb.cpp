@@ -3,6 +3,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <hash.h>
 #include <util.h>
 #include <consensus/params.h>
 #include <script/ismine.h>
@@ -19,29 +20,141 @@ static const char ADDRESS_TOKEN_QUANTITY_FLAG = 'C';
 static const char MY_TOKEN_FLAG = 'M';
 static const char BLOCK_TOKEN_UNDO_DATA = 'U';
 static const char MEMPOOL_REISSUED_TX = 'Z';
+static const char BEST_BLOCK_FLAG = 'H';
+static const char TOKEN_NAME_FILTER_FLAG = 'N';
+static const char ADDRESS_KEYS_FLAG = 'K';
 
 static size_t MAX_DATABASE_RESULTS = 50000;
 
-CTokensDB::CTokensDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "tokens", nCacheSize, fMemory, fWipe) {
+//! Key of the prefix counts, the flag followed by the bytes of the first half of the quantity keys
+static std::string PrefixCountKey(const char flag, const std::string& first)
+{
+    return flag + first;
+}
+
+static std::string PrefixCountKey(const char flag, const CTokenAddress& first)
+{
+    return flag + std::string(first.begin(), first.end());
+}
+
+//! Whether a directory query continues after the last entry of a previous page
+static bool HasCursor(const std::string& after)
+{
+    return !after.empty();
+}
+
+static bool HasCursor(const CTokenAddress& after)
+{
+    return !after.IsNull();
+}
+
+CTokenNameFilter::CTokenNameFilter() : nHashFuncs(0), nCapacity(0), nElements(0)
+{
+}
+
+CTokenNameFilter::CTokenNameFilter(unsigned int nCapacityIn) : nHashFuncs(0), nCapacity(std::max(nCapacityIn, 1u)), nElements(0)
+{
+    // Sized for 0.1% false positives once it holds nCapacity names, about 14 bits per name
+    static const double FALSE_POSITIVE_RATE = 0.001;
+    static const double LN2 = 0.6931471805599453094;
+    vData.resize((size_t)(-1 / (LN2 * LN2) * nCapacity * log(FALSE_POSITIVE_RATE) / 8) + 1);
+    nHashFuncs = std::max(1u, (unsigned int)(vData.size() * 8 / nCapacity * LN2));
+}
+
+unsigned int CTokenNameFilter::Hash(unsigned int nHashNum, const std::vector<unsigned char>& vName) const
+{
+    return MurmurHash3(nHashNum * 0xFBA4C795, vName) % (vData.size() * 8);
+}
+
+bool CTokenNameFilter::Insert(const std::string& name)
+{
+    if (vData.empty())
+        return false;
+
+    std::vector<unsigned char> vName(name.begin(), name.end());
+    bool fNew = false;
+    for (unsigned int i = 0; i < nHashFuncs; i++) {
+        unsigned int nIndex = Hash(i, vName);
+        if (!(vData[nIndex >> 3] & (1 << (7 & nIndex)))) {
+            vData[nIndex >> 3] |= (1 << (7 & nIndex));
+            fNew = true;
+        }
+    }
+
+    // A name whose bits were all set by other names still takes up room, writing a name again counts it twice
+    // but only makes the filter fill up early
+    nElements++;
+    return fNew;
+}
+
+bool CTokenNameFilter::MayContain(const std::string& name) const
+{
+    // A filter that wasn't built can't rule anything out
+    if (vData.empty())
+        return true;
+
+    std::vector<unsigned char> vName(name.begin(), name.end());
+    for (unsigned int i = 0; i < nHashFuncs; i++) {
+        unsigned int nIndex = Hash(i, vName);
+        if (!(vData[nIndex >> 3] & (1 << (7 & nIndex))))
+            return false;
+    }
+    return true;
+}
+
+CTokensDB::CTokensDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "tokens", nCacheSize, fMemory, fWipe), prefixCounts(MAX_CACHE_TOKENS_BYTES), fNameFilterStored(false) {
+    if (!LoadTokenNameFilter())
+        LogPrintf("%s: Failed to load the token name filter, every token lookup will read the database\n", __func__);
 }
 
 bool CTokensDB::WriteTokenData(const CNewToken &token, const int nHeight, const uint256& blockHash)
 {
     CDatabasedTokenData data(token, nHeight, blockHash);
-    return Write(std::make_pair(TOKEN_FLAG, token.strName), data);
+    CDBBatch batch(*this);
+    batch.Write(std::make_pair(TOKEN_FLAG, token.strName), data);
+
+    LOCK(cs_nameFilter);
+    bool fDropStored = nameFilter.Insert(token.strName) && fNameFilterStored;
+    if (fDropStored)
+        batch.Erase(TOKEN_NAME_FILTER_FLAG);
+
+    if (!WriteBatch(batch))
+        return false;
+
+    if (fDropStored)
+        fNameFilterStored = false;
+
+    if (nameFilter.IsFull())
+        return RebuildTokenNameFilter(nameFilter.GetCapacity() * 2);
+    return true;
 }
 
-bool CTokensDB::WriteTokenAddressQuantity(const std::string &tokenName, const std::string &address, const CAmount &quantity)
+bool CTokensDB::WriteTokenAddressQuantity(const std::string &tokenName, const CTokenAddress &address, const CAmount &quantity)
 {
-    return Write(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, address)), quantity);
+    LOCK(cs_prefixCounts);
+    UpdatePrefixCount(TOKEN_ADDRESS_QUANTITY_FLAG, tokenName, address, true);
+    if (!Write(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, address)), quantity)) {
+        prefixCounts.Erase(PrefixCountKey(TOKEN_ADDRESS_QUANTITY_FLAG, tokenName));
+        return false;
+    }
+    return true;
 }
 
-bool CTokensDB::WriteAddressTokenQuantity(const std::string &address, const std::string &tokenName, const CAmount& quantity) {
-    return Write(std::make_pair(ADDRESS_TOKEN_QUANTITY_FLAG, std::make_pair(address, tokenName)), quantity);
+bool CTokensDB::WriteAddressTokenQuantity(const CTokenAddress &address, const std::string &tokenName, const CAmount& quantity) {
+    LOCK(cs_prefixCounts);
+    UpdatePrefixCount(ADDRESS_TOKEN_QUANTITY_FLAG, address, tokenName, true);
+    if (!Write(std::make_pair(ADDRESS_TOKEN_QUANTITY_FLAG, std::make_pair(address, tokenName)), quantity)) {
+        prefixCounts.Erase(PrefixCountKey(ADDRESS_TOKEN_QUANTITY_FLAG, address));
+        return false;
+    }
+    return true;
 }
 
 bool CTokensDB::ReadTokenData(const std::string& strName, CNewToken& token, int& nHeight, uint256& blockHash)
 {
+    // Most names looked up while checking issuances were never issued, those don't have to reach the database
+    if (!TokenNameMayExist(strName))
+        return false;
 
     CDatabasedTokenData data;
     bool ret =  Read(std::make_pair(TOKEN_FLAG, strName), data);
@@ -55,12 +168,12 @@ bool CTokensDB::ReadTokenData(const std::string& strName, CNewToken& token, int&
     return ret;
 }
 
-bool CTokensDB::ReadTokenAddressQuantity(const std::string& tokenName, const std::string& address, CAmount& quantity)
+bool CTokensDB::ReadTokenAddressQuantity(const std::string& tokenName, const CTokenAddress& address, CAmount& quantity)
 {
     return Read(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, address)), quantity);
 }
 
-bool CTokensDB::ReadAddressTokenQuantity(const std::string &address, const std::string &tokenName, CAmount& quantity) {
+bool CTokensDB::ReadAddressTokenQuantity(const CTokenAddress &address, const std::string &tokenName, CAmount& quantity) {
     return Read(std::make_pair(ADDRESS_TOKEN_QUANTITY_FLAG, std::make_pair(address, tokenName)), quantity);
 }
 
@@ -74,15 +187,174 @@ bool CTokensDB::EraseMyTokenData(const std::string& tokenName)
     return Erase(std::make_pair(MY_TOKEN_FLAG, tokenName));
 }
 
-bool CTokensDB::EraseTokenAddressQuantity(const std::string &tokenName, const std::string &address) {
-    return Erase(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, address)));
+bool CTokensDB::EraseTokenAddressQuantity(const std::string &tokenName, const CTokenAddress &address) {
+    LOCK(cs_prefixCounts);
+    UpdatePrefixCount(TOKEN_ADDRESS_QUANTITY_FLAG, tokenName, address, false);
+    if (!Erase(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, address)))) {
+        prefixCounts.Erase(PrefixCountKey(TOKEN_ADDRESS_QUANTITY_FLAG, tokenName));
+        return false;
+    }
+    return true;
+}
+
+bool CTokensDB::EraseAddressTokenQuantity(const CTokenAddress &address, const std::string &tokenName) {
+    LOCK(cs_prefixCounts);
+    UpdatePrefixCount(ADDRESS_TOKEN_QUANTITY_FLAG, address, tokenName, false);
+    if (!Erase(std::make_pair(ADDRESS_TOKEN_QUANTITY_FLAG, std::make_pair(address, tokenName)))) {
+        prefixCounts.Erase(PrefixCountKey(ADDRESS_TOKEN_QUANTITY_FLAG, address));
+        return false;
+    }
+    return true;
+}
+
+void CTokensDB::WriteTokenData(CTokensDBBatch& batch, const CNewToken &token, const int nHeight, const uint256& blockHash)
+{
+    CDatabasedTokenData data(token, nHeight, blockHash);
+    batch.setTokenNames.insert(token.strName);
+    batch.Write(std::make_pair(TOKEN_FLAG, token.strName), data);
+}
+
+void CTokensDB::WriteTokenAddressQuantity(CTokensDBBatch& batch, const std::string &tokenName, const CTokenAddress &address, const CAmount &quantity)
+{
+    auto key = std::make_pair(tokenName, address);
+    batch.mapTokenAddressEntries[key] = true;
+    batch.Write(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, key), quantity);
+}
+
+void CTokensDB::WriteAddressTokenQuantity(CTokensDBBatch& batch, const CTokenAddress &address, const std::string &tokenName, const CAmount& quantity)
+{
+    auto key = std::make_pair(address, tokenName);
+    batch.mapAddressTokenEntries[key] = true;
+    batch.Write(std::make_pair(ADDRESS_TOKEN_QUANTITY_FLAG, key), quantity);
+}
+
+void CTokensDB::EraseTokenData(CTokensDBBatch& batch, const std::string& tokenName)
+{
+    batch.Erase(std::make_pair(TOKEN_FLAG, tokenName));
+}
+
+void CTokensDB::EraseTokenAddressQuantity(CTokensDBBatch& batch, const std::string &tokenName, const CTokenAddress &address)
+{
+    auto key = std::make_pair(tokenName, address);
+    batch.mapTokenAddressEntries[key] = false;
+    batch.Erase(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, key));
+}
+
+void CTokensDB::EraseAddressTokenQuantity(CTokensDBBatch& batch, const CTokenAddress &address, const std::string &tokenName)
+{
+    auto key = std::make_pair(address, tokenName);
+    batch.mapAddressTokenEntries[key] = false;
+    batch.Erase(std::make_pair(ADDRESS_TOKEN_QUANTITY_FLAG, key));
+}
+
+bool CTokensDB::WriteTokensBatch(const CTokensDBBatch& batch, const uint256& hashBlock, size_t& nBytes)
+{
+    // The counts compare against the entries on disk, so they have to be updated before the batch is written.
+    // cs_prefixCounts is held until the batch is on disk, so no count can be taken in between.
+    LOCK(cs_prefixCounts);
+    for (const auto& entry : batch.mapTokenAddressEntries)
+        UpdatePrefixCount(TOKEN_ADDRESS_QUANTITY_FLAG, entry.first.first, entry.first.second, entry.second);
+    for (const auto& entry : batch.mapAddressTokenEntries)
+        UpdatePrefixCount(ADDRESS_TOKEN_QUANTITY_FLAG, entry.first.first, entry.first.second, entry.second);
+
+    CDBBatch dbBatch(*this);
+    batch.AddTo(dbBatch);
+    if (!hashBlock.IsNull())
+        dbBatch.Write(BEST_BLOCK_FLAG, hashBlock);
+
+    // The filter is only written by WriteTokenNameFilter. A stored filter that lacks a name of the batch is erased
+    // with it, one that is tagged with another block than the marker is built again when the database is opened.
+    LOCK(cs_nameFilter);
+    bool fDropStored = false;
+    for (const auto& name : batch.setTokenNames)
+        fDropStored |= nameFilter.Insert(name);
+    fDropStored &= fNameFilterStored;
+    if (fDropStored)
+        dbBatch.Erase(TOKEN_NAME_FILTER_FLAG);
+
+    nBytes = dbBatch.SizeEstimate();
+    if (!WriteBatch(dbBatch)) {
+        prefixCounts.Clear();
+        return false;
+    }
+
+    if (fDropStored)
+        fNameFilterStored = false;
+
+    if (nameFilter.IsFull())
+        return RebuildTokenNameFilter(nameFilter.GetCapacity() * 2);
+    return true;
+}
+
+uint256 CTokensDB::GetBestBlock() const
+{
+    uint256 hashBestBlock;
+    if (!Read(BEST_BLOCK_FLAG, hashBestBlock))
+        return uint256();
+    return hashBestBlock;
+}
+
+bool CTokensDB::TokenNameMayExist(const std::string& strName)
+{
+    LOCK(cs_nameFilter);
+    return nameFilter.MayContain(strName);
+}
+
+bool CTokensDB::WriteTokenNameFilter()
+{
+    LOCK(cs_nameFilter);
+    if (!nameFilter.GetCapacity() || nameFilter.IsFull())
+        return true;
+
+    if (!Write(TOKEN_NAME_FILTER_FLAG, std::make_pair(GetBestBlock(), nameFilter)))
+        return false;
+
+    fNameFilterStored = true;
+    return true;
 }
 
-bool CTokensDB::EraseAddressTokenQuantity(const std::string &address, const std::string &tokenName) {
-    return Erase(std::make_pair(ADDRESS_TOKEN_QUANTITY_FLAG, std::make_pair(address, tokenName)));
+bool CTokensDB::LoadTokenNameFilter()
+{
+    LOCK(cs_nameFilter);
+
+    // A filter that wasn't written at the last batch may miss some of the names, it is built again
+    std::pair<uint256, CTokenNameFilter> filter;
+    if (Read(TOKEN_NAME_FILTER_FLAG, filter) && filter.first == GetBestBlock() && filter.second.GetCapacity() && !filter.second.IsFull()) {
+        nameFilter = filter.second;
+        fNameFilterStored = true;
+        return true;
+    }
+
+    return RebuildTokenNameFilter(std::max(DEFAULT_TOKEN_NAME_FILTER_CAPACITY, filter.second.GetElements() * 2));
 }
 
-bool EraseAddressTokenQuantity(const std::string &address, const std::string &tokenName);
+bool CTokensDB::RebuildTokenNameFilter(unsigned int nCapacity)
+{
+    AssertLockHeld(cs_nameFilter);
+
+    CTokenNameFilter filter(nCapacity);
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(TOKEN_FLAG, std::string()));
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, std::string> key;
+        if (!pcursor->GetKey(key) || key.first != TOKEN_FLAG)
+            break;
+        filter.Insert(key.second);
+        pcursor->Next();
+    }
+
+    if (filter.IsFull())
+        return RebuildTokenNameFilter(filter.GetElements() * 2);
+
+    nameFilter = filter;
+    LogPrintf("%s: Built the token name filter with %u names, sized for %u\n", __func__, nameFilter.GetElements(), nameFilter.GetCapacity());
+    if (!Write(TOKEN_NAME_FILTER_FLAG, std::make_pair(GetBestBlock(), nameFilter)))
+        return false;
+
+    fNameFilterStored = true;
+    return true;
+}
 
 bool CTokensDB::WriteBlockUndoTokenData(const uint256& blockhash, const std::vector<std::pair<std::string, CBlockTokenUndo> >& tokenUndoData)
 {
@@ -117,6 +389,66 @@ bool CTokensDB::ReadReissuedMempoolState()
     return rv;
 }
 
+bool CTokensDB::UpgradeAddressKeys()
+{
+    bool fUpgraded = false;
+    if (Read(ADDRESS_KEYS_FLAG, fUpgraded) && fUpgraded)
+        return true;
+
+    LogPrintf("%s: Upgrading the token address quantities to binary address keys...\n", __func__);
+
+    // The two quantity tables are next to each other, both are upgraded in a single pass
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(TOKEN_ADDRESS_QUANTITY_FLAG);
+
+    CDBBatch batch(*this);
+    size_t nUpgraded = 0;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+
+        char flag;
+        if (!pcursor->GetKey(flag) || (flag != TOKEN_ADDRESS_QUANTITY_FLAG && flag != ADDRESS_TOKEN_QUANTITY_FLAG))
+            break;
+
+        // Only keys that parse as two strings up to their last byte, one of them an address, were written with
+        // base58 addresses. An upgrade that was interrupted already rewrote some of them.
+        std::pair<char, std::pair<std::string, std::string> > key;
+        if (pcursor->GetKey(key) && GetSerializeSize(key, SER_DISK, CLIENT_VERSION) == pcursor->GetKeySize()) {
+            const std::string& strAddress = flag == TOKEN_ADDRESS_QUANTITY_FLAG ? key.second.second : key.second.first;
+            CTokenAddress address = CTokenAddress::FromString(strAddress);
+            if (address.ToString() == strAddress) {
+                CAmount quantity;
+                if (!pcursor->GetValue(quantity))
+                    return error("%s: failed to read token address quantity", __func__);
+
+                batch.Erase(key);
+                if (flag == TOKEN_ADDRESS_QUANTITY_FLAG)
+                    batch.Write(std::make_pair(flag, std::make_pair(key.second.first, address)), quantity);
+                else
+                    batch.Write(std::make_pair(flag, std::make_pair(address, key.second.second)), quantity);
+                nUpgraded++;
+            }
+        }
+
+        if (batch.SizeEstimate() > (size_t)nDefaultDbBatchSize) {
+            if (!WriteBatch(batch))
+                return error("%s: failed to write upgraded token address quantities", __func__);
+            batch.Clear();
+        }
+        pcursor->Next();
+    }
+
+    batch.Write(ADDRESS_KEYS_FLAG, true);
+    if (!WriteBatch(batch, true))
+        return error("%s: failed to write upgraded token address quantities", __func__);
+
+    LOCK(cs_prefixCounts);
+    prefixCounts.Clear();
+
+    LogPrintf("%s: Upgraded %u token address quantities\n", __func__, nUpgraded);
+    return true;
+}
+
 bool CTokensDB::LoadTokens()
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
@@ -135,7 +467,7 @@ bool CTokensDB::LoadTokens()
 
                 // Loaded enough from database to have in memory.
                 // No need to load everything if it is just going to be removed from the cache
-                if (ptokensCache->Size() == (ptokensCache->MaxSize() / 2))
+                if (ptokensCache->DynamicMemoryUsage() >= (ptokensCache->MaxSize() / 2))
                     break;
             } else {
                 return error("%s: failed to read token", __func__);
@@ -148,12 +480,12 @@ bool CTokensDB::LoadTokens()
 
     if (fTokenIndex) {
         std::unique_ptr<CDBIterator> pcursor3(NewIterator());
-        pcursor3->Seek(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(std::string(), std::string())));
+        pcursor3->Seek(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(std::string(), CTokenAddress())));
 
         // Load mapTokenAddressAmount
         while (pcursor3->Valid()) {
             boost::this_thread::interruption_point();
-            std::pair<char, std::pair<std::string, std::string> > key; // <Token Name, Address> -> Quantity
+            std::pair<char, std::pair<std::string, CTokenAddress> > key; // <Token Name, Address> -> Quantity
             if (pcursor3->GetKey(key) && key.first == TOKEN_ADDRESS_QUANTITY_FLAG) {
                 CAmount value;
                 if (pcursor3->GetValue(value)) {
@@ -174,21 +506,21 @@ bool CTokensDB::LoadTokens()
     return true;
 }
 
-std::string CTokensDB::UsernameAddress(const std::string& tokenName)
+CTokenAddress CTokensDB::UsernameAddress(const std::string& tokenName)
 {
     FlushStateToDisk();
 
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, std::string())));
+    pcursor->Seek(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, CTokenAddress())));
 
-    std::string address = "";
+    CTokenAddress address;
     size_t loaded = 0;
 
     // Load tokens
     while (pcursor->Valid() && loaded < MAX_DATABASE_RESULTS) {
         boost::this_thread::interruption_point();
 
-        std::pair<char, std::pair<std::string, std::string> > key;
+        std::pair<char, std::pair<std::string, CTokenAddress> > key;
         if (pcursor->GetKey(key) && key.first == TOKEN_ADDRESS_QUANTITY_FLAG && key.second.first == tokenName) {
             address = key.second.second;
             loaded += 1;
@@ -202,42 +534,163 @@ std::string CTokensDB::UsernameAddress(const std::string& tokenName)
     return address;
 }
 
-bool CTokensDB::TokenDir(std::vector<CDatabasedTokenData>& tokens, const std::string filter, const size_t count, const long start)
+/** Raw bytes of a database key, used to seek to positions that lie between two keys of a table */
+class CDBSeekKey
+{
+public:
+    std::vector<char> vch;
+
+    template<typename K>
+    explicit CDBSeekKey(const K& key)
+    {
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey << key;
+        vch.assign(ssKey.begin(), ssKey.end());
+    }
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s.write(vch.data(), vch.size());
+    }
+};
+
+// Token names are ascii, so no name byte sorts after this one
+static const char END_OF_RANGE = (char)0xff;
+
+//! Position of the names of nLength characters starting with prefix, or the position just past them
+static CDBSeekKey TokenNameSeekKey(const size_t nLength, const std::string& prefix, const bool fEnd)
+{
+    CDBSeekKey key(TOKEN_FLAG);
+    CDataStream ssLength(SER_DISK, CLIENT_VERSION);
+    WriteCompactSize(ssLength, nLength);
+    key.vch.insert(key.vch.end(), ssLength.begin(), ssLength.end());
+    key.vch.insert(key.vch.end(), prefix.begin(), prefix.end());
+    if (fEnd)
+        key.vch.push_back(END_OF_RANGE);
+    return key;
+}
+
+//! The directory queries read the database directly, only flush when the token cache holds changes it doesn't have yet
+static void FlushDirtyTokens()
 {
+    {
+        LOCK(cs_main);
+        if (!ptokens || !ptokens->HasDirtyTokenData())
+            return;
+    }
     FlushStateToDisk();
+}
+
+template<typename First, typename Second>
+int CTokensDB::GetPrefixCount(const char flag, const First& first)
+{
+    LOCK(cs_prefixCounts);
+    std::string key = PrefixCountKey(flag, first);
+    int nCached;
+    if (prefixCounts.TryGet(key, nCached))
+        return nCached;
 
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(TOKEN_FLAG, std::string()));
+    pcursor->Seek(std::make_pair(flag, std::make_pair(first, Second())));
+
+    int nCount = 0;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+
+        std::pair<char, std::pair<First, Second> > dbKey;
+        if (!pcursor->GetKey(dbKey) || dbKey.first != flag || dbKey.second.first != first)
+            break;
+        nCount++;
+        pcursor->Next();
+    }
+
+    prefixCounts.Put(key, nCount);
+    return nCount;
+}
+
+template<typename First, typename Second>
+void CTokensDB::UpdatePrefixCount(const char flag, const First& first, const Second& second, const bool fAdd)
+{
+    AssertLockHeld(cs_prefixCounts);
+    std::string key = PrefixCountKey(flag, first);
+    int nCount;
+    if (!prefixCounts.TryGet(key, nCount))
+        return;
+
+    // Only entries that are created or removed change the count, not updated quantities
+    bool fExists = Exists(std::make_pair(flag, std::make_pair(first, second)));
+    if (fAdd != fExists)
+        prefixCounts.Put(key, nCount + (fAdd ? 1 : -1));
+}
+
+bool CTokensDB::TokenDir(std::vector<CDatabasedTokenData>& tokens, const std::string filter, const size_t count, const long start, const std::string& after)
+{
+    FlushDirtyTokens();
 
     auto prefix = filter;
     bool wildcard = prefix.back() == '*';
     if (wildcard)
         prefix.pop_back();
 
+    if (!wildcard) {
+        // A full name is a single entry, the offset or the cursor either select it or nothing
+        CDatabasedTokenData data;
+        if (count > 0 && (start == 0 || start == -1) && after.empty() && Read(std::make_pair(TOKEN_FLAG, prefix), data))
+            tokens.push_back(data);
+        return true;
+    }
+
+    // Token keys are sorted by the length of the name first, so the names that share a prefix
+    // are a separate run of keys for every length. These runs are found with a seek each.
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
     size_t skip = 0;
-    if (start >= 0) {
+    if (!after.empty()) {
+        pcursor->Seek(std::make_pair(TOKEN_FLAG, after));
+        skip = std::max(start, 0L);
+    } else if (start >= 0) {
+        pcursor->Seek(TokenNameSeekKey(prefix.size(), prefix, false));
         skip = start;
-    }
-    else {
-        // compute table size for backwards offset
-        long table_size = 0;
-        while (pcursor->Valid()) {
+    } else {
+        // Walk backwards from the end to the entry the backward offset points at
+        pcursor->Seek(char(TOKEN_FLAG + 1));
+        if (pcursor->Valid())
+            pcursor->Prev();
+        else
+            pcursor->SeekToLast();
+
+        std::string first;
+        long nFound = 0;
+        while (pcursor->Valid() && nFound < -start) {
             boost::this_thread::interruption_point();
 
             std::pair<char, std::string> key;
-            if (pcursor->GetKey(key) && key.first == TOKEN_FLAG) {
-                if (prefix == "" ||
-                    (wildcard && key.second.find(prefix) == 0) ||
-                    (!wildcard && key.second == prefix)) {
-                    table_size += 1;
-                }
+            if (!pcursor->GetKey(key) || key.first != TOKEN_FLAG || key.second.size() < prefix.size())
+                break;
+
+            int nCompare = key.second.compare(0, prefix.size(), prefix);
+            if (nCompare == 0) {
+                first = key.second;
+                nFound++;
+                pcursor->Prev();
+            } else if (nCompare > 0) {
+                pcursor->Seek(TokenNameSeekKey(key.second.size(), prefix, true));
+                pcursor->Prev();
+            } else {
+                if (key.second.size() == prefix.size())
+                    break;
+                pcursor->Seek(TokenNameSeekKey(key.second.size() - 1, prefix, true));
+                pcursor->Prev();
             }
-            pcursor->Next();
         }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
-    }
 
+        // The offset reaches back past the first entry
+        if (nFound < -start)
+            return true;
+
+        pcursor->Seek(std::make_pair(TOKEN_FLAG, first));
+    }
 
     size_t loaded = 0;
     size_t offset = 0;
@@ -247,171 +700,155 @@ bool CTokensDB::TokenDir(std::vector<CDatabasedTokenData>& tokens, const std::st
         boost::this_thread::interruption_point();
 
         std::pair<char, std::string> key;
-        if (pcursor->GetKey(key) && key.first == TOKEN_FLAG) {
-            if (prefix == "" ||
-                    (wildcard && key.second.find(prefix) == 0) ||
-                    (!wildcard && key.second == prefix)) {
-                if (offset < skip) {
-                    offset += 1;
-                }
-                else {
-                    CDatabasedTokenData data;
-                    if (pcursor->GetValue(data)) {
-                        tokens.push_back(data);
-                        loaded += 1;
-                    } else {
-                        return error("%s: failed to read token", __func__);
-                    }
-                }
-            }
-            pcursor->Next();
-        } else {
+        if (!pcursor->GetKey(key) || key.first != TOKEN_FLAG)
             break;
+
+        if (key.second.size() < prefix.size()) {
+            pcursor->Seek(TokenNameSeekKey(prefix.size(), prefix, false));
+            continue;
         }
+
+        int nCompare = key.second.compare(0, prefix.size(), prefix);
+        if (nCompare < 0) {
+            pcursor->Seek(TokenNameSeekKey(key.second.size(), prefix, false));
+            continue;
+        } else if (nCompare > 0) {
+            pcursor->Seek(TokenNameSeekKey(key.second.size() + 1, prefix, false));
+            continue;
+        }
+
+        if (key.second == after) {
+            // The cursor entry was part of the previous page
+        } else if (offset < skip) {
+            offset += 1;
+        } else {
+            CDatabasedTokenData data;
+            if (pcursor->GetValue(data)) {
+                tokens.push_back(data);
+                loaded += 1;
+            } else {
+                return error("%s: failed to read token", __func__);
+            }
+        }
+        pcursor->Next();
     }
 
     return true;
 }
 
-bool CTokensDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecTokenAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start)
+template<typename First, typename Second>
+bool CTokensDB::QuantityDir(std::vector<std::pair<Second, CAmount> >& vecAmount, const char flag, const First& first, const size_t count, const long start, const Second& after)
 {
-    FlushStateToDisk();
-
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ADDRESS_TOKEN_QUANTITY_FLAG, std::make_pair(address, std::string())));
 
-    if (fGetTotal) {
-        totalEntries = 0;
-        while (pcursor->Valid()) {
+    size_t skip = 0;
+    if (HasCursor(after) || start >= 0) {
+        pcursor->Seek(std::make_pair(flag, std::make_pair(first, after)));
+        skip = std::max(start, 0L);
+    } else {
+        // Walk backwards from the end of the entries of first to the entry the backward offset points at
+        CDBSeekKey endKey(std::make_pair(flag, first));
+        endKey.vch.push_back(END_OF_RANGE);
+        pcursor->Seek(endKey);
+        if (pcursor->Valid())
+            pcursor->Prev();
+        else
+            pcursor->SeekToLast();
+
+        Second second;
+        long nFound = 0;
+        while (pcursor->Valid() && nFound < -start) {
             boost::this_thread::interruption_point();
 
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ADDRESS_TOKEN_QUANTITY_FLAG && key.second.first == address) {
-                totalEntries++;
-            }
-            pcursor->Next();
+            std::pair<char, std::pair<First, Second> > key;
+            if (!pcursor->GetKey(key) || key.first != flag || key.second.first != first)
+                break;
+            second = key.second.second;
+            nFound++;
+            pcursor->Prev();
         }
-        return true;
-    }
 
-    size_t skip = 0;
-    if (start >= 0) {
-        skip = start;
-    }
-    else {
-        // compute table size for backwards offset
-        long table_size = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
+        // The offset reaches back past the first entry
+        if (nFound < -start)
+            return true;
 
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ADDRESS_TOKEN_QUANTITY_FLAG && key.second.first == address) {
-                table_size += 1;
-            }
-            pcursor->Next();
-        }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
+        pcursor->Seek(std::make_pair(flag, std::make_pair(first, second)));
     }
 
-
     size_t loaded = 0;
     size_t offset = 0;
 
-    // Load tokens
     while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
         boost::this_thread::interruption_point();
 
-        std::pair<char, std::pair<std::string, std::string> > key;
-        if (pcursor->GetKey(key) && key.first == ADDRESS_TOKEN_QUANTITY_FLAG && key.second.first == address) {
-                if (offset < skip) {
-                    offset += 1;
-                }
-                else {
-                    CAmount amount;
-                    if (pcursor->GetValue(amount)) {
-                        vecTokenAmount.emplace_back(std::make_pair(key.second.second, amount));
-                        loaded += 1;
-                    } else {
-                        return error("%s: failed to Address Token Quanity", __func__);
-                    }
-                }
-            pcursor->Next();
-        } else {
+        std::pair<char, std::pair<First, Second> > key;
+        if (!pcursor->GetKey(key) || key.first != flag || key.second.first != first)
             break;
+
+        if (HasCursor(after) && key.second.second == after) {
+            // The cursor entry was part of the previous page
+        } else if (offset < skip) {
+            offset += 1;
+        } else {
+            CAmount amount;
+            if (pcursor->GetValue(amount)) {
+                vecAmount.emplace_back(std::make_pair(key.second.second, amount));
+                loaded += 1;
+            } else {
+                return error("%s: failed to read quantity", __func__);
+            }
         }
+        pcursor->Next();
     }
 
     return true;
 }
 
-// Can get to total count of addresses that belong to a certain token_name, or get you the list of all address that belong to a certain token_name
-bool CTokensDB::TokenAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& tokenName, const size_t count, const long start)
+bool CTokensDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecTokenAmount, int& totalEntries, const bool& fGetTotal, const CTokenAddress& address, const size_t count, const long start, const std::string& after)
 {
-    FlushStateToDisk();
-
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, std::string())));
+    FlushDirtyTokens();
 
     if (fGetTotal) {
-        totalEntries = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
-
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == TOKEN_ADDRESS_QUANTITY_FLAG && key.second.first == tokenName) {
-                totalEntries += 1;
-            }
-            pcursor->Next();
-        }
+        totalEntries = GetPrefixCount<CTokenAddress, std::string>(ADDRESS_TOKEN_QUANTITY_FLAG, address);
         return true;
     }
 
-    size_t skip = 0;
-    if (start >= 0) {
-        skip = start;
-    }
-    else {
-        // compute table size for backwards offset
-        long table_size = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
+    return QuantityDir(vecTokenAmount, ADDRESS_TOKEN_QUANTITY_FLAG, address, count, start, after);
+}
 
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == TOKEN_ADDRESS_QUANTITY_FLAG && key.second.first == tokenName) {
-                table_size += 1;
-            }
-            pcursor->Next();
-        }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
+// Can get to total count of addresses that belong to a certain token_name, or get you the list of all address that belong to a certain token_name
+bool CTokensDB::TokenAddressDir(std::vector<std::pair<CTokenAddress, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& tokenName, const size_t count, const long start, const CTokenAddress& after)
+{
+    FlushDirtyTokens();
+
+    if (fGetTotal) {
+        totalEntries = GetPrefixCount<std::string, CTokenAddress>(TOKEN_ADDRESS_QUANTITY_FLAG, tokenName);
+        return true;
     }
 
-    size_t loaded = 0;
-    size_t offset = 0;
+    return QuantityDir(vecAddressAmount, TOKEN_ADDRESS_QUANTITY_FLAG, tokenName, count, start, after);
+}
 
-    // Load tokens
-    while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
+bool CTokensDB::ForEachTokenAddress(const std::string& tokenName, std::function<bool(const CTokenAddress&, const CAmount&)> func)
+{
+    FlushDirtyTokens();
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(TOKEN_ADDRESS_QUANTITY_FLAG, std::make_pair(tokenName, CTokenAddress())));
+
+    while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
 
-        std::pair<char, std::pair<std::string, std::string> > key;
-        if (pcursor->GetKey(key) && key.first == TOKEN_ADDRESS_QUANTITY_FLAG && key.second.first == tokenName) {
-            if (offset < skip) {
-                offset += 1;
-            }
-            else {
-                CAmount amount;
-                if (pcursor->GetValue(amount)) {
-                    vecAddressAmount.emplace_back(std::make_pair(key.second.second, amount));
-                    loaded += 1;
-                } else {
-                    return error("%s: failed to Token Address Quanity", __func__);
-                }
-            }
-            pcursor->Next();
-        } else {
+        std::pair<char, std::pair<std::string, CTokenAddress> > key;
+        if (!pcursor->GetKey(key) || key.first != TOKEN_ADDRESS_QUANTITY_FLAG || key.second.first != tokenName)
             break;
-        }
+
+        CAmount amount;
+        if (!pcursor->GetValue(amount))
+            return error("%s: failed to read token address quantity", __func__);
+        if (!func(key.second.second, amount))
+            return false;
+        pcursor->Next();
     }
 
     return true;
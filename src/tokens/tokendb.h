@@ -8,7 +8,11 @@
 
 #include "fs.h"
 #include "serialize.h"
+#include "sync.h"
+#include "tokens/tokentypes.h"
 
+#include <functional>
+#include <set>
 #include <string>
 #include <map>
 #include <dbwrapper.h>
@@ -57,6 +61,62 @@ struct CBlockTokenUndo
     }
 };
 
+//! Names the token name filter is sized for when it is first built, it is rebuilt twice as large when it fills up
+static const unsigned int DEFAULT_TOKEN_NAME_FILTER_CAPACITY = 1 << 16;
+
+/**
+ * Bloom filter of the names of every token in the database. A name it doesn't contain was never written, so the
+ * database doesn't have to be read to find out it doesn't exist. Names aren't removed when a token is erased,
+ * they are only false positives until the filter is rebuilt.
+ */
+class CTokenNameFilter
+{
+public:
+    CTokenNameFilter();
+    explicit CTokenNameFilter(unsigned int nCapacity);
+
+    //! Returns whether the name set a bit that wasn't set yet
+    bool Insert(const std::string& name);
+    bool MayContain(const std::string& name) const;
+
+    //! Whether more names were inserted than the filter is sized for, the false positive rate grows beyond it.
+    //! Every insert is counted, names that happen to hit only bits that are already set fill the filter too.
+    bool IsFull() const { return nElements > nCapacity; }
+
+    unsigned int GetCapacity() const { return nCapacity; }
+    unsigned int GetElements() const { return nElements; }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(vData);
+        READWRITE(nHashFuncs);
+        READWRITE(nCapacity);
+        READWRITE(nElements);
+    }
+
+private:
+    std::vector<unsigned char> vData;
+    unsigned int nHashFuncs;
+    unsigned int nCapacity;
+    unsigned int nElements;
+
+    unsigned int Hash(unsigned int nHashNum, const std::vector<unsigned char>& vName) const;
+};
+
+/** Token database changes that are written together by CTokensDB::WriteTokensBatch */
+class CTokensDBBatch : public CDBOrderedBatch
+{
+public:
+    //! Quantity entries the batch creates (true) or removes (false), the last change of an entry wins
+    std::map<std::pair<std::string, CTokenAddress>, bool> mapTokenAddressEntries;
+    std::map<std::pair<CTokenAddress, std::string>, bool> mapAddressTokenEntries;
+
+    //! Names of the tokens the batch writes, added to the token name filter
+    std::set<std::string> setTokenNames;
+};
+
 /** Access to the block database (blocks/index/) */
 class CTokensDB : public CDBWrapper
 {
@@ -68,33 +128,85 @@ public:
 
     // Write to database functions
     bool WriteTokenData(const CNewToken& token, const int nHeight, const uint256& blockHash);
-    bool WriteTokenAddressQuantity(const std::string& tokenName, const std::string& address, const CAmount& quantity);
-    bool WriteAddressTokenQuantity( const std::string& address, const std::string& tokenName, const CAmount& quantity);
+    bool WriteTokenAddressQuantity(const std::string& tokenName, const CTokenAddress& address, const CAmount& quantity);
+    bool WriteAddressTokenQuantity(const CTokenAddress& address, const std::string& tokenName, const CAmount& quantity);
     bool WriteBlockUndoTokenData(const uint256& blockhash, const std::vector<std::pair<std::string, CBlockTokenUndo> >& tokenUndoData);
     bool WriteReissuedMempoolState();
 
     // Read from database functions
     bool ReadTokenData(const std::string& strName, CNewToken& token, int& nHeight, uint256& blockHash);
-    bool ReadTokenAddressQuantity(const std::string& tokenName, const std::string& address, CAmount& quantity);
-    bool ReadAddressTokenQuantity(const std::string& address, const std::string& tokenName, CAmount& quantity);
+    bool ReadTokenAddressQuantity(const std::string& tokenName, const CTokenAddress& address, CAmount& quantity);
+    bool ReadAddressTokenQuantity(const CTokenAddress& address, const std::string& tokenName, CAmount& quantity);
     bool ReadBlockUndoTokenData(const uint256& blockhash, std::vector<std::pair<std::string, CBlockTokenUndo> >& tokenUndoData);
     bool ReadReissuedMempoolState();
 
     // Erase from database functions
     bool EraseTokenData(const std::string& tokenName);
     bool EraseMyTokenData(const std::string& tokenName);
-    bool EraseTokenAddressQuantity(const std::string &tokenName, const std::string &address);
-    bool EraseAddressTokenQuantity(const std::string &address, const std::string &tokenName);
+    bool EraseTokenAddressQuantity(const std::string &tokenName, const CTokenAddress &address);
+    bool EraseAddressTokenQuantity(const CTokenAddress &address, const std::string &tokenName);
+
+    // Batched changes, nothing is written until WriteTokensBatch
+    void WriteTokenData(CTokensDBBatch& batch, const CNewToken& token, const int nHeight, const uint256& blockHash);
+    void WriteTokenAddressQuantity(CTokensDBBatch& batch, const std::string& tokenName, const CTokenAddress& address, const CAmount& quantity);
+    void WriteAddressTokenQuantity(CTokensDBBatch& batch, const CTokenAddress& address, const std::string& tokenName, const CAmount& quantity);
+    void EraseTokenData(CTokensDBBatch& batch, const std::string& tokenName);
+    void EraseTokenAddressQuantity(CTokensDBBatch& batch, const std::string &tokenName, const CTokenAddress &address);
+    void EraseAddressTokenQuantity(CTokensDBBatch& batch, const CTokenAddress &address, const std::string &tokenName);
+
+    // Writes the batch atomically, tagged with the block the chainstate was flushed at. nBytes is set to the size written
+    bool WriteTokensBatch(const CTokensDBBatch& batch, const uint256& hashBlock, size_t& nBytes);
+
+    // The block of the last batch, null if none was written yet
+    uint256 GetBestBlock() const;
+
+    // False only if no token named strName was ever written, answered without reading the database
+    bool TokenNameMayExist(const std::string& strName);
+
+    // Stores the token name filter tagged with the current block, so it doesn't have to be built when the database is
+    // opened again. Called on shutdown and periodic flushes, not with every batch.
+    bool WriteTokenNameFilter();
 
     // Helper functions
     bool LoadTokens();
-    bool TokenDir(std::vector<CDatabasedTokenData>& tokens, const std::string filter, const size_t count, const long start);
+
+    // Rewrites the quantity tables of a database written with base58 address keys, once
+    bool UpgradeAddressKeys();
+
+    // Directory queries, a non empty after continues from the last name or address of the previous page
+    bool TokenDir(std::vector<CDatabasedTokenData>& tokens, const std::string filter, const size_t count, const long start, const std::string& after = "");
     bool TokenDir(std::vector<CDatabasedTokenData>& tokens);
 
-    bool AddressDir(std::vector<std::pair<std::string, CAmount> >& vecTokenAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start);
-    bool TokenAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& tokenName, const size_t count, const long start);
+    bool AddressDir(std::vector<std::pair<std::string, CAmount> >& vecTokenAmount, int& totalEntries, const bool& fGetTotal, const CTokenAddress& address, const size_t count, const long start, const std::string& after = "");
+    bool TokenAddressDir(std::vector<std::pair<CTokenAddress, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& tokenName, const size_t count, const long start, const CTokenAddress& after = CTokenAddress());
+
+    // Calls func with every address holding tokenName and its quantity, in a single pass. Stops when func returns false.
+    bool ForEachTokenAddress(const std::string& tokenName, std::function<bool(const CTokenAddress&, const CAmount&)> func);
+
+    CTokenAddress UsernameAddress(const std::string& tokenName);
+
+private:
+    template<typename First, typename Second>
+    bool QuantityDir(std::vector<std::pair<Second, CAmount> >& vecAmount, const char flag, const First& first, const size_t count, const long start, const Second& after);
+
+    // Number of quantity entries per token and per address, counted on first request and kept up to date by the writes.
+    // cs_prefixCounts is held from the update of a count until the write reaches the database, and while counting.
+    CCriticalSection cs_prefixCounts;
+    CLRUCache<std::string, int> prefixCounts;
+
+    template<typename First, typename Second>
+    int GetPrefixCount(const char flag, const First& first);
+    template<typename First, typename Second>
+    void UpdatePrefixCount(const char flag, const First& first, const Second& second, const bool fAdd);
+
+    // Filter of the token names in the database, read or built when the database is opened and kept up to date by
+    // the writes. fNameFilterStored is set while the stored copy holds every name written since.
+    CCriticalSection cs_nameFilter;
+    CTokenNameFilter nameFilter;
+    bool fNameFilterStored;
 
-    std::string UsernameAddress(const std::string& tokenName);
+    bool LoadTokenNameFilter();
+    bool RebuildTokenNameFilter(unsigned int nCapacity);
 };
 
 
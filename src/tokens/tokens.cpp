@@ -3,7 +3,9 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
-#include <regex>
+#include <algorithm>
+#include <atomic>
+#include <string.h>
 #include <script/script.h>
 #include <version.h>
 #include <streams.h>
@@ -45,170 +47,236 @@ std::map<std::string, uint256> mapReissuedTokens;
 static const auto MAX_NAME_LENGTH = 31;
 static const auto MAX_CHANNEL_NAME_LENGTH = 12;
 
-// min lengths are expressed by quantifiers
-static const std::regex ROOT_NAME_CHARACTERS("^[A-Z0-9._]{3,}$");
-static const std::regex SUB_NAME_CHARACTERS("^[A-Z0-9._]+$");
-static const std::regex UNIQUE_TAG_CHARACTERS("^[-A-Za-z0-9@$%&*()[\\]{}_.?:]+$");
-static const std::regex MSG_CHANNEL_TAG_CHARACTERS("^[A-Za-z0-9_]+$");
-static const std::regex VOTE_TAG_CHARACTERS("^[A-Z0-9._]+$");
-static const std::regex USERNAME_CHARACTERS("^@[A-Z0-9._]{4,}$");
-
-// Restricted tokens
-static const std::regex QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]{3,}$");
-static const std::regex SUB_QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]+$");
-static const std::regex RESTRICTED_NAME_CHARACTERS("\\$[A-Z0-9._]{3,}$");
-
-static const std::regex DOUBLE_PUNCTUATION("^.*[._]{2,}.*$");
-static const std::regex LEADING_PUNCTUATION("^[._].*$");
-static const std::regex TRAILING_PUNCTUATION("^.*[._]$");
-static const std::regex QUALIFIER_LEADING_PUNCTUATION("^[#\\$][._].*$"); // Used for qualifier tokens, and restricted token only
-
 static const std::string SUB_NAME_DELIMITER = "/";
 static const std::string UNIQUE_TAG_DELIMITER = "#";
 static const std::string MSG_CHANNEL_TAG_DELIMITER = "~";
 static const std::string VOTE_TAG_DELIMITER = "^";
 static const std::string RESTRICTED_TAG_DELIMITER = "$";
 
-static const std::regex UNIQUE_INDICATOR(R"(^[^^~#!]+#[^~#!\/]+$)");
-static const std::regex MSG_CHANNEL_INDICATOR(R"(^[^^~#!]+~[^~#!\/]+$)");
-static const std::regex OWNER_INDICATOR(R"(^[^^~#!]+!$)");
-static const std::regex VOTE_INDICATOR(R"(^[^^~#!]+\^[^~#!\/]+$)");
-static const std::regex USERNAME_INDICATOR(R"(^@[A-Z0-9._]{4,}$)");
+// Character classes of the name validators, a character can be in several of them
+enum NameCharClass : uint8_t {
+    NAME_CHAR = 0x01,            // A-Z 0-9 . _
+    NAME_PUNCTUATION = 0x02,     // . _ (can't be the first or last character, or follow each other)
+    UNIQUE_TAG_CHAR = 0x04,      // A-Z a-z 0-9 @ $ % & * ( ) [ ] { } _ . ? : -
+    MSG_CHANNEL_TAG_CHAR = 0x08, // A-Z a-z 0-9 _
+    TAG_INDICATOR = 0x10,        // ^ ~ # ! (end the name in front of a tag)
+    TAG_FORBIDDEN = 0x20,        // ~ # ! / (can't be used in a tag)
+};
+
+static const uint8_t nameCharClasses[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x30, 0x00, 0x30, 0x04, 0x04, 0x04, 0x00, 0x04, 0x04, 0x04, 0x00, 0x00, 0x04, 0x07, 0x20,
+    0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x04, 0x00, 0x00, 0x00, 0x00, 0x04,
+    0x04, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d,
+    0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x04, 0x00, 0x04, 0x10, 0x0f,
+    0x00, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c,
+    0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x04, 0x00, 0x04, 0x30, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static inline uint8_t GetNameCharClass(char c)
+{
+    return nameCharClasses[(unsigned char)c];
+}
+
+// All characters in nClass, at least nMinLength (and one) of them, without doubled or trailing punctuation.
+// Leading punctuation is only allowed if fLeadingPunctuation is set.
+static bool IsNamePartValid(const char* begin, const char* end, size_t nMinLength, uint8_t nClass, bool fLeadingPunctuation = false)
+{
+    if (begin == end || (size_t)(end - begin) < nMinLength)
+        return false;
+
+    bool fPunctuation = !fLeadingPunctuation;
+    for (const char* p = begin; p != end; p++) {
+        uint8_t nCharClass = GetNameCharClass(*p);
+        if (!(nCharClass & nClass))
+            return false;
+        if ((nCharClass & NAME_PUNCTUATION) && fPunctuation)
+            return false;
+        fPunctuation = nCharClass & NAME_PUNCTUATION;
+    }
+
+    return !fPunctuation;
+}
+
+// One or more characters, all in nClass
+static bool IsInCharClass(const char* begin, const char* end, uint8_t nClass)
+{
+    if (begin == end)
+        return false;
 
-static const std::regex QUALIFIER_INDICATOR("^[#][A-Z0-9._]{3,}$"); // Starts with #
-static const std::regex SUB_QUALIFIER_INDICATOR("^#[A-Z0-9._]+\\/#[A-Z0-9._]+$"); // Starts with #
-static const std::regex RESTRICTED_INDICATOR("^[\\$][A-Z0-9._]{3,}$"); // Starts with $
+    for (const char* p = begin; p != end; p++) {
+        if (!(GetNameCharClass(*p) & nClass))
+            return false;
+    }
 
-static const std::regex PLB_NAMES("^PLB$|^PLB$|^PLBCOIN$");
+    return true;
+}
 
-bool IsRootNameValid(const std::string& name)
+// cPrefix followed by at least nMinLength characters of A-Z 0-9 . _
+static bool IsPrefixedName(const char* begin, const char* end, char cPrefix, size_t nMinLength)
 {
-    return std::regex_match(name, ROOT_NAME_CHARACTERS)
-        && !std::regex_match(name, DOUBLE_PUNCTUATION)
-        && !std::regex_match(name, LEADING_PUNCTUATION)
-        && !std::regex_match(name, TRAILING_PUNCTUATION)
-        && !std::regex_match(name, PLB_NAMES);
+    return begin != end && *begin == cPrefix && (size_t)(end - begin - 1) >= nMinLength && IsInCharClass(begin + 1, end, NAME_CHAR);
 }
 
-bool IsQualifierNameValid(const std::string& name)
+static bool IsPLBName(const char* begin, const char* end)
 {
-    return std::regex_match(name, QUALIFIER_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, QUALIFIER_LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION)
-           && !std::regex_match(name, PLB_NAMES);
+    size_t nLength = end - begin;
+    return (nLength == 3 && memcmp(begin, "PLB", 3) == 0) || (nLength == 7 && memcmp(begin, "PLBCOIN", 7) == 0);
 }
 
-bool IsRestrictedNameValid(const std::string& name)
+static bool IsRootNameValid(const char* begin, const char* end)
 {
-    return std::regex_match(name, RESTRICTED_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION)
-           && !std::regex_match(name, PLB_NAMES);
+    return IsNamePartValid(begin, end, 3, NAME_CHAR) && !IsPLBName(begin, end);
 }
 
-bool IsSubQualifierNameValid(const std::string& name)
+static bool IsQualifierNameValid(const char* begin, const char* end)
 {
-    return std::regex_match(name, SUB_QUALIFIER_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION);
+    return begin != end && *begin == '#' && IsNamePartValid(begin + 1, end, 3, NAME_CHAR);
 }
 
-bool IsSubNameValid(const std::string& name)
+// Unlike qualifiers, punctuation may follow the leading $
+static bool IsRestrictedNameValid(const char* begin, const char* end)
 {
-    return std::regex_match(name, SUB_NAME_CHARACTERS)
-        && !std::regex_match(name, DOUBLE_PUNCTUATION)
-        && !std::regex_match(name, LEADING_PUNCTUATION)
-        && !std::regex_match(name, TRAILING_PUNCTUATION);
+    return begin != end && *begin == '$' && IsNamePartValid(begin + 1, end, 3, NAME_CHAR, true);
 }
 
-bool IsUniqueTagValid(const std::string& tag)
+static bool IsSubQualifierNameValid(const char* begin, const char* end)
 {
-    return std::regex_match(tag, UNIQUE_TAG_CHARACTERS);
+    return begin != end && *begin == '#' && IsNamePartValid(begin + 1, end, 1, NAME_CHAR, true);
 }
 
-bool IsVoteTagValid(const std::string& tag)
+static bool IsSubNameValid(const char* begin, const char* end)
 {
-    return std::regex_match(tag, VOTE_TAG_CHARACTERS);
+    return IsNamePartValid(begin, end, 1, NAME_CHAR);
 }
 
-bool IsMsgChannelTagValid(const std::string &tag)
+static bool IsUniqueTagValid(const char* begin, const char* end)
 {
-    return std::regex_match(tag, MSG_CHANNEL_TAG_CHARACTERS)
-        && !std::regex_match(tag, DOUBLE_PUNCTUATION)
-        && !std::regex_match(tag, LEADING_PUNCTUATION)
-        && !std::regex_match(tag, TRAILING_PUNCTUATION);
+    return IsInCharClass(begin, end, UNIQUE_TAG_CHAR);
 }
 
-bool IsUsernameValid(const std::string& username)
+static bool IsVoteTagValid(const char* begin, const char* end)
 {
-    return std::regex_match(username, USERNAME_CHARACTERS);
+    return IsInCharClass(begin, end, NAME_CHAR);
 }
 
-bool IsNameValidBeforeTag(const std::string& name)
+static bool IsMsgChannelTagValid(const char* begin, const char* end)
 {
-    std::vector<std::string> parts;
-    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+    return IsNamePartValid(begin, end, 1, MSG_CHANNEL_TAG_CHAR);
+}
 
-    if (!IsRootNameValid(parts.front())) return false;
+static bool IsUsernameValid(const char* begin, const char* end)
+{
+    return IsPrefixedName(begin, end, '@', 4);
+}
 
-    if (parts.size() > 1)
-    {
-        for (unsigned long i = 1; i < parts.size(); i++)
-        {
-            if (!IsSubNameValid(parts[i])) return false;
-        }
+bool IsUniqueTagValid(const std::string& tag)
+{
+    return IsUniqueTagValid(tag.data(), tag.data() + tag.size());
+}
+
+bool IsUsernameValid(const std::string& username)
+{
+    return IsUsernameValid(username.data(), username.data() + username.size());
+}
+
+static bool IsNameValidBeforeTag(const char* begin, const char* end)
+{
+    const char* sep = std::find(begin, end, '/');
+    if (!IsRootNameValid(begin, sep)) return false;
+
+    while (sep != end) {
+        const char* next = std::find(sep + 1, end, '/');
+        if (!IsSubNameValid(sep + 1, next)) return false;
+        sep = next;
     }
 
     return true;
 }
 
-bool IsQualifierNameValidBeforeTag(const std::string& name)
+static bool IsQualifierNameValidBeforeTag(const char* begin, const char* end)
 {
-    std::vector<std::string> parts;
-    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+    const char* sep = std::find(begin, end, '/');
+    if (!IsQualifierNameValid(begin, sep)) return false;
 
-    if (!IsQualifierNameValid(parts.front())) return false;
+    if (sep == end)
+        return true;
 
     // Qualifiers can only have one sub qualifier under it
-    if (parts.size() > 2) {
+    if (std::find(sep + 1, end, '/') != end)
         return false;
-    }
 
-    if (parts.size() > 1)
-    {
-
-        for (unsigned long i = 1; i < parts.size(); i++)
-        {
-            if (!IsSubQualifierNameValid(parts[i])) return false;
-        }
-    }
+    return IsSubQualifierNameValid(sep + 1, end);
+}
 
-    return true;
+static bool IsTokenNameASubtoken(const char* begin, const char* end)
+{
+    const char* sep = std::find(begin, end, '/');
+    return IsRootNameValid(begin, sep) && sep != end;
 }
 
 bool IsTokenNameASubtoken(const std::string& name)
 {
-    std::vector<std::string> parts;
-    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
-
-    if (!IsRootNameValid(parts.front())) return false;
-
-    return parts.size() > 1;
+    return IsTokenNameASubtoken(name.data(), name.data() + name.size());
 }
 
 bool IsTokenNameASubQualifier(const std::string& name)
 {
-    std::vector<std::string> parts;
-    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+    const char* begin = name.data();
+    const char* end = begin + name.size();
+    const char* sep = std::find(begin, end, '/');
+    return IsQualifierNameValid(begin, sep) && sep != end;
+}
 
-    if (!IsQualifierNameValid(parts.front())) return false;
+// The indicator of a NAME#TAG, NAME~TAG, NAME^TAG or NAME! name, or 0 if the name has none of these forms
+static char GetTagIndicator(const char* begin, const char* end)
+{
+    const char* p = begin;
+    while (p != end && !(GetNameCharClass(*p) & TAG_INDICATOR))
+        p++;
 
-    return parts.size() > 1;
+    if (p == begin || p == end)
+        return 0;
+
+    char cIndicator = *p++;
+    if (cIndicator == '!')
+        return p == end ? cIndicator : 0;
+
+    if (p == end)
+        return 0;
+
+    for (; p != end; p++) {
+        if (GetNameCharClass(*p) & TAG_FORBIDDEN)
+            return 0;
+    }
+
+    return cIndicator;
+}
+
+static bool IsQualifierIndicator(const char* begin, const char* end)
+{
+    return IsPrefixedName(begin, end, '#', 3);
 }
 
+static bool IsSubQualifierIndicator(const char* begin, const char* end)
+{
+    const char* sep = std::find(begin, end, '/');
+    return sep != end && IsPrefixedName(begin, sep, '#', 1) && IsPrefixedName(sep + 1, end, '#', 1);
+}
+
+static bool IsRestrictedIndicator(const char* begin, const char* end)
+{
+    return IsPrefixedName(begin, end, '$', 3);
+}
 
 bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::string& error)
 {
@@ -217,8 +285,12 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
     if (name.length() > 40)
         return false;
 
+    const char* begin = name.data();
+    const char* end = begin + name.size();
+
     tokenType = KnownTokenType::INVALID;
-    if (std::regex_match(name, UNIQUE_INDICATOR))
+    char cIndicator = GetTagIndicator(begin, end);
+    if (cIndicator == '#')
     {
         bool ret = IsTypeCheckNameValid(KnownTokenType::UNIQUE, name, error);
         if (ret)
@@ -226,7 +298,7 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
 
         return ret;
     }
-    else if (std::regex_match(name, MSG_CHANNEL_INDICATOR))
+    else if (cIndicator == '~')
     {
         bool ret = IsTypeCheckNameValid(KnownTokenType::MSGCHANNEL, name, error);
         if (ret)
@@ -234,7 +306,7 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
 
         return ret;
     }
-    else if (std::regex_match(name, OWNER_INDICATOR))
+    else if (cIndicator == '!')
     {
         bool ret = IsTypeCheckNameValid(KnownTokenType::OWNER, name, error);
         if (ret)
@@ -242,7 +314,7 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
 
         return ret;
     }
-    else if (std::regex_match(name, VOTE_INDICATOR))
+    else if (cIndicator == '^')
     {
         bool ret = IsTypeCheckNameValid(KnownTokenType::VOTE, name, error);
         if (ret)
@@ -250,7 +322,7 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
 
         return ret;
     }
-    else if (std::regex_match(name, QUALIFIER_INDICATOR))
+    else if (IsQualifierIndicator(begin, end))
     {
         bool ret = IsTypeCheckNameValid(KnownTokenType::QUALIFIER, name, error);
         if (ret) {
@@ -262,7 +334,7 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
 
         return ret;
     }
-    else if (std::regex_match(name, SUB_QUALIFIER_INDICATOR))
+    else if (IsSubQualifierIndicator(begin, end))
     {
         bool ret = IsTypeCheckNameValid(KnownTokenType::SUB_QUALIFIER, name, error);
         if (ret) {
@@ -272,7 +344,7 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
 
         return ret;
     }
-    else if (std::regex_match(name, RESTRICTED_INDICATOR))
+    else if (IsRestrictedIndicator(begin, end))
     {
         bool ret = IsTypeCheckNameValid(KnownTokenType::RESTRICTED, name, error);
         if (ret)
@@ -280,7 +352,7 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
 
         return ret;
     }
-    else if (std::regex_match(name, USERNAME_INDICATOR))
+    else if (IsUsernameValid(begin, end))
     {
         bool ret = IsTypeCheckNameValid(KnownTokenType::USERNAME, name, error);
         if (ret)
@@ -290,7 +362,7 @@ bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType, std::s
     }
     else
     {
-        auto type = IsTokenNameASubtoken(name) ? KnownTokenType::SUB : KnownTokenType::ROOT;
+        auto type = IsTokenNameASubtoken(begin, end) ? KnownTokenType::SUB : KnownTokenType::ROOT;
         bool ret = IsTypeCheckNameValid(type, name, error);
         if (ret)
             tokenType = type;
@@ -320,66 +392,81 @@ bool IsTokenNameARoot(const std::string& name)
 
 bool IsTokenNameAnOwner(const std::string& name)
 {
-    return IsTokenNameValid(name) && std::regex_match(name, OWNER_INDICATOR);
+    return IsTokenNameValid(name) && GetTagIndicator(name.data(), name.data() + name.size()) == '!';
 }
 
 bool IsTokenNameAnRestricted(const std::string& name)
 {
-    return IsTokenNameValid(name) && std::regex_match(name, RESTRICTED_INDICATOR);
+    return IsTokenNameValid(name) && IsRestrictedIndicator(name.data(), name.data() + name.size());
 }
 
 bool IsTokenNameAQualifier(const std::string& name, bool fOnlyQualifiers)
 {
+    const char* begin = name.data();
+    const char* end = begin + name.size();
+
     if (fOnlyQualifiers) {
-        return IsTokenNameValid(name) && std::regex_match(name, QUALIFIER_INDICATOR);
+        return IsTokenNameValid(name) && IsQualifierIndicator(begin, end);
     }
 
-    return IsTokenNameValid(name) && (std::regex_match(name, QUALIFIER_INDICATOR) || std::regex_match(name, SUB_QUALIFIER_INDICATOR));
+    return IsTokenNameValid(name) && (IsQualifierIndicator(begin, end) || IsSubQualifierIndicator(begin, end));
 }
 
 bool IsTokenNameAnMsgChannel(const std::string& name)
 {
-    return IsTokenNameValid(name) && std::regex_match(name, MSG_CHANNEL_INDICATOR);
+    return IsTokenNameValid(name) && GetTagIndicator(name.data(), name.data() + name.size()) == '~';
+}
+
+// Splits NAME<cDelimiter>TAG into the part before the first and the part after the last delimiter,
+// both are the whole name if it doesn't contain the delimiter
+static void SplitTag(const std::string& name, char cDelimiter, const char*& frontEnd, const char*& backBegin)
+{
+    size_t nFront = name.find(cDelimiter);
+    size_t nBack = name.rfind(cDelimiter);
+    frontEnd = name.data() + (nFront == std::string::npos ? name.size() : nFront);
+    backBegin = name.data() + (nBack == std::string::npos ? 0 : nBack + 1);
 }
 
 // TODO get the string translated below
 bool IsTypeCheckNameValid(const KnownTokenType type, const std::string& name, std::string& error)
 {
+    const char* begin = name.data();
+    const char* end = begin + name.size();
+    const char* frontEnd;
+    const char* backBegin;
+
     if (type == KnownTokenType::UNIQUE) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        std::vector<std::string> parts;
-        boost::split(parts, name, boost::is_any_of(UNIQUE_TAG_DELIMITER));
-        bool valid = IsNameValidBeforeTag(parts.front()) && IsUniqueTagValid(parts.back());
+        SplitTag(name, UNIQUE_TAG_DELIMITER[0], frontEnd, backBegin);
+        bool valid = IsNameValidBeforeTag(begin, frontEnd) && IsUniqueTagValid(backBegin, end);
         if (!valid) { error = "Unique name contains invalid characters (Valid characters are: A-Z a-z 0-9 @ $ % & * ( ) [ ] { } _ . ? : -)";  return false; }
         return true;
     } else if (type == KnownTokenType::MSGCHANNEL) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        std::vector<std::string> parts;
-        boost::split(parts, name, boost::is_any_of(MSG_CHANNEL_TAG_DELIMITER));
-        bool valid = IsNameValidBeforeTag(parts.front()) && IsMsgChannelTagValid(parts.back());
-        if (parts.back().size() > MAX_CHANNEL_NAME_LENGTH) { error = "Channel name is greater than max length of " + std::to_string(MAX_CHANNEL_NAME_LENGTH); return false; }
+        SplitTag(name, MSG_CHANNEL_TAG_DELIMITER[0], frontEnd, backBegin);
+        bool valid = IsNameValidBeforeTag(begin, frontEnd) && IsMsgChannelTagValid(backBegin, end);
+        if ((size_t)(end - backBegin) > MAX_CHANNEL_NAME_LENGTH) { error = "Channel name is greater than max length of " + std::to_string(MAX_CHANNEL_NAME_LENGTH); return false; }
         if (!valid) { error = "Message Channel name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == KnownTokenType::OWNER) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        bool valid = IsNameValidBeforeTag(name.substr(0, name.size() - 1));
+        bool valid = IsNameValidBeforeTag(begin, name.empty() ? end : end - 1);
         if (!valid) { error = "Owner name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == KnownTokenType::VOTE) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        std::vector<std::string> parts;
-        boost::split(parts, name, boost::is_any_of(VOTE_TAG_DELIMITER));
-        bool valid = IsNameValidBeforeTag(parts.front()) && IsVoteTagValid(parts.back());
+        SplitTag(name, VOTE_TAG_DELIMITER[0], frontEnd, backBegin);
+        bool valid = IsNameValidBeforeTag(begin, frontEnd) && IsVoteTagValid(backBegin, end);
         if (!valid) { error = "Vote name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == KnownTokenType::QUALIFIER || type == KnownTokenType::SUB_QUALIFIER) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        bool valid = IsQualifierNameValidBeforeTag(name);
+        bool valid = IsQualifierNameValidBeforeTag(begin, end);
         if (!valid) { error = "Qualifier name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (# must be the first character, _ . special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == KnownTokenType::RESTRICTED) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        bool valid = IsRestrictedNameValid(name);
+        bool valid = IsRestrictedNameValid(begin, end);
         if (!valid) { error = "Restricted name contains invalid characters (Valid characters are: A-Z 0-9 _ .) ($ must be the first character, _ . special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == KnownTokenType::USERNAME) {
@@ -388,7 +475,7 @@ bool IsTypeCheckNameValid(const KnownTokenType type, const std::string& name, st
             return false;
         }
 
-        bool valid = IsUsernameValid(name);
+        bool valid = IsUsernameValid(begin, end);
         if (!valid) {
             error = "Username contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";
             return false;
@@ -396,10 +483,11 @@ bool IsTypeCheckNameValid(const KnownTokenType type, const std::string& name, st
 
         return true;
     } else {
+        bool fSubtoken = IsTokenNameASubtoken(begin, end);
         if (name.size() > MAX_NAME_LENGTH - 1) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH - 1); return false; }  //Tokens and sub-tokens need to leave one extra char for OWNER indicator
-        if (!IsTokenNameASubtoken(name) && name.size() < MIN_TOKEN_LENGTH) { error = "Name must be contain " + std::to_string(MIN_TOKEN_LENGTH) + " characters"; return false; }
-        bool valid = IsNameValidBeforeTag(name);
-        if (!valid && IsTokenNameASubtoken(name) && name.size() < 3) { error = "Name must have at least 3 characters (Valid characters are: A-Z 0-9 _ .)";  return false; }
+        if (!fSubtoken && name.size() < MIN_TOKEN_LENGTH) { error = "Name must be contain " + std::to_string(MIN_TOKEN_LENGTH) + " characters"; return false; }
+        bool valid = IsNameValidBeforeTag(begin, end);
+        if (!valid && fSubtoken && name.size() < 3) { error = "Name must have at least 3 characters (Valid characters are: A-Z 0-9 _ .)";  return false; }
         if (!valid) { error = "Name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
         return true;
     }
@@ -600,7 +688,7 @@ void CNewToken::ConstructOwnerTransaction(CScript& script) const
     script << OP_PLB_TOKEN << ToByteVector(vchMessage) << OP_DROP;
 }
 
-bool TokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+bool TokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address)
 {
     // Check to see if the transaction is an new token issue tx
     if (!tx.IsNewToken())
@@ -609,10 +697,10 @@ bool TokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string&
     // Get the scriptPubKey from the last tx in vout
     CScript scriptPubKey = tx.vout[tx.vout.size() - 1].scriptPubKey;
 
-    return TokenFromScript(scriptPubKey, token, strAddress);
+    return TokenFromScript(scriptPubKey, token, address);
 }
 
-bool MsgChannelTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+bool MsgChannelTokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address)
 {
     // Check to see if the transaction is an new token issue tx
     if (!tx.IsNewMsgChannelToken())
@@ -621,10 +709,10 @@ bool MsgChannelTokenFromTransaction(const CTransaction& tx, CNewToken& token, st
     // Get the scriptPubKey from the last tx in vout
     CScript scriptPubKey = tx.vout[tx.vout.size() - 1].scriptPubKey;
 
-    return MsgChannelTokenFromScript(scriptPubKey, token, strAddress);
+    return MsgChannelTokenFromScript(scriptPubKey, token, address);
 }
 
-bool QualifierTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+bool QualifierTokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address)
 {
     // Check to see if the transaction is an new token qualifier issue tx
     if (!tx.IsNewQualifierToken())
@@ -633,9 +721,9 @@ bool QualifierTokenFromTransaction(const CTransaction& tx, CNewToken& token, std
     // Get the scriptPubKey from the last tx in vout
     CScript scriptPubKey = tx.vout[tx.vout.size() - 1].scriptPubKey;
 
-    return QualifierTokenFromScript(scriptPubKey, token, strAddress);
+    return QualifierTokenFromScript(scriptPubKey, token, address);
 }
-bool RestrictedTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+bool RestrictedTokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address)
 {
     // Check to see if the transaction is an new token qualifier issue tx
     if (!tx.IsNewRestrictedToken())
@@ -644,10 +732,10 @@ bool RestrictedTokenFromTransaction(const CTransaction& tx, CNewToken& token, st
     // Get the scriptPubKey from the last tx in vout
     CScript scriptPubKey = tx.vout[tx.vout.size() - 1].scriptPubKey;
 
-    return RestrictedTokenFromScript(scriptPubKey, token, strAddress);
+    return RestrictedTokenFromScript(scriptPubKey, token, address);
 }
 
-bool ReissueTokenFromTransaction(const CTransaction& tx, CReissueToken& reissue, std::string& strAddress)
+bool ReissueTokenFromTransaction(const CTransaction& tx, CReissueToken& reissue, CTokenAddress& address)
 {
     // Check to see if the transaction is a reissue tx
     if (!tx.IsReissueToken())
@@ -656,10 +744,10 @@ bool ReissueTokenFromTransaction(const CTransaction& tx, CReissueToken& reissue,
     // Get the scriptPubKey from the last tx in vout
     CScript scriptPubKey = tx.vout[tx.vout.size() - 1].scriptPubKey;
 
-    return ReissueTokenFromScript(scriptPubKey, reissue, strAddress);
+    return ReissueTokenFromScript(scriptPubKey, reissue, address);
 }
 
-bool UniqueTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+bool UniqueTokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address)
 {
     // Check to see if the transaction is an new token issue tx
     if (!tx.IsNewUniqueToken())
@@ -668,10 +756,10 @@ bool UniqueTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::s
     // Get the scriptPubKey from the last tx in vout
     CScript scriptPubKey = tx.vout[tx.vout.size() - 1].scriptPubKey;
 
-    return TokenFromScript(scriptPubKey, token, strAddress);
+    return TokenFromScript(scriptPubKey, token, address);
 }
 
-bool UsernameFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+bool UsernameFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address)
 {
     // Check to see if the transaction is an new token issue tx
     if (!tx.IsNewUsername())
@@ -680,14 +768,14 @@ bool UsernameFromTransaction(const CTransaction& tx, CNewToken& token, std::stri
     // Get the scriptPubKey from the last tx in vout
     CScript scriptPubKey = tx.vout[tx.vout.size() - 1].scriptPubKey;
 
-    return TokenFromScript(scriptPubKey, token, strAddress);
+    return TokenFromScript(scriptPubKey, token, address);
 }
 
-bool IsNewOwnerTxValid(const CTransaction& tx, const std::string& tokenName, const std::string& address, std::string& errorMsg)
+bool IsNewOwnerTxValid(const CTransaction& tx, const std::string& tokenName, const CTokenAddress& address, std::string& errorMsg)
 {
     // TODO when ready to ship. Put the owner validation code in own method if needed
     std::string ownerName;
-    std::string ownerAddress;
+    CTokenAddress ownerAddress;
     if (!OwnerFromTransaction(tx, ownerName, ownerAddress)) {
         errorMsg = "bad-txns-bad-owner";
         return false;
@@ -713,7 +801,7 @@ bool IsNewOwnerTxValid(const CTransaction& tx, const std::string& tokenName, con
     return true;
 }
 
-bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, std::string& strAddress)
+bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, CTokenAddress& address)
 {
     // Check to see if the transaction is an new token issue tx
     if (!tx.IsNewToken())
@@ -722,10 +810,10 @@ bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, std::s
     // Get the scriptPubKey from the last tx in vout
     CScript scriptPubKey = tx.vout[tx.vout.size() - 2].scriptPubKey;
 
-    return OwnerTokenFromScript(scriptPubKey, ownerName, strAddress);
+    return OwnerTokenFromScript(scriptPubKey, ownerName, address);
 }
 
-bool TransferTokenFromScript(const CScript& scriptPubKey, CTokenTransfer& tokenTransfer, std::string& strAddress)
+bool TransferTokenFromScript(const CScript& scriptPubKey, CTokenTransfer& tokenTransfer, CTokenAddress& address)
 {
     int nStartingIndex = 0;
     if (!IsScriptTransferToken(scriptPubKey, nStartingIndex)) {
@@ -735,7 +823,7 @@ bool TransferTokenFromScript(const CScript& scriptPubKey, CTokenTransfer& tokenT
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    address = CTokenAddress(destination);
 
     std::vector<unsigned char> vchTransferToken;
 
@@ -753,7 +841,7 @@ bool TransferTokenFromScript(const CScript& scriptPubKey, CTokenTransfer& tokenT
     return true;
 }
 
-bool TokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::string& strAddress)
+bool TokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, CTokenAddress& address)
 {
     int nStartingIndex = 0;
     if (!IsScriptNewToken(scriptPubKey, nStartingIndex))
@@ -762,7 +850,7 @@ bool TokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::stri
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    address = CTokenAddress(destination);
 
     std::vector<unsigned char> vchNewToken;
     vchNewToken.insert(vchNewToken.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
@@ -778,7 +866,7 @@ bool TokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::stri
     return true;
 }
 
-bool MsgChannelTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::string& strAddress)
+bool MsgChannelTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, CTokenAddress& address)
 {
     int nStartingIndex = 0;
     if (!IsScriptNewMsgChannelToken(scriptPubKey, nStartingIndex))
@@ -787,7 +875,7 @@ bool MsgChannelTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew,
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    address = CTokenAddress(destination);
 
     std::vector<unsigned char> vchNewToken;
     vchNewToken.insert(vchNewToken.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
@@ -803,7 +891,7 @@ bool MsgChannelTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew,
     return true;
 }
 
-bool QualifierTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::string& strAddress)
+bool QualifierTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, CTokenAddress& address)
 {
     int nStartingIndex = 0;
     if (!IsScriptNewQualifierToken(scriptPubKey, nStartingIndex))
@@ -812,7 +900,7 @@ bool QualifierTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew,
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    address = CTokenAddress(destination);
 
     std::vector<unsigned char> vchNewToken;
     vchNewToken.insert(vchNewToken.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
@@ -828,7 +916,7 @@ bool QualifierTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew,
     return true;
 }
 
-bool RestrictedTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::string& strAddress)
+bool RestrictedTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, CTokenAddress& address)
 {
     int nStartingIndex = 0;
     if (!IsScriptNewRestrictedToken(scriptPubKey, nStartingIndex))
@@ -837,7 +925,7 @@ bool RestrictedTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew,
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    address = CTokenAddress(destination);
 
     std::vector<unsigned char> vchNewToken;
     vchNewToken.insert(vchNewToken.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
@@ -853,7 +941,7 @@ bool RestrictedTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew,
     return true;
 }
 
-bool OwnerTokenFromScript(const CScript& scriptPubKey, std::string& tokenName, std::string& strAddress)
+bool OwnerTokenFromScript(const CScript& scriptPubKey, std::string& tokenName, CTokenAddress& address)
 {
     int nStartingIndex = 0;
     if (!IsScriptOwnerToken(scriptPubKey, nStartingIndex))
@@ -862,7 +950,7 @@ bool OwnerTokenFromScript(const CScript& scriptPubKey, std::string& tokenName, s
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    address = CTokenAddress(destination);
 
     std::vector<unsigned char> vchOwnerToken;
     vchOwnerToken.insert(vchOwnerToken.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
@@ -878,7 +966,7 @@ bool OwnerTokenFromScript(const CScript& scriptPubKey, std::string& tokenName, s
     return true;
 }
 
-bool ReissueTokenFromScript(const CScript& scriptPubKey, CReissueToken& reissue, std::string& strAddress)
+bool ReissueTokenFromScript(const CScript& scriptPubKey, CReissueToken& reissue, CTokenAddress& address)
 {
     int nStartingIndex = 0;
     if (!IsScriptReissueToken(scriptPubKey, nStartingIndex))
@@ -887,7 +975,7 @@ bool ReissueTokenFromScript(const CScript& scriptPubKey, CReissueToken& reissue,
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    address = CTokenAddress(destination);
 
     std::vector<unsigned char> vchReissueToken;
     vchReissueToken.insert(vchReissueToken.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
@@ -903,7 +991,7 @@ bool ReissueTokenFromScript(const CScript& scriptPubKey, CReissueToken& reissue,
     return true;
 }
 
-bool TokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& tokenData, std::string& strAddress)
+bool TokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& tokenData, CTokenAddress& address)
 {
     if (!scriptPubKey.IsNullTokenTxDataScript()) {
         return false;
@@ -912,7 +1000,7 @@ bool TokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& toke
     CTxDestination destination;
     ExtractDestination(scriptPubKey, destination);
 
-    strAddress = EncodeDestination(destination);
+    address = CTokenAddress(destination);
 
     std::vector<unsigned char> vchTokenData;
     vchTokenData.insert(vchTokenData.end(), scriptPubKey.begin() + OFFSET_TWENTY_THREE, scriptPubKey.end());
@@ -928,6 +1016,150 @@ bool TokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& toke
     return true;
 }
 
+bool TokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!TokenFromTransaction(tx, token, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool MsgChannelTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!MsgChannelTokenFromTransaction(tx, token, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool QualifierTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!QualifierTokenFromTransaction(tx, token, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool RestrictedTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!RestrictedTokenFromTransaction(tx, token, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool ReissueTokenFromTransaction(const CTransaction& tx, CReissueToken& reissue, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!ReissueTokenFromTransaction(tx, reissue, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool UniqueTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!UniqueTokenFromTransaction(tx, token, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool UsernameFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!UsernameFromTransaction(tx, token, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!OwnerFromTransaction(tx, ownerName, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool TransferTokenFromScript(const CScript& scriptPubKey, CTokenTransfer& tokenTransfer, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!TransferTokenFromScript(scriptPubKey, tokenTransfer, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool TokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!TokenFromScript(scriptPubKey, tokenNew, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool MsgChannelTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!MsgChannelTokenFromScript(scriptPubKey, tokenNew, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool QualifierTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!QualifierTokenFromScript(scriptPubKey, tokenNew, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool RestrictedTokenFromScript(const CScript& scriptPubKey, CNewToken& tokenNew, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!RestrictedTokenFromScript(scriptPubKey, tokenNew, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool OwnerTokenFromScript(const CScript& scriptPubKey, std::string& tokenName, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!OwnerTokenFromScript(scriptPubKey, tokenName, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool ReissueTokenFromScript(const CScript& scriptPubKey, CReissueToken& reissue, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!ReissueTokenFromScript(scriptPubKey, reissue, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
+bool TokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& tokenData, std::string& strAddress)
+{
+    CTokenAddress address;
+    if (!TokenNullDataFromScript(scriptPubKey, tokenData, address))
+        return false;
+    strAddress = address.ToString();
+    return true;
+}
+
 bool GlobalTokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& tokenData)
 {
     if (!scriptPubKey.IsNullGlobalRestrictionTokenTxDataScript()) {
@@ -968,6 +1200,49 @@ bool TokenNullVerifierDataFromScript(const CScript& scriptPubKey, CNullTokenTxVe
     return true;
 }
 
+const CTokenOutputEntry* CTransaction::GetTokenOutput(unsigned int n) const
+{
+    if (n >= vout.size())
+        return nullptr;
+
+    std::shared_ptr<const std::vector<CTokenOutputEntry> > outputs = std::atomic_load(&tokenOutputs);
+    if (!outputs) {
+        // Only the token outputs are kept, most outputs of most transactions aren't
+        std::shared_ptr<std::vector<CTokenOutputEntry> > decoded = std::make_shared<std::vector<CTokenOutputEntry> >();
+        for (unsigned int i = 0; i < vout.size(); i++) {
+            CTokenOutputEntry entry;
+            if (GetTokenData(vout[i].scriptPubKey, entry)) {
+                entry.vout = i;
+                decoded->push_back(std::move(entry));
+            }
+        }
+        decoded->shrink_to_fit();
+
+        // Another thread may have decoded the outputs meanwhile, keep the first result so no entry handed out is freed
+        std::shared_ptr<const std::vector<CTokenOutputEntry> > expected;
+        outputs = decoded;
+        if (!std::atomic_compare_exchange_strong(&tokenOutputs, &expected, outputs))
+            outputs = expected;
+    }
+
+    auto it = std::lower_bound(outputs->begin(), outputs->end(), n, [](const CTokenOutputEntry& entry, unsigned int n) {
+        return entry.vout < (int)n;
+    });
+    return it != outputs->end() && it->vout == (int)n ? &*it : nullptr;
+}
+
+size_t CTransaction::GetTokenOutputsDynamicUsage() const
+{
+    std::shared_ptr<const std::vector<CTokenOutputEntry> > outputs = std::atomic_load(&tokenOutputs);
+    if (!outputs)
+        return 0;
+
+    size_t mem = memusage::DynamicUsage(outputs) + memusage::DynamicUsage(*outputs);
+    for (const CTokenOutputEntry& entry : *outputs)
+        mem += memusage::DynamicUsage(entry.tokenName) + memusage::DynamicUsage(entry.message);
+    return mem;
+}
+
 //! Call VerifyNewToken if this function returns true
 bool CTransaction::IsNewToken() const
 {
@@ -1011,7 +1286,7 @@ bool CTransaction::VerifyNewUsername(std::string& strError) const
 
     // Get the token type
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!TokenFromScript(vout[vout.size() - 1].scriptPubKey, token, address)) {
         strError = "bad-txns-issue-serialzation-failed";
         return error("%s : Failed to get new token from transaction: %s", __func__, this->GetHash().GetHex());
@@ -1091,7 +1366,7 @@ bool CTransaction::VerifyNewUniqueToken(std::string& strError) const
     for (auto out : vout) {
         if (IsScriptNewUniqueToken(out.scriptPubKey)) {
             CNewToken token;
-            std::string address;
+            CTokenAddress address;
             if (!TokenFromScript(out.scriptPubKey, token, address)) {
                 strError = "bad-txns-issue-unique-token-from-script";
                 return false;
@@ -1138,7 +1413,7 @@ bool CTransaction::VerifyNewUniqueToken(std::string& strError) const
     bool fOwnerOutFound = false;
     for (auto out : vout) {
         CTokenTransfer transfer;
-        std::string transferAddress;
+        CTokenAddress transferAddress;
         if (TransferTokenFromScript(out.scriptPubKey, transfer, transferAddress)) {
             if (tokenRoot + OWNER_TAG == transfer.strName) {
                 fOwnerOutFound = true;
@@ -1189,7 +1464,7 @@ bool CTransaction::VerifyNewToken(std::string& strError) const {
 
     // Get the token type
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!TokenFromScript(vout[vout.size() - 1].scriptPubKey, token, address)) {
         strError = "bad-txns-issue-serialzation-failed";
         return error("%s : Failed to get new token from transaction: %s", __func__, this->GetHash().GetHex());
@@ -1228,7 +1503,7 @@ bool CTransaction::VerifyNewToken(std::string& strError) const {
         bool fOwnerOutFound = false;
         for (auto out : this->vout) {
             CTokenTransfer transfer;
-            std::string transferAddress;
+            CTokenAddress transferAddress;
             if (TransferTokenFromScript(out.scriptPubKey, transfer, transferAddress)) {
                 if (root + OWNER_TAG == transfer.strName) {
                     fOwnerOutFound = true;
@@ -1288,7 +1563,7 @@ bool CTransaction::VerifyNewMsgChannelToken(std::string &strError) const
 
     // Get the token type
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!MsgChannelTokenFromScript(vout[vout.size() - 1].scriptPubKey, token, address)) {
         strError = "bad-txns-issue-msgchannel-serialzation-failed";
         return error("%s : Failed to get new msgchannel token from transaction: %s", __func__, this->GetHash().GetHex());
@@ -1316,7 +1591,7 @@ bool CTransaction::VerifyNewMsgChannelToken(std::string &strError) const
     bool fOwnerOutFound = false;
     for (auto out : vout) {
         CTokenTransfer transfer;
-        std::string transferAddress;
+        CTokenAddress transferAddress;
         if (TransferTokenFromScript(out.scriptPubKey, transfer, transferAddress)) {
             if (root + OWNER_TAG == transfer.strName) {
                 fOwnerOutFound = true;
@@ -1375,7 +1650,7 @@ bool CTransaction::VerifyNewQualfierToken(std::string &strError) const
 
     // Get the token type
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!QualifierTokenFromScript(vout[vout.size() - 1].scriptPubKey, token, address)) {
         strError = "bad-txns-issue-qualifier-serialzation-failed";
         return error("%s : Failed to get new qualifier token from transaction: %s", __func__, this->GetHash().GetHex());
@@ -1404,7 +1679,7 @@ bool CTransaction::VerifyNewQualfierToken(std::string &strError) const
         std::string root = GetParentName(token.strName);
         for (auto out : vout) {
             CTokenTransfer transfer;
-            std::string transferAddress;
+            CTokenAddress transferAddress;
             if (TransferTokenFromScript(out.scriptPubKey, transfer, transferAddress)) {
                 if (root == transfer.strName) {
                     fOwnerOutFound = true;
@@ -1463,7 +1738,7 @@ bool CTransaction::VerifyNewRestrictedToken(std::string& strError) const {
 
     // Get the token type
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!RestrictedTokenFromScript(vout[vout.size() - 1].scriptPubKey, token, address)) {
         strError = "bad-txns-issue-restricted-serialization-failed";
         return error("%s : Failed to get new restricted token from transaction: %s", __func__, this->GetHash().GetHex());
@@ -1492,7 +1767,7 @@ bool CTransaction::VerifyNewRestrictedToken(std::string& strError) const {
     std::string strippedRoot = root.substr(1, root.size() -1) + OWNER_TAG; // $TOKEN checks for TOKEN!
     for (auto out : vout) {
         CTokenTransfer transfer;
-        std::string transferAddress;
+        CTokenAddress transferAddress;
         if (TransferTokenFromScript(out.scriptPubKey, transfer, transferAddress)) {
             if (strippedRoot == transfer.strName) {
                 fRootOwnerOutFound = true;
@@ -1591,7 +1866,7 @@ bool CTransaction::VerifyReissueToken(std::string& strError) const
     }
 
     CReissueToken reissue;
-    std::string address;
+    CTokenAddress address;
     if (!ReissueTokenFromScript(vout[vout.size() - 1].scriptPubKey, reissue, address)) {
         strError  = "bad-txns-reissue-serialization-failed";
         return false;
@@ -1613,7 +1888,7 @@ bool CTransaction::VerifyReissueToken(std::string& strError) const
     bool fOwnerOutFound = false;
     for (auto out : vout) {
         CTokenTransfer transfer;
-        std::string transferAddress;
+        CTokenAddress transferAddress;
         if (TransferTokenFromScript(out.scriptPubKey, transfer, transferAddress)) {
             if (token_name_to_check + OWNER_TAG == transfer.strName) {
                 fOwnerOutFound = true;
@@ -1722,7 +1997,7 @@ bool CTokenTransfer::IsValid(std::string& strError) const
     return true;
 }
 
-bool CTokenTransfer::ContextualCheckAgainstVerifyString(CTokensCache *tokenCache, const std::string& address, std::string& strError) const
+bool CTokenTransfer::ContextualCheckAgainstVerifyString(CTokensCache *tokenCache, const CTokenAddress& address, std::string& strError) const
 {
     // Get the verifier string
     CNullTokenTxVerifierString verifier;
@@ -1789,7 +2064,7 @@ bool CReissueToken::IsNull() const
     return strName == "" || nAmount < 0;
 }
 
-bool CTokensCache::AddTransferToken(const CTokenTransfer& transferToken, const std::string& address, const COutPoint& out, const CTxOut& txOut)
+bool CTokensCache::AddTransferToken(const CTokenTransfer& transferToken, const CTokenAddress& address, const COutPoint& out, const CTxOut& txOut)
 {
     AddToTokenBalance(transferToken.strName, address, transferToken.nAmount);
 
@@ -1804,7 +2079,7 @@ bool CTokensCache::AddTransferToken(const CTokenTransfer& transferToken, const s
     return true;
 }
 
-void CTokensCache::AddToTokenBalance(const std::string& strName, const std::string& address, const CAmount& nAmount)
+void CTokensCache::AddToTokenBalance(const std::string& strName, const CTokenAddress& address, const CAmount& nAmount)
 {
     if (fTokenIndex) {
         auto pair = std::make_pair(strName, address);
@@ -1824,8 +2099,8 @@ void CTokensCache::AddToTokenBalance(const std::string& strName, const std::stri
 
 bool CTokensCache::TrySpendCoin(const COutPoint& out, const CTxOut& txOut)
 {
-    // Placeholder strings that will get set if you successfully get the transfer or token from the script
-    std::string address = "";
+    // Placeholders that will get set if you successfully get the transfer or token from the script
+    CTokenAddress address;
     std::string tokenName = "";
     CAmount nAmount = -1;
 
@@ -1865,7 +2140,7 @@ bool CTokensCache::TrySpendCoin(const COutPoint& out, const CTxOut& txOut)
     }
 
     // If we got the address and the tokenName, proceed to remove it from the database, and in memory objects
-    if (address != "" && tokenName != "") {
+    if (!address.IsNull() && tokenName != "") {
         if (fTokenIndex && nAmount > 0) {
             CTokenCacheSpendToken spend(tokenName, address, nAmount);
             if (GetBestTokenAddressAmount(*this, tokenName, address)) {
@@ -1899,7 +2174,7 @@ bool CTokensCache::ContainsToken(const std::string& tokenName)
 
 bool CTokensCache::UndoTokenCoin(const Coin& coin, const COutPoint& out)
 {
-    std::string strAddress = "";
+    CTokenAddress address;
     std::string tokenName = "";
     CAmount nAmount = 0;
 
@@ -1910,7 +2185,7 @@ bool CTokensCache::UndoTokenCoin(const Coin& coin, const COutPoint& out)
 
         if (nType == TX_NEW_TOKEN && !fIsOwner) {
             CNewToken token;
-            if (!TokenFromScript(coin.out.scriptPubKey, token, strAddress)) {
+            if (!TokenFromScript(coin.out.scriptPubKey, token, address)) {
                 return error("%s : Failed to get token from script while trying to undo token spend. OutPoint : %s",
                              __func__,
                              out.ToString());
@@ -1920,7 +2195,7 @@ bool CTokensCache::UndoTokenCoin(const Coin& coin, const COutPoint& out)
             nAmount = token.nAmount;
         } else if (nType == TX_TRANSFER_TOKEN) {
             CTokenTransfer transfer;
-            if (!TransferTokenFromScript(coin.out.scriptPubKey, transfer, strAddress))
+            if (!TransferTokenFromScript(coin.out.scriptPubKey, transfer, address))
                 return error(
                         "%s : Failed to get transfer token from script while trying to undo token spend. OutPoint : %s",
                         __func__,
@@ -1930,7 +2205,7 @@ bool CTokensCache::UndoTokenCoin(const Coin& coin, const COutPoint& out)
             nAmount = transfer.nAmount;
         } else if (nType == TX_NEW_TOKEN && fIsOwner) {
             std::string ownerName;
-            if (!OwnerTokenFromScript(coin.out.scriptPubKey, ownerName, strAddress))
+            if (!OwnerTokenFromScript(coin.out.scriptPubKey, ownerName, address))
                 return error(
                         "%s : Failed to get owner token from script while trying to undo token spend. OutPoint : %s",
                         __func__, out.ToString());
@@ -1938,7 +2213,7 @@ bool CTokensCache::UndoTokenCoin(const Coin& coin, const COutPoint& out)
             nAmount = OWNER_TOKEN_AMOUNT;
         } else if (nType == TX_REISSUE_TOKEN) {
             CReissueToken reissue;
-            if (!ReissueTokenFromScript(coin.out.scriptPubKey, reissue, strAddress))
+            if (!ReissueTokenFromScript(coin.out.scriptPubKey, reissue, address))
                 return error(
                         "%s : Failed to get reissue token from script while trying to undo token spend. OutPoint : %s",
                         __func__, out.ToString());
@@ -1947,17 +2222,17 @@ bool CTokensCache::UndoTokenCoin(const Coin& coin, const COutPoint& out)
         }
     }
 
-    if (tokenName == "" || strAddress == "" || nAmount == 0)
-        return error("%s : TokenName, Address or nAmount is invalid., Token Name: %s, Address: %s, Amount: %d", __func__, tokenName, strAddress, nAmount);
+    if (tokenName == "" || address.IsNull() || nAmount == 0)
+        return error("%s : TokenName, Address or nAmount is invalid., Token Name: %s, Address: %s, Amount: %d", __func__, tokenName, address.ToString(), nAmount);
 
-    if (!AddBackSpentToken(coin, tokenName, strAddress, nAmount, out))
+    if (!AddBackSpentToken(coin, tokenName, address, nAmount, out))
         return error("%s : Failed to add back the spent token. OutPoint : %s", __func__, out.ToString());
 
     return true;
 }
 
 //! Changes Memory Only
-bool CTokensCache::AddBackSpentToken(const Coin& coin, const std::string& tokenName, const std::string& address, const CAmount& nAmount, const COutPoint& out)
+bool CTokensCache::AddBackSpentToken(const Coin& coin, const std::string& tokenName, const CTokenAddress& address, const CAmount& nAmount, const COutPoint& out)
 {
     if (fTokenIndex) {
         // Update the tokens address balance
@@ -1978,24 +2253,24 @@ bool CTokensCache::AddBackSpentToken(const Coin& coin, const std::string& tokenN
 }
 
 //! Changes Memory Only
-bool CTokensCache::UndoTransfer(const CTokenTransfer& transfer, const std::string& address, const COutPoint& outToRemove)
+bool CTokensCache::UndoTransfer(const CTokenTransfer& transfer, const CTokenAddress& address, const COutPoint& outToRemove)
 {
     if (fTokenIndex) {
         // Make sure we are in a valid state to undo the transfer of the token
         if (!GetBestTokenAddressAmount(*this, transfer.strName, address))
             return error("%s : Failed to get the tokens address balance from the database. Token : %s Address : %s",
-                         __func__, transfer.strName, address);
+                         __func__, transfer.strName, address.ToString());
 
         auto pair = std::make_pair(transfer.strName, address);
         if (!mapTokensAddressAmount.count(pair))
             return error(
                     "%s : Tried undoing a transfer and the map of address amount didn't have the token address pair. Token : %s Address : %s",
-                    __func__, transfer.strName, address);
+                    __func__, transfer.strName, address.ToString());
 
         if (mapTokensAddressAmount.at(pair) < transfer.nAmount)
             return error(
                     "%s : Tried undoing a transfer and the map of address amount had less than the amount we are trying to undo. Token : %s Address : %s",
-                    __func__, transfer.strName, address);
+                    __func__, transfer.strName, address.ToString());
 
         // Change the in memory balance of the token at the address
         mapTokensAddressAmount[pair] -= transfer.nAmount;
@@ -2005,7 +2280,7 @@ bool CTokensCache::UndoTransfer(const CTokenTransfer& transfer, const std::strin
 }
 
 //! Changes Memory Only
-bool CTokensCache::RemoveNewToken(const CNewToken& token, const std::string address)
+bool CTokensCache::RemoveNewToken(const CNewToken& token, const CTokenAddress& address)
 {
     if (!CheckIfTokenExists(token.strName))
         return error("%s : Tried removing an token that didn't exist. Token Name : %s", __func__, token.strName);
@@ -2024,7 +2299,7 @@ bool CTokensCache::RemoveNewToken(const CNewToken& token, const std::string addr
 }
 
 //! Changes Memory Only
-bool CTokensCache::AddNewToken(const CNewToken& token, const std::string address, const int& nHeight, const uint256& blockHash)
+bool CTokensCache::AddNewToken(const CNewToken& token, const CTokenAddress& address, const int& nHeight, const uint256& blockHash)
 {
     if(CheckIfTokenExists(token.strName))
         return error("%s: Tried adding new token, but it already existed in the set of tokens: %s", __func__, token.strName);
@@ -2045,7 +2320,7 @@ bool CTokensCache::AddNewToken(const CNewToken& token, const std::string address
 }
 
 //! Changes Memory Only
-bool CTokensCache::AddReissueToken(const CReissueToken& reissue, const std::string address, const COutPoint& out)
+bool CTokensCache::AddReissueToken(const CReissueToken& reissue, const CTokenAddress& address, const COutPoint& out)
 {
     auto pair = std::make_pair(reissue.strName, address);
 
@@ -2075,21 +2350,23 @@ bool CTokensCache::AddReissueToken(const CReissueToken& reissue, const std::stri
 
         mapReissuedTokenData.insert(make_pair(reissue.strName, token));
     } else {
-        mapReissuedTokenData.at(reissue.strName).nAmount += reissue.nAmount;
-        mapReissuedTokenData.at(reissue.strName).nReissuable = reissue.nReissuable;
+        mapReissuedTokenData.Modify(reissue.strName, [&reissue](CNewToken& token) {
+            token.nAmount += reissue.nAmount;
+            token.nReissuable = reissue.nReissuable;
 
-        mapReissuedTokenData.at(reissue.strName).nHasRoyalties = reissue.nHasRoyalties;
-        mapReissuedTokenData.at(reissue.strName).nRoyaltiesAddress = reissue.nRoyaltiesAddress;
-        mapReissuedTokenData.at(reissue.strName).nRoyaltiesAmount = reissue.nRoyaltiesAmount;
+            token.nHasRoyalties = reissue.nHasRoyalties;
+            token.nRoyaltiesAddress = reissue.nRoyaltiesAddress;
+            token.nRoyaltiesAmount = reissue.nRoyaltiesAmount;
 
-        if (reissue.nUnits != -1) {
-            mapReissuedTokenData.at(reissue.strName).units = reissue.nUnits;
-        }
+            if (reissue.nUnits != -1) {
+                token.units = reissue.nUnits;
+            }
 
-        if (reissue.strIPFSHash != "") {
-            mapReissuedTokenData.at(reissue.strName).nHasIPFS = 1;
-            mapReissuedTokenData.at(reissue.strName).strIPFSHash = reissue.strIPFSHash;
-        }
+            if (reissue.strIPFSHash != "") {
+                token.nHasIPFS = 1;
+                token.strIPFSHash = reissue.strIPFSHash;
+            }
+        });
     }
 
     CTokenCacheReissueToken reissueToken(reissue, address, out, tokenHeight, tokenBlockHash);
@@ -2113,7 +2390,7 @@ bool CTokensCache::AddReissueToken(const CReissueToken& reissue, const std::stri
 }
 
 //! Changes Memory Only
-bool CTokensCache::RemoveReissueToken(const CReissueToken& reissue, const std::string address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockTokenUndo> >& vUndoIPFS)
+bool CTokensCache::RemoveReissueToken(const CReissueToken& reissue, const CTokenAddress& address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockTokenUndo> >& vUndoIPFS)
 {
     auto pair = std::make_pair(reissue.strName, address);
 
@@ -2147,7 +2424,7 @@ bool CTokensCache::RemoveReissueToken(const CReissueToken& reissue, const std::s
         }
     }
 
-    mapReissuedTokenData[tokenData.strName] = tokenData;
+    mapReissuedTokenData.Set(tokenData.strName, tokenData);
 
     CTokenCacheReissueToken reissueToken(reissue, address, out, height, blockHash);
 
@@ -2179,7 +2456,7 @@ bool CTokensCache::RemoveReissueToken(const CReissueToken& reissue, const std::s
 }
 
 //! Changes Memory Only
-bool CTokensCache::AddOwnerToken(const std::string& tokensName, const std::string address)
+bool CTokensCache::AddOwnerToken(const std::string& tokensName, const CTokenAddress& address)
 {
     // Update the cache
     CTokenCacheNewOwner newOwner(tokensName, address);
@@ -2198,7 +2475,7 @@ bool CTokensCache::AddOwnerToken(const std::string& tokensName, const std::strin
 }
 
 //! Changes Memory Only
-bool CTokensCache::RemoveOwnerToken(const std::string& tokensName, const std::string address)
+bool CTokensCache::RemoveOwnerToken(const std::string& tokensName, const CTokenAddress& address)
 {
     // Update the cache
     CTokenCacheNewOwner newOwner(tokensName, address);
@@ -2216,7 +2493,7 @@ bool CTokensCache::RemoveOwnerToken(const std::string& tokensName, const std::st
 }
 
 //! Changes Memory Only
-bool CTokensCache::RemoveTransfer(const CTokenTransfer &transfer, const std::string &address, const COutPoint &out)
+bool CTokensCache::RemoveTransfer(const CTokenTransfer &transfer, const CTokenAddress& address, const COutPoint &out)
 {
     if (!UndoTransfer(transfer, address, out))
         return error("%s : Failed to undo the transfer", __func__);
@@ -2231,7 +2508,7 @@ bool CTokensCache::RemoveTransfer(const CTokenTransfer &transfer, const std::str
 }
 
 //! Changes Memory Only, this only called when adding a block to the chain
-bool CTokensCache::AddQualifierAddress(const std::string& tokenName, const std::string& address, const QualifierType type)
+bool CTokensCache::AddQualifierAddress(const std::string& tokenName, const CTokenAddress& address, const QualifierType type)
 {
     CTokenCacheQualifierAddress newQualifier(tokenName, address, type);
 
@@ -2247,12 +2524,15 @@ bool CTokensCache::AddQualifierAddress(const std::string& tokenName, const std::
     }
 
     if (IsTokenNameASubQualifier(tokenName)) {
+        CTokenCacheRootQualifierChecker rootChecker(GetParentName(tokenName), address);
+        auto fnInsert = [&tokenName](std::set<std::string>& tokens) { tokens.insert(tokenName); };
+        auto fnErase = [&tokenName](std::set<std::string>& tokens) { tokens.erase(tokenName); };
         if (type == QualifierType::ADD_QUALIFIER) {
-            mapRootQualifierAddressesAdd[CTokenCacheRootQualifierChecker(GetParentName(tokenName), address)].insert(tokenName);
-            mapRootQualifierAddressesRemove[CTokenCacheRootQualifierChecker(GetParentName(tokenName), address)].erase(tokenName);
+            mapRootQualifierAddressesAdd.Modify(rootChecker, fnInsert);
+            mapRootQualifierAddressesRemove.Modify(rootChecker, fnErase);
         } else {
-            mapRootQualifierAddressesRemove[CTokenCacheRootQualifierChecker(GetParentName(tokenName), address)].insert(tokenName);
-            mapRootQualifierAddressesAdd[CTokenCacheRootQualifierChecker(GetParentName(tokenName), address)].erase(tokenName);
+            mapRootQualifierAddressesRemove.Modify(rootChecker, fnInsert);
+            mapRootQualifierAddressesAdd.Modify(rootChecker, fnErase);
         }
     }
 
@@ -2262,7 +2542,7 @@ bool CTokensCache::AddQualifierAddress(const std::string& tokenName, const std::
 }
 
 //! Changes Memory Only, this is only called when undoing a block from the chain
-bool CTokensCache::RemoveQualifierAddress(const std::string& tokenName, const std::string& address, const QualifierType type)
+bool CTokensCache::RemoveQualifierAddress(const std::string& tokenName, const CTokenAddress& address, const QualifierType type)
 {
     CTokenCacheQualifierAddress newQualifier(tokenName, address, type);
 
@@ -2278,14 +2558,17 @@ bool CTokensCache::RemoveQualifierAddress(const std::string& tokenName, const st
     }
 
     if (IsTokenNameASubQualifier(tokenName)) {
+        CTokenCacheRootQualifierChecker rootChecker(GetParentName(tokenName), address);
+        auto fnInsert = [&tokenName](std::set<std::string>& tokens) { tokens.insert(tokenName); };
+        auto fnErase = [&tokenName](std::set<std::string>& tokens) { tokens.erase(tokenName); };
         if (type == QualifierType::ADD_QUALIFIER) {
             // When undoing a add, we want to remove it
-            mapRootQualifierAddressesRemove[CTokenCacheRootQualifierChecker(GetParentName(tokenName), address)].insert(tokenName);
-            mapRootQualifierAddressesAdd[CTokenCacheRootQualifierChecker(GetParentName(tokenName), address)].erase(tokenName);
+            mapRootQualifierAddressesRemove.Modify(rootChecker, fnInsert);
+            mapRootQualifierAddressesAdd.Modify(rootChecker, fnErase);
         } else {
             // When undoing a remove, we want to add it
-            mapRootQualifierAddressesAdd[CTokenCacheRootQualifierChecker(GetParentName(tokenName), address)].insert(tokenName);
-            mapRootQualifierAddressesRemove[CTokenCacheRootQualifierChecker(GetParentName(tokenName), address)].erase(tokenName);
+            mapRootQualifierAddressesAdd.Modify(rootChecker, fnInsert);
+            mapRootQualifierAddressesRemove.Modify(rootChecker, fnErase);
         }
     }
 
@@ -2296,7 +2579,7 @@ bool CTokensCache::RemoveQualifierAddress(const std::string& tokenName, const st
 
 
 //! Changes Memory Only, this only called when adding a block to the chain
-bool CTokensCache::AddRestrictedAddress(const std::string& tokenName, const std::string& address, const RestrictedType type)
+bool CTokensCache::AddRestrictedAddress(const std::string& tokenName, const CTokenAddress& address, const RestrictedType type)
 {
     CTokenCacheRestrictedAddress newRestricted(tokenName, address, type);
 
@@ -2317,7 +2600,7 @@ bool CTokensCache::AddRestrictedAddress(const std::string& tokenName, const std:
 }
 
 //! Changes Memory Only, this is only called when undoing a block from the chain
-bool CTokensCache::RemoveRestrictedAddress(const std::string& tokenName, const std::string& address, const RestrictedType type)
+bool CTokensCache::RemoveRestrictedAddress(const std::string& tokenName, const CTokenAddress& address, const RestrictedType type)
 {
     CTokenCacheRestrictedAddress newRestricted(tokenName, address, type);
 
@@ -2407,181 +2690,80 @@ bool CTokensCache::RemoveRestrictedVerifier(const std::string& tokenName, const
     return true;
 }
 
-bool CTokensCache::DumpCacheToDatabase()
+static int64_t nTimeDumpTokens = 0;
+static int64_t nDumpTokensCount = 0;
+static uint64_t nDumpTokensBytes = 0;
+
+bool CTokensCache::DumpCacheToDatabase(const uint256& hashBlock)
 {
     try {
-        bool dirty = false;
-        std::string message;
+        int64_t nTimeStart = GetTimeMicros();
+
+        // All the changes are collected first and written in one batch per database, so a failure part way through
+        // doesn't leave the databases holding only some of them
+        CTokensDBBatch tokensBatch;
+        CDBOrderedBatch restrictedBatch;
 
         // Remove new tokens from the database
         for (auto newToken : setNewTokensToRemove) {
             ptokensCache->Erase(newToken.token.strName);
-            if (!ptokensdb->EraseTokenData(newToken.token.strName)) {
-                dirty = true;
-                message = "_Failed Erasing New Token Data from database";
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
-
-            if (!prestricteddb->EraseVerifier(newToken.token.strName)) {
-                dirty = true;
-                message = "_Failed Erasing verifier of new token removal data from database";
-            }
+            ptokensdb->EraseTokenData(tokensBatch, newToken.token.strName);
+            prestricteddb->EraseVerifier(restrictedBatch, newToken.token.strName);
 
             if (fTokenIndex) {
-                if (!ptokensdb->EraseTokenAddressQuantity(newToken.token.strName, newToken.address)) {
-                    dirty = true;
-                    message = "_Failed Erasing Address Balance from database";
-                }
-
-                if (!ptokensdb->EraseAddressTokenQuantity(newToken.address, newToken.token.strName)) {
-                    dirty = true;
-                    message = "_Failed Erasing New Token Address Balance from AddressToken database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                ptokensdb->EraseTokenAddressQuantity(tokensBatch, newToken.token.strName, newToken.address);
+                ptokensdb->EraseAddressTokenQuantity(tokensBatch, newToken.address, newToken.token.strName);
             }
         }
 
         // Add the new tokens to the database
         for (auto newToken : setNewTokensToAdd) {
             ptokensCache->Put(newToken.token.strName, CDatabasedTokenData(newToken.token, newToken.blockHeight, newToken.blockHash));
-            if (!ptokensdb->WriteTokenData(newToken.token, newToken.blockHeight, newToken.blockHash)) {
-                dirty = true;
-                message = "_Failed Writing New Token Data to database";
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
+            ptokensdb->WriteTokenData(tokensBatch, newToken.token, newToken.blockHeight, newToken.blockHash);
 
             if (fTokenIndex) {
-                if (!ptokensdb->WriteTokenAddressQuantity(newToken.token.strName, newToken.address,
-                                                          newToken.token.nAmount)) {
-                    dirty = true;
-                    message = "_Failed Writing Address Balance to database";
-                }
-
-                if (!ptokensdb->WriteAddressTokenQuantity(newToken.address, newToken.token.strName,
-                                                          newToken.token.nAmount)) {
-                    dirty = true;
-                    message = "_Failed Writing Address Balance to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                ptokensdb->WriteTokenAddressQuantity(tokensBatch, newToken.token.strName, newToken.address, newToken.token.nAmount);
+                ptokensdb->WriteAddressTokenQuantity(tokensBatch, newToken.address, newToken.token.strName, newToken.token.nAmount);
             }
         }
 
         if (fTokenIndex) {
             // Remove the new owners from database
             for (auto ownerToken : setNewOwnerTokensToRemove) {
-                if (!ptokensdb->EraseTokenAddressQuantity(ownerToken.tokenName, ownerToken.address)) {
-                    dirty = true;
-                    message = "_Failed Erasing Owner Address Balance from database";
-                }
-
-                if (!ptokensdb->EraseAddressTokenQuantity(ownerToken.address, ownerToken.tokenName)) {
-                    dirty = true;
-                    message = "_Failed Erasing New Owner Address Balance from AddressToken database";
-                }
-
-                if (dirty) {
-                    return error("%s : %s", __func__, message);
-                }
+                ptokensdb->EraseTokenAddressQuantity(tokensBatch, ownerToken.tokenName, ownerToken.address);
+                ptokensdb->EraseAddressTokenQuantity(tokensBatch, ownerToken.address, ownerToken.tokenName);
             }
 
             // Add the new owners to database
             for (auto ownerToken : setNewOwnerTokensToAdd) {
                 auto pair = std::make_pair(ownerToken.tokenName, ownerToken.address);
                 if (mapTokensAddressAmount.count(pair) && mapTokensAddressAmount.at(pair) > 0) {
-                    if (!ptokensdb->WriteTokenAddressQuantity(ownerToken.tokenName, ownerToken.address,
-                                                              mapTokensAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing Owner Address Balance to database";
-                    }
-
-                    if (!ptokensdb->WriteAddressTokenQuantity(ownerToken.address, ownerToken.tokenName,
-                                                              mapTokensAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing Address Balance to database";
-                    }
-
-                    if (dirty) {
-                        return error("%s : %s", __func__, message);
-                    }
+                    ptokensdb->WriteTokenAddressQuantity(tokensBatch, ownerToken.tokenName, ownerToken.address, mapTokensAddressAmount.at(pair));
+                    ptokensdb->WriteAddressTokenQuantity(tokensBatch, ownerToken.address, ownerToken.tokenName, mapTokensAddressAmount.at(pair));
                 }
             }
 
             // Undo the transfering by updating the balances in the database
-
             for (auto undoTransfer : setNewTransferTokensToRemove) {
                 auto pair = std::make_pair(undoTransfer.transfer.strName, undoTransfer.address);
                 if (mapTokensAddressAmount.count(pair)) {
                     if (mapTokensAddressAmount.at(pair) == 0) {
-                        if (!ptokensdb->EraseTokenAddressQuantity(undoTransfer.transfer.strName,
-                                                                  undoTransfer.address)) {
-                            dirty = true;
-                            message = "_Failed Erasing Address Quantity from database";
-                        }
-
-                        if (!ptokensdb->EraseAddressTokenQuantity(undoTransfer.address,
-                                                                  undoTransfer.transfer.strName)) {
-                            dirty = true;
-                            message = "_Failed Erasing UndoTransfer Address Balance from AddressToken database";
-                        }
-
-                        if (dirty) {
-                            return error("%s : %s", __func__, message);
-                        }
+                        ptokensdb->EraseTokenAddressQuantity(tokensBatch, undoTransfer.transfer.strName, undoTransfer.address);
+                        ptokensdb->EraseAddressTokenQuantity(tokensBatch, undoTransfer.address, undoTransfer.transfer.strName);
                     } else {
-                        if (!ptokensdb->WriteTokenAddressQuantity(undoTransfer.transfer.strName,
-                                                                  undoTransfer.address,
-                                                                  mapTokensAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing updated Address Quantity to database when undoing transfers";
-                        }
-
-                        if (!ptokensdb->WriteAddressTokenQuantity(undoTransfer.address,
-                                                                  undoTransfer.transfer.strName,
-                                                                  mapTokensAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing Address Balance to database";
-                        }
-
-                        if (dirty) {
-                            return error("%s : %s", __func__, message);
-                        }
+                        ptokensdb->WriteTokenAddressQuantity(tokensBatch, undoTransfer.transfer.strName, undoTransfer.address, mapTokensAddressAmount.at(pair));
+                        ptokensdb->WriteAddressTokenQuantity(tokensBatch, undoTransfer.address, undoTransfer.transfer.strName, mapTokensAddressAmount.at(pair));
                     }
                 }
             }
 
-
             // Save the new transfers by updating the quantity in the database
             for (auto newTransfer : setNewTransferTokensToAdd) {
                 auto pair = std::make_pair(newTransfer.transfer.strName, newTransfer.address);
                 // During init and reindex it disconnects and verifies blocks, can create a state where vNewTransfer will contain transfers that have already been spent. So if they aren't in the map, we can skip them.
                 if (mapTokensAddressAmount.count(pair)) {
-                    if (!ptokensdb->WriteTokenAddressQuantity(newTransfer.transfer.strName, newTransfer.address,
-                                                              mapTokensAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing new address quantity to database";
-                    }
-
-                    if (!ptokensdb->WriteAddressTokenQuantity(newTransfer.address, newTransfer.transfer.strName,
-                                                              mapTokensAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing Address Balance to database";
-                    }
-
-                    if (dirty) {
-                        return error("%s : %s", __func__, message);
-                    }
+                    ptokensdb->WriteTokenAddressQuantity(tokensBatch, newTransfer.transfer.strName, newTransfer.address, mapTokensAddressAmount.at(pair));
+                    ptokensdb->WriteAddressTokenQuantity(tokensBatch, newTransfer.address, newTransfer.transfer.strName, mapTokensAddressAmount.at(pair));
                 }
             }
         }
@@ -2590,35 +2772,13 @@ bool CTokensCache::DumpCacheToDatabase()
             auto reissue_name = newReissue.reissue.strName;
             auto pair = make_pair(reissue_name, newReissue.address);
             if (mapReissuedTokenData.count(reissue_name)) {
-                if(!ptokensdb->WriteTokenData(mapReissuedTokenData.at(reissue_name), newReissue.blockHeight, newReissue.blockHash)) {
-                    dirty = true;
-                    message = "_Failed Writing reissue token data to database";
-                }
-
-                if (dirty) {
-                    return error("%s : %s", __func__, message);
-                }
-
+                ptokensdb->WriteTokenData(tokensBatch, mapReissuedTokenData.at(reissue_name), newReissue.blockHeight, newReissue.blockHash);
                 ptokensCache->Erase(reissue_name);
 
                 if (fTokenIndex) {
-
                     if (mapTokensAddressAmount.count(pair) && mapTokensAddressAmount.at(pair) > 0) {
-                        if (!ptokensdb->WriteTokenAddressQuantity(pair.first, pair.second,
-                                                                  mapTokensAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing reissue token quantity to the address quantity database";
-                        }
-
-                        if (!ptokensdb->WriteAddressTokenQuantity(pair.second, pair.first,
-                                                                  mapTokensAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing Address Balance to database";
-                        }
-
-                        if (dirty) {
-                            return error("%s, %s", __func__, message);
-                        }
+                        ptokensdb->WriteTokenAddressQuantity(tokensBatch, pair.first, pair.second, mapTokensAddressAmount.at(pair));
+                        ptokensdb->WriteAddressTokenQuantity(tokensBatch, pair.second, pair.first, mapTokensAddressAmount.at(pair));
                     }
                 }
             }
@@ -2629,51 +2789,28 @@ bool CTokensCache::DumpCacheToDatabase()
             // we can skip this call because the removal of the issue should remove all data pertaining the to token
             // Fixes the issue where the reissue data will write over the removed token meta data that was removed above
             CNewToken token(undoReissue.reissue.strName, 0);
-            CTokenCacheNewToken testNewTokenCache(token, "", 0 , uint256());
+            CTokenCacheNewToken testNewTokenCache(token, CTokenAddress(), 0 , uint256());
             if (setNewTokensToRemove.count(testNewTokenCache)) {
                 continue;
             }
 
             auto reissue_name = undoReissue.reissue.strName;
             if (mapReissuedTokenData.count(reissue_name)) {
-                if(!ptokensdb->WriteTokenData(mapReissuedTokenData.at(reissue_name), undoReissue.blockHeight, undoReissue.blockHash)) {
-                    dirty = true;
-                    message = "_Failed Writing undo reissue token data to database";
-                }
+                ptokensdb->WriteTokenData(tokensBatch, mapReissuedTokenData.at(reissue_name), undoReissue.blockHeight, undoReissue.blockHash);
 
                 if (fTokenIndex) {
                     auto pair = make_pair(undoReissue.reissue.strName, undoReissue.address);
                     if (mapTokensAddressAmount.count(pair)) {
                         if (mapTokensAddressAmount.at(pair) == 0) {
-                            if (!ptokensdb->EraseTokenAddressQuantity(reissue_name, undoReissue.address)) {
-                                dirty = true;
-                                message = "_Failed Erasing Address Balance from database";
-                            }
-
-                            if (!ptokensdb->EraseAddressTokenQuantity(undoReissue.address, reissue_name)) {
-                                dirty = true;
-                                message = "_Failed Erasing UndoReissue Balance from AddressToken database";
-                            }
+                            ptokensdb->EraseTokenAddressQuantity(tokensBatch, reissue_name, undoReissue.address);
+                            ptokensdb->EraseAddressTokenQuantity(tokensBatch, undoReissue.address, reissue_name);
                         } else {
-                            if (!ptokensdb->WriteTokenAddressQuantity(reissue_name, undoReissue.address,
-                                                                      mapTokensAddressAmount.at(pair))) {
-                                dirty = true;
-                                message = "_Failed Writing the undo of reissue of token from database";
-                            }
-
-                            if (!ptokensdb->WriteAddressTokenQuantity(undoReissue.address, reissue_name,
-                                                                      mapTokensAddressAmount.at(pair))) {
-                                dirty = true;
-                                message = "_Failed Writing Address Balance to database";
-                            }
+                            ptokensdb->WriteTokenAddressQuantity(tokensBatch, reissue_name, undoReissue.address, mapTokensAddressAmount.at(pair));
+                            ptokensdb->WriteAddressTokenQuantity(tokensBatch, undoReissue.address, reissue_name, mapTokensAddressAmount.at(pair));
                         }
                     }
                 }
 
-                if (dirty) {
-                    return error("%s : %s", __func__, message);
-                }
-
                 ptokensCache->Erase(reissue_name);
             }
         }
@@ -2681,15 +2818,7 @@ bool CTokensCache::DumpCacheToDatabase()
         // Add new verifier strings for restricted tokens
         for (auto newVerifier : setNewRestrictedVerifierToAdd) {
             auto tokenName = newVerifier.tokenName;
-            if (!prestricteddb->WriteVerifier(tokenName, newVerifier.verifier)) {
-                dirty = true;
-                message = "_Failed Writing restricted verifier to database";
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
-
+            prestricteddb->WriteVerifier(restrictedBatch, tokenName, newVerifier.verifier);
             ptokensVerifierCache->Erase(tokenName);
         }
 
@@ -2699,19 +2828,9 @@ bool CTokensCache::DumpCacheToDatabase()
 
             // If we are undoing a reissue, we need to save back the old verifier string to database
             if (undoVerifiers.fUndoingRessiue) {
-                if (!prestricteddb->WriteVerifier(tokenName, undoVerifiers.verifier)) {
-                    dirty = true;
-                    message = "_Failed Writing undo restricted verifer to database";
-                }
+                prestricteddb->WriteVerifier(restrictedBatch, tokenName, undoVerifiers.verifier);
             } else {
-                if (!prestricteddb->EraseVerifier(tokenName)) {
-                    dirty = true;
-                    message = "_Failed Writing undo restricted verifer to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                prestricteddb->EraseVerifier(restrictedBatch, tokenName);
             }
 
             ptokensVerifierCache->Erase(tokenName);
@@ -2721,93 +2840,44 @@ bool CTokensCache::DumpCacheToDatabase()
         for (auto newQualifierAddress : setNewQualifierAddressToAdd) {
             if (newQualifierAddress.type == QualifierType::REMOVE_QUALIFIER) {
                 ptokensQualifierCache->Erase(newQualifierAddress.GetHash().GetHex());
-                if (!prestricteddb->EraseAddressQualifier(newQualifierAddress.address, newQualifierAddress.tokenName)) {
-                    dirty = true;
-                    message = "_Failed Erasing address qualifier from database";
-                }
-                if (fTokenIndex && !dirty) {
-                    if (!prestricteddb->EraseQualifierAddress(newQualifierAddress.address,
-                                                              newQualifierAddress.tokenName)) {
-                        dirty = true;
-                        message = "_Failed Erasing qualifier address from database";
-                    }
+                prestricteddb->EraseAddressQualifier(restrictedBatch, newQualifierAddress.address, newQualifierAddress.tokenName);
+                if (fTokenIndex) {
+                    prestricteddb->EraseQualifierAddress(restrictedBatch, newQualifierAddress.address, newQualifierAddress.tokenName);
                 }
             } else if (newQualifierAddress.type == QualifierType::ADD_QUALIFIER) {
                 ptokensQualifierCache->Put(newQualifierAddress.GetHash().GetHex(), 1);
-                if (!prestricteddb->WriteAddressQualifier(newQualifierAddress.address, newQualifierAddress.tokenName))
-                {
-                    dirty = true;
-                    message = "_Failed Writing address qualifier to database";
-                }
-                if (fTokenIndex & !dirty) {
-                    if (!prestricteddb->WriteQualifierAddress(newQualifierAddress.address, newQualifierAddress.tokenName))
-                    {
-                        dirty = true;
-                        message = "_Failed Writing qualifier address to database";
-                    }
+                prestricteddb->WriteAddressQualifier(restrictedBatch, newQualifierAddress.address, newQualifierAddress.tokenName);
+                if (fTokenIndex) {
+                    prestricteddb->WriteQualifierAddress(restrictedBatch, newQualifierAddress.address, newQualifierAddress.tokenName);
                 }
             }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
         }
 
         // Undo the qualifier commands
         for (auto undoQualifierAddress : setNewQualifierAddressToRemove) {
             if (undoQualifierAddress.type == QualifierType::REMOVE_QUALIFIER) { // If we are undoing a removal, we write the data to database
                 ptokensQualifierCache->Put(undoQualifierAddress.GetHash().GetHex(), 1);
-                if (!prestricteddb->WriteAddressQualifier(undoQualifierAddress.address, undoQualifierAddress.tokenName)) {
-                    dirty = true;
-                    message = "_Failed undoing a removal of a address qualifier  from database";
-                }
-                if (fTokenIndex & !dirty) {
-                    if (!prestricteddb->WriteQualifierAddress(undoQualifierAddress.address, undoQualifierAddress.tokenName))
-                    {
-                        dirty = true;
-                        message = "_Failed undoing a removal of a qualifier address from database";
-                    }
+                prestricteddb->WriteAddressQualifier(restrictedBatch, undoQualifierAddress.address, undoQualifierAddress.tokenName);
+                if (fTokenIndex) {
+                    prestricteddb->WriteQualifierAddress(restrictedBatch, undoQualifierAddress.address, undoQualifierAddress.tokenName);
                 }
             } else if (undoQualifierAddress.type == QualifierType::ADD_QUALIFIER) { // If we are undoing an addition, we remove the data from the database
                 ptokensQualifierCache->Erase(undoQualifierAddress.GetHash().GetHex());
-                if (!prestricteddb->EraseAddressQualifier(undoQualifierAddress.address, undoQualifierAddress.tokenName))
-                {
-                    dirty = true;
-                    message = "_Failed undoing a addition of a address qualifier to database";
-                }
-                if (fTokenIndex && !dirty) {
-                    if (!prestricteddb->EraseQualifierAddress(undoQualifierAddress.address,
-                                                              undoQualifierAddress.tokenName)) {
-                        dirty = true;
-                        message = "_Failed undoing a addition of a qualifier address from database";
-                    }
+                prestricteddb->EraseAddressQualifier(restrictedBatch, undoQualifierAddress.address, undoQualifierAddress.tokenName);
+                if (fTokenIndex) {
+                    prestricteddb->EraseQualifierAddress(restrictedBatch, undoQualifierAddress.address, undoQualifierAddress.tokenName);
                 }
             }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
         }
 
         // Add new restricted address commands
         for (auto newRestrictedAddress : setNewRestrictedAddressToAdd) {
             if (newRestrictedAddress.type == RestrictedType::UNFREEZE_ADDRESS) {
                 ptokensRestrictionCache->Erase(newRestrictedAddress.GetHash().GetHex());
-                if (!prestricteddb->EraseRestrictedAddress(newRestrictedAddress.address, newRestrictedAddress.tokenName)) {
-                    dirty = true;
-                    message = "_Failed Erasing restricted address from database";
-                }
-            } else if (newRestrictedAddress.type == RestrictedType::FREEZE_ADDRESS) {
-                ptokensRestrictionCache->Put(newRestrictedAddress.GetHash().GetHex(), 1);
-                if (!prestricteddb->WriteRestrictedAddress(newRestrictedAddress.address, newRestrictedAddress.tokenName))
-                {
-                    dirty = true;
-                    message = "_Failed Writing restricted address to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                prestricteddb->EraseRestrictedAddress(restrictedBatch, newRestrictedAddress.address, newRestrictedAddress.tokenName);
+            } else if (newRestrictedAddress.type == RestrictedType::FREEZE_ADDRESS) {
+                ptokensRestrictionCache->Put(newRestrictedAddress.GetHash().GetHex(), 1);
+                prestricteddb->WriteRestrictedAddress(restrictedBatch, newRestrictedAddress.address, newRestrictedAddress.tokenName);
             }
         }
 
@@ -2815,21 +2885,10 @@ bool CTokensCache::DumpCacheToDatabase()
         for (auto undoRestrictedAddress : setNewRestrictedAddressToRemove) {
             if (undoRestrictedAddress.type == RestrictedType::UNFREEZE_ADDRESS) { // If we are undoing an unfreeze, we need to freeze the address
                 ptokensRestrictionCache->Put(undoRestrictedAddress.GetHash().GetHex(), 1);
-                if (!prestricteddb->WriteRestrictedAddress(undoRestrictedAddress.address, undoRestrictedAddress.tokenName)) {
-                    dirty = true;
-                    message = "_Failed undoing a removal of a restricted address from database";
-                }
+                prestricteddb->WriteRestrictedAddress(restrictedBatch, undoRestrictedAddress.address, undoRestrictedAddress.tokenName);
             } else if (undoRestrictedAddress.type == RestrictedType::FREEZE_ADDRESS) { // If we are undoing a freeze, we need to unfreeze the address
                 ptokensRestrictionCache->Erase(undoRestrictedAddress.GetHash().GetHex());
-                if (!prestricteddb->EraseRestrictedAddress(undoRestrictedAddress.address, undoRestrictedAddress.tokenName))
-                {
-                    dirty = true;
-                    message = "_Failed undoing a addition of a restricted address to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                prestricteddb->EraseRestrictedAddress(restrictedBatch, undoRestrictedAddress.address, undoRestrictedAddress.tokenName);
             }
         }
 
@@ -2837,21 +2896,10 @@ bool CTokensCache::DumpCacheToDatabase()
         for (auto newGlobalRestriction : setNewRestrictedGlobalToAdd) {
             if (newGlobalRestriction.type == RestrictedType::GLOBAL_UNFREEZE) {
                 ptokensGlobalRestrictionCache->Erase(newGlobalRestriction.tokenName);
-                if (!prestricteddb->EraseGlobalRestriction(newGlobalRestriction.tokenName)) {
-                    dirty = true;
-                    message = "_Failed Erasing global restriction from database";
-                }
+                prestricteddb->EraseGlobalRestriction(restrictedBatch, newGlobalRestriction.tokenName);
             } else if (newGlobalRestriction.type == RestrictedType::GLOBAL_FREEZE) {
                 ptokensGlobalRestrictionCache->Put(newGlobalRestriction.tokenName, 1);
-                if (!prestricteddb->WriteGlobalRestriction(newGlobalRestriction.tokenName))
-                {
-                    dirty = true;
-                    message = "_Failed Writing global restriction to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                prestricteddb->WriteGlobalRestriction(restrictedBatch, newGlobalRestriction.tokenName);
             }
         }
 
@@ -2859,21 +2907,10 @@ bool CTokensCache::DumpCacheToDatabase()
         for (auto undoGlobalRestriction : setNewRestrictedGlobalToRemove) {
             if (undoGlobalRestriction.type == RestrictedType::GLOBAL_UNFREEZE) { // If we are undoing an global unfreeze, we need to write a global freeze
                 ptokensGlobalRestrictionCache->Put(undoGlobalRestriction.tokenName, 1);
-                if (!prestricteddb->WriteGlobalRestriction(undoGlobalRestriction.tokenName)) {
-                    dirty = true;
-                    message = "_Failed undoing a global unfreeze of a restricted token from database";
-                }
+                prestricteddb->WriteGlobalRestriction(restrictedBatch, undoGlobalRestriction.tokenName);
             } else if (undoGlobalRestriction.type == RestrictedType::GLOBAL_FREEZE) { // If we are undoing a global freeze, erase the freeze from the database
                 ptokensGlobalRestrictionCache->Erase(undoGlobalRestriction.tokenName);
-                if (!prestricteddb->EraseGlobalRestriction(undoGlobalRestriction.tokenName))
-                {
-                    dirty = true;
-                    message = "_Failed undoing a global freeze of a restricted token to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                prestricteddb->EraseGlobalRestriction(restrictedBatch, undoGlobalRestriction.tokenName);
             }
         }
 
@@ -2882,64 +2919,45 @@ bool CTokensCache::DumpCacheToDatabase()
             for (auto undoSpend : vUndoTokenAmount) {
                 auto pair = std::make_pair(undoSpend.tokenName, undoSpend.address);
                 if (mapTokensAddressAmount.count(pair)) {
-                    if (!ptokensdb->WriteTokenAddressQuantity(undoSpend.tokenName, undoSpend.address,
-                                                              mapTokensAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing updated Address Quantity to database when undoing spends";
-                    }
-
-                    if (!ptokensdb->WriteAddressTokenQuantity(undoSpend.address, undoSpend.tokenName,
-                                                              mapTokensAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing Address Balance to database";
-                    }
-
-                    if (dirty) {
-                        return error("%s : %s", __func__, message);
-                    }
+                    ptokensdb->WriteTokenAddressQuantity(tokensBatch, undoSpend.tokenName, undoSpend.address, mapTokensAddressAmount.at(pair));
+                    ptokensdb->WriteAddressTokenQuantity(tokensBatch, undoSpend.address, undoSpend.tokenName, mapTokensAddressAmount.at(pair));
                 }
             }
 
-
             // Save the tokens that have been spent by erasing the quantity in the database
             for (auto spentToken : vSpentTokens) {
                 auto pair = make_pair(spentToken.tokenName, spentToken.address);
                 if (mapTokensAddressAmount.count(pair)) {
                     if (mapTokensAddressAmount.at(pair) == 0) {
-                        if (!ptokensdb->EraseTokenAddressQuantity(spentToken.tokenName, spentToken.address)) {
-                            dirty = true;
-                            message = "_Failed Erasing a Spent Token, from database";
-                        }
-
-                        if (!ptokensdb->EraseAddressTokenQuantity(spentToken.address, spentToken.tokenName)) {
-                            dirty = true;
-                            message = "_Failed Erasing a Spent Token from AddressToken database";
-                        }
-
-                        if (dirty) {
-                            return error("%s : %s", __func__, message);
-                        }
+                        ptokensdb->EraseTokenAddressQuantity(tokensBatch, spentToken.tokenName, spentToken.address);
+                        ptokensdb->EraseAddressTokenQuantity(tokensBatch, spentToken.address, spentToken.tokenName);
                     } else {
-                        if (!ptokensdb->WriteTokenAddressQuantity(spentToken.tokenName, spentToken.address,
-                                                                  mapTokensAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Erasing a Spent Token, from database";
-                        }
-
-                        if (!ptokensdb->WriteAddressTokenQuantity(spentToken.address, spentToken.tokenName,
-                                                                  mapTokensAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing Address Balance to database";
-                        }
-
-                        if (dirty) {
-                            return error("%s : %s", __func__, message);
-                        }
+                        ptokensdb->WriteTokenAddressQuantity(tokensBatch, spentToken.tokenName, spentToken.address, mapTokensAddressAmount.at(pair));
+                        ptokensdb->WriteAddressTokenQuantity(tokensBatch, spentToken.address, spentToken.tokenName, mapTokensAddressAmount.at(pair));
                     }
                 }
             }
         }
 
+        int64_t nTimeCollect = GetTimeMicros();
+
+        size_t nTokensBytes = 0;
+        size_t nRestrictedBytes = 0;
+        if (!ptokensdb->WriteTokensBatch(tokensBatch, hashBlock, nTokensBytes))
+            return error("%s : %s", __func__, "_Failed Writing the token changes to database");
+
+        if (!prestricteddb->WriteRestrictedBatch(restrictedBatch, hashBlock, nRestrictedBytes))
+            return error("%s : %s", __func__, "_Failed Writing the restricted token changes to database");
+
+        int64_t nTimeWrite = GetTimeMicros();
+        nTimeDumpTokens += nTimeWrite - nTimeStart;
+        nDumpTokensCount++;
+        nDumpTokensBytes += nTokensBytes + nRestrictedBytes;
+        LogPrint(BCLog::BENCH, "    - Dump token cache: %u token changes (%.2fkB), %u restricted changes (%.2fkB), collect %.2fms, write %.2fms [%.2fs, %.2fMB (%.2fms/flush)]\n",
+                 tokensBatch.Size(), nTokensBytes * 0.001, restrictedBatch.Size(), nRestrictedBytes * 0.001,
+                 (nTimeCollect - nTimeStart) * 0.001, (nTimeWrite - nTimeCollect) * 0.001,
+                 nTimeDumpTokens * 0.000001, nDumpTokensBytes * 0.000001, nTimeDumpTokens * 0.001 / nDumpTokensCount);
+
         ClearDirtyCache();
 
         return true;
@@ -2948,182 +2966,192 @@ bool CTokensCache::DumpCacheToDatabase()
     }
 }
 
-// This function will put all current cache data into the global ptokens cache.
+CTokensCache* CTokensCache::GetParent() const
+{
+    if (pparent)
+        return pparent;
+
+    // Caches created without a parent are views on the global cache
+    return this != ptokens ? ptokens : nullptr;
+}
+
+// This function will put all current cache data into the parent cache, the global ptokens cache unless another parent was given.
 //! Do not call this function on the ptokens pointer
 bool CTokensCache::Flush()
 {
 
-    if (!ptokens)
-        return error("%s: Couldn't find ptokens pointer while trying to flush tokens cache", __func__);
+    CTokensCache* parent = GetParent();
+    if (!parent)
+        return error("%s: Couldn't find the parent cache while trying to flush tokens cache", __func__);
 
     try {
         for (auto &item : setNewTokensToAdd) {
-            if (ptokens->setNewTokensToRemove.count(item))
-                ptokens->setNewTokensToRemove.erase(item);
-            ptokens->setNewTokensToAdd.insert(item);
+            if (parent->setNewTokensToRemove.count(item))
+                parent->setNewTokensToRemove.erase(item);
+            parent->setNewTokensToAdd.insert(item);
         }
 
         for (auto &item : setNewTokensToRemove) {
-            if (ptokens->setNewTokensToAdd.count(item))
-                ptokens->setNewTokensToAdd.erase(item);
-            ptokens->setNewTokensToRemove.insert(item);
+            if (parent->setNewTokensToAdd.count(item))
+                parent->setNewTokensToAdd.erase(item);
+            parent->setNewTokensToRemove.insert(item);
         }
 
         for (auto &item : mapTokensAddressAmount)
-            ptokens->mapTokensAddressAmount[item.first] = item.second;
+            parent->mapTokensAddressAmount[item.first] = item.second;
 
         for (auto &item : mapReissuedTokenData)
-            ptokens->mapReissuedTokenData[item.first] = item.second;
+            parent->mapReissuedTokenData.Set(item.first, item.second);
 
         for (auto &item : setNewOwnerTokensToAdd) {
-            if (ptokens->setNewOwnerTokensToRemove.count(item))
-                ptokens->setNewOwnerTokensToRemove.erase(item);
-            ptokens->setNewOwnerTokensToAdd.insert(item);
+            if (parent->setNewOwnerTokensToRemove.count(item))
+                parent->setNewOwnerTokensToRemove.erase(item);
+            parent->setNewOwnerTokensToAdd.insert(item);
         }
 
         for (auto &item : setNewOwnerTokensToRemove) {
-            if (ptokens->setNewOwnerTokensToAdd.count(item))
-                ptokens->setNewOwnerTokensToAdd.erase(item);
-            ptokens->setNewOwnerTokensToRemove.insert(item);
+            if (parent->setNewOwnerTokensToAdd.count(item))
+                parent->setNewOwnerTokensToAdd.erase(item);
+            parent->setNewOwnerTokensToRemove.insert(item);
         }
 
         for (auto &item : setNewReissueToAdd) {
-            if (ptokens->setNewReissueToRemove.count(item))
-                ptokens->setNewReissueToRemove.erase(item);
-            ptokens->setNewReissueToAdd.insert(item);
+            if (parent->setNewReissueToRemove.count(item))
+                parent->setNewReissueToRemove.erase(item);
+            parent->setNewReissueToAdd.insert(item);
         }
 
         for (auto &item : setNewReissueToRemove) {
-            if (ptokens->setNewReissueToAdd.count(item))
-                ptokens->setNewReissueToAdd.erase(item);
-            ptokens->setNewReissueToRemove.insert(item);
+            if (parent->setNewReissueToAdd.count(item))
+                parent->setNewReissueToAdd.erase(item);
+            parent->setNewReissueToRemove.insert(item);
         }
 
         for (auto &item : setNewTransferTokensToAdd) {
-            if (ptokens->setNewTransferTokensToRemove.count(item))
-                ptokens->setNewTransferTokensToRemove.erase(item);
-            ptokens->setNewTransferTokensToAdd.insert(item);
+            if (parent->setNewTransferTokensToRemove.count(item))
+                parent->setNewTransferTokensToRemove.erase(item);
+            parent->setNewTransferTokensToAdd.insert(item);
         }
 
         for (auto &item : setNewTransferTokensToRemove) {
-            if (ptokens->setNewTransferTokensToAdd.count(item))
-                ptokens->setNewTransferTokensToAdd.erase(item);
-            ptokens->setNewTransferTokensToRemove.insert(item);
+            if (parent->setNewTransferTokensToAdd.count(item))
+                parent->setNewTransferTokensToAdd.erase(item);
+            parent->setNewTransferTokensToRemove.insert(item);
         }
 
         for (auto &item : vSpentTokens) {
-            ptokens->vSpentTokens.emplace_back(item);
+            parent->vSpentTokens.emplace_back(item);
         }
 
         for (auto &item : vUndoTokenAmount) {
-            ptokens->vUndoTokenAmount.emplace_back(item);
+            parent->vUndoTokenAmount.emplace_back(item);
         }
 
         for(auto &item : setNewQualifierAddressToAdd) {
-            if (ptokens->setNewQualifierAddressToRemove.count(item)) {
-                ptokens->setNewQualifierAddressToRemove.erase(item);
+            if (parent->setNewQualifierAddressToRemove.count(item)) {
+                parent->setNewQualifierAddressToRemove.erase(item);
             }
 
-            if (ptokens->setNewQualifierAddressToAdd.count(item)) {
-                ptokens->setNewQualifierAddressToAdd.erase(item);
+            if (parent->setNewQualifierAddressToAdd.count(item)) {
+                parent->setNewQualifierAddressToAdd.erase(item);
             }
 
-            ptokens->setNewQualifierAddressToAdd.insert(item);
+            parent->setNewQualifierAddressToAdd.insert(item);
         }
 
         for(auto &item : setNewQualifierAddressToRemove) {
-            if (ptokens->setNewQualifierAddressToAdd.count(item)) {
-                ptokens->setNewQualifierAddressToAdd.erase(item);
+            if (parent->setNewQualifierAddressToAdd.count(item)) {
+                parent->setNewQualifierAddressToAdd.erase(item);
             }
 
-            if (ptokens->setNewQualifierAddressToRemove.count(item)) {
-                ptokens->setNewQualifierAddressToRemove.erase(item);
+            if (parent->setNewQualifierAddressToRemove.count(item)) {
+                parent->setNewQualifierAddressToRemove.erase(item);
             }
 
-            ptokens->setNewQualifierAddressToRemove.insert(item);
+            parent->setNewQualifierAddressToRemove.insert(item);
         }
 
         for(auto &item : setNewRestrictedAddressToAdd) {
-            if (ptokens->setNewRestrictedAddressToRemove.count(item)) {
-                ptokens->setNewRestrictedAddressToRemove.erase(item);
+            if (parent->setNewRestrictedAddressToRemove.count(item)) {
+                parent->setNewRestrictedAddressToRemove.erase(item);
             }
 
-            if (ptokens->setNewRestrictedAddressToAdd.count(item)) {
-                ptokens->setNewRestrictedAddressToAdd.erase(item);
+            if (parent->setNewRestrictedAddressToAdd.count(item)) {
+                parent->setNewRestrictedAddressToAdd.erase(item);
             }
 
-            ptokens->setNewRestrictedAddressToAdd.insert(item);
+            parent->setNewRestrictedAddressToAdd.insert(item);
         }
 
         for(auto &item : setNewRestrictedAddressToRemove) {
-            if (ptokens->setNewRestrictedAddressToAdd.count(item)) {
-                ptokens->setNewRestrictedAddressToAdd.erase(item);
+            if (parent->setNewRestrictedAddressToAdd.count(item)) {
+                parent->setNewRestrictedAddressToAdd.erase(item);
             }
 
-            if (ptokens->setNewRestrictedAddressToRemove.count(item)) {
-                ptokens->setNewRestrictedAddressToRemove.erase(item);
+            if (parent->setNewRestrictedAddressToRemove.count(item)) {
+                parent->setNewRestrictedAddressToRemove.erase(item);
             }
 
-            ptokens->setNewRestrictedAddressToRemove.insert(item);
+            parent->setNewRestrictedAddressToRemove.insert(item);
         }
 
         for(auto &item : setNewRestrictedGlobalToAdd) {
-            if (ptokens->setNewRestrictedGlobalToRemove.count(item)) {
-                ptokens->setNewRestrictedGlobalToRemove.erase(item);
+            if (parent->setNewRestrictedGlobalToRemove.count(item)) {
+                parent->setNewRestrictedGlobalToRemove.erase(item);
             }
 
-            if (ptokens->setNewRestrictedGlobalToAdd.count(item)) {
-                ptokens->setNewRestrictedGlobalToAdd.erase(item);
+            if (parent->setNewRestrictedGlobalToAdd.count(item)) {
+                parent->setNewRestrictedGlobalToAdd.erase(item);
             }
 
-            ptokens->setNewRestrictedGlobalToAdd.insert(item);
+            parent->setNewRestrictedGlobalToAdd.insert(item);
         }
 
         for(auto &item : setNewRestrictedGlobalToRemove) {
-            if (ptokens->setNewRestrictedGlobalToAdd.count(item)) {
-                ptokens->setNewRestrictedGlobalToAdd.erase(item);
+            if (parent->setNewRestrictedGlobalToAdd.count(item)) {
+                parent->setNewRestrictedGlobalToAdd.erase(item);
             }
 
-            if (ptokens->setNewRestrictedGlobalToRemove.count(item)) {
-                ptokens->setNewRestrictedGlobalToRemove.erase(item);
+            if (parent->setNewRestrictedGlobalToRemove.count(item)) {
+                parent->setNewRestrictedGlobalToRemove.erase(item);
             }
 
-            ptokens->setNewRestrictedGlobalToRemove.insert(item);
+            parent->setNewRestrictedGlobalToRemove.insert(item);
         }
 
         for (auto &item : setNewRestrictedVerifierToAdd) {
-            if (ptokens->setNewRestrictedVerifierToRemove.count(item)) {
-                ptokens->setNewRestrictedVerifierToRemove.erase(item);
+            if (parent->setNewRestrictedVerifierToRemove.count(item)) {
+                parent->setNewRestrictedVerifierToRemove.erase(item);
             }
 
-            if (ptokens->setNewRestrictedVerifierToAdd.count(item)) {
-                ptokens->setNewRestrictedVerifierToAdd.erase(item);
+            if (parent->setNewRestrictedVerifierToAdd.count(item)) {
+                parent->setNewRestrictedVerifierToAdd.erase(item);
             }
 
-            ptokens->setNewRestrictedVerifierToAdd.insert(item);
+            parent->setNewRestrictedVerifierToAdd.insert(item);
         }
 
         for (auto &item : setNewRestrictedVerifierToRemove) {
-            if (ptokens->setNewRestrictedVerifierToAdd.count(item)) {
-                ptokens->setNewRestrictedVerifierToAdd.erase(item);
+            if (parent->setNewRestrictedVerifierToAdd.count(item)) {
+                parent->setNewRestrictedVerifierToAdd.erase(item);
             }
 
-            if (ptokens->setNewRestrictedVerifierToRemove.count(item)) {
-                ptokens->setNewRestrictedVerifierToRemove.erase(item);
+            if (parent->setNewRestrictedVerifierToRemove.count(item)) {
+                parent->setNewRestrictedVerifierToRemove.erase(item);
             }
 
-            ptokens->setNewRestrictedVerifierToRemove.insert(item);
+            parent->setNewRestrictedVerifierToRemove.insert(item);
         }
 
         for (auto &item : mapRootQualifierAddressesAdd) {
             for (auto token : item.second) {
-                ptokens->mapRootQualifierAddressesAdd[item.first].insert(token);
+                parent->mapRootQualifierAddressesAdd.Modify(item.first, [&token](std::set<std::string>& tokens) { tokens.insert(token); });
             }
         }
 
         for (auto &item : mapRootQualifierAddressesRemove) {
             for (auto token : item.second) {
-                ptokens->mapRootQualifierAddressesAdd[item.first].insert(token);
+                parent->mapRootQualifierAddressesAdd.Modify(item.first, [&token](std::set<std::string>& tokens) { tokens.insert(token); });
             }
         }
 
@@ -3134,75 +3162,55 @@ bool CTokensCache::Flush()
     }
 }
 
-//! Get the amount of memory the cache is using
+//! Get the amount of memory the cache is using, the balances and reissue data plus the dirty entries
 size_t CTokensCache::DynamicMemoryUsage() const
 {
-    // TODO make sure this is accurate
-    return memusage::DynamicUsage(mapTokensAddressAmount) + memusage::DynamicUsage(mapReissuedTokenData);
+    return mapTokensAddressAmount.DynamicMemoryUsage() + mapReissuedTokenData.DynamicMemoryUsage() +
+           mapAddressQualifiers.DynamicMemoryUsage() + GetCacheSize();
 }
 
-//! Get an estimated size of the cache in bytes that will be needed inorder to save to database
+//! Get the amount of memory used by the entries that will be written to the database when flushed
 size_t CTokensCache::GetCacheSize() const
 {
-    // COutPoint: 32 bytes
-    // CNewToken: Max 80 bytes
-    // CTokenTransfer: Token Name, CAmount ( 40 bytes)
-    // CReissueToken: Max 80 bytes
-    // CAmount: 8 bytes
-    // Token Name: Max 32 bytes
-    // Address: 40 bytes
-    // Block hash: 32 bytes
-    // CTxOut: CAmount + CScript (105 + 8 = 113 bytes)
-
     size_t size = 0;
-
-    size += (32 + 40 + 8) * vUndoTokenAmount.size(); // Token Name, Address, CAmount
-
-    size += (40 + 40 + 32) * setNewTransferTokensToRemove.size(); // CTokenTrasnfer, Address, COutPoint
-    size += (40 + 40 + 32) * setNewTransferTokensToAdd.size(); // CTokenTrasnfer, Address, COutPoint
-
-    size += 72 * setNewOwnerTokensToAdd.size(); // Token Name, Address
-    size += 72 * setNewOwnerTokensToRemove.size(); // Token Name, Address
-
-    size += (32 + 40 + 8) * vSpentTokens.size(); // Token Name, Address, CAmount
-
-    size += (80 + 40 + 32 + sizeof(int)) * setNewTokensToAdd.size(); // CNewToken, Address, Block hash, int
-    size += (80 + 40 + 32 + sizeof(int)) * setNewTokensToRemove.size(); // CNewToken, Address, Block hash, int
-
-    size += (80 + 40 + 32 + 32 + sizeof(int)) * setNewReissueToAdd.size(); // CReissueToken, Address, COutPoint, Block hash, int
-    size += (80 + 40 + 32 + 32 + sizeof(int)) * setNewReissueToRemove.size(); // CReissueToken, Address, COutPoint, Block hash, int
-
-    // TODO add the qualfier, and restricted sets into this calculation
+    size += vUndoTokenAmount.DynamicMemoryUsage();
+    size += vSpentTokens.DynamicMemoryUsage();
+    size += setNewTokensToRemove.DynamicMemoryUsage();
+    size += setNewTokensToAdd.DynamicMemoryUsage();
+    size += setNewReissueToRemove.DynamicMemoryUsage();
+    size += setNewReissueToAdd.DynamicMemoryUsage();
+    size += setNewOwnerTokensToAdd.DynamicMemoryUsage();
+    size += setNewOwnerTokensToRemove.DynamicMemoryUsage();
+    size += setNewTransferTokensToAdd.DynamicMemoryUsage();
+    size += setNewTransferTokensToRemove.DynamicMemoryUsage();
+    size += setNewQualifierAddressToAdd.DynamicMemoryUsage();
+    size += setNewQualifierAddressToRemove.DynamicMemoryUsage();
+    size += setNewRestrictedAddressToAdd.DynamicMemoryUsage();
+    size += setNewRestrictedAddressToRemove.DynamicMemoryUsage();
+    size += setNewRestrictedGlobalToAdd.DynamicMemoryUsage();
+    size += setNewRestrictedGlobalToRemove.DynamicMemoryUsage();
+    size += setNewRestrictedVerifierToAdd.DynamicMemoryUsage();
+    size += setNewRestrictedVerifierToRemove.DynamicMemoryUsage();
+    size += mapRootQualifierAddressesAdd.DynamicMemoryUsage();
+    size += mapRootQualifierAddressesRemove.DynamicMemoryUsage();
 
     return size;
 }
 
-//! Get an estimated size of the cache in bytes that will be needed inorder to save to database
-size_t CTokensCache::GetCacheSizeV2() const
+size_t GetTokenLRUCachesUsage()
 {
-    // COutPoint: 32 bytes
-    // CNewToken: Max 80 bytes
-    // CTokenTransfer: Token Name, CAmount ( 40 bytes)
-    // CReissueToken: Max 80 bytes
-    // CAmount: 8 bytes
-    // Token Name: Max 32 bytes
-    // Address: 40 bytes
-    // Block hash: 32 bytes
-    // CTxOut: CAmount + CScript (105 + 8 = 113 bytes)
-
-    size_t size = 0;
-    size += memusage::DynamicUsage(vUndoTokenAmount);
-    size += memusage::DynamicUsage(setNewTransferTokensToRemove);
-    size += memusage::DynamicUsage(setNewTransferTokensToAdd);
-    size += memusage::DynamicUsage(setNewOwnerTokensToAdd);
-    size += memusage::DynamicUsage(setNewOwnerTokensToRemove);
-    size += memusage::DynamicUsage(vSpentTokens);
-    size += memusage::DynamicUsage(setNewTokensToAdd);
-    size += memusage::DynamicUsage(setNewTokensToRemove);
-    size += memusage::DynamicUsage(setNewReissueToAdd);
-    size += memusage::DynamicUsage(setNewReissueToRemove);
-
-    return size;
+    size_t usage = 0;
+    if (ptokensCache)
+        usage += ptokensCache->DynamicMemoryUsage();
+    if (ptokensVerifierCache)
+        usage += ptokensVerifierCache->DynamicMemoryUsage();
+    if (ptokensQualifierCache)
+        usage += ptokensQualifierCache->DynamicMemoryUsage();
+    if (ptokensRestrictionCache)
+        usage += ptokensRestrictionCache->DynamicMemoryUsage();
+    if (ptokensGlobalRestrictionCache)
+        usage += ptokensGlobalRestrictionCache->DynamicMemoryUsage();
+    return usage;
 }
 
 bool CheckIssueBurnTx(const CTxOut& txOut, const KnownTokenType& type, const int numberIssued)
@@ -3333,7 +3341,7 @@ bool IsScriptNewUniqueToken(const CScript &scriptPubKey, int &nStartingIndex)
         return false;
 
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!TokenFromScript(scriptPubKey, token, address))
         return false;
 
@@ -3359,7 +3367,7 @@ bool IsScriptNewMsgChannelToken(const CScript &scriptPubKey, int &nStartingIndex
         return false;
 
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!TokenFromScript(scriptPubKey, token, address))
         return false;
 
@@ -3385,7 +3393,7 @@ bool IsScriptNewUsername(const CScript& scriptPubKey, int& nStartingIndex)
         return false;
 
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!TokenFromScript(scriptPubKey, token, address))
         return false;
 
@@ -3466,7 +3474,7 @@ bool IsScriptNewQualifierToken(const CScript &scriptPubKey, int &nStartingIndex)
         return false;
 
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!TokenFromScript(scriptPubKey, token, address))
         return false;
 
@@ -3492,7 +3500,7 @@ bool IsScriptNewRestrictedToken(const CScript &scriptPubKey, int &nStartingIndex
         return false;
 
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     if (!TokenFromScript(scriptPubKey, token, address))
         return false;
 
@@ -3515,33 +3523,23 @@ bool CTokensCache::CheckIfTokenExists(const std::string& name, bool fForceDuplic
     // Create objects that will be used to check the dirty cache
     CNewToken token;
     token.strName = name;
-    CTokenCacheNewToken cachedToken(token, "", 0, uint256());
-
-    // Check the dirty caches first and see if it was recently added or removed
-    if (setNewTokensToRemove.count(cachedToken)) {
-        return false;
-    }
-
-    // Check the dirty caches first and see if it was recently added or removed
-    if (ptokens->setNewTokensToRemove.count(cachedToken)) {
-        return false;
-    }
+    CTokenCacheNewToken cachedToken(token, CTokenAddress(), 0, uint256());
 
-    if (setNewTokensToAdd.count(cachedToken)) {
-        if (fForceDuplicateCheck) {
-            return true;
-        }
-        else {
-            LogPrintf("%s : Found token %s in setNewTokensToAdd but force duplicate check wasn't true\n", __func__, name);
+    // Check the dirty caches first and see if it was recently added or removed. The nearest view that added or
+    // removed the token decides, like the nearest CCoinsViewCache holding a coin.
+    for (const CTokensCache* view = this; view; view = view->GetParent()) {
+        if (view->setNewTokensToRemove.count(cachedToken)) {
+            return false;
         }
-    }
 
-    if (ptokens->setNewTokensToAdd.count(cachedToken)) {
-        if (fForceDuplicateCheck) {
-            return true;
-        }
-        else {
-            LogPrintf("%s : Found token %s in setNewTokensToAdd but force duplicate check wasn't true\n", __func__, name);
+        if (view->setNewTokensToAdd.count(cachedToken)) {
+            if (fForceDuplicateCheck) {
+                return true;
+            }
+            else {
+                LogPrintf("%s : Found token %s in setNewTokensToAdd but force duplicate check wasn't true\n", __func__, name);
+            }
+            break;
         }
     }
 
@@ -3583,56 +3581,38 @@ bool CTokensCache::GetTokenMetaDataIfExists(const std::string &name, CNewToken &
 
 bool CTokensCache::GetTokenMetaDataIfExists(const std::string &name, CNewToken &token, int& nHeight, uint256& blockHash)
 {
-    // Check the map that contains the reissued token data. If it is in this map, it hasn't been saved to disk yet
-    if (mapReissuedTokenData.count(name)) {
-        token = mapReissuedTokenData.at(name);
-        return true;
-    }
-
-    // Check the map that contains the reissued token data. If it is in this map, it hasn't been saved to disk yet
-    if (ptokens->mapReissuedTokenData.count(name)) {
-        token = ptokens->mapReissuedTokenData.at(name);
-        return true;
-    }
-
     // Create objects that will be used to check the dirty cache
     CNewToken tempToken;
     tempToken.strName = name;
-    CTokenCacheNewToken cachedToken(tempToken, "", 0, uint256());
-
-    // Check the dirty caches first and see if it was recently added or removed
-    if (setNewTokensToRemove.count(cachedToken)) {
-        LogPrintf("%s : Found in new tokens to Remove - Returning False\n", __func__);
-        return false;
-    }
-
-    // Check the dirty caches first and see if it was recently added or removed
-    if (ptokens->setNewTokensToRemove.count(cachedToken)) {
-        LogPrintf("%s : Found in new tokens to Remove - Returning False\n", __func__);
-        return false;
-    }
+    CTokenCacheNewToken cachedToken(tempToken, CTokenAddress(), 0, uint256());
+
+    // Check the dirty caches first, the nearest view that reissued, added or removed the token decides
+    for (const CTokensCache* view = this; view; view = view->GetParent()) {
+        // Check the map that contains the reissued token data. If it is in this map, it hasn't been saved to disk yet
+        auto mapIterator = view->mapReissuedTokenData.find(name);
+        if (mapIterator != view->mapReissuedTokenData.end()) {
+            token = mapIterator->second;
+            return true;
+        }
 
-    auto setIterator = setNewTokensToAdd.find(cachedToken);
-    if (setIterator != setNewTokensToAdd.end()) {
-        token = setIterator->token;
-        nHeight = setIterator->blockHeight;
-        blockHash = setIterator->blockHash;
-        return true;
-    }
+        if (view->setNewTokensToRemove.count(cachedToken)) {
+            LogPrintf("%s : Found in new tokens to Remove - Returning False\n", __func__);
+            return false;
+        }
 
-    setIterator = ptokens->setNewTokensToAdd.find(cachedToken);
-    if (setIterator != ptokens->setNewTokensToAdd.end()) {
-        token = setIterator->token;
-        nHeight = setIterator->blockHeight;
-        blockHash = setIterator->blockHash;
-        return true;
+        auto setIterator = view->setNewTokensToAdd.find(cachedToken);
+        if (setIterator != view->setNewTokensToAdd.end()) {
+            token = setIterator->token;
+            nHeight = setIterator->blockHeight;
+            blockHash = setIterator->blockHash;
+            return true;
+        }
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (ptokensCache) {
-        if (ptokensCache->Exists(name)) {
-            CDatabasedTokenData data;
-            data = ptokensCache->Get(name);
+        CDatabasedTokenData data;
+        if (ptokensCache->TryGet(name, data)) {
             token = data.token;
             nHeight = data.nHeight;
             blockHash = data.blockHash;
@@ -3657,6 +3637,117 @@ bool CTokensCache::GetTokenMetaDataIfExists(const std::string &name, CNewToken &
     return false;
 }
 
+//! Replaced, never modified, once published
+static std::shared_ptr<const CTokenMetaDataSnapshot> ptokenMetaDataSnapshot;
+
+//! Deltas stacked on a snapshot published in full before it is published in full again
+static const int MAX_TOKEN_META_DATA_SNAPSHOT_DEPTH = 16;
+
+//! Set while the blocks connected or disconnected since the published snapshot weren't published
+static std::atomic<bool> fTokenMetaDataSnapshotBehind{false};
+
+static void AddTokenMetaDataChanges(const CTokensCache& cache, CTokenMetaDataSnapshot& snapshot)
+{
+    // Same precedence as GetTokenMetaDataIfExists: reissued data, then removed tokens, then new tokens
+    for (const auto& newToken : cache.setNewTokensToAdd)
+        snapshot.mapTokens[newToken.token.strName] = CDatabasedTokenData(newToken.token, newToken.blockHeight, newToken.blockHash);
+
+    for (const auto& newToken : cache.setNewTokensToRemove) {
+        snapshot.mapTokens.erase(newToken.token.strName);
+        snapshot.setRemoved.insert(newToken.token.strName);
+    }
+
+    for (const auto& newReissue : cache.setNewReissueToAdd) {
+        auto it = cache.mapReissuedTokenData.find(newReissue.reissue.strName);
+        if (it != cache.mapReissuedTokenData.end()) {
+            snapshot.mapTokens[it->first] = CDatabasedTokenData(it->second, newReissue.blockHeight, newReissue.blockHash);
+            snapshot.setRemoved.erase(it->first);
+        }
+    }
+
+    // Like Flush, undoing the reissue of a token that is removed as well leaves it removed
+    for (const auto& undoReissue : cache.setNewReissueToRemove) {
+        auto it = cache.mapReissuedTokenData.find(undoReissue.reissue.strName);
+        if (it != cache.mapReissuedTokenData.end() && !snapshot.setRemoved.count(it->first))
+            snapshot.mapTokens[it->first] = CDatabasedTokenData(it->second, undoReissue.blockHeight, undoReissue.blockHash);
+    }
+}
+
+void PublishTokenMetaDataSnapshot(const uint256& hashBlock)
+{
+    AssertLockHeld(cs_main);
+
+    std::shared_ptr<CTokenMetaDataSnapshot> snapshot = std::make_shared<CTokenMetaDataSnapshot>();
+    snapshot->hashBlock = hashBlock;
+    if (ptokens)
+        AddTokenMetaDataChanges(*ptokens, *snapshot);
+
+    std::atomic_store(&ptokenMetaDataSnapshot, std::shared_ptr<const CTokenMetaDataSnapshot>(std::move(snapshot)));
+    fTokenMetaDataSnapshotBehind = false;
+}
+
+void SkipTokenMetaDataChanges()
+{
+    fTokenMetaDataSnapshotBehind = true;
+}
+
+bool IsTokenMetaDataSnapshotBehind()
+{
+    return fTokenMetaDataSnapshotBehind;
+}
+
+void PublishTokenMetaDataChanges(const CTokensCache& blockCache, const uint256& hashPrevBlock, const uint256& hashBlock)
+{
+    AssertLockHeld(cs_main);
+
+    std::shared_ptr<const CTokenMetaDataSnapshot> prev = std::atomic_load(&ptokenMetaDataSnapshot);
+
+    // Snapshots missed blocks during the initial block download, and a long stack of them slows the readers down, a
+    // full one has all ptokens holds since it was written to the database
+    if (!prev || prev->hashBlock != hashPrevBlock || prev->nDepth >= MAX_TOKEN_META_DATA_SNAPSHOT_DEPTH) {
+        PublishTokenMetaDataSnapshot(hashBlock);
+        return;
+    }
+
+    std::shared_ptr<CTokenMetaDataSnapshot> snapshot = std::make_shared<CTokenMetaDataSnapshot>();
+    AddTokenMetaDataChanges(blockCache, *snapshot);
+    snapshot->pprev = prev;
+    snapshot->nDepth = prev->nDepth + 1;
+    snapshot->hashBlock = hashBlock;
+
+    std::atomic_store(&ptokenMetaDataSnapshot, std::shared_ptr<const CTokenMetaDataSnapshot>(std::move(snapshot)));
+}
+
+bool GetTokenMetaDataFromSnapshot(const std::string& name, CDatabasedTokenData& data)
+{
+    // A snapshot is only replaced by one still holding its changes or once they are in the database, so a name it
+    // doesn't hold can be read from there, at worst finding data newer than the snapshot
+    std::shared_ptr<const CTokenMetaDataSnapshot> snapshot = std::atomic_load(&ptokenMetaDataSnapshot);
+    for (const CTokenMetaDataSnapshot* layer = snapshot.get(); layer; layer = layer->pprev.get()) {
+        auto it = layer->mapTokens.find(name);
+        if (it != layer->mapTokens.end()) {
+            data = it->second;
+            return true;
+        }
+
+        if (layer->setRemoved.count(name))
+            return false;
+    }
+
+    if (ptokensCache && ptokensCache->TryGet(name, data))
+        return true;
+
+    CNewToken token;
+    int nHeight;
+    uint256 blockHash;
+    if (ptokensdb && ptokensdb->ReadTokenData(name, token, nHeight, blockHash)) {
+        data = CDatabasedTokenData(token, nHeight, blockHash);
+        return true;
+    }
+
+    return false;
+}
+
 bool GetTokenInfoFromScript(const CScript& scriptPubKey, std::string& strName, CAmount& nAmount, uint32_t& nTimeLock)
 {
     CTokenOutputEntry data;
@@ -3677,8 +3768,8 @@ bool GetTokenInfoFromCoin(const Coin& coin, std::string& strName, CAmount& nAmou
 
 bool GetTokenData(const CScript& script, CTokenOutputEntry& data)
 {
-    // Placeholder strings that will get set if you successfully get the transfer or token from the script
-    std::string address = "";
+    // Placeholders that will get set if you successfully get the transfer or token from the script
+    CTokenAddress address;
     std::string tokenName = "";
 
     int nType = 0;
@@ -3700,23 +3791,27 @@ bool GetTokenData(const CScript& script, CTokenOutputEntry& data)
         if (TokenFromScript(script, token, address)) {
             data.type = TX_NEW_TOKEN;
             data.nAmount = token.nAmount;
-            data.destination = DecodeDestination(address);
+            data.address = address;
+            data.destination = address.Get();
             data.tokenName = token.strName;
             return true;
         } else if (MsgChannelTokenFromScript(script, token, address)) {
             data.type = TX_NEW_TOKEN;
             data.nAmount = token.nAmount;
-            data.destination = DecodeDestination(address);
+            data.address = address;
+            data.destination = address.Get();
             data.tokenName = token.strName;
         } else if (QualifierTokenFromScript(script, token, address)) {
             data.type = TX_NEW_TOKEN;
             data.nAmount = token.nAmount;
-            data.destination = DecodeDestination(address);
+            data.address = address;
+            data.destination = address.Get();
             data.tokenName = token.strName;
         } else if (RestrictedTokenFromScript(script, token, address)) {
             data.type = TX_NEW_TOKEN;
             data.nAmount = token.nAmount;
-            data.destination = DecodeDestination(address);
+            data.address = address;
+            data.destination = address.Get();
             data.tokenName = token.strName;
         }
     } else if (type == TX_TRANSFER_TOKEN) {
@@ -3724,7 +3819,8 @@ bool GetTokenData(const CScript& script, CTokenOutputEntry& data)
         if (TransferTokenFromScript(script, transfer, address)) {
             data.type = TX_TRANSFER_TOKEN;
             data.nAmount = transfer.nAmount;
-            data.destination = DecodeDestination(address);
+            data.address = address;
+            data.destination = address.Get();
             data.tokenName = transfer.strName;
             data.nTimeLock = transfer.nTimeLock;
             data.message = transfer.message;
@@ -3739,7 +3835,8 @@ bool GetTokenData(const CScript& script, CTokenOutputEntry& data)
         if (OwnerTokenFromScript(script, tokenName, address)) {
             data.type = TX_NEW_TOKEN;
             data.nAmount = OWNER_TOKEN_AMOUNT;
-            data.destination = DecodeDestination(address);
+            data.address = address;
+            data.destination = address.Get();
             data.tokenName = tokenName;
             return true;
         }
@@ -3750,7 +3847,8 @@ bool GetTokenData(const CScript& script, CTokenOutputEntry& data)
         if (ReissueTokenFromScript(script, reissue, address)) {
             data.type = TX_REISSUE_TOKEN;
             data.nAmount = reissue.nAmount;
-            data.destination = DecodeDestination(address);
+            data.address = address;
+            data.destination = address.Get();
             data.tokenName = reissue.strName;
             return true;
         }
@@ -3793,52 +3891,52 @@ void GetAllMyTokens(CWallet* pwallet, std::vector<std::string>& names, int nMinC
 
 CAmount GetIssueTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_ROOT);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_ROOT);
 }
 
 CAmount GetReissueTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_REISSUE);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_REISSUE);
 }
 
 CAmount GetIssueSubTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_SUB);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_SUB);
 }
 
 CAmount GetIssueUniqueTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_UNIQUE);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_UNIQUE);
 }
 
 CAmount GetIssueUsernameTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_USERNAME);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_USERNAME);
 }
 
 CAmount GetIssueMsgChannelTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_MSG_CHANNEL);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_MSG_CHANNEL);
 }
 
 CAmount GetIssueQualifierTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_QUALIFIER);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_QUALIFIER);
 }
 
 CAmount GetIssueSubQualifierTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_SUB_QUALIFIER);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_SUB_QUALIFIER);
 }
 
 CAmount GetIssueRestrictedTokenFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_RESTRICTED);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_RESTRICTED);
 }
 
 CAmount GetAddNullQualifierTagFeeAmount()
 {
-    return governance->GetCost(GOVERNANCE_COST_NULL_QUALIFIER);
+    return pgovernanceTip->GetCost(GOVERNANCE_COST_NULL_QUALIFIER);
 }
 
 CAmount GetBurnAmount(const int nType)
@@ -3916,7 +4014,7 @@ std::string GetBurnAddress(const KnownTokenType type)
 }
 
 //! This will get the amount that an address for a certain token contains from the database if they cache doesn't already have it
-bool GetBestTokenAddressAmount(CTokensCache& cache, const std::string& tokenName, const std::string& address)
+bool GetBestTokenAddressAmount(CTokensCache& cache, const std::string& tokenName, const CTokenAddress& address)
 {
     if (fTokenIndex) {
         auto pair = make_pair(tokenName, address);
@@ -3925,10 +4023,12 @@ bool GetBestTokenAddressAmount(CTokensCache& cache, const std::string& tokenName
         if (cache.mapTokensAddressAmount.count(pair))
             return true;
 
-        // If the caches map has the pair, return true because the map already contains the best dirty amount
-        if (ptokens->mapTokensAddressAmount.count(pair)) {
-            cache.mapTokensAddressAmount[pair] = ptokens->mapTokensAddressAmount.at(pair);
-            return true;
+        // If a view below the cache has the pair, copy the best dirty amount up into the cache
+        for (const CTokensCache* view = cache.GetParent(); view; view = view->GetParent()) {
+            if (view->mapTokensAddressAmount.count(pair)) {
+                cache.mapTokensAddressAmount[pair] = view->mapTokensAddressAmount.at(pair);
+                return true;
+            }
         }
 
         // If the database contains the tokens address amount, insert it into the database and return true
@@ -4366,14 +4466,14 @@ bool CreateReissueTokenTransaction(CWallet* pwallet, CCoinControl& coinControl,
             if (reissueToken.nAmount > 0) {
                 std::string strError = "";
                 ErrorReport report;
-                if (!ContextualCheckVerifierString(ptokens, *verifier_string, address, strError, &report)) {
+                if (!ContextualCheckVerifierString(ptokens, *verifier_string, CTokenAddress::FromString(address), strError, &report)) {
                     error = std::make_pair(RPC_INVALID_PARAMETER, strError);
                     return false;
                 }
             } else {
                 // If we aren't adding any tokens but we are changing the verifier string, Check to make sure the verifier string parses correctly
                 std::string strError = "";
-                if (!ContextualCheckVerifierString(ptokens, *verifier_string, "", strError)) {
+                if (!ContextualCheckVerifierString(ptokens, *verifier_string, CTokenAddress(), strError)) {
                     error = std::make_pair(RPC_INVALID_PARAMETER, strError);
                     return false;
                 }
@@ -4388,7 +4488,7 @@ bool CreateReissueTokenTransaction(CWallet* pwallet, CCoinControl& coinControl,
                 }
 
                 std::string strError = "";
-                if (!ContextualCheckVerifierString(ptokens, verifier.verifier_string, address, strError)) {
+                if (!ContextualCheckVerifierString(ptokens, verifier.verifier_string, CTokenAddress::FromString(address), strError)) {
                     error = std::make_pair(RPC_INVALID_PARAMETER, strError);
                     return false;
                 }
@@ -4489,13 +4589,13 @@ bool CreateTransferTokenTransaction(CWallet* pwallet, const CCoinControl& coinCo
                 return false;
             }
 
-            if (!transfer.first.ContextualCheckAgainstVerifyString(ptokens, address, strError)) {
+            if (!transfer.first.ContextualCheckAgainstVerifyString(ptokens, CTokenAddress::FromString(address), strError)) {
                 error = std::make_pair(RPC_INVALID_PARAMETER, strError);
                 return false;
             }
 
             if (!coinControl.tokenDestChange.empty()) {
-                std::string change_address = EncodeDestination(coinControl.tokenDestChange);
+                CTokenAddress change_address(coinControl.tokenDestChange);
                 // If this is a transfer of a restricted token, check the destination address against the verifier string
                 CNullTokenTxVerifierString verifier;
                 if (!ptokens->GetTokenVerifierStringIfExists(token_name, verifier)) {
@@ -4528,14 +4628,14 @@ bool CreateTransferTokenTransaction(CWallet* pwallet, const CCoinControl& coinCo
         for (auto pair : *nullTokenTxData) {
 
             if (IsTokenNameAQualifier(pair.first.token_name)) {
-                if (!VerifyQualifierChange(*ptokens, pair.first, pair.second, strError)) {
+                if (!VerifyQualifierChange(*ptokens, pair.first, CTokenAddress::FromString(pair.second), strError)) {
                     error = std::make_pair(RPC_INVALID_REQUEST, strError);
                     return false;
                 }
                 if (pair.first.flag == (int)QualifierType::ADD_QUALIFIER)
                     nAddTagCount++;
             } else if (IsTokenNameAnRestricted(pair.first.token_name)) {
-                if (!VerifyRestrictedAddressChange(*ptokens, pair.first, pair.second, strError)) {
+                if (!VerifyRestrictedAddressChange(*ptokens, pair.first, CTokenAddress::FromString(pair.second), strError)) {
                     error = std::make_pair(RPC_INVALID_REQUEST, strError);
                     return false;
                 }
@@ -4665,12 +4765,12 @@ bool ParseTokenScript(CScript scriptPubKey, uint160 &hashBytes, int& nScriptType
     int nType;
     bool fIsOwner;
     int _nStartingPoint;
-    std::string _strAddress;
+    CTokenAddress address;
     bool isToken = false;
     if (scriptPubKey.IsTokenScript(nType, nScriptType, fIsOwner, _nStartingPoint)) {
         if (nType == TX_NEW_TOKEN) {
             if (fIsOwner) {
-                if (OwnerTokenFromScript(scriptPubKey, tokenName, _strAddress)) {
+                if (OwnerTokenFromScript(scriptPubKey, tokenName, address)) {
                     tokenAmount = OWNER_TOKEN_AMOUNT;
                     isToken = true;
                 } else {
@@ -4678,7 +4778,7 @@ bool ParseTokenScript(CScript scriptPubKey, uint160 &hashBytes, int& nScriptType
                 }
             } else {
                 CNewToken token;
-                if (TokenFromScript(scriptPubKey, token, _strAddress)) {
+                if (TokenFromScript(scriptPubKey, token, address)) {
                     tokenName = token.strName;
                     tokenAmount = token.nAmount;
                     isToken = true;
@@ -4688,7 +4788,7 @@ bool ParseTokenScript(CScript scriptPubKey, uint160 &hashBytes, int& nScriptType
             }
         } else if (nType == TX_REISSUE_TOKEN) {
             CReissueToken token;
-            if (ReissueTokenFromScript(scriptPubKey, token, _strAddress)) {
+            if (ReissueTokenFromScript(scriptPubKey, token, address)) {
                 tokenName = token.strName;
                 tokenAmount = token.nAmount;
                 isToken = true;
@@ -4697,7 +4797,7 @@ bool ParseTokenScript(CScript scriptPubKey, uint160 &hashBytes, int& nScriptType
             }
         } else if (nType == TX_TRANSFER_TOKEN) {
             CTokenTransfer token;
-            if (TransferTokenFromScript(scriptPubKey, token, _strAddress)) {
+            if (TransferTokenFromScript(scriptPubKey, token, address)) {
                 tokenName = token.strName;
                 tokenAmount = token.nAmount;
                 nTimeLock = token.nTimeLock;
@@ -4811,44 +4911,32 @@ bool CTokensCache::GetTokenVerifierStringIfExists(const std::string &name, CNull
     // Create objects that will be used to check the dirty cache
     CTokenCacheRestrictedVerifiers tempCacheVerifier {name, ""};
 
-    auto setIterator = setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
-    // Check the dirty caches first and see if it was recently added or removed
-    if (!fSkipTempCache && setIterator != setNewRestrictedVerifierToRemove.end()) {
-        if (setIterator->fUndoingRessiue) {
-            verifierString.verifier_string = setIterator->verifier;
-            return true;
+    // Check the dirty caches first, the nearest view that added or removed the verifier decides.
+    // With fSkipTempCache only the global cache is checked, not this view or the views between it and this one
+    for (const CTokensCache* view = this; view; view = view->GetParent()) {
+        if (fSkipTempCache && view != ptokens)
+            continue;
+
+        auto setIterator = view->setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
+        if (setIterator != view->setNewRestrictedVerifierToRemove.end()) {
+            if (setIterator->fUndoingRessiue) {
+                verifierString.verifier_string = setIterator->verifier;
+                return true;
+            }
+            return false;
         }
-        return false;
-    }
 
-    setIterator = ptokens->setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
-    // Check the dirty caches first and see if it was recently added or removed
-    if (setIterator != ptokens->setNewRestrictedVerifierToRemove.end()) {
-        if (setIterator->fUndoingRessiue) {
+        setIterator = view->setNewRestrictedVerifierToAdd.find(tempCacheVerifier);
+        if (setIterator != view->setNewRestrictedVerifierToAdd.end()) {
             verifierString.verifier_string = setIterator->verifier;
             return true;
         }
-        return false;
-    }
-
-    setIterator = setNewRestrictedVerifierToAdd.find(tempCacheVerifier);
-    if (!fSkipTempCache && setIterator != setNewRestrictedVerifierToAdd.end()) {
-        verifierString.verifier_string = setIterator->verifier;
-        return true;
-    }
-
-    setIterator = ptokens->setNewRestrictedVerifierToAdd.find(tempCacheVerifier);
-    if (setIterator != ptokens->setNewRestrictedVerifierToAdd.end()) {
-        verifierString.verifier_string = setIterator->verifier;
-        return true;
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (ptokensVerifierCache) {
-        if (ptokensVerifierCache->Exists(name)) {
-            verifierString = ptokensVerifierCache->Get(name);
+        if (ptokensVerifierCache->TryGet(name, verifierString))
             return true;
-        }
     }
 
     if (prestricteddb) {
@@ -4864,7 +4952,7 @@ bool CTokensCache::GetTokenVerifierStringIfExists(const std::string &name, CNull
     return false;
 }
 
-bool CTokensCache::CheckForAddressQualifier(const std::string &qualifier_name, const std::string& address, bool fSkipTempCache)
+bool CTokensCache::CheckForAddressQualifier(const std::string &qualifier_name, const CTokenAddress& address, bool fSkipTempCache)
 {
     /** There are circumstances where a blocks transactions could be removing or adding a qualifier to an address,
      * While at the same time a transaction is added to the same block that is trying to transfer to the same address.
@@ -4878,42 +4966,32 @@ bool CTokensCache::CheckForAddressQualifier(const std::string &qualifier_name, c
     // Create cache object that will be used to check the dirty caches
     CTokenCacheQualifierAddress cachedQualifierAddress(qualifier_name, address, QualifierType::ADD_QUALIFIER);
 
-    // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewQualifierAddressToRemove.find(cachedQualifierAddress);
-    if (!fSkipTempCache &&setIterator != setNewQualifierAddressToRemove.end()) {
-        // Undoing a remove qualifier command, means that we are adding the qualifier to the address
-        return setIterator->type == QualifierType::REMOVE_QUALIFIER;
-    }
-
-
-    setIterator = ptokens->setNewQualifierAddressToRemove.find(cachedQualifierAddress);
-    if (setIterator != ptokens->setNewQualifierAddressToRemove.end()) {
-        // Undoing a remove qualifier command, means that we are adding the qualifier to the address
-        return setIterator->type == QualifierType::REMOVE_QUALIFIER;
-    }
-
-    setIterator = setNewQualifierAddressToAdd.find(cachedQualifierAddress);
-    if (!fSkipTempCache && setIterator != setNewQualifierAddressToAdd.end()) {
-        // Return true if we are adding the qualifier, and false if we are removing it
-        return setIterator->type == QualifierType::ADD_QUALIFIER;
-    }
+    // Check the dirty caches first, the nearest view that added or removed the qualifier decides.
+    // With fSkipTempCache only the global cache is checked, not this view or the views between it and this one
+    for (const CTokensCache* view = this; view; view = view->GetParent()) {
+        if (fSkipTempCache && view != ptokens)
+            continue;
 
+        auto setIterator = view->setNewQualifierAddressToRemove.find(cachedQualifierAddress);
+        if (setIterator != view->setNewQualifierAddressToRemove.end()) {
+            // Undoing a remove qualifier command, means that we are adding the qualifier to the address
+            return setIterator->type == QualifierType::REMOVE_QUALIFIER;
+        }
 
-    setIterator = ptokens->setNewQualifierAddressToAdd.find(cachedQualifierAddress);
-    if (setIterator != ptokens->setNewQualifierAddressToAdd.end()) {
-        // Return true if we are adding the qualifier, and false if we are removing it
-        return setIterator->type == QualifierType::ADD_QUALIFIER;
+        setIterator = view->setNewQualifierAddressToAdd.find(cachedQualifierAddress);
+        if (setIterator != view->setNewQualifierAddressToAdd.end()) {
+            // Return true if we are adding the qualifier, and false if we are removing it
+            return setIterator->type == QualifierType::ADD_QUALIFIER;
+        }
     }
 
     auto tempCache = CTokenCacheRootQualifierChecker(qualifier_name, address);
-    if (!fSkipTempCache && mapRootQualifierAddressesAdd.count(tempCache)){
-        if (mapRootQualifierAddressesAdd[tempCache].size()) {
-            return true;
-        }
-    }
+    for (const CTokensCache* view = this; view; view = view->GetParent()) {
+        if (fSkipTempCache && view != ptokens)
+            continue;
 
-    if (ptokens->mapRootQualifierAddressesAdd.count(tempCache)) {
-        if (ptokens->mapRootQualifierAddressesAdd[tempCache].size()) {
+        auto mapIterator = view->mapRootQualifierAddressesAdd.find(tempCache);
+        if (mapIterator != view->mapRootQualifierAddressesAdd.end() && mapIterator->second.size()) {
             return true;
         }
     }
@@ -4925,6 +5003,22 @@ bool CTokensCache::CheckForAddressQualifier(const std::string &qualifier_name, c
         }
     }
 
+    // Addresses loaded by LoadAddressQualifiers are answered the same way as the database reads below
+    auto addressIterator = mapAddressQualifiers.find(address);
+    if (addressIterator != mapAddressQualifiers.end()) {
+        const std::set<std::string>& qualifiers = addressIterator->second;
+        if (qualifiers.count(qualifier_name)) {
+            if (ptokensQualifierCache)
+                ptokensQualifierCache->Put(cachedQualifierAddress.GetHash().GetHex(), 1);
+            return true;
+        }
+
+        // Look for sub qualifiers
+        std::string prefix = qualifier_name + "/";
+        auto qualifierIterator = qualifiers.lower_bound(prefix);
+        return qualifierIterator != qualifiers.end() && qualifierIterator->compare(0, prefix.size(), prefix) == 0;
+    }
+
     if (prestricteddb) {
 
         // Check for exact qualifier, and add to cache if it exists
@@ -4943,7 +5037,27 @@ bool CTokensCache::CheckForAddressQualifier(const std::string &qualifier_name, c
 }
 
 
-bool CTokensCache::CheckForAddressRestriction(const std::string &restricted_name, const std::string& address, bool fSkipTempCache)
+void CTokensCache::LoadAddressQualifiers(const std::set<CTokenAddress>& setAddresses)
+{
+    if (!prestricteddb)
+        return;
+
+    std::set<CTokenAddress> setMissing;
+    for (const CTokenAddress& address : setAddresses) {
+        if (!mapAddressQualifiers.count(address))
+            setMissing.insert(address);
+    }
+
+    if (setMissing.empty())
+        return;
+
+    std::map<CTokenAddress, std::set<std::string> > mapRead;
+    prestricteddb->ReadAddressesQualifiers(setMissing, mapRead);
+    for (const auto& item : mapRead)
+        mapAddressQualifiers.insert(item);
+}
+
+bool CTokensCache::CheckForAddressRestriction(const std::string &restricted_name, const CTokenAddress& address, bool fSkipTempCache)
 {
     /** There are circumstances where a blocks transactions could be removing or adding a restriction to an address,
      * While at the same time a transaction is added to the same block that is trying to transfer from that address.
@@ -4957,36 +5071,31 @@ bool CTokensCache::CheckForAddressRestriction(const std::string &restricted_name
     // Create cache object that will be used to check the dirty caches (type, doesn't matter in this search)
     CTokenCacheRestrictedAddress cachedRestrictedAddress(restricted_name, address, RestrictedType::FREEZE_ADDRESS);
 
-    // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
-    if (!fSkipTempCache && setIterator != setNewRestrictedAddressToRemove.end()) {
-        // Undoing a unfreeze, means that we are adding back a freeze
-        return setIterator->type == RestrictedType::UNFREEZE_ADDRESS;
-    }
-
-    setIterator = ptokens->setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
-    if (setIterator != ptokens->setNewRestrictedAddressToRemove.end()) {
-        // Undoing a unfreeze, means that we are adding back a freeze
-        return setIterator->type == RestrictedType::UNFREEZE_ADDRESS;
-    }
+    // Check the dirty caches first, the nearest view that added or removed the restriction decides.
+    // With fSkipTempCache only the global cache is checked, not this view or the views between it and this one
+    for (const CTokensCache* view = this; view; view = view->GetParent()) {
+        if (fSkipTempCache && view != ptokens)
+            continue;
 
-    setIterator = setNewRestrictedAddressToAdd.find(cachedRestrictedAddress);
-    if (!fSkipTempCache && setIterator != setNewRestrictedAddressToAdd.end()) {
-        // Return true if we are freezing the address
-        return setIterator->type == RestrictedType::FREEZE_ADDRESS;
-    }
+        auto setIterator = view->setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
+        if (setIterator != view->setNewRestrictedAddressToRemove.end()) {
+            // Undoing a unfreeze, means that we are adding back a freeze
+            return setIterator->type == RestrictedType::UNFREEZE_ADDRESS;
+        }
 
-    setIterator = ptokens->setNewRestrictedAddressToAdd.find(cachedRestrictedAddress);
-    if (setIterator != ptokens->setNewRestrictedAddressToAdd.end()) {
-        // Return true if we are freezing the address
-        return setIterator->type == RestrictedType::FREEZE_ADDRESS;
+        setIterator = view->setNewRestrictedAddressToAdd.find(cachedRestrictedAddress);
+        if (setIterator != view->setNewRestrictedAddressToAdd.end()) {
+            // Return true if we are freezing the address
+            return setIterator->type == RestrictedType::FREEZE_ADDRESS;
+        }
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (ptokensRestrictionCache) {
-        if (ptokensRestrictionCache->Exists(cachedRestrictedAddress.GetHash().GetHex())) {
-            return true;
-        }
+        int8_t nCached;
+        bool fMissing = false;
+        if (ptokensRestrictionCache->TryGet(cachedRestrictedAddress.GetHash().GetHex(), nCached, fMissing))
+            return !fMissing;
     }
 
     if (prestricteddb) {
@@ -4996,6 +5105,10 @@ bool CTokensCache::CheckForAddressRestriction(const std::string &restricted_name
             }
             return true;
         }
+
+        // Most addresses are never frozen, remember it until the flush that freezes it replaces the entry
+        if (ptokensRestrictionCache)
+            ptokensRestrictionCache->PutMissing(cachedRestrictedAddress.GetHash().GetHex());
     }
 
     return false;
@@ -5016,36 +5129,31 @@ bool CTokensCache::CheckForGlobalRestriction(const std::string &restricted_name,
     // Create cache object that will be used to check the dirty caches (type, doesn't matter in this search)
     CTokenCacheRestrictedGlobal cachedRestrictedGlobal(restricted_name, RestrictedType::GLOBAL_FREEZE);
 
-    // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
-    if (!fSkipTempCache && setIterator != setNewRestrictedGlobalToRemove.end()) {
-        // Undoing a removal of a global unfreeze, means that is will become frozen
-        return setIterator->type == RestrictedType::GLOBAL_UNFREEZE;
-    }
-
-    setIterator = ptokens->setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
-    if (setIterator != ptokens->setNewRestrictedGlobalToRemove.end()) {
-        // Undoing a removal of a global unfreeze, means that is will become frozen
-        return setIterator->type == RestrictedType::GLOBAL_UNFREEZE;
-    }
+    // Check the dirty caches first, the nearest view that added or removed the restriction decides.
+    // With fSkipTempCache only the global cache is checked, not this view or the views between it and this one
+    for (const CTokensCache* view = this; view; view = view->GetParent()) {
+        if (fSkipTempCache && view != ptokens)
+            continue;
 
-    setIterator = setNewRestrictedGlobalToAdd.find(cachedRestrictedGlobal);
-    if (!fSkipTempCache && setIterator != setNewRestrictedGlobalToAdd.end()) {
-        // Return true if we are adding a freeze command
-        return setIterator->type == RestrictedType::GLOBAL_FREEZE;
-    }
+        auto setIterator = view->setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
+        if (setIterator != view->setNewRestrictedGlobalToRemove.end()) {
+            // Undoing a removal of a global unfreeze, means that is will become frozen
+            return setIterator->type == RestrictedType::GLOBAL_UNFREEZE;
+        }
 
-    setIterator = ptokens->setNewRestrictedGlobalToAdd.find(cachedRestrictedGlobal);
-    if (setIterator != ptokens->setNewRestrictedGlobalToAdd.end()) {
-        // Return true if we are adding a freeze command
-        return setIterator->type == RestrictedType::GLOBAL_FREEZE;
+        setIterator = view->setNewRestrictedGlobalToAdd.find(cachedRestrictedGlobal);
+        if (setIterator != view->setNewRestrictedGlobalToAdd.end()) {
+            // Return true if we are adding a freeze command
+            return setIterator->type == RestrictedType::GLOBAL_FREEZE;
+        }
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (ptokensGlobalRestrictionCache) {
-        if (ptokensGlobalRestrictionCache->Exists(cachedRestrictedGlobal.tokenName)) {
-            return true;
-        }
+        int8_t nCached;
+        bool fMissing = false;
+        if (ptokensGlobalRestrictionCache->TryGet(cachedRestrictedGlobal.tokenName, nCached, fMissing))
+            return !fMissing;
     }
 
     if (prestricteddb) {
@@ -5054,6 +5162,9 @@ bool CTokensCache::CheckForGlobalRestriction(const std::string &restricted_name,
                 ptokensGlobalRestrictionCache->Put(cachedRestrictedGlobal.tokenName, 1);
             return true;
         }
+
+        if (ptokensGlobalRestrictionCache)
+            ptokensGlobalRestrictionCache->PutMissing(cachedRestrictedGlobal.tokenName);
     }
 
     return false;
@@ -5061,15 +5172,19 @@ bool CTokensCache::CheckForGlobalRestriction(const std::string &restricted_name,
 
 void ExtractVerifierStringQualifiers(const std::string& verifier, std::set<std::string>& qualifiers)
 {
-    std::string s(verifier);
-
-    std::regex regexSearch = std::regex(R"([A-Z0-9_.]+)");
-    std::smatch match;
+    // Every run of A-Z 0-9 _ . is a qualifier name
+    const char* end = verifier.data() + verifier.size();
+    const char* p = verifier.data();
+    while (p != end) {
+        if (!(GetNameCharClass(*p) & NAME_CHAR)) {
+            p++;
+            continue;
+        }
 
-    while (std::regex_search(s,match,regexSearch)) {
-        for (auto str : match)
-            qualifiers.insert(str);
-        s = match.suffix().str();
+        const char* begin = p;
+        while (p != end && (GetNameCharClass(*p) & NAME_CHAR))
+            p++;
+        qualifiers.emplace(begin, p);
     }
 }
 
@@ -5084,12 +5199,27 @@ std::string GetStrippedVerifierString(const std::string& verifier)
     return str_without_qualifier_tags;
 }
 
-bool CheckVerifierString(const std::string& verifier, std::set<std::string>& setFoundQualifiers, std::string& strError, ErrorReport* errorReport)
+/** A verifier string that passed CheckVerifierString, with the qualifiers it uses and its compiled formula */
+struct CCompiledVerifierString
 {
-    // If verifier string is true, always return true
-    if (verifier == "true") {
-        return true;
-    }
+    std::set<std::string> setQualifiers;
+    LibBoolEE::Formula formula;
+};
+
+//! The nodes of the compiled formula aren't counted, they are bounded by the verifier string the entry is cached under
+static inline size_t RecursiveDynamicUsage(const std::shared_ptr<const CCompiledVerifierString>& compiled) {
+    return compiled ? memusage::DynamicUsage(compiled) + RecursiveDynamicUsage(compiled->setQualifiers) : 0;
+}
+
+// Whether a verifier string is valid and what it compiles to doesn't depend on the chain,
+// so the entries never have to be invalidated
+static CLRUCache<std::string, std::shared_ptr<const CCompiledVerifierString>> compiledVerifierCache(MAX_CACHE_TOKENS_BYTES);
+
+static std::shared_ptr<const CCompiledVerifierString> CompileVerifierString(const std::string& verifier, std::string& strError, ErrorReport* errorReport)
+{
+    std::shared_ptr<const CCompiledVerifierString> cached;
+    if (compiledVerifierCache.TryGet(verifier, cached))
+        return cached;
 
     // If verifier string is empty, return false
     if (verifier.empty()) {
@@ -5098,7 +5228,7 @@ bool CheckVerifierString(const std::string& verifier, std::set<std::string>& set
             errorReport->type = ErrorReport::ErrorType::EmptyString;
             errorReport->strDevData = "bad-txns-null-verifier-empty";
         }
-        return false;
+        return nullptr;
     }
 
     // Remove all white spaces, and # from the string as this is how it will be stored in database, and in the script
@@ -5112,41 +5242,37 @@ bool CheckVerifierString(const std::string& verifier, std::set<std::string>& set
             errorReport->strDevData = "bad-txns-null-verifier-length-greater-than-max-length";
             errorReport->vecUserData.emplace_back(strippedVerifier);
         }
-        return false;
+        return nullptr;
     }
 
-    // Extract the qualifiers from the verifier string
-    ExtractVerifierStringQualifiers(strippedVerifier, setFoundQualifiers);
-
-    // Create an object that stores if an address contains a qualifier
-    LibBoolEE::Vals vals;
+    std::shared_ptr<CCompiledVerifierString> compiled = std::make_shared<CCompiledVerifierString>();
 
-    // If the check address is empty
+    // Extract the qualifiers from the verifier string
+    ExtractVerifierStringQualifiers(strippedVerifier, compiled->setQualifiers);
 
-    // set all qualifiers in the verifier to true
-    for (auto qualifier : setFoundQualifiers) {
+    for (auto qualifier : compiled->setQualifiers) {
 
         std::string edited_qualifier;
 
         // Qualifer string was stripped above, so we need to add back the #
         edited_qualifier = QUALIFIER_CHAR + qualifier;
 
-        if (!IsQualifierNameValid(edited_qualifier)) {
+        if (!IsQualifierNameValid(edited_qualifier.data(), edited_qualifier.data() + edited_qualifier.size())) {
             strError = "bad-txns-null-verifier-invalid-token-name-" + qualifier;
             if (errorReport) {
                 errorReport->type = ErrorReport::ErrorType::InvalidQualifierName;
                 errorReport->vecUserData.emplace_back(edited_qualifier);
                 errorReport->strDevData = "bad-txns-null-verifier-invalid-token-name-" + qualifier;
             }
-            return false;
+            return nullptr;
         }
-
-        vals.insert(std::make_pair(qualifier, true));
     }
 
+    // Bit i of the values the formula is evaluated with is set if the address has the i-th qualifier
+    std::vector<std::string> vQualifiers(compiled->setQualifiers.begin(), compiled->setQualifiers.end());
+
     try {
-        LibBoolEE::resolve(verifier, vals, errorReport);
-        return true;
+        LibBoolEE::compile(verifier, vQualifiers, compiled->formula, errorReport);
     } catch (const std::runtime_error& run_error) {
         if (errorReport) {
             if (errorReport->type == ErrorReport::ErrorType::NotSetError) {
@@ -5156,8 +5282,27 @@ bool CheckVerifierString(const std::string& verifier, std::set<std::string>& set
             }
         }
         strError = "bad-txns-null-verifier-failed-syntax-check";
-        return error("%s : Verifier string failed to resolve. Please check string syntax - exception: %s\n", __func__, run_error.what());
+        error("%s : Verifier string failed to resolve. Please check string syntax - exception: %s\n", __func__, run_error.what());
+        return nullptr;
+    }
+
+    compiledVerifierCache.Put(verifier, compiled);
+    return compiled;
+}
+
+bool CheckVerifierString(const std::string& verifier, std::set<std::string>& setFoundQualifiers, std::string& strError, ErrorReport* errorReport)
+{
+    // If verifier string is true, always return true
+    if (verifier == "true") {
+        return true;
     }
+
+    std::shared_ptr<const CCompiledVerifierString> compiled = CompileVerifierString(verifier, strError, errorReport);
+    if (!compiled)
+        return false;
+
+    setFoundQualifiers.insert(compiled->setQualifiers.begin(), compiled->setQualifiers.end());
+    return true;
 }
 
 bool VerifyNullTokenDataFlag(const int& flag, std::string& strError)
@@ -5171,7 +5316,7 @@ bool VerifyNullTokenDataFlag(const int& flag, std::string& strError)
     return true;
 }
 
-bool VerifyQualifierChange(CTokensCache& cache, const CNullTokenTxData& data, const std::string& address, std::string& strError)
+bool VerifyQualifierChange(CTokensCache& cache, const CNullTokenTxData& data, const CTokenAddress& address, std::string& strError)
 {
     // Check the flag
     if (!VerifyNullTokenDataFlag(data.flag, strError))
@@ -5195,7 +5340,7 @@ bool VerifyQualifierChange(CTokensCache& cache, const CNullTokenTxData& data, co
     return true;
 }
 
-bool VerifyRestrictedAddressChange(CTokensCache& cache, const CNullTokenTxData& data, const std::string& address, std::string& strError)
+bool VerifyRestrictedAddressChange(CTokensCache& cache, const CNullTokenTxData& data, const CTokenAddress& address, std::string& strError)
 {
     // Check the flag
     if (!VerifyNullTokenDataFlag(data.flag, strError))
@@ -5283,7 +5428,7 @@ bool ContextualCheckNullTokenTxOut(const CTxOut& txout, CTokensCache* tokenCache
 {
     // Get the data from the script
     CNullTokenTxData data;
-    std::string address;
+    CTokenAddress address;
     if (!TokenNullDataFromScript(txout.scriptPubKey, data, address)) {
         strError = "bad-txns-null-token-data-serialization";
         return false;
@@ -5307,8 +5452,8 @@ bool ContextualCheckNullTokenTxOut(const CTxOut& txout, CTokensCache* tokenCache
 
 #ifdef ENABLE_WALLET
     if (myNullTokenData && vpwallets.size()) {
-        if (IsMine(*vpwallets[0], DecodeDestination(address), chainActive.Tip()) & ISMINE_ALL) {
-            myNullTokenData->emplace_back(std::make_pair(address, data));
+        if (IsMine(*vpwallets[0], address.Get(), chainActive.Tip()) & ISMINE_ALL) {
+            myNullTokenData->emplace_back(std::make_pair(address.ToString(), data));
         }
     }
 #endif
@@ -5342,28 +5487,27 @@ bool ContextualCheckVerifierTokenTxOut(const CTxOut& txout, CTokensCache* tokenC
 
     if (tokenCache) {
         std::string strError = "";
-        std::string address = "";
         std::string strVerifier = verifier.verifier_string;
-        if (!ContextualCheckVerifierString(tokenCache, strVerifier, address, strError))
+        if (!ContextualCheckVerifierString(tokenCache, strVerifier, CTokenAddress(), strError))
             return false;
     }
 
     return true;
 }
 
-bool ContextualCheckVerifierString(CTokensCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport)
+bool ContextualCheckVerifierString(CTokensCache* cache, const std::string& verifier, const CTokenAddress& check_address, std::string& strError, ErrorReport* errorReport)
 {
     // If verifier is set to true, return true
     if (verifier == "true")
         return true;
 
     // Check against the non contextual changes first
-    std::set<std::string> setFoundQualifiers;
-    if (!CheckVerifierString(verifier, setFoundQualifiers, strError, errorReport))
+    std::shared_ptr<const CCompiledVerifierString> compiled = CompileVerifierString(verifier, strError, errorReport);
+    if (!compiled)
         return false;
 
     // Loop through each qualifier and make sure that the token exists
-    for(auto qualifier : setFoundQualifiers) {
+    for(auto qualifier : compiled->setQualifiers) {
         std::string search = QUALIFIER_CHAR + qualifier;
         if (!cache->CheckIfTokenExists(search, true)) {
             if (errorReport) {
@@ -5378,56 +5522,39 @@ bool ContextualCheckVerifierString(CTokensCache* cache, const std::string& verif
 
     // If we got this far, and the check_address is empty. The CheckVerifyString method already did the syntax checks
     // No need to do any more checks, as it will fail because the check_address is empty
-    if (check_address.empty())
+    if (check_address.IsNull())
         return true;
 
-    // Create an object that stores if an address contains a qualifier
-    LibBoolEE::Vals vals;
-
-    // Add the qualifiers into the vals object
-    for (auto qualifier : setFoundQualifiers) {
+    // Set the bit of each qualifier the address has, in the order the formula was compiled with
+    uint64_t values = 0;
+    size_t nBit = 0;
+    for (auto qualifier : compiled->setQualifiers) {
         std::string search = QUALIFIER_CHAR + qualifier;
 
         // Check to see if the address contains the qualifier
-        bool has_qualifier = cache->CheckForAddressQualifier(search, check_address, true);
-
-        // Add the true or false value into the vals
-        vals.insert(std::make_pair(qualifier, has_qualifier));
+        if (cache->CheckForAddressQualifier(search, check_address, true))
+            values |= (uint64_t)1 << nBit;
+        nBit++;
     }
 
-    try {
-        bool ret = LibBoolEE::resolve(verifier, vals, errorReport);
-        if (!ret) {
-            if (errorReport) {
-                if (errorReport->type == ErrorReport::ErrorType::NotSetError) {
-                    errorReport->type = ErrorReport::ErrorType::FailedToVerifyAgainstAddress;
-                    errorReport->vecUserData.emplace_back(check_address);
-                    errorReport->strDevData = "bad-txns-null-verifier-address-failed-verification";
-                }
-            }
-
-            error("%s : The address %s failed to verify against: %s. Is null %d", __func__, check_address, verifier, errorReport ? 0 : 1);
-            strError = "bad-txns-null-verifier-address-failed-verification";
-        }
-        return ret;
-
-    } catch (const std::runtime_error& run_error) {
-
+    // The formula compiled, so it can't fail to evaluate
+    bool ret = LibBoolEE::evaluate(compiled->formula, values);
+    if (!ret) {
         if (errorReport) {
             if (errorReport->type == ErrorReport::ErrorType::NotSetError) {
-                errorReport->type = ErrorReport::ErrorType::InvalidSyntax;
+                errorReport->type = ErrorReport::ErrorType::FailedToVerifyAgainstAddress;
+                errorReport->vecUserData.emplace_back(check_address.ToString());
+                errorReport->strDevData = "bad-txns-null-verifier-address-failed-verification";
             }
-
-            errorReport->vecUserData.emplace_back(run_error.what());
-            errorReport->strDevData = "bad-txns-null-verifier-failed-contexual-syntax-check";
         }
 
-        strError = "bad-txns-null-verifier-failed-contexual-syntax-check";
-        return error("%s : Verifier string failed to resolve. Please check string syntax - exception: %s\n", __func__, run_error.what());
+        error("%s : The address %s failed to verify against: %s. Is null %d", __func__, check_address.ToString(), verifier, errorReport ? 0 : 1);
+        strError = "bad-txns-null-verifier-address-failed-verification";
     }
+    return ret;
 }
 
-bool ContextualCheckTransferToken(CTokensCache* tokenCache, const CTokenTransfer& transfer, const std::string& address, std::string& strError)
+bool ContextualCheckTransferToken(CTokensCache* tokenCache, const CTokenTransfer& transfer, const CTokenAddress& address, std::string& strError)
 {
     strError = "";
     KnownTokenType tokenType;
@@ -5734,10 +5861,10 @@ bool CheckReissueToken(const CReissueToken& token, std::string& strError)
 
 bool ContextualCheckReissueToken(CTokensCache* tokenCache, const CReissueToken& reissue_token, std::string& strError, const CTransaction& tx)
 {
-    // We are using this just to get the strAddress
+    // We are using this just to get the address
     CReissueToken reissue;
-    std::string strAddress;
-    if (!ReissueTokenFromTransaction(tx, reissue, strAddress)) {
+    CTokenAddress address;
+    if (!ReissueTokenFromTransaction(tx, reissue, address)) {
         strError = "bad-txns-reissue-token-contextual-check";
         return false;
     }
@@ -5843,7 +5970,7 @@ bool ContextualCheckReissueToken(CTokensCache* tokenCache, const CReissueToken&
             if (fNotFound) {
                 CNullTokenTxVerifierString current_verifier;
                 if (tokenCache->GetTokenVerifierStringIfExists(reissue_token.strName, current_verifier)) {
-                    if (!ContextualCheckVerifierString(tokenCache, current_verifier.verifier_string, strAddress, strError))
+                    if (!ContextualCheckVerifierString(tokenCache, current_verifier.verifier_string, address, strError))
                         return false;
                 } else {
                     // This should happen, but if it does. The wallet needs to shutdown,
@@ -5853,7 +5980,7 @@ bool ContextualCheckReissueToken(CTokensCache* tokenCache, const CReissueToken&
                     return false;
                 }
             } else {
-                if (!ContextualCheckVerifierString(tokenCache, new_verifier.verifier_string, strAddress, strError))
+                if (!ContextualCheckVerifierString(tokenCache, new_verifier.verifier_string, address, strError))
                     return false;
             }
         }
@@ -5922,8 +6049,8 @@ bool ContextualCheckUniqueTokenTx(CTokensCache* tokenCache, std::string& strErro
         if (IsScriptNewUniqueToken(out.scriptPubKey))
         {
             CNewToken token;
-            std::string strAddress;
-            if (!TokenFromScript(out.scriptPubKey, token, strAddress)) {
+            CTokenAddress address;
+            if (!TokenFromScript(out.scriptPubKey, token, address)) {
                 strError = "bad-txns-issue-unique-serialization-failed";
                 return false;
             }
@@ -5951,8 +6078,8 @@ bool ContextualCheckUsernameTokenTx(CTokensCache* tokenCache, std::string& strEr
         if (IsScriptNewUsername(out.scriptPubKey))
         {
             CNewToken token;
-            std::string strAddress;
-            if (!TokenFromScript(out.scriptPubKey, token, strAddress)) {
+            CTokenAddress address;
+            if (!TokenFromScript(out.scriptPubKey, token, address)) {
                 strError = "bad-txns-issue-username-serialization-failed";
                 return false;
             }
@@ -16,6 +16,7 @@
 #include <map>
 #include <unordered_map>
 #include <list>
+#include <memory>
 
 #define TOKEN_Y 121
 #define TOKEN_N 110
@@ -77,6 +78,9 @@ class COutput;
 // 2500 * 82 Bytes == 205 KB (kilobytes) of memory
 #define MAX_CACHE_TOKENS_SIZE 2500
 
+// Memory each of the token LRU caches may use, 4 MiB holds about 15000 token meta data entries
+#define MAX_CACHE_TOKENS_BYTES (4 << 20)
+
 // Create map that store that state of current reissued transaction that the mempool as accepted.
 // If an token name is in this map, any other reissue transactions wont be accepted into the mempool
 extern std::map<uint256, std::string> mapReissuedTx;
@@ -84,10 +88,10 @@ extern std::map<std::string, uint256> mapReissuedTokens;
 
 class CTokens {
 public:
-    std::map<std::pair<std::string, std::string>, CAmount> mapTokensAddressAmount; // pair < Token Name , Address > -> Quantity of tokens in the address
+    CTokenCacheMap<std::pair<std::string, CTokenAddress>, CAmount> mapTokensAddressAmount; // pair < Token Name , Address > -> Quantity of tokens in the address
 
     // Dirty, Gets wiped once flushed to database
-    std::map<std::string, CNewToken> mapReissuedTokenData; // Token Name -> New Token Data
+    CTokenCacheMap<std::string, CNewToken> mapReissuedTokenData; // Token Name -> New Token Data
 
     CTokens(const CTokens& tokens) {
         this->mapTokensAddressAmount = tokens.mapTokensAddressAmount;
@@ -137,57 +141,71 @@ std::string GetUserErrorString(const ErrorReport& report);
 class CTokensCache : public CTokens
 {
 private:
-    bool AddBackSpentToken(const Coin& coin, const std::string& tokenName, const std::string& address, const CAmount& nAmount, const COutPoint& out);
-    void AddToTokenBalance(const std::string& strName, const std::string& address, const CAmount& nAmount);
-    bool UndoTransfer(const CTokenTransfer& transfer, const std::string& address, const COutPoint& outToRemove);
+    bool AddBackSpentToken(const Coin& coin, const std::string& tokenName, const CTokenAddress& address, const CAmount& nAmount, const COutPoint& out);
+    void AddToTokenBalance(const std::string& strName, const CTokenAddress& address, const CAmount& nAmount);
+    bool UndoTransfer(const CTokenTransfer& transfer, const CTokenAddress& address, const COutPoint& outToRemove);
+
+    //! The view lookups fall through to and Flush merges into, nullptr for the global ptokens
+    CTokensCache* pparent;
 public :
     //! These are memory only containers that show dirty entries that will be databased when flushed
-    std::vector<CTokenCacheUndoTokenAmount> vUndoTokenAmount;
-    std::vector<CTokenCacheSpendToken> vSpentTokens;
+    CTokenCacheVector<CTokenCacheUndoTokenAmount> vUndoTokenAmount;
+    CTokenCacheVector<CTokenCacheSpendToken> vSpentTokens;
 
     //! New Tokens Caches
-    std::set<CTokenCacheNewToken> setNewTokensToRemove;
-    std::set<CTokenCacheNewToken> setNewTokensToAdd;
+    CTokenCacheSet<CTokenCacheNewToken> setNewTokensToRemove;
+    CTokenCacheSet<CTokenCacheNewToken> setNewTokensToAdd;
 
     //! New Reissue Caches
-    std::set<CTokenCacheReissueToken> setNewReissueToRemove;
-    std::set<CTokenCacheReissueToken> setNewReissueToAdd;
+    CTokenCacheSet<CTokenCacheReissueToken> setNewReissueToRemove;
+    CTokenCacheSet<CTokenCacheReissueToken> setNewReissueToAdd;
 
     //! Ownership Tokens Caches
-    std::set<CTokenCacheNewOwner> setNewOwnerTokensToAdd;
-    std::set<CTokenCacheNewOwner> setNewOwnerTokensToRemove;
+    CTokenCacheSet<CTokenCacheNewOwner> setNewOwnerTokensToAdd;
+    CTokenCacheSet<CTokenCacheNewOwner> setNewOwnerTokensToRemove;
 
     //! Transfer Tokens Caches
-    std::set<CTokenCacheNewTransfer> setNewTransferTokensToAdd;
-    std::set<CTokenCacheNewTransfer> setNewTransferTokensToRemove;
+    CTokenCacheSet<CTokenCacheNewTransfer> setNewTransferTokensToAdd;
+    CTokenCacheSet<CTokenCacheNewTransfer> setNewTransferTokensToRemove;
 
     //! Qualfier Address Token Caches
-    std::set<CTokenCacheQualifierAddress> setNewQualifierAddressToAdd;
-    std::set<CTokenCacheQualifierAddress> setNewQualifierAddressToRemove;
+    CTokenCacheSet<CTokenCacheQualifierAddress> setNewQualifierAddressToAdd;
+    CTokenCacheSet<CTokenCacheQualifierAddress> setNewQualifierAddressToRemove;
 
     //! Restricted Address Token Caches
-    std::set<CTokenCacheRestrictedAddress> setNewRestrictedAddressToAdd;
-    std::set<CTokenCacheRestrictedAddress> setNewRestrictedAddressToRemove;
+    CTokenCacheSet<CTokenCacheRestrictedAddress> setNewRestrictedAddressToAdd;
+    CTokenCacheSet<CTokenCacheRestrictedAddress> setNewRestrictedAddressToRemove;
 
     //! Restricted Global Token Caches
-    std::set<CTokenCacheRestrictedGlobal> setNewRestrictedGlobalToAdd;
-    std::set<CTokenCacheRestrictedGlobal> setNewRestrictedGlobalToRemove;
+    CTokenCacheSet<CTokenCacheRestrictedGlobal> setNewRestrictedGlobalToAdd;
+    CTokenCacheSet<CTokenCacheRestrictedGlobal> setNewRestrictedGlobalToRemove;
 
     //! Restricted Tokens Verifier Caches
-    std::set<CTokenCacheRestrictedVerifiers> setNewRestrictedVerifierToAdd;
-    std::set<CTokenCacheRestrictedVerifiers> setNewRestrictedVerifierToRemove;
+    CTokenCacheSet<CTokenCacheRestrictedVerifiers> setNewRestrictedVerifierToAdd;
+    CTokenCacheSet<CTokenCacheRestrictedVerifiers> setNewRestrictedVerifierToRemove;
 
     //! Root Qualifier Address Map
-    std::map<CTokenCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesAdd;
-    std::map<CTokenCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesRemove;
+    CTokenCacheMap<CTokenCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesAdd;
+    CTokenCacheMap<CTokenCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesRemove;
+
+    //! Qualifiers of addresses read from the restricted database by LoadAddressQualifiers, not copied with the cache
+    CTokenCacheMap<CTokenAddress, std::set<std::string> > mapAddressQualifiers;
+
+    CTokensCache() : CTokens(), pparent(nullptr)
+    {
+        SetNull();
+        ClearDirtyCache();
+    }
 
-    CTokensCache() : CTokens()
+    //! A view on top of parent that only records its own changes, like CCoinsViewCache over its base.
+    //! The parent must outlive the view
+    explicit CTokensCache(CTokensCache* parent) : CTokens(), pparent(parent)
     {
         SetNull();
         ClearDirtyCache();
     }
 
-    CTokensCache(const CTokensCache& cache) : CTokens(cache)
+    CTokensCache(const CTokensCache& cache) : CTokens(cache), pparent(cache.pparent)
     {
         //! Copy dirty cache also
         this->vSpentTokens = cache.vSpentTokens;
@@ -234,6 +252,7 @@ public :
     {
         this->mapTokensAddressAmount = cache.mapTokensAddressAmount;
         this->mapReissuedTokenData = cache.mapReissuedTokenData;
+        this->pparent = cache.pparent;
 
         //! Copy dirty cache also
         this->vSpentTokens = cache.vSpentTokens;
@@ -279,23 +298,23 @@ public :
     }
 
     //! Cache only undo functions
-    bool RemoveNewToken(const CNewToken& token, const std::string address);
-    bool RemoveTransfer(const CTokenTransfer& transfer, const std::string& address, const COutPoint& out);
-    bool RemoveOwnerToken(const std::string& tokensName, const std::string address);
-    bool RemoveReissueToken(const CReissueToken& reissue, const std::string address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockTokenUndo> >& vUndoIPFS);
+    bool RemoveNewToken(const CNewToken& token, const CTokenAddress& address);
+    bool RemoveTransfer(const CTokenTransfer& transfer, const CTokenAddress& address, const COutPoint& out);
+    bool RemoveOwnerToken(const std::string& tokensName, const CTokenAddress& address);
+    bool RemoveReissueToken(const CReissueToken& reissue, const CTokenAddress& address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockTokenUndo> >& vUndoIPFS);
     bool UndoTokenCoin(const Coin& coin, const COutPoint& out);
-    bool RemoveQualifierAddress(const std::string& tokenName, const std::string& address, const QualifierType type);
-    bool RemoveRestrictedAddress(const std::string& tokenName, const std::string& address, const RestrictedType type);
+    bool RemoveQualifierAddress(const std::string& tokenName, const CTokenAddress& address, const QualifierType type);
+    bool RemoveRestrictedAddress(const std::string& tokenName, const CTokenAddress& address, const RestrictedType type);
     bool RemoveGlobalRestricted(const std::string& tokenName, const RestrictedType type);
     bool RemoveRestrictedVerifier(const std::string& tokenName, const std::string& verifier, const bool fUndoingReissue = false);
 
     //! Cache only add token functions
-    bool AddNewToken(const CNewToken& token, const std::string address, const int& nHeight, const uint256& blockHash);
-    bool AddTransferToken(const CTokenTransfer& transferToken, const std::string& address, const COutPoint& out, const CTxOut& txOut);
-    bool AddOwnerToken(const std::string& tokensName, const std::string address);
-    bool AddReissueToken(const CReissueToken& reissue, const std::string address, const COutPoint& out);
-    bool AddQualifierAddress(const std::string& tokenName, const std::string& address, const QualifierType type);
-    bool AddRestrictedAddress(const std::string& tokenName, const std::string& address, const RestrictedType type);
+    bool AddNewToken(const CNewToken& token, const CTokenAddress& address, const int& nHeight, const uint256& blockHash);
+    bool AddTransferToken(const CTokenTransfer& transferToken, const CTokenAddress& address, const COutPoint& out, const CTxOut& txOut);
+    bool AddOwnerToken(const std::string& tokensName, const CTokenAddress& address);
+    bool AddReissueToken(const CReissueToken& reissue, const CTokenAddress& address, const COutPoint& out);
+    bool AddQualifierAddress(const std::string& tokenName, const CTokenAddress& address, const QualifierType type);
+    bool AddRestrictedAddress(const std::string& tokenName, const CTokenAddress& address, const RestrictedType type);
     bool AddGlobalRestricted(const std::string& tokenName, const RestrictedType type);
     bool AddRestrictedVerifier(const std::string& tokenName, const std::string& verifier);
 
@@ -317,26 +336,39 @@ public :
     bool GetTokenVerifierStringIfExists(const std::string &name, CNullTokenTxVerifierString& verifier, bool fSkipTempCache = false);
 
     //! Return true if the address has the given qualifier assigned to it
-    bool CheckForAddressQualifier(const std::string &qualifier_name, const std::string& address, bool fSkipTempCache = false);
+    bool CheckForAddressQualifier(const std::string &qualifier_name, const CTokenAddress& address, bool fSkipTempCache = false);
+
+    //! Read the qualifiers of all the addresses from the database in one pass, CheckForAddressQualifier then answers
+    //! from memory for them instead of reading each (qualifier, address) pair. Only valid while the database doesn't change
+    void LoadAddressQualifiers(const std::set<CTokenAddress>& setAddresses);
 
     //! Return true if the address is marked as frozen
-    bool CheckForAddressRestriction(const std::string &restricted_name, const std::string& address, bool fSkipTempCache = false);
+    bool CheckForAddressRestriction(const std::string &restricted_name, const CTokenAddress& address, bool fSkipTempCache = false);
 
     //! Return true if the restricted token is globally freezing trading
     bool CheckForGlobalRestriction(const std::string &restricted_name, bool fSkipTempCache = false);
 
-    //! Calculate the size of the CTokens (in bytes)
+    //! Calculate the memory used by the cache (in bytes), walks every entry
     size_t DynamicMemoryUsage() const;
 
-    //! Get the size of the none databased cache
+    //! Get the memory used by the none databased entries (in bytes), part of DynamicMemoryUsage
     size_t GetCacheSize() const;
-    size_t GetCacheSizeV2() const;
 
-    //! Flush all new cache entries into the ptokens global cache
+    //! The view below this one, ending with the global ptokens which has none
+    CTokensCache* GetParent() const;
+
+    //! Flush all new cache entries into the parent view, the ptokens global cache unless another parent was given
     bool Flush();
 
-    //! Write token cache data to database
-    bool DumpCacheToDatabase();
+    //! Write token cache data to database, one batch per database tagged with the chainstate block hashBlock
+    bool DumpCacheToDatabase(const uint256& hashBlock = uint256());
+
+    //! Whether the cache holds token data or balances the token database doesn't have yet
+    bool HasDirtyTokenData() const {
+        return !vUndoTokenAmount.empty() || !vSpentTokens.empty() || !setNewTokensToRemove.empty() || !setNewTokensToAdd.empty() ||
+               !setNewReissueToAdd.empty() || !setNewReissueToRemove.empty() || !setNewTransferTokensToAdd.empty() ||
+               !setNewTransferTokensToRemove.empty() || !setNewOwnerTokensToAdd.empty() || !setNewOwnerTokensToRemove.empty();
+    }
 
     //! Clear all dirty cache sets, vetors, and maps
     void ClearDirtyCache() {
@@ -373,6 +405,8 @@ public :
 
         mapRootQualifierAddressesAdd.clear();
         mapRootQualifierAddressesRemove.clear();
+
+        mapAddressQualifiers.clear();
     }
 
    std::string CacheToString() const {
@@ -387,6 +421,45 @@ public :
    }
 };
 
+/**
+ * The token meta data of ptokens that the tokens database doesn't have yet, as published for readers without cs_main.
+ * Each connected or disconnected block publishes only its own changes, on top of the snapshot of the block before.
+ */
+struct CTokenMetaDataSnapshot
+{
+    //! Tokens issued or reissued since the previous snapshot
+    std::map<std::string, CDatabasedTokenData> mapTokens;
+    //! Tokens whose issuance was disconnected since the previous snapshot
+    std::set<std::string> setRemoved;
+    //! The snapshot these changes were made on, null once they are all in the database
+    std::shared_ptr<const CTokenMetaDataSnapshot> pprev;
+    //! The number of snapshots down to the last one published in full
+    int nDepth;
+    //! The block whose token state this snapshot shows
+    uint256 hashBlock;
+
+    CTokenMetaDataSnapshot() : nDepth(0) {}
+};
+
+//! Publishes all the meta data changes ptokens holds as of hashBlock, call with cs_main held after ptokens was written
+//! to the database, where it holds none
+void PublishTokenMetaDataSnapshot(const uint256& hashBlock);
+
+//! Publishes the meta data changes that blockCache flushed into ptokens, moving the snapshot from hashPrevBlock to
+//! hashBlock. Falls back to PublishTokenMetaDataSnapshot if the published snapshot isn't at hashPrevBlock
+void PublishTokenMetaDataChanges(const CTokensCache& blockCache, const uint256& hashPrevBlock, const uint256& hashBlock);
+
+//! Records that a block was connected or disconnected without publishing its changes, as during the initial block
+//! download. The next PublishTokenMetaDataSnapshot catches the snapshot up
+void SkipTokenMetaDataChanges();
+
+//! Whether blocks were connected or disconnected since the published snapshot without publishing their changes
+bool IsTokenMetaDataSnapshotBehind();
+
+//! Looks up the meta data of a token as of the last published snapshot, without cs_main. Unlike
+//! CTokensCache::GetTokenMetaDataIfExists it falls through to ptokensCache and ptokensdb without adding to ptokensCache
+bool GetTokenMetaDataFromSnapshot(const std::string& name, CDatabasedTokenData& data);
+
 //! Functions to be used to get access to the current burn amount required for specific token issuance transactions
 CAmount GetIssueTokenFeeAmount();
 CAmount GetReissueTokenFeeAmount();
@@ -406,6 +479,9 @@ std::string GetBurnAddress(const int nType);
 
 void GetTxOutKnownTokenTypes(const std::vector<CTxOut>& vout, int& issues, int& reissues, int& transfers, int& owners);
 
+//! Memory used by the token LRU caches in validation.h (in bytes), walks every cached item
+size_t GetTokenLRUCachesUsage();
+
 //! Check is an token name is valid, and being able to return the token type if needed
 bool IsTokenNameValid(const std::string& name);
 bool IsTokenNameValid(const std::string& name, KnownTokenType& tokenType);
@@ -448,6 +524,28 @@ bool IsTypeCheckNameValid(const KnownTokenType type, const std::string& name, st
 
 //! These types of token tx, have specific metadata at certain indexes in the transaction.
 //! These functions pull data from the scripts at those indexes
+bool TokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address);
+bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, CTokenAddress& address);
+bool ReissueTokenFromTransaction(const CTransaction& tx, CReissueToken& reissue, CTokenAddress& address);
+bool UniqueTokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address);
+bool UsernameFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address);
+bool MsgChannelTokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address);
+bool QualifierTokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address);
+bool RestrictedTokenFromTransaction(const CTransaction& tx, CNewToken& token, CTokenAddress& address);
+
+//! Get specific token type metadata from the given scripts
+bool TransferTokenFromScript(const CScript& scriptPubKey, CTokenTransfer& tokenTransfer, CTokenAddress& address);
+bool TokenFromScript(const CScript& scriptPubKey, CNewToken& token, CTokenAddress& address);
+bool OwnerTokenFromScript(const CScript& scriptPubKey, std::string& tokenName, CTokenAddress& address);
+bool ReissueTokenFromScript(const CScript& scriptPubKey, CReissueToken& reissue, CTokenAddress& address);
+bool MsgChannelTokenFromScript(const CScript& scriptPubKey, CNewToken& token, CTokenAddress& address);
+bool QualifierTokenFromScript(const CScript& scriptPubKey, CNewToken& token, CTokenAddress& address);
+bool RestrictedTokenFromScript(const CScript& scriptPubKey, CNewToken& token, CTokenAddress& address);
+bool TokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& tokenData, CTokenAddress& address);
+bool TokenNullVerifierDataFromScript(const CScript& scriptPubKey, CNullTokenTxVerifierString& verifierData);
+bool GlobalTokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& tokenData);
+
+//! The same with the address encoded to base58, for the RPC, wallet and UI code
 bool TokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress);
 bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, std::string& strAddress);
 bool ReissueTokenFromTransaction(const CTransaction& tx, CReissueToken& reissue, std::string& strAddress);
@@ -456,8 +554,6 @@ bool UsernameFromTransaction(const CTransaction& tx, CNewToken& token, std::stri
 bool MsgChannelTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress);
 bool QualifierTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress);
 bool RestrictedTokenFromTransaction(const CTransaction& tx, CNewToken& token, std::string& strAddress);
-
-//! Get specific token type metadata from the given scripts
 bool TransferTokenFromScript(const CScript& scriptPubKey, CTokenTransfer& tokenTransfer, std::string& strAddress);
 bool TokenFromScript(const CScript& scriptPubKey, CNewToken& token, std::string& strAddress);
 bool OwnerTokenFromScript(const CScript& scriptPubKey, std::string& tokenName, std::string& strAddress);
@@ -466,8 +562,6 @@ bool MsgChannelTokenFromScript(const CScript& scriptPubKey, CNewToken& token, st
 bool QualifierTokenFromScript(const CScript& scriptPubKey, CNewToken& token, std::string& strAddress);
 bool RestrictedTokenFromScript(const CScript& scriptPubKey, CNewToken& token, std::string& strAddress);
 bool TokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& tokenData, std::string& strAddress);
-bool TokenNullVerifierDataFromScript(const CScript& scriptPubKey, CNullTokenTxVerifierString& verifierData);
-bool GlobalTokenNullDataFromScript(const CScript& scriptPubKey, CNullTokenTxData& tokenData);
 
 //! Check to make sure the script contains the burn transaction
 bool CheckIssueBurnTx(const CTxOut& txOut, const KnownTokenType& type, const int numberIssued);
@@ -525,7 +619,7 @@ bool IsScriptNewQualifierToken(const CScript &scriptPubKey, int &nStartingIndex)
 bool IsScriptNewRestrictedToken(const CScript& scriptPubKey);
 bool IsScriptNewRestrictedToken(const CScript &scriptPubKey, int &nStartingIndex);
 
-bool IsNewOwnerTxValid(const CTransaction& tx, const std::string& tokenName, const std::string& address, std::string& errorMsg);
+bool IsNewOwnerTxValid(const CTransaction& tx, const std::string& tokenName, const CTokenAddress& address, std::string& errorMsg);
 
 void GetAllAdministrativeTokens(CWallet *pwallet, std::vector<std::string> &names, int nMinConf = 1);
 void GetAllMyTokens(CWallet* pwallet, std::vector<std::string>& names, int nMinConf = 1, bool fIncludeAdministrator = false, bool fOnlyAdministrator = false);
@@ -535,7 +629,7 @@ bool GetTokenInfoFromScript(const CScript& scriptPubKey, std::string& strName, C
 
 bool GetTokenData(const CScript& script, CTokenOutputEntry& data);
 
-bool GetBestTokenAddressAmount(CTokensCache& cache, const std::string& tokenName, const std::string& address);
+bool GetBestTokenAddressAmount(CTokensCache& cache, const std::string& tokenName, const CTokenAddress& address);
 
 
 //! Decode and Encode IPFS hashes, or OIP hashes
@@ -578,8 +672,8 @@ std::string GetStrippedVerifierString(const std::string& verifier);
 
 /** Helper methods that validate changes to null token data transaction databases */
 bool VerifyNullTokenDataFlag(const int& flag, std::string& strError);
-bool VerifyQualifierChange(CTokensCache& cache, const CNullTokenTxData& data, const std::string& address, std::string& strError);
-bool VerifyRestrictedAddressChange(CTokensCache& cache, const CNullTokenTxData& data, const std::string& address, std::string& strError);
+bool VerifyQualifierChange(CTokensCache& cache, const CNullTokenTxData& data, const CTokenAddress& address, std::string& strError);
+bool VerifyRestrictedAddressChange(CTokensCache& cache, const CNullTokenTxData& data, const CTokenAddress& address, std::string& strError);
 bool VerifyGlobalRestrictedChange(CTokensCache& cache, const CNullTokenTxData& data, std::string& strError);
 
 //// Non Contextual Check functions
@@ -591,9 +685,9 @@ bool CheckReissueToken(const CReissueToken& token, std::string& strError);
 bool ContextualCheckNullTokenTxOut(const CTxOut& txout, CTokensCache* tokenCache, std::string& strError, std::vector<std::pair<std::string, CNullTokenTxData>>* myNullTokenData = nullptr);
 bool ContextualCheckGlobalTokenTxOut(const CTxOut& txout, CTokensCache* tokenCache, std::string& strError);
 bool ContextualCheckVerifierTokenTxOut(const CTxOut& txout, CTokensCache* tokenCache, std::string& strError);
-bool ContextualCheckVerifierString(CTokensCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport = nullptr);
+bool ContextualCheckVerifierString(CTokensCache* cache, const std::string& verifier, const CTokenAddress& check_address, std::string& strError, ErrorReport* errorReport = nullptr);
 bool ContextualCheckNewToken(CTokensCache* tokenCache, const CNewToken& token, std::string& strError, bool fCheckMempool = false);
-bool ContextualCheckTransferToken(CTokensCache* tokenCache, const CTokenTransfer& transfer, const std::string& address, std::string& strError);
+bool ContextualCheckTransferToken(CTokensCache* tokenCache, const CTokenTransfer& transfer, const CTokenAddress& address, std::string& strError);
 bool ContextualCheckReissueToken(CTokensCache* tokenCache, const CReissueToken& reissue_token, std::string& strError, const CTransaction& tx);
 bool ContextualCheckReissueToken(CTokensCache* tokenCache, const CReissueToken& reissue_token, std::string& strError);
 bool ContextualCheckUniqueTokenTx(CTokensCache* tokenCache, std::string& strError, const CTransaction& tx);
@@ -7,10 +7,13 @@
 #include "validation.h"
 #include "base58.h"
 
+#include <algorithm>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/thread.hpp>
 
 static const char SNAPSHOTCHECK_FLAG = 'C'; // Snapshot Check
+static const char SNAPSHOT_OWNERS_FLAG = 'O'; // Snapshot Owners Chunk
 
 CTokenSnapshotDBEntry::CTokenSnapshotDBEntry()
 {
@@ -48,71 +51,71 @@ bool CTokenSnapshotDB::AddTokenOwnershipSnapshot(
         return false;
     }
 
-    std::set<std::pair<std::string, CAmount>> ownersAndAmounts;
-    std::vector<std::pair<std::string, CAmount>> tempOwnersAndAmounts;
-    int totalEntryCount;
-
-    if (!ptokensdb->TokenAddressDir(tempOwnersAndAmounts, totalEntryCount, true, p_tokenName, INT_MAX, 0)) {
-        LogPrint(BCLog::REWARDS, "AddTokenOwnershipSnapshot: Failed to retrieve tokens directory for '%s'\n", p_tokenName.c_str());
-        return false;
-    }
+    CTokenSnapshotDBEntry snapshotEntry(p_tokenName, p_height, std::set<std::pair<std::string, CAmount>>());
 
-    //  Retrieve all of the addresses/amounts in batches
-    const int MAX_RETRIEVAL_COUNT = 100;
+    //  Stream the owners from the tokens DB into chunks and write each chunk once it is full
+    std::vector<std::pair<std::string, CAmount>> chunk;
+    chunk.reserve(OWNERS_PER_SNAPSHOT_CHUNK);
+    size_t ownerCount = 0;
     bool errorsOccurred = false;
 
-    for (int retrievalOffset = 0; retrievalOffset < totalEntryCount; retrievalOffset += MAX_RETRIEVAL_COUNT) {
-        //  Retrieve the specified segment of addresses
-        if (!ptokensdb->TokenAddressDir(tempOwnersAndAmounts, totalEntryCount, false, p_tokenName, MAX_RETRIEVAL_COUNT, retrievalOffset)) {
-            LogPrint(BCLog::REWARDS, "AddTokenOwnershipSnapshot: Failed to retrieve tokens directory for '%s'\n", p_tokenName.c_str());
-            errorsOccurred = true;
-            break;
-        }
-
-        //  Verify that some addresses were returned
-        if (tempOwnersAndAmounts.size() == 0) {
-            LogPrint(BCLog::REWARDS, "AddTokenOwnershipSnapshot: No addresses were retrieved.\n");
-            continue;
-        }
-
-        //  Move these into the main set
-        for (auto const & currPair : tempOwnersAndAmounts) {
-            //  Verify that the address is valid
-            CTxDestination dest = DecodeDestination(currPair.first);
-            if (IsValidDestination(dest)) {
-                ownersAndAmounts.insert(currPair);
-            }
-            else {
-                LogPrint(BCLog::REWARDS, "AddTokenOwnershipSnapshot: Address '%s' is invalid.\n", currPair.first.c_str());
+    auto writeChunk = [&]() {
+        //  Verify the addresses of the whole chunk before it is written
+        auto invalid = std::remove_if(chunk.begin(), chunk.end(), [](const std::pair<std::string, CAmount> & currPair) {
+            if (IsValidDestinationString(currPair.first))
+                return false;
+            LogPrint(BCLog::REWARDS, "AddTokenOwnershipSnapshot: Address '%s' is invalid.\n", currPair.first.c_str());
+            return true;
+        });
+        chunk.erase(invalid, chunk.end());
+
+        if (!chunk.empty()) {
+            if (!Write(std::make_pair(SNAPSHOT_OWNERS_FLAG, std::make_pair(snapshotEntry.heightAndName, snapshotEntry.nChunks)), chunk)) {
+                errorsOccurred = true;
+                return false;
             }
+            snapshotEntry.nChunks++;
+            ownerCount += chunk.size();
         }
+        chunk.clear();
+        return true;
+    };
 
-        tempOwnersAndAmounts.clear();
-    }
+    bool succeeded = ptokensdb->ForEachTokenAddress(p_tokenName, [&](const CTokenAddress & address, const CAmount & amount) {
+        //  The snapshots hold the owners as base58 strings for the reward payouts
+        chunk.emplace_back(address.ToString(), amount);
+        return chunk.size() < OWNERS_PER_SNAPSHOT_CHUNK || writeChunk();
+    });
+
+    if (succeeded)
+        succeeded = writeChunk();
 
-    if (errorsOccurred) {
+    if (!succeeded || errorsOccurred) {
         LogPrint(BCLog::REWARDS, "AddTokenOwnershipSnapshot: Errors occurred while acquiring ownership info for token '%s'.\n", p_tokenName.c_str());
         return false;
     }
-    if (ownersAndAmounts.size() == 0) {
+
+    //  Chunks left over from an earlier snapshot of the same token and height
+    EraseOwnershipChunks(snapshotEntry.heightAndName, snapshotEntry.nChunks);
+
+    if (ownerCount == 0) {
         LogPrint(BCLog::REWARDS, "AddTokenOwnershipSnapshot: No owners exist for token '%s'.\n", p_tokenName.c_str());
         return false;
     }
 
-    //  Write the snapshot to the database. We don't care if we overwrite, because it should be identical.
-    CTokenSnapshotDBEntry snapshotEntry(p_tokenName, p_height, ownersAndAmounts);
-
+    //  Write the snapshot to the database last, so it only exists once all of its chunks do.
+    //  We don't care if we overwrite, because it should be identical.
     if (Write(std::make_pair(SNAPSHOTCHECK_FLAG, snapshotEntry.heightAndName), snapshotEntry)) {
         LogPrint(BCLog::REWARDS, "AddTokenOwnershipSnapshot: Successfully added snapshot for '%s' at height %d (ownerCount = %d).\n",
-            p_tokenName.c_str(), p_height, ownersAndAmounts.size());
+            p_tokenName.c_str(), p_height, ownerCount);
         return true;
     }
     return false;
 }
 
-bool CTokenSnapshotDB::RetrieveOwnershipSnapshot(
+bool CTokenSnapshotDB::ReadOwnershipSnapshot(
     const std::string & p_tokenName, int p_height,
-    CTokenSnapshotDBEntry & p_snapshotEntry)
+    std::function<void(const std::string &, CAmount)> p_func)
 {
     //  Load up the snapshot entries at this height
     std::string heightAndName = std::to_string(p_height) + p_tokenName;
@@ -121,7 +124,22 @@ bool CTokenSnapshotDB::RetrieveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), p_snapshotEntry);
+    CTokenSnapshotDBEntry snapshotEntry;
+    bool succeeded = Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), snapshotEntry);
+
+    if (succeeded) {
+        for (auto const & currPair : snapshotEntry.ownersAndAmounts) {
+            p_func(currPair.first, currPair.second);
+        }
+
+        std::vector<std::pair<std::string, CAmount>> chunk;
+        for (uint32_t i = 0; succeeded && i < snapshotEntry.nChunks; i++) {
+            succeeded = Read(std::make_pair(SNAPSHOT_OWNERS_FLAG, std::make_pair(heightAndName, i)), chunk);
+            for (auto const & currPair : chunk) {
+                p_func(currPair.first, currPair.second);
+            }
+        }
+    }
 
     LogPrint(BCLog::REWARDS, "%s : Retrieval of snapshot for '%s' %s!\n",
         __func__,
@@ -131,6 +149,35 @@ bool CTokenSnapshotDB::RetrieveOwnershipSnapshot(
     return succeeded;
 }
 
+bool CTokenSnapshotDB::RetrieveOwnershipSnapshot(
+    const std::string & p_tokenName, int p_height,
+    CTokenSnapshotDBEntry & p_snapshotEntry)
+{
+    std::set<std::pair<std::string, CAmount>> ownersAndAmounts;
+    if (!ReadOwnershipSnapshot(p_tokenName, p_height, [&](const std::string & address, CAmount amount) {
+            ownersAndAmounts.emplace(address, amount);
+        })) {
+        return false;
+    }
+
+    p_snapshotEntry = CTokenSnapshotDBEntry(p_tokenName, p_height, ownersAndAmounts);
+    return true;
+}
+
+bool CTokenSnapshotDB::OwnershipSnapshotExists(
+    const std::string & p_tokenName, int p_height)
+{
+    return Exists(std::make_pair(SNAPSHOTCHECK_FLAG, std::to_string(p_height) + p_tokenName));
+}
+
+void CTokenSnapshotDB::EraseOwnershipChunks(const std::string & p_heightAndName, uint32_t p_firstChunk)
+{
+    //  Chunks are written with consecutive indexes, so the first missing one is the end
+    for (uint32_t i = p_firstChunk; Exists(std::make_pair(SNAPSHOT_OWNERS_FLAG, std::make_pair(p_heightAndName, i))); i++) {
+        Erase(std::make_pair(SNAPSHOT_OWNERS_FLAG, std::make_pair(p_heightAndName, i)));
+    }
+}
+
 bool CTokenSnapshotDB::RemoveOwnershipSnapshot(
     const std::string & p_tokenName, int p_height)
 {
@@ -142,6 +189,7 @@ bool CTokenSnapshotDB::RemoveOwnershipSnapshot(
         heightAndName.c_str());
 
     bool succeeded = Erase(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), true);
+    EraseOwnershipChunks(heightAndName, 0);
 
     LogPrint(BCLog::REWARDS, "%s : Removal of snapshot for '%s' %s!\n",
         __func__,
@@ -6,11 +6,15 @@
 #ifndef TOKENSNAPSHOTDB_H
 #define TOKENSNAPSHOTDB_H
 
+#include <functional>
 #include <set>
 
 #include <dbwrapper.h>
 #include "amount.h"
 
+//  Number of owners stored together in one database entry of a snapshot
+static const unsigned int OWNERS_PER_SNAPSHOT_CHUNK = 1000;
+
 class CTokenSnapshotDBEntry
 {
 public:
@@ -21,6 +25,9 @@ public:
     //  Used as the DB key for the snapshot
     std::string heightAndName;
 
+    //  Number of chunks holding the owners, snapshots written before chunking keep them in ownersAndAmounts
+    uint32_t nChunks;
+
     CTokenSnapshotDBEntry();
     CTokenSnapshotDBEntry(
         const std::string & p_tokenName, const int p_snapshotHeight,
@@ -34,6 +41,7 @@ public:
         ownersAndAmounts.clear();
 
         heightAndName = "";
+        nChunks = 0;
     }
 
     bool operator<(const CTokenSnapshotDBEntry &rhs) const
@@ -51,6 +59,12 @@ public:
         READWRITE(tokenName);
         READWRITE(ownersAndAmounts);
         READWRITE(heightAndName);
+        if (ser_action.ForRead()) {
+            if (!s.empty())
+                ::Unserialize(s, nChunks);
+        } else {
+            ::Serialize(s, nChunks);
+        }
     }
 };
 
@@ -70,9 +84,22 @@ public:
         const std::string & p_tokenName, int p_height,
         CTokenSnapshotDBEntry & p_snapshotEntry);
 
+    //  Pass the entries at a specified height to p_func one by one, without keeping them in memory
+    bool ReadOwnershipSnapshot(
+        const std::string & p_tokenName, int p_height,
+        std::function<void(const std::string &, CAmount)> p_func);
+
+    //  Check for a snapshot at the specified height without reading its entries
+    bool OwnershipSnapshotExists(
+        const std::string & p_tokenName, int p_height);
+
     //  Remove the token snapshot at the specified height
     bool RemoveOwnershipSnapshot(
         const std::string & p_tokenName, int p_height);
+
+private:
+    //  Erase the owner chunks of a snapshot starting at p_firstChunk
+    void EraseOwnershipChunks(const std::string & p_heightAndName, uint32_t p_firstChunk);
 };
 
 
@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "tokentypes.h"
+#include "base58.h"
 #include "hash.h"
 
 int IntFromKnownTokenType(KnownTokenType type) {
@@ -14,6 +15,39 @@ KnownTokenType KnownTokenTypeFromInt(int nType) {
     return (KnownTokenType)nType;
 }
 
+CTokenAddress::CTokenAddress(const CTxDestination& dest)
+{
+    SetNull();
+    if (const CKeyID* keyID = boost::get<CKeyID>(&dest)) {
+        data[0] = TYPE_KEYID;
+        memcpy(data + 1, keyID->begin(), 20);
+    } else if (const CScriptID* scriptID = boost::get<CScriptID>(&dest)) {
+        data[0] = TYPE_SCRIPTID;
+        memcpy(data + 1, scriptID->begin(), 20);
+    }
+}
+
+CTokenAddress CTokenAddress::FromString(const std::string& strAddress)
+{
+    return CTokenAddress(DecodeDestination(strAddress));
+}
+
+CTxDestination CTokenAddress::Get() const
+{
+    uint160 hash;
+    memcpy(hash.begin(), data + 1, 20);
+    if (data[0] == TYPE_KEYID)
+        return CKeyID(hash);
+    if (data[0] == TYPE_SCRIPTID)
+        return CScriptID(hash);
+    return CNoDestination();
+}
+
+std::string CTokenAddress::ToString() const
+{
+    return EncodeDestination(Get());
+}
+
 uint256 CTokenCacheQualifierAddress::GetHash() {
     return Hash(tokenName.begin(), tokenName.end(), address.begin(), address.end());
 }
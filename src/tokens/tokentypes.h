@@ -6,11 +6,21 @@
 #ifndef PLBCOIN_NEWTOKEN_H
 #define PLBCOIN_NEWTOKEN_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include "amount.h"
+#include "memusage.h"
+#include "pubkey.h"
 #include "script/standard.h"
 #include "primitives/transaction.h"
 
@@ -96,6 +106,51 @@ bool ReadWriteTokenHash(Stream &s, Operation ser_action, std::string &strIPFSHas
     return false;
 };
 
+/**
+ * The destination of a token output the way the token caches and databases key it, the type of the destination
+ * followed by its hash: 21 bytes that are compared and hashed as they are. Only the RPC and UI code encode it to
+ * base58. Token scripts only pay to key and script hashes, other destinations are kept as the null address.
+ */
+class CTokenAddress
+{
+public:
+    static const unsigned char TYPE_NONE = 0;
+    static const unsigned char TYPE_KEYID = 1;
+    static const unsigned char TYPE_SCRIPTID = 2;
+    static const size_t SIZE = 21;
+
+    CTokenAddress() { SetNull(); }
+    explicit CTokenAddress(const CTxDestination& dest);
+
+    //! Decodes a base58 address, only meant for the addresses given to the RPC and UI code
+    static CTokenAddress FromString(const std::string& strAddress);
+
+    void SetNull() { memset(data, 0, sizeof(data)); }
+    bool IsNull() const { return data[0] == TYPE_NONE; }
+    unsigned char GetType() const { return data[0]; }
+
+    CTxDestination Get() const;
+    //! The base58 address, empty for the null address
+    std::string ToString() const;
+
+    const unsigned char* begin() const { return data; }
+    const unsigned char* end() const { return data + sizeof(data); }
+
+    friend bool operator==(const CTokenAddress& a, const CTokenAddress& b) { return memcmp(a.data, b.data, sizeof(a.data)) == 0; }
+    friend bool operator!=(const CTokenAddress& a, const CTokenAddress& b) { return !(a == b); }
+    friend bool operator<(const CTokenAddress& a, const CTokenAddress& b) { return memcmp(a.data, b.data, sizeof(a.data)) < 0; }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(FLATDATA(data));
+    }
+
+private:
+    unsigned char data[SIZE];
+};
+
 class CNewToken
 {
 public:
@@ -250,7 +305,22 @@ public:
     CTokenTransfer(const std::string& strTokenName, const CAmount& nAmount, const uint32_t& nTimeLock, const std::string& message = "", const int64_t& nExpireTime = 0);
     bool IsValid(std::string& strError) const;
     void ConstructTransaction(CScript& script) const;
-    bool ContextualCheckAgainstVerifyString(CTokensCache *tokenCache, const std::string& address, std::string& strError) const;
+    bool ContextualCheckAgainstVerifyString(CTokensCache *tokenCache, const CTokenAddress& address, std::string& strError) const;
+};
+
+/** The token data of an output, as decoded by GetTokenData */
+struct CTokenOutputEntry
+{
+    txnouttype type = TX_NONSTANDARD;
+    txnouttype scriptType = TX_NONSTANDARD;
+    std::string tokenName;
+    CTxDestination destination;
+    CTokenAddress address; //!< destination the way the token caches key it
+    CAmount nAmount = 0;
+    uint32_t nTimeLock = 0;
+    std::string message;
+    int64_t expireTime = 0;
+    int vout = -1;
 };
 
 class CReissueToken
@@ -368,11 +438,11 @@ public:
 struct CTokenCacheNewToken
 {
     CNewToken token;
-    std::string address;
+    CTokenAddress address;
     uint256 blockHash;
     int blockHeight;
 
-    CTokenCacheNewToken(const CNewToken& token, const std::string& address, const int& blockHeight, const uint256& blockHash)
+    CTokenCacheNewToken(const CNewToken& token, const CTokenAddress& address, const int& blockHeight, const uint256& blockHash)
     {
         this->token = token;
         this->address = address;
@@ -389,13 +459,13 @@ struct CTokenCacheNewToken
 struct CTokenCacheReissueToken
 {
     CReissueToken reissue;
-    std::string address;
+    CTokenAddress address;
     COutPoint out;
     uint256 blockHash;
     int blockHeight;
 
 
-    CTokenCacheReissueToken(const CReissueToken& reissue, const std::string& address, const COutPoint& out, const int& blockHeight, const uint256& blockHash)
+    CTokenCacheReissueToken(const CReissueToken& reissue, const CTokenAddress& address, const COutPoint& out, const int& blockHeight, const uint256& blockHash)
     {
         this->reissue = reissue;
         this->address = address;
@@ -414,10 +484,10 @@ struct CTokenCacheReissueToken
 struct CTokenCacheNewTransfer
 {
     CTokenTransfer transfer;
-    std::string address;
+    CTokenAddress address;
     COutPoint out;
 
-    CTokenCacheNewTransfer(const CTokenTransfer& transfer, const std::string& address, const COutPoint& out)
+    CTokenCacheNewTransfer(const CTokenTransfer& transfer, const CTokenAddress& address, const COutPoint& out)
     {
         this->transfer = transfer;
         this->address = address;
@@ -433,9 +503,9 @@ struct CTokenCacheNewTransfer
 struct CTokenCacheNewOwner
 {
     std::string tokenName;
-    std::string address;
+    CTokenAddress address;
 
-    CTokenCacheNewOwner(const std::string& tokenName, const std::string& address)
+    CTokenCacheNewOwner(const std::string& tokenName, const CTokenAddress& address)
     {
         this->tokenName = tokenName;
         this->address = address;
@@ -451,10 +521,10 @@ struct CTokenCacheNewOwner
 struct CTokenCacheUndoTokenAmount
 {
     std::string tokenName;
-    std::string address;
+    CTokenAddress address;
     CAmount nAmount;
 
-    CTokenCacheUndoTokenAmount(const std::string& tokenName, const std::string& address, const CAmount& nAmount)
+    CTokenCacheUndoTokenAmount(const std::string& tokenName, const CTokenAddress& address, const CAmount& nAmount)
     {
         this->tokenName = tokenName;
         this->address = address;
@@ -465,10 +535,10 @@ struct CTokenCacheUndoTokenAmount
 struct CTokenCacheSpendToken
 {
     std::string tokenName;
-    std::string address;
+    CTokenAddress address;
     CAmount nAmount;
 
-    CTokenCacheSpendToken(const std::string& tokenName, const std::string& address, const CAmount& nAmount)
+    CTokenCacheSpendToken(const std::string& tokenName, const CTokenAddress& address, const CAmount& nAmount)
     {
         this->tokenName = tokenName;
         this->address = address;
@@ -478,10 +548,10 @@ struct CTokenCacheSpendToken
 
 struct CTokenCacheQualifierAddress {
     std::string tokenName;
-    std::string address;
+    CTokenAddress address;
     QualifierType type;
 
-    CTokenCacheQualifierAddress(const std::string &tokenName, const std::string &address, const QualifierType &type) {
+    CTokenCacheQualifierAddress(const std::string &tokenName, const CTokenAddress& address, const QualifierType &type) {
         this->tokenName = tokenName;
         this->address = address;
         this->type = type;
@@ -496,9 +566,9 @@ struct CTokenCacheQualifierAddress {
 
 struct CTokenCacheRootQualifierChecker {
     std::string rootTokenName;
-    std::string address;
+    CTokenAddress address;
 
-    CTokenCacheRootQualifierChecker(const std::string &tokenName, const std::string &address) {
+    CTokenCacheRootQualifierChecker(const std::string &tokenName, const CTokenAddress& address) {
         this->rootTokenName = tokenName;
         this->address = address;
     }
@@ -513,10 +583,10 @@ struct CTokenCacheRootQualifierChecker {
 struct CTokenCacheRestrictedAddress
 {
     std::string tokenName;
-    std::string address;
+    CTokenAddress address;
     RestrictedType type;
 
-    CTokenCacheRestrictedAddress(const std::string& tokenName, const std::string& address, const RestrictedType& type)
+    CTokenCacheRestrictedAddress(const std::string& tokenName, const CTokenAddress& address, const RestrictedType& type)
     {
         this->tokenName = tokenName;
         this->address = address;
@@ -567,81 +637,426 @@ struct CTokenCacheRestrictedVerifiers
     }
 };
 
-// Least Recently Used Cache
+// Memory owned by the token cache entries, on top of the containers holding them
+static inline size_t RecursiveDynamicUsage(const std::string& str) {
+    return memusage::DynamicUsage(str);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenAddress&) {
+    return 0;
+}
+
+static inline size_t RecursiveDynamicUsage(const int8_t&) {
+    return 0;
+}
+
+static inline size_t RecursiveDynamicUsage(const int&) {
+    return 0;
+}
+
+static inline size_t RecursiveDynamicUsage(const CNewToken& token) {
+    return memusage::DynamicUsage(token.strName) + memusage::DynamicUsage(token.strIPFSHash) + memusage::DynamicUsage(token.nRoyaltiesAddress);
+}
+
+static inline size_t RecursiveDynamicUsage(const CDatabasedTokenData& data) {
+    return RecursiveDynamicUsage(data.token);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenTransfer& transfer) {
+    return memusage::DynamicUsage(transfer.strName) + memusage::DynamicUsage(transfer.message);
+}
+
+static inline size_t RecursiveDynamicUsage(const CReissueToken& reissue) {
+    return memusage::DynamicUsage(reissue.strName) + memusage::DynamicUsage(reissue.strIPFSHash) + memusage::DynamicUsage(reissue.nRoyaltiesAddress);
+}
+
+static inline size_t RecursiveDynamicUsage(const CNullTokenTxVerifierString& verifier) {
+    return memusage::DynamicUsage(verifier.verifier_string);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheNewToken& newToken) {
+    return RecursiveDynamicUsage(newToken.token);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheReissueToken& reissue) {
+    return RecursiveDynamicUsage(reissue.reissue);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheNewTransfer& transfer) {
+    return RecursiveDynamicUsage(transfer.transfer);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheNewOwner& owner) {
+    return memusage::DynamicUsage(owner.tokenName);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheUndoTokenAmount& undo) {
+    return memusage::DynamicUsage(undo.tokenName);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheSpendToken& spend) {
+    return memusage::DynamicUsage(spend.tokenName);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheQualifierAddress& qualifier) {
+    return memusage::DynamicUsage(qualifier.tokenName);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheRootQualifierChecker& checker) {
+    return memusage::DynamicUsage(checker.rootTokenName);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheRestrictedAddress& restricted) {
+    return memusage::DynamicUsage(restricted.tokenName);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheRestrictedGlobal& global) {
+    return memusage::DynamicUsage(global.tokenName);
+}
+
+static inline size_t RecursiveDynamicUsage(const CTokenCacheRestrictedVerifiers& verifier) {
+    return memusage::DynamicUsage(verifier.tokenName) + memusage::DynamicUsage(verifier.verifier);
+}
+
+static inline size_t RecursiveDynamicUsage(const int64_t&) {
+    return 0;
+}
+
+template<typename X>
+static inline size_t RecursiveDynamicUsage(const std::set<X>& entries) {
+    size_t usage = memusage::DynamicUsage(entries);
+    for (const auto& entry : entries)
+        usage += RecursiveDynamicUsage(entry);
+    return usage;
+}
+
+template<typename X, typename Y>
+static inline size_t RecursiveDynamicUsage(const std::pair<X, Y>& pair) {
+    return RecursiveDynamicUsage(pair.first) + RecursiveDynamicUsage(pair.second);
+}
+
+// A set of token cache entries that adds up their memory as they are inserted and erased, the way
+// CCoinsViewCache keeps cachedCoinsUsage, so reading the usage doesn't walk the set
+template<typename T>
+class CTokenCacheSet
+{
+private:
+    std::set<T> entries;
+    size_t nUsage;
+
+    static size_t EntryUsage(const std::set<T>& set, const T& entry) {
+        return memusage::IncrementalDynamicUsage(set) + RecursiveDynamicUsage(entry);
+    }
+
+public:
+    typedef typename std::set<T>::const_iterator const_iterator;
+
+    CTokenCacheSet() : nUsage(0) {}
+
+    // Copies may hold their strings in less memory, so the usage is counted again
+    CTokenCacheSet(const CTokenCacheSet& other) : entries(other.entries), nUsage(RecursiveDynamicUsage(entries)) {}
+
+    CTokenCacheSet& operator=(const CTokenCacheSet& other) {
+        entries = other.entries;
+        nUsage = RecursiveDynamicUsage(entries);
+        return *this;
+    }
+
+    operator const std::set<T>&() const { return entries; }
+
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    const_iterator find(const T& entry) const { return entries.find(entry); }
+    size_t count(const T& entry) const { return entries.count(entry); }
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    std::pair<const_iterator, bool> insert(const T& entry) {
+        auto ret = entries.insert(entry);
+        if (ret.second)
+            nUsage += EntryUsage(entries, *ret.first);
+        return ret;
+    }
+
+    size_t erase(const T& entry) {
+        auto it = entries.find(entry);
+        if (it == entries.end())
+            return 0;
+        nUsage -= EntryUsage(entries, *it);
+        entries.erase(it);
+        return 1;
+    }
+
+    void clear() {
+        entries.clear();
+        nUsage = 0;
+    }
+
+    size_t DynamicMemoryUsage() const { return nUsage; }
+};
+
+// The map counterpart of CTokenCacheSet. Values that own memory can only be changed through Set and Modify,
+// which count them again, plain numbers can also be changed through at and operator[]
+template<typename K, typename V>
+class CTokenCacheMap
+{
+private:
+    std::map<K, V> entries;
+    size_t nUsage;
+
+    static size_t EntryUsage(const std::map<K, V>& map, const std::pair<const K, V>& entry) {
+        return memusage::IncrementalDynamicUsage(map) + RecursiveDynamicUsage(entry);
+    }
+
+    static size_t Usage(const std::map<K, V>& map) {
+        size_t usage = memusage::DynamicUsage(map);
+        for (const auto& entry : map)
+            usage += RecursiveDynamicUsage(entry);
+        return usage;
+    }
+
+public:
+    typedef typename std::map<K, V>::const_iterator const_iterator;
+    typedef typename std::map<K, V>::value_type value_type;
+
+    CTokenCacheMap() : nUsage(0) {}
+
+    // Copies may hold their strings in less memory, so the usage is counted again
+    CTokenCacheMap(const CTokenCacheMap& other) : entries(other.entries), nUsage(Usage(entries)) {}
+
+    CTokenCacheMap& operator=(const CTokenCacheMap& other) {
+        entries = other.entries;
+        nUsage = Usage(entries);
+        return *this;
+    }
+
+    operator const std::map<K, V>&() const { return entries; }
+
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    const_iterator find(const K& key) const { return entries.find(key); }
+    size_t count(const K& key) const { return entries.count(key); }
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    const V& at(const K& key) const { return entries.at(key); }
+
+    template<typename U = V>
+    typename std::enable_if<std::is_arithmetic<U>::value, U&>::type at(const K& key) {
+        return entries.at(key);
+    }
+
+    template<typename U = V>
+    typename std::enable_if<std::is_arithmetic<U>::value, U&>::type operator[](const K& key) {
+        return insert(std::make_pair(key, V())).first->second;
+    }
+
+    std::pair<typename std::map<K, V>::iterator, bool> insert(const value_type& entry) {
+        auto ret = entries.insert(entry);
+        if (ret.second)
+            nUsage += EntryUsage(entries, *ret.first);
+        return ret;
+    }
+
+    void Set(const K& key, const V& value) {
+        Modify(key, [&value](V& entry) { entry = value; });
+    }
+
+    // Apply f to the value at key, adding a default value first if the key is missing
+    template<typename F>
+    void Modify(const K& key, F f) {
+        auto it = entries.find(key);
+        if (it == entries.end())
+            it = entries.emplace(key, V()).first;
+        else
+            nUsage -= EntryUsage(entries, *it);
+        f(it->second);
+        nUsage += EntryUsage(entries, *it);
+    }
+
+    size_t erase(const K& key) {
+        auto it = entries.find(key);
+        if (it == entries.end())
+            return 0;
+        nUsage -= EntryUsage(entries, *it);
+        entries.erase(it);
+        return 1;
+    }
+
+    void clear() {
+        entries.clear();
+        nUsage = 0;
+    }
+
+    size_t DynamicMemoryUsage() const { return nUsage; }
+};
+
+// The vector counterpart of CTokenCacheSet, entries are only appended until the vector is cleared
+template<typename T>
+class CTokenCacheVector
+{
+private:
+    std::vector<T> entries;
+    size_t nUsage;
+
+public:
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    CTokenCacheVector() : nUsage(0) {}
+
+    CTokenCacheVector(const CTokenCacheVector& other) : entries(other.entries), nUsage(0) {
+        for (const auto& entry : entries)
+            nUsage += RecursiveDynamicUsage(entry);
+    }
+
+    CTokenCacheVector& operator=(const CTokenCacheVector& other) {
+        entries = other.entries;
+        nUsage = 0;
+        for (const auto& entry : entries)
+            nUsage += RecursiveDynamicUsage(entry);
+        return *this;
+    }
+
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    void push_back(const T& entry) {
+        entries.push_back(entry);
+        nUsage += RecursiveDynamicUsage(entries.back());
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        entries.emplace_back(std::forward<Args>(args)...);
+        nUsage += RecursiveDynamicUsage(entries.back());
+    }
+
+    void clear() {
+        entries.clear();
+        nUsage = 0;
+    }
+
+    size_t DynamicMemoryUsage() const { return nUsage + memusage::DynamicUsage(entries); }
+};
+
+//! Number of independently locked shards of a CLRUCache
+static const size_t DEFAULT_LRU_CACHE_SHARDS = 16;
+
+// Least Recently Used Cache, bounded by the memory its entries use (in bytes) and split into independently
+// locked shards, so it can be used from several threads. Keys known to be missing can be cached as well.
 template<typename cache_key_t, typename cache_value_t>
 class CLRUCache
 {
-public:
-    typedef typename std::pair<cache_key_t, cache_value_t> key_value_pair_t;
-    typedef typename std::list<key_value_pair_t>::iterator list_iterator_t;
+private:
+    struct CacheEntry
+    {
+        cache_key_t key;
+        cache_value_t value;
+        bool fMissing;
+        size_t nUsage;
+    };
+
+    typedef typename std::list<CacheEntry>::iterator list_iterator_t;
 
-    CLRUCache(size_t max_size) : maxSize(max_size)
+    struct CacheShard
     {
-    }
-    CLRUCache()
+        std::mutex mutex;
+        std::list<CacheEntry> cacheItemsList;
+        std::unordered_map<cache_key_t, list_iterator_t> cacheItemsMap;
+        size_t nUsage = 0;
+    };
+
+public:
+    explicit CLRUCache(size_t max_size, size_t nShards = DEFAULT_LRU_CACHE_SHARDS)
+        : maxSize(max_size), shards(std::max<size_t>(nShards, 1)), nHits(0), nMisses(0), nEvictions(0)
     {
-        SetNull();
     }
 
+    CLRUCache(const CLRUCache&) = delete;
+    CLRUCache& operator=(const CLRUCache&) = delete;
+
+    //! Cache value for key, replacing what was cached for it
     void Put(const cache_key_t& key, const cache_value_t& value)
     {
-        auto it = cacheItemsMap.find(key);
-        cacheItemsList.push_front(key_value_pair_t(key, value));
-        if (it != cacheItemsMap.end())
-        {
-            cacheItemsList.erase(it->second);
-            cacheItemsMap.erase(it);
-        }
-        cacheItemsMap[key] = cacheItemsList.begin();
-
-        if (cacheItemsMap.size() > maxSize)
-        {
-            auto last = cacheItemsList.end();
-            last--;
-            cacheItemsMap.erase(last->first);
-            cacheItemsList.pop_back();
-        }
+        Insert(key, value, false);
+    }
+
+    //! Cache that key doesn't exist, until it is Put or Erased
+    void PutMissing(const cache_key_t& key)
+    {
+        Insert(key, cache_value_t(), true);
     }
 
     void Erase(const cache_key_t& key)
     {
-        auto it = cacheItemsMap.find(key);
-        if (it != cacheItemsMap.end())
-        {
-            cacheItemsList.erase(it->second);
-            cacheItemsMap.erase(it);
-        }
+        CacheShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.cacheItemsMap.find(key);
+        if (it != shard.cacheItemsMap.end())
+            Remove(shard, it->second);
     }
 
-    const cache_value_t& Get(const cache_key_t& key)
+    //! Returns false if nothing is cached for key. Otherwise makes key the most recently used and returns true,
+    //! with fMissing set if key is cached as missing, and value set if it isn't.
+    bool TryGet(const cache_key_t& key, cache_value_t& value, bool& fMissing)
     {
-        auto it = cacheItemsMap.find(key);
-        if (it == cacheItemsMap.end())
-        {
-            throw std::range_error("There is no such key in cache");
-        }
-        else
-        {
-            cacheItemsList.splice(cacheItemsList.begin(), cacheItemsList, it->second);
-            return it->second->second;
+        CacheShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.cacheItemsMap.find(key);
+        if (it == shard.cacheItemsMap.end()) {
+            nMisses++;
+            return false;
         }
+
+        nHits++;
+        shard.cacheItemsList.splice(shard.cacheItemsList.begin(), shard.cacheItemsList, it->second);
+        fMissing = it->second->fMissing;
+        if (!fMissing)
+            value = it->second->value;
+        return true;
+    }
+
+    //! Returns true and sets value if a value is cached for key
+    bool TryGet(const cache_key_t& key, cache_value_t& value)
+    {
+        bool fMissing = false;
+        return TryGet(key, value, fMissing) && !fMissing;
     }
 
+    //! Whether a value is cached for key, doesn't change the order of use
     bool Exists(const cache_key_t& key) const
     {
-        return cacheItemsMap.find(key) != cacheItemsMap.end();
+        CacheShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.cacheItemsMap.find(key);
+        if (it == shard.cacheItemsMap.end()) {
+            nMisses++;
+            return false;
+        }
+
+        nHits++;
+        return !it->second->fMissing;
     }
 
     size_t Size() const
     {
-        return cacheItemsMap.size();
+        size_t size = 0;
+        for (CacheShard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size += shard.cacheItemsMap.size();
+        }
+        return size;
     }
 
-
     void Clear()
     {
-        cacheItemsMap.clear();
-        cacheItemsList.clear();
+        for (CacheShard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.cacheItemsMap.clear();
+            shard.cacheItemsList.clear();
+            shard.nUsage = 0;
+        }
     }
 
     void SetNull()
@@ -650,39 +1065,81 @@ public:
         Clear();
     }
 
+    //! The memory the entries may use, in bytes
     size_t MaxSize() const
     {
         return maxSize;
     }
 
-
+    //! Change the memory the entries may use, applied by the next Put
     void SetSize(const size_t size)
     {
         maxSize = size;
     }
 
-   const std::unordered_map<cache_key_t, list_iterator_t>& GetItemsMap()
+    //! Memory used by the cache, including the keys and values it owns
+    size_t DynamicMemoryUsage() const
     {
-        return cacheItemsMap;
-    };
+        size_t usage = 0;
+        for (CacheShard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            usage += shard.nUsage + memusage::MallocUsage(sizeof(void*) * shard.cacheItemsMap.bucket_count());
+        }
+        return usage;
+    }
 
-    const std::list<key_value_pair_t>& GetItemsList()
+    //! Lookups that found an entry, lookups that didn't and entries removed to stay within MaxSize
+    void GetStats(uint64_t& hits, uint64_t& misses, uint64_t& evictions) const
     {
-        return cacheItemsList;
-    };
+        hits = nHits;
+        misses = nMisses;
+        evictions = nEvictions;
+    }
 
+private:
+    std::atomic<size_t> maxSize; // Read by Put in every shard, SetSize may change it meanwhile
+    mutable std::vector<CacheShard> shards;
 
-    CLRUCache(const CLRUCache& cache)
+    mutable std::atomic<uint64_t> nHits;
+    mutable std::atomic<uint64_t> nMisses;
+    std::atomic<uint64_t> nEvictions;
+
+    CacheShard& GetShard(const cache_key_t& key) const
     {
-        this->cacheItemsList = cache.cacheItemsList;
-        this->cacheItemsMap = cache.cacheItemsMap;
-        this->maxSize = cache.maxSize;
+        return shards[std::hash<cache_key_t>()(key) % shards.size()];
     }
 
-private:
-    std::list<key_value_pair_t> cacheItemsList;
-    std::unordered_map<cache_key_t, list_iterator_t> cacheItemsMap;
-    size_t maxSize;
+    void Insert(const cache_key_t& key, const cache_value_t& value, bool fMissing)
+    {
+        size_t nUsage = memusage::MallocUsage(sizeof(memusage::stl_list_node<CacheEntry>)) +
+                memusage::MallocUsage(sizeof(memusage::unordered_node<std::pair<const cache_key_t, list_iterator_t> >)) +
+                2 * RecursiveDynamicUsage(key) + (fMissing ? 0 : RecursiveDynamicUsage(value)); // The key is stored in the list and in the map
+
+        CacheShard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.cacheItemsMap.find(key);
+        if (it != shard.cacheItemsMap.end())
+            Remove(shard, it->second);
+
+        shard.cacheItemsList.push_front(CacheEntry{key, value, fMissing, nUsage});
+        shard.cacheItemsMap.emplace(key, shard.cacheItemsList.begin());
+        shard.nUsage += nUsage;
+
+        // Each shard gets an equal part of the memory. The entry just inserted stays even if it doesn't fit on its
+        // own, or a small budget would turn the cache into a pass-through.
+        size_t nShardSize = maxSize.load() / shards.size();
+        while (shard.nUsage > nShardSize && shard.cacheItemsList.size() > 1) {
+            Remove(shard, std::prev(shard.cacheItemsList.end()));
+            nEvictions++;
+        }
+    }
+
+    void Remove(CacheShard& shard, list_iterator_t item)
+    {
+        shard.nUsage -= item->nUsage;
+        shard.cacheItemsMap.erase(item->key);
+        shard.cacheItemsList.erase(item);
+    }
 };
 
 #endif //PLBCOIN_NEWTOKEN_H
@@ -19,6 +19,8 @@
 
 #include <stdint.h>
 
+#include <set>
+
 #include <boost/thread.hpp>
 
 static const char DB_COIN = 'C';
@@ -27,6 +29,7 @@ static const char DB_BLOCK_FILES = 'f';
 static const char DB_TXINDEX = 't';
 static const char DB_ADDRESSINDEX = 'a';
 static const char DB_ADDRESSUNSPENTINDEX = 'u';
+static const char DB_ADDRESSBALANCEINDEX = 'A';
 static const char DB_TIMESTAMPINDEX = 's';
 static const char DB_BLOCKHASHINDEX = 'z';
 static const char DB_SPENTINDEX = 'p';
@@ -60,6 +63,22 @@ struct CoinEntry {
     }
 };
 
+//! The serialized bytes of a key, whatever type it was written with
+struct RawKey {
+    std::vector<char> data;
+
+    template<typename Stream>
+    void Serialize(Stream &s) const {
+        s.write(data.data(), data.size());
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        data.resize(s.size());
+        s.read(data.data(), data.size());
+    }
+};
+
 }
 
 CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true, 2 << 20)
@@ -255,12 +274,130 @@ bool CBlockTreeDB::WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos>
     return WriteBatch(batch);
 }
 
-bool CBlockTreeDB::ReadSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value) {
+bool CBlockTreeDB::WriteFlag(const std::string &name, bool fValue) {
+    return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
+}
+
+bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
+    char ch;
+    if (!Read(std::make_pair(DB_FLAG, name), ch))
+        return false;
+    fValue = ch == '1';
+    return true;
+}
+
+bool CBlockTreeDB::EraseMovedIndexes(const std::atomic<bool>* pfInterrupt) {
+    static const size_t BATCH_SIZE = 16 << 20;
+
+    for (const char prefix : {DB_ADDRESSINDEX, DB_ADDRESSUNSPENTINDEX, DB_TIMESTAMPINDEX, DB_BLOCKHASHINDEX, DB_SPENTINDEX}) {
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        CDBBatch batch(*this);
+        size_t nErased = 0;
+        for (pcursor->Seek(prefix); pcursor->Valid(); pcursor->Next()) {
+            if (pfInterrupt && *pfInterrupt)
+                break;
+            RawKey key;
+            if (!pcursor->GetKey(key) || key.data.empty() || key.data[0] != prefix)
+                break;
+            batch.Erase(key);
+            nErased++;
+            if (batch.SizeEstimate() > BATCH_SIZE) {
+                if (!WriteBatch(batch))
+                    return false;
+                batch.Clear();
+            }
+        }
+        if (!WriteBatch(batch))
+            return false;
+
+        if (nErased) {
+            LogPrintf("%s: Erased %u rows of the '%c' index moved to the index database\n", __func__, nErased, prefix);
+            CompactRange(prefix, (char)(prefix + 1));
+        }
+        if (pfInterrupt && *pfInterrupt)
+            return true;
+    }
+    return true;
+}
+
+bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
+
+    // Load mapBlockIndex
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char, uint256> key;
+        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
+            CDiskBlockIndex diskindex;
+            if (pcursor->GetValue(diskindex)) {
+                // Construct block index object
+                CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetIndexHash());
+                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
+                pindexNew->nHeight        = diskindex.nHeight;
+                pindexNew->nFile          = diskindex.nFile;
+                pindexNew->nDataPos       = diskindex.nDataPos;
+                pindexNew->nUndoPos       = diskindex.nUndoPos;
+                pindexNew->nVersion       = diskindex.nVersion;
+                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+                pindexNew->nTime          = diskindex.nTime;
+                pindexNew->nBits          = diskindex.nBits;
+                pindexNew->nStatus        = diskindex.nStatus;
+                pindexNew->nTx            = diskindex.nTx;
+                pindexNew->nStakeModifier = diskindex.nStakeModifier;
+                pindexNew->nNonce         = diskindex.nNonce;
+
+                pcursor->Next();
+            } else {
+                return error("%s: failed to read value", __func__);
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
+
+CIndexesDB::CIndexesDB(size_t nCacheSize, bool fMemory, bool fWipe, size_t maxFileSize) : CDBWrapper(GetDataDir() / "indexes", nCacheSize, fMemory, fWipe, false, maxFileSize) {
+}
+
+uint256 CIndexesDB::GetBestBlock() const {
+    uint256 hashBestBlock;
+    if (!Read(DB_BEST_BLOCK, hashBestBlock))
+        return uint256();
+    return hashBestBlock;
+}
+
+void CIndexesDB::WriteBestBlock(CDBBatch& batch, const uint256& hashBlock) {
+    batch.Write(DB_BEST_BLOCK, hashBlock);
+}
+
+bool CIndexesDB::WriteFlag(const std::string &name, bool fValue) {
+    return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
+}
+
+bool CIndexesDB::ReadFlag(const std::string &name, bool &fValue) {
+    char ch;
+    if (!Read(std::make_pair(DB_FLAG, name), ch))
+        return false;
+    fValue = ch == '1';
+    return true;
+}
+
+bool CIndexesDB::ReadSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value) {
     return Read(std::make_pair(DB_SPENTINDEX, key), value);
 }
 
-bool CBlockTreeDB::UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect) {
+bool CIndexesDB::UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect) {
     CDBBatch batch(*this);
+    UpdateSpentIndex(batch, vect);
+    return WriteBatch(batch);
+}
+
+void CIndexesDB::UpdateSpentIndex(CDBBatch& batch, const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect) {
     for (std::vector<std::pair<CSpentIndexKey,CSpentIndexValue> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
         if (it->second.IsNull()) {
             batch.Erase(std::make_pair(DB_SPENTINDEX, it->first));
@@ -268,11 +405,15 @@ bool CBlockTreeDB::UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey,
             batch.Write(std::make_pair(DB_SPENTINDEX, it->first), it->second);
         }
     }
-    return WriteBatch(batch);
 }
 
-bool CBlockTreeDB::UpdateAddressUnspentIndex(const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue > >&vect) {
+bool CIndexesDB::UpdateAddressUnspentIndex(const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue > >&vect) {
     CDBBatch batch(*this);
+    UpdateAddressUnspentIndex(batch, vect);
+    return WriteBatch(batch);
+}
+
+void CIndexesDB::UpdateAddressUnspentIndex(CDBBatch& batch, const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue > >&vect) {
     for (std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
         if (it->second.IsNull()) {
             batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, it->first));
@@ -280,55 +421,169 @@ bool CBlockTreeDB::UpdateAddressUnspentIndex(const std::vector<std::pair<CAddres
             batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, it->first), it->second);
         }
     }
-    return WriteBatch(batch);
 }
 
-bool CBlockTreeDB::ReadAddressUnspentIndex(uint160 addressHash, int type, std::string tokenName,
-                                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs) {
+// Key just past the unspent outputs of an address for one token, no output of it sorts after
+static CAddressUnspentKey AddressUnspentTokenEnd(int type, const uint160& addressHash, const std::string& tokenName)
+{
+    return CAddressUnspentKey(type, addressHash, tokenName, uint256S(std::string(64, 'f')), 0xffffffff, -1);
+}
+
+bool CIndexesDB::ReadAddressUnspentIndex(uint160 addressHash, int type, const std::string& tokenName, bool fExcludePLB, const CAddressUnspentKey* pafter,
+                                         std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)> func) {
 
     boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
 
-    pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorTokenKey(type, addressHash, tokenName)));
+    if (pafter) {
+        pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, *pafter));
+    } else if (!tokenName.empty()) {
+        pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorTokenKey(type, addressHash, tokenName)));
+    } else {
+        pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorKey(type, addressHash)));
+    }
 
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
         std::pair<char,CAddressUnspentKey> key;
-        if (pcursor->GetKey(key) && key.first == DB_ADDRESSUNSPENTINDEX && key.second.hashBytes == addressHash
-                && (tokenName.empty() || key.second.token == tokenName)) {
-            CAddressUnspentValue nValue;
-            if (pcursor->GetValue(nValue)) {
-                unspentOutputs.push_back(std::make_pair(key.second, nValue));
-                pcursor->Next();
-            } else {
-                return error("failed to get address unspent value");
-            }
-        } else {
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSUNSPENTINDEX || key.second.type != (unsigned int)type || key.second.hashBytes != addressHash
+                || (!tokenName.empty() && key.second.token != tokenName)) {
             break;
         }
+
+        if (pafter && key.second.txhash == pafter->txhash && key.second.index == pafter->index && key.second.token == pafter->token) {
+            pcursor->Next();
+            continue;
+        }
+
+        // The PLB outputs are skipped with a single seek
+        if (fExcludePLB && key.second.token == PLB) {
+            pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, AddressUnspentTokenEnd(type, addressHash, PLB)));
+            continue;
+        }
+
+        CAddressUnspentValue nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("failed to get address unspent value");
+        if (!func(key.second, nValue))
+            break;
+        pcursor->Next();
     }
 
     return true;
 }
 
-bool CBlockTreeDB::ReadAddressUnspentIndex(uint160 addressHash, int type,
+bool CIndexesDB::ReadAddressUnspentIndex(uint160 addressHash, int type, std::string tokenName,
+                                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs) {
+    return ReadAddressUnspentIndex(addressHash, type, tokenName, false, nullptr, [&unspentOutputs](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+        unspentOutputs.push_back(std::make_pair(key, value));
+        return true;
+    });
+}
+
+bool CIndexesDB::ReadAddressUnspentIndex(uint160 addressHash, int type,
                                            std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs) {
 
+    return ReadAddressUnspentIndex(addressHash, type, "", true, nullptr, [&unspentOutputs](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+        unspentOutputs.push_back(std::make_pair(key, value));
+        return true;
+    });
+}
+
+typedef std::map<CAddressIndexIteratorTokenKey, CAddressBalanceValue> AddressBalanceMap;
+
+// Adds the delta of an address index entry to the balance of its address and token, reading the balance first if needed
+static void AddAddressBalanceDelta(const CDBWrapper& db, AddressBalanceMap& mapBalances, const CAddressIndexKey& key, const CAmount& nValue, bool fUndo)
+{
+    CAddressIndexIteratorTokenKey balanceKey(key.type, key.hashBytes, key.token);
+    AddressBalanceMap::iterator it = mapBalances.find(balanceKey);
+    if (it == mapBalances.end()) {
+        CAddressBalanceValue balance;
+        if (!db.Read(std::make_pair(DB_ADDRESSBALANCEINDEX, balanceKey), balance))
+            balance.SetNull();
+        it = mapBalances.emplace(balanceKey, balance).first;
+    }
+    it->second.AddDelta(nValue, key.timeLock, fUndo);
+}
+
+static void WriteAddressBalances(CDBBatch& batch, const AddressBalanceMap& mapBalances)
+{
+    for (const auto& balance : mapBalances) {
+        if (balance.second.IsNull())
+            batch.Erase(std::make_pair(DB_ADDRESSBALANCEINDEX, balance.first));
+        else
+            batch.Write(std::make_pair(DB_ADDRESSBALANCEINDEX, balance.first), balance.second);
+    }
+}
+
+bool CIndexesDB::WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect, bool fBalanceIndex) {
+    CDBBatch batch(*this);
+    WriteAddressIndex(batch, vect, fBalanceIndex);
+    return WriteBatch(batch);
+}
+
+void CIndexesDB::WriteAddressIndex(CDBBatch& batch, const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect, bool fBalanceIndex) {
+    AddressBalanceMap mapBalances;
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
+        // Only entries that aren't in the index yet change the balances, a block connected again after an
+        // unclean shutdown rewrites its entries and mustn't be counted twice
+        if (fBalanceIndex && !Exists(std::make_pair(DB_ADDRESSINDEX, it->first))) {
+            AddAddressBalanceDelta(*this, mapBalances, it->first, it->second, false);
+        }
+        batch.Write(std::make_pair(DB_ADDRESSINDEX, it->first), it->second);
+    }
+    WriteAddressBalances(batch, mapBalances);
+}
+
+bool CIndexesDB::EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect, bool fBalanceIndex) {
+    CDBBatch batch(*this);
+    EraseAddressIndex(batch, vect, fBalanceIndex);
+    return WriteBatch(batch);
+}
+
+void CIndexesDB::EraseAddressIndex(CDBBatch& batch, const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect, bool fBalanceIndex) {
+    AddressBalanceMap mapBalances;
+    std::set<std::vector<unsigned char> > setErased;
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++) {
+        // The stored delta is taken away rather than the one passed in, and only once per entry, so the balances
+        // always add up to the entries left in the index
+        CAmount nValue;
+        if (fBalanceIndex && Read(std::make_pair(DB_ADDRESSINDEX, it->first), nValue)) {
+            CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+            ssKey << it->first;
+            if (setErased.insert(std::vector<unsigned char>(ssKey.begin(), ssKey.end())).second)
+                AddAddressBalanceDelta(*this, mapBalances, it->first, nValue, true);
+        }
+        batch.Erase(std::make_pair(DB_ADDRESSINDEX, it->first));
+    }
+    WriteAddressBalances(batch, mapBalances);
+}
+
+bool CIndexesDB::ReadAddressBalanceIndex(uint160 addressHash, int type, std::string tokenName,
+                                           std::vector<std::pair<CAddressIndexIteratorTokenKey, CAddressBalanceValue> > &balances) {
+
+    if (!tokenName.empty()) {
+        CAddressIndexIteratorTokenKey key(type, addressHash, tokenName);
+        CAddressBalanceValue balance;
+        if (Read(std::make_pair(DB_ADDRESSBALANCEINDEX, key), balance))
+            balances.push_back(std::make_pair(key, balance));
+        return true;
+    }
+
     boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
 
-    pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorKey(type, addressHash)));
+    pcursor->Seek(std::make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorKey(type, addressHash)));
 
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
-        std::pair<char,CAddressUnspentKey> key;
-        if (pcursor->GetKey(key) && key.first == DB_ADDRESSUNSPENTINDEX && key.second.hashBytes == addressHash) {
-            CAddressUnspentValue nValue;
-            if (pcursor->GetValue(nValue)) {
-                if (key.second.token != "PLB") {
-                    unspentOutputs.push_back(std::make_pair(key.second, nValue));
-                }
+        std::pair<char,CAddressIndexIteratorTokenKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_ADDRESSBALANCEINDEX && key.second.type == (unsigned int)type
+                && key.second.hashBytes == addressHash) {
+            CAddressBalanceValue balance;
+            if (pcursor->GetValue(balance)) {
+                balances.push_back(std::make_pair(key.second, balance));
                 pcursor->Next();
             } else {
-                return error("failed to get address unspent value");
+                return error("failed to get address balance index value");
             }
         } else {
             break;
@@ -338,29 +593,15 @@ bool CBlockTreeDB::ReadAddressUnspentIndex(uint160 addressHash, int type,
     return true;
 }
 
-bool CBlockTreeDB::WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect) {
-    CDBBatch batch(*this);
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
-        batch.Write(std::make_pair(DB_ADDRESSINDEX, it->first), it->second);
-    return WriteBatch(batch);
-}
-
-bool CBlockTreeDB::EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount > >&vect) {
-    CDBBatch batch(*this);
-    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=vect.begin(); it!=vect.end(); it++)
-        batch.Erase(std::make_pair(DB_ADDRESSINDEX, it->first));
-    return WriteBatch(batch);
-}
-
-bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, int type, std::string tokenName,
-                                    std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
-                                    int start, int end) {
+bool CIndexesDB::ReadAddressIndex(uint160 addressHash, int type, const std::string& tokenName, int start, int end, const CAddressIndexKey* pafter,
+                                  std::function<bool(const CAddressIndexKey&, const CAmount&)> func) {
 
     boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
 
-    if (!tokenName.empty() && start > 0 && end > 0) {
-        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX,
-                                     CAddressIndexIteratorHeightKey(type, addressHash, tokenName, start)));
+    if (pafter) {
+        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, *pafter));
+    } else if (!tokenName.empty() && start > 0) {
+        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, tokenName, start)));
     } else if (!tokenName.empty()) {
         pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorTokenKey(type, addressHash, tokenName)));
     } else {
@@ -370,40 +611,88 @@ bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, int type, std::string t
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
         std::pair<char,CAddressIndexKey> key;
-        if (pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX && key.second.hashBytes == addressHash
-                && (tokenName.empty() || key.second.token == tokenName)) {
-            if (end > 0 && key.second.blockHeight > end) {
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX || key.second.type != (unsigned int)type || key.second.hashBytes != addressHash
+                || (!tokenName.empty() && key.second.token != tokenName)) {
+            break;
+        }
+
+        if (pafter && key.second.txhash == pafter->txhash && key.second.index == pafter->index && key.second.spending == pafter->spending
+                && key.second.token == pafter->token) {
+            pcursor->Next();
+            continue;
+        }
+
+        // With every token the heights restart at each token, seek over the ones out of range
+        if (start > 0 && key.second.blockHeight < start) {
+            pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, key.second.token, start)));
+            continue;
+        }
+        if (end > 0 && key.second.blockHeight > end) {
+            if (!tokenName.empty())
                 break;
-            }
-            CAmount nValue;
-            if (pcursor->GetValue(nValue)) {
-                addressIndex.push_back(std::make_pair(key.second, nValue));
-                pcursor->Next();
-            } else {
-                return error("failed to get address index value");
-            }
-        } else {
+            pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, key.second.token, -1)));
+            continue;
+        }
+
+        CAmount nValue;
+        if (!pcursor->GetValue(nValue))
+            return error("failed to get address index value");
+        if (!func(key.second, nValue))
+            break;
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+bool CIndexesDB::ReadAddressIndexTokens(uint160 addressHash, int type, std::vector<std::string>& tokens) {
+
+    boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorKey(type, addressHash)));
+
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+        std::pair<char,CAddressIndexKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX || key.second.type != (unsigned int)type || key.second.hashBytes != addressHash) {
             break;
         }
+
+        tokens.push_back(key.second.token);
+        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, key.second.token, -1)));
     }
 
     return true;
 }
 
-bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, int type,
+bool CIndexesDB::ReadAddressIndex(uint160 addressHash, int type, std::string tokenName,
                                     std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                                     int start, int end) {
 
-    return CBlockTreeDB::ReadAddressIndex(addressHash, type, "", addressIndex, start, end);
+    return ReadAddressIndex(addressHash, type, tokenName, start, end, nullptr, [&addressIndex](const CAddressIndexKey& key, const CAmount& nValue) {
+        addressIndex.push_back(std::make_pair(key, nValue));
+        return true;
+    });
 }
 
-bool CBlockTreeDB::WriteTimestampIndex(const CTimestampIndexKey &timestampIndex) {
+bool CIndexesDB::ReadAddressIndex(uint160 addressHash, int type,
+                                    std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
+                                    int start, int end) {
+
+    return CIndexesDB::ReadAddressIndex(addressHash, type, "", addressIndex, start, end);
+}
+
+bool CIndexesDB::WriteTimestampIndex(const CTimestampIndexKey &timestampIndex) {
     CDBBatch batch(*this);
-    batch.Write(std::make_pair(DB_TIMESTAMPINDEX, timestampIndex), 0);
+    WriteTimestampIndex(batch, timestampIndex);
     return WriteBatch(batch);
 }
 
-bool CBlockTreeDB::ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes) {
+void CIndexesDB::WriteTimestampIndex(CDBBatch& batch, const CTimestampIndexKey &timestampIndex) {
+    batch.Write(std::make_pair(DB_TIMESTAMPINDEX, timestampIndex), 0);
+}
+
+bool CIndexesDB::ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &hashes) {
 
     boost::scoped_ptr<CDBIterator> pcursor(NewIterator());
 
@@ -430,13 +719,17 @@ bool CBlockTreeDB::ReadTimestampIndex(const unsigned int &high, const unsigned i
     return true;
 }
 
-bool CBlockTreeDB::WriteTimestampBlockIndex(const CTimestampBlockIndexKey &blockhashIndex, const CTimestampBlockIndexValue &logicalts) {
+bool CIndexesDB::WriteTimestampBlockIndex(const CTimestampBlockIndexKey &blockhashIndex, const CTimestampBlockIndexValue &logicalts) {
     CDBBatch batch(*this);
-    batch.Write(std::make_pair(DB_BLOCKHASHINDEX, blockhashIndex), logicalts);
+    WriteTimestampBlockIndex(batch, blockhashIndex, logicalts);
     return WriteBatch(batch);
 }
 
-bool CBlockTreeDB::ReadTimestampBlockIndex(const uint256 &hash, unsigned int &ltimestamp) {
+void CIndexesDB::WriteTimestampBlockIndex(CDBBatch& batch, const CTimestampBlockIndexKey &blockhashIndex, const CTimestampBlockIndexValue &logicalts) {
+    batch.Write(std::make_pair(DB_BLOCKHASHINDEX, blockhashIndex), logicalts);
+}
+
+bool CIndexesDB::ReadTimestampBlockIndex(const uint256 &hash, unsigned int &ltimestamp) {
 
     CTimestampBlockIndexValue(lts);
     if (!Read(std::make_pair(DB_BLOCKHASHINDEX, hash), lts))
@@ -446,59 +739,6 @@ bool CBlockTreeDB::ReadTimestampBlockIndex(const uint256 &hash, unsigned int &lt
     return true;
 }
 
-bool CBlockTreeDB::WriteFlag(const std::string &name, bool fValue) {
-    return Write(std::make_pair(DB_FLAG, name), fValue ? '1' : '0');
-}
-
-bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
-    char ch;
-    if (!Read(std::make_pair(DB_FLAG, name), ch))
-        return false;
-    fValue = ch == '1';
-    return true;
-}
-
-bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
-{
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-
-    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
-
-    // Load mapBlockIndex
-    while (pcursor->Valid()) {
-        boost::this_thread::interruption_point();
-        std::pair<char, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
-            CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetIndexHash());
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-                pindexNew->nStakeModifier = diskindex.nStakeModifier;
-                pindexNew->nNonce         = diskindex.nNonce;
-
-                pcursor->Next();
-            } else {
-                return error("%s: failed to read value", __func__);
-            }
-        } else {
-            break;
-        }
-    }
-
-    return true;
-}
-
 namespace {
 
 //! Legacy class to deserialize pre-pertxout database entries without reindex.
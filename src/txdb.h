@@ -15,6 +15,8 @@
 #include "spentindex.h"
 #include "timestampindex.h"
 
+#include <atomic>
+#include <functional>
 #include <map>
 #include <string>
 #include <utility>
@@ -34,6 +36,14 @@ static const int64_t nDefaultDbBatchSize = 16 << 20;
 static const int64_t nMaxDbCache = sizeof(void*) > 4 ? 16384 : 1024;
 //! min. -dbcache (MiB)
 static const int64_t nMinDbCache = 4;
+//! -tokencache default (MiB)
+static const int64_t nDefaultTokenCache = 200;
+//! min. -tokencache (MiB)
+static const int64_t nMinTokenCache = 4;
+//! -indexcache default (MiB)
+static const int64_t nDefaultIndexCache = 100;
+//! min. -indexcache (MiB)
+static const int64_t nMinIndexCache = 4;
 //! Max memory allocated to block tree DB specific cache, if no -txindex (MiB)
 static const int64_t nMaxBlockDBCache = 2;
 //! Max memory allocated to block tree DB specific cache, if -txindex (MiB)
@@ -126,6 +136,23 @@ public:
     bool ReadReindexing(bool &fReindexing);
     bool ReadTxIndex(const uint256 &txid, CDiskTxPos &pos);
     bool WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos> > &vect);
+    bool WriteFlag(const std::string &name, bool fValue);
+    bool ReadFlag(const std::string &name, bool &fValue);
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+    // Erases the address, spent and timestamp index rows older versions kept here, they moved to CIndexesDB.
+    // Stops early, leaving the rest for the next call, once *pfInterrupt is set.
+    bool EraseMovedIndexes(const std::atomic<bool>* pfInterrupt = nullptr);
+};
+
+/** Access to the address, spent and timestamp index database (indexes/) */
+class CIndexesDB : public CDBWrapper
+{
+public:
+    explicit CIndexesDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false, size_t maxFileSize = 2 << 20);
+
+    CIndexesDB(const CIndexesDB&) = delete;
+    CIndexesDB& operator=(const CIndexesDB&) = delete;
+
     bool ReadSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
     bool UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect);
     bool UpdateAddressUnspentIndex(const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue > >&vect);
@@ -133,21 +160,44 @@ public:
                                  std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &vect);
     bool ReadAddressUnspentIndex(uint160 addressHash, int type,
                                  std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &vect);
-    bool WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect);
-    bool EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect);
+    // Calls func with the unspent outputs of tokenName (every token if empty, but PLB if fExcludePLB) in key order,
+    // continuing after pafter if it isn't null. Stops when func returns false.
+    bool ReadAddressUnspentIndex(uint160 addressHash, int type, const std::string& tokenName, bool fExcludePLB, const CAddressUnspentKey* pafter,
+                                 std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)> func);
+    bool WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect, bool fBalanceIndex = false);
+    bool EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect, bool fBalanceIndex = false);
+    bool ReadAddressBalanceIndex(uint160 addressHash, int type, std::string tokenName,
+                                 std::vector<std::pair<CAddressIndexIteratorTokenKey, CAddressBalanceValue> > &balances);
     bool ReadAddressIndex(uint160 addressHash, int type, std::string tokenName,
                           std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                           int start = 0, int end = 0);
     bool ReadAddressIndex(uint160 addressHash, int type,
                           std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                           int start = 0, int end = 0);
+    // Calls func with the entries of tokenName (every token if empty) between heights start and end (unbounded if 0)
+    // in key order, continuing after pafter if it isn't null. Stops when func returns false.
+    bool ReadAddressIndex(uint160 addressHash, int type, const std::string& tokenName, int start, int end, const CAddressIndexKey* pafter,
+                          std::function<bool(const CAddressIndexKey&, const CAmount&)> func);
+    // The tokens the address has entries for, found by seeking over the entries of each
+    bool ReadAddressIndexTokens(uint160 addressHash, int type, std::vector<std::string>& tokens);
     bool WriteTimestampIndex(const CTimestampIndexKey &timestampIndex);
     bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, const bool fActiveOnly, std::vector<std::pair<uint256, unsigned int> > &vect);
     bool WriteTimestampBlockIndex(const CTimestampBlockIndexKey &blockhashIndex, const CTimestampBlockIndexValue &logicalts);
     bool ReadTimestampBlockIndex(const uint256 &hash, unsigned int &logicalTS);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+
+    // Batched changes, nothing is written until WriteBatch
+    void UpdateSpentIndex(CDBBatch& batch, const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect);
+    void UpdateAddressUnspentIndex(CDBBatch& batch, const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue > >&vect);
+    void WriteAddressIndex(CDBBatch& batch, const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect, bool fBalanceIndex);
+    void EraseAddressIndex(CDBBatch& batch, const std::vector<std::pair<CAddressIndexKey, CAmount> > &vect, bool fBalanceIndex);
+    void WriteTimestampIndex(CDBBatch& batch, const CTimestampIndexKey &timestampIndex);
+    void WriteTimestampBlockIndex(CDBBatch& batch, const CTimestampBlockIndexKey &blockhashIndex, const CTimestampBlockIndexValue &logicalts);
+    void WriteBestBlock(CDBBatch& batch, const uint256& hashBlock);
+
+    // The block the indexes were last written for, null if nothing was indexed yet
+    uint256 GetBestBlock() const;
 };
 
 #endif // PLB_TXDB_H
@@ -27,6 +27,8 @@ CTxMemPoolEntry::CTxMemPoolEntry(const CTransactionRef& _tx, const CAmount& _nFe
     spendsCoinbase(_spendsCoinbase), sigOpCost(_sigOpsCost), lockPoints(lp)
 {
     nTxWeight = GetTransactionWeight(*tx);
+    // Decode the token outputs before the usage is taken, so it counts them however the entry was validated
+    tx->GetTokenOutput(0);
     nUsageSize = RecursiveDynamicUsage(tx);
 
     nCountWithDescendants = 1;
@@ -23,6 +23,7 @@
 #include "primitives/transaction.h"
 #include "sync.h"
 #include "random.h"
+#include "tokens/tokentypes.h"
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -473,16 +474,16 @@ public:
 
     /** Restricted tokens maps */
     // Helper maps for when addresses are marked as frozen
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressesMarkedFrozen;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressMarkedFrozen;
+    std::map<std::pair<CTokenAddress, std::string>, std::set<uint256> > mapAddressesMarkedFrozen;
+    std::map<uint256, std::set<std::pair<CTokenAddress, std::string>>> mapHashToAddressMarkedFrozen;
 
     // Helper maps for when restricted tokens are globally frozen
     std::map<std::string, std::set<uint256>> mapTokenMarkedGlobalFrozen;
     std::map<uint256, std::set<std::string>> mapHashMarkedGlobalFrozen;
 
     // Helper maps for when qualifiers are added or removed from addresses
-    std::map<std::string, std::set<uint256>> mapAddressesQualifiersChanged;
-    std::map<uint256, std::set<std::string>> mapHashQualifiersChanged;
+    std::map<CTokenAddress, std::set<uint256>> mapAddressesQualifiersChanged;
+    std::map<uint256, std::set<CTokenAddress>> mapHashQualifiersChanged;
 
     // Helper maps for when verifier string are changed
     std::map<std::string, std::set<uint256>> mapTokenVerifierChanged;
@@ -493,12 +494,12 @@ public:
     std::map<uint256, std::set<std::string>> mapHashGlobalFreezingTokenTransactions;
 
     // Helper map for when a qualfier is added to an address
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressAddedTag;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressAddedTag;
+    std::map<std::pair<CTokenAddress, std::string>, std::set<uint256> > mapAddressAddedTag;
+    std::map<uint256, std::set<std::pair<CTokenAddress, std::string>>> mapHashToAddressAddedTag;
 
     // Helper map for when a qualfier is added to an address
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressRemoveTag;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressRemoveTag;
+    std::map<std::pair<CTokenAddress, std::string>, std::set<uint256> > mapAddressRemoveTag;
+    std::map<uint256, std::set<std::pair<CTokenAddress, std::string>>> mapHashToAddressRemoveTag;
 
     std::map<std::string, std::set<uint256>> mapGlobalUnFreezingTokenTransactions;
     std::map<uint256, std::set<std::string>> mapHashGlobalUnFreezingTokenTransactions;
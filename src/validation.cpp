@@ -106,6 +106,7 @@ bool fMessaging = true;
 bool fTxIndex = true;
 bool fTokenIndex = true;
 bool fAddressIndex = false;
+bool fAddressBalanceIndex = false;
 bool fTimestampIndex = false;
 bool fSpentIndex = false;
 bool fHavePruned = false;
@@ -115,6 +116,7 @@ bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
+size_t nTokenCacheUsage = nDefaultTokenCache << 20;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
 bool fEnableReplacement = DEFAULT_ENABLE_REPLACEMENT;
@@ -243,13 +245,12 @@ CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& loc
 CCoinsViewDB *pcoinsdbview = nullptr;
 CCoinsViewCache *pcoinsTip = nullptr;
 CBlockTreeDB *pblocktree = nullptr;
+CIndexesDB *pindexesdb = nullptr;
 
 CTokensDB *ptokensdb = nullptr;
 CTokensCache *ptokens = nullptr;
 CLRUCache<std::string, CDatabasedTokenData> *ptokensCache = nullptr;
 CLRUCache<std::string, CMessage> *pMessagesCache = nullptr;
-CLRUCache<std::string, int> *pMessageSubscribedChannelsCache = nullptr;
-CLRUCache<std::string, int> *pMessagesSeenAddressCache = nullptr;
 CMessageDB *pmessagedb = nullptr;
 CMessageChannelDB *pmessagechanneldb = nullptr;
 CMyRestrictedDB *pmyrestricteddb = nullptr;
@@ -258,6 +259,7 @@ CTokenSnapshotDB *pTokenSnapshotDb = nullptr;
 CDistributeSnapshotRequestDB *pDistributeSnapshotDb = nullptr;
 
 CGovernance *governance = nullptr;
+CGovernanceCache *pgovernanceTip = nullptr;
 
 CLRUCache<std::string, CNullTokenTxVerifierString> *ptokensVerifierCache = nullptr;
 CLRUCache<std::string, int8_t> *ptokensQualifierCache = nullptr;
@@ -1001,11 +1003,13 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
         }
 
         if (AreTokensDeployed()) {
-            for (auto out : tx.vout) {
+            for (unsigned int i = 0; i < tx.vout.size(); i++) {
+                const CTxOut& out = tx.vout[i];
                 if (out.scriptPubKey.IsTokenScript()) {
-                    CTokenOutputEntry data;
-                    if (!GetTokenData(out.scriptPubKey, data))
+                    const CTokenOutputEntry* pdata = tx.GetTokenOutput(i);
+                    if (!pdata)
                         continue;
+                    const CTokenOutputEntry& data = *pdata;
                     if (data.type == TX_NEW_TOKEN && !IsTokenNameAnOwner(data.tokenName)) {
                         pool.mapTokenToHash[data.tokenName] = hash;
                         pool.mapHashToToken[hash] = data.tokenName;
@@ -1014,9 +1018,8 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
                     // Keep track of all restricted tokens tx that can become invalid if qualifier or verifiers are changed
                     if (AreRestrictedTokensDeployed()) {
                         if (IsTokenNameAnRestricted(data.tokenName)) {
-                            std::string address = EncodeDestination(data.destination);
-                            pool.mapAddressesQualifiersChanged[address].insert(hash);
-                            pool.mapHashQualifiersChanged[hash].insert(address);
+                            pool.mapAddressesQualifiersChanged[data.address].insert(hash);
+                            pool.mapHashQualifiersChanged[hash].insert(data.address);
 
                             pool.mapTokenVerifierChanged[data.tokenName].insert(hash);
                             pool.mapHashVerifierChanged[hash].insert(data.tokenName);
@@ -1045,7 +1048,7 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
                     // We need to track all tags that are being adding to address, that live in the mempool
                     // This will allow us to keep the mempool clean, and only allow one tag per address at a time into the mempool
                     CNullTokenTxData addressNullData;
-                    std::string address;
+                    CTokenAddress address;
                     if (TokenNullDataFromScript(out.scriptPubKey, addressNullData, address)) {
                         if (IsTokenNameAQualifier(addressNullData.token_name)) {
                             if (addressNullData.flag == (int) QualifierType::ADD_QUALIFIER) {
@@ -1086,7 +1089,7 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
                         pool.mapTokenMarkedGlobalFrozen[data.tokenName].insert(hash);
                         pool.mapHashMarkedGlobalFrozen[hash].insert(data.tokenName);
 
-                        auto pair = std::make_pair(EncodeDestination(data.destination), data.tokenName);
+                        auto pair = std::make_pair(data.address, data.tokenName);
                         pool.mapAddressesMarkedFrozen[pair].insert(hash);
                         pool.mapHashToAddressMarkedFrozen[hash].insert(pair);
                     }
@@ -1130,7 +1133,7 @@ bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, const
     if (!fTimestampIndex)
         return error("Timestamp index not enabled");
 
-    if (!pblocktree->ReadTimestampIndex(high, low, fActiveOnly, hashes))
+    if (!pindexesdb->ReadTimestampIndex(high, low, fActiveOnly, hashes))
         return error("Unable to get hashes for timestamps");
 
     return true;
@@ -1144,7 +1147,7 @@ bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value)
     if (mempool.getSpentIndex(key, value))
         return true;
 
-    if (!pblocktree->ReadSpentIndex(key, value))
+    if (!pindexesdb->ReadSpentIndex(key, value))
         return false;
 
     return true;
@@ -1167,7 +1170,7 @@ bool GetAddressIndex(uint160 addressHash, int type, std::string tokenName,
     if (!fAddressIndex)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressIndex(addressHash, type, tokenName, addressIndex, start, end))
+    if (!pindexesdb->ReadAddressIndex(addressHash, type, tokenName, addressIndex, start, end))
         return error("unable to get txids for address");
 
     return true;
@@ -1179,19 +1182,31 @@ bool GetAddressIndex(uint160 addressHash, int type,
     if (!fAddressIndex)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressIndex(addressHash, type, addressIndex, start, end))
+    if (!pindexesdb->ReadAddressIndex(addressHash, type, addressIndex, start, end))
         return error("unable to get txids for address");
 
     return true;
 }
 
+bool GetAddressBalance(uint160 addressHash, int type, std::string tokenName,
+                       std::vector<std::pair<CAddressIndexIteratorTokenKey, CAddressBalanceValue> > &balances)
+{
+    if (!fAddressBalanceIndex)
+        return error("address balance index not enabled");
+
+    if (!pindexesdb->ReadAddressBalanceIndex(addressHash, type, tokenName, balances))
+        return error("unable to get balances for address");
+
+    return true;
+}
+
 bool GetAddressUnspent(uint160 addressHash, int type, std::string tokenName,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs)
 {
     if (!fAddressIndex)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressUnspentIndex(addressHash, type, tokenName, unspentOutputs))
+    if (!pindexesdb->ReadAddressUnspentIndex(addressHash, type, tokenName, unspentOutputs))
         return error("unable to get txids for address");
 
     return true;
@@ -1203,12 +1218,47 @@ bool GetAddressUnspent(uint160 addressHash, int type,
     if (!fAddressIndex)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressUnspentIndex(addressHash, type, unspentOutputs))
+    if (!pindexesdb->ReadAddressUnspentIndex(addressHash, type, unspentOutputs))
+        return error("unable to get txids for address");
+
+    return true;
+}
+
+bool GetAddressIndex(uint160 addressHash, int type, std::string tokenName, int start, int end, const CAddressIndexKey* pafter,
+                     std::function<bool(const CAddressIndexKey&, const CAmount&)> func)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pindexesdb->ReadAddressIndex(addressHash, type, tokenName, start, end, pafter, func))
         return error("unable to get txids for address");
 
     return true;
 }
 
+bool GetAddressUnspent(uint160 addressHash, int type, std::string tokenName, bool fExcludePLB, const CAddressUnspentKey* pafter,
+                       std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)> func)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pindexesdb->ReadAddressUnspentIndex(addressHash, type, tokenName, fExcludePLB, pafter, func))
+        return error("unable to get txids for address");
+
+    return true;
+}
+
+bool GetAddressIndexTokens(uint160 addressHash, int type, std::vector<std::string>& tokens)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (!pindexesdb->ReadAddressIndexTokens(addressHash, type, tokens))
+        return error("unable to get tokens for address");
+
+    return true;
+}
+
 /** Return transaction in txOut, and if it was found inside a block, its hash is placed in hashBlock */
 bool GetTransaction(const uint256 &hash, CTransactionRef &txOut, const Consensus::Params& consensusParams, uint256 &hashBlock, bool fAllowSlow)
 {
@@ -1324,8 +1374,68 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
     return true;
 }
 
+/** Size of the message start and length WriteBlockToDisk writes in front of each block */
+static const unsigned int BLOCK_RECORD_HEADER_SIZE = CMessageHeader::MESSAGE_START_SIZE + sizeof(unsigned int);
+
+/**
+ * Reads the block at pos without hashing it. Instead the record in front of it has to carry the message start and
+ * the exact size of the block read, which catches a wrong position and truncated or overwritten data.
+ */
+static bool ReadBlockRecordFromDisk(CBlock& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+{
+    block.SetNull();
+
+    if (pos.nPos < BLOCK_RECORD_HEADER_SIZE)
+        return error("%s: No block record in front of %s", __func__, pos.ToString());
+
+    // Open history file to read, at the record header
+    CAutoFile filein(OpenBlockFile(CDiskBlockPos(pos.nFile, pos.nPos - BLOCK_RECORD_HEADER_SIZE), true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+
+    CMessageHeader::MessageStartChars recordStart;
+    unsigned int nSize;
+    try {
+        filein >> FLATDATA(recordStart) >> nSize;
+        if (memcmp(recordStart, messageStart, CMessageHeader::MESSAGE_START_SIZE))
+            return error("%s: Block record message start mismatch at %s", __func__, pos.ToString());
+        filein >> block;
+    }
+    catch (const std::exception& e) {
+        return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+    }
+
+    long nEnd = ftell(filein.Get());
+    if (nEnd < 0 || (uint64_t)nEnd != (uint64_t)pos.nPos + nSize)
+        return error("%s: Block size doesn't match its record (%u bytes) at %s", __func__, nSize, pos.ToString());
+
+    return true;
+}
+
+/** Whether the header read from disk is the one the index was built from, field by field instead of by hash */
+static bool BlockHeaderMatchesIndex(const CBlockHeader& header, const CBlockIndex* pindex)
+{
+    return header.nVersion == pindex->nVersion &&
+           header.hashPrevBlock == (pindex->pprev ? pindex->pprev->GetIndexHash() : uint256()) &&
+           header.hashMerkleRoot == pindex->hashMerkleRoot &&
+           header.nTime == pindex->nTime &&
+           header.nBits == pindex->nBits &&
+           header.nNonce == pindex->nNonce;
+}
+
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
+    // A header linked into the tree has had its proof of work checked and its hash is what the index is keyed by,
+    // so a trusted read only checks the record on disk and that the header read is the indexed one.
+    if (pindex->IsValid(BLOCK_VALID_TREE)) {
+        if (!ReadBlockRecordFromDisk(block, pindex->GetBlockPos(), GetParams().MessageStart()))
+            return false;
+        if (!BlockHeaderMatchesIndex(block, pindex))
+            return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): header doesn't match index for %s at %s",
+                    pindex->ToString(), pindex->GetBlockPos().ToString());
+        return true;
+    }
+
     if (!ReadBlockFromDisk(block, pindex->GetBlockPos(), consensusParams))
         return false;
     if (block.GetIndexHash() != pindex->GetIndexHash())
@@ -1719,6 +1829,31 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
     return true;
 }
 
+} // namespace
+
+/** Abort with a message */
+bool AbortNode(const std::string& strMessage, const std::string& userMessage)
+{
+    SetMiscWarning(strMessage);
+    LogPrintf("*** %s\n", strMessage);
+    uiInterface.ThreadSafeMessageBox(
+        userMessage.empty() ? _("Error: A fatal internal error occurred, see debug.log for details") : userMessage,
+        "", CClientUIInterface::MSG_ERROR);
+
+    StartShutdown();
+    return false;
+}
+
+namespace {
+
+bool AbortNode(CValidationState& state, const std::string& strMessage, const std::string& userMessage="")
+{
+    ::AbortNode(strMessage, userMessage);
+    return state.Error(strMessage);
+}
+
+} // namespace
+
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uint256& hashBlock)
 {
     // Open history file to read
@@ -1745,27 +1880,6 @@ bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uin
     return true;
 }
 
-/** Abort with a message */
-bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
-{
-    SetMiscWarning(strMessage);
-    LogPrintf("*** %s\n", strMessage);
-    uiInterface.ThreadSafeMessageBox(
-        userMessage.empty() ? _("Error: A fatal internal error occurred, see debug.log for details") : userMessage,
-        "", CClientUIInterface::MSG_ERROR);
-
-    StartShutdown();
-    return false;
-}
-
-bool AbortNode(CValidationState& state, const std::string& strMessage, const std::string& userMessage="")
-{
-    AbortNode(strMessage, userMessage);
-    return state.Error(strMessage);
-}
-
-} // namespace
-
 enum DisconnectResult
 {
     DISCONNECT_OK,      // All good.
@@ -1830,7 +1944,7 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out, CTok
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
  *  When FAILED is returned, view is left in an indeterminate state. */
-static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, CTokensCache* tokensCache = nullptr, bool ignoreAddressIndex = false, bool databaseMessaging = true)
+static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, CGovernanceCache& governanceCache, CTokensCache* tokensCache = nullptr, bool databaseMessaging = true)
 {
     bool fClean = true;
 
@@ -1856,15 +1970,11 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
         return DISCONNECT_FAILED;
     }
     
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
-    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
-
     CTxDestination destination = DecodeDestination(GetParams().GovernanceMasterAddress());
     CScript masterKey = GetScriptForDestination(destination);
 
     // undo transactions in reverse order
-    CTokensCache tempCache(*tokensCache);
+    CTokensCache tempCache(tokensCache);
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
         const CTransaction &tx = *(block.vtx[i]);
         uint256 hash = tx.GetHash();
@@ -1872,81 +1982,6 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
         std::vector<int> vTokenTxIndex;
         std::vector<int> vNullTokenTxIndex;
-        if (fAddressIndex) {
-            for (unsigned int k = tx.vout.size(); k-- > 0;) {
-                const CTxOut &out = tx.vout[k];
-
-                if (out.scriptPubKey.IsPayToScriptHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+2, out.scriptPubKey.begin()+22);
-
-                    // undo receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), pindex->nHeight, i, hash, k, false), out.nValue));
-
-                    // undo unspent index
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), hash, k), CAddressUnspentValue()));
-
-                } else if (out.scriptPubKey.IsPayToPublicKeyHash()) {
-
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+3, out.scriptPubKey.begin()+23);
-
-                    // undo receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, hash, k, false), out.nValue));
-
-                    // undo unspent index
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), hash, k), CAddressUnspentValue()));
-
-                } else if (out.scriptPubKey.IsPayToPublicKeyHashLocked()) {
-                    int timeLock = out.GetLockTime();
-
-                    int offset = out.scriptPubKey.size() - 25;
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin() + (3 + offset), out.scriptPubKey.begin() + (23 + offset));
-
-                    // undo receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, hash, k, false, timeLock), out.nValue));
-
-                    // undo unspent index
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), hash, k, timeLock), CAddressUnspentValue()));
-
-                } else if (out.scriptPubKey.IsPayToPublicKey()) {
-                    uint160 hashBytes(Hash160(out.scriptPubKey.begin()+1, out.scriptPubKey.end()-1));
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, pindex->nHeight, i, hash, k, false), out.nValue));
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, hash, k), CAddressUnspentValue()));
-                } else {
-                    /** TOKENS START */
-                    if (AreTokensDeployed()) {
-                        std::string tokenName;
-                        CAmount tokenAmount;
-                        uint160 hashBytes;
-                        int nScriptType;
-                        uint32_t nTimeLock;
-
-                        if (ParseTokenScript(out.scriptPubKey, hashBytes, nScriptType, tokenName, tokenAmount, nTimeLock)) {
-                            if (nScriptType == TX_PUBKEYHASH) {
-                                // undo receiving activity
-                                addressIndex.push_back(std::make_pair(
-                                        CAddressIndexKey(1, uint160(hashBytes), tokenName, pindex->nHeight, i, hash, k,
-                                                         false, nTimeLock), tokenAmount));
-
-                                // undo unspent index
-                                addressUnspentIndex.push_back(
-                                        std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), tokenName, hash, k),
-                                                       CAddressUnspentValue()));
-                            }  else if (nScriptType == TX_SCRIPTHASH) {
-                                // undo receiving activity
-                                addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), tokenName, pindex->nHeight, i, hash, k, false, nTimeLock), tokenAmount));
-
-                                // undo unspent index
-                                addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), tokenName, hash, k), CAddressUnspentValue()));
-                            }
-                        } else {
-                            continue;
-                        }
-                    }
-                    /** TOKENS END */
-                }
-            }
-        }
-
         // Check that all outputs are available and match the outputs in the block itself
         // exactly.
         int indexOfRestrictedTokenVerifierString = -1;
@@ -1988,13 +2023,13 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                 if (tx.IsNewToken()) {
                     // Remove the newly created token
                     CNewToken token;
-                    std::string strAddress;
-                    if (!TokenFromTransaction(tx, token, strAddress)) {
+                    CTokenAddress address;
+                    if (!TokenFromTransaction(tx, token, address)) {
                         error("%s : Failed to get token from transaction. TXID : %s", __func__, tx.GetHash().GetHex());
                         return DISCONNECT_FAILED;
                     }
                     if (tokensCache->ContainsToken(token)) {
-                        if (!tokensCache->RemoveNewToken(token, strAddress)) {
+                        if (!tokensCache->RemoveNewToken(token, address)) {
                             error("%s : Failed to Remove Token. Token Name : %s", __func__, token.strName);
                             return DISCONNECT_FAILED;
                         }
@@ -2002,7 +2037,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                     // Get the owner from the transaction and remove it
                     std::string ownerName;
-                    std::string ownerAddress;
+                    CTokenAddress ownerAddress;
                     if (!OwnerFromTransaction(tx, ownerName, ownerAddress)) {
                         error("%s : Failed to get owner from transaction. TXID : %s", __func__, tx.GetHash().GetHex());
                         return DISCONNECT_FAILED;
@@ -2014,16 +2049,16 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                     }
                 } else if (tx.IsReissueToken()) {
                     CReissueToken reissue;
-                    std::string strAddress;
+                    CTokenAddress address;
 
-                    if (!ReissueTokenFromTransaction(tx, reissue, strAddress)) {
+                    if (!ReissueTokenFromTransaction(tx, reissue, address)) {
                         error("%s : Failed to get reissue token from transaction. TXID : %s", __func__,
                               tx.GetHash().GetHex());
                         return DISCONNECT_FAILED;
                     }
 
                     if (tokensCache->ContainsToken(reissue.strName)) {
-                        if (!tokensCache->RemoveReissueToken(reissue, strAddress,
+                        if (!tokensCache->RemoveReissueToken(reissue, address,
                                                              COutPoint(tx.GetHash(), tx.vout.size() - 1),
                                                              vUndoData)) {
                             error("%s : Failed to Undo Reissue Token. Token Name : %s", __func__, reissue.strName);
@@ -2034,17 +2069,17 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                     for (int n = 0; n < (int)tx.vout.size(); n++) {
                         auto out = tx.vout[n];
                         CNewToken token;
-                        std::string strAddress;
+                        CTokenAddress address;
 
                         if (IsScriptNewUniqueToken(out.scriptPubKey)) {
-                            if (!TokenFromScript(out.scriptPubKey, token, strAddress)) {
+                            if (!TokenFromScript(out.scriptPubKey, token, address)) {
                                 error("%s : Failed to get unique token from transaction. TXID : %s, vout: %s", __func__,
                                       tx.GetHash().GetHex(), n);
                                 return DISCONNECT_FAILED;
                             }
 
                             if (tokensCache->ContainsToken(token.strName)) {
-                                if (!tokensCache->RemoveNewToken(token, strAddress)) {
+                                if (!tokensCache->RemoveNewToken(token, address)) {
                                     error("%s : Failed to Undo Unique Token. Token Name : %s", __func__, token.strName);
                                     return DISCONNECT_FAILED;
                                 }
@@ -2053,48 +2088,48 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                     }
                 } else if (tx.IsNewMsgChannelToken()) {
                     CNewToken token;
-                    std::string strAddress;
+                    CTokenAddress address;
 
-                    if (!MsgChannelTokenFromTransaction(tx, token, strAddress)) {
+                    if (!MsgChannelTokenFromTransaction(tx, token, address)) {
                         error("%s : Failed to get msgchannel token from transaction. TXID : %s", __func__,
                               tx.GetHash().GetHex());
                         return DISCONNECT_FAILED;
                     }
 
                     if (tokensCache->ContainsToken(token.strName)) {
-                        if (!tokensCache->RemoveNewToken(token, strAddress)) {
+                        if (!tokensCache->RemoveNewToken(token, address)) {
                             error("%s : Failed to Undo Msg Channel Token. Token Name : %s", __func__, token.strName);
                             return DISCONNECT_FAILED;
                         }
                     }
                 } else if (tx.IsNewQualifierToken()) {
                     CNewToken token;
-                    std::string strAddress;
+                    CTokenAddress address;
 
-                    if (!QualifierTokenFromTransaction(tx, token, strAddress)) {
+                    if (!QualifierTokenFromTransaction(tx, token, address)) {
                         error("%s : Failed to get qualifier token from transaction. TXID : %s", __func__,
                               tx.GetHash().GetHex());
                         return DISCONNECT_FAILED;
                     }
 
                     if (tokensCache->ContainsToken(token.strName)) {
-                        if (!tokensCache->RemoveNewToken(token, strAddress)) {
+                        if (!tokensCache->RemoveNewToken(token, address)) {
                             error("%s : Failed to Undo Qualifier Token. Token Name : %s", __func__, token.strName);
                             return DISCONNECT_FAILED;
                         }
                     }
                 } else if (tx.IsNewRestrictedToken()) {
                     CNewToken token;
-                    std::string strAddress;
+                    CTokenAddress address;
 
-                    if (!RestrictedTokenFromTransaction(tx, token, strAddress)) {
+                    if (!RestrictedTokenFromTransaction(tx, token, address)) {
                         error("%s : Failed to get restricted token from transaction. TXID : %s", __func__,
                               tx.GetHash().GetHex());
                         return DISCONNECT_FAILED;
                     }
 
                     if (tokensCache->ContainsToken(token.strName)) {
-                        if (!tokensCache->RemoveNewToken(token, strAddress)) {
+                        if (!tokensCache->RemoveNewToken(token, address)) {
                             error("%s : Failed to Undo Restricted Token. Token Name : %s", __func__, token.strName);
                             return DISCONNECT_FAILED;
                         }
@@ -2119,15 +2154,15 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                 for (auto index : vTokenTxIndex) {
                     CTokenTransfer transfer;
-                    std::string strAddress;
-                    if (!TransferTokenFromScript(tx.vout[index].scriptPubKey, transfer, strAddress)) {
+                    CTokenAddress address;
+                    if (!TransferTokenFromScript(tx.vout[index].scriptPubKey, transfer, address)) {
                         error("%s : Failed to get transfer token from transaction. CTxOut : %s", __func__,
                               tx.vout[index].ToString());
                         return DISCONNECT_FAILED;
                     }
 
                     COutPoint out(hash, index);
-                    if (!tokensCache->RemoveTransfer(transfer, strAddress, out)) {
+                    if (!tokensCache->RemoveTransfer(transfer, address, out)) {
                         error("%s : Failed to Remove the transfer of an token. Token Name : %s, COutPoint : %s",
                               __func__,
                               transfer.strName, out.ToString());
@@ -2153,7 +2188,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                         if (script.IsNullTokenTxDataScript()) {
                             CNullTokenTxData data;
-                            std::string address;
+                            CTokenAddress address;
                             if (!TokenNullDataFromScript(script, data, address)) {
                                 error("%s : Failed to get null token data from transaction. CTxOut : %s", __func__,
                                       tx.vout[index].ToString());
@@ -2167,20 +2202,19 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                             if (type == KnownTokenType::QUALIFIER || type == KnownTokenType::SUB_QUALIFIER) {
                                 if (!tokensCache->RemoveQualifierAddress(data.token_name, address, data.flag ? QualifierType::ADD_QUALIFIER : QualifierType::REMOVE_QUALIFIER)) {
                                     error("%s : Failed to remove qualifier from address, Qualifier : %s, Flag Removing : %d, Address : %s",
-                                          __func__, data.token_name, data.flag, address);
+                                          __func__, data.token_name, data.flag, address.ToString());
                                     return DISCONNECT_FAILED;
                                 }
                             // Handle adding restrictions to addresses
                             } else if (type == KnownTokenType::RESTRICTED) {
                                 if (!tokensCache->RemoveRestrictedAddress(data.token_name, address, data.flag ? RestrictedType::FREEZE_ADDRESS : RestrictedType::UNFREEZE_ADDRESS)) {
                                     error("%s : Failed to remove restriction from address, Restriction : %s, Flag Removing : %d, Address : %s",
-                                          __func__, data.token_name, data.flag, address);
+                                          __func__, data.token_name, data.flag, address.ToString());
                                     return DISCONNECT_FAILED;
                                 }
                             }
                         } else if (script.IsNullGlobalRestrictionTokenTxDataScript()) {
                             CNullTokenTxData data;
-                            std::string address;
                             if (!GlobalTokenNullDataFromScript(script, data)) {
                                 error("%s : Failed to get global null token data from transaction. CTxOut : %s", __func__,
                                       tx.vout[index].ToString());
@@ -2218,90 +2252,11 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                 if (res == DISCONNECT_FAILED) return DISCONNECT_FAILED;
                 fClean = fClean && res != DISCONNECT_UNCLEAN;
 
-                const CTxIn input = tx.vin[j];
-
-                if (fSpentIndex) {
-                    // undo and delete the spent index
-                    spentIndex.push_back(std::make_pair(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue()));
-                }
-
                 const CTxOut &prevout = view.AccessCoin(tx.vin[j].prevout).out;
 
                 if (prevout.scriptPubKey == masterKey)
                     fCheckGovernance = true;
 
-                if (fAddressIndex) {
-                    if (prevout.scriptPubKey.IsPayToScriptHash()) {
-                        std::vector<unsigned char> hashBytes(prevout.scriptPubKey.begin()+2, prevout.scriptPubKey.begin()+22);
-
-                        // undo spending activity
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), pindex->nHeight, i, hash, j, true), prevout.nValue * -1));
-
-                        // restore unspent index
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), input.prevout.hash, input.prevout.n), CAddressUnspentValue(prevout.nValue, prevout.scriptPubKey, undo.nHeight, tx.nTime)));
-
-
-                    } else if (prevout.scriptPubKey.IsPayToPublicKeyHash()) {
-                        std::vector<unsigned char> hashBytes(prevout.scriptPubKey.begin()+3, prevout.scriptPubKey.begin()+23);
-
-                        // undo spending activity
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, hash, j, true), prevout.nValue * -1));
-
-                        // restore unspent index
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), input.prevout.hash, input.prevout.n), CAddressUnspentValue(prevout.nValue, prevout.scriptPubKey, undo.nHeight, tx.nTime)));
-
-                    } else if (prevout.scriptPubKey.IsPayToPublicKeyHashLocked()) {
-                        int timeLock = prevout.GetLockTime();
-
-                        int offset = prevout.scriptPubKey.size() - 25;
-
-                        std::vector<unsigned char> hashBytes(prevout.scriptPubKey.begin() + (3 + offset), prevout.scriptPubKey.begin() + (23 + offset));
-
-                        // undo spending activity
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, hash, j, true, timeLock), prevout.nValue * -1));
-
-                        // restore unspent index
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), input.prevout.hash, input.prevout.n, timeLock), CAddressUnspentValue(prevout.nValue, prevout.scriptPubKey, undo.nHeight, tx.nTime)));
-
-                    } else if (prevout.scriptPubKey.IsPayToPublicKey()) {
-                        uint160 hashBytes(Hash160(prevout.scriptPubKey.begin() + 1, prevout.scriptPubKey.end() - 1));
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, pindex->nHeight, i, hash, j, false), prevout.nValue));
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, hash, j), CAddressUnspentValue()));
-                    } else {
-                        /** TOKENS START */
-                        if (AreTokensDeployed()) {
-                            std::string tokenName;
-                            CAmount tokenAmount;
-                            uint160 hashBytes;
-                            int nScriptType;
-                            uint32_t nTimeLock;
-
-                            if (ParseTokenScript(prevout.scriptPubKey, hashBytes, nScriptType, tokenName, tokenAmount, nTimeLock)) {
-                                if (nScriptType == TX_PUBKEYHASH) {
-                                    // undo spending activity
-                                    addressIndex.push_back(std::make_pair(
-                                            CAddressIndexKey(1, uint160(hashBytes), tokenName, pindex->nHeight, i, hash, j,
-                                                             true, nTimeLock), tokenAmount * -1));
-
-                                    // restore unspent index
-                                    addressUnspentIndex.push_back(std::make_pair(
-                                            CAddressUnspentKey(1, uint160(hashBytes), tokenName, input.prevout.hash,
-                                                               input.prevout.n),
-                                            CAddressUnspentValue(tokenAmount, prevout.scriptPubKey, undo.nHeight, tx.nTime)));
-                                } else if (nScriptType == TX_SCRIPTHASH) {
-                                    // undo spending activity
-                                    addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), tokenName, pindex->nHeight, i, hash, j, true, nTimeLock), tokenAmount * -1));
-
-                                    // restore unspent index
-                                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), tokenName, input.prevout.hash, input.prevout.n), CAddressUnspentValue(tokenAmount, prevout.scriptPubKey, undo.nHeight, tx.nTime)));
-                                }
-                            } else {
-                                continue;
-                            }
-                        }
-                        /** TOKENS END */
-                    }
-                }
             }
 
             // Master key signature found
@@ -2322,7 +2277,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                                     // Failsafe
                                     if (freezeScript != masterKey)
-                                        governance->RevertFreezeScript(freezeScript);
+                                        governanceCache.RevertFreezeScript(freezeScript);
                                 }
                             }
 
@@ -2336,7 +2291,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                                     // Failsafe
                                     if (freezeScript != masterKey)
-                                        governance->RevertUnfreezeScript(freezeScript);
+                                        governanceCache.RevertUnfreezeScript(freezeScript);
                                 }
                             }
 
@@ -2355,7 +2310,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
                                     try {
                                         ssAmount >> costAmount;
 
-                                        governance->RevertUpdateCost(type, pindex->nHeight);
+                                        governanceCache.RevertUpdateCost(type, pindex->nHeight);
                                     } catch(std::exception& e) {
                                         std::cout << "Failed to get amount from the stream: " << e.what() << std::endl;
                                     }
@@ -2373,7 +2328,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                                     // Failsafe
                                     if (feeScript != masterKey)
-                                        governance->RevertUpdateFeeScript(pindex->nHeight);
+                                        governanceCache.RevertUpdateFeeScript(pindex->nHeight);
                                 }
                             }
 
@@ -2388,7 +2343,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                                     // Failsafe
                                     if (authorizeScript != masterKey)
-                                        governance->RevertAuthorizeScript(authorizeScript);
+                                        governanceCache.RevertAuthorizeScript(authorizeScript);
                                 }
                             }
 
@@ -2402,7 +2357,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
 
                                     // Failsafe
                                     if (authorizeScript != masterKey)
-                                        governance->RevertUnauthorizeScript(authorizeScript);
+                                        governanceCache.RevertUnauthorizeScript(authorizeScript);
                                 }
                             }
                         }
@@ -2418,17 +2373,6 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetIndexHash());
 
-    if (!ignoreAddressIndex && fAddressIndex) {
-        if (!pblocktree->EraseAddressIndex(addressIndex)) {
-            error("Failed to delete address index");
-            return DISCONNECT_FAILED;
-        }
-        if (!pblocktree->UpdateAddressUnspentIndex(addressUnspentIndex)) {
-            error("Failed to write address unspent index");
-            return DISCONNECT_FAILED;
-        }
-    }
-
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
@@ -2560,11 +2504,118 @@ static int64_t nTimeCallbacks = 0;
 static int64_t nTimeTotal = 0;
 static int64_t nBlocksTotal = 0;
 
+/** Apply the governance actions in the outputs of a transaction that spends from the master key */
+static void ApplyGovernanceActions(const CTransaction& tx, const CScript& masterKey, int nHeight, CGovernanceCache& governanceCache)
+{
+    for (auto out : tx.vout) {
+        // Check if output is OP_RETURN
+        if (out.scriptPubKey[0] == OP_RETURN and out.scriptPubKey.size() >= 5) {
+            if (out.scriptPubKey[2] == GOVERNANCE_MARKER && out.scriptPubKey[3] == GOVERNANCE_ACTION)
+            {
+                // Freeze
+                if (out.scriptPubKey[4] == GOVERNANCE_FREEZE && out.scriptPubKey.size() >= 6)
+                {
+                    int length = (int)out.scriptPubKey[5];
+                    int offset = 6;
+
+                    if (out.scriptPubKey.size() == offset + length) {
+                        CScript freezeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
+
+                        // Failsafe
+                        if (freezeScript != masterKey)
+                            governanceCache.FreezeScript(freezeScript);
+                    }
+                }
+
+                // Unfreeze
+                if (out.scriptPubKey[4] == GOVERNANCE_UNFREEZE && out.scriptPubKey.size() >= 6) {
+                    int length = (int)out.scriptPubKey[5];
+                    int offset = 6;
+
+                    if (out.scriptPubKey.size() == offset + length) {
+                        CScript freezeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
+
+                        // Failsafe
+                        if (freezeScript != masterKey)
+                            governanceCache.UnfreezeScript(freezeScript);
+                    }
+                }
+
+                // Update issuance cost
+                if (out.scriptPubKey[4] == GOVERNANCE_COST && out.scriptPubKey.size() == 14)
+                {
+                    int type = (int)out.scriptPubKey[5];
+
+                    if (type >= GOVERNANCE_COST_ROOT && type <= GOVERNANCE_COST_RESTRICTED) {
+                        std::vector<unsigned char> vchAmount;
+                        CAmount costAmount;
+
+                        vchAmount.insert(vchAmount .end(), out.scriptPubKey.begin() + 6, out.scriptPubKey.end());
+                        CDataStream ssAmount(vchAmount, SER_NETWORK, PROTOCOL_VERSION);
+
+                        try {
+                            ssAmount >> costAmount;
+
+                            governanceCache.UpdateCost(costAmount, type, nHeight);
+                        } catch(std::exception& e) {
+                            std::cout << "Failed to get amount from the stream: " << e.what() << std::endl;
+                        }
+                    }
+                }
+
+                // Fee address
+                if (out.scriptPubKey[4] == GOVERNANCE_FEE && out.scriptPubKey.size() >= 6)
+                {
+                    int length = (int)out.scriptPubKey[5];
+                    int offset = 6;
+
+                    if (out.scriptPubKey.size() == offset + length) {
+                        CScript feeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
+
+                        // Failsafe
+                        if (feeScript != masterKey)
+                            governanceCache.UpdateFeeScript(feeScript, nHeight);
+                    }
+                }
+
+                // Authorize
+                if (out.scriptPubKey[4] == GOVERNANCE_AUTHORIZATION && out.scriptPubKey.size() >= 6)
+                {
+                    int length = (int)out.scriptPubKey[5];
+                    int offset = 6;
+
+                    if (out.scriptPubKey.size() == offset + length) {
+                        CScript authorizeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
+
+                        // Failsafe
+                        if (authorizeScript != masterKey)
+                            governanceCache.AuthorizeScript(authorizeScript);
+                    }
+                }
+
+                // Unauthorize
+                if (out.scriptPubKey[4] == GOVERNANCE_UNAUTHORIZATION && out.scriptPubKey.size() >= 6) {
+                    int length = (int)out.scriptPubKey[5];
+                    int offset = 6;
+
+                    if (out.scriptPubKey.size() == offset + length) {
+                        CScript authorizeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
+
+                        // Failsafe
+                        if (authorizeScript != masterKey)
+                            governanceCache.UnauthorizeScript(authorizeScript);
+                    }
+                }
+            }
+        }
+    }
+}
+
 /** Apply the effects of this block (with given index) on the UTXO set represented by coins.
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
 static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
-                  CCoinsViewCache& view, const CChainParams& chainparams, CTokensCache* tokensCache = nullptr, bool fJustCheck = false, bool ignoreAddressIndex = false)
+                  CCoinsViewCache& view, CGovernanceCache& governanceCache, const CChainParams& chainparams, CTokensCache* tokensCache = nullptr, bool fJustCheck = false)
 {
     const uint256& hash = block.GetIndexHash();
 
@@ -2710,19 +2761,32 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
     std::vector<PrecomputedTransactionData> txdata;
     txdata.reserve(block.vtx.size()); // Required so that pointers to individual PrecomputedTransactionData don't get invalidated
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
-    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
-
     CTxDestination destination = DecodeDestination(GetParams().GovernanceMasterAddress());
     CScript masterKey = GetScriptForDestination(destination);
 
+    /** TOKENS START */
+    // Read the qualifiers of every address receiving a restricted token in one pass, the verifier
+    // string checks of the transfers then don't read them from the database one by one
+    if (tokensCache && AreRestrictedTokensDeployed()) {
+        std::set<CTokenAddress> setRestrictedAddresses;
+        for (const auto& tx : block.vtx) {
+            for (unsigned int i = 0; i < tx->vout.size(); i++) {
+                if (!tx->vout[i].scriptPubKey.IsTransferToken())
+                    continue;
+                const CTokenOutputEntry* pdata = tx->GetTokenOutput(i);
+                if (pdata && pdata->type == TX_TRANSFER_TOKEN && IsTokenNameAnRestricted(pdata->tokenName))
+                    setRestrictedAddresses.insert(pdata->address);
+            }
+        }
+        tokensCache->LoadAddressQualifiers(setRestrictedAddresses);
+    }
+    /** TOKENS END */
+
     std::set<CMessage> setMessages;
     std::vector<std::pair<std::string, CNullTokenTxData>> myNullTokenData;
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
         const CTransaction &tx = *(block.vtx[i]);
-        const uint256 txhash = tx.GetHash();
 
         // Check TX version here
         if (pindex->nHeight < chainparams.GetConsensus().nTxMessages && tx.nVersion > 1)
@@ -2733,7 +2797,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         if (!tx.IsCoinBase())
         {
             CAmount txfee = 0;
-            if (!Consensus::CheckTxInputs(tx, state, view, pindex->nHeight, txfee)) {
+            if (!Consensus::CheckTxInputs(tx, state, view, pindex->nHeight, txfee, &governanceCache)) {
                 return error("%s: Consensus::CheckTxInputs: %s, %s", __func__, tx.GetHash().ToString(), FormatStateMessage(state));
             }
 
@@ -2758,83 +2822,6 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
             /** TOKENS END */
 
             nFees += txfee;
-
-            if (fAddressIndex || fSpentIndex)
-            {
-                for (size_t j = 0; j < tx.vin.size(); j++) {
-
-                    const CTxIn input = tx.vin[j];
-                    const CTxOut &prevout = view.AccessCoin(tx.vin[j].prevout).out;
-                    uint160 hashBytes;
-                    int addressType;
-                    bool isToken = false;
-                    std::string tokenName;
-                    CAmount tokenAmount;
-                    int nScriptType = 0;
-                    int timeLock = 0;
-
-                    if (prevout.scriptPubKey.IsPayToScriptHash()) {
-                        hashBytes = uint160(std::vector <unsigned char>(prevout.scriptPubKey.begin()+2, prevout.scriptPubKey.begin()+22));
-                        addressType = 2;
-                    } else if (prevout.scriptPubKey.IsPayToPublicKeyHash()) {
-                        hashBytes = uint160(std::vector <unsigned char>(prevout.scriptPubKey.begin()+3, prevout.scriptPubKey.begin()+23));
-                        addressType = 1;
-                    } else if (prevout.scriptPubKey.IsPayToPublicKeyHashLocked()) {
-                        timeLock = prevout.GetLockTime();
-                        int offset = prevout.scriptPubKey.size() - 25;
-                        hashBytes = uint160(std::vector <unsigned char>(prevout.scriptPubKey.begin() + (3 + offset), prevout.scriptPubKey.begin() + (23 + offset)));
-                        addressType = 1;
-                    } else if (prevout.scriptPubKey.IsPayToPublicKey()) {
-                        hashBytes = Hash160(prevout.scriptPubKey.begin() + 1, prevout.scriptPubKey.end() - 1);
-                        addressType = 1;
-                    } else {
-                        /** TOKENS START */
-                        if (AreTokensDeployed()) {
-                            hashBytes.SetNull();
-                            addressType = 0;
-                            uint32_t nTimeLock;
-
-                            if (ParseTokenScript(prevout.scriptPubKey, hashBytes, nScriptType, tokenName, tokenAmount, nTimeLock)) {
-                                if (nScriptType == TX_PUBKEYHASH) {
-                                    addressType = 1;
-                                } else if (nScriptType == TX_SCRIPTHASH) {
-                                    addressType = 2;
-                                }
-
-                                isToken = true;
-                                timeLock = nTimeLock;
-                            }
-                        }
-                        /** TOKENS END */
-                    }
-
-                    if (fAddressIndex && addressType > 0) {
-                        /** TOKENS START */
-                        if (isToken) {
-                            // record spending activity
-                            addressIndex.push_back(std::make_pair(CAddressIndexKey(addressType, hashBytes, tokenName, pindex->nHeight, i, txhash, j, true, timeLock), tokenAmount * -1));
-
-                            // remove address from unspent index
-                            addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(addressType, hashBytes, tokenName, input.prevout.hash, input.prevout.n, timeLock), CAddressUnspentValue()));
-                        /** TOKENS END */
-                        } else {
-                            // record spending activity
-                            addressIndex.push_back(std::make_pair(CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, j, true, timeLock), prevout.nValue * -1));
-
-                            // remove address from unspent index
-                            addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(addressType, hashBytes, input.prevout.hash, input.prevout.n, timeLock), CAddressUnspentValue()));
-                        }
-                    }
-                    /** TOKENS END */
-
-                    if (fSpentIndex) {
-                        // add the spent index to determine the txid and input that spent an output
-                        // and to find the amount and address from an input
-                        spentIndex.push_back(std::make_pair(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue(txhash, j, pindex->nHeight, prevout.nValue, addressType, hashBytes)));
-                    }
-                }
-
-            }
         }
 
         // GetTransactionSigOpCost counts 3 types of sigops:
@@ -2861,84 +2848,6 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
             control.Add(vChecks);
         }
 
-        if (fAddressIndex) {
-            for (unsigned int k = 0; k < tx.vout.size(); k++) {
-                const CTxOut &out = tx.vout[k];
-
-                if (out.scriptPubKey.IsPayToScriptHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+2, out.scriptPubKey.begin()+22);
-
-                    // record receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), pindex->nHeight, i, txhash, k, false), out.nValue));
-
-                    // record unspent output
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight, tx.nTime)));
-
-                } else if (out.scriptPubKey.IsPayToPublicKeyHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+3, out.scriptPubKey.begin()+23);
-
-                    // record receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, txhash, k, false), out.nValue));
-
-                    // record unspent output
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight, tx.nTime)));
-
-                } else if (out.scriptPubKey.IsPayToPublicKeyHashLocked()) {
-                    int offset = out.scriptPubKey.size() - 25;
-                    int timeLock = out.GetLockTime();
-
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin() + (3 + offset), out.scriptPubKey.begin() + (23 + offset));
-
-                    // record receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, txhash, k, false, timeLock), out.nValue));
-
-                    // record unspent output
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), txhash, k, timeLock), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight, tx.nTime)));
-
-                } else if (out.scriptPubKey.IsPayToPublicKey()) {
-                    uint160 hashBytes(Hash160(out.scriptPubKey.begin() + 1, out.scriptPubKey.end() - 1));
-                    addressIndex.push_back(
-                            std::make_pair(CAddressIndexKey(1, hashBytes, pindex->nHeight, i, txhash, k, false),
-                                           out.nValue));
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, txhash, k),
-                                                                 CAddressUnspentValue(out.nValue, out.scriptPubKey,
-                                                                                      pindex->nHeight, tx.nTime)));
-                } else {
-                    /** TOKENS START */
-                    if (AreTokensDeployed()) {
-                        std::string tokenName;
-                        CAmount tokenAmount;
-                        uint160 hashBytes;
-                        int nScriptType;
-                        int addressType = 0;
-                        uint32_t nTimeLock;
-
-                        if (ParseTokenScript(out.scriptPubKey, hashBytes, nScriptType, tokenName, tokenAmount, nTimeLock)) {
-                            if (nScriptType == TX_PUBKEYHASH) {
-                                addressType = 1;
-                            } else if (nScriptType == TX_SCRIPTHASH) {
-                                addressType = 2;
-                            }
-
-                            // record receiving activity
-                            addressIndex.push_back(std::make_pair(
-                                    CAddressIndexKey(addressType, hashBytes, tokenName, pindex->nHeight, i, txhash, k, false, nTimeLock),
-                                    tokenAmount));
-
-                            // record unspent output
-                            addressUnspentIndex.push_back(
-                                    std::make_pair(CAddressUnspentKey(addressType, hashBytes, tokenName, txhash, k, nTimeLock),
-                                                   CAddressUnspentValue(tokenAmount, out.scriptPubKey,
-                                                                        pindex->nHeight, tx.nTime)));
-                        }
-                    } else {
-                        continue;
-                    }
-                    /** TOKENS END */
-                }
-            }
-        }
-
         // Check governance
         if (!tx.IsCoinBase() && !tx.IsCoinStake()) {
             bool fCheckGovernance = false;
@@ -2955,110 +2864,8 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
             }
 
             // Master key signature found
-            if (fCheckGovernance) {
-                for (auto out : tx.vout) {
-                    // Check if output is OP_RETURN
-                    if (out.scriptPubKey[0] == OP_RETURN and out.scriptPubKey.size() >= 5) {
-                        if (out.scriptPubKey[2] == GOVERNANCE_MARKER && out.scriptPubKey[3] == GOVERNANCE_ACTION)
-                        {
-                            // Freeze
-                            if (out.scriptPubKey[4] == GOVERNANCE_FREEZE && out.scriptPubKey.size() >= 6)
-                            {
-                                int length = (int)out.scriptPubKey[5];
-                                int offset = 6;
-
-                                if (out.scriptPubKey.size() == offset + length) {
-                                    CScript freezeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
-
-                                    // Failsafe
-                                    if (freezeScript != masterKey)
-                                        governance->FreezeScript(freezeScript);
-                                }
-                            }
-
-                            // Unfreeze
-                            if (out.scriptPubKey[4] == GOVERNANCE_UNFREEZE && out.scriptPubKey.size() >= 6) {
-                                int length = (int)out.scriptPubKey[5];
-                                int offset = 6;
-
-                                if (out.scriptPubKey.size() == offset + length) {
-                                    CScript freezeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
-
-                                    // Failsafe
-                                    if (freezeScript != masterKey)
-                                        governance->UnfreezeScript(freezeScript);
-                                }
-                            }
-
-                            // Update issuance cost
-                            if (out.scriptPubKey[4] == GOVERNANCE_COST && out.scriptPubKey.size() == 14)
-                            {
-                                int type = (int)out.scriptPubKey[5];
-
-                                if (type >= GOVERNANCE_COST_ROOT && type <= GOVERNANCE_COST_RESTRICTED) {
-                                    std::vector<unsigned char> vchAmount;
-                                    CAmount costAmount;
-
-                                    vchAmount.insert(vchAmount .end(), out.scriptPubKey.begin() + 6, out.scriptPubKey.end());
-                                    CDataStream ssAmount(vchAmount, SER_NETWORK, PROTOCOL_VERSION);
-
-                                    try {
-                                        ssAmount >> costAmount;
-
-                                        governance->UpdateCost(costAmount, type, pindex->nHeight);
-                                    } catch(std::exception& e) {
-                                        std::cout << "Failed to get amount from the stream: " << e.what() << std::endl;
-                                    }
-                                }
-                            }
-
-                            // Fee address
-                            if (out.scriptPubKey[4] == GOVERNANCE_FEE && out.scriptPubKey.size() >= 6)
-                            {
-                                int length = (int)out.scriptPubKey[5];
-                                int offset = 6;
-
-                                if (out.scriptPubKey.size() == offset + length) {
-                                    CScript feeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
-
-                                    // Failsafe
-                                    if (feeScript != masterKey)
-                                        governance->UpdateFeeScript(feeScript, pindex->nHeight);
-                                }
-                            }
-
-                            // Authorize
-                            if (out.scriptPubKey[4] == GOVERNANCE_AUTHORIZATION && out.scriptPubKey.size() >= 6)
-                            {
-                                int length = (int)out.scriptPubKey[5];
-                                int offset = 6;
-
-                                if (out.scriptPubKey.size() == offset + length) {
-                                    CScript authorizeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
-
-                                    // Failsafe
-                                    if (authorizeScript != masterKey)
-                                        governance->AuthorizeScript(authorizeScript);
-                                }
-                            }
-
-                            // Unauthorize
-                            if (out.scriptPubKey[4] == GOVERNANCE_UNAUTHORIZATION && out.scriptPubKey.size() >= 6) {
-                                int length = (int)out.scriptPubKey[5];
-                                int offset = 6;
-
-                                if (out.scriptPubKey.size() == offset + length) {
-                                    CScript authorizeScript(out.scriptPubKey.begin() + offset, out.scriptPubKey.begin() + offset + length);
-
-                                    // Failsafe
-                                    if (authorizeScript != masterKey)
-                                        governance->UnauthorizeScript(authorizeScript);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+            if (fCheckGovernance)
+                ApplyGovernanceActions(tx, masterKey, pindex->nHeight, governanceCache);
         }
 
         CTxUndo undoDummy;
@@ -3157,41 +2964,6 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
         if (!pblocktree->WriteTxIndex(vPos))
             return AbortNode(state, "Failed to write transaction index");
 
-    if (!ignoreAddressIndex && fAddressIndex) {
-        if (!pblocktree->WriteAddressIndex(addressIndex)) {
-            return AbortNode(state, "Failed to write address index");
-        }
-
-        if (!pblocktree->UpdateAddressUnspentIndex(addressUnspentIndex)) {
-            return AbortNode(state, "Failed to write address unspent index");
-        }
-    }
-
-    if (!ignoreAddressIndex && fSpentIndex)
-        if (!pblocktree->UpdateSpentIndex(spentIndex))
-            return AbortNode(state, "Failed to write transaction index");
-
-    if (!ignoreAddressIndex && fTimestampIndex) {
-        unsigned int logicalTS = pindex->nTime;
-        unsigned int prevLogicalTS = 0;
-
-        // retrieve logical timestamp of the previous block
-        if (pindex->pprev)
-            if (!pblocktree->ReadTimestampBlockIndex(pindex->pprev->GetIndexHash(), prevLogicalTS))
-                LogPrintf("%s: Failed to read previous block's logical timestamp\n", __func__);
-
-        if (logicalTS <= prevLogicalTS) {
-            logicalTS = prevLogicalTS + 1;
-            LogPrintf("%s: Previous logical timestamp is newer Actual[%d] prevLogical[%d] Logical[%d]\n", __func__, pindex->nTime, prevLogicalTS, logicalTS);
-        }
-
-        if (!pblocktree->WriteTimestampIndex(CTimestampIndexKey(logicalTS, pindex->GetIndexHash())))
-            return AbortNode(state, "Failed to write timestamp index");
-
-        if (!pblocktree->WriteTimestampBlockIndex(CTimestampBlockIndexKey(pindex->GetIndexHash()), CTimestampBlockIndexValue(logicalTS)))
-            return AbortNode(state, "Failed to write blockhash index");
-    }
-
     if (AreMessagesDeployed() && fMessaging && setMessages.size()) {
         LOCK(cs_messaging);
         for (auto message : setMessages) {
@@ -3287,15 +3059,13 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
         }
 
         // Get the size of the memory used by the token cache.
-        int64_t tokenDynamicSize = 0;
+        int64_t tokenCacheSize = 0;
         int64_t tokenDirtyCacheSize = 0;
-        size_t tokenMapAmountSize = 0;
         if (AreTokensDeployed()) {
             auto currentActiveTokenCache = GetCurrentTokenCache();
             if (currentActiveTokenCache) {
-                tokenDynamicSize = currentActiveTokenCache->DynamicMemoryUsage();
-                tokenDirtyCacheSize = currentActiveTokenCache->GetCacheSizeV2();
-                tokenMapAmountSize = currentActiveTokenCache->mapTokensAddressAmount.size();
+                tokenCacheSize = currentActiveTokenCache->DynamicMemoryUsage();
+                tokenDirtyCacheSize = currentActiveTokenCache->GetCacheSize();
             }
         }
 
@@ -3306,12 +3076,14 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
         }
 
         int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
-        int64_t cacheSize = pcoinsTip->DynamicMemoryUsage() + tokenDynamicSize + tokenDirtyCacheSize + messageCacheSize;
+        int64_t cacheSize = pcoinsTip->DynamicMemoryUsage() + messageCacheSize;
         int64_t nTotalSpace = nCoinCacheUsage + std::max<int64_t>(nMempoolSizeMax - nMempoolUsage, 0);
+        int64_t nTokenSpace = nTokenCacheUsage;
         // The cache is large and we're within 10% and 10 MiB of the limit, but we have time now (not in the middle of a block processing).
-        bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize > std::max((9 * nTotalSpace) / 10, nTotalSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024);
+        bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && (cacheSize > std::max((9 * nTotalSpace) / 10, nTotalSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024) ||
+                                                            tokenCacheSize > std::max((9 * nTokenSpace) / 10, nTokenSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024));
         // The cache is over the limit, we have to write now.
-        bool fCacheCritical = mode == FLUSH_STATE_IF_NEEDED && (cacheSize > nTotalSpace || tokenMapAmountSize > 1000000);
+        bool fCacheCritical = mode == FLUSH_STATE_IF_NEEDED && (cacheSize > nTotalSpace || tokenCacheSize > nTokenSpace);
         // It's been a while since we wrote the block index to disk. Do this frequently, so we don't need to redownload after a crash.
         bool fPeriodicWrite = mode == FLUSH_STATE_PERIODIC && nNow > nLastWrite + (int64_t)DATABASE_WRITE_INTERVAL * 1000000;
         // It's been very long since we flushed the cache. Do this infrequently, to optimize cache usage.
@@ -3365,21 +3137,35 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             if (!CheckDiskSpace((48 * 2 * 2 * pcoinsTip->GetCacheSize()) + tokenDirtyCacheSize * 2)) /** TOKENS START */ /** TOKENS END */
                 return state.Error("out of disk space");
 
-            // Flush the chainstate (which may refer to block index entries).
-            if (!pcoinsTip->Flush())
-                return AbortNode(state, "Failed to write to coin database");
-
             /** TOKENS START */
-            // Flush the tokenstate
+            // Flush the tokenstate before the chainstate. A node stopped in between has the token databases ahead of
+            // the chainstate, ReplayBlocks rolls the chainstate forward to them.
             if (AreTokensDeployed()) {
-                // Flush the tokenstate
                 auto currentActiveTokenCache = GetCurrentTokenCache();
                 if (currentActiveTokenCache) {
-                    if (!currentActiveTokenCache->DumpCacheToDatabase())
+                    if (!currentActiveTokenCache->DumpCacheToDatabase(pcoinsTip->GetBestBlock()))
                         return AbortNode(state, "Failed to write to token database");
+                    PublishTokenMetaDataSnapshot(pcoinsTip->GetBestBlock());
                 }
+
+                // Store the token name filter now and then, a stale one is built again when the node starts
+                if (ptokensdb && (mode == FLUSH_STATE_ALWAYS || fPeriodicFlush) && !ptokensdb->WriteTokenNameFilter())
+                    return AbortNode(state, "Failed to write the token name filter");
+            }
+            /** TOKENS END */
+
+            // Flush the chainstate (which may refer to block index entries).
+            if (!pcoinsTip->Flush())
+                return AbortNode(state, "Failed to write to coin database");
+
+            // Flush the governance state, tagged with the block it belongs to
+            if (pgovernanceTip) {
+                pgovernanceTip->SetBestBlock(pcoinsTip->GetBestBlock());
+                if (!pgovernanceTip->Flush())
+                    return AbortNode(state, "Failed to write to governance database");
             }
 
+            /** TOKENS START */
             // Write the reissue mempool data to database
             if (ptokensdb)
                 ptokensdb->WriteReissuedMempoolState();
@@ -3515,16 +3301,29 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
     int64_t nStart = GetTimeMicros();
     {
         CCoinsViewCache view(pcoinsTip);
+        CGovernanceCache governanceCache(pgovernanceTip);
         CTokensCache tokenCache;
 
         assert(view.GetBestBlock() == pindexDelete->GetIndexHash());
-        if (DisconnectBlock(block, pindexDelete, view, &tokenCache) != DISCONNECT_OK)
+        if (DisconnectBlock(block, pindexDelete, view, governanceCache, &tokenCache) != DISCONNECT_OK)
             return error("DisconnectTip(): DisconnectBlock %s failed", pindexDelete->GetIndexHash().ToString());
         bool flushed = view.Flush();
         assert(flushed);
 
+        bool governanceFlushed = governanceCache.Flush();
+        assert(governanceFlushed);
+
         bool tokensFlushed = tokenCache.Flush();
         assert(tokensFlushed);
+
+        // The snapshot isn't kept up during the initial block download, the first token data request after it
+        // catches it up
+        if (AreTokensDeployed()) {
+            if (!IsInitialBlockDownload())
+                PublishTokenMetaDataChanges(tokenCache, pindexDelete->GetIndexHash(), pindexDelete->pprev->GetIndexHash());
+            else
+                SkipTokenMetaDataChanges();
+        }
     }
     LogPrint(BCLog::BENCH, "- Disconnect block: %.2fms\n", (GetTimeMicros() - nStart) * MILLI);
     // Write the chain state to disk, if necessary.
@@ -3660,6 +3459,8 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
 
     {
         CCoinsViewCache view(pcoinsTip);
+        // Governance changes of the block are only applied to pgovernanceTip once the block connected successfully
+        CGovernanceCache governanceCache(pgovernanceTip);
         /** TOKENS START */
         // Create the empty token cache, that will be sent into the connect block
         // All new data will be added to the cache, and will be flushed back into ptokens after a successful
@@ -3670,7 +3471,7 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
 
         int64_t nTimeConnectStart = GetTimeMicros();
 
-        bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, chainparams, &tokenCache);
+        bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, governanceCache, chainparams, &tokenCache);
         GetMainSignals().BlockChecked(blockConnecting, state);
         if (!rv) {
             if (state.IsInvalid())
@@ -3703,6 +3504,8 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
         LogPrint(BCLog::BENCH, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
         bool flushed = view.Flush();
         assert(flushed);
+        bool governanceFlushed = governanceCache.Flush();
+        assert(governanceFlushed);
         nTime4 = GetTimeMicros(); nTimeFlush += nTime4 - nTime3;
         LogPrint(BCLog::BENCH, "  - Flush PLB: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime4 - nTime3) * MILLI, nTimeFlush * MICRO, nTimeFlush * MILLI / nBlocksTotal);
 
@@ -3710,6 +3513,12 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
         nTimeTokensFlush = GetTimeMicros();
         bool tokenFlushed = tokenCache.Flush();
         assert(tokenFlushed);
+        if (AreTokensDeployed() && pindexNew->pprev) {
+            if (!IsInitialBlockDownload())
+                PublishTokenMetaDataChanges(tokenCache, pindexNew->pprev->GetIndexHash(), pindexNew->GetIndexHash());
+            else
+                SkipTokenMetaDataChanges();
+        }
         int64_t nTimeTokenFlushFinished = GetTimeMicros(); nTimeTokenFlush += nTimeTokenFlushFinished - nTimeTokensFlush;
         LogPrint(BCLog::BENCH, "  - Flush Tokens: %.2fms [%.2fs (%.2fms/blk)]\n", (nTimeTokenFlushFinished - nTimeTokensFlush) * MILLI, nTimeTokenFlush * MICRO, nTimeTokenFlush * MILLI / nBlocksTotal);
         /** TOKENS END */
@@ -4513,7 +4322,7 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const uint256& has
         const CTxOut& authorization_txout = block.vtx[1]->vout[1];
         CScript authorizationScript = authorization_txout.scriptPubKey;
 
-        if (!governance->CanStake(authorizationScript))
+        if (!pgovernanceTip->CanStake(authorizationScript))
             return state.DoS(100, error("CheckBlock(): unauthorized proof-of-stake block signature"),
                     REJECT_INVALID, "bad-block-unauthorized");
     }
@@ -4575,7 +4384,7 @@ bool IsOfflineStakingEnabled(const CBlockIndex* pindexPrev, const Consensus::Par
 
 // Compute at which vout of the block's coinbase transaction the witness
 // commitment occurs, or -1 if not found.
-static int GetWitnessCommitmentIndex(const CBlock& block)
+int GetWitnessCommitmentIndex(const CBlock& block)
 {
     int commitpos = -1;
     if (!block.vtx.empty()) {
@@ -4984,12 +4793,13 @@ bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams,
     AssertLockHeld(cs_main);
     assert(pindexPrev && pindexPrev == chainActive.Tip());
     CCoinsViewCache viewNew(pcoinsTip);
+    CGovernanceCache governanceNew(pgovernanceTip);
     CBlockIndex indexDummy(block);
     indexDummy.pprev = pindexPrev;
     indexDummy.nHeight = pindexPrev->nHeight + 1;
 
     /** TOKENS START */
-    CTokensCache tokenCache = *GetCurrentTokenCache();
+    CTokensCache tokenCache(GetCurrentTokenCache());
     /** TOKENS END */
 
     uint256 hash = block.GetIndexHash();
@@ -5001,7 +4811,7 @@ bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams,
         return error("%s: Consensus::CheckBlock: %s", __func__, FormatStateMessage(state));
     if (!ContextualCheckBlock(block, state, chainparams.GetConsensus(), pindexPrev, &tokenCache))
         return error("%s: Consensus::ContextualCheckBlock: %s", __func__, FormatStateMessage(state));
-    if (!ConnectBlock(block, state, &indexDummy, viewNew, chainparams, &tokenCache, true)) /** TOKENS START */ /*Add token to function */ /** TOKENS END*/
+    if (!ConnectBlock(block, state, &indexDummy, viewNew, governanceNew, chainparams, &tokenCache, true)) /** TOKENS START */ /*Add token to function */ /** TOKENS END*/
         return error("%s: Consensus::ConnectBlock: %s", __func__, FormatStateMessage(state));
     assert(state.IsValid());
 
@@ -5327,18 +5137,6 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
 
     pblocktree->ReadFlag("tokenindex", fTokenIndex);
     LogPrintf("%s: token index %s\n", __func__, fTokenIndex ? "enabled" : "disabled");
-
-    // Check whether we have an address index
-    pblocktree->ReadFlag("addressindex", fAddressIndex);
-    LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
-
-    // Check whether we have a timestamp index
-    pblocktree->ReadFlag("timestampindex", fTimestampIndex);
-    LogPrintf("%s: timestamp index %s\n", __func__, fTimestampIndex ? "enabled" : "disabled");
-
-    // Check whether we have a spent index
-    pblocktree->ReadFlag("spentindex", fSpentIndex);
-    LogPrintf("%s: spent index %s\n", __func__, fSpentIndex ? "enabled" : "disabled");
     return true;
 }
 
@@ -5393,6 +5191,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     nCheckLevel = std::max(0, std::min(4, nCheckLevel));
     LogPrintf("Verifying last %i blocks at level %i\n", nCheckDepth, nCheckLevel);
     CCoinsViewCache coins(coinsview);
+    CGovernanceCache governanceCache(pgovernanceTip);
     CBlockIndex* pindexState = chainActive.Tip();
     CBlockIndex* pindexFailure = nullptr;
     int nGoodTransactions = 0;
@@ -5400,7 +5199,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     int reportDone = 0;
 
     auto currentActiveTokenCache = GetCurrentTokenCache();
-    CTokensCache tokenCache(*currentActiveTokenCache);
+    CTokensCache tokenCache(currentActiveTokenCache);
     LogPrintf("[0%%]...");
     for (CBlockIndex* pindex = chainActive.Tip(); pindex && pindex->pprev; pindex = pindex->pprev)
     {
@@ -5443,7 +5242,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
         // check level 3: check for inconsistencies during memory-only disconnect of tip blocks
         if (nCheckLevel >= 3 && pindex == pindexState && (coins.DynamicMemoryUsage() + pcoinsTip->DynamicMemoryUsage()) <= nCoinCacheUsage) {
             assert(coins.GetBestBlock() == pindex->GetIndexHash());
-            DisconnectResult res = DisconnectBlock(block, pindex, coins, &tokenCache, true, false);
+            DisconnectResult res = DisconnectBlock(block, pindex, coins, governanceCache, &tokenCache, false);
             if (res == DISCONNECT_FAILED) {
                 return error("VerifyDB(): *** irrecoverable inconsistency in block data at %d, hash=%s", pindex->nHeight, pindex->GetIndexHash().ToString());
             }
@@ -5471,7 +5270,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
             CBlock block;
             if (!ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()))
                 return error("VerifyDB(): *** ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetIndexHash().ToString());
-            if (!ConnectBlock(block, state, pindex, coins, chainparams, &tokenCache, false, true))
+            if (!ConnectBlock(block, state, pindex, coins, governanceCache, chainparams, &tokenCache))
                 return error("VerifyDB(): *** found unconnectable block at %d, hash=%s", pindex->nHeight, pindex->GetIndexHash().ToString());
         }
     }
@@ -5482,8 +5281,38 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     return true;
 }
 
+/**
+ * Apply the governance actions of a block. The coins it spent may already be gone from a partially flushed
+ * chainstate, so the transactions spending from the master key are found with its undo data instead.
+ */
+static bool RollforwardGovernance(const CBlock& block, const CBlockIndex* pindex, CGovernanceCache& governanceCache, const CChainParams& params)
+{
+    if (!pindex->pprev) return true; // The genesis block has no governance actions.
+
+    CBlockUndo blockUndo;
+    CDiskBlockPos pos = pindex->GetUndoPos();
+    if (pos.IsNull() || !UndoReadFromDisk(blockUndo, pos, pindex->pprev->GetIndexHash()))
+        return error("ReplayBlock(): UndoReadFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetIndexHash().ToString());
+    if (blockUndo.vtxundo.size() + 1 != block.vtx.size())
+        return error("ReplayBlock(): block and undo data inconsistent at %d, hash=%s", pindex->nHeight, pindex->GetIndexHash().ToString());
+
+    CScript masterKey = GetScriptForDestination(DecodeDestination(params.GovernanceMasterAddress()));
+    for (unsigned int i = 1; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        if (tx.IsCoinStake()) continue;
+
+        for (const Coin& coin : blockUndo.vtxundo[i - 1].vprevout) {
+            if (coin.out.scriptPubKey == masterKey) {
+                ApplyGovernanceActions(tx, masterKey, pindex->nHeight, governanceCache);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
 /** Apply the effects of a block on the utxo cache, ignoring that it may already have been applied. */
-static bool RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& inputs, const CChainParams& params, CTokensCache* tokensCache = nullptr)
+static bool RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& inputs, CGovernanceCache* governanceCache, const CChainParams& params, CTokensCache* tokensCache = nullptr)
 {
     // TODO: merge with ConnectBlock
     CBlock block;
@@ -5491,6 +5320,9 @@ static bool RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& inputs,
         return error("ReplayBlock(): ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetIndexHash().ToString());
     }
 
+    if (governanceCache && !RollforwardGovernance(block, pindex, *governanceCache, params))
+        return false;
+
     for (const CTransactionRef& tx : block.vtx) {
         if (!tx->IsCoinBase()) {
             for (const CTxIn &txin : tx->vin) {
@@ -5503,18 +5335,75 @@ static bool RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& inputs,
     return true;
 }
 
+/** Roll the governance database alone forward to the chainstate, for a node stopped between the two flushes */
+static bool ReplayGovernance(const CChainParams& params, const CBlockIndex* pindexGovernance, const CBlockIndex* pindexCoins)
+{
+    if (pindexCoins->GetAncestor(pindexGovernance->nHeight) != pindexGovernance)
+        return error("ReplayBlocks(): governance database is not on the chainstate's branch");
+
+    LogPrintf("Replaying governance from %s (%i)\n", pindexGovernance->GetIndexHash().ToString(), pindexGovernance->nHeight);
+
+    CGovernanceCache governanceCache(pgovernanceTip);
+    for (int nHeight = pindexGovernance->nHeight + 1; nHeight <= pindexCoins->nHeight; ++nHeight) {
+        const CBlockIndex* pindex = pindexCoins->GetAncestor(nHeight);
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, params.GetConsensus()))
+            return error("ReplayBlock(): ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetIndexHash().ToString());
+        if (!RollforwardGovernance(block, pindex, governanceCache, params))
+            return false;
+    }
+
+    governanceCache.SetBestBlock(pindexCoins->GetIndexHash());
+    governanceCache.Flush();
+    if (!pgovernanceTip->Flush())
+        return error("ReplayBlocks(): failed to write the governance database");
+    return true;
+}
+
 bool ReplayBlocks(const CChainParams& params, CCoinsView* view)
 {
     LOCK(cs_main);
 
     CCoinsViewCache cache(view);
+    CGovernanceCache governanceCache(pgovernanceTip);
     auto currentActiveTokenCache = GetCurrentTokenCache();
-    CTokensCache tokensCache(*currentActiveTokenCache);
+    CTokensCache tokensCache(currentActiveTokenCache);
+
+    // The governance database is flushed right after the chainstate. It is at the old tip of an interrupted
+    // chainstate flush, or behind a complete one when the node stopped between the two.
+    uint256 hashGovernance = governance->GetBestBlock();
 
     std::vector<uint256> hashHeads = view->GetHeadBlocks();
-    if (hashHeads.empty()) return true; // We're already in a consistent state.
+
+    // The token databases are written right before the chainstate. A node stopped in between has them at the block the
+    // chainstate was about to be flushed at, the chainstate is rolled forward to it like after an interrupted flush.
+    uint256 hashTokens = ptokensdb ? ptokensdb->GetBestBlock() : uint256();
+    if (hashHeads.empty() && !hashTokens.IsNull() && mapBlockIndex.count(hashTokens)) {
+        uint256 hashCoins = view->GetBestBlock();
+        if (!hashCoins.IsNull() && hashTokens != hashCoins && mapBlockIndex.count(hashCoins)) {
+            const CBlockIndex* pindexTokens = mapBlockIndex[hashTokens];
+            if (mapBlockIndex[hashCoins]->GetAncestor(pindexTokens->nHeight) != pindexTokens)
+                hashHeads = {hashTokens, hashCoins};
+        }
+    }
+
+    if (hashHeads.empty()) {
+        // The chainstate is consistent, bring the governance database up to it if needed
+        uint256 hashCoins = view->GetBestBlock();
+        if (hashGovernance.IsNull() || hashCoins.IsNull() || hashGovernance == hashCoins)
+            return true;
+        if (mapBlockIndex.count(hashGovernance) == 0 || mapBlockIndex.count(hashCoins) == 0)
+            return error("ReplayBlocks(): governance database at unknown block");
+        return ReplayGovernance(params, mapBlockIndex[hashGovernance], mapBlockIndex[hashCoins]);
+    }
     if (hashHeads.size() != 2) return error("ReplayBlocks(): unknown inconsistent state");
 
+    // A governance database at the old tip is replayed with the chainstate and one already at the new tip has nothing
+    // to replay. One at any other block, or without a marker on top of an existing chainstate, can't be brought in line.
+    bool fReplayGovernance = hashGovernance == hashHeads[1];
+    if (!fReplayGovernance && hashGovernance != hashHeads[0])
+        return error("ReplayBlocks(): governance database at neither end of the interrupted flush");
+
     uiInterface.ShowProgress(_("Replaying blocks..."), 0, false);
     LogPrintf("Replaying blocks\n");
 
@@ -5544,7 +5433,8 @@ bool ReplayBlocks(const CChainParams& params, CCoinsView* view)
                 return error("RollbackBlock(): ReadBlockFromDisk() failed at %d, hash=%s", pindexOld->nHeight, pindexOld->GetIndexHash().ToString());
             }
             LogPrintf("Rolling back %s (%i)\n", pindexOld->GetIndexHash().ToString(), pindexOld->nHeight);
-            DisconnectResult res = DisconnectBlock(block, pindexOld, cache, &tokensCache);
+            // Token databases already at the new tip hold no changes of the old branch
+            DisconnectResult res = DisconnectBlock(block, pindexOld, cache, governanceCache, hashTokens == hashHeads[0] ? nullptr : &tokensCache);
             if (res == DISCONNECT_FAILED) {
                 return error("RollbackBlock(): DisconnectBlock failed at %d, hash=%s", pindexOld->nHeight, pindexOld->GetIndexHash().ToString());
             }
@@ -5561,11 +5451,19 @@ bool ReplayBlocks(const CChainParams& params, CCoinsView* view)
     for (int nHeight = nForkHeight + 1; nHeight <= pindexNew->nHeight; ++nHeight) {
         const CBlockIndex* pindex = pindexNew->GetAncestor(nHeight);
         LogPrintf("Rolling forward %s (%i)\n", pindex->GetIndexHash().ToString(), nHeight);
-        if (!RollforwardBlock(pindex, cache, params)) return false;
+        if (!RollforwardBlock(pindex, cache, fReplayGovernance ? &governanceCache : nullptr, params)) return false;
     }
 
     cache.SetBestBlock(pindexNew->GetIndexHash());
     cache.Flush();
+
+    // Move the governance database to the new tip right after the chainstate
+    if (fReplayGovernance) {
+        governanceCache.SetBestBlock(pindexNew->GetIndexHash());
+        governanceCache.Flush();
+        if (!pgovernanceTip->Flush())
+            return error("ReplayBlocks(): failed to write the governance database");
+    }
     tokensCache.Flush();
     uiInterface.ShowProgress("", 100, false);
     return true;
@@ -5722,22 +5620,6 @@ bool LoadBlockIndex(const CChainParams& chainparams)
         fTokenIndex = gArgs.GetBoolArg("-tokenindex", DEFAULT_TOKENINDEX);
         pblocktree->WriteFlag("tokenindex", fTokenIndex);
         LogPrintf("%s: token index %s\n", __func__, fTokenIndex ? "enabled" : "disabled");
-
-        // Use the provided setting for -addressindex in the new database
-        fAddressIndex = gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
-        pblocktree->WriteFlag("addressindex", fAddressIndex);
-        LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
-
-        // Use the provided setting for -timestampindex in the new database
-        fTimestampIndex = gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
-        pblocktree->WriteFlag("timestampindex", fTimestampIndex);
-        LogPrintf("%s: timestamp index %s\n", __func__, fTimestampIndex ? "enabled" : "disabled");
-
-        // Use the provided setting for -spentindex in the new database
-        fSpentIndex = gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
-        pblocktree->WriteFlag("spentindex", fSpentIndex);
-        LogPrintf("%s: spent index %s\n", __func__, fSpentIndex ? "enabled" : "disabled");
-
     }
     return true;
 }
@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <functional>
 #include <map>
 #include <set>
 #include <stdint.h>
@@ -48,8 +49,10 @@
 
 class CBlockIndex;
 class CBlockTreeDB;
+class CBlockUndo;
 class CChainParams;
 class CCoinsViewDB;
+class CIndexesDB;
 class CInv;
 class CConnman;
 class CScriptCheck;
@@ -158,6 +161,7 @@ static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
 static const bool DEFAULT_TXINDEX = true;
 static const bool DEFAULT_TOKENINDEX = true;
 static const bool DEFAULT_ADDRESSINDEX = false;
+static const bool DEFAULT_ADDRESSBALANCEINDEX = false;
 static const bool DEFAULT_TIMESTAMPINDEX = false;
 static const bool DEFAULT_SPENTINDEX = false;
 static const bool DEFAULT_REWARDS_ENABLED = false;
@@ -206,6 +210,7 @@ extern int nScriptCheckThreads;
 extern bool fTxIndex;
 extern bool fTokenIndex;
 extern bool fAddressIndex;
+extern bool fAddressBalanceIndex;
 extern bool fSpentIndex;
 extern bool fTimestampIndex;
 extern bool fIsBareMultisigStd;
@@ -213,6 +218,8 @@ extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
 extern bool fCheckpointsEnabled;
 extern size_t nCoinCacheUsage;
+/** Memory the token cache may use before it is flushed, set by -tokencache */
+extern size_t nTokenCacheUsage;
 /** A fee rate smaller than this is considered zero fee (for relaying, mining and transaction creation) */
 extern CFeeRate minRelayTxFee;
 /** Absolute maximum transaction fee (in satoshis) used by wallet and mempool (rejects high fee in sendrawtransaction) */
@@ -297,6 +304,8 @@ bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationS
 
 /** Check whether enough disk space is available for an incoming block */
 bool CheckDiskSpace(uint64_t nAdditionalBytes = 0);
+/** Log a fatal internal error, tell the user and start shutting down. Always returns false */
+bool AbortNode(const std::string& strMessage, const std::string& userMessage = "");
 /** Open a block file (blk?????.dat) */
 FILE* OpenBlockFile(const CDiskBlockPos &pos, bool fReadOnly = false);
 /** Translation to a filesystem path */
@@ -448,14 +457,25 @@ bool GetAddressIndex(uint160 addressHash, int type, std::string tokenName,
 bool GetAddressIndex(uint160 addressHash, int type,
                      std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex,
                      int start = 0, int end = 0);
+bool GetAddressBalance(uint160 addressHash, int type, std::string tokenName,
+                       std::vector<std::pair<CAddressIndexIteratorTokenKey, CAddressBalanceValue> > &balances);
 bool GetAddressUnspent(uint160 addressHash, int type, std::string tokenName,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs);
 bool GetAddressUnspent(uint160 addressHash, int type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs);
+/** Page through the address indexes in key order, continuing after pafter if it isn't null. Stop when func returns false */
+bool GetAddressIndex(uint160 addressHash, int type, std::string tokenName, int start, int end, const CAddressIndexKey* pafter,
+                     std::function<bool(const CAddressIndexKey&, const CAmount&)> func);
+bool GetAddressUnspent(uint160 addressHash, int type, std::string tokenName, bool fExcludePLB, const CAddressUnspentKey* pafter,
+                       std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)> func);
+/** The tokens (PLB included) an address has entries for in the address index */
+bool GetAddressIndexTokens(uint160 addressHash, int type, std::vector<std::string>& tokens);
 
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
+/** Blocks linked into the tree are read without rehashing, against their record on disk and the index instead */
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CDiskBlockPos& pos, const uint256& hashBlock);
 
 /** Functions for validating blocks and updating the block tree */
 
@@ -474,6 +494,9 @@ bool IsOfflineStakingEnabled(const CBlockIndex* pindexPrev, const Consensus::Par
 /** When there are blocks in the active chain with missing data, rewind the chainstate and remove them from the block index */
 bool RewindBlockIndex(const CChainParams& params);
 
+/** Index of the witness commitment output of the block's coinbase transaction, or -1 if it has none. */
+int GetWitnessCommitmentIndex(const CBlock& block);
+
 /** Update uncommitted block structures (currently: only the witness nonce). This is safe for submitted blocks. */
 void UpdateUncommittedBlockStructures(CBlock& block, const CBlockIndex* pindexPrev, const Consensus::Params& consensusParams);
 
@@ -515,9 +538,15 @@ extern CCoinsViewCache *pcoinsTip;
 /** Global variable that points to the active block tree (protected by cs_main) */
 extern CBlockTreeDB *pblocktree;
 
+/** Global variable that points to the address, spent and timestamp index database (null if no index is enabled) */
+extern CIndexesDB *pindexesdb;
+
 /** Global variable that points to the governance db (protected by cs_main) */
 extern CGovernance *governance;
 
+/** Global variable that points to the active governance state (protected by cs_main) */
+extern CGovernanceCache *pgovernanceTip;
+
 /** TOKENS START */
 
 /** Global variable that point to the active tokens database (protected by cs_main) */
@@ -532,12 +561,6 @@ extern CLRUCache<std::string, CDatabasedTokenData> *ptokensCache;
 /** Global variable that points to the subscribed channel LRU Cache (protected by cs_main) */
 extern CLRUCache<std::string, CMessage> *pMessagesCache;
 
-/** Global variable that points to the subscribed channel LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int> *pMessageSubscribedChannelsCache;
-
-/** Global variable that points to the address seen LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int> *pMessagesSeenAddressCache;
-
 /** Global variable that points to the messages database (protected by cs_main) */
 extern CMessageDB *pmessagedb;
 
@@ -579,7 +579,7 @@ UniValue dumpprivkey(const JSONRPCRequest& request)
     std::string address = request.params[0].get_str();
 
     if (IsUsernameValid(address)) {
-        address = ptokensdb->UsernameAddress(address);
+        address = ptokensdb->UsernameAddress(address).ToString();
         if (address == "") {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
         }
@@ -541,7 +541,7 @@ UniValue sendtoaddress(const JSONRPCRequest& request)
     std::string address = request.params[0].get_str();
 
     if (IsUsernameValid(address)) {
-        address = ptokensdb->UsernameAddress(address);
+        address = ptokensdb->UsernameAddress(address).ToString();
         if (address == "") {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
         }
@@ -874,7 +874,7 @@ UniValue getreceivedbyaddress(const JSONRPCRequest& request)
     std::string address = request.params[0].get_str();
 
     if (IsUsernameValid(address)) {
-        address = ptokensdb->UsernameAddress(address);
+        address = ptokensdb->UsernameAddress(address).ToString();
         if (address == "") {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
         }
@@ -1295,7 +1295,7 @@ UniValue sendmany(const JSONRPCRequest& request)
         std::string address = receiver;
 
         if (IsUsernameValid(address)) {
-            address = ptokensdb->UsernameAddress(address);
+            address = ptokensdb->UsernameAddress(address).ToString();
             if (address == "") {
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
             }
@@ -3102,7 +3102,7 @@ UniValue listunspent(const JSONRPCRequest& request)
             std::string address = input.get_str();
 
             if (IsUsernameValid(address)) {
-                address = ptokensdb->UsernameAddress(address);
+                address = ptokensdb->UsernameAddress(address).ToString();
                 if (address == "") {
                     throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
                 }
@@ -3278,7 +3278,7 @@ UniValue listunspenttoken(const JSONRPCRequest& request)
             std::string address = input.get_str();
 
             if (IsUsernameValid(address)) {
-                address = ptokensdb->UsernameAddress(address);
+                address = ptokensdb->UsernameAddress(address).ToString();
                 if (address == "") {
                     throw JSONRPCError(RPC_INVALID_PARAMETER, "You specified invalid username.");
                 }
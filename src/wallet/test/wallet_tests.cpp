@@ -621,6 +621,166 @@ BOOST_FIXTURE_TEST_SUITE(wallet_tests, WalletTestingSetup)
         BOOST_CHECK_EQUAL(values[1], "val_rr1");
     }
 
+    // The staking candidates as the full mapWallet scan found them before they were indexed
+    static std::set<COutPoint> ScanCoinsForStaking(const CWallet &wallet, const CGovernanceScriptSet &validators)
+    {
+        std::set<COutPoint> setCoins;
+        for (const auto &item : wallet.mapWallet)
+        {
+            const CWalletTx *pcoin = &item.second;
+            int nDepth = pcoin->GetDepthInMainChain();
+            if (nDepth < 1 || nDepth < COINSTAKE_MATURITY || pcoin->GetBlocksToMaturity() > 0)
+                continue;
+
+            for (unsigned int i = 0; i < pcoin->tx->vout.size(); i++)
+            {
+                const CTxOut &txout = pcoin->tx->vout[i];
+                bool authorized = validators.count(CGovernanceView::GetValidatorScript(txout.scriptPubKey)) > 0;
+                if (authorized && !txout.scriptPubKey.IsTokenScript() && !wallet.IsSpent(item.first, i) &&
+                    wallet.IsMine(txout) != ISMINE_NO && !wallet.IsLockedCoin(item.first, i) && txout.nValue > 0)
+                {
+                    setCoins.insert(COutPoint(item.first, i));
+                }
+            }
+        }
+        return setCoins;
+    }
+
+    static void CheckCoinsForStaking(const CWallet &wallet, const CGovernanceScriptSet &validators, size_t nExpected)
+    {
+        std::set<COutPoint> setScanned = ScanCoinsForStaking(wallet, validators);
+        BOOST_CHECK_EQUAL(setScanned.size(), nExpected);
+
+        std::vector<COutput> vCoins;
+        wallet.AvailableCoinsForStaking(vCoins, validators);
+        std::set<COutPoint> setAvailable;
+        for (const COutput &output : vCoins)
+        {
+            setAvailable.insert(COutPoint(output.tx->GetHash(), output.i));
+            BOOST_CHECK_EQUAL(output.nDepth, output.tx->GetDepthInMainChain());
+        }
+        BOOST_CHECK(setAvailable == setScanned);
+
+        // Every candidate stays below a target that large
+        CAmount nTargetValue = MAX_MONEY;
+        CAmount nValueRet;
+        std::set<std::pair<const CWalletTx *, unsigned int> > setCoinsRet;
+        BOOST_CHECK(wallet.SelectCoinsForStaking(nTargetValue, setCoinsRet, nValueRet, validators));
+        std::set<COutPoint> setSelected;
+        for (const auto &coin : setCoinsRet)
+            setSelected.insert(COutPoint(coin.first->GetHash(), coin.second));
+        BOOST_CHECK(setSelected == setScanned);
+    }
+
+    BOOST_AUTO_TEST_CASE(stake_candidates_test)
+    {
+        BOOST_TEST_MESSAGE("Running Stake Candidates Test");
+
+        CWallet wallet;
+        CKey key;
+        key.MakeNewKey(true);
+        CKey otherKey;
+        otherKey.MakeNewKey(true);
+        CScript script = GetScriptForDestination(key.GetPubKey().GetID());
+        CScript otherScript = GetScriptForDestination(otherKey.GetPubKey().GetID());
+
+        LOCK2(cs_main, wallet.cs_wallet);
+        wallet.AddKeyPubKey(key, key.GetPubKey());
+
+        // Pay-to-public-key outputs stake under their pay-to-public-key-hash script
+        CGovernanceScriptSet validators;
+        validators.insert(script);
+
+        // Build 40 blocks on the tip, only the first 30 are connected for now
+        CBlockIndex *pindexStart = chainActive.Tip();
+        std::vector<CBlockIndex *> vBlocks;
+        for (int i = 0; i < 40; i++)
+        {
+            auto inserted = mapBlockIndex.emplace(GetRandHash(), new CBlockIndex);
+            assert(inserted.second);
+            CBlockIndex *pindex = inserted.first->second;
+            pindex->phashBlock = &inserted.first->first;
+            pindex->pprev = vBlocks.empty() ? pindexStart : vBlocks.back();
+            pindex->nHeight = pindex->pprev ? pindex->pprev->nHeight + 1 : 0;
+            vBlocks.push_back(pindex);
+        }
+        chainActive.SetTip(vBlocks[29]);
+
+        // Build the index while the wallet is empty so that the coins below are added to it one by one
+        CheckCoinsForStaking(wallet, validators, 0);
+
+        static uint32_t nextLockTime = 0;
+        auto MakeTx = [&](const COutPoint &prevout, const std::vector<CTxOut> &vout) {
+            CMutableTransaction tx;
+            tx.nLockTime = nextLockTime++;
+            tx.vin.emplace_back(prevout);
+            tx.vout = vout;
+            return MakeTransactionRef(std::move(tx));
+        };
+        auto ConnectTx = [&](const CTransactionRef &tx, CBlockIndex *pindex) {
+            std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+            pblock->vtx.push_back(tx);
+            wallet.BlockConnected(pblock, pindex, {});
+        };
+
+        // Mature at the tip: ours, another wallet's and ours paid to the public key
+        CTransactionRef tx1 = MakeTx(COutPoint(GetRandHash(), 0), {CTxOut(10 * COIN, script), CTxOut(10 * COIN, otherScript), CTxOut(20 * COIN, GetScriptForRawPubKey(key.GetPubKey()))});
+        ConnectTx(tx1, vBlocks[2]);
+        CheckCoinsForStaking(wallet, validators, 2);
+
+        // Mature only while the chain is 30 blocks high
+        CTransactionRef tx2 = MakeTx(COutPoint(GetRandHash(), 0), {CTxOut(30 * COIN, script)});
+        ConnectTx(tx2, vBlocks[15]);
+        CheckCoinsForStaking(wallet, validators, 3);
+
+        // Not mature yet
+        CTransactionRef tx3 = MakeTx(COutPoint(GetRandHash(), 0), {CTxOut(40 * COIN, script)});
+        ConnectTx(tx3, vBlocks[27]);
+        CheckCoinsForStaking(wallet, validators, 3);
+
+        // Spend the first coin in a block, the change isn't mature yet
+        CTransactionRef tx4 = MakeTx(COutPoint(tx1->GetHash(), 0), {CTxOut(5 * COIN, otherScript), CTxOut(4 * COIN, script)});
+        ConnectTx(tx4, vBlocks[22]);
+        CheckCoinsForStaking(wallet, validators, 2);
+
+        // Spend the pay-to-public-key coin from the mempool
+        CTransactionRef tx5 = MakeTx(COutPoint(tx1->GetHash(), 2), {CTxOut(19 * COIN, otherScript)});
+        wallet.TransactionAddedToMempool(tx5);
+        CheckCoinsForStaking(wallet, validators, 1);
+
+        // Locked coins don't stake
+        wallet.LockCoin(COutPoint(tx2->GetHash(), 0));
+        CheckCoinsForStaking(wallet, validators, 0);
+        wallet.UnlockCoin(COutPoint(tx2->GetHash(), 0));
+        CheckCoinsForStaking(wallet, validators, 1);
+
+        // Reorg to 20 blocks: the second coin is immature again and the spend of the first goes back to the mempool
+        chainActive.SetTip(vBlocks[19]);
+        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+        pblock->vtx = {tx3};
+        wallet.BlockDisconnected(pblock);
+        pblock->vtx = {tx4};
+        wallet.BlockDisconnected(pblock);
+        CheckCoinsForStaking(wallet, validators, 0);
+
+        // Connect the blocks again
+        chainActive.SetTip(vBlocks[29]);
+        ConnectTx(tx4, vBlocks[22]);
+        ConnectTx(tx3, vBlocks[27]);
+        CheckCoinsForStaking(wallet, validators, 1);
+
+        // Blocks without wallet transactions let the change and the third coin mature
+        chainActive.SetTip(vBlocks.back());
+        CheckCoinsForStaking(wallet, validators, 3);
+
+        chainActive.SetTip(pindexStart);
+        for (CBlockIndex *pindex : vBlocks)
+        {
+            mapBlockIndex.erase(pindex->GetIndexHash());
+            delete pindex;
+        }
+    }
+
     class ListCoinsTestingSetup : public TestChain100Setup
     {
     public:
@@ -650,7 +810,7 @@ BOOST_FIXTURE_TEST_SUITE(wallet_tests, WalletTestingSetup)
             int changePos = -1;
             std::string error;
             CCoinControl dummy;
-            BOOST_CHECK(wallet->CreateTransaction({recipient}, wtx, reservekey, fee, changePos, error, dummy));
+            BOOST_CHECK(wallet->CreateTransaction({recipient}, wtx, reservekey, fee, "", changePos, error, dummy));
             CValidationState state;
             BOOST_CHECK(wallet->CommitTransaction(wtx, reservekey, nullptr, state));
             auto it = wallet->mapWallet.find(wtx.GetHash());
@@ -35,6 +35,7 @@
 #include "wallet/fees.h"
 #include "wallet/bip39.h"
 #include <miner.h>
+#include <pow.h>
 
 #include <assert.h>
 
@@ -1014,6 +1015,10 @@ void CWallet::MarkDirty()
         LOCK(cs_wallet);
         for (std::pair<const uint256, CWalletTx>& item : mapWallet)
             item.second.MarkDirty();
+
+        // Ownership of outputs may have changed, e.g. after a key import
+        mapStakeCandidates.clear();
+        fStakeCandidatesDirty = true;
     }
 }
 
@@ -1119,6 +1124,10 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
     // Break debit/credit balance caches:
     wtx.MarkDirty();
 
+    // Outputs may have confirmed or been disconnected, inputs are now spent
+    UpdateStakeCandidates(wtx);
+    UpdateStakeCandidatesForInputs(*wtx.tx);
+
     // Notify UI of new or updated transaction
     NotifyTransactionChanged(this, hash, fInsertedNew ? CT_NEW : CT_UPDATED);
 
@@ -1290,6 +1299,8 @@ bool CWallet::AbandonTransaction(const uint256& hashTx)
                     it->second.MarkDirty();
                 }
             }
+            UpdateStakeCandidates(wtx);
+            UpdateStakeCandidatesForInputs(*wtx.tx);
         }
     }
 
@@ -1353,6 +1364,8 @@ void CWallet::MarkConflicted(const uint256& hashBlock, const uint256& hashTx)
                     it->second.MarkDirty();
                 }
             }
+            UpdateStakeCandidates(wtx);
+            UpdateStakeCandidatesForInputs(*wtx.tx);
         }
     }
 }
@@ -1367,6 +1380,7 @@ void CWallet::SyncTransaction(const CTransactionRef& ptx, const CBlockIndex *pin
         if (tx.IsCoinStake() && IsFromMe(tx))
         {
             DisableTransaction(tx);
+            UpdateStakeCandidatesForInputs(tx);
             return;
         }
     }
@@ -2535,10 +2549,6 @@ void CWallet::AvailableCoinsAll(std::vector<COutput>& vCoins, std::map<std::stri
     {
         LOCK2(cs_main, cs_wallet);
 
-        // Get list of validator addresses
-        std::vector< CScript > validatorVector;
-        governance->GetActiveValidatorsScript(&validatorVector);
-
         CAmount nTotal = 0;
 
         /** TOKENS START */
@@ -2638,26 +2648,23 @@ void CWallet::AvailableCoinsAll(std::vector<COutput>& vCoins, std::map<std::stri
                                      (mine & ISMINE_WATCH_SOLVABLE) != ISMINE_NO);
                 bool fSolvableIn = (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE)) != ISMINE_NO;
 
-                std::string address;
-
                 // Looking for Token Tx OutPoints Only
                 if (fGetTokens && AreTokensDeployed() && isTokenScript) {
-                    CTokenOutputEntry output_data;
-                    if (!GetTokenData(pcoin->tx->vout[i].scriptPubKey, output_data))
+                    const CTokenOutputEntry* poutput_data = pcoin->tx->GetTokenOutput(i);
+                    if (!poutput_data)
                         continue;
+                    const CTokenOutputEntry& output_data = *poutput_data;
 
                     if ((int64_t)output_data.nTimeLock > ((int64_t)output_data.nTimeLock < LOCKTIME_THRESHOLD ? (int64_t)chainActive.Height() : GetTime()) == !fLockedTokens) {
                         continue;
                     }
 
-                    address = EncodeDestination(output_data.destination);
-
                     // If we already have the maximum amount or size for this token, skip it
                     if (setTokenMaxFound.count(output_data.tokenName))
                         continue;
 
                     if (IsTokenNameAnRestricted(output_data.tokenName)) {
-                        if (ptokens->CheckForAddressRestriction(output_data.tokenName, address, true)) {
+                        if (ptokens->CheckForAddressRestriction(output_data.tokenName, output_data.address, true)) {
                             continue;
                         }
                     }
@@ -2700,17 +2707,7 @@ void CWallet::AvailableCoinsAll(std::vector<COutput>& vCoins, std::map<std::stri
                         continue;
 
                     // Failsafe to prevent from spending PoS-A outputs
-                    bool authorized = false;
-
-                    CScript validatorScript = pcoin->tx->vout[i].scriptPubKey;
-                    if (validatorScript.IsPayToPublicKey()) {
-                        uint160 hashBytes(Hash160(validatorScript.begin() + 1, validatorScript.end() - 1));
-                        validatorScript = CScript() << OP_DUP << OP_HASH160 << ToByteVector(hashBytes) << OP_EQUALVERIFY << OP_CHECKSIG;
-                    }
-
-                    if (std::find(validatorVector.begin(), validatorVector.end(), validatorScript) != validatorVector.end()) {
-                        authorized = true;
-                    }
+                    bool authorized = pgovernanceTip->CanStake(pcoin->tx->vout[i].scriptPubKey);
 
                     bool send_authorized = gArgs.GetBoolArg("-sendauthorized", false);
 
@@ -2794,59 +2791,102 @@ std::map<CTxDestination, std::vector<COutput>> CWallet::ListTokens() const
 
 /** TOKENS END */
 
-void CWallet::AvailableCoinsForStaking(std::vector<COutput>& vCoins, std::vector< CScript > validatorVector) const
+void CWallet::UpdateStakeCandidates(const CWalletTx& wtx) const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    // The whole index is rebuilt on next use
+    if (fStakeCandidatesDirty)
+        return;
+
+    const uint256& hash = wtx.GetHash();
+    auto it = mapStakeCandidates.lower_bound(COutPoint(hash, 0));
+    while (it != mapStakeCandidates.end() && it->first.hash == hash)
+        it = mapStakeCandidates.erase(it);
+
+    const CBlockIndex* pindex = nullptr;
+    if (wtx.GetDepthInMainChain(pindex) < 1)
+        return;
+
+    // Same limits as COINSTAKE_MATURITY and GetBlocksToMaturity
+    int nMaturity = COINSTAKE_MATURITY - 1;
+    if (wtx.IsCoinBase())
+        nMaturity = std::max(nMaturity, COINBASE_MATURITY);
+    if (wtx.IsCoinStake())
+        nMaturity = std::max(nMaturity, COINSTAKE_MATURITY);
+
+    for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+        const CTxOut& txout = wtx.tx->vout[i];
+        if (txout.nValue <= 0 || txout.scriptPubKey.IsTokenScript())
+            continue;
+
+        isminetype mine = IsMine(txout);
+        if (mine == ISMINE_NO || IsSpent(hash, i))
+            continue;
+
+        CStakeCandidate candidate;
+        candidate.pwtx = &wtx;
+        candidate.nValue = txout.nValue;
+        candidate.nTime = wtx.tx->nTime;
+        candidate.nHeight = pindex->nHeight;
+        candidate.nMaturityHeight = pindex->nHeight + nMaturity;
+        candidate.scriptValidator = CGovernanceView::GetValidatorScript(txout.scriptPubKey);
+        candidate.fSolvable = (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE | ISMINE_STAKABLE)) != ISMINE_NO;
+        candidate.fSpendable = ((mine & ISMINE_SPENDABLE) != ISMINE_NO) || (((mine & ISMINE_WATCH_ONLY) != ISMINE_NO) && candidate.fSolvable);
+
+        mapStakeCandidates.emplace(COutPoint(hash, i), std::move(candidate));
+    }
+}
+
+void CWallet::UpdateStakeCandidatesForInputs(const CTransaction& tx) const
+{
+    for (const CTxIn& txin : tx.vin) {
+        auto it = mapWallet.find(txin.prevout.hash);
+        if (it != mapWallet.end())
+            UpdateStakeCandidates(it->second);
+    }
+}
+
+void CWallet::AvailableCoinsForStaking(std::vector<COutput>& vCoins, const CGovernanceScriptSet& validators) const
 {
     vCoins.clear();
 
     {
         LOCK2(cs_main, cs_wallet);
-        for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+
+        if (fStakeCandidatesDirty) {
+            mapStakeCandidates.clear();
+            fStakeCandidatesDirty = false;
+            for (const auto& item : mapWallet)
+                UpdateStakeCandidates(item.second);
+            LogPrint(BCLog::COINSTAKE, "%s: Indexed %u staking candidates\n", __func__, mapStakeCandidates.size());
+        }
+
+        int nHeight = chainActive.Height();
+        for (const auto& item : mapStakeCandidates)
         {
-            const uint256& wtxid = it->first;
-            const CWalletTx* pcoin = &(*it).second;
-            int nDepth = pcoin->GetDepthInMainChain();
+            const CStakeCandidate& candidate = item.second;
 
-            if (nDepth < 1)
+            if (nHeight < candidate.nMaturityHeight)
                 continue;
 
-            if (nDepth < COINSTAKE_MATURITY)
+            if (!validators.count(candidate.scriptValidator))
                 continue;
 
-            if (pcoin->GetBlocksToMaturity() > 0)
+            // Spends from the mempool and locks may change without a notification
+            if (IsSpent(item.first.hash, item.first.n) || IsLockedCoin(item.first.hash, item.first.n))
                 continue;
 
-            for (unsigned int i = 0; i < pcoin->tx->vout.size(); i++) {
-                isminetype mine = IsMine(pcoin->tx->vout[i]);
-                bool isTokenScript = pcoin->tx->vout[i].scriptPubKey.IsTokenScript();
-                bool solvable = (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE | ISMINE_STAKABLE)) != ISMINE_NO;
-                bool spendable = ((mine & ISMINE_SPENDABLE) != ISMINE_NO) || (((mine & ISMINE_WATCH_ONLY) != ISMINE_NO) && solvable);
-
-                bool authorized = false;
-
-                CScript validatorScript = pcoin->tx->vout[i].scriptPubKey;
-                if (validatorScript.IsPayToPublicKey()) {
-                    uint160 hashBytes(Hash160(validatorScript.begin() + 1, validatorScript.end() - 1));
-                    validatorScript = CScript() << OP_DUP << OP_HASH160 << ToByteVector(hashBytes) << OP_EQUALVERIFY << OP_CHECKSIG;
-                }
-
-                if (std::find(validatorVector.begin(), validatorVector.end(), validatorScript) != validatorVector.end()) {
-                    authorized = true;
-                }
-
-                if (authorized && !isTokenScript && !(IsSpent(wtxid, i)) && mine != ISMINE_NO &&
-                    !IsLockedCoin((*it).first, i) && (pcoin->tx->vout[i].nValue > 0))
-                {
-                    vCoins.push_back(COutput(pcoin, i, nDepth, spendable, solvable, pcoin->IsTrusted()));
-                }
-            }
+            vCoins.push_back(COutput(candidate.pwtx, item.first.n, nHeight - candidate.nHeight + 1, candidate.fSpendable, candidate.fSolvable, candidate.pwtx->IsTrusted()));
         }
     }
 }
 
-bool CWallet::SelectCoinsForStaking(CAmount& nTargetValue, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, std::vector< CScript > validatorVector) const
+bool CWallet::SelectCoinsForStaking(CAmount& nTargetValue, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, const CGovernanceScriptSet& validators) const
 {
     std::vector<COutput> vCoins;
-    AvailableCoinsForStaking(vCoins, validatorVector);
+    AvailableCoinsForStaking(vCoins, validators);
 
     setCoinsRet.clear();
     nValueRet = 0;
@@ -2882,7 +2922,33 @@ bool CWallet::SelectCoinsForStaking(CAmount& nTargetValue, std::set<std::pair<co
     return true;
 }
 
-bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, const CAmount& nTotalFees, uint32_t nTimeBlock, CMutableTransaction& tx, CKey& key, std::vector< CScript > validatorVector)
+static std::vector<CStakeKernelCandidate> GetStakeKernelCandidates(const std::set<std::pair<const CWalletTx*,unsigned int> >& setCoins)
+{
+    std::vector<CStakeKernelCandidate> vCandidates;
+    vCandidates.reserve(setCoins.size());
+    for (const std::pair<const CWalletTx*,unsigned int>& pcoin : setCoins)
+        vCandidates.emplace_back(COutPoint(pcoin.first->GetHash(), pcoin.second), pcoin.first->tx->vout[pcoin.second].nValue, pcoin.first->tx->nTime);
+    return vCandidates;
+}
+
+bool CWallet::FindStakeTime(const CBlockIndex* pindexPrev, uint32_t nTimeFrom, uint32_t nTimeTo, const CGovernanceScriptSet& validators, uint32_t& nTimeRet) const
+{
+    CAmount nBalance = GetBalance() + GetOfflineStakingBalance();
+    if (nBalance <= nReserveBalance)
+        return false;
+
+    std::set<std::pair<const CWalletTx*,unsigned int> > setCoins;
+    CAmount nValueIn = 0;
+    CAmount nTargetValue = nBalance - nReserveBalance;
+    if (!SelectCoinsForStaking(nTargetValue, setCoins, nValueIn, validators) || setCoins.empty())
+        return false;
+
+    unsigned int nBits = GetNextTargetRequired(pindexPrev, nullptr, true, GetParams().GetConsensus());
+    std::vector<size_t> vKernels;
+    return FindStakeKernel(pindexPrev, nBits, GetStakeKernelCandidates(setCoins), nTimeFrom, nTimeTo, vKernels, nTimeRet);
+}
+
+bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, const CAmount& nTotalFees, uint32_t nTimeBlock, CMutableTransaction& tx, CKey& key, const CGovernanceScriptSet& validators)
 {
     CBlockIndex* pindexPrev = chainActive.Tip();
     arith_uint256 bnTargetPerCoinDay;
@@ -2910,7 +2976,7 @@ bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, con
 
     // Select coins with suitable depth
     CAmount nTargetValue = nBalance - nReserveBalance;
-    if (!SelectCoinsForStaking(nTargetValue, setCoins, nValueIn, validatorVector))
+    if (!SelectCoinsForStaking(nTargetValue, setCoins, nValueIn, validators))
         return false;
 
     if (setCoins.empty())
@@ -2922,19 +2988,33 @@ bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, con
         stakeCache.clear();
     }
 
+    // Hash the kernels of all the coins at once, only the hits go through the full check below
+    std::vector<size_t> vKernels;
+    uint32_t nTimeKernel = 0;
+    if (!FindStakeKernel(pindexPrev, nBits, GetStakeKernelCandidates(setCoins), nTimeBlock, nTimeBlock, vKernels, nTimeKernel))
+        return false;
+
     CAmount nCredit = 0;
     CAmount nOfflineReward = 0;
     CScript scriptPubKeyKernel;
     CScript scriptOfflineStaker;
     bool nOfflineStake = false;
 
+    // The candidates are in the order of setCoins, try the hits in that order until one passes the full check
+    std::vector<size_t>::const_iterator itKernel = vKernels.begin();
+    size_t nCandidate = 0;
     for(const std::pair<const CWalletTx*,unsigned int> &pcoin : setCoins)
     {
         bool fKernelFound = false;
         boost::this_thread::interruption_point();
-        // Search backward in time from the given txNew timestamp
-        // Search nSearchInterval seconds back up to nMaxStakeSearchInterval
+        if (itKernel == vKernels.end())
+            break;
+        if (nCandidate++ != *itKernel)
+            continue;
+        ++itKernel;
+
         COutPoint prevoutStake = COutPoint(pcoin.first->GetHash(), pcoin.second);
+
         if (CheckKernel(pindexPrev, nBits, nTimeBlock, prevoutStake, *pcoinsTip, stakeCache))
         {
             // Found a kernel
@@ -3103,10 +3183,10 @@ bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, con
     return true;
 }
 
-bool CWallet::HaveAvailableCoinsForStaking(std::vector< CScript > validatorVector) const
+bool CWallet::HaveAvailableCoinsForStaking(const CGovernanceScriptSet& validators) const
 {
     std::vector<COutput> vCoins;
-    AvailableCoinsForStaking(vCoins, validatorVector);
+    AvailableCoinsForStaking(vCoins, validators);
     return vCoins.size() > 0;
 }
 
@@ -4091,7 +4171,7 @@ bool CWallet::CreateTransactionAll(const std::vector<CRecipient>& vecSend, CWall
                                     return false;
                                 }
 
-                                std::string change_address = EncodeDestination(dest);
+                                CTokenAddress change_address(dest);
                                 bool fFoundValueChangeAddress = false;
                                 // Check the verifier string against the change address, if it fails, we will try to send the change back to the same input that created this transaction
                                 if (!ContextualCheckVerifierString(ptokens, verifier.verifier_string, change_address, strFailReason)) {
@@ -4108,9 +4188,7 @@ bool CWallet::CreateTransactionAll(const std::vector<CRecipient>& vecSend, CWall
                                             if (outputData.tokenName != tokenChange.first)
                                                 continue;
 
-                                            std::string check_address = EncodeDestination(outputData.destination);
-
-                                            if (ContextualCheckVerifierString(ptokens, verifier.verifier_string, check_address, strFailReason)) {
+                                            if (ContextualCheckVerifierString(ptokens, verifier.verifier_string, outputData.address, strFailReason)) {
                                                 fFoundValueChangeAddress = true;
 
                                                 CScript scriptTokenChange = GetScriptForDestination(outputData.destination);
@@ -4471,10 +4549,10 @@ uint64_t CWallet::GetStakeWeight() const
 
     CAmount nTargetValue = nBalance - nReserveBalance;
 
-    std::vector< CScript > validatorVector;
-    governance->GetActiveValidatorsScript(&validatorVector);
+    CGovernanceScriptSet validators;
+    pgovernanceTip->GetValidators(validators);
 
-    if (!SelectCoinsForStaking(nTargetValue, setCoins, nValueIn, validatorVector))
+    if (!SelectCoinsForStaking(nTargetValue, setCoins, nValueIn, validators))
         return 0;
 
     if (setCoins.empty())
@@ -4559,6 +4637,9 @@ DBErrors CWallet::ZapSelectTx(std::vector<uint256>& vHashIn, std::vector<uint256
     for (uint256 hash : vHashOut)
         mapWallet.erase(hash);
 
+    // The stake candidates point into mapWallet, drop them before any return
+    MarkDirty();
+
     if (nZapSelectTxRet == DB_NEED_REWRITE)
     {
         if (dbw->Rewrite("\x04pool"))
@@ -4575,8 +4656,6 @@ DBErrors CWallet::ZapSelectTx(std::vector<uint256>& vHashIn, std::vector<uint256
     if (nZapSelectTxRet != DB_LOAD_OK)
         return nZapSelectTxRet;
 
-    MarkDirty();
-
     return DB_LOAD_OK;
 
 }
@@ -21,6 +21,7 @@
 #include "wallet/walletdb.h"
 #include "wallet/rpcwallet.h"
 #include "tokens/tokentypes.h"
+#include "governance/governance.h"
 #include <pos.h>
 
 #include <algorithm>
@@ -199,20 +200,6 @@ struct COutputEntry
     int vout;
 };
 
-/** TOKENS START */
-struct CTokenOutputEntry
-{
-    txnouttype type;
-    txnouttype scriptType;
-    std::string tokenName;
-    CTxDestination destination;
-    CAmount nAmount = 0;
-    uint32_t nTimeLock;
-    std::string message;
-    int64_t expireTime;
-    int vout;
-};
-/** TOKENS END */
 
 /** A transaction with a merkle branch linking it to the block chain. */
 class CMerkleTx
@@ -592,6 +579,24 @@ public:
     std::string ToString() const;
 };
 
+/** Wallet output that can be used as a staking kernel once it is mature */
+struct CStakeCandidate
+{
+    const CWalletTx* pwtx;
+    CAmount nValue;
+    unsigned int nTime;
+    int nHeight;
+
+    //! First chain height at which the output may stake
+    int nMaturityHeight;
+
+    //! Script the output is authorized under, see CGovernanceView::GetValidatorScript
+    CScript scriptValidator;
+
+    bool fSpendable;
+    bool fSolvable;
+};
+
 
 
 
@@ -786,6 +791,17 @@ private:
 
     std::map<COutPoint, CStakeCache> stakeCache;
 
+    /**
+     * Confirmed, unspent outputs of ours that may be used for staking, kept up
+     * to date from the wallet notifications so the staker does not have to
+     * walk mapWallet. Rebuilt on next use when fStakeCandidatesDirty is set.
+     */
+    mutable std::map<COutPoint, CStakeCandidate> mapStakeCandidates;
+    mutable bool fStakeCandidatesDirty = true;
+
+    void UpdateStakeCandidates(const CWalletTx& wtx) const;
+    void UpdateStakeCandidatesForInputs(const CTransaction& tx) const;
+
     boost::thread_group* stakeThread = nullptr;
     void StakeCoins(bool fStake);
 
@@ -881,7 +897,7 @@ public:
     bool CanSupportFeature(enum WalletFeature wf) const { AssertLockHeld(cs_wallet); return nWalletMaxVersion >= wf; }
 
     //! select coins for staking from the available coins for staking.
-    bool SelectCoinsForStaking(CAmount& nTargetValue, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, std::vector< CScript > validatorVector) const;
+    bool SelectCoinsForStaking(CAmount& nTargetValue, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, CAmount& nValueRet, const CGovernanceScriptSet& validators) const;
 
     /**
      * populate vCoins with vector of available COutputs, and populates vTokenCoins in fWithTokens is set to true.
@@ -924,9 +940,9 @@ public:
                         const CAmount& nMinimumSumAmount = MAX_MONEY, const uint64_t& nMaximumCount = 0,
                         const int& nMinDepth = 0, const int& nMaxDepth = 9999999) const;
 
-    void AvailableCoinsForStaking(std::vector<COutput>& vCoins, std::vector< CScript > validatorVector) const;
+    void AvailableCoinsForStaking(std::vector<COutput>& vCoins, const CGovernanceScriptSet& validators) const;
     uint64_t GetStakeWeight() const;
-    bool HaveAvailableCoinsForStaking(std::vector< CScript > validatorVector) const;
+    bool HaveAvailableCoinsForStaking(const CGovernanceScriptSet& validators) const;
 
     /**
      * Return list of available coins and locked coins grouped by non-change output address.
@@ -1080,7 +1096,9 @@ public:
     bool CreateTransaction(const std::vector<CRecipient>& vecSend, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRet, std::string message, int& nChangePosInOut,
                            std::string& strFailReason, const CCoinControl& coin_control, bool sign = true);
 
-    bool CreateCoinStake(const CKeyStore &keystore, unsigned int nBits, const CAmount& nTotalFees, uint32_t nTimeBlock, CMutableTransaction& tx, CKey& key, std::vector< CScript > validatorVector);
+    /** Find the earliest timestamp between nTimeFrom and nTimeTo at which one of the staking coins is a kernel on top of pindexPrev */
+    bool FindStakeTime(const CBlockIndex* pindexPrev, uint32_t nTimeFrom, uint32_t nTimeTo, const CGovernanceScriptSet& validators, uint32_t& nTimeRet) const;
+    bool CreateCoinStake(const CKeyStore &keystore, unsigned int nBits, const CAmount& nTotalFees, uint32_t nTimeBlock, CMutableTransaction& tx, CKey& key, const CGovernanceScriptSet& validators);
 
     /**
      * Create a new transaction paying the recipients with a set of coins
@@ -144,6 +144,15 @@ class TokenTest(PaladeumTestFramework):
 
         n0.listtokens(token="PLB*", verbose=False, count=2, start=-2)
 
+        self.log.info("Checking listtokens() pages with the after cursor...")
+        all_tokens = n0.listtokens("PLB*", False)
+        assert(len(all_tokens) >= 3)
+        page = n0.listtokens("PLB*", False, 2)
+        assert_equal(page, all_tokens[:2])
+        page = n0.listtokens("PLB*", False, 2, 0, page[-1])
+        assert_equal(page, all_tokens[2:4])
+        assert_raises_rpc_error(-8, "start can't be negative when continuing after a token.", n0.listtokens, "PLB*", False, 2, -1, page[-1])
+
         self.log.info("Creating some sub-tokens...")
         n0.issue(token_name="MY_TOKEN/SUB1", qty=1000, to_address=address0, change_address=address0, units=4, reissuable=True, has_ipfs=True, ipfs_hash=ipfs_hash)
 
@@ -106,6 +106,17 @@ class AddressIndexTest(PaladeumTestFramework):
         assert_equal(multi_tx_ids[4], tx_id2)
         assert_equal(multi_tx_ids[5], tx_idb2)
 
+        # Pages of both addresses list each txid once, in block order
+        paged_tx_ids = []
+        request = {"addresses": ["2N2JD6wb56AfK4tfmM6PwdVmoYk2dCKf4Br", "mo9ncXisMeAoXwqcV5EWuyncbmCcQN4rVs"], "limit": 4}
+        while True:
+            page = self.nodes[1].getaddresstxids(request, True)
+            paged_tx_ids += page["txids"]
+            if "cursor" not in page:
+                break
+            request["cursor"] = page["cursor"]
+        assert_equal(paged_tx_ids, multi_tx_ids)
+
         # Check that balances are correct
         balance0 = self.nodes[1].getaddressbalance("2N2JD6wb56AfK4tfmM6PwdVmoYk2dCKf4Br")
         assert_equal(balance0["balance"], 45 * 100000000)